@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <context.h>
 #include <context_mgmt.h>
+#include <dcache_batch.h>
 #include <debug.h>
 #include <platform.h>
 #include <smccc_helpers.h>
@@ -83,15 +84,19 @@ static void copy_cpu_ctx_to_smc_ctx(const regs_t *cpu_reg_ctx,
  ******************************************************************************/
 static void flush_smc_and_cpu_ctx(void)
 {
-	flush_dcache_range((uintptr_t)&bl1_next_smc_context_ptr,
+	dcache_batch_t batch;
+
+	dcache_batch_init(&batch, DCACHE_BATCH_FLUSH);
+	dcache_batch_add(&batch, (uintptr_t)&bl1_next_smc_context_ptr,
 		sizeof(bl1_next_smc_context_ptr));
-	flush_dcache_range((uintptr_t)bl1_next_smc_context_ptr,
+	dcache_batch_add(&batch, (uintptr_t)bl1_next_smc_context_ptr,
 		sizeof(smc_ctx_t));
 
-	flush_dcache_range((uintptr_t)&bl1_next_cpu_context_ptr,
+	dcache_batch_add(&batch, (uintptr_t)&bl1_next_cpu_context_ptr,
 		sizeof(bl1_next_cpu_context_ptr));
-	flush_dcache_range((uintptr_t)bl1_next_cpu_context_ptr,
+	dcache_batch_add(&batch, (uintptr_t)bl1_next_cpu_context_ptr,
 		sizeof(cpu_context_t));
+	dcache_batch_finish(&batch);
 }
 
 /*******************************************************************************
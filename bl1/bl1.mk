@@ -25,4 +25,12 @@ ifeq (${TRUSTED_BOARD_BOOT},1)
 BL1_SOURCES		+=	bl1/bl1_fwu.c
 endif
 
+ifeq (${BL1_WARM_RESUME},1)
+BL1_SOURCES		+=	bl1/bl1_resume.c
+endif
+
+ifeq (${BOOT_PROFILING},1)
+BL1_SOURCES		+=	lib/boot_prof/boot_prof.c
+endif
+
 BL1_LINKERFILE		:=	bl1/bl1.ld.S
@@ -52,6 +52,12 @@ static unsigned int sec_exec_image_id = INVALID_IMAGE_ID;
 /* Authentication status of each image. */
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
+/*
+ * Image being hashed while it is copied, if any. Only one image can be hashed
+ * at a time, the others are hashed in one go when they are authenticated.
+ */
+static unsigned int hashing_image_id = INVALID_IMAGE_ID;
+
 /*******************************************************************************
  * Top level handler for servicing FWU SMCs.
  ******************************************************************************/
@@ -214,6 +220,42 @@ static int bl1_fwu_image_check_overlaps(int image_id)
 	return 0;
 }
 
+/*******************************************************************************
+ * Start hashing an image as its blocks are copied, so that its authentication
+ * does not need another pass over it. This is only possible once its parent
+ * has been authenticated, and if the authentication module supports it for
+ * this image.
+ ******************************************************************************/
+static void bl1_fwu_hash_start(unsigned int image_id)
+{
+	unsigned int parent_id;
+
+	if (hashing_image_id != INVALID_IMAGE_ID)
+		return;
+
+	if (auth_mod_get_parent_id(image_id, &parent_id) == 0)
+		return;
+
+	if (auth_mod_verify_img_init(image_id) == 0)
+		hashing_image_id = image_id;
+}
+
+/*******************************************************************************
+ * Stop hashing an image while it is being copied. It is then authenticated
+ * from memory once it has been copied.
+ ******************************************************************************/
+static void bl1_fwu_hash_abort(void)
+{
+	unsigned int image_id = hashing_image_id;
+
+	if (image_id == INVALID_IMAGE_ID)
+		return;
+
+	hashing_image_id = INVALID_IMAGE_ID;
+	(void)auth_mod_verify_img_finish(image_id);
+	auth_img_flags[image_id] &= ~IMG_FLAG_AUTHENTICATED;
+}
+
 /*******************************************************************************
  * This function is responsible for copying secure images in AP Secure RAM.
  ******************************************************************************/
@@ -341,6 +383,8 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 					image_id);
 			return -EPERM;
 		}
+
+		bl1_fwu_hash_start(image_id);
 	}
 
 	/* Everything looks sane. Go ahead and copy the block of data. */
@@ -348,6 +392,14 @@ static int bl1_fwu_image_copy(unsigned int image_id,
 	memcpy((void *) dest_addr, (const void *) image_src, block_size);
 	flush_dcache_range(dest_addr, block_size);
 
+	/*
+	 * Hash the secure copy rather than the source, which the non-secure
+	 * world could modify afterwards.
+	 */
+	if ((hashing_image_id == image_id) &&
+	    (auth_mod_verify_img_update((void *)dest_addr, block_size) != 0))
+		bl1_fwu_hash_abort();
+
 	image_desc->copied_size += block_size;
 	image_desc->state = (block_size == remaining) ?
 		IMAGE_STATE_COPIED : IMAGE_STATE_COPYING;
@@ -433,10 +485,23 @@ static int bl1_fwu_image_auth(unsigned int image_id,
 	}
 
 	/*
-	 * Authenticate the image.
+	 * Authenticate the image. If it has been hashed while it was copied,
+	 * only the hash needs to be compared. Otherwise, or if the comparison
+	 * fails, e.g. because the parent certificate has been authenticated
+	 * again since then, authenticate the image in memory.
 	 */
 	INFO("BL1-FWU: Authenticating image_id:%d\n", image_id);
-	result = auth_mod_verify_img(image_id, (void *)base_addr, total_size);
+	result = -EAUTH;
+	if (hashing_image_id == image_id) {
+		hashing_image_id = INVALID_IMAGE_ID;
+		result = auth_mod_verify_img_finish(image_id);
+	} else {
+		/* Another image's hash would be clobbered */
+		bl1_fwu_hash_abort();
+	}
+	if (result != 0)
+		result = auth_mod_verify_img(image_id, (void *)base_addr,
+					     total_size);
 	if (result != 0) {
 		WARN("BL1-FWU: Authentication Failed err=%d\n", result);
 
@@ -708,6 +773,9 @@ static int bl1_fwu_image_reset(unsigned int image_id, unsigned int flags)
 			return -EPERM;
 		}
 
+		if (hashing_image_id == image_id)
+			bl1_fwu_hash_abort();
+
 		if (image_desc->copied_size) {
 			/* Clear the memory if the image is copied */
 			assert(GET_SECURITY_STATE(image_desc->ep_info.h.attr) == SECURE);
@@ -10,6 +10,7 @@
 #include <auth_mod.h>
 #include <bl1.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <debug.h>
 #include <errata_report.h>
@@ -57,6 +58,8 @@ void bl1_main(void)
 {
 	unsigned int image_id;
 
+	boot_prof_record(BOOT_PROF_STAGE_ENTRY, BOOT_PROF_NO_ID);
+
 	/* Announce our arrival */
 	NOTICE(FIRMWARE_WELCOME_STR);
 	NOTICE("BL1: %s\n", version_string);
@@ -114,13 +117,20 @@ void bl1_main(void)
 	 * We currently interpret any image id other than
 	 * BL2_IMAGE_ID as the start of firmware update.
 	 */
-	if (image_id == BL2_IMAGE_ID)
+	if (image_id == BL2_IMAGE_ID) {
 		bl1_load_bl2();
-	else
+	} else {
+#if BL1_WARM_RESUME
+		/* The images recorded may be updated */
+		bl1_resume_invalidate();
+#endif
 		NOTICE("BL1-FWU: *******FWU Process Started*******\n");
+	}
 
 	bl1_prepare_next_image(image_id);
 
+	boot_prof_record(BOOT_PROF_STAGE_EXIT, image_id);
+
 	console_flush();
 }
 
@@ -150,11 +160,19 @@ static void bl1_load_bl2(void)
 		plat_error_handler(err);
 	}
 
-	err = load_auth_image(BL2_IMAGE_ID, image_info);
-	if (err) {
-		ERROR("Failed to load BL2 firmware.\n");
-		plat_error_handler(err);
+#if BL1_WARM_RESUME
+	/* On a warm reset, only check BL2 against the hash recorded */
+	if (bl1_resume_load_image(BL2_IMAGE_ID, image_info) != 0) {
+#endif
+		err = load_auth_image(BL2_IMAGE_ID, image_info);
+		if (err) {
+			ERROR("Failed to load BL2 firmware.\n");
+			plat_error_handler(err);
+		}
+#if BL1_WARM_RESUME
+		bl1_resume_record_image(BL2_IMAGE_ID, image_info);
 	}
+#endif
 
 	/* Allow platform to handle image information. */
 	err = bl1_plat_handle_post_image_load(BL2_IMAGE_ID);
@@ -7,6 +7,7 @@
 #ifndef BL1_PRIVATE_H
 #define BL1_PRIVATE_H
 
+#include <bl_common.h>
 #include <stdint.h>
 #include <utils_def.h>
 
@@ -35,4 +36,11 @@ register_t bl1_fwu_smc_handler(unsigned int smc_fid,
 		void *cookie,
 		void *handle,
 		unsigned int flags);
+
+#if BL1_WARM_RESUME
+void bl1_resume_invalidate(void);
+void bl1_resume_record_image(unsigned int image_id,
+		const image_info_t *image_info);
+int bl1_resume_load_image(unsigned int image_id, image_info_t *image_info);
+#endif
 #endif /* BL1_PRIVATE_H */
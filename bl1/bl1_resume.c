@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <cassert.h>
+#include <crypto_mod.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdint.h>
+#include <string.h>
+#include <utils.h>
+#include "bl1_private.h"
+
+#if !TRUSTED_BOARD_BOOT
+#error "BL1_WARM_RESUME requires TRUSTED_BOARD_BOOT=1"
+#endif
+
+/*
+ * BL1 fast resume (BL1_WARM_RESUME=1). After authenticating BL2 through the
+ * Chain of Trust, BL1 records the SHA-256 of the image in a record kept at
+ * PLAT_BL1_RESUME_RECORD_BASE, in memory retained across warm resets and only
+ * accessible by the Secure world. On a warm reset reported by
+ * bl1_plat_is_warm_resume(), BL1 loads BL2 without parsing the certificates
+ * and only compares its hash with the record. If the record is invalid or the
+ * image has changed in the meantime, BL2 goes through the full authentication
+ * again.
+ */
+#define BL1_RESUME_MAGIC	U(0x53524c42)	/* "BLRS" */
+#define BL1_RESUME_DIGEST_LEN	32U
+
+typedef struct bl1_resume_record {
+	uint32_t magic;
+	uint32_t image_id;
+	uint32_t image_size;
+	uint32_t reserved;
+	uint8_t digest[BL1_RESUME_DIGEST_LEN];
+	/* SHA-256 of the fields above, to detect a corrupted record */
+	uint8_t tag[BL1_RESUME_DIGEST_LEN];
+} bl1_resume_record_t;
+
+CASSERT(sizeof(bl1_resume_record_t) <= PLAT_BL1_RESUME_RECORD_SIZE,
+	assert_bl1_resume_record_size);
+
+static bl1_resume_record_t *const resume_record =
+	(bl1_resume_record_t *)PLAT_BL1_RESUME_RECORD_BASE;
+
+static int bl1_resume_calc_tag(const bl1_resume_record_t *record,
+		uint8_t *tag)
+{
+	return crypto_mod_calc_hash(CRYPTO_HASH_SHA256, (void *)record,
+			offsetof(bl1_resume_record_t, tag), tag);
+}
+
+/* Invalidate the record, e.g. before updating the firmware */
+void bl1_resume_invalidate(void)
+{
+	zeromem(resume_record, sizeof(*resume_record));
+	flush_dcache_range((uintptr_t)resume_record, sizeof(*resume_record));
+}
+
+/*
+ * Record the hash of `image_id`, just loaded and authenticated, for the next
+ * warm reset.
+ */
+void bl1_resume_record_image(unsigned int image_id,
+		const image_info_t *image_info)
+{
+	bl1_resume_record_t record;
+
+	assert(image_info != NULL);
+
+	zeromem(&record, sizeof(record));
+	record.magic = BL1_RESUME_MAGIC;
+	record.image_id = image_id;
+	record.image_size = image_info->image_size;
+
+	if ((crypto_mod_calc_hash(CRYPTO_HASH_SHA256,
+			(void *)image_info->image_base, image_info->image_size,
+			record.digest) != 0) ||
+	    (bl1_resume_calc_tag(&record, record.tag) != 0)) {
+		WARN("BL1: Failed to record image id=%u for warm resets\n",
+		     image_id);
+		bl1_resume_invalidate();
+		return;
+	}
+
+	*resume_record = record;
+	flush_dcache_range((uintptr_t)resume_record, sizeof(*resume_record));
+}
+
+/*
+ * Load `image_id` on a warm reset, and check it against its recorded hash
+ * instead of authenticating it. Returns 0 if the image matches its record,
+ * or -1 if it must be loaded and authenticated with load_auth_image().
+ */
+int bl1_resume_load_image(unsigned int image_id, image_info_t *image_info)
+{
+	bl1_resume_record_t record = *resume_record;
+	uint8_t digest[BL1_RESUME_DIGEST_LEN];
+
+	assert(image_info != NULL);
+
+	if (bl1_plat_is_warm_resume() == 0)
+		return -1;
+
+	if ((record.magic != BL1_RESUME_MAGIC) ||
+	    (record.image_id != image_id) ||
+	    (bl1_resume_calc_tag(&record, digest) != 0) ||
+	    (memcmp(digest, record.tag, sizeof(digest)) != 0)) {
+		VERBOSE("BL1: No valid record for image id=%u\n", image_id);
+		return -1;
+	}
+
+	if ((load_unauth_image(image_id, image_info) != 0) ||
+	    (image_info->image_size != record.image_size) ||
+	    (crypto_mod_calc_hash(CRYPTO_HASH_SHA256,
+			(void *)image_info->image_base, image_info->image_size,
+			digest) != 0) ||
+	    (memcmp(digest, record.digest, sizeof(digest)) != 0)) {
+		INFO("BL1: Image id=%u changed since it was recorded\n",
+		     image_id);
+		return -1;
+	}
+
+	INFO("BL1: Image id=%u matches its record\n", image_id);
+	return 0;
+}
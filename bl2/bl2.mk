@@ -16,6 +16,26 @@ endif
 
 BL2_SOURCES		+=	bl2/bl2_image_load_v2.c
 
+ifeq (${BOOT_PROFILING},1)
+BL2_SOURCES		+=	lib/boot_prof/boot_prof.c
+endif
+
+ifeq (${MEASURED_BOOT},1)
+BL2_SOURCES		+=	drivers/measured_boot/event_log.c
+endif
+
+ifeq (${BL2_IO_BENCHMARK},1)
+BL2_SOURCES		+=	bl2/bl2_io_bench.c
+ifeq ($(filter common/image_decompress.c,${BL2_SOURCES}),)
+BL2_SOURCES		+=	common/image_decompress.c
+endif
+endif
+
+ifeq (${BL2_SECONDARY_HASH},1)
+BL2_SOURCES		+=	bl2/bl2_secondary_hash.c		\
+				bl2/${ARCH}/bl2_secondary_entrypoint.S
+endif
+
 ifeq (${BL2_AT_EL3},0)
 BL2_SOURCES		+=	bl2/${ARCH}/bl2_entrypoint.S
 BL2_LINKERFILE		:=	bl2/bl2.ld.S
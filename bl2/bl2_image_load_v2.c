@@ -16,6 +16,39 @@
 #include <stdint.h>
 #include "bl2_private.h"
 
+/*******************************************************************************
+ * This function prepares the images marked with IMAGE_ATTRIB_DEFERRED, which
+ * are not loaded by BL2 but by a later boot stage. It is called once all the
+ * other images are loaded, so that the hand-off structures that the platform
+ * publishes the deferred images in are already loaded.
+ ******************************************************************************/
+static void bl2_handle_deferred_images(const bl_load_info_node_t *node_info)
+{
+	void *hash;
+	unsigned int hash_len;
+	int err;
+
+	for (; node_info != NULL; node_info = node_info->next_load_info) {
+		if (!(node_info->image_info->h.attr & IMAGE_ATTRIB_DEFERRED))
+			continue;
+
+		err = auth_deferred_image(node_info->image_id,
+				node_info->image_info, &hash, &hash_len);
+		if (err) {
+			ERROR("BL2: Failed to prepare deferred image (%i)\n",
+			      err);
+			plat_error_handler(err);
+		}
+
+		err = bl2_plat_handle_deferred_image(node_info->image_id,
+				hash, hash_len);
+		if (err) {
+			ERROR("BL2: Failure in deferred image handling (%i)\n",
+			      err);
+			plat_error_handler(err);
+		}
+	}
+}
 
 /*******************************************************************************
  * This function loads SCP_BL2/BL3x images and returns the ep_info for
@@ -26,6 +59,7 @@ struct entry_point_info *bl2_load_images(void)
 	bl_params_t *bl2_to_next_bl_params;
 	bl_load_info_t *bl2_load_info;
 	const bl_load_info_node_t *bl2_node_info;
+	image_split_t *split;
 	int plat_setup_done = 0;
 	int err;
 
@@ -61,10 +95,20 @@ struct entry_point_info *bl2_load_images(void)
 			plat_error_handler(err);
 		}
 
-		if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+		if (bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_DEFERRED) {
+			/* Published by bl2_handle_deferred_images() */
+			INFO("BL2: Deferring image id %d\n", bl2_node_info->image_id);
+		} else if (!(bl2_node_info->image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
 			INFO("BL2: Loading image id %d\n", bl2_node_info->image_id);
-			err = load_auth_image(bl2_node_info->image_id,
-				bl2_node_info->image_info);
+			split = bl2_plat_get_image_split(bl2_node_info->image_id);
+			if (split != NULL) {
+				err = load_auth_split_image(
+					bl2_node_info->image_id,
+					bl2_node_info->image_info, split);
+			} else {
+				err = load_auth_image(bl2_node_info->image_id,
+					bl2_node_info->image_info);
+			}
 			if (err) {
 				ERROR("BL2: Failed to load image (%i)\n", err);
 				plat_error_handler(err);
@@ -84,6 +128,8 @@ struct entry_point_info *bl2_load_images(void)
 		bl2_node_info = bl2_node_info->next_load_info;
 	}
 
+	bl2_handle_deferred_images(bl2_load_info->head);
+
 	/*
 	 * Get information to pass to the next image.
 	 */
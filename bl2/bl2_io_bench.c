@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Benchmark of the loading path of BL2 (BL2_IO_BENCHMARK=1).
+ *
+ * Before the images of the boot are loaded, each image listed by the platform
+ * is loaded PLAT_BL2_IO_BENCH_ITERATIONS times to the benchmark buffer, and the
+ * average time and throughput of two paths are printed:
+ * - "read": the image read in one go through the IO layer, i.e. the FIP driver
+ *   and the backend behind it (memmap, block device, semihosting...);
+ * - "load": the whole pipeline of load_auth_image(), with the authentication
+ *   of the image and its certificates when TRUSTED_BOARD_BOOT=1, followed by
+ *   the decompression of the image if the platform flags it as compressed.
+ *
+ * With BOOT_PROFILING=1, the time of the pipeline is also split in its load,
+ * authentication and decompression stages, from the events it records in the
+ * boot timeline. These events are then discarded, so that the timeline only
+ * shows the boot itself.
+ *
+ * The buffer is reused by the images of the boot, so it must not hold anything
+ * loaded before BL2 runs the benchmark.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl2.h>
+#include <bl_common.h>
+#include <boot_prof.h>
+#include <debug.h>
+#include <errno.h>
+#include <image_decompress.h>
+#include <io_storage.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdint.h>
+
+#include "bl2_private.h"
+
+#if !defined(PLAT_BL2_IO_BENCH_BUF_BASE) || \
+	!defined(PLAT_BL2_IO_BENCH_BUF_SIZE)
+#error "Platform must define the buffer of the BL2 loading benchmark"
+#endif
+
+#ifndef PLAT_BL2_IO_BENCH_ITERATIONS
+#define PLAT_BL2_IO_BENCH_ITERATIONS	4U
+#endif
+
+/*
+ * Stages of the pipeline. The start and end events of stage N in the boot
+ * timeline are BOOT_PROF_LOAD_START + 2N and BOOT_PROF_LOAD_START + 2N + 1.
+ */
+#define BENCH_STAGE_LOAD	0U
+#define BENCH_STAGE_AUTH	1U
+#define BENCH_STAGE_DECOMP	2U
+#define BENCH_NUM_STAGES	3U
+
+typedef struct bench_result {
+	size_t size;
+	uint64_t ticks;
+	uint64_t stage_ticks[BENCH_NUM_STAGES];
+} bench_result_t;
+
+/* Read the whole image `image_id` to the buffer through the IO layer */
+static int bench_read(unsigned int image_id, size_t *size)
+{
+	uintptr_t dev_handle, image_handle, image_spec;
+	size_t bytes_read;
+	int rc;
+
+	rc = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (rc != 0)
+		return rc;
+
+	rc = io_open(dev_handle, image_spec, &image_handle);
+	if (rc != 0)
+		return rc;
+
+	rc = io_size(image_handle, size);
+	if ((rc == 0) && (*size > PLAT_BL2_IO_BENCH_BUF_SIZE))
+		rc = -EFBIG;
+
+	if (rc == 0) {
+		rc = io_read(image_handle, PLAT_BL2_IO_BENCH_BUF_BASE, *size,
+			     &bytes_read);
+		if ((rc == 0) && (bytes_read != *size))
+			rc = -EIO;
+	}
+
+	(void)io_close(image_handle);
+	(void)io_dev_close(dev_handle);
+
+	return rc;
+}
+
+/* Load the image `img` to the buffer the way BL2 loads the images */
+static int bench_load(const bl2_io_bench_image_t *img, size_t *size)
+{
+	image_info_t info;
+	int rc;
+
+	SET_PARAM_HEAD(&info, PARAM_IMAGE_BINARY, VERSION_2, 0U);
+	info.image_base = PLAT_BL2_IO_BENCH_BUF_BASE;
+	info.image_max_size = PLAT_BL2_IO_BENCH_BUF_SIZE;
+	info.image_size = 0U;
+
+	if ((img->flags & BL2_IO_BENCH_COMPRESSED) != 0U)
+		image_decompress_prepare(&info);
+
+	rc = load_auth_image(img->image_id, &info);
+
+	if ((rc == 0) && ((img->flags & BL2_IO_BENCH_COMPRESSED) != 0U))
+		rc = image_decompress(&info);
+
+	*size = info.image_size;
+
+	return rc;
+}
+
+#if BOOT_PROFILING
+/* Number of entries in the boot timeline */
+static unsigned int bench_timeline_len(void)
+{
+	struct boot_prof_entry entry;
+	unsigned int num;
+
+	(void)boot_prof_get_entry(0U, &entry, &num);
+
+	return num;
+}
+
+/*
+ * Add the time of the stages recorded in the boot timeline from entry `first`
+ * onwards to `stage_ticks`, then discard these entries.
+ */
+static void bench_add_stages(unsigned int first, uint64_t *stage_ticks)
+{
+	struct boot_prof_entry entry;
+	uint64_t start[BENCH_NUM_STAGES] = { 0U };
+	unsigned int i, num, ev;
+
+	for (i = first; boot_prof_get_entry(i, &entry, &num) == 0; i++) {
+		if ((entry.event < BOOT_PROF_LOAD_START) ||
+		    (entry.event > BOOT_PROF_DECOMP_END))
+			continue;
+
+		ev = entry.event - BOOT_PROF_LOAD_START;
+		if ((ev & 1U) == 0U)
+			start[ev >> 1] = entry.timestamp;
+		else
+			stage_ticks[ev >> 1] += entry.timestamp - start[ev >> 1];
+	}
+
+	boot_prof_rewind(first);
+}
+#endif /* BOOT_PROFILING */
+
+static unsigned long long bench_us(uint64_t ticks, uint64_t freq)
+{
+	return (unsigned long long)((ticks * 1000000U) / freq);
+}
+
+static void bench_print(const char *path, unsigned int image_id,
+			const bench_result_t *res, uint64_t freq)
+{
+	uint64_t ticks = res->ticks / PLAT_BL2_IO_BENCH_ITERATIONS;
+	uint64_t rate;
+
+	/* Throughput in bytes per second */
+	rate = ((uint64_t)res->size * freq) / ((ticks != 0U) ? ticks : 1U);
+
+	NOTICE("BL2: Bench id=%u %s: %lu bytes, %llu us, %llu.%02llu MB/s\n",
+	       image_id, path, (unsigned long)res->size, bench_us(ticks, freq),
+	       (unsigned long long)(rate / 1000000U),
+	       (unsigned long long)((rate % 1000000U) / 10000U));
+}
+
+static void bench_image(const bl2_io_bench_image_t *img, uint64_t freq)
+{
+	bench_result_t read_res = { 0U };
+	bench_result_t load_res = { 0U };
+	uint64_t start;
+	unsigned int n;
+	int rc;
+#if BOOT_PROFILING
+	unsigned int first;
+#endif
+
+	for (n = 0U; n < PLAT_BL2_IO_BENCH_ITERATIONS; n++) {
+		start = read_cntpct_el0();
+		rc = bench_read(img->image_id, &read_res.size);
+		read_res.ticks += read_cntpct_el0() - start;
+		if (rc != 0)
+			goto skip;
+
+#if BOOT_PROFILING
+		first = bench_timeline_len();
+#endif
+		start = read_cntpct_el0();
+		rc = bench_load(img, &load_res.size);
+		load_res.ticks += read_cntpct_el0() - start;
+#if BOOT_PROFILING
+		bench_add_stages(first, load_res.stage_ticks);
+#endif
+		if (rc != 0)
+			goto skip;
+	}
+
+	bench_print("read", img->image_id, &read_res, freq);
+	bench_print("load", img->image_id, &load_res, freq);
+
+#if BOOT_PROFILING
+	NOTICE("BL2: Bench id=%u stages: load %llu us, auth %llu us, decompress %llu us\n",
+	       img->image_id,
+	       bench_us(load_res.stage_ticks[BENCH_STAGE_LOAD] /
+			PLAT_BL2_IO_BENCH_ITERATIONS, freq),
+	       bench_us(load_res.stage_ticks[BENCH_STAGE_AUTH] /
+			PLAT_BL2_IO_BENCH_ITERATIONS, freq),
+	       bench_us(load_res.stage_ticks[BENCH_STAGE_DECOMP] /
+			PLAT_BL2_IO_BENCH_ITERATIONS, freq));
+#endif
+	return;
+
+skip:
+	NOTICE("BL2: Bench id=%u skipped (%d)\n", img->image_id, rc);
+}
+
+void bl2_io_bench_run(void)
+{
+	const bl2_io_bench_image_t *images;
+	unsigned int num_images, i;
+	uint64_t freq = read_cntfrq_el0();
+
+	assert(freq != 0U);
+
+	images = plat_bl2_io_bench_get_images(&num_images);
+	assert((images != NULL) || (num_images == 0U));
+
+	NOTICE("BL2: Benchmarking the loading of %u images, %u iterations\n",
+	       num_images, PLAT_BL2_IO_BENCH_ITERATIONS);
+
+	for (i = 0U; i < num_images; i++)
+		bench_image(&images[i], freq);
+}
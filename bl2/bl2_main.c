@@ -9,8 +9,10 @@
 #include <bl1.h>
 #include <bl2.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <debug.h>
+#include <event_log.h>
 #include <platform.h>
 #include "bl2_private.h"
 
@@ -29,6 +31,8 @@ void bl2_main(void)
 {
 	entry_point_info_t *next_bl_ep_info;
 
+	boot_prof_record(BOOT_PROF_STAGE_ENTRY, BOOT_PROF_NO_ID);
+
 	NOTICE("BL2: %s\n", version_string);
 	NOTICE("BL2: %s\n", build_message);
 
@@ -38,14 +42,33 @@ void bl2_main(void)
 #if TRUSTED_BOARD_BOOT
 	/* Initialize authentication module */
 	auth_mod_init();
+
+#if BL2_SECONDARY_HASH
+	/* Offload the hashing of the images to a secondary CPU */
+	bl2_secondary_hash_init();
+#endif
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* initialize boot source */
 	bl2_plat_preload_setup();
 
+#if BL2_IO_BENCHMARK
+	/* Benchmark the loading path before the images of the boot are loaded */
+	bl2_io_bench_run();
+#endif
+
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if BL2_SECONDARY_HASH
+	bl2_secondary_hash_stop();
+#endif
+
+	/* Publish the measurements of the images loaded above */
+	event_log_finish();
+
+	boot_prof_record(BOOT_PROF_STAGE_EXIT, BOOT_PROF_NO_ID);
+
 #if !BL2_AT_EL3
 #ifdef AARCH32
 	/*
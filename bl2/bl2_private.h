@@ -33,4 +33,13 @@ void bl2_arch_setup(void);
 struct entry_point_info *bl2_load_images(void);
 void bl2_run_next_image(const struct entry_point_info *bl_ep_info);
 
+#if BL2_IO_BENCHMARK
+void bl2_io_bench_run(void);
+#endif
+
+#if BL2_SECONDARY_HASH
+void bl2_secondary_hash_init(void);
+void bl2_secondary_hash_stop(void);
+#endif
+
 #endif /* BL2_PRIVATE_H */
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Hash engine running on a secondary CPU during the BL2 cold boot.
+ *
+ * The images loaded by BL2 are hashed with SHA-2, which processes the data
+ * sequentially, so a single digest can't be split between several CPUs. What
+ * can run in parallel is the hashing and the loading: the primary CPU queues
+ * each chunk read from storage (see LOAD_IMAGE_CHUNK_SIZE) and carries on with
+ * the next read while a secondary CPU hashes it. The secondary CPU is exposed
+ * to the crypto module as a hash engine, so the authentication code does not
+ * have to know about it.
+ *
+ * The queue is a single-producer single-consumer ring: only the primary CPU
+ * writes shs_tail and only the secondary CPU writes shs_head. The hash context
+ * is set up and read back by the primary CPU while the queue is empty.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <crypto_mod.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <utils_def.h>
+#include <xlat_mmu_helpers.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+#include "bl2_private.h"
+
+#define SHS_QUEUE_DEPTH		U(8)
+
+#define SHS_STATE_OFF		U(0)
+#define SHS_STATE_RUNNING	U(1)
+#define SHS_STATE_STOP		U(2)
+#define SHS_STATE_STOPPED	U(3)
+
+#ifdef MBEDTLS_SHA512_C
+#define SHS_ALGS	(CRYPTO_HASH_SHA256 | CRYPTO_HASH_SHA384 | \
+			 CRYPTO_HASH_SHA512)
+#else
+#define SHS_ALGS	CRYPTO_HASH_SHA256
+#endif
+
+/* Configuration of the MMU of the primary CPU, from the translation tables
+ * library */
+extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
+
+void bl2_secondary_entrypoint(void);
+__dead2 void bl2_secondary_hash_main(void);
+
+typedef struct shs_job {
+	uintptr_t data;
+	size_t len;
+} shs_job_t;
+
+static shs_job_t shs_queue[SHS_QUEUE_DEPTH];
+static volatile unsigned int shs_head;
+static volatile unsigned int shs_tail;
+static volatile unsigned int shs_state;
+static volatile int shs_error;
+
+static unsigned int shs_alg;
+static union {
+	mbedtls_sha256_context sha256;
+#ifdef MBEDTLS_SHA512_C
+	mbedtls_sha512_context sha512;
+#endif
+} shs_ctx;
+
+static int shs_update(const shs_job_t *job)
+{
+	switch (shs_alg) {
+	case CRYPTO_HASH_SHA256:
+		return mbedtls_sha256_update_ret(&shs_ctx.sha256,
+				(const unsigned char *)job->data, job->len);
+#ifdef MBEDTLS_SHA512_C
+	case CRYPTO_HASH_SHA384:
+	case CRYPTO_HASH_SHA512:
+		return mbedtls_sha512_update_ret(&shs_ctx.sha512,
+				(const unsigned char *)job->data, job->len);
+#endif
+	default:
+		return -EINVAL;
+	}
+}
+
+/*
+ * Main loop of the secondary CPU. It hashes the queued data until the primary
+ * CPU asks it to stop, then leaves BL2 through the platform.
+ */
+void bl2_secondary_hash_main(void)
+{
+	unsigned int head = shs_head;
+	int ret;
+
+	shs_state = SHS_STATE_RUNNING;
+	dsbish();
+	sev();
+
+	for (;;) {
+		while ((head == shs_tail) && (shs_state != SHS_STATE_STOP)) {
+			wfe();
+		}
+
+		/* Only stop once all the queued data has been hashed */
+		if (head == shs_tail) {
+			break;
+		}
+
+		/* Read the job after the index that published it */
+		dmbishld();
+
+		ret = shs_update(&shs_queue[head]);
+		if (ret != 0) {
+			shs_error = -EIO;
+		}
+
+		/* Release the job and the hash state to the primary CPU */
+		dmbish();
+		head = (head + 1U) % SHS_QUEUE_DEPTH;
+		shs_head = head;
+		dsbish();
+		sev();
+	}
+
+	shs_state = SHS_STATE_STOPPED;
+	dsbish();
+	sev();
+
+	plat_bl2_secondary_exit();
+}
+
+static int shs_start(unsigned int alg)
+{
+	int ret;
+
+	if (shs_state != SHS_STATE_RUNNING) {
+		return -ENODEV;
+	}
+
+	/* The secondary CPU must not be using the context */
+	if (shs_head != shs_tail) {
+		return -EBUSY;
+	}
+
+	switch (alg) {
+	case CRYPTO_HASH_SHA256:
+		mbedtls_sha256_init(&shs_ctx.sha256);
+		ret = mbedtls_sha256_starts_ret(&shs_ctx.sha256, 0);
+		break;
+#ifdef MBEDTLS_SHA512_C
+	case CRYPTO_HASH_SHA384:
+	case CRYPTO_HASH_SHA512:
+		mbedtls_sha512_init(&shs_ctx.sha512);
+		ret = mbedtls_sha512_starts_ret(&shs_ctx.sha512,
+				(alg == CRYPTO_HASH_SHA384) ? 1 : 0);
+		break;
+#endif
+	default:
+		return -EINVAL;
+	}
+
+	if (ret != 0) {
+		return -EIO;
+	}
+
+	shs_alg = alg;
+	shs_error = 0;
+
+	/* Publish the context before any job */
+	dmbish();
+
+	return 0;
+}
+
+static int shs_submit(uintptr_t data, size_t len)
+{
+	unsigned int tail = shs_tail;
+	unsigned int next = (tail + 1U) % SHS_QUEUE_DEPTH;
+
+	assert(shs_state == SHS_STATE_RUNNING);
+
+	/* One job is kept free to tell a full ring from an empty one */
+	if (next == shs_head) {
+		return -EBUSY;
+	}
+
+	shs_queue[tail].data = data;
+	shs_queue[tail].len = len;
+
+	/* Write the job before the index that publishes it */
+	dmbish();
+	shs_tail = next;
+	dsbish();
+	sev();
+
+	return 0;
+}
+
+static int shs_poll(void)
+{
+	if (shs_head != shs_tail) {
+		return -EBUSY;
+	}
+
+	/* Read the hash state after the index that released it */
+	dmbishld();
+
+	return shs_error;
+}
+
+static int shs_finish(void *digest, size_t digest_len)
+{
+	unsigned char output[64];
+	size_t len;
+	int ret;
+
+	assert(digest != NULL);
+
+	if (shs_head != shs_tail) {
+		return -EBUSY;
+	}
+
+	dmbishld();
+
+	switch (shs_alg) {
+	case CRYPTO_HASH_SHA256:
+		len = 32U;
+		ret = mbedtls_sha256_finish_ret(&shs_ctx.sha256, output);
+		mbedtls_sha256_free(&shs_ctx.sha256);
+		break;
+#ifdef MBEDTLS_SHA512_C
+	case CRYPTO_HASH_SHA384:
+	case CRYPTO_HASH_SHA512:
+		len = (shs_alg == CRYPTO_HASH_SHA384) ? 48U : 64U;
+		ret = mbedtls_sha512_finish_ret(&shs_ctx.sha512, output);
+		mbedtls_sha512_free(&shs_ctx.sha512);
+		break;
+#endif
+	default:
+		return -EINVAL;
+	}
+
+	if ((ret != 0) || (shs_error != 0)) {
+		return -EIO;
+	}
+
+	if (digest_len < len) {
+		return -EINVAL;
+	}
+
+	(void)memcpy(digest, output, len);
+
+	return 0;
+}
+
+static const crypto_hash_engine_t shs_engine = {
+	.name = "BL2 secondary CPU",
+	.algs = SHS_ALGS,
+	.start = shs_start,
+	.submit = shs_submit,
+	.poll = shs_poll,
+	.finish = shs_finish
+};
+
+/*
+ * Release a secondary CPU and register it as hash engine. If no secondary CPU
+ * is available, the images are hashed on the primary CPU as usual.
+ */
+void bl2_secondary_hash_init(void)
+{
+	int ret;
+
+	/* A hardware engine is always faster */
+	if (crypto_mod_get_hash_engine(SHS_ALGS) != NULL) {
+		return;
+	}
+
+	/*
+	 * The secondary CPU reads the MMU configuration with its data cache
+	 * disabled. The translation tables themselves are then walked with the
+	 * same cacheability as on the primary CPU.
+	 */
+	flush_dcache_range((uintptr_t)mmu_cfg_params, sizeof(mmu_cfg_params));
+
+	ret = plat_bl2_secondary_start((uintptr_t)bl2_secondary_entrypoint);
+	if (ret != 0) {
+		WARN("BL2: No secondary CPU for hashing (%d)\n", ret);
+		return;
+	}
+
+	while (shs_state != SHS_STATE_RUNNING) {
+		wfe();
+	}
+
+	crypto_mod_register_hash_engine(&shs_engine);
+}
+
+/*
+ * Ask the secondary CPU to leave BL2 and wait for it to stop using BL2 memory.
+ * This must be called before handing over to the next image.
+ */
+void bl2_secondary_hash_stop(void)
+{
+	if (shs_state != SHS_STATE_RUNNING) {
+		return;
+	}
+
+	shs_state = SHS_STATE_STOP;
+	dsbish();
+	sev();
+
+	while (shs_state != SHS_STATE_STOPPED) {
+		wfe();
+	}
+}
@@ -44,14 +44,62 @@ ifeq (${ENABLE_PMF}, 1)
 BL31_SOURCES		+=	lib/pmf/pmf_main.c
 endif
 
+ifeq (${ENABLE_SMC_LATENCY_HIST}, 1)
+BL31_SOURCES		+=	lib/pmf/pmf_smc_hist.c
+endif
+
+ifeq (${ENABLE_PSCI_SUSPEND_TRACE}, 1)
+BL31_SOURCES		+=	lib/pmf/pmf_suspend_trace.c
+endif
+
 ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
 
+ifeq (${PUBSUB_STATIC_DISPATCH},1)
+BL31_SOURCES		+=	lib/el3_runtime/aarch64/pubsub_call_chains.S
+endif
+
+ifeq (${BOOT_PROFILING},1)
+BL31_SOURCES		+=	lib/boot_prof/boot_prof.c
+endif
+
+ifeq (${EL3_PROFILER},1)
+ifeq (${EL3_EXCEPTION_HANDLING},0)
+  $(error EL3_EXCEPTION_HANDLING must be 1 for the EL3 profiler)
+endif
+BL31_SOURCES		+=	lib/el3_prof/el3_prof.c				\
+				lib/el3_prof/aarch64/el3_prof_entry.S
+endif
+
+ifeq (${ENABLE_LOCK_STATS},1)
+ifneq (${ARCH},aarch64)
+  $(error ENABLE_LOCK_STATS is only supported on AArch64)
+endif
+BL31_SOURCES		+=	lib/locks/lock_stats.c
+endif
+
+ifeq (${SECURE_TIME_BUDGET},1)
+ifeq (${EL3_EXCEPTION_HANDLING},0)
+  $(error EL3_EXCEPTION_HANDLING must be 1 for the secure time budget)
+endif
+BL31_SOURCES		+=	bl31/secure_budget.c
+endif
+
+ifeq (${SIP_BATCH},1)
+ifneq (${ARCH},aarch64)
+  $(error SIP_BATCH is only supported on AArch64)
+endif
+BL31_SOURCES		+=	bl31/sip_batch.c
+endif
+
 ifeq (${SDEI_SUPPORT},1)
 ifeq (${EL3_EXCEPTION_HANDLING},0)
   $(error EL3_EXCEPTION_HANDLING must be 1 for SDEI support)
 endif
+ifeq (${SDEI_DISPATCH_BATCH},0)
+  $(error SDEI_DISPATCH_BATCH must be at least 1)
+endif
 BL31_SOURCES		+=	services/std_svc/sdei/sdei_dispatch.S	\
 				services/std_svc/sdei/sdei_event.c	\
 				services/std_svc/sdei/sdei_intr_mgmt.c	\
@@ -59,6 +107,39 @@ BL31_SOURCES		+=	services/std_svc/sdei/sdei_dispatch.S	\
 				services/std_svc/sdei/sdei_state.c
 endif
 
+# The SDEI event statistics are read through the PMF SMC interface
+ifeq (${SDEI_EVENT_STATS},1)
+ifneq (${SDEI_SUPPORT},1)
+  $(error SDEI_SUPPORT must be 1 for SDEI event statistics)
+endif
+ifneq (${ENABLE_PMF},1)
+  $(error ENABLE_PMF must be 1 for SDEI event statistics)
+endif
+endif
+
+# The per-world AMU statistics are read through the PMF SMC interface
+ifeq (${AMU_WORLD_STATS},1)
+ifneq (${ENABLE_AMU},1)
+  $(error ENABLE_AMU must be 1 for the per-world AMU statistics)
+endif
+ifneq (${ENABLE_PMF},1)
+  $(error ENABLE_PMF must be 1 for the per-world AMU statistics)
+endif
+endif
+
+ifeq (${MPAM_WORLD_PARTID},1)
+ifneq (${ENABLE_MPAM_FOR_LOWER_ELS},1)
+  $(error ENABLE_MPAM_FOR_LOWER_ELS must be 1 for the per-world MPAM partitions)
+endif
+endif
+
+ifeq (${DSU_L3_PARTITIONING},1)
+ifneq (${ARCH},aarch64)
+  $(error DSU_L3_PARTITIONING is only supported on AArch64)
+endif
+BL31_SOURCES		+=	lib/cpus/aarch64/dsu_partition.c
+endif
+
 ifeq (${ENABLE_SPE_FOR_LOWER_ELS},1)
 BL31_SOURCES		+=	lib/extensions/spe/spe.c
 endif
@@ -89,10 +170,38 @@ ifndef CRASH_REPORTING
 CRASH_REPORTING		:=	$(DEBUG)
 endif
 
+ifeq (${CRASH_DUMP_TO_MEMORY},1)
+    ifneq (${CRASH_REPORTING},1)
+        $(error "CRASH_DUMP_TO_MEMORY requires CRASH_REPORTING=1")
+    endif
+endif
+
+$(eval $(call assert_boolean,AMU_WORLD_STATS))
+$(eval $(call assert_boolean,CRASH_DUMP_TO_MEMORY))
 $(eval $(call assert_boolean,CRASH_REPORTING))
+$(eval $(call assert_boolean,DSU_L3_PARTITIONING))
 $(eval $(call assert_boolean,EL3_EXCEPTION_HANDLING))
+$(eval $(call assert_boolean,ENABLE_LOCK_STATS))
+$(eval $(call assert_boolean,EL3_PROFILER))
+$(eval $(call assert_boolean,MPAM_WORLD_PARTID))
+$(eval $(call assert_boolean,SDEI_EVENT_STATS))
 $(eval $(call assert_boolean,SDEI_SUPPORT))
+$(eval $(call assert_boolean,SECURE_TIME_BUDGET))
+$(eval $(call assert_boolean,SIP_BATCH))
+$(eval $(call assert_numeric,EL3_PROFILER_SAMPLES))
+$(eval $(call assert_numeric,SDEI_DISPATCH_BATCH))
 
+$(eval $(call add_define,AMU_WORLD_STATS))
+$(eval $(call add_define,CRASH_DUMP_TO_MEMORY))
 $(eval $(call add_define,CRASH_REPORTING))
+$(eval $(call add_define,DSU_L3_PARTITIONING))
 $(eval $(call add_define,EL3_EXCEPTION_HANDLING))
+$(eval $(call add_define,ENABLE_LOCK_STATS))
+$(eval $(call add_define,EL3_PROFILER))
+$(eval $(call add_define,EL3_PROFILER_SAMPLES))
+$(eval $(call add_define,MPAM_WORLD_PARTID))
+$(eval $(call add_define,SDEI_DISPATCH_BATCH))
+$(eval $(call add_define,SDEI_EVENT_STATS))
 $(eval $(call add_define,SDEI_SUPPORT))
+$(eval $(call add_define,SECURE_TIME_BUDGET))
+$(eval $(call add_define,SIP_BATCH))
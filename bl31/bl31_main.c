@@ -9,14 +9,18 @@
 #include <assert.h>
 #include <bl31.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <console.h>
 #include <context_mgmt.h>
 #include <debug.h>
+#include <dsu_partition.h>
 #include <ehf.h>
+#include <el3_prof.h>
 #include <platform.h>
 #include <pmf.h>
 #include <runtime_instr.h>
 #include <runtime_svc.h>
+#include <secure_budget.h>
 #include <std_svc.h>
 #include <string.h>
 
@@ -72,6 +76,8 @@ void __init bl31_lib_init(void)
  ******************************************************************************/
 void bl31_main(void)
 {
+	boot_prof_record(BOOT_PROF_STAGE_ENTRY, BOOT_PROF_NO_ID);
+
 	NOTICE("BL31: %s\n", version_string);
 	NOTICE("BL31: %s\n", build_message);
 
@@ -86,6 +92,24 @@ void bl31_main(void)
 	ehf_init();
 #endif
 
+#if EL3_PROFILER
+	el3_prof_init();
+#endif
+
+#if SECURE_TIME_BUDGET
+	secure_budget_init();
+#endif
+
+#if MPAM_WORLD_PARTID
+	/* Configure the partitions in the MPAM memory system components */
+	plat_mpam_msc_setup();
+#endif
+
+#if DSU_L3_PARTITIONING
+	/* Partition the L3 cache of the clusters between the worlds */
+	dsu_partition_setup();
+#endif
+
 	/* Initialize the runtime services e.g. psci. */
 	INFO("BL31: Initializing runtime services\n");
 	runtime_svc_init();
@@ -179,6 +203,8 @@ void __init bl31_prepare_next_image_entry(void)
 	print_entry_point_info(next_image_info);
 	cm_init_my_context(next_image_info);
 	cm_prepare_el3_exit(image_type);
+
+	boot_prof_record(BOOT_PROF_STAGE_EXIT, image_type);
 }
 
 /*******************************************************************************
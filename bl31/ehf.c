@@ -17,6 +17,7 @@
 #include <gic_common.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <pubsub_events.h>
 #include <stdbool.h>
 
@@ -49,6 +50,20 @@
 /* To be defined by the platform */
 extern const ehf_priorities_t exception_data;
 
+/* Maximum number of priority levels, one per bit of the priority stack */
+#define EHF_MAX_PRIORITIES	(sizeof(ehf_pri_bits_t) * 8U)
+
+/*
+ * Handlers of the priority levels, indexed like the priority descriptors of
+ * the platform, or NULL if a level is not valid or has no handler yet. It is
+ * built from the descriptors by ehf_init() and kept in step with them by
+ * ehf_register_priority_handler(), so that the EL3 interrupt handler reads the
+ * handler directly instead of decoding the descriptor. It is only written at
+ * boot, and kept in its own cache lines.
+ */
+static ehf_handler_t ehf_handlers[EHF_MAX_PRIORITIES]
+	__aligned(CACHE_WRITEBACK_GRANULE);
+
 /* Translate priority to the index in the priority array */
 static unsigned int pri_to_idx(unsigned int priority)
 {
@@ -149,6 +164,10 @@ void ehf_activate_priority(unsigned int priority)
 	if (cur_pri_idx == EHF_INVALID_IDX)
 		pe_data->init_pri_mask = (uint8_t) old_mask;
 
+#if EL3_EXCEPTION_PMR_TRACKING
+	pe_data->pri_mask = (uint8_t) priority;
+#endif
+
 	EHF_LOG("activate prio=%d\n", get_pe_highest_active_idx(pe_data));
 }
 
@@ -204,6 +223,14 @@ void ehf_deactivate_priority(unsigned int priority)
 	cur_pri_idx = get_pe_highest_active_idx(pe_data);
 	if (cur_pri_idx == EHF_INVALID_IDX)
 		old_mask = plat_ic_set_priority_mask(pe_data->init_pri_mask);
+#if EL3_EXCEPTION_PMR_TRACKING
+	/*
+	 * The Priority Mask programmed for the deactivated level already masks
+	 * the lower priority levels that are still active.
+	 */
+	else if (pe_data->pri_mask == priority)
+		old_mask = pe_data->pri_mask;
+#endif
 	else
 		old_mask = plat_ic_set_priority_mask(priority);
 
@@ -386,6 +413,29 @@ unsigned int ehf_is_ns_preemption_allowed(void)
 	return 1;
 }
 
+/*
+ * Return whether the top-level handler can handle another EL3 interrupt before
+ * returning from the exception, having handled 'count' interrupts. The handler
+ * of the last one must have completed it in EL3, i.e. the running priority has
+ * dropped below its priority 'pri' and no priority level has been activated to
+ * delegate it to a lower EL. Another EL3 interrupt must also be pending.
+ */
+static bool ehf_can_handle_next_interrupt(const pe_exc_data_t *pe_data,
+		ehf_pri_bits_t active_pri_bits, unsigned int pri,
+		unsigned int count)
+{
+	if (count >= EL3_EXCEPTION_INTR_BATCH)
+		return false;
+
+	if (pe_data->active_pri_bits != active_pri_bits)
+		return false;
+
+	if (plat_ic_get_running_priority() <= pri)
+		return false;
+
+	return plat_ic_get_pending_interrupt_type() == INTR_TYPE_EL3;
+}
+
 /*
  * Top-level EL3 interrupt handler.
  */
@@ -394,8 +444,10 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 {
 	int ret = 0;
 	uint32_t intr_raw;
-	unsigned int intr, pri, idx;
+	unsigned int intr, pri, idx, count = 0U;
 	ehf_handler_t handler;
+	pe_exc_data_t *pe_data = this_cpu_data();
+	ehf_pri_bits_t active_pri_bits = pe_data->active_pri_bits;
 
 	/*
 	 * Top-level interrupt type handler from Interrupt Management Framework
@@ -405,45 +457,59 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 	assert(id == INTR_ID_UNAVAILABLE);
 
 	/*
-	 * Acknowledge interrupt. Proceed with handling only for valid interrupt
-	 * IDs. This situation may arise because of Interrupt Management
-	 * Framework identifying an EL3 interrupt, but before it's been
-	 * acknowledged here, the interrupt was either deasserted, or there was
-	 * a higher-priority interrupt of another type.
+	 * Handle the EL3 interrupts that are pending, up to
+	 * EL3_EXCEPTION_INTR_BATCH, as long as their handlers complete them in
+	 * EL3.
 	 */
-	intr_raw = plat_ic_acknowledge_interrupt();
-	intr = plat_ic_get_interrupt_id(intr_raw);
-	if (intr == INTR_ID_UNAVAILABLE)
-		return 0;
-
-	/* Having acknowledged the interrupt, get the running priority */
-	pri = plat_ic_get_running_priority();
-
-	/* Check EL3 interrupt priority is in secure range */
-	assert(IS_PRI_SECURE(pri));
-
-	/*
-	 * Translate the priority to a descriptor index. We do this by masking
-	 * and shifting the running priority value (platform-supplied).
-	 */
-	idx = pri_to_idx(pri);
-
-	/* Validate priority */
-	assert(pri == IDX_TO_PRI(idx));
-
-	handler = (ehf_handler_t) RAW_HANDLER(
-			exception_data.ehf_priorities[idx].ehf_handler);
-	if (handler == NULL) {
-		ERROR("No EL3 exception handler for priority 0x%x\n",
-				IDX_TO_PRI(idx));
-		panic();
-	}
-
-	/*
-	 * Call registered handler. Pass the raw interrupt value to registered
-	 * handlers.
-	 */
-	ret = handler(intr_raw, flags, handle, cookie);
+	do {
+		/*
+		 * Acknowledge interrupt. Proceed with handling only for valid
+		 * interrupt IDs. This situation may arise because of Interrupt
+		 * Management Framework identifying an EL3 interrupt, but before
+		 * it's been acknowledged here, the interrupt was either
+		 * deasserted, or there was a higher-priority interrupt of
+		 * another type.
+		 */
+		intr_raw = plat_ic_acknowledge_interrupt();
+		intr = plat_ic_get_interrupt_id(intr_raw);
+		if (intr == INTR_ID_UNAVAILABLE)
+			return (uint64_t) ret;
+
+		/*
+		 * Having acknowledged the interrupt, get the running priority
+		 */
+		pri = plat_ic_get_running_priority();
+
+		/* Check EL3 interrupt priority is in secure range */
+		assert(IS_PRI_SECURE(pri));
+
+		/*
+		 * Translate the priority to a descriptor index. We do this by
+		 * masking and shifting the running priority value
+		 * (platform-supplied).
+		 */
+		idx = EHF_PRI_TO_IDX(pri, exception_data.pri_bits);
+		assert(idx < exception_data.num_priorities);
+
+		/* Validate priority */
+		assert(pri == IDX_TO_PRI(idx));
+
+		handler = ehf_handlers[idx];
+		if (handler == NULL) {
+			ERROR("No EL3 exception handler for priority 0x%x\n",
+					IDX_TO_PRI(idx));
+			panic();
+		}
+
+		/*
+		 * Call registered handler. Pass the raw interrupt value to
+		 * registered handlers.
+		 */
+		ret = handler(intr_raw, flags, handle, cookie);
+
+		count++;
+	} while (ehf_can_handle_next_interrupt(pe_data, active_pri_bits, pri,
+			count));
 
 	return (uint64_t) ret;
 }
@@ -454,6 +520,7 @@ static uint64_t ehf_el3_interrupt_handler(uint32_t id, uint32_t flags,
 void __init ehf_init(void)
 {
 	unsigned int flags = 0;
+	unsigned int idx;
 	int ret __unused;
 
 	/* Ensure EL3 interrupts are supported */
@@ -463,7 +530,7 @@ void __init ehf_init(void)
 	 * Make sure that priority water mark has enough bits to represent the
 	 * whole priority array.
 	 */
-	assert(exception_data.num_priorities <= (sizeof(ehf_pri_bits_t) * 8U));
+	assert(exception_data.num_priorities <= EHF_MAX_PRIORITIES);
 
 	assert(exception_data.ehf_priorities != NULL);
 
@@ -474,6 +541,12 @@ void __init ehf_init(void)
 	assert((exception_data.pri_bits >= 1U) ||
 			(exception_data.pri_bits < 8U));
 
+	/* Decode the handlers already provided in the descriptors */
+	for (idx = 0U; idx < exception_data.num_priorities; idx++) {
+		ehf_handlers[idx] = RAW_HANDLER(
+				exception_data.ehf_priorities[idx].ehf_handler);
+	}
+
 	/* Route EL3 interrupts when in Secure and Non-secure. */
 	set_interrupt_rm_flag(flags, NON_SECURE);
 	set_interrupt_rm_flag(flags, SECURE);
@@ -517,6 +590,7 @@ void ehf_register_priority_handler(unsigned int pri, ehf_handler_t handler)
 	 */
 	exception_data.ehf_priorities[idx].ehf_handler =
 		(((uintptr_t) handler) | EHF_PRI_VALID_);
+	ehf_handlers[idx] = handler;
 
 	EHF_LOG("register pri=0x%x handler=%p\n", pri, handler);
 }
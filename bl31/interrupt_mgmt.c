@@ -34,13 +34,20 @@
  *                 two security states.
  ******************************************************************************/
 typedef struct intr_type_desc {
-	interrupt_type_handler_t handler;
 	uint32_t flags;
 	uint32_t scr_el3[2];
 } intr_type_desc_t;
 
 static intr_type_desc_t intr_type_descs[MAX_INTR_TYPES];
 
+/*******************************************************************************
+ * Handlers registered for each interrupt type, NULL if there is none. They are
+ * kept apart from the descriptors so that the interrupt exception vectors can
+ * load the handler of the pending interrupt type directly, without a call to
+ * get_interrupt_type_handler().
+ ******************************************************************************/
+interrupt_type_handler_t intr_type_handlers[MAX_INTR_TYPES];
+
 /*******************************************************************************
  * This function validates the interrupt type.
  ******************************************************************************/
@@ -149,7 +156,7 @@ int disable_intr_rm_local(uint32_t type, uint32_t security_state)
 {
 	uint32_t bit_pos, flag;
 
-	assert(intr_type_descs[type].handler != NULL);
+	assert(intr_type_handlers[type] != NULL);
 
 	flag = get_interrupt_rm_flag(INTR_DEFAULT_RM, security_state);
 
@@ -167,7 +174,7 @@ int enable_intr_rm_local(uint32_t type, uint32_t security_state)
 {
 	uint32_t bit_pos, flag;
 
-	assert(intr_type_descs[type].handler != NULL);
+	assert(intr_type_handlers[type] != NULL);
 
 	flag = get_interrupt_rm_flag(intr_type_descs[type].flags,
 				security_state);
@@ -198,7 +205,7 @@ int32_t register_interrupt_type_handler(uint32_t type,
 		return -EINVAL;
 
 	/* Check if a handler has already been registered */
-	if (intr_type_descs[type].handler != NULL)
+	if (intr_type_handlers[type] != NULL)
 		return -EALREADY;
 
 	rc = set_routing_model(type, flags);
@@ -206,7 +213,7 @@ int32_t register_interrupt_type_handler(uint32_t type,
 		return rc;
 
 	/* Save the handler */
-	intr_type_descs[type].handler = handler;
+	intr_type_handlers[type] = handler;
 
 	return 0;
 }
@@ -221,6 +228,6 @@ interrupt_type_handler_t get_interrupt_type_handler(uint32_t type)
 	if (validate_interrupt_type(type) != 0)
 		return NULL;
 
-	return intr_type_descs[type].handler;
+	return intr_type_handlers[type];
 }
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cdefs.h>
+#include <debug.h>
+#include <ehf.h>
+#include <interrupt_mgmt.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <secure_budget.h>
+
+#ifndef PLAT_SECURE_BUDGET_PRI
+#error "Platform must define PLAT_SECURE_BUDGET_PRI for the secure time budget"
+#endif
+
+/* Default budget of a yielding call, in microseconds */
+#ifndef PLAT_SECURE_BUDGET_US
+#define PLAT_SECURE_BUDGET_US	10000U
+#endif
+
+/*
+ * Dispatcher function to call when the budget of the call running on a CPU
+ * runs out, NULL if no budget is running. It is only accessed by its CPU.
+ */
+typedef struct secure_budget {
+	secure_budget_preempt_t preempt;
+	uint64_t expiries;
+} __aligned(CACHE_WRITEBACK_GRANULE) secure_budget_t;
+
+static secure_budget_t secure_budgets[PLATFORM_CORE_COUNT];
+
+/* Budget of a yielding call in ticks of the system counter */
+static uint64_t secure_budget_ticks;
+
+/*
+ * Handler of the timer interrupt. The interrupt is completed before the
+ * dispatcher is called, so that the Exception Handling Framework restores the
+ * Non-secure priority mask on the way out. An expiry racing with the end of
+ * the call, taken once the Non-secure world runs, is ignored.
+ */
+static int secure_budget_handler(uint32_t intr_raw, uint32_t flags,
+		void *handle, void *cookie)
+{
+	secure_budget_t *budget = &secure_budgets[plat_my_core_pos()];
+	secure_budget_preempt_t preempt = budget->preempt;
+
+	plat_secure_budget_timer_disarm();
+	plat_ic_end_of_interrupt(intr_raw);
+
+	if ((preempt == NULL) || (get_interrupt_src_ss(flags) != SECURE))
+		return 0;
+
+	budget->preempt = NULL;
+	budget->expiries++;
+
+	VERBOSE("BL31: Secure call preempted after %u us (%llu times)\n",
+		PLAT_SECURE_BUDGET_US, (unsigned long long)budget->expiries);
+
+	(void)preempt(handle);
+
+	return 0;
+}
+
+/*
+ * Start the budget of the yielding call that the calling CPU is about to
+ * process or resume in S-EL1. `preempt` is called if it runs out.
+ */
+void secure_budget_start(secure_budget_preempt_t preempt)
+{
+	assert(preempt != NULL);
+
+	secure_budgets[plat_my_core_pos()].preempt = preempt;
+	plat_secure_budget_timer_arm(read_cntpct_el0() + secure_budget_ticks);
+}
+
+/*
+ * Stop the budget of the yielding call of the calling CPU, which has completed
+ * or has been preempted. It does nothing if no budget is running.
+ */
+void secure_budget_stop(void)
+{
+	secure_budget_t *budget = &secure_budgets[plat_my_core_pos()];
+
+	if (budget->preempt == NULL)
+		return;
+
+	plat_secure_budget_timer_disarm();
+	budget->preempt = NULL;
+}
+
+void __init secure_budget_init(void)
+{
+	secure_budget_ticks = ((uint64_t)plat_get_syscnt_freq2() *
+			       PLAT_SECURE_BUDGET_US) / 1000000U;
+	assert(secure_budget_ticks != 0U);
+
+	ehf_register_priority_handler(PLAT_SECURE_BUDGET_PRI,
+				      secure_budget_handler);
+}
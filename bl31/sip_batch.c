@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <context.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <sip_batch.h>
+#include <smccc.h>
+#include <smccc_helpers.h>
+#include <utils.h>
+#include <utils_def.h>
+
+#if !defined(PLAT_SIP_BATCH_BUF_BASE) || !defined(PLAT_SIP_BATCH_BUF_SIZE)
+#error "Platform must define the Non-secure buffer of the SiP call batches"
+#endif
+
+/* Area of the buffer of each CPU, holding a whole number of records */
+#define SIP_BATCH_AREA_SIZE						\
+	(((PLAT_SIP_BATCH_BUF_SIZE) / PLATFORM_CORE_COUNT) /		\
+	 sizeof(sip_batch_rec_t) * sizeof(sip_batch_rec_t))
+
+CASSERT(SIP_BATCH_AREA_SIZE >= sizeof(sip_batch_rec_t),
+	assert_sip_batch_area_size);
+
+/*
+ * Context given as `handle` to the handler of each batched call, in which it
+ * writes the values it returns. It is only accessed by its CPU.
+ */
+static cpu_context_t sip_batch_ctx[PLATFORM_CORE_COUNT];
+
+/* Maximum number of records in a batch */
+unsigned int sip_batch_max_records(void)
+{
+	return SIP_BATCH_AREA_SIZE / sizeof(sip_batch_rec_t);
+}
+
+/*
+ * Run the first `num` records of the area of the calling CPU through the
+ * `handler` of the SiP service that received the batch call `batch_fid`, with
+ * the `cookie` and `flags` of that call. The calls are run in order, and the
+ * batch stops at the first one that is not a fast call of the SiP service
+ * allowed by `allowed`, whose record then returns SMC_UNK. The number of calls
+ * that have been run is returned in `done`.
+ *
+ * The records are read once before being used, as the Normal world may write
+ * them while they are handled.
+ */
+int sip_batch_run(uint32_t batch_fid, unsigned int num,
+		  rt_svc_handle_t handler, sip_batch_allowed_t allowed,
+		  void *cookie, u_register_t flags, unsigned int *done)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	volatile sip_batch_rec_t *rec = (volatile sip_batch_rec_t *)
+		(PLAT_SIP_BATCH_BUF_BASE + (core_pos * SIP_BATCH_AREA_SIZE));
+	cpu_context_t *ctx = &sip_batch_ctx[core_pos];
+	gp_regs_t *gp_regs = get_gpregs_ctx(ctx);
+	u_register_t args[4];
+	uint32_t smc_fid;
+	unsigned int i, j;
+
+	assert((handler != NULL) && (allowed != NULL) && (done != NULL));
+
+	*done = 0U;
+
+	if (num > sip_batch_max_records())
+		return SIP_BATCH_E_PARAM;
+
+	for (i = 0U; i < num; i++, rec++) {
+		smc_fid = (uint32_t)rec->smc_fid;
+		for (j = 0U; j < ARRAY_SIZE(args); j++)
+			args[j] = rec->args[j];
+
+		if ((smc_fid == batch_fid) ||
+		    (GET_SMC_TYPE(smc_fid) != SMC_TYPE_FAST) ||
+		    (GET_SMC_OEN(smc_fid) != OEN_SIP_START) ||
+		    !allowed(smc_fid)) {
+			rec->ret[0] = (uint64_t)SMC_UNK;
+			return SIP_BATCH_E_DENIED;
+		}
+
+		/* The upper halves of the arguments of SMC32 calls are ignored */
+		if (GET_SMC_CC(smc_fid) == SMC_32) {
+			for (j = 0U; j < ARRAY_SIZE(args); j++)
+				args[j] = (uint32_t)args[j];
+		}
+
+		zeromem(gp_regs, CTX_GPREG_X8);
+
+		(void)handler(smc_fid, args[0], args[1], args[2], args[3],
+			      cookie, ctx, flags);
+
+		for (j = 0U; j < ARRAY_SIZE(rec->ret); j++)
+			rec->ret[j] = read_ctx_reg(gp_regs,
+					CTX_GPREG_X0 + (j << DWORD_SHIFT));
+
+		(*done)++;
+	}
+
+	return SMC_OK;
+}
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2013-2016, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -25,6 +25,17 @@ TSP_INIT_ASYNC         :=      0
 $(eval $(call assert_boolean,TSP_INIT_ASYNC))
 $(eval $(call add_define,TSP_INIT_ASYNC))
 
+# This flag makes the TSP run SMC latency micro-benchmarks during its cold boot
+# initialisation and print the results.
+TSP_BENCHMARK		:=	0
+
+$(eval $(call assert_boolean,TSP_BENCHMARK))
+$(eval $(call add_define,TSP_BENCHMARK))
+
+ifeq (${TSP_BENCHMARK},1)
+BL32_SOURCES		+=	bl32/tsp/tsp_bench.c
+endif
+
 # Include the platform-specific TSP Makefile
 # If no platform-specific TSP Makefile exists, it means TSP is not supported
 # on this platform.
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <arm_arch_svc.h>
+#include <debug.h>
+#include <stdint.h>
+#include <tsp.h>
+#include <utils_def.h>
+#include "tsp_private.h"
+
+/*
+ * Micro-benchmarks of the SMC round trips that the TSP can make during its
+ * cold boot initialisation. Each benchmark is run TSP_BENCH_SAMPLES times and
+ * the minimum, median and 99th percentile latencies are reported in system
+ * counter ticks, so that regressions in the Secure Monitor are visible in the
+ * boot log.
+ */
+#define TSP_BENCH_SAMPLES	U(128)
+
+typedef struct tsp_bench {
+	const char *name;
+	uint32_t smc_fid;
+} tsp_bench_t;
+
+static const tsp_bench_t tsp_benches[] = {
+	/* Handled by the Arm Architecture Service, in BL31 only */
+	{ "null SMC", SMCCC_VERSION },
+	/* Handled by the TSPD, through the Trusted OS dispatch */
+	{ "TSPD SMC", TSP_GET_ARGS },
+};
+
+static uint64_t tsp_bench_samples[TSP_BENCH_SAMPLES];
+
+static void tsp_bench_sort(uint64_t *samples, unsigned int count)
+{
+	unsigned int i, j;
+	uint64_t s;
+
+	for (i = 1U; i < count; i++) {
+		s = samples[i];
+		for (j = i; (j > 0U) && (samples[j - 1U] > s); j--)
+			samples[j] = samples[j - 1U];
+		samples[j] = s;
+	}
+}
+
+/*******************************************************************************
+ * Run the SMC micro-benchmarks on the current CPU and print their results
+ ******************************************************************************/
+void tsp_bench_run(void)
+{
+	const tsp_bench_t *bench;
+	uint64_t start;
+	unsigned int i, j;
+
+	NOTICE("TSP: SMC latency in ticks of %lu Hz (min/median/p99)\n",
+	       (unsigned long)read_cntfrq_el0());
+
+	for (i = 0U; i < ARRAY_SIZE(tsp_benches); i++) {
+		bench = &tsp_benches[i];
+
+		/* Warm up the caches and branch predictors */
+		(void)tsp_bench_smc(bench->smc_fid);
+
+		for (j = 0U; j < TSP_BENCH_SAMPLES; j++) {
+			isb();
+			start = read_cntpct_el0();
+			(void)tsp_bench_smc(bench->smc_fid);
+			isb();
+			tsp_bench_samples[j] = read_cntpct_el0() - start;
+		}
+
+		tsp_bench_sort(tsp_bench_samples, TSP_BENCH_SAMPLES);
+
+		NOTICE("TSP:   %s: %llu/%llu/%llu\n", bench->name,
+		       (unsigned long long)tsp_bench_samples[0],
+		       (unsigned long long)
+			tsp_bench_samples[TSP_BENCH_SAMPLES / 2U],
+		       (unsigned long long)
+			tsp_bench_samples[(TSP_BENCH_SAMPLES * 99U) / 100U]);
+	}
+}
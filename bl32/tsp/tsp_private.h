@@ -61,6 +61,8 @@ typedef struct tsp_args {
 CASSERT(TSP_ARGS_SIZE == sizeof(tsp_args_t), assert_sp_args_size_mismatch);
 
 void tsp_get_magic(uint64_t args[4]);
+uint64_t tsp_bench_smc(uint32_t smc_fid);
+void tsp_bench_run(void);
 
 tsp_args_t *tsp_cpu_resume_main(uint64_t max_off_pwrlvl,
 				uint64_t arg1,
@@ -9,6 +9,7 @@
 #include <assert.h>
 #include <auth_mod.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <debug.h>
 #include <errno.h>
 #include <io_storage.h>
@@ -143,22 +144,154 @@ size_t get_image_size(unsigned int image_id)
 	return image_size;
 }
 
+#if TRUSTED_BOARD_BOOT && LOAD_IMAGE_CHUNK_SIZE
+/*******************************************************************************
+ * Internal function to read an image in chunks of LOAD_IMAGE_CHUNK_SIZE bytes
+ * and pass each chunk to the authentication module as soon as it has been
+ * read. Hashing each chunk while it is still in the caches avoids a second
+ * pass over the whole image once it is loaded.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int read_image_chunks(uintptr_t image_handle, uintptr_t image_base,
+			     size_t image_size)
+{
+	size_t offset, chunk_size, bytes_read;
+	int io_result;
+
+	for (offset = 0U; offset < image_size; offset += chunk_size) {
+		chunk_size = MIN(image_size - offset,
+				 (size_t)LOAD_IMAGE_CHUNK_SIZE);
+
+		io_result = io_read(image_handle, image_base + offset,
+				    chunk_size, &bytes_read);
+		if (io_result != 0) {
+			return io_result;
+		}
+		if (bytes_read < chunk_size) {
+			return -EIO;
+		}
+
+		if (auth_mod_verify_img_update((void *)(image_base + offset),
+					       (unsigned int)chunk_size) != 0) {
+			return -EAUTH;
+		}
+	}
+
+	return 0;
+}
+#endif /* TRUSTED_BOARD_BOOT && LOAD_IMAGE_CHUNK_SIZE */
+
+/*******************************************************************************
+ * Internal function to read `size` bytes of an image at `base`. If
+ * 'hash_chunks' is set, they are passed to auth_mod_verify_img_update() while
+ * they are being read.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int read_image_part(uintptr_t image_handle, uintptr_t base, size_t size,
+			   int hash_chunks)
+{
+	size_t bytes_read;
+	int io_result;
+
+#if TRUSTED_BOARD_BOOT && LOAD_IMAGE_CHUNK_SIZE
+	if (hash_chunks != 0) {
+		return read_image_chunks(image_handle, base, size);
+	}
+#endif
+
+	/* TODO: Consider whether to try to recover/retry a partially successful read */
+	io_result = io_read(image_handle, base, size, &bytes_read);
+	if ((io_result == 0) && (bytes_read < size)) {
+		io_result = -EIO;
+	}
+
+	return io_result;
+}
+
+/*******************************************************************************
+ * Internal function to load the head of an image at the image base, then the
+ * rest of it at the addresses returned by the split() callback of `split`.
+ *
+ * Returns 0 on success, a negative error code otherwise.
+ ******************************************************************************/
+static int read_split_image(uintptr_t image_handle, image_info_t *image_data,
+			    size_t image_size, image_split_t *split,
+			    int hash_chunks)
+{
+	size_t head_size, total;
+	unsigned int i;
+	int rc;
+
+	assert(split->split != NULL);
+
+	head_size = MIN(split->head_size, image_size);
+	if (head_size > image_data->image_max_size) {
+		return -EFBIG;
+	}
+	image_data->image_size = (uint32_t)head_size;
+
+	rc = read_image_part(image_handle, image_data->image_base, head_size,
+			     hash_chunks);
+	if (rc != 0) {
+		return rc;
+	}
+
+	split->num_parts = 0U;
+	rc = split->split(split, image_data, image_size);
+	if (rc != 0) {
+		return rc;
+	}
+	assert(split->num_parts <= IMAGE_SPLIT_MAX_PARTS);
+
+	total = head_size;
+	for (i = 0U; i < split->num_parts; i++) {
+		if (split->parts[i].size > (image_size - total)) {
+			return -EINVAL;
+		}
+		total += split->parts[i].size;
+	}
+	if (total != image_size) {
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < split->num_parts; i++) {
+		if (split->parts[i].size == 0U) {
+			continue;
+		}
+
+		INFO("Loading image part at address 0x%lx\n",
+		     split->parts[i].base);
+		rc = read_image_part(image_handle, split->parts[i].base,
+				     split->parts[i].size, hash_chunks);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
 /*******************************************************************************
  * Internal function to load an image at a specific address given
  * an image ID and extents of free memory.
  *
- * If the load is successful then the image information is updated.
+ * If the load is successful then the image information is updated. If
+ * 'hash_chunks' is set, the image is passed to auth_mod_verify_img_update()
+ * while it is being loaded. If `split` is not NULL, the image is loaded in
+ * parts as described by it.
  *
  * Returns 0 on success, a negative error code otherwise.
  ******************************************************************************/
-static int load_image(unsigned int image_id, image_info_t *image_data)
+static int load_image(unsigned int image_id, image_info_t *image_data,
+		      int hash_chunks, image_split_t *split)
 {
 	uintptr_t dev_handle;
 	uintptr_t image_handle;
 	uintptr_t image_spec;
 	uintptr_t image_base;
 	size_t image_size;
-	size_t bytes_read;
 	int io_result;
 
 	assert(image_data != NULL);
@@ -192,6 +325,20 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 		goto exit;
 	}
 
+	if (split != NULL) {
+		io_result = read_split_image(image_handle, image_data,
+					     image_size, split, hash_chunks);
+		if (io_result != 0) {
+			WARN("Failed to load image id=%u (%i)\n", image_id,
+			     io_result);
+			goto exit;
+		}
+
+		INFO("Image id=%u loaded in %u parts\n", image_id,
+		     split->num_parts + 1U);
+		goto exit;
+	}
+
 	/* Check that the image size to load is within limit */
 	if (image_size > image_data->image_max_size) {
 		WARN("Image id=%u size out of bounds\n", image_id);
@@ -206,9 +353,9 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 	image_data->image_size = (uint32_t)image_size;
 
 	/* We have enough space so load the image now */
-	/* TODO: Consider whether to try to recover/retry a partially successful read */
-	io_result = io_read(image_handle, image_base, image_size, &bytes_read);
-	if ((io_result != 0) || (bytes_read < image_size)) {
+	io_result = read_image_part(image_handle, image_base, image_size,
+				    hash_chunks);
+	if (io_result != 0) {
 		WARN("Failed to load image id=%u (%i)\n", image_id, io_result);
 		goto exit;
 	}
@@ -227,45 +374,111 @@ exit:
 	return io_result;
 }
 
+/*******************************************************************************
+ * Internal function to flush the parts of a split image, after zeroing them if
+ * `zero` is set.
+ ******************************************************************************/
+static void flush_image_parts(const image_split_t *split, int zero)
+{
+	unsigned int i;
+
+	if (split == NULL) {
+		return;
+	}
+
+	for (i = 0U; i < split->num_parts; i++) {
+		if (zero != 0) {
+			zero_normalmem((void *)split->parts[i].base,
+				       split->parts[i].size);
+		}
+		flush_dcache_range(split->parts[i].base, split->parts[i].size);
+	}
+}
+
 static int load_auth_image_internal(unsigned int image_id,
 				    image_info_t *image_data,
-				    int is_parent_image)
+				    int is_parent_image,
+				    image_split_t *split)
 {
 	int rc;
+	int hash_chunks = 0;
 
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
 		unsigned int parent_id;
 
-		/* Use recursion to authenticate parent images */
+		/*
+		 * Use recursion to authenticate parent images, unless the
+		 * parameters they provide to this image are already held.
+		 */
 		rc = auth_mod_get_parent_id(image_id, &parent_id);
+#if AUTH_CERT_CACHE
+		if ((rc == 0) && (auth_mod_has_params(parent_id) != 0)) {
+			VERBOSE("Parent image id=%u already authenticated\n",
+				parent_id);
+			rc = 1;	/* Skip the parent */
+		}
+#endif
 		if (rc == 0) {
-			rc = load_auth_image_internal(parent_id, image_data, 1);
+			rc = load_auth_image_internal(parent_id, image_data, 1,
+						      NULL);
 			if (rc != 0) {
 				return rc;
 			}
 		}
+
+#if LOAD_IMAGE_CHUNK_SIZE
+		/* Authenticate the image while it is loaded if possible */
+		if (auth_mod_verify_img_init(image_id) == 0) {
+			hash_chunks = 1;
+		}
+#endif
+
+		/*
+		 * The parts of a split image are only contiguous in the image
+		 * file, so they can only be authenticated while they are loaded.
+		 */
+		if ((split != NULL) && (hash_chunks == 0)) {
+			WARN("Image id=%u can't be hashed in parts, loading it whole\n",
+			     image_id);
+			split = NULL;
+		}
 	}
 #endif /* TRUSTED_BOARD_BOOT */
 
 	/* Load the image */
-	rc = load_image(image_id, image_data);
+	boot_prof_record(BOOT_PROF_LOAD_START, image_id);
+	rc = load_image(image_id, image_data, hash_chunks, split);
+	boot_prof_record(BOOT_PROF_LOAD_END, image_id);
 	if (rc != 0) {
+#if TRUSTED_BOARD_BOOT
+		if (hash_chunks != 0) {
+			/* Abort the authentication */
+			(void)auth_mod_verify_img_finish(image_id);
+		}
+#endif
 		return rc;
 	}
 
 #if TRUSTED_BOARD_BOOT
 	if (dyn_is_auth_disabled() == 0) {
 		/* Authenticate it */
-		rc = auth_mod_verify_img(image_id,
-					 (void *)image_data->image_base,
-					 image_data->image_size);
+		boot_prof_record(BOOT_PROF_AUTH_START, image_id);
+		if (hash_chunks != 0) {
+			rc = auth_mod_verify_img_finish(image_id);
+		} else {
+			rc = auth_mod_verify_img(image_id,
+					(void *)image_data->image_base,
+					image_data->image_size);
+		}
+		boot_prof_record(BOOT_PROF_AUTH_END, image_id);
 		if (rc != 0) {
 			/* Authentication error, zero memory and flush it right away. */
 			zero_normalmem((void *)image_data->image_base,
 			       image_data->image_size);
 			flush_dcache_range(image_data->image_base,
 					   image_data->image_size);
+			flush_image_parts(split, 1);
 			return -EAUTH;
 		}
 	}
@@ -280,6 +493,7 @@ static int load_auth_image_internal(unsigned int image_id,
 	if (is_parent_image == 0) {
 		flush_dcache_range(image_data->image_base,
 				   image_data->image_size);
+		flush_image_parts(split, 0);
 	}
 
 
@@ -298,12 +512,95 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 	int err;
 
 	do {
-		err = load_auth_image_internal(image_id, image_data, 0);
+		err = load_auth_image_internal(image_id, image_data, 0, NULL);
 	} while ((err != 0) && (plat_try_next_boot_source() != 0));
 
 	return err;
 }
 
+/*******************************************************************************
+ * Function to load and authenticate an image in parts, as described by
+ * `split`, e.g. a firmware image whose header gives the load addresses of the
+ * sections that follow it in the same image file. The parts are read straight
+ * to their addresses. When Trusted Board Boot is enabled, they are hashed while
+ * they are read, so the image is loaded whole at the image base instead if the
+ * crypto library can't hash incrementally. Returns the same error codes as
+ * load_auth_image().
+ ******************************************************************************/
+int load_auth_split_image(unsigned int image_id, image_info_t *image_data,
+			  image_split_t *split)
+{
+	int err;
+
+	assert(split != NULL);
+
+	do {
+		err = load_auth_image_internal(image_id, image_data, 0, split);
+	} while ((err != 0) && (plat_try_next_boot_source() != 0));
+
+	return err;
+}
+
+/*******************************************************************************
+ * Function to load an image without authenticating it, for a boot stage that
+ * checks it by other means, e.g. against a hash recorded earlier. Returns the
+ * same error codes as load_auth_image() for the loading operation.
+ ******************************************************************************/
+int load_unauth_image(unsigned int image_id, image_info_t *image_data)
+{
+	int err;
+
+	err = load_image(image_id, image_data, 0, NULL);
+	if (err == 0) {
+		flush_dcache_range(image_data->image_base,
+				   image_data->image_size);
+	}
+
+	return err;
+}
+
+/*******************************************************************************
+ * Function to prepare an image that is not loaded by this boot stage but left
+ * for a later one to load, e.g. by the Non-secure bootloader. When Trusted
+ * Board Boot is enabled, the parents of the image are loaded and authenticated
+ * as for load_auth_image(), in the memory of the image, and `hash` is set to
+ * the hash the image must match. Otherwise, `hash` is set to NULL. Returns 0
+ * on success, or the error code of the loading or authentication of the
+ * parents.
+ ******************************************************************************/
+int auth_deferred_image(unsigned int image_id, image_info_t *image_data,
+			void **hash, unsigned int *hash_len)
+{
+	int err = 0;
+
+	assert(hash != NULL);
+	assert(hash_len != NULL);
+
+	*hash = NULL;
+	*hash_len = 0U;
+
+#if TRUSTED_BOARD_BOOT
+	unsigned int parent_id;
+
+	if ((dyn_is_auth_disabled() != 0) ||
+	    (auth_mod_get_parent_id(image_id, &parent_id) != 0))
+		return 0;
+
+	do {
+#if AUTH_CERT_CACHE
+		if (auth_mod_has_params(parent_id) != 0)
+			break;
+#endif
+		err = load_auth_image_internal(parent_id, image_data, 1, NULL);
+	} while ((err != 0) && (plat_try_next_boot_source() != 0));
+
+	if (err == 0)
+		err = auth_mod_get_img_hash(image_id, hash, hash_len);
+#endif /* TRUSTED_BOARD_BOOT */
+
+	return err;
+}
+
 /*******************************************************************************
  * Print the content of an entry_point_info_t structure.
  ******************************************************************************/
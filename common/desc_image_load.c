@@ -7,25 +7,83 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
+#include <dcache_batch.h>
 #include <desc_image_load.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <tbbr/tbbr_img_def.h>
 
 
 
 static bl_load_info_t bl_load_info;
 static bl_params_t next_bl_params;
 
+/*
+ * Index of the descriptor of each image id below MAX_NUMBER_IDS within the
+ * image descriptor array, or NO_DESC_INDEX if there is none. It is built on
+ * the first look-up, as the array doesn't change once registered. Image ids
+ * beyond MAX_NUMBER_IDS, defined by some platforms, are searched linearly.
+ */
+#define NO_DESC_INDEX		U(0xff)
+
+static uint8_t bl_mem_params_desc_index[MAX_NUMBER_IDS];
+static bool bl_mem_params_desc_indexed;
+
 
 /*******************************************************************************
  * This function flushes the data structures so that they are visible
- * in memory for the next BL image.
+ * in memory for the next BL image. Once the list of executable images has been
+ * created, the next BL image can only reach the descriptors of these images,
+ * so the other descriptors are left alone.
  ******************************************************************************/
 void flush_bl_params_desc(void)
 {
-	flush_dcache_range((uintptr_t)bl_mem_params_desc_ptr,
+	dcache_batch_t batch;
+	const bl_params_node_t *node;
+
+	dcache_batch_init(&batch, DCACHE_BATCH_FLUSH);
+
+	if (next_bl_params.head == NULL) {
+		dcache_batch_add(&batch, (uintptr_t)bl_mem_params_desc_ptr,
 			sizeof(*bl_mem_params_desc_ptr) * bl_mem_params_desc_num);
+	}
+
+	for (node = next_bl_params.head; node != NULL;
+	     node = node->next_params_info) {
+		dcache_batch_add(&batch, (uintptr_t)node -
+			offsetof(bl_mem_params_node_t, params_node_mem),
+			sizeof(bl_mem_params_node_t));
+	}
 
-	flush_dcache_range((uintptr_t)&next_bl_params,
+	dcache_batch_add(&batch, (uintptr_t)&next_bl_params,
 			sizeof(next_bl_params));
+	dcache_batch_finish(&batch);
+}
+
+/*******************************************************************************
+ * This function builds the index of the image descriptor array. If several
+ * descriptors have the same image id, the first one is indexed, as it is the
+ * one a linear search would find.
+ ******************************************************************************/
+static void index_bl_mem_params_desc(void)
+{
+	unsigned int index, image_id;
+
+	assert(bl_mem_params_desc_num < NO_DESC_INDEX);
+
+	(void)memset(bl_mem_params_desc_index, (int)NO_DESC_INDEX,
+		     sizeof(bl_mem_params_desc_index));
+
+	for (index = 0U; index < bl_mem_params_desc_num; index++) {
+		image_id = bl_mem_params_desc_ptr[index].image_id;
+
+		if ((image_id < MAX_NUMBER_IDS) &&
+		    (bl_mem_params_desc_index[image_id] == NO_DESC_INDEX))
+			bl_mem_params_desc_index[image_id] = (uint8_t)index;
+	}
+
+	bl_mem_params_desc_indexed = true;
 }
 
 /*******************************************************************************
@@ -38,6 +96,14 @@ int get_bl_params_node_index(unsigned int image_id)
 	unsigned int index;
 	assert(image_id != INVALID_IMAGE_ID);
 
+	if (image_id < MAX_NUMBER_IDS) {
+		if (!bl_mem_params_desc_indexed)
+			index_bl_mem_params_desc();
+
+		index = bl_mem_params_desc_index[image_id];
+		return (index == NO_DESC_INDEX) ? -1 : (int)index;
+	}
+
 	for (index = 0U; index < bl_mem_params_desc_num; index++) {
 		if (bl_mem_params_desc_ptr[index].image_id == image_id)
 			return (int)index;
@@ -0,0 +1,614 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Batched modifications of a Device Tree Blob */
+
+#include <assert.h>
+#include <fdt_fixup.h>
+#include <libfdt.h>
+#include <string.h>
+
+/* Maximum depth of the nodes of the DTB written by fdt_fixup_apply() */
+#define FDT_FIXUP_MAX_DEPTH	16U
+
+#define FDT_FIXUP_ALIGN(_x)	(((_x) + FDT_TAGSIZE - 1U) & ~(FDT_TAGSIZE - 1U))
+
+/* Layout of the original DTB, read before it may be overwritten */
+typedef struct fdt_fixup_src {
+	const uint8_t *rsvmap;
+	const uint8_t *dt_struct;
+	const char *dt_strings;
+	uint32_t rsvmap_size;
+	uint32_t size_dt_struct;
+	uint32_t size_dt_strings;
+	uint32_t boot_cpuid_phys;
+} fdt_fixup_src_t;
+
+static int fdt_fixup_error(fdt_fixup_t *fx, int err)
+{
+	if (fx->err == 0)
+		fx->err = err;
+
+	return err;
+}
+
+/*
+ * Initialize the fixups of the DTB at `fdt`. The DTB must be of version 17 or
+ * later, with its blocks in the usual order, as written by dtc.
+ */
+int fdt_fixup_init(fdt_fixup_t *fx, const void *fdt)
+{
+	int err;
+
+	assert(fx != NULL);
+
+	(void)memset(fx, 0, sizeof(*fx));
+	fx->fdt = fdt;
+
+	err = fdt_check_header(fdt);
+	if (err != 0)
+		return fdt_fixup_error(fx, err);
+
+	if (fdt_version(fdt) < 17)
+		return fdt_fixup_error(fx, -FDT_ERR_BADVERSION);
+
+	if ((fdt_off_mem_rsvmap(fdt) < sizeof(struct fdt_header)) ||
+	    (fdt_off_dt_struct(fdt) < fdt_off_mem_rsvmap(fdt)) ||
+	    (fdt_off_dt_strings(fdt) <
+	     (fdt_off_dt_struct(fdt) + fdt_size_dt_struct(fdt))))
+		return fdt_fixup_error(fx, -FDT_ERR_BADLAYOUT);
+
+	return 0;
+}
+
+static int fdt_fixup_check_node(const fdt_fixup_t *fx, int node)
+{
+	int next;
+
+	if (node >= FDT_FIXUP_NEW_NODE_BASE) {
+		if ((unsigned int)(node - FDT_FIXUP_NEW_NODE_BASE) >=
+		    fx->num_nodes)
+			return -FDT_ERR_BADOFFSET;
+		return 0;
+	}
+
+	if ((node < 0) || ((node % FDT_TAGSIZE) != 0) ||
+	    (fdt_next_tag(fx->fdt, node, &next) != FDT_BEGIN_NODE))
+		return -FDT_ERR_BADOFFSET;
+
+	return 0;
+}
+
+/*
+ * Find `name` in the strings block of the original DTB, or in the strings
+ * added by the fixups, which follow it. Return its offset or -1.
+ */
+static int fdt_fixup_find_string(const char *strtab, unsigned int size,
+		const char *name, size_t len)
+{
+	const char *p;
+
+	for (p = strtab; (p + len) <= (strtab + size); p++) {
+		if (memcmp(p, name, len) == 0)
+			return (int)(p - strtab);
+	}
+
+	return -1;
+}
+
+static int fdt_fixup_get_nameoff(fdt_fixup_t *fx, const char *name,
+		uint32_t *nameoff)
+{
+	const char *strtab = (const char *)fx->fdt + fdt_off_dt_strings(fx->fdt);
+	unsigned int size = fdt_size_dt_strings(fx->fdt);
+	size_t len = strlen(name) + 1U;
+	int off;
+
+	off = fdt_fixup_find_string(strtab, size, name, len);
+	if (off >= 0) {
+		*nameoff = (uint32_t)off;
+		return 0;
+	}
+
+	off = fdt_fixup_find_string(fx->strings, fx->strings_len, name, len);
+	if (off < 0) {
+		if ((fx->strings_len + len) > FDT_FIXUP_MAX_STRINGS)
+			return -FDT_ERR_NOSPACE;
+
+		off = (int)fx->strings_len;
+		(void)memcpy(&fx->strings[off], name, len);
+		fx->strings_len += (unsigned int)len;
+	}
+
+	*nameoff = size + (uint32_t)off;
+
+	return 0;
+}
+
+/*
+ * Add a node called `name` under `parent`, which is either the offset of a
+ * node in the original DTB, or a node added by this function. Return the
+ * handle of the new node, to use as the node of other fixups, or a negative
+ * libfdt error code.
+ */
+int fdt_fixup_add_node(fdt_fixup_t *fx, int parent, const char *name)
+{
+	int err;
+
+	if (fx->err != 0)
+		return fx->err;
+
+	err = fdt_fixup_check_node(fx, parent);
+	if (err != 0)
+		return fdt_fixup_error(fx, err);
+
+	if (fx->num_nodes == FDT_FIXUP_MAX_NODES)
+		return fdt_fixup_error(fx, -FDT_ERR_NOSPACE);
+
+	fx->nodes[fx->num_nodes].parent = parent;
+	fx->nodes[fx->num_nodes].name = name;
+
+	return FDT_FIXUP_NEW_NODE(fx->num_nodes++);
+}
+
+/*
+ * Return the fixup of the property `name` of `node`, added if there is none
+ * yet, or NULL on error.
+ */
+static fdt_fixup_prop_t *fdt_fixup_get_prop(fdt_fixup_t *fx, int node,
+		const char *name)
+{
+	fdt_fixup_prop_t *e;
+	unsigned int i;
+	int err;
+
+	if (fx->err != 0)
+		return NULL;
+
+	err = fdt_fixup_check_node(fx, node);
+	if (err != 0) {
+		(void)fdt_fixup_error(fx, err);
+		return NULL;
+	}
+
+	for (i = 0U; i < fx->num_props; i++) {
+		e = &fx->props[i];
+		if ((e->node == node) && (strcmp(e->name, name) == 0))
+			return e;
+	}
+
+	if (fx->num_props == FDT_FIXUP_MAX_PROPS) {
+		(void)fdt_fixup_error(fx, -FDT_ERR_NOSPACE);
+		return NULL;
+	}
+
+	e = &fx->props[fx->num_props];
+	err = fdt_fixup_get_nameoff(fx, name, &e->nameoff);
+	if (err != 0) {
+		(void)fdt_fixup_error(fx, err);
+		return NULL;
+	}
+
+	e->node = node;
+	e->name = name;
+	fx->num_props++;
+
+	return e;
+}
+
+/*
+ * Set the property `name` of `node` to the `len` bytes at `val`, or delete it
+ * if `val` is NULL. The value isn't copied, and must remain valid, and outside
+ * the DTB, until fdt_fixup_apply() returns. A later fixup of the same property
+ * replaces this one.
+ */
+int fdt_fixup_setprop(fdt_fixup_t *fx, int node, const char *name,
+		const void *val, int len)
+{
+	fdt_fixup_prop_t *e;
+
+	if ((fx->err == 0) && (len < 0))
+		(void)fdt_fixup_error(fx, -FDT_ERR_BADVALUE);
+
+	e = fdt_fixup_get_prop(fx, node, name);
+	if (e == NULL)
+		return fx->err;
+
+	e->val = val;
+	e->len = (val != NULL) ? len : 0;
+
+	return 0;
+}
+
+int fdt_fixup_setprop_u32(fdt_fixup_t *fx, int node, const char *name,
+		uint32_t val)
+{
+	fdt_fixup_prop_t *e = fdt_fixup_get_prop(fx, node, name);
+	fdt32_t v = cpu_to_fdt32(val);
+
+	if (e == NULL)
+		return fx->err;
+
+	(void)memcpy(e->buf, &v, sizeof(v));
+	e->val = e->buf;
+	e->len = (int)sizeof(v);
+
+	return 0;
+}
+
+int fdt_fixup_setprop_u64(fdt_fixup_t *fx, int node, const char *name,
+		uint64_t val)
+{
+	fdt_fixup_prop_t *e = fdt_fixup_get_prop(fx, node, name);
+	fdt64_t v = cpu_to_fdt64(val);
+
+	if (e == NULL)
+		return fx->err;
+
+	(void)memcpy(e->buf, &v, sizeof(v));
+	e->val = e->buf;
+	e->len = (int)sizeof(v);
+
+	return 0;
+}
+
+int fdt_fixup_setprop_string(fdt_fixup_t *fx, int node, const char *name,
+		const char *str)
+{
+	return fdt_fixup_setprop(fx, node, name, str, (int)strlen(str) + 1);
+}
+
+int fdt_fixup_delprop(fdt_fixup_t *fx, int node, const char *name)
+{
+	return fdt_fixup_setprop(fx, node, name, NULL, 0);
+}
+
+/*
+ * Return an upper bound of the size of the DTB written by fdt_fixup_apply(),
+ * or a negative libfdt error code.
+ */
+int fdt_fixup_size(const fdt_fixup_t *fx)
+{
+	unsigned int i;
+	size_t size;
+
+	if (fx->err != 0)
+		return fx->err;
+
+	size = fdt_totalsize(fx->fdt) + fx->strings_len;
+
+	for (i = 0U; i < fx->num_props; i++) {
+		if (fx->props[i].val != NULL)
+			size += sizeof(struct fdt_property) +
+				FDT_FIXUP_ALIGN((size_t)fx->props[i].len);
+	}
+
+	for (i = 0U; i < fx->num_nodes; i++)
+		size += sizeof(struct fdt_node_header) + FDT_TAGSIZE +
+			FDT_FIXUP_ALIGN(strlen(fx->nodes[i].name) + 1U);
+
+	if (size > (size_t)INT32_MAX)
+		return -FDT_ERR_NOSPACE;
+
+	return (int)size;
+}
+
+static uint8_t *fdt_fixup_put_u32(uint8_t *p, uint32_t val)
+{
+	fdt32_t v = cpu_to_fdt32(val);
+
+	(void)memcpy(p, &v, sizeof(v));
+
+	return p + sizeof(v);
+}
+
+static uint8_t *fdt_fixup_put_data(uint8_t *p, const void *data, size_t len)
+{
+	size_t aligned = FDT_FIXUP_ALIGN(len);
+
+	(void)memmove(p, data, len);
+	(void)memset(p + len, 0, aligned - len);
+
+	return p + aligned;
+}
+
+/* Write the properties of `node` set by fixups and not written yet */
+static uint8_t *fdt_fixup_put_props(fdt_fixup_t *fx, uint8_t *p, int node)
+{
+	fdt_fixup_prop_t *e;
+	unsigned int i;
+
+	for (i = 0U; i < fx->num_props; i++) {
+		e = &fx->props[i];
+		if ((e->node != node) || e->done)
+			continue;
+
+		e->done = true;
+		if (e->val == NULL)
+			continue;
+
+		p = fdt_fixup_put_u32(p, FDT_PROP);
+		p = fdt_fixup_put_u32(p, (uint32_t)e->len);
+		p = fdt_fixup_put_u32(p, e->nameoff);
+		p = fdt_fixup_put_data(p, e->val, (size_t)e->len);
+	}
+
+	return p;
+}
+
+/* Write the nodes added under `parent`, with their properties and subnodes */
+static uint8_t *fdt_fixup_put_nodes(fdt_fixup_t *fx, uint8_t *p, int parent)
+{
+	unsigned int i;
+
+	for (i = 0U; i < fx->num_nodes; i++) {
+		if (fx->nodes[i].parent != parent)
+			continue;
+
+		p = fdt_fixup_put_u32(p, FDT_BEGIN_NODE);
+		p = fdt_fixup_put_data(p, fx->nodes[i].name,
+				strlen(fx->nodes[i].name) + 1U);
+		p = fdt_fixup_put_props(fx, p, FDT_FIXUP_NEW_NODE(i));
+		p = fdt_fixup_put_nodes(fx, p, FDT_FIXUP_NEW_NODE(i));
+		p = fdt_fixup_put_u32(p, FDT_END_NODE);
+	}
+
+	return p;
+}
+
+/*
+ * Return the tag at `offset` of the structure block, and set `next` to the
+ * offset of the next tag. Return FDT_END if the block is truncated or has an
+ * unknown tag, with `next` set to 0.
+ */
+static uint32_t fdt_fixup_next_tag(const fdt_fixup_src_t *src, uint32_t offset,
+		uint32_t *next)
+{
+	const uint8_t *s = src->dt_struct;
+	uint32_t size = src->size_dt_struct;
+	uint32_t tag, len;
+	fdt32_t v;
+
+	*next = 0U;
+
+	if ((size < FDT_TAGSIZE) || (offset > (size - FDT_TAGSIZE)))
+		return FDT_END;
+	(void)memcpy(&v, s + offset, sizeof(v));
+	tag = fdt32_to_cpu(v);
+	len = FDT_TAGSIZE;
+
+	switch (tag) {
+	case FDT_BEGIN_NODE:
+		while (((offset + len) < size) && (s[offset + len] != '\0'))
+			len++;
+		if ((offset + len) >= size)
+			return FDT_END;
+		len++;
+		break;
+
+	case FDT_PROP:
+		if ((size - offset) < sizeof(struct fdt_property))
+			return FDT_END;
+		(void)memcpy(&v, s + offset + FDT_TAGSIZE, sizeof(v));
+		if (fdt32_to_cpu(v) > (size - offset - sizeof(struct fdt_property)))
+			return FDT_END;
+		len = sizeof(struct fdt_property) + fdt32_to_cpu(v);
+		break;
+
+	case FDT_END:
+	case FDT_END_NODE:
+	case FDT_NOP:
+		break;
+
+	default:
+		return FDT_END;
+	}
+
+	len = FDT_FIXUP_ALIGN(len);
+	if (len > (size - offset))
+		return FDT_END;
+
+	*next = offset + len;
+	return tag;
+}
+
+/* Write the structure block of the modified DTB at `p`, and return its end */
+static uint8_t *fdt_fixup_put_struct(fdt_fixup_t *fx,
+		const fdt_fixup_src_t *src, uint8_t *p)
+{
+	struct {
+		int node;
+		bool props_done;
+	} stack[FDT_FIXUP_MAX_DEPTH];
+	const struct fdt_property *prop;
+	unsigned int depth = 0U;
+	uint32_t offset = 0U, next, tag, nameoff;
+	const char *name;
+	unsigned int i;
+	bool replaced;
+
+	do {
+		tag = fdt_fixup_next_tag(src, offset, &next);
+		if (next == 0U)
+			return NULL;
+
+		switch (tag) {
+		case FDT_BEGIN_NODE:
+			/* The properties of a node come before its subnodes */
+			if ((depth > 0U) && !stack[depth - 1U].props_done) {
+				p = fdt_fixup_put_props(fx, p,
+						stack[depth - 1U].node);
+				stack[depth - 1U].props_done = true;
+			}
+			if (depth == FDT_FIXUP_MAX_DEPTH)
+				return NULL;
+			stack[depth].node = (int)offset;
+			stack[depth].props_done = false;
+			depth++;
+			p = fdt_fixup_put_data(p, src->dt_struct + offset,
+					next - offset);
+			break;
+
+		case FDT_PROP:
+			if (depth == 0U)
+				return NULL;
+			prop = (const struct fdt_property *)
+				(src->dt_struct + offset);
+			nameoff = fdt32_to_cpu(prop->nameoff);
+			if (nameoff >= src->size_dt_strings)
+				return NULL;
+			name = src->dt_strings + nameoff;
+
+			replaced = false;
+			for (i = 0U; i < fx->num_props; i++) {
+				if ((fx->props[i].node == stack[depth - 1U].node) &&
+				    !fx->props[i].done &&
+				    (strcmp(fx->props[i].name, name) == 0)) {
+					replaced = true;
+					break;
+				}
+			}
+
+			if (replaced) {
+				fx->props[i].done = true;
+				if (fx->props[i].val != NULL) {
+					p = fdt_fixup_put_u32(p, FDT_PROP);
+					p = fdt_fixup_put_u32(p,
+						(uint32_t)fx->props[i].len);
+					p = fdt_fixup_put_u32(p,
+						fx->props[i].nameoff);
+					p = fdt_fixup_put_data(p,
+						fx->props[i].val,
+						(size_t)fx->props[i].len);
+				}
+			} else {
+				p = fdt_fixup_put_data(p,
+						src->dt_struct + offset,
+						next - offset);
+			}
+			break;
+
+		case FDT_END_NODE:
+			if (depth == 0U)
+				return NULL;
+			depth--;
+			if (!stack[depth].props_done)
+				p = fdt_fixup_put_props(fx, p, stack[depth].node);
+			p = fdt_fixup_put_nodes(fx, p, stack[depth].node);
+			p = fdt_fixup_put_u32(p, FDT_END_NODE);
+			break;
+
+		case FDT_NOP:
+			/* Dropped */
+			break;
+
+		default:
+			assert(tag == FDT_END);
+			if (depth != 0U)
+				return NULL;
+			p = fdt_fixup_put_u32(p, FDT_END);
+			break;
+		}
+
+		offset = next;
+	} while (tag != FDT_END);
+
+	return p;
+}
+
+/*
+ * Write the DTB with all the fixups applied to the `bufsize` bytes at `buf`,
+ * in a single pass. The buffer may hold the original DTB, which is then moved
+ * once to the end of the buffer and overwritten: it then needs up to 7 bytes
+ * more than fdt_fixup_size(). Return 0 on success or a
+ * negative libfdt error code.
+ */
+int fdt_fixup_apply(fdt_fixup_t *fx, void *buf, int bufsize)
+{
+	const uint8_t *fdt = fx->fdt;
+	uint8_t *out = buf;
+	uint8_t *p;
+	fdt_fixup_src_t src;
+	struct fdt_header hdr;
+	uint32_t totalsize;
+	unsigned int i;
+	int size;
+
+	size = fdt_fixup_size(fx);
+	if (size < 0)
+		return size;
+
+	if ((bufsize < 0) || (size > bufsize))
+		return -FDT_ERR_NOSPACE;
+
+	totalsize = fdt_totalsize(fdt);
+
+	/*
+	 * Move an original DTB overlapping the buffer to its end, aligned for
+	 * the reserve map entries: as long as the modified DTB is no larger than
+	 * what then remains of the buffer, writing it from the start never
+	 * overtakes what is left to read.
+	 */
+	if (((uintptr_t)fdt < ((uintptr_t)out + (uintptr_t)bufsize)) &&
+	    (((uintptr_t)fdt + totalsize) > (uintptr_t)out)) {
+		uintptr_t moved = ((uintptr_t)out + (uintptr_t)bufsize -
+				   totalsize) & ~(uintptr_t)7U;
+
+		if ((moved < (uintptr_t)out) ||
+		    ((uintptr_t)size > (moved - (uintptr_t)out + totalsize)))
+			return -FDT_ERR_NOSPACE;
+
+		(void)memmove((void *)moved, fdt, totalsize);
+		fdt = (const uint8_t *)moved;
+		fx->fdt = fdt;
+	}
+
+	src.rsvmap = fdt + fdt_off_mem_rsvmap(fdt);
+	src.rsvmap_size = (uint32_t)((fdt_num_mem_rsv(fdt) + 1) *
+				     (int)sizeof(struct fdt_reserve_entry));
+	src.dt_struct = fdt + fdt_off_dt_struct(fdt);
+	src.size_dt_struct = fdt_size_dt_struct(fdt);
+	src.dt_strings = (const char *)fdt + fdt_off_dt_strings(fdt);
+	src.size_dt_strings = fdt_size_dt_strings(fdt);
+	src.boot_cpuid_phys = fdt_boot_cpuid_phys(fdt);
+
+	for (i = 0U; i < fx->num_props; i++)
+		fx->props[i].done = false;
+
+	/* The header is written last, as it may overlap the original one */
+	p = out + sizeof(struct fdt_header);
+	(void)memmove(p, src.rsvmap, src.rsvmap_size);
+	p += src.rsvmap_size;
+
+	hdr.off_mem_rsvmap = cpu_to_fdt32(sizeof(struct fdt_header));
+	hdr.off_dt_struct = cpu_to_fdt32((uint32_t)(p - out));
+
+	p = fdt_fixup_put_struct(fx, &src, p);
+	if (p == NULL)
+		return -FDT_ERR_BADSTRUCTURE;
+
+	hdr.size_dt_struct = cpu_to_fdt32((uint32_t)(p - out) -
+					  fdt32_to_cpu(hdr.off_dt_struct));
+	hdr.off_dt_strings = cpu_to_fdt32((uint32_t)(p - out));
+
+	(void)memmove(p, src.dt_strings, src.size_dt_strings);
+	p += src.size_dt_strings;
+	(void)memcpy(p, fx->strings, fx->strings_len);
+	p += fx->strings_len;
+
+	hdr.size_dt_strings = cpu_to_fdt32(src.size_dt_strings +
+					   fx->strings_len);
+	hdr.magic = cpu_to_fdt32(FDT_MAGIC);
+	hdr.totalsize = cpu_to_fdt32((uint32_t)(p - out));
+	hdr.version = cpu_to_fdt32(17U);
+	hdr.last_comp_version = cpu_to_fdt32(16U);
+	hdr.boot_cpuid_phys = cpu_to_fdt32(src.boot_cpuid_phys);
+
+	(void)memcpy(out, &hdr, sizeof(hdr));
+	fx->fdt = out;
+
+	return 0;
+}
@@ -12,6 +12,229 @@
 #include <libfdt.h>
 #include <string.h>
 
+#if FDT_LOOKUP_CACHE_ENTRIES
+/*
+ * Cache of the node and property offsets found by the fdtw_*() lookups, so
+ * that looking up the same path, compatible string, phandle or property again
+ * doesn't walk the structure block of the DTB. The cache follows the last DTB
+ * looked up, and is flushed when the DTB changes or when its structure or
+ * strings block is moved or resized, as libfdt does when adding, removing or
+ * resizing data. fdtw_cache_invalidate() must be called after any other
+ * modification of the DTB, e.g. a node renamed in place. The cache isn't
+ * protected by a lock and is meant to be used by a single CPU, e.g. during
+ * the cold boot.
+ */
+#define FDTW_CACHE_FREE		0U
+#define FDTW_CACHE_PATH		1U
+#define FDTW_CACHE_COMPAT	2U
+#define FDTW_CACHE_PHANDLE	3U
+#define FDTW_CACHE_PROP		4U
+
+/* Longer strings aren't cached */
+#define FDTW_CACHE_KEY_LEN	32U
+
+typedef struct fdtw_cache_entry {
+	unsigned int type;
+	/* Node of the property, or phandle */
+	uint32_t id;
+	int offset;
+	char key[FDTW_CACHE_KEY_LEN];
+} fdtw_cache_entry_t;
+
+static struct {
+	const void *dtb;
+	uint32_t off_dt_struct;
+	uint32_t size_dt_struct;
+	uint32_t size_dt_strings;
+	unsigned int next;
+	fdtw_cache_entry_t entries[FDT_LOOKUP_CACHE_ENTRIES];
+} fdtw_cache;
+
+/* Flush the cache if it doesn't hold the current layout of `dtb` */
+static void fdtw_cache_check(const void *dtb)
+{
+	if ((fdtw_cache.dtb == dtb) &&
+	    (fdtw_cache.off_dt_struct == fdt_off_dt_struct(dtb)) &&
+	    (fdtw_cache.size_dt_struct == fdt_size_dt_struct(dtb)) &&
+	    (fdtw_cache.size_dt_strings == fdt_size_dt_strings(dtb)))
+		return;
+
+	fdtw_cache_invalidate();
+	fdtw_cache.dtb = dtb;
+	fdtw_cache.off_dt_struct = fdt_off_dt_struct(dtb);
+	fdtw_cache.size_dt_struct = fdt_size_dt_struct(dtb);
+	fdtw_cache.size_dt_strings = fdt_size_dt_strings(dtb);
+}
+
+/* Return the cached offset for the key, or -1 if it isn't cached */
+static int fdtw_cache_find(const void *dtb, unsigned int type, uint32_t id,
+		const char *key)
+{
+	const fdtw_cache_entry_t *e;
+	unsigned int i;
+
+	fdtw_cache_check(dtb);
+
+	for (i = 0U; i < FDT_LOOKUP_CACHE_ENTRIES; i++) {
+		e = &fdtw_cache.entries[i];
+		if ((e->type == type) && (e->id == id) &&
+		    ((key == NULL) || (strcmp(e->key, key) == 0)))
+			return e->offset;
+	}
+
+	return -1;
+}
+
+static void fdtw_cache_add(unsigned int type, uint32_t id, const char *key,
+		int offset)
+{
+	fdtw_cache_entry_t *e = &fdtw_cache.entries[fdtw_cache.next];
+
+	if ((offset < 0) ||
+	    ((key != NULL) && (strlen(key) >= FDTW_CACHE_KEY_LEN)))
+		return;
+
+	e->type = type;
+	e->id = id;
+	e->offset = offset;
+	e->key[0] = '\0';
+	if (key != NULL)
+		(void)strlcpy(e->key, key, sizeof(e->key));
+
+	fdtw_cache.next = (fdtw_cache.next + 1U) % FDT_LOOKUP_CACHE_ENTRIES;
+}
+#endif /* FDT_LOOKUP_CACHE_ENTRIES */
+
+/*
+ * Flush the lookup cache, which must be done after modifying a DTB in a way
+ * that changes the offset or the name of any node or property without
+ * changing the size of its structure or strings block.
+ */
+void fdtw_cache_invalidate(void)
+{
+#if FDT_LOOKUP_CACHE_ENTRIES
+	(void)memset(&fdtw_cache, 0, sizeof(fdtw_cache));
+#endif
+}
+
+/*
+ * Cached equivalent of fdt_path_offset(). Returns the offset of the node, or
+ * a negative libfdt error code.
+ */
+int fdtw_path_offset(const void *dtb, const char *path)
+{
+	int node;
+
+	assert(dtb != NULL);
+	assert(path != NULL);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	node = fdtw_cache_find(dtb, FDTW_CACHE_PATH, 0U, path);
+	if (node >= 0)
+		return node;
+#endif
+
+	node = fdt_path_offset(dtb, path);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	fdtw_cache_add(FDTW_CACHE_PATH, 0U, path, node);
+#endif
+	return node;
+}
+
+/*
+ * Cached equivalent of fdt_node_offset_by_compatible() for the first node
+ * compatible with `compatible`. Returns the offset of the node, or a negative
+ * libfdt error code.
+ */
+int fdtw_node_offset_by_compatible(const void *dtb, const char *compatible)
+{
+	int node;
+
+	assert(dtb != NULL);
+	assert(compatible != NULL);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	node = fdtw_cache_find(dtb, FDTW_CACHE_COMPAT, 0U, compatible);
+	if (node >= 0)
+		return node;
+#endif
+
+	node = fdt_node_offset_by_compatible(dtb, -1, compatible);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	fdtw_cache_add(FDTW_CACHE_COMPAT, 0U, compatible, node);
+#endif
+	return node;
+}
+
+/*
+ * Cached equivalent of fdt_node_offset_by_phandle(). Returns the offset of the
+ * node, or a negative libfdt error code.
+ */
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle)
+{
+	int node;
+
+	assert(dtb != NULL);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	node = fdtw_cache_find(dtb, FDTW_CACHE_PHANDLE, phandle, NULL);
+	if (node >= 0)
+		return node;
+#endif
+
+	node = fdt_node_offset_by_phandle(dtb, phandle);
+
+#if FDT_LOOKUP_CACHE_ENTRIES
+	fdtw_cache_add(FDTW_CACHE_PHANDLE, phandle, NULL, node);
+#endif
+	return node;
+}
+
+/*
+ * Cached equivalent of fdt_getprop(). Returns a pointer to the value of the
+ * property, with its length in `lenp` if not NULL, or NULL if not found.
+ */
+const void *fdtw_getprop(const void *dtb, int node, const char *name,
+		int *lenp)
+{
+#if FDT_LOOKUP_CACHE_ENTRIES
+	const char *prop_name;
+	const void *value;
+	int offset;
+
+	assert(dtb != NULL);
+	assert(node >= 0);
+	assert(name != NULL);
+
+	/* The name is checked in case the property was replaced in place */
+	offset = fdtw_cache_find(dtb, FDTW_CACHE_PROP, (uint32_t)node, name);
+	if (offset >= 0) {
+		value = fdt_getprop_by_offset(dtb, offset, &prop_name, lenp);
+		if ((value != NULL) && (strcmp(prop_name, name) == 0))
+			return value;
+	}
+
+	fdt_for_each_property_offset(offset, dtb, node) {
+		value = fdt_getprop_by_offset(dtb, offset, &prop_name, lenp);
+		if ((value != NULL) && (strcmp(prop_name, name) == 0)) {
+			fdtw_cache_add(FDTW_CACHE_PROP, (uint32_t)node, name,
+				       offset);
+			return value;
+		}
+	}
+
+	return NULL;
+#else
+	assert(dtb != NULL);
+	assert(node >= 0);
+	assert(name != NULL);
+
+	return fdt_getprop(dtb, node, name, lenp);
+#endif
+}
+
 /*
  * Read cells from a given property of the given node. At most 2 cells of the
  * property are read, and pointer is updated. Returns 0 on success, and -1 upon
@@ -33,8 +256,7 @@ int fdtw_read_cells(const void *dtb, int node, const char *prop,
 	assert(cells <= 2U);
 
 	/* Access property and obtain its length (in bytes) */
-	value_ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop),
-			&value_len);
+	value_ptr = fdtw_getprop(dtb, node, prop, &value_len);
 	if (value_ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
@@ -78,8 +300,7 @@ int fdtw_read_array(const void *dtb, int node, const char *prop,
 	assert(node >= 0);
 
 	/* Access property and obtain its length (in bytes) */
-	value_ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop),
-			&value_len);
+	value_ptr = fdtw_getprop(dtb, node, prop, &value_len);
 	if (value_ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
@@ -117,7 +338,7 @@ int fdtw_read_string(const void *dtb, int node, const char *prop,
 	assert(str != NULL);
 	assert(size > 0U);
 
-	ptr = fdt_getprop_namelen(dtb, node, prop, (int)strlen(prop), NULL);
+	ptr = fdtw_getprop(dtb, node, prop, NULL);
 	if (ptr == NULL) {
 		WARN("Couldn't find property %s in dtb\n", prop);
 		return -1;
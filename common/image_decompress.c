@@ -7,8 +7,12 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
+#include <boot_prof.h>
 #include <debug.h>
+#include <errno.h>
 #include <image_decompress.h>
+#include <io_storage.h>
+#include <platform.h>
 #include <stdint.h>
 
 static uintptr_t decompressor_buf_base;
@@ -16,6 +20,11 @@ static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
 static struct image_info saved_image_info;
 
+static uintptr_t stream_buf_base;
+static uint32_t stream_buf_size;
+static uint32_t stream_chunk_size;
+static const stream_decompressor_t *stream_decompressor;
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
@@ -62,9 +71,11 @@ int image_decompress(struct image_info *info)
 	work_base = compressed_image_base + compressed_image_size;
 	work_size = decompressor_buf_size - compressed_image_size;
 
+	boot_prof_record(BOOT_PROF_DECOMP_START, BOOT_PROF_NO_ID);
 	ret = decompressor(&compressed_image_base, compressed_image_size,
 			   &image_base, info->image_max_size,
 			   work_base, work_size);
+	boot_prof_record(BOOT_PROF_DECOMP_END, BOOT_PROF_NO_ID);
 	if (ret) {
 		ERROR("Failed to decompress image (err=%d)\n", ret);
 		return ret;
@@ -77,3 +88,116 @@ int image_decompress(struct image_info *info)
 
 	return 0;
 }
+
+/*
+ * Set up streaming decompression. The first chunk_size bytes of the buffer
+ * are used to stage the compressed data as it is read, and the rest of the
+ * buffer is used as workspace of the decompressor.
+ */
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  const stream_decompressor_t *decompressor)
+{
+	assert((chunk_size != 0U) && (chunk_size < buf_size));
+	assert(decompressor != NULL);
+
+	stream_buf_base = buf_base;
+	stream_buf_size = buf_size;
+	stream_chunk_size = chunk_size;
+	stream_decompressor = decompressor;
+}
+
+/*
+ * Load a compressed image and decompress it straight to its final location.
+ * The compressed data is read chunk by chunk and each chunk is decompressed
+ * before the next one is read, so the compressed image never needs to be
+ * staged as a whole.
+ *
+ * This replaces the load_image() step for the image, and therefore does not
+ * authenticate it.
+ */
+int image_decompress_load(unsigned int image_id, struct image_info *info)
+{
+	uintptr_t dev_handle, image_handle, image_spec;
+	uintptr_t chunk_base, image_end;
+	size_t image_size, left, chunk_len, bytes_read;
+	int ret, io_result;
+
+	assert(stream_decompressor != NULL);
+	assert(info != NULL);
+
+	ret = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (ret != 0) {
+		WARN("Failed to obtain reference to image id=%u (%i)\n",
+		     image_id, ret);
+		return ret;
+	}
+
+	ret = io_open(dev_handle, image_spec, &image_handle);
+	if (ret != 0) {
+		WARN("Failed to access image id=%u (%i)\n", image_id, ret);
+		return ret;
+	}
+
+	ret = io_size(image_handle, &image_size);
+	if ((ret != 0) || (image_size == 0U)) {
+		WARN("Failed to determine the size of the image id=%u (%i)\n",
+		     image_id, ret);
+		ret = (ret != 0) ? ret : -EIO;
+		goto exit;
+	}
+
+	INFO("Loading compressed image id=%u at address 0x%lx\n", image_id,
+	     info->image_base);
+
+	boot_prof_record(BOOT_PROF_DECOMP_START, image_id);
+
+	chunk_base = stream_buf_base;
+	ret = stream_decompressor->init(info->image_base, info->image_max_size,
+					stream_buf_base + stream_chunk_size,
+					stream_buf_size - stream_chunk_size);
+	if (ret != 0)
+		goto exit;
+
+	for (left = image_size; left > 0U; left -= chunk_len) {
+		chunk_len = (left < stream_chunk_size) ? left :
+							 stream_chunk_size;
+
+		ret = io_read(image_handle, chunk_base, chunk_len, &bytes_read);
+		if ((ret != 0) || (bytes_read != chunk_len)) {
+			WARN("Failed to load image id=%u (%i)\n", image_id, ret);
+			ret = (ret != 0) ? ret : -EIO;
+			break;
+		}
+
+		ret = stream_decompressor->update(chunk_base, chunk_len);
+		if (ret != 0)
+			break;
+	}
+
+	/* Always finish so that the decompressor releases its state */
+	image_end = info->image_base;
+	io_result = stream_decompressor->finish(&image_end);
+	if (ret == 0)
+		ret = io_result;
+
+	boot_prof_record(BOOT_PROF_DECOMP_END, image_id);
+
+	if (ret != 0) {
+		ERROR("Failed to decompress image (err=%d)\n", ret);
+		goto exit;
+	}
+
+	info->image_size = image_end - info->image_base;
+
+	flush_dcache_range(info->image_base, info->image_size);
+
+	INFO("Image id=%u loaded: 0x%lx - 0x%lx\n", image_id, info->image_base,
+	     image_end);
+
+exit:
+	(void)io_close(image_handle);
+	(void)io_dev_close(dev_handle);
+
+	return ret;
+}
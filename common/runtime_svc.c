@@ -4,10 +4,14 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
+#include <boot_prof.h>
 #include <debug.h>
 #include <errno.h>
+#include <pubsub_events.h>
 #include <runtime_svc.h>
+#include <spinlock.h>
 #include <string.h>
 
 /*******************************************************************************
@@ -24,6 +28,94 @@ uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 #define RT_SVC_DECS_NUM		((RT_SVC_DESCS_END - RT_SVC_DESCS_START)\
 					/ sizeof(rt_svc_desc_t))
 
+#if RT_SVC_FID_HANDLERS
+/*******************************************************************************
+ * The 'rt_svc_fid_table' array holds the handlers bound to a single SMC
+ * Function ID with runtime_svc_register_fid(). The SMC handler looks the
+ * function id up in this table before using the 'rt_svc_descs_indices' array,
+ * so that frequent calls skip the dispatch by their runtime service. Entries
+ * are placed by (fid ^ (fid >> 24)) and collisions are resolved by probing the
+ * next entries. An entry without handler ends the search.
+ ******************************************************************************/
+rt_svc_fid_t rt_svc_fid_table[RT_SVC_FID_TABLE_SIZE];
+
+static int runtime_svc_add_fid(uint32_t smc_fid, rt_svc_handle_t handle,
+			       uint32_t flags)
+{
+	unsigned int i, idx;
+
+	assert(handle != NULL);
+
+	idx = (smc_fid ^ (smc_fid >> 24)) & (RT_SVC_FID_TABLE_SIZE - 1U);
+
+	for (i = 0U; i < RT_SVC_FID_TABLE_SIZE; i++) {
+		rt_svc_fid_t *entry = &rt_svc_fid_table[idx];
+
+		if (entry->handle == NULL) {
+			entry->smc_fid = smc_fid;
+			entry->flags = flags;
+			entry->handle = handle;
+			return 0;
+		}
+
+		if (entry->smc_fid == smc_fid)
+			return -EEXIST;
+
+		idx = (idx + 1U) & (RT_SVC_FID_TABLE_SIZE - 1U);
+	}
+
+	return -ENOMEM;
+}
+
+/*******************************************************************************
+ * Bind a handler directly to an SMC Function ID. The handler is called with
+ * the same arguments as the handler of the runtime service owning the function
+ * id, and must perform the same checks on the caller. This function must be
+ * called during the initialisation of the runtime services, before any SMC
+ * can be taken.
+ ******************************************************************************/
+int runtime_svc_register_fid(uint32_t smc_fid, rt_svc_handle_t handle)
+{
+	return runtime_svc_add_fid(smc_fid, handle, 0U);
+}
+
+/*******************************************************************************
+ * Bind a leaf handler directly to an SMC Function ID, like
+ * runtime_svc_register_fid(). A leaf handler only computes its return values
+ * and returns to its caller: it must not switch the security state, change
+ * SPSR_EL3, ELR_EL3 or SCR_EL3, nor read or write the saved registers of the
+ * caller above x19. In exchange, the AArch64 SMC handler saves and restores
+ * only the registers that the handler may clobber.
+ ******************************************************************************/
+int runtime_svc_register_leaf_fid(uint32_t smc_fid, rt_svc_handle_t handle)
+{
+	return runtime_svc_add_fid(smc_fid, handle, RT_SVC_FID_LEAF);
+}
+
+#if SMCCC_MAJOR_VERSION == 1
+/*******************************************************************************
+ * Return the handler bound to an SMC Function ID, or NULL if there is none
+ ******************************************************************************/
+static rt_svc_handle_t runtime_svc_get_fid_handle(uint32_t smc_fid)
+{
+	unsigned int i, idx;
+
+	idx = (smc_fid ^ (smc_fid >> 24)) & (RT_SVC_FID_TABLE_SIZE - 1U);
+
+	for (i = 0U; i < RT_SVC_FID_TABLE_SIZE; i++) {
+		const rt_svc_fid_t *entry = &rt_svc_fid_table[idx];
+
+		if ((entry->handle == NULL) || (entry->smc_fid == smc_fid))
+			return entry->handle;
+
+		idx = (idx + 1U) & (RT_SVC_FID_TABLE_SIZE - 1U);
+	}
+
+	return NULL;
+}
+#endif /* SMCCC_MAJOR_VERSION */
+#endif /* RT_SVC_FID_HANDLERS */
+
 /*******************************************************************************
  * Function to invoke the registered `handle` corresponding to the smc_fid in
  * AArch32 mode.
@@ -38,8 +130,21 @@ uintptr_t handle_runtime_svc(uint32_t smc_fid,
 	unsigned int index;
 	unsigned int idx;
 	const rt_svc_desc_t *rt_svc_descs;
+#if RT_SVC_FID_HANDLERS
+	rt_svc_handle_t fid_handle;
+#endif
 
 	assert(handle != NULL);
+
+#if RT_SVC_FID_HANDLERS
+	fid_handle = runtime_svc_get_fid_handle(smc_fid);
+	if (fid_handle != NULL) {
+		get_smc_params_from_ctx(handle, x1, x2, x3, x4);
+		return fid_handle(smc_fid, x1, x2, x3, x4, cookie, handle,
+				  flags);
+	}
+#endif
+
 	idx = get_unique_oen_from_smc_fid(smc_fid);
 	assert(idx < MAX_RT_SVCS);
 
@@ -86,6 +191,102 @@ static int32_t validate_rt_svc_desc(const rt_svc_desc_t *desc)
 	return 0;
 }
 
+/* States of a deferred initialisation */
+#define RT_SVC_DEFERRED_PENDING		0U
+#define RT_SVC_DEFERRED_DONE		1U
+#define RT_SVC_DEFERRED_FAILED		2U
+
+#if RT_SVC_DEFERRED_INIT
+/*
+ * Deferred initialisations, added during the cold boot. The list isn't
+ * modified afterwards, so it can be walked without lock.
+ */
+static rt_svc_deferred_t *rt_svc_deferred_list;
+#endif
+
+/* Run a deferred initialisation unless it has already been */
+static int runtime_svc_deferred_run(rt_svc_deferred_t *deferred)
+{
+	int32_t rc;
+
+	spin_lock(&deferred->lock);
+	if (deferred->state == RT_SVC_DEFERRED_PENDING) {
+		rc = deferred->init();
+		if (rc != 0) {
+			ERROR("Error initializing runtime service %s\n",
+			      deferred->name);
+		}
+		deferred->state = (rc == 0) ? RT_SVC_DEFERRED_DONE :
+					      RT_SVC_DEFERRED_FAILED;
+	}
+	spin_unlock(&deferred->lock);
+
+	return (deferred->state == RT_SVC_DEFERRED_DONE) ? 0 : -1;
+}
+
+/*******************************************************************************
+ * Register a part of the initialisation of a runtime service which doesn't
+ * need to complete before BL31 exits. With RT_SVC_DEFERRED_INIT=0, it is run
+ * right away. Must only be called during the cold boot.
+ ******************************************************************************/
+void runtime_svc_defer_init(rt_svc_deferred_t *deferred)
+{
+	assert(deferred != NULL);
+	assert(deferred->init != NULL);
+
+#if RT_SVC_DEFERRED_INIT
+	deferred->next = rt_svc_deferred_list;
+	rt_svc_deferred_list = deferred;
+#else
+	(void)runtime_svc_deferred_run(deferred);
+#endif
+}
+
+/*******************************************************************************
+ * Make sure a deferred initialisation has completed, running it on this CPU
+ * if it hasn't started yet, or waiting for the CPU running it otherwise.
+ * Returns 0 if it succeeded, -1 if it failed.
+ ******************************************************************************/
+int runtime_svc_deferred_ready(rt_svc_deferred_t *deferred)
+{
+	assert(deferred != NULL);
+
+	if (deferred->state == RT_SVC_DEFERRED_DONE) {
+		/* Order the accesses to the state it set up after the check */
+		dmbish();
+		return 0;
+	}
+
+	return runtime_svc_deferred_run(deferred);
+}
+
+#if RT_SVC_DEFERRED_INIT
+/*******************************************************************************
+ * Run the deferred initialisations that haven't been run yet.
+ ******************************************************************************/
+void runtime_svc_deferred_init(void)
+{
+	rt_svc_deferred_t *deferred;
+
+	for (deferred = rt_svc_deferred_list; deferred != NULL;
+	     deferred = deferred->next)
+		(void)runtime_svc_deferred_ready(deferred);
+}
+
+/* The first CPU brought up runs the deferred initialisations */
+static void *runtime_svc_deferred_cpu_on(const void *arg)
+{
+	runtime_svc_deferred_init();
+	return NULL;
+}
+
+SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, runtime_svc_deferred_cpu_on);
+#else
+void runtime_svc_deferred_init(void)
+{
+}
+#endif /* RT_SVC_DEFERRED_INIT */
+
 /*******************************************************************************
  * This function calls the initialisation routine in the descriptor exported by
  * a runtime service. Once a descriptor has been validated, its start & end
@@ -134,7 +335,9 @@ void __init runtime_svc_init(void)
 		 * routine for this runtime service, if it is defined.
 		 */
 		if (service->init != NULL) {
+			boot_prof_record(BOOT_PROF_SVC_INIT_START, index);
 			rc = service->init();
+			boot_prof_record(BOOT_PROF_SVC_INIT_END, index);
 			if (rc != 0) {
 				ERROR("Error initializing runtime service %s\n",
 						service->name);
@@ -6,10 +6,152 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 #include <platform.h>
+#include <stdint.h>
+#if LOG_BINARY
+#include <cassert.h>
+#include <platform_def.h>
+#include <tf_log_bin.h>
+#endif
 
-/* Set the default maximum log level to the `LOG_LEVEL` build flag */
-static unsigned int max_log_level = LOG_LEVEL;
+/*
+ * Maximum log level of each log module, set by default to the `LOG_LEVEL`
+ * build flag.
+ */
+static uint8_t log_module_level[LOG_MODULE_COUNT] = {
+	[0 ... LOG_MODULE_COUNT - 1U] = (uint8_t)LOG_LEVEL
+};
+
+#if LOG_BINARY
+/*
+ * Binary log. The INFO and VERBOSE messages are not formatted but recorded in
+ * the ring of the current CPU, to be decoded on the host by the logdecode tool
+ * from a dump of `tf_log_bin`. Only the owning CPU writes to a ring, so no lock
+ * is needed. The log is zero-initialised, the header is written with the first
+ * record of any CPU.
+ */
+#ifdef PLAT_LOG_BINARY_RING_WORDS
+#define LOG_BIN_RING_WORDS	PLAT_LOG_BINARY_RING_WORDS
+#else
+#define LOG_BIN_RING_WORDS	U(256)
+#endif
+
+#define LOG_BIN_REC_WORDS	(TF_LOG_BIN_MAX_ARGS + 2U)
+
+CASSERT(LOG_BIN_RING_WORDS >= LOG_BIN_REC_WORDS, assert_log_bin_ring_words);
+
+typedef struct log_bin_ring {
+	tf_log_bin_ring_hdr_t hdr;
+	uint64_t words[LOG_BIN_RING_WORDS];
+} log_bin_ring_t;
+
+struct {
+	tf_log_bin_hdr_t hdr;
+	log_bin_ring_t ring[PLATFORM_CORE_COUNT];
+} tf_log_bin;
+
+#define get_num_va_args(_args, _lcount)				\
+	(((_lcount) > 1)  ? va_arg(_args, long long int) :	\
+	(((_lcount) == 1) ? va_arg(_args, long int) :		\
+			    va_arg(_args, int)))
+
+#define get_unum_va_args(_args, _lcount)				\
+	(((_lcount) > 1)  ? va_arg(_args, unsigned long long int) :	\
+	(((_lcount) == 1) ? va_arg(_args, unsigned long int) :		\
+			    va_arg(_args, unsigned int)))
+
+/*
+ * Read the arguments of a message into `argv`, following the conversions
+ * supported by printf(). Return the number of arguments read.
+ */
+static unsigned int log_bin_get_args(const char *fmt, va_list args,
+				     uint64_t *argv)
+{
+	unsigned int n = 0U;
+	int l_count;
+
+	while ((*fmt != '\0') && (n < TF_LOG_BIN_MAX_ARGS)) {
+		if (*fmt++ != '%')
+			continue;
+
+		l_count = 0;
+
+		/* Skip the padding, then read the length specifiers */
+		if (*fmt == '0') {
+			while ((*fmt >= '0') && (*fmt <= '9'))
+				fmt++;
+		}
+
+		for (;;) {
+			if (*fmt == 'l') {
+				l_count++;
+			} else if (*fmt == 'z') {
+				if (sizeof(size_t) == 8U)
+					l_count = 2;
+			} else {
+				break;
+			}
+			fmt++;
+		}
+
+		switch (*fmt) {
+		case 'i':
+		case 'd':
+			argv[n++] = (uint64_t)get_num_va_args(args, l_count);
+			break;
+		case 'u':
+		case 'x':
+			argv[n++] = (uint64_t)get_unum_va_args(args, l_count);
+			break;
+		case 's':
+		case 'p':
+			argv[n++] = (uintptr_t)va_arg(args, void *);
+			break;
+		default:
+			/* printf() stops on any other conversion */
+			return n;
+		}
+
+		fmt++;
+	}
+
+	return n;
+}
+
+static void log_bin_record(unsigned int log_level, const char *fmt,
+			   va_list args)
+{
+	log_bin_ring_t *ring = &tf_log_bin.ring[plat_my_core_pos()];
+	uint64_t argv[TF_LOG_BIN_MAX_ARGS];
+	uint64_t *rec;
+	unsigned int nargs, i;
+
+	if (tf_log_bin.hdr.magic == 0ULL) {
+		tf_log_bin.hdr.cpus = PLATFORM_CORE_COUNT;
+		tf_log_bin.hdr.ring_words = LOG_BIN_RING_WORDS;
+		tf_log_bin.hdr.magic = TF_LOG_BIN_MAGIC;
+	}
+
+	nargs = log_bin_get_args(fmt, args, argv);
+
+	/* Records don't wrap, clear the end of the ring */
+	if ((ring->hdr.head + nargs + 2U) > LOG_BIN_RING_WORDS) {
+		for (i = ring->hdr.head; i < LOG_BIN_RING_WORDS; i++)
+			ring->words[i] = 0ULL;
+		ring->hdr.head = 0U;
+		ring->hdr.wrapped = 1U;
+	}
+
+	rec = &ring->words[ring->hdr.head];
+	rec[0] = TF_LOG_BIN_REC(log_level, nargs);
+	rec[1] = (uintptr_t)fmt;
+	for (i = 0U; i < nargs; i++)
+		rec[i + 2U] = argv[i];
+
+	ring->hdr.head += nargs + 2U;
+}
+#endif /* LOG_BINARY */
 
 /*
  * The common log function which is invoked by ARM Trusted Firmware code.
@@ -21,6 +163,8 @@ static unsigned int max_log_level = LOG_LEVEL;
 void tf_log(const char *fmt, ...)
 {
 	unsigned int log_level;
+	unsigned int module = LOG_MODULE_ID_GENERIC;
+	const char *msg = fmt + 1;
 	va_list args;
 	const char *prefix_str;
 
@@ -31,9 +175,25 @@ void tf_log(const char *fmt, ...)
 	assert((log_level > 0U) && (log_level <= LOG_LEVEL_VERBOSE));
 	assert((log_level % 10U) == 0U);
 
-	if (log_level > max_log_level)
+	/* The LOG_MODULE_* marker, if any, follows the LOG_MARKER_* one */
+	if (((unsigned char)*msg & LOG_MODULE_MARKER_BIT) != 0U) {
+		module = (unsigned char)*msg & ~LOG_MODULE_MARKER_BIT;
+		assert(module < LOG_MODULE_COUNT);
+		msg++;
+	}
+
+	if (log_level > log_module_level[module])
 		return;
 
+#if LOG_BINARY
+	if (log_level >= LOG_LEVEL_INFO) {
+		va_start(args, fmt);
+		log_bin_record(log_level, msg, args);
+		va_end(args);
+		return;
+	}
+#endif
+
 	prefix_str = plat_log_get_prefix(log_level);
 
 	while (*prefix_str != '\0') {
@@ -42,7 +202,7 @@ void tf_log(const char *fmt, ...)
 	}
 
 	va_start(args, fmt);
-	(void)vprintf(fmt + 1, args);
+	(void)vprintf(msg, args);
 	va_end(args);
 }
 
@@ -57,6 +217,29 @@ void tf_log_set_max_level(unsigned int log_level)
 	assert((log_level % 10U) == 0U);
 
 	/* Cap log_level to the compile time maximum. */
-	if (log_level <= (unsigned int)LOG_LEVEL)
-		max_log_level = log_level;
+	if (log_level <= (unsigned int)LOG_LEVEL) {
+		for (unsigned int i = 0U; i < LOG_MODULE_COUNT; i++)
+			log_module_level[i] = (uint8_t)log_level;
+	}
+}
+
+/*
+ * Set the log level of a single log module, e.g. to raise the verbosity of a
+ * subsystem at runtime. The log level is capped to the `LOG_LEVEL` build flag,
+ * as the messages above it are not compiled in. This is called with untrusted
+ * arguments from the SiP service, so they are checked rather than asserted.
+ * Return 0 on success, or -EINVAL if the module or the log level is invalid.
+ */
+int tf_log_set_module_level(unsigned int module, unsigned int log_level)
+{
+	if ((module >= LOG_MODULE_COUNT) || (log_level > LOG_LEVEL_VERBOSE) ||
+	    ((log_level % 10U) != 0U))
+		return -EINVAL;
+
+	if (log_level > (unsigned int)LOG_LEVEL)
+		log_level = LOG_LEVEL;
+
+	log_module_level[module] = (uint8_t)log_level;
+
+	return 0;
 }
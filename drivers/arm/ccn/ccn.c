@@ -243,6 +243,47 @@ static unsigned long long ccn_master_to_rn_id_map(unsigned long long master_map)
 	return rn_id_map;
 }
 
+/*******************************************************************************
+ * This function issues the operation to add or remove Request node IDs
+ * specified in the 'rn_id_map' bitmap from the snoop/DVM domains specified in
+ * the 'hn_id_map'. The 'region_id' specifies the ID of the first HN-F/MN on
+ * which the operation should be performed. 'op_reg_offset' specifies the type
+ * of operation (add/remove). The operation is issued on all the nodes before
+ * any of them is polled for completion by ccn_snoop_dvm_wait_op().
+ ******************************************************************************/
+static void ccn_snoop_dvm_issue_op(unsigned long long rn_id_map,
+				   unsigned long long hn_id_map,
+				   unsigned int region_id,
+				   unsigned int op_reg_offset)
+{
+	FOR_EACH_PRESENT_REGION_ID(region_id, hn_id_map) {
+		ccn_reg_write(ccn_plat_desc->periphbase,
+			      region_id,
+			      op_reg_offset,
+			      rn_id_map);
+	}
+}
+
+/*******************************************************************************
+ * This function waits for the completion of an operation issued by
+ * ccn_snoop_dvm_issue_op() with the same parameters. 'stat_reg_offset'
+ * specifies the register which should be polled to determine if the operation
+ * has completed or not.
+ ******************************************************************************/
+static void ccn_snoop_dvm_wait_op(unsigned long long rn_id_map,
+				  unsigned long long hn_id_map,
+				  unsigned int region_id,
+				  unsigned int op_reg_offset,
+				  unsigned int stat_reg_offset)
+{
+	FOR_EACH_PRESENT_REGION_ID(region_id, hn_id_map) {
+		WAIT_FOR_DOMAIN_CTRL_OP_COMPLETION(region_id,
+						   stat_reg_offset,
+						   op_reg_offset,
+						   rn_id_map);
+	}
+}
+
 /*******************************************************************************
  * This function executes the necessary operations to add or remove Request node
  * IDs specified in the 'rn_id_map' bitmap from the snoop/DVM domains specified
@@ -257,31 +298,84 @@ static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
 				unsigned int op_reg_offset,
 				unsigned int stat_reg_offset)
 {
-	unsigned int start_region_id;
+	assert(ccn_plat_desc);
+	assert(ccn_plat_desc->periphbase);
+
+#if defined(IMAGE_BL31) || (defined(AARCH32) && defined(IMAGE_BL32))
+	bakery_lock_get(&ccn_lock);
+#endif
+	ccn_snoop_dvm_issue_op(rn_id_map, hn_id_map, region_id, op_reg_offset);
+	ccn_snoop_dvm_wait_op(rn_id_map, hn_id_map, region_id, op_reg_offset,
+			      stat_reg_offset);
+#if defined(IMAGE_BL31) || (defined(AARCH32) && defined(IMAGE_BL32))
+	bakery_lock_release(&ccn_lock);
+#endif
+}
+
+/*******************************************************************************
+ * This function adds the master interfaces in 'enter_iface_map' to, and
+ * removes the ones in 'exit_iface_map' from, the snoop and DVM domains in a
+ * single batch. The masters of several clusters can be passed at once. All the
+ * set and clear operations are issued to every HN-F and to the MN before
+ * polling any of them for completion, so that the nodes process them in
+ * parallel. Either map can be 0, but the masters being added and the ones
+ * being removed must not reside on the same Request nodes.
+ ******************************************************************************/
+void ccn_update_snoop_dvm_domain(unsigned long long enter_iface_map,
+				 unsigned long long exit_iface_map)
+{
+	unsigned long long enter_rn_id_map = 0, exit_rn_id_map = 0;
+	unsigned long long hnf_id_map, mn_id_map;
 
 	assert(ccn_plat_desc);
 	assert(ccn_plat_desc->periphbase);
+	assert((enter_iface_map & exit_iface_map) == 0);
+
+	if (enter_iface_map != 0)
+		enter_rn_id_map = ccn_master_to_rn_id_map(enter_iface_map);
+	if (exit_iface_map != 0)
+		exit_rn_id_map = ccn_master_to_rn_id_map(exit_iface_map);
+
+	assert((enter_rn_id_map & exit_rn_id_map) == 0);
+
+	hnf_id_map = CCN_GET_HN_NODEID_MAP(ccn_plat_desc->periphbase,
+					   MN_HNF_NODEID_OFFSET);
+	mn_id_map = CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase);
 
 #if defined(IMAGE_BL31) || (defined(AARCH32) && defined(IMAGE_BL32))
 	bakery_lock_get(&ccn_lock);
 #endif
-	start_region_id = region_id;
-	FOR_EACH_PRESENT_REGION_ID(start_region_id, hn_id_map) {
-		ccn_reg_write(ccn_plat_desc->periphbase,
-			      start_region_id,
-			      op_reg_offset,
-			      rn_id_map);
+	if (exit_rn_id_map != 0) {
+		ccn_snoop_dvm_issue_op(exit_rn_id_map, hnf_id_map,
+				       HNF_REGION_ID_START, HNF_SDC_CLR_OFFSET);
+		ccn_snoop_dvm_issue_op(exit_rn_id_map, mn_id_map,
+				       MN_REGION_ID, MN_DDC_CLR_OFFSET);
 	}
 
-	start_region_id = region_id;
+	if (enter_rn_id_map != 0) {
+		ccn_snoop_dvm_issue_op(enter_rn_id_map, hnf_id_map,
+				       HNF_REGION_ID_START, HNF_SDC_SET_OFFSET);
+		ccn_snoop_dvm_issue_op(enter_rn_id_map, mn_id_map,
+				       MN_REGION_ID, MN_DDC_SET_OFFSET);
+	}
 
-	FOR_EACH_PRESENT_REGION_ID(start_region_id, hn_id_map) {
-		WAIT_FOR_DOMAIN_CTRL_OP_COMPLETION(start_region_id,
-						   stat_reg_offset,
-						   op_reg_offset,
-						   rn_id_map);
+	if (exit_rn_id_map != 0) {
+		ccn_snoop_dvm_wait_op(exit_rn_id_map, hnf_id_map,
+				      HNF_REGION_ID_START, HNF_SDC_CLR_OFFSET,
+				      HNF_SDC_STAT_OFFSET);
+		ccn_snoop_dvm_wait_op(exit_rn_id_map, mn_id_map,
+				      MN_REGION_ID, MN_DDC_CLR_OFFSET,
+				      MN_DDC_STAT_OFFSET);
 	}
 
+	if (enter_rn_id_map != 0) {
+		ccn_snoop_dvm_wait_op(enter_rn_id_map, hnf_id_map,
+				      HNF_REGION_ID_START, HNF_SDC_SET_OFFSET,
+				      HNF_SDC_STAT_OFFSET);
+		ccn_snoop_dvm_wait_op(enter_rn_id_map, mn_id_map,
+				      MN_REGION_ID, MN_DDC_SET_OFFSET,
+				      MN_DDC_STAT_OFFSET);
+	}
 #if defined(IMAGE_BL31) || (defined(AARCH32) && defined(IMAGE_BL32))
 	bakery_lock_release(&ccn_lock);
 #endif
@@ -303,40 +397,12 @@ static void ccn_snoop_dvm_do_op(unsigned long long rn_id_map,
  ******************************************************************************/
 void ccn_enter_snoop_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_HN_NODEID_MAP(ccn_plat_desc->periphbase,
-						  MN_HNF_NODEID_OFFSET),
-			    HNF_REGION_ID_START,
-			    HNF_SDC_SET_OFFSET,
-			    HNF_SDC_STAT_OFFSET);
-
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_SET_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_update_snoop_dvm_domain(master_iface_map, 0);
 }
 
 void ccn_exit_snoop_dvm_domain(unsigned long long master_iface_map)
 {
-	unsigned long long rn_id_map;
-
-	rn_id_map = ccn_master_to_rn_id_map(master_iface_map);
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_HN_NODEID_MAP(ccn_plat_desc->periphbase,
-						  MN_HNF_NODEID_OFFSET),
-			    HNF_REGION_ID_START,
-			    HNF_SDC_CLR_OFFSET,
-			    HNF_SDC_STAT_OFFSET);
-
-	ccn_snoop_dvm_do_op(rn_id_map,
-			    CCN_GET_MN_NODEID_MAP(ccn_plat_desc->periphbase),
-			    MN_REGION_ID,
-			    MN_DDC_CLR_OFFSET,
-			    MN_DDC_STAT_OFFSET);
+	ccn_update_snoop_dvm_domain(0, master_iface_map);
 }
 
 void ccn_enter_dvm_domain(unsigned long long master_iface_map)
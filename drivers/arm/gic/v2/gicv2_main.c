@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_GIC
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
@@ -52,16 +52,25 @@ static int gicr_group_powering_down(uint32_t pwrr)
 	return ((pwrr & PWRR_RDGPD) && !(pwrr & PWRR_RDGPO));
 }
 
-static void gic600_pwr_on(uintptr_t base)
+static void gic600_pwr_on_start(uintptr_t base)
 {
 	/* Power on redistributor */
 	gicr_write_pwrr(base, PWRR_ON);
+}
 
+static void gic600_pwr_on_wait(uintptr_t base)
+{
 	/* Wait until the power on state is reflected */
 	while (gicr_read_pwrr(base) & PWRR_RDGPO)
 		;
 }
 
+static void gic600_pwr_on(uintptr_t base)
+{
+	gic600_pwr_on_start(base);
+	gic600_pwr_on_wait(base);
+}
+
 static void gic600_pwr_off(uintptr_t base)
 {
 	/* Power off redistributor */
@@ -79,6 +88,20 @@ static void gic600_pwr_off(uintptr_t base)
 	}
 }
 
+static uintptr_t gic600_rdist_base(unsigned int proc_num)
+{
+	uintptr_t gicr_base;
+
+	assert(gicv3_driver_data);
+	assert(proc_num < gicv3_driver_data->rdistif_num);
+	assert(gicv3_driver_data->rdistif_base_addrs);
+
+	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+	assert(gicr_base);
+
+	return gicr_base;
+}
+
 void gicv3_distif_pre_save(unsigned int proc_num)
 {
 	arm_gicv3_distif_pre_save(proc_num);
@@ -94,17 +117,8 @@ void gicv3_distif_post_restore(unsigned int proc_num)
  */
 void gicv3_rdistif_off(unsigned int proc_num)
 {
-	uintptr_t gicr_base;
-
-	assert(gicv3_driver_data);
-	assert(proc_num < gicv3_driver_data->rdistif_num);
-	assert(gicv3_driver_data->rdistif_base_addrs);
-
-	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
-	assert(gicr_base);
-
 	/* Attempt to power redistributor off */
-	gic600_pwr_off(gicr_base);
+	gic600_pwr_off(gic600_rdist_base(proc_num));
 }
 
 /*
@@ -112,15 +126,26 @@ void gicv3_rdistif_off(unsigned int proc_num)
  */
 void gicv3_rdistif_on(unsigned int proc_num)
 {
-	uintptr_t gicr_base;
-
-	assert(gicv3_driver_data);
-	assert(proc_num < gicv3_driver_data->rdistif_num);
-	assert(gicv3_driver_data->rdistif_base_addrs);
+	/* Power redistributor on */
+	gic600_pwr_on(gic600_rdist_base(proc_num));
+}
 
-	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
-	assert(gicr_base);
+/*
+ * Start powering on GIC600 redistributor without waiting for it to be powered,
+ * so that the caller can do other work in the meantime. It must be followed by
+ * gicv3_rdistif_on_wait() or gicv3_rdistif_on() before the redistributor is
+ * accessed.
+ */
+void gicv3_rdistif_on_start(unsigned int proc_num)
+{
+	gic600_pwr_on_start(gic600_rdist_base(proc_num));
+}
 
-	/* Power redistributor on */
-	gic600_pwr_on(gicr_base);
+/*
+ * Wait for GIC600 redistributor to be powered on after
+ * gicv3_rdistif_on_start()
+ */
+void gicv3_rdistif_on_wait(unsigned int proc_num)
+{
+	gic600_pwr_on_wait(gic600_rdist_base(proc_num));
 }
@@ -341,7 +341,12 @@ void gicv3_rdistif_base_addrs_probe(uintptr_t *rdistif_base_addrs,
 		}
 		assert(proc_num < rdistif_num);
 		rdistif_base_addrs[proc_num] = rdistif_base;
-		rdistif_base += (1U << GICR_PCPUBASE_SHIFT);
+
+		/* GICv4 Redistributors have two more frames for virtual LPIs */
+		if ((typer_val & TYPER_VLPIS_BIT) != 0U)
+			rdistif_base += (1U << GICR_V4_PCPUBASE_SHIFT);
+		else
+			rdistif_base += (1U << GICR_PCPUBASE_SHIFT);
 	} while ((typer_val & TYPER_LAST_BIT) == 0U);
 }
 
@@ -375,6 +380,22 @@ void gicv3_spis_config_defaults(uintptr_t gicd_base)
 	 */
 	for (index = MIN_SPI_ID; index < num_ints; index += 16U)
 		gicd_write_icfgr(gicd_base, index, 0U);
+
+	/* Same for the extended SPIs, if any */
+	num_ints = gicd_get_espi_num(gicd_base);
+
+	for (index = 0U; index < num_ints; index += 32U)
+		gicd_write_igroupr(gicd_base + GICD_IGROUPRE - GICD_IGROUPR,
+				   index, ~0U);
+
+	for (index = 0U; index < num_ints; index += 4U)
+		gicd_write_ipriorityr(
+				gicd_base + GICD_IPRIORITYRE - GICD_IPRIORITYR,
+				index, GICD_IPRIORITYR_DEF_VAL);
+
+	for (index = 0U; index < num_ints; index += 16U)
+		gicd_write_icfgr(gicd_base + GICD_ICFGRE - GICD_ICFGR,
+				 index, 0U);
 }
 
 /*******************************************************************************
@@ -384,7 +405,7 @@ unsigned int gicv3_secure_spis_config_props(uintptr_t gicd_base,
 		const interrupt_prop_t *interrupt_props,
 		unsigned int interrupt_props_num)
 {
-	unsigned int i;
+	unsigned int i, id, idx;
 	const interrupt_prop_t *current_prop;
 	unsigned long long gic_affinity_val;
 	unsigned int ctlr_enable = 0U;
@@ -395,40 +416,49 @@ unsigned int gicv3_secure_spis_config_props(uintptr_t gicd_base,
 
 	for (i = 0U; i < interrupt_props_num; i++) {
 		current_prop = &interrupt_props[i];
+		id = current_prop->intr_num;
 
-		if (current_prop->intr_num < MIN_SPI_ID)
+		assert(IS_VALID_INTR_ID(id));
+		if (IS_PCPU_INTR(id))
 			continue;
 
+		/* Extended SPIs must be implemented */
+		assert(!IS_ESPI(id) ||
+		       (GICD_SPI_ID(id) < gicd_get_espi_num(gicd_base)));
+		idx = GICD_SPI_ID(id);
+
 		/* Configure this interrupt as a secure interrupt */
-		gicd_clr_igroupr(gicd_base, current_prop->intr_num);
+		gicd_clr_igroupr(GICD_SPI_BASE(gicd_base, IGROUPR, id), idx);
 
 		/* Configure this interrupt as G0 or a G1S interrupt */
 		assert((current_prop->intr_grp == INTR_GROUP0) ||
 				(current_prop->intr_grp == INTR_GROUP1S));
 		if (current_prop->intr_grp == INTR_GROUP1S) {
-			gicd_set_igrpmodr(gicd_base, current_prop->intr_num);
+			gicd_set_igrpmodr(
+				GICD_SPI_BASE(gicd_base, IGRPMODR, id), idx);
 			ctlr_enable |= CTLR_ENABLE_G1S_BIT;
 		} else {
-			gicd_clr_igrpmodr(gicd_base, current_prop->intr_num);
+			gicd_clr_igrpmodr(
+				GICD_SPI_BASE(gicd_base, IGRPMODR, id), idx);
 			ctlr_enable |= CTLR_ENABLE_G0_BIT;
 		}
 
 		/* Set interrupt configuration */
-		gicd_set_icfgr(gicd_base, current_prop->intr_num,
+		gicd_set_icfgr(GICD_SPI_BASE(gicd_base, ICFGR, id), idx,
 				current_prop->intr_cfg);
 
 		/* Set the priority of this interrupt */
-		gicd_set_ipriorityr(gicd_base, current_prop->intr_num,
-				current_prop->intr_pri);
+		gicd_set_ipriorityr(GICD_SPI_BASE(gicd_base, IPRIORITYR, id),
+				idx, current_prop->intr_pri);
 
 		/* Target SPIs to the primary CPU */
 		gic_affinity_val =
 			gicd_irouter_val_from_mpidr(read_mpidr(), 0U);
-		gicd_write_irouter(gicd_base, current_prop->intr_num,
-				gic_affinity_val);
+		gicd_write_irouter(gicd_base, id, gic_affinity_val);
 
 		/* Enable this interrupt */
-		gicd_set_isenabler(gicd_base, current_prop->intr_num);
+		gicd_set_isenabler(GICD_SPI_BASE(gicd_base, ISENABLER, id),
+				   idx);
 	}
 
 	return ctlr_enable;
@@ -439,7 +469,7 @@ unsigned int gicv3_secure_spis_config_props(uintptr_t gicd_base,
  ******************************************************************************/
 void gicv3_ppi_sgi_config_defaults(uintptr_t gicr_base)
 {
-	unsigned int index;
+	unsigned int index, num_eppis;
 
 	/*
 	 * Disable all SGIs (imp. def.)/PPIs before configuring them. This is a
@@ -460,6 +490,29 @@ void gicv3_ppi_sgi_config_defaults(uintptr_t gicr_base)
 
 	/* Configure all PPIs as level triggered by default */
 	gicr_write_icfgr1(gicr_base, 0U);
+
+	/* Same for the extended PPIs, if any */
+	num_eppis = gicr_get_eppi_num(gicr_base);
+	if (num_eppis == 0U)
+		return;
+
+	for (index = MIN_SPI_ID; index < (MIN_SPI_ID + num_eppis);
+			index += 32U)
+		gicr_write_icenabler0(GICR_BANK_BASE(gicr_base, index), ~0U);
+	gicr_wait_for_pending_write(gicr_base);
+
+	for (index = MIN_SPI_ID; index < (MIN_SPI_ID + num_eppis);
+			index += 32U)
+		gicr_write_igroupr0(GICR_BANK_BASE(gicr_base, index), ~0U);
+
+	for (index = MIN_SPI_ID; index < (MIN_SPI_ID + num_eppis);
+			index += 4U)
+		gicr_write_ipriorityr(gicr_base, index,
+				      GICD_IPRIORITYR_DEF_VAL);
+
+	for (index = MIN_SPI_ID; index < (MIN_SPI_ID + num_eppis);
+			index += 16U)
+		gicr_write_icfgr0(GICR_ICFGR_BASE(gicr_base, index), 0U);
 }
 
 /*******************************************************************************
@@ -469,7 +522,8 @@ unsigned int gicv3_secure_ppi_sgi_config_props(uintptr_t gicr_base,
 		const interrupt_prop_t *interrupt_props,
 		unsigned int interrupt_props_num)
 {
-	unsigned int i;
+	unsigned int i, idx;
+	uintptr_t bank_base;
 	const interrupt_prop_t *current_prop;
 	unsigned int ctlr_enable = 0U;
 
@@ -480,40 +534,82 @@ unsigned int gicv3_secure_ppi_sgi_config_props(uintptr_t gicr_base,
 	for (i = 0U; i < interrupt_props_num; i++) {
 		current_prop = &interrupt_props[i];
 
-		if (current_prop->intr_num >= MIN_SPI_ID)
+		if (!IS_PCPU_INTR(current_prop->intr_num))
 			continue;
 
+		/* Extended PPIs must be implemented */
+		idx = GICR_PCPU_IDX(current_prop->intr_num);
+		assert(idx < (MIN_SPI_ID + gicr_get_eppi_num(gicr_base)));
+		bank_base = GICR_BANK_BASE(gicr_base, idx);
+
 		/* Configure this interrupt as a secure interrupt */
-		gicr_clr_igroupr0(gicr_base, current_prop->intr_num);
+		gicr_clr_igroupr0(bank_base, idx);
 
 		/* Configure this interrupt as G0 or a G1S interrupt */
 		assert((current_prop->intr_grp == INTR_GROUP0) ||
 				(current_prop->intr_grp == INTR_GROUP1S));
 		if (current_prop->intr_grp == INTR_GROUP1S) {
-			gicr_set_igrpmodr0(gicr_base, current_prop->intr_num);
+			gicr_set_igrpmodr0(bank_base, idx);
 			ctlr_enable |= CTLR_ENABLE_G1S_BIT;
 		} else {
-			gicr_clr_igrpmodr0(gicr_base, current_prop->intr_num);
+			gicr_clr_igrpmodr0(bank_base, idx);
 			ctlr_enable |= CTLR_ENABLE_G0_BIT;
 		}
 
 		/* Set the priority of this interrupt */
-		gicr_set_ipriorityr(gicr_base, current_prop->intr_num,
-				current_prop->intr_pri);
+		gicr_set_ipriorityr(gicr_base, idx, current_prop->intr_pri);
 
 		/*
 		 * Set interrupt configuration for PPIs. Configuration for SGIs
 		 * are ignored.
 		 */
-		if ((current_prop->intr_num >= MIN_PPI_ID) &&
-				(current_prop->intr_num < MIN_SPI_ID)) {
-			gicr_set_icfgr1(gicr_base, current_prop->intr_num,
+		if (idx >= MIN_PPI_ID) {
+			gicr_set_icfgr0(GICR_ICFGR_BASE(gicr_base, idx), idx,
 					current_prop->intr_cfg);
 		}
 
 		/* Enable this interrupt */
-		gicr_set_isenabler0(gicr_base, current_prop->intr_num);
+		gicr_set_isenabler0(bank_base, idx);
 	}
 
 	return ctlr_enable;
 }
+
+/*******************************************************************************
+ * Helper functions to save and restore `num_regs` consecutive 32-bit GIC
+ * registers, starting at address `addr`, to and from the `regs` array. The
+ * registers are accessed in sequence, rather than computing the address of the
+ * register of each interrupt ID.
+ ******************************************************************************/
+void gicv3_regs_save(uintptr_t addr, unsigned int num_regs, uint32_t *regs)
+{
+	unsigned int i;
+
+	for (i = 0U; i < num_regs; i++)
+		regs[i] = mmio_read_32(addr + (i << 2));
+}
+
+void gicv3_regs_restore(uintptr_t addr, unsigned int num_regs,
+			const uint32_t *regs)
+{
+	unsigned int i;
+
+	for (i = 0U; i < num_regs; i++)
+		mmio_write_32(addr + (i << 2), regs[i]);
+}
+
+/*
+ * Same as gicv3_regs_restore() for the registers where writing a zero bit has
+ * no effect, e.g. GICD_ISENABLER, GICD_ISPENDR and GICD_ISACTIVER. Only the
+ * registers with bits set are written, as most of them are usually zero.
+ */
+void gicv3_set_regs_restore(uintptr_t addr, unsigned int num_regs,
+			    const uint32_t *regs)
+{
+	unsigned int i;
+
+	for (i = 0U; i < num_regs; i++) {
+		if (regs[i] != 0U)
+			mmio_write_32(addr + (i << 2), regs[i]);
+	}
+}
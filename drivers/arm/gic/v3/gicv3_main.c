@@ -4,12 +4,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_GIC
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <gicv3.h>
 #include <interrupt_props.h>
+#include <lock_stats.h>
+#include <platform_def.h>
+#include <pubsub_events.h>
 #include <spinlock.h>
 #include "gicv3_private.h"
 
@@ -22,6 +27,35 @@ static unsigned int gicv2_compat;
  * when the system is fully coherent.
  */
 static spinlock_t gic_lock;
+REGISTER_LOCK_STATS(gicv3, gic_lock);
+
+/*
+ * Context holding the current Secure configuration of the SGIs and PPIs of each
+ * Redistributor, i.e. GICR_IGROUPR0, GICR_IGRPMODR0 and GICR_NSACR, or NULL if
+ * it has to be read again. These registers can only be written by EL3, through
+ * this driver, which resets the entry of a Redistributor when it writes them.
+ * They are then only read by gicv3_rdistif_save() when they may have changed
+ * since the last save.
+ */
+static const gicv3_redist_ctx_t *gicv3_rdist_cfg_ctx[PLATFORM_CORE_COUNT];
+
+#if (GICV3_SECURE_SPI_ROUTING == GICV3_SPI_ROUTING_ROUND_ROBIN) && \
+	defined(IMAGE_BL31)
+/*
+ * PEs that the Secure SPIs are spread over: the boot PE and the PEs turned on
+ * with PSCI CPU_ON and not turned off since. They are updated with the data
+ * cache enabled, under spi_routing_lock.
+ */
+static u_register_t spi_online_mpidrs[PLATFORM_CORE_COUNT];
+static unsigned int spi_online_num;
+static spinlock_t spi_routing_lock;
+#endif
+
+static void gicv3_rdist_cfg_changed(unsigned int proc_num)
+{
+	if (proc_num < PLATFORM_CORE_COUNT)
+		gicv3_rdist_cfg_ctx[proc_num] = NULL;
+}
 
 /*
  * Redistributor power operations are weakly bound so that they can be
@@ -29,26 +63,61 @@ static spinlock_t gic_lock;
  */
 #pragma weak gicv3_rdistif_off
 #pragma weak gicv3_rdistif_on
+#pragma weak gicv3_rdistif_on_start
+#pragma weak gicv3_rdistif_on_wait
+
 
+/*
+ * Helper macros to save and restore GICD registers to and from the context.
+ * The registers of the SPIs are saved from the one of MIN_SPI_ID.
+ */
+#define GICD_SPI_REGS(base, REG)					\
+	((base) + GICD_##REG + ((MIN_SPI_ID >> REG##_SHIFT) << 2))
+#define GICD_SPI_REGS_NUM(intr_num, REG)				\
+	(((intr_num) - MIN_SPI_ID) >> REG##_SHIFT)
 
-/* Helper macros to save and restore GICD registers to and from the context */
 #define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
-	do {								\
-		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
-				int_id += (1U << REG##_SHIFT)) {	\
-			gicd_write_##reg(base, int_id,			\
-				ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT]); \
-		}							\
-	} while (false)
+	gicv3_regs_restore(GICD_SPI_REGS(base, REG),			\
+			   GICD_SPI_REGS_NUM(intr_num, REG), (ctx)->gicd_##reg)
+
+#define RESTORE_GICD_SET_REGS(base, ctx, intr_num, reg, REG)		\
+	gicv3_set_regs_restore(GICD_SPI_REGS(base, REG),		\
+			       GICD_SPI_REGS_NUM(intr_num, REG),	\
+			       (ctx)->gicd_##reg)
 
 #define SAVE_GICD_REGS(base, ctx, intr_num, reg, REG)			\
-	do {								\
-		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num); \
-				int_id += (1U << REG##_SHIFT)) {	\
-			ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT] =\
-					gicd_read_##reg(base, int_id);	\
-		}							\
-	} while (false)
+	gicv3_regs_save(GICD_SPI_REGS(base, REG),			\
+			GICD_SPI_REGS_NUM(intr_num, REG), (ctx)->gicd_##reg)
+
+#if GIC_EXT_INTID
+/* Same for the registers of the extended SPIs */
+#define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)		\
+	gicv3_regs_restore((base) + GICD_##REG##E,			\
+			   (intr_num) >> REG##_SHIFT, (ctx)->gicd_##reg##e)
+
+#define RESTORE_GICD_SET_EREGS(base, ctx, intr_num, reg, REG)		\
+	gicv3_set_regs_restore((base) + GICD_##REG##E,			\
+			       (intr_num) >> REG##_SHIFT, (ctx)->gicd_##reg##e)
+
+#define SAVE_GICD_EREGS(base, ctx, intr_num, reg, REG)			\
+	gicv3_regs_save((base) + GICD_##REG##E,				\
+			(intr_num) >> REG##_SHIFT, (ctx)->gicd_##reg##e)
+
+/*
+ * Helper macros to save and restore the GICR registers of the extended PPIs,
+ * which follow the registers of the SGIs and PPIs at offset `off`.
+ */
+#define GICR_EPPI_REGS(base, off, REG)					\
+	((base) + (off) + ((MIN_SPI_ID >> REG##_SHIFT) << 2))
+
+#define RESTORE_GICR_EREGS(base, off, ctx, intr_num, reg, REG)		\
+	gicv3_regs_restore(GICR_EPPI_REGS(base, off, REG),		\
+			   (intr_num) >> REG##_SHIFT, (ctx)->gicr_##reg##e)
+
+#define SAVE_GICR_EREGS(base, off, ctx, intr_num, reg, REG)		\
+	gicv3_regs_save(GICR_EPPI_REGS(base, off, REG),			\
+			(intr_num) >> REG##_SHIFT, (ctx)->gicr_##reg##e)
+#endif /* GIC_EXT_INTID */
 
 
 /*******************************************************************************
@@ -161,6 +230,15 @@ void __init gicv3_distif_init(void)
 			gicv3_driver_data->interrupt_props,
 			gicv3_driver_data->interrupt_props_num);
 
+#if GICV3_SECURE_SPI_ROUTING == GICV3_SPI_ROUTING_1_OF_N
+	gicv3_route_secure_spis(GICV3_IRM_ANY, NULL, 0U);
+#elif (GICV3_SECURE_SPI_ROUTING == GICV3_SPI_ROUTING_ROUND_ROBIN) && \
+	defined(IMAGE_BL31)
+	/* The Secure SPIs have been routed to the boot PE */
+	spi_online_mpidrs[0] = read_mpidr() & MPIDR_AFFINITY_MASK;
+	spi_online_num = 1U;
+#endif
+
 	/* Enable the secure SPIs now that they have been configured */
 	gicd_set_ctlr(gicv3_driver_data->gicd_base, bitmap, RWP_TRUE);
 }
@@ -191,6 +269,8 @@ void gicv3_rdistif_init(unsigned int proc_num)
 
 	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
 
+	gicv3_rdist_cfg_changed(proc_num);
+
 	/* Set the default attribute of all SGIs and PPIs */
 	gicv3_ppi_sgi_config_defaults(gicr_base);
 
@@ -216,6 +296,16 @@ void gicv3_rdistif_on(unsigned int proc_num)
 	return;
 }
 
+void gicv3_rdistif_on_start(unsigned int proc_num)
+{
+	return;
+}
+
+void gicv3_rdistif_on_wait(unsigned int proc_num)
+{
+	return;
+}
+
 /*******************************************************************************
  * This function enables the GIC CPU interface of the calling CPU using only
  * system register accesses.
@@ -362,29 +452,35 @@ unsigned int gicv3_get_pending_interrupt_type(void)
 unsigned int gicv3_get_interrupt_type(unsigned int id,
 					  unsigned int proc_num)
 {
-	unsigned int igroup, grpmodr;
-	uintptr_t gicr_base;
+	unsigned int igroup, grpmodr, idx;
+	uintptr_t gicr_base, gicd_base;
 
 	assert(IS_IN_EL3());
 	assert(gicv3_driver_data != NULL);
 
 	/* Ensure the parameters are valid */
-	assert((id < PENDING_G1S_INTID) || (id >= MIN_LPI_ID));
+	assert(IS_VALID_INTR_ID(id) || (id >= MIN_LPI_ID));
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 
 	/* All LPI interrupts are Group 1 non secure */
 	if (id >= MIN_LPI_ID)
 		return INTR_GROUP1NS;
 
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		assert(gicv3_driver_data->rdistif_base_addrs != NULL);
 		gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
-		igroup = gicr_get_igroupr0(gicr_base, id);
-		grpmodr = gicr_get_igrpmodr0(gicr_base, id);
+		idx = GICR_PCPU_IDX(id);
+		igroup = gicr_get_igroupr0(GICR_BANK_BASE(gicr_base, idx), idx);
+		grpmodr = gicr_get_igrpmodr0(GICR_BANK_BASE(gicr_base, idx),
+					     idx);
 	} else {
 		assert(gicv3_driver_data->gicd_base != 0U);
-		igroup = gicd_get_igroupr(gicv3_driver_data->gicd_base, id);
-		grpmodr = gicd_get_igrpmodr(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		igroup = gicd_get_igroupr(GICD_SPI_BASE(gicd_base, IGROUPR, id),
+					  GICD_SPI_ID(id));
+		grpmodr = gicd_get_igrpmodr(
+				GICD_SPI_BASE(gicd_base, IGRPMODR, id),
+				GICD_SPI_ID(id));
 	}
 
 	/*
@@ -473,11 +569,17 @@ void gicv3_its_restore(uintptr_t gits_base, const gicv3_its_ctx_t * const its_ct
 /*****************************************************************************
  * Function to save the GIC Redistributor register context. This function
  * must be invoked after CPU interface disable and prior to Distributor save.
+ * The Secure configuration registers are only read if EL3 has changed them
+ * since they were last saved to the same context. All the registers that the
+ * Non-secure world can write are always read.
  *****************************************************************************/
 void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t * const rdist_ctx)
 {
 	uintptr_t gicr_base;
 	unsigned int int_id;
+#if GIC_EXT_INTID
+	unsigned int num_eppis;
+#endif
 
 	assert(gicv3_driver_data != NULL);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
@@ -486,6 +588,10 @@ void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t * const rdist_
 	assert(rdist_ctx != NULL);
 
 	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+#if GIC_EXT_INTID
+	num_eppis = gicr_get_eppi_num(gicr_base);
+	assert(num_eppis <= TOTAL_EPPI_INTR_NUM);
+#endif
 
 	/*
 	 * Wait for any write to GICR_CTLR to complete before trying to save any
@@ -498,20 +604,73 @@ void gicv3_rdistif_save(unsigned int proc_num, gicv3_redist_ctx_t * const rdist_
 	rdist_ctx->gicr_propbaser = gicr_read_propbaser(gicr_base);
 	rdist_ctx->gicr_pendbaser = gicr_read_pendbaser(gicr_base);
 
-	rdist_ctx->gicr_igroupr0 = gicr_read_igroupr0(gicr_base);
+	/*
+	 * Save the vPE that the hypervisor made resident on a GICv4
+	 * Redistributor. It is made non-resident so that the Redistributor
+	 * writes its pending virtual LPIs back to its pending table, from where
+	 * they are read again when it is made resident on restore.
+	 */
+	if ((gicr_read_typer(gicr_base) & TYPER_VLPIS_BIT) != 0U) {
+		rdist_ctx->gicr_vpropbaser = gicr_read_vpropbaser(gicr_base);
+		rdist_ctx->gicr_vpendbaser = gicr_read_vpendbaser(gicr_base);
+
+		if ((rdist_ctx->gicr_vpendbaser &
+		     GICR_VPENDBASER_VALID_BIT) != 0U) {
+			gicr_write_vpendbaser(gicr_base,
+				rdist_ctx->gicr_vpendbaser &
+				~GICR_VPENDBASER_VALID_BIT);
+			while ((gicr_read_vpendbaser(gicr_base) &
+				GICR_VPENDBASER_DIRTY_BIT) != 0U)
+				;
+		}
+	}
+
+	/*
+	 * The context may also be used to save other Redistributors, so it
+	 * records the one it was last saved from.
+	 */
+	if ((proc_num >= PLATFORM_CORE_COUNT) ||
+	    (gicv3_rdist_cfg_ctx[proc_num] != rdist_ctx) ||
+	    (rdist_ctx->cfg_proc_num != proc_num)) {
+		rdist_ctx->gicr_igroupr0 = gicr_read_igroupr0(gicr_base);
+		rdist_ctx->gicr_igrpmodr0 = gicr_read_igrpmodr0(gicr_base);
+		rdist_ctx->gicr_nsacr = gicr_read_nsacr(gicr_base);
+#if GIC_EXT_INTID
+		SAVE_GICR_EREGS(gicr_base, GICR_IGROUPR0, rdist_ctx,
+				num_eppis, igroupr, IGROUPR);
+		SAVE_GICR_EREGS(gicr_base, GICR_IGRPMODR0, rdist_ctx,
+				num_eppis, igrpmodr, IGRPMODR);
+#endif
+		rdist_ctx->cfg_proc_num = proc_num;
+
+		if (proc_num < PLATFORM_CORE_COUNT)
+			gicv3_rdist_cfg_ctx[proc_num] = rdist_ctx;
+	}
+
 	rdist_ctx->gicr_isenabler0 = gicr_read_isenabler0(gicr_base);
 	rdist_ctx->gicr_ispendr0 = gicr_read_ispendr0(gicr_base);
 	rdist_ctx->gicr_isactiver0 = gicr_read_isactiver0(gicr_base);
 	rdist_ctx->gicr_icfgr0 = gicr_read_icfgr0(gicr_base);
 	rdist_ctx->gicr_icfgr1 = gicr_read_icfgr1(gicr_base);
-	rdist_ctx->gicr_igrpmodr0 = gicr_read_igrpmodr0(gicr_base);
-	rdist_ctx->gicr_nsacr = gicr_read_nsacr(gicr_base);
 	for (int_id = MIN_SGI_ID; int_id < TOTAL_PCPU_INTR_NUM;
 			int_id += (1U << IPRIORITYR_SHIFT)) {
 		rdist_ctx->gicr_ipriorityr[(int_id - MIN_SGI_ID) >> IPRIORITYR_SHIFT] =
 				gicr_read_ipriorityr(gicr_base, int_id);
 	}
 
+#if GIC_EXT_INTID
+	/* Save the registers of the extended PPIs */
+	SAVE_GICR_EREGS(gicr_base, GICR_ISENABLER0, rdist_ctx, num_eppis,
+			isenabler, ISENABLER);
+	SAVE_GICR_EREGS(gicr_base, GICR_ISPENDR0, rdist_ctx, num_eppis,
+			ispendr, ISPENDR);
+	SAVE_GICR_EREGS(gicr_base, GICR_ISACTIVER0, rdist_ctx, num_eppis,
+			isactiver, ISACTIVER);
+	SAVE_GICR_EREGS(gicr_base, GICR_ICFGR0, rdist_ctx, num_eppis,
+			icfgr, ICFGR);
+	SAVE_GICR_EREGS(gicr_base, GICR_IPRIORITYR, rdist_ctx, num_eppis,
+			ipriorityr, IPRIORITYR);
+#endif
 
 	/*
 	 * Call the pre-save hook that implements the IMP DEF sequence that may
@@ -533,6 +692,9 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 {
 	uintptr_t gicr_base;
 	unsigned int int_id;
+#if GIC_EXT_INTID
+	unsigned int num_eppis;
+#endif
 
 	assert(gicv3_driver_data != NULL);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
@@ -541,6 +703,19 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	assert(rdist_ctx != NULL);
 
 	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+#if GIC_EXT_INTID
+	num_eppis = gicr_get_eppi_num(gicr_base);
+	assert(num_eppis <= TOTAL_EPPI_INTR_NUM);
+#endif
+
+	/*
+	 * The Secure configuration is restored from this context, which may
+	 * not be the one it was last saved to.
+	 */
+	if ((proc_num < PLATFORM_CORE_COUNT) &&
+	    ((gicv3_rdist_cfg_ctx[proc_num] != rdist_ctx) ||
+	     (rdist_ctx->cfg_proc_num != proc_num)))
+		gicv3_rdist_cfg_ctx[proc_num] = NULL;
 
 	/* Power on redistributor */
 	gicv3_rdistif_on(proc_num);
@@ -558,6 +733,11 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	 * GICD_CTLR
 	 */
 	gicr_write_icenabler0(gicr_base, ~0U);
+#if GIC_EXT_INTID
+	for (int_id = 0U; int_id < num_eppis; int_id += (1U << ICENABLER_SHIFT))
+		gicr_write_icenabler0(GICR_BANK_BASE(gicr_base,
+						     int_id + MIN_SPI_ID), ~0U);
+#endif
 	/* Wait for pending writes to GICR_ICENABLER */
 	gicr_wait_for_pending_write(gicr_base);
 
@@ -586,9 +766,27 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	gicr_write_igrpmodr0(gicr_base, rdist_ctx->gicr_igrpmodr0);
 	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
 
+#if GIC_EXT_INTID
+	/* Restore the configuration of the extended PPIs */
+	RESTORE_GICR_EREGS(gicr_base, GICR_IGROUPR0, rdist_ctx, num_eppis,
+			   igroupr, IGROUPR);
+	RESTORE_GICR_EREGS(gicr_base, GICR_IPRIORITYR, rdist_ctx, num_eppis,
+			   ipriorityr, IPRIORITYR);
+	RESTORE_GICR_EREGS(gicr_base, GICR_ICFGR0, rdist_ctx, num_eppis,
+			   icfgr, ICFGR);
+	RESTORE_GICR_EREGS(gicr_base, GICR_IGRPMODR0, rdist_ctx, num_eppis,
+			   igrpmodr, IGRPMODR);
+#endif
+
 	/* Restore after group and priorities are set */
 	gicr_write_ispendr0(gicr_base, rdist_ctx->gicr_ispendr0);
 	gicr_write_isactiver0(gicr_base, rdist_ctx->gicr_isactiver0);
+#if GIC_EXT_INTID
+	RESTORE_GICR_EREGS(gicr_base, GICR_ISPENDR0, rdist_ctx, num_eppis,
+			   ispendr, ISPENDR);
+	RESTORE_GICR_EREGS(gicr_base, GICR_ISACTIVER0, rdist_ctx, num_eppis,
+			   isactiver, ISACTIVER);
+#endif
 
 	/*
 	 * Wait for all writes to the Distributor to complete before enabling
@@ -596,6 +794,10 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	 */
 	gicr_wait_for_upstream_pending_write(gicr_base);
 	gicr_write_isenabler0(gicr_base, rdist_ctx->gicr_isenabler0);
+#if GIC_EXT_INTID
+	RESTORE_GICR_EREGS(gicr_base, GICR_ISENABLER0, rdist_ctx, num_eppis,
+			   isenabler, ISENABLER);
+#endif
 
 	/*
 	 * Restore GICR_CTLR.Enable_LPIs bit and wait for pending writes in case
@@ -605,6 +807,16 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 	 */
 	gicr_write_ctlr(gicr_base, rdist_ctx->gicr_ctlr);
 	gicr_wait_for_pending_write(gicr_base);
+
+	/*
+	 * Make the vPE saved on a GICv4 Redistributor resident again, once
+	 * physical LPIs are enabled. The base address registers must be
+	 * written while it is non-resident.
+	 */
+	if ((gicr_read_typer(gicr_base) & TYPER_VLPIS_BIT) != 0U) {
+		gicr_write_vpropbaser(gicr_base, rdist_ctx->gicr_vpropbaser);
+		gicr_write_vpendbaser(gicr_base, rdist_ctx->gicr_vpendbaser);
+	}
 }
 
 /*****************************************************************************
@@ -659,7 +871,30 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
 
 	/* Save GICD_IROUTER for INTIDs 32 - 1024 */
-	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter, IROUTER);
+	for (unsigned int int_id = MIN_SPI_ID; int_id < num_ints; int_id++) {
+		dist_ctx->gicd_irouter[int_id - MIN_SPI_ID] =
+				gicd_read_irouter(gicd_base, int_id);
+	}
+
+#if GIC_EXT_INTID
+	/* Save the registers of the extended SPIs, if any */
+	num_ints = gicd_get_espi_num(gicd_base);
+	assert(num_ints <= TOTAL_ESPI_INTR_NUM);
+
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, ipriorityr, IPRIORITYR);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, icfgr, ICFGR);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMODR);
+	SAVE_GICD_EREGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
+
+	for (unsigned int i = 0U; i < num_ints; i++) {
+		dist_ctx->gicd_iroutere[i] =
+			gicd_read_irouter(gicd_base, MIN_ESPI_ID + i);
+	}
+#endif
 
 	/*
 	 * GICD_ITARGETSR<n> and GICD_SPENDSGIR<n> are RAZ/WI when
@@ -678,6 +913,9 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 {
 	unsigned int num_ints = 0U;
+#if GIC_EXT_INTID
+	unsigned int num_espis;
+#endif
 
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
@@ -722,21 +960,53 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
 
 	/* Restore GICD_IROUTER for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter, IROUTER);
+	for (unsigned int int_id = MIN_SPI_ID; int_id < num_ints; int_id++) {
+		gicd_write_irouter(gicd_base, int_id,
+				dist_ctx->gicd_irouter[int_id - MIN_SPI_ID]);
+	}
+
+#if GIC_EXT_INTID
+	/* Restore the configuration of the extended SPIs, if any */
+	num_espis = gicd_get_espi_num(gicd_base);
+	assert(num_espis <= TOTAL_ESPI_INTR_NUM);
+
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_espis, igroupr, IGROUPR);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_espis, ipriorityr,
+			   IPRIORITYR);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_espis, icfgr, ICFGR);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_espis, igrpmodr, IGRPMODR);
+	RESTORE_GICD_EREGS(gicd_base, dist_ctx, num_espis, nsacr, NSACR);
+
+	for (unsigned int i = 0U; i < num_espis; i++) {
+		gicd_write_irouter(gicd_base, MIN_ESPI_ID + i,
+				   dist_ctx->gicd_iroutere[i]);
+	}
+#endif
 
 	/*
 	 * Restore ISENABLER, ISPENDR and ISACTIVER after the interrupts are
-	 * configured.
+	 * configured. Only their non-zero registers are written.
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isenabler,
+			      ISENABLER);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	RESTORE_GICD_SET_REGS(gicd_base, dist_ctx, num_ints, isactiver,
+			      ISACTIVER);
+
+#if GIC_EXT_INTID
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_espis, isenabler,
+			       ISENABLER);
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_espis, ispendr,
+			       ISPENDR);
+	RESTORE_GICD_SET_EREGS(gicd_base, dist_ctx, num_espis, isactiver,
+			       ISACTIVER);
+#endif
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
@@ -761,20 +1031,26 @@ unsigned int gicv3_get_running_priority(void)
  ******************************************************************************/
 unsigned int gicv3_get_interrupt_active(unsigned int id, unsigned int proc_num)
 {
-	unsigned int value;
+	unsigned int value, idx;
+	uintptr_t gicd_base;
 
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
-	assert(id <= MAX_SPI_ID);
+	assert(IS_VALID_INTR_ID(id));
 
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		/* For SGIs and PPIs */
-		value = gicr_get_isactiver0(
-				gicv3_driver_data->rdistif_base_addrs[proc_num], id);
+		idx = GICR_PCPU_IDX(id);
+		value = gicr_get_isactiver0(GICR_BANK_BASE(
+				gicv3_driver_data->rdistif_base_addrs[proc_num],
+				idx), idx);
 	} else {
-		value = gicd_get_isactiver(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		value = gicd_get_isactiver(
+				GICD_SPI_BASE(gicd_base, ISACTIVER, id),
+				GICD_SPI_ID(id));
 	}
 
 	return value;
@@ -787,24 +1063,30 @@ unsigned int gicv3_get_interrupt_active(unsigned int id, unsigned int proc_num)
  ******************************************************************************/
 void gicv3_enable_interrupt(unsigned int id, unsigned int proc_num)
 {
+	unsigned int idx;
+	uintptr_t gicd_base;
+
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
-	assert(id <= MAX_SPI_ID);
+	assert(IS_VALID_INTR_ID(id));
 
 	/*
 	 * Ensure that any shared variable updates depending on out of band
 	 * interrupt trigger are observed before enabling interrupt.
 	 */
 	dsbishst();
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		/* For SGIs and PPIs */
-		gicr_set_isenabler0(
+		idx = GICR_PCPU_IDX(id);
+		gicr_set_isenabler0(GICR_BANK_BASE(
 				gicv3_driver_data->rdistif_base_addrs[proc_num],
-				id);
+				idx), idx);
 	} else {
-		gicd_set_isenabler(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		gicd_set_isenabler(GICD_SPI_BASE(gicd_base, ISENABLER, id),
+				   GICD_SPI_ID(id));
 	}
 }
 
@@ -815,27 +1097,33 @@ void gicv3_enable_interrupt(unsigned int id, unsigned int proc_num)
  ******************************************************************************/
 void gicv3_disable_interrupt(unsigned int id, unsigned int proc_num)
 {
+	unsigned int idx;
+	uintptr_t gicd_base;
+
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
-	assert(id <= MAX_SPI_ID);
+	assert(IS_VALID_INTR_ID(id));
 
 	/*
 	 * Disable interrupt, and ensure that any shared variable updates
 	 * depending on out of band interrupt trigger are observed afterwards.
 	 */
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		/* For SGIs and PPIs */
-		gicr_set_icenabler0(
+		idx = GICR_PCPU_IDX(id);
+		gicr_set_icenabler0(GICR_BANK_BASE(
 				gicv3_driver_data->rdistif_base_addrs[proc_num],
-				id);
+				idx), idx);
 
 		/* Write to clear enable requires waiting for pending writes */
 		gicr_wait_for_pending_write(
 				gicv3_driver_data->rdistif_base_addrs[proc_num]);
 	} else {
-		gicd_set_icenabler(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		gicd_set_icenabler(GICD_SPI_BASE(gicd_base, ICENABLER, id),
+				   GICD_SPI_ID(id));
 
 		/* Write to clear enable requires waiting for pending writes */
 		gicd_wait_for_pending_write(gicv3_driver_data->gicd_base);
@@ -851,19 +1139,21 @@ void gicv3_disable_interrupt(unsigned int id, unsigned int proc_num)
 void gicv3_set_interrupt_priority(unsigned int id, unsigned int proc_num,
 		unsigned int priority)
 {
-	uintptr_t gicr_base;
+	uintptr_t gicr_base, gicd_base;
 
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
-	assert(id <= MAX_SPI_ID);
+	assert(IS_VALID_INTR_ID(id));
 
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
-		gicr_set_ipriorityr(gicr_base, id, priority);
+		gicr_set_ipriorityr(gicr_base, GICR_PCPU_IDX(id), priority);
 	} else {
-		gicd_set_ipriorityr(gicv3_driver_data->gicd_base, id, priority);
+		gicd_base = gicv3_driver_data->gicd_base;
+		gicd_set_ipriorityr(GICD_SPI_BASE(gicd_base, IPRIORITYR, id),
+				    GICD_SPI_ID(id), priority);
 	}
 }
 
@@ -876,12 +1166,14 @@ void gicv3_set_interrupt_type(unsigned int id, unsigned int proc_num,
 		unsigned int type)
 {
 	bool igroup = false, grpmod = false;
-	uintptr_t gicr_base;
+	uintptr_t gicr_base, gicd_base;
+	unsigned int idx;
 
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
 	assert(gicv3_driver_data->rdistif_base_addrs != NULL);
+	assert(IS_VALID_INTR_ID(id));
 
 	switch (type) {
 	case INTR_GROUP1S:
@@ -901,29 +1193,40 @@ void gicv3_set_interrupt_type(unsigned int id, unsigned int proc_num,
 		break;
 	}
 
-	if (id < MIN_SPI_ID) {
-		gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
+	if (IS_PCPU_INTR(id)) {
+		idx = GICR_PCPU_IDX(id);
+		gicr_base = GICR_BANK_BASE(
+				gicv3_driver_data->rdistif_base_addrs[proc_num],
+				idx);
+		gicv3_rdist_cfg_changed(proc_num);
 		if (igroup)
-			gicr_set_igroupr0(gicr_base, id);
+			gicr_set_igroupr0(gicr_base, idx);
 		else
-			gicr_clr_igroupr0(gicr_base, id);
+			gicr_clr_igroupr0(gicr_base, idx);
 
 		if (grpmod)
-			gicr_set_igrpmodr0(gicr_base, id);
+			gicr_set_igrpmodr0(gicr_base, idx);
 		else
-			gicr_clr_igrpmodr0(gicr_base, id);
+			gicr_clr_igrpmodr0(gicr_base, idx);
 	} else {
+		gicd_base = gicv3_driver_data->gicd_base;
+		idx = GICD_SPI_ID(id);
+
 		/* Serialize read-modify-write to Distributor registers */
 		spin_lock(&gic_lock);
 		if (igroup)
-			gicd_set_igroupr(gicv3_driver_data->gicd_base, id);
+			gicd_set_igroupr(GICD_SPI_BASE(gicd_base, IGROUPR, id),
+					 idx);
 		else
-			gicd_clr_igroupr(gicv3_driver_data->gicd_base, id);
+			gicd_clr_igroupr(GICD_SPI_BASE(gicd_base, IGROUPR, id),
+					 idx);
 
 		if (grpmod)
-			gicd_set_igrpmodr(gicv3_driver_data->gicd_base, id);
+			gicd_set_igrpmodr(
+				GICD_SPI_BASE(gicd_base, IGRPMODR, id), idx);
 		else
-			gicd_clr_igrpmodr(gicv3_driver_data->gicd_base, id);
+			gicd_clr_igrpmodr(
+				GICD_SPI_BASE(gicd_base, IGRPMODR, id), idx);
 		spin_unlock(&gic_lock);
 	}
 }
@@ -987,7 +1290,7 @@ void gicv3_set_spi_routing(unsigned int id, unsigned int irm, u_register_t mpidr
 	assert(gicv3_driver_data->gicd_base != 0U);
 
 	assert((irm == GICV3_IRM_ANY) || (irm == GICV3_IRM_PE));
-	assert((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID));
+	assert(((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID)) || IS_ESPI(id));
 
 	aff = gicd_irouter_val_from_mpidr(mpidr, irm);
 	gicd_write_irouter(gicv3_driver_data->gicd_base, id, aff);
@@ -1005,6 +1308,79 @@ void gicv3_set_spi_routing(unsigned int id, unsigned int irm, u_register_t mpidr
 	}
 }
 
+/*******************************************************************************
+ * This function routes the Secure SPIs of the platform interrupt properties.
+ * With routing mode GICV3_IRM_ANY, they are all routed with 1 of N distribution
+ * and mpidrs is ignored. With routing mode GICV3_IRM_PE, the SPIs routed to a
+ * single PE are spread round-robin over the mpidr_num PEs of the mpidrs array,
+ * and those routed with 1 of N distribution are left as they are.
+ ******************************************************************************/
+void gicv3_route_secure_spis(unsigned int irm, const u_register_t *mpidrs,
+			     unsigned int mpidr_num)
+{
+	const interrupt_prop_t *prop;
+	unsigned int i, n = 0U;
+	uint64_t router;
+
+	assert(gicv3_driver_data != NULL);
+	assert(gicv3_driver_data->gicd_base != 0U);
+	assert((irm == GICV3_IRM_ANY) || ((mpidrs != NULL) && (mpidr_num > 0U)));
+
+	for (i = 0U; i < gicv3_driver_data->interrupt_props_num; i++) {
+		prop = &gicv3_driver_data->interrupt_props[i];
+		if (IS_PCPU_INTR(prop->intr_num))
+			continue;
+
+		if (irm == GICV3_IRM_ANY) {
+			gicv3_set_spi_routing(prop->intr_num, GICV3_IRM_ANY, 0U);
+			continue;
+		}
+
+		router = gicd_read_irouter(gicv3_driver_data->gicd_base,
+					   prop->intr_num);
+		if (((router >> IROUTER_IRM_SHIFT) & IROUTER_IRM_MASK) != 0U)
+			continue;
+
+		gicv3_set_spi_routing(prop->intr_num, GICV3_IRM_PE,
+				      mpidrs[n]);
+		n = (n + 1U == mpidr_num) ? 0U : n + 1U;
+	}
+}
+
+/*******************************************************************************
+ * This function moves the Secure SPIs of the platform interrupt properties that
+ * are routed to the PE `mpidr` to the mpidr_num PEs of the mpidrs array,
+ * round-robin, e.g. before that PE is turned off.
+ ******************************************************************************/
+void gicv3_reroute_secure_spis(u_register_t mpidr, const u_register_t *mpidrs,
+			       unsigned int mpidr_num)
+{
+	const interrupt_prop_t *prop;
+	unsigned int i, n = 0U;
+	uint64_t router, from;
+
+	assert(gicv3_driver_data != NULL);
+	assert(gicv3_driver_data->gicd_base != 0U);
+	assert((mpidrs != NULL) && (mpidr_num > 0U));
+
+	from = gicd_irouter_val_from_mpidr(mpidr, GICV3_IRM_PE);
+
+	for (i = 0U; i < gicv3_driver_data->interrupt_props_num; i++) {
+		prop = &gicv3_driver_data->interrupt_props[i];
+		if (IS_PCPU_INTR(prop->intr_num))
+			continue;
+
+		router = gicd_read_irouter(gicv3_driver_data->gicd_base,
+					   prop->intr_num);
+		if (router != from)
+			continue;
+
+		gicv3_set_spi_routing(prop->intr_num, GICV3_IRM_PE,
+				      mpidrs[n]);
+		n = (n + 1U == mpidr_num) ? 0U : n + 1U;
+	}
+}
+
 /*******************************************************************************
  * This function clears the pending status of an interrupt identified by id.
  * The proc_num is used if the interrupt is SGI or PPI, and programs the
@@ -1012,6 +1388,9 @@ void gicv3_set_spi_routing(unsigned int id, unsigned int irm, u_register_t mpidr
  ******************************************************************************/
 void gicv3_clear_interrupt_pending(unsigned int id, unsigned int proc_num)
 {
+	unsigned int idx;
+	uintptr_t gicd_base;
+
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
@@ -1021,12 +1400,16 @@ void gicv3_clear_interrupt_pending(unsigned int id, unsigned int proc_num)
 	 * Clear pending interrupt, and ensure that any shared variable updates
 	 * depending on out of band interrupt trigger are observed afterwards.
 	 */
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		/* For SGIs and PPIs */
-		gicr_set_icpendr0(gicv3_driver_data->rdistif_base_addrs[proc_num],
-				id);
+		idx = GICR_PCPU_IDX(id);
+		gicr_set_icpendr0(GICR_BANK_BASE(
+				gicv3_driver_data->rdistif_base_addrs[proc_num],
+				idx), idx);
 	} else {
-		gicd_set_icpendr(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		gicd_set_icpendr(GICD_SPI_BASE(gicd_base, ICPENDR, id),
+				 GICD_SPI_ID(id));
 	}
 	dsbishst();
 }
@@ -1038,6 +1421,9 @@ void gicv3_clear_interrupt_pending(unsigned int id, unsigned int proc_num)
  ******************************************************************************/
 void gicv3_set_interrupt_pending(unsigned int id, unsigned int proc_num)
 {
+	unsigned int idx;
+	uintptr_t gicd_base;
+
 	assert(gicv3_driver_data != NULL);
 	assert(gicv3_driver_data->gicd_base != 0U);
 	assert(proc_num < gicv3_driver_data->rdistif_num);
@@ -1048,12 +1434,16 @@ void gicv3_set_interrupt_pending(unsigned int id, unsigned int proc_num)
 	 * interrupt trigger are observed before setting interrupt pending.
 	 */
 	dsbishst();
-	if (id < MIN_SPI_ID) {
+	if (IS_PCPU_INTR(id)) {
 		/* For SGIs and PPIs */
-		gicr_set_ispendr0(gicv3_driver_data->rdistif_base_addrs[proc_num],
-				id);
+		idx = GICR_PCPU_IDX(id);
+		gicr_set_ispendr0(GICR_BANK_BASE(
+				gicv3_driver_data->rdistif_base_addrs[proc_num],
+				idx), idx);
 	} else {
-		gicd_set_ispendr(gicv3_driver_data->gicd_base, id);
+		gicd_base = gicv3_driver_data->gicd_base;
+		gicd_set_ispendr(GICD_SPI_BASE(gicd_base, ISPENDR, id),
+				 GICD_SPI_ID(id));
 	}
 }
 
@@ -1078,3 +1468,66 @@ unsigned int gicv3_set_pmr(unsigned int mask)
 
 	return old_mask;
 }
+
+#if (GICV3_SECURE_SPI_ROUTING == GICV3_SPI_ROUTING_ROUND_ROBIN) && \
+	defined(IMAGE_BL31)
+/*******************************************************************************
+ * Spread the Secure SPIs over the PEs that are on, this one included, once it
+ * has been turned on.
+ ******************************************************************************/
+static void *gicv3_spi_routing_cpu_on(const void *arg)
+{
+	u_register_t mpidr = read_mpidr() & MPIDR_AFFINITY_MASK;
+	unsigned int i;
+
+	spin_lock(&spi_routing_lock);
+
+	for (i = 0U; i < spi_online_num; i++) {
+		if (spi_online_mpidrs[i] == mpidr)
+			break;
+	}
+
+	if (i == spi_online_num) {
+		assert(spi_online_num < PLATFORM_CORE_COUNT);
+		spi_online_mpidrs[spi_online_num++] = mpidr;
+	}
+
+	gicv3_route_secure_spis(GICV3_IRM_PE, spi_online_mpidrs,
+				spi_online_num);
+
+	spin_unlock(&spi_routing_lock);
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Move the Secure SPIs routed to this PE to the other PEs that are on, before
+ * it is turned off.
+ ******************************************************************************/
+static void *gicv3_spi_routing_cpu_off(const void *arg)
+{
+	u_register_t mpidr = read_mpidr() & MPIDR_AFFINITY_MASK;
+	unsigned int i;
+
+	spin_lock(&spi_routing_lock);
+
+	for (i = 0U; i < spi_online_num; i++) {
+		if (spi_online_mpidrs[i] == mpidr) {
+			spi_online_mpidrs[i] =
+				spi_online_mpidrs[--spi_online_num];
+			break;
+		}
+	}
+
+	if (spi_online_num > 0U)
+		gicv3_reroute_secure_spis(mpidr, spi_online_mpidrs,
+					  spi_online_num);
+
+	spin_unlock(&spi_routing_lock);
+
+	return NULL;
+}
+
+SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, gicv3_spi_routing_cpu_on);
+SUBSCRIBE_TO_EVENT(psci_cpu_off_start, gicv3_spi_routing_cpu_off);
+#endif
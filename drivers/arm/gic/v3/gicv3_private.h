@@ -22,6 +22,29 @@
 #define RWP_TRUE		U(1)
 #define RWP_FALSE		U(0)
 
+/*
+ * The registers of the extended SPIs have the layout of the registers of the
+ * SPIs, at other offsets and for interrupt IDs counted from MIN_ESPI_ID. The
+ * SPI accessors are used for both ranges, with the base address and the
+ * interrupt ID returned by these macros. REG is the name of the register.
+ */
+#define GICD_SPI_BASE(base, REG, id)					\
+	(IS_ESPI(id) ? ((base) + GICD_##REG##E - GICD_##REG) : (base))
+#define GICD_SPI_ID(id)		(IS_ESPI(id) ? ((id) - MIN_ESPI_ID) : (id))
+
+/*
+ * The registers of the extended PPIs follow the registers of the SGIs and PPIs
+ * in the SGI frame of the Redistributor, as if the extended PPIs were numbered
+ * from MIN_SPI_ID. GICR_PCPU_IDX() returns this index of a per-CPU interrupt.
+ * The accessors of the registers 0 are used for all per-CPU interrupts, with
+ * the index and the base address returned by GICR_BANK_BASE() for the 1-bit
+ * per interrupt registers or by GICR_ICFGR_BASE() for GICR_ICFGR0.
+ */
+#define GICR_PCPU_IDX(id)						\
+	(IS_EPPI(id) ? ((id) - MIN_EPPI_ID + MIN_SPI_ID) : (id))
+#define GICR_BANK_BASE(base, idx)	((base) + (((idx) >> 5) << 2))
+#define GICR_ICFGR_BASE(base, idx)	((base) + (((idx) >> ICFGR_SHIFT) << 2))
+
 /*
  * Macro to convert an mpidr to a value suitable for programming into a
  * GICD_IROUTER. Bits[31:24] in the MPIDR are cleared as they are not relevant
@@ -107,6 +130,11 @@ void gicv3_rdistif_base_addrs_probe(uintptr_t *rdistif_base_addrs,
 					mpidr_hash_fn mpidr_to_core_pos);
 void gicv3_rdistif_mark_core_awake(uintptr_t gicr_base);
 void gicv3_rdistif_mark_core_asleep(uintptr_t gicr_base);
+void gicv3_regs_save(uintptr_t addr, unsigned int num_regs, uint32_t *regs);
+void gicv3_regs_restore(uintptr_t addr, unsigned int num_regs,
+			const uint32_t *regs);
+void gicv3_set_regs_restore(uintptr_t addr, unsigned int num_regs,
+			    const uint32_t *regs);
 
 /*******************************************************************************
  * GIC Distributor interface accessors
@@ -131,6 +159,9 @@ static inline unsigned int gicd_read_pidr2(uintptr_t base)
 static inline unsigned long long gicd_read_irouter(uintptr_t base, unsigned int id)
 {
 	assert(id >= MIN_SPI_ID);
+	if (IS_ESPI(id))
+		return mmio_read_64(base + GICD_IROUTERE +
+				    ((id - MIN_ESPI_ID) << 3));
 	return mmio_read_64(base + GICD_IROUTER + (id << 3));
 }
 
@@ -139,7 +170,27 @@ static inline void gicd_write_irouter(uintptr_t base,
 				      unsigned long long affinity)
 {
 	assert(id >= MIN_SPI_ID);
-	mmio_write_64(base + GICD_IROUTER + (id << 3), affinity);
+	if (IS_ESPI(id))
+		mmio_write_64(base + GICD_IROUTERE + ((id - MIN_ESPI_ID) << 3),
+			      affinity);
+	else
+		mmio_write_64(base + GICD_IROUTER + (id << 3), affinity);
+}
+
+/* Number of extended SPIs implemented by the Distributor */
+static inline unsigned int gicd_get_espi_num(uintptr_t base)
+{
+	unsigned int typer;
+
+	if (GIC_EXT_INTID == 0)
+		return 0U;
+
+	typer = gicd_read_typer(base);
+	if ((typer & TYPER_ESPI_BIT) == 0U)
+		return 0U;
+
+	return (((typer >> TYPER_ESPI_RANGE_SHIFT) & TYPER_ESPI_RANGE_MASK) +
+		1U) << 5;
 }
 
 static inline void gicd_clr_ctlr(uintptr_t base,
@@ -178,6 +229,16 @@ static inline unsigned long long gicr_read_typer(uintptr_t base)
 	return mmio_read_64(base + GICR_TYPER);
 }
 
+/* Number of extended PPIs implemented by a Redistributor */
+static inline unsigned int gicr_get_eppi_num(uintptr_t base)
+{
+	if (GIC_EXT_INTID == 0)
+		return 0U;
+
+	return (unsigned int)((gicr_read_typer(base) >> TYPER_PPI_NUM_SHIFT) &
+			      TYPER_PPI_NUM_MASK) << 5;
+}
+
 static inline unsigned int gicr_read_waker(uintptr_t base)
 {
 	return mmio_read_32(base + GICR_WAKER);
@@ -331,6 +392,26 @@ static inline void gicr_write_pendbaser(uintptr_t base, uint64_t val)
 	mmio_write_64(base + GICR_PENDBASER, val);
 }
 
+static inline uint64_t gicr_read_vpropbaser(uintptr_t base)
+{
+	return mmio_read_64(base + GICR_VPROPBASER);
+}
+
+static inline void gicr_write_vpropbaser(uintptr_t base, uint64_t val)
+{
+	mmio_write_64(base + GICR_VPROPBASER, val);
+}
+
+static inline uint64_t gicr_read_vpendbaser(uintptr_t base)
+{
+	return mmio_read_64(base + GICR_VPENDBASER);
+}
+
+static inline void gicr_write_vpendbaser(uintptr_t base, uint64_t val)
+{
+	mmio_write_64(base + GICR_VPENDBASER, val);
+}
+
 /*******************************************************************************
  * GIC ITS functions to read and write entire ITS registers.
  ******************************************************************************/
@@ -4,10 +4,14 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
+#include <assert.h>
 #include <cdefs.h>
+#include <debug.h>
 #include <mmio.h>
 #include <smmu_v3.h>
 #include <stdbool.h>
+#include <string.h>
 
 static inline uint32_t __init smmuv3_read_s_idr1(uintptr_t base)
 {
@@ -57,3 +61,306 @@ int __init smmuv3_init(uintptr_t smmu_base)
 
 	return 0;
 }
+
+/*
+ * Secure stream table and command queue.
+ *
+ * The queue and the table are accessed by the SMMU as Non-cacheable memory,
+ * with data cache maintenance after each CPU write, so that the SMMU doesn't
+ * need to be I/O coherent. The callers must serialise the calls on a given
+ * SMMU.
+ */
+
+/* Queue index and wrap flag of a CMDQ_PROD or CMDQ_CONS value */
+#define CMDQ_IDX_WRP_MASK(_log2size)	((U(2) << (_log2size)) - 1U)
+#define CMDQ_IDX_MASK(_log2size)	((U(1) << (_log2size)) - 1U)
+
+static bool smmuv3_cmdq_full(const smmuv3_secure_t *smmu, uint32_t cons)
+{
+	uint32_t prod = smmu->cmdq_prod;
+
+	/* Same index, different wrap flag */
+	return ((prod ^ cons) & CMDQ_IDX_WRP_MASK(smmu->cmdq_log2size)) ==
+		(U(1) << smmu->cmdq_log2size);
+}
+
+static uint32_t smmuv3_read_cmdq_cons(const smmuv3_secure_t *smmu)
+{
+	return mmio_read_32(smmu->base + SMMU_S_CMDQ_CONS);
+}
+
+static bool smmuv3_cmdq_error(uint32_t cons)
+{
+	return ((cons >> SMMU_CMDQ_CONS_ERR_SHIFT) &
+		SMMU_CMDQ_CONS_ERR_MASK) != 0U;
+}
+
+/* Publish the commands written to the queue since the last call */
+static void smmuv3_cmdq_publish(smmuv3_secure_t *smmu, uint32_t first)
+{
+	unsigned int log2size = smmu->cmdq_log2size;
+	uint32_t idx = first & CMDQ_IDX_MASK(log2size);
+	uint32_t last = smmu->cmdq_prod & CMDQ_IDX_MASK(log2size);
+
+	if (idx == last)
+		return;
+
+	/* Clean the commands to memory, in two parts if the queue wrapped */
+	if (last > idx) {
+		flush_dcache_range(smmu->cmdq + (idx * SMMU_CMD_SIZE),
+				   (last - idx) * SMMU_CMD_SIZE);
+	} else {
+		flush_dcache_range(smmu->cmdq + (idx * SMMU_CMD_SIZE),
+				   ((U(1) << log2size) - idx) * SMMU_CMD_SIZE);
+		flush_dcache_range(smmu->cmdq, last * SMMU_CMD_SIZE);
+	}
+
+	dsbsy();
+	mmio_write_32(smmu->base + SMMU_S_CMDQ_PROD, smmu->cmdq_prod);
+}
+
+/* Write a command to the queue, waiting for an entry to be free */
+static int smmuv3_cmdq_write(smmuv3_secure_t *smmu, const smmuv3_cmd_t *cmd,
+			     uint32_t *first)
+{
+	uint32_t cons = smmuv3_read_cmdq_cons(smmu);
+	smmuv3_cmd_t *entry;
+
+	if (smmuv3_cmdq_full(smmu, cons)) {
+		/* Let the SMMU consume the commands written so far */
+		smmuv3_cmdq_publish(smmu, *first);
+		*first = smmu->cmdq_prod;
+
+		do {
+			cons = smmuv3_read_cmdq_cons(smmu);
+			if (smmuv3_cmdq_error(cons))
+				return -1;
+		} while (smmuv3_cmdq_full(smmu, cons));
+	}
+
+	entry = (smmuv3_cmd_t *)(smmu->cmdq + ((smmu->cmdq_prod &
+			CMDQ_IDX_MASK(smmu->cmdq_log2size)) * SMMU_CMD_SIZE));
+	*entry = *cmd;
+
+	smmu->cmdq_prod = (smmu->cmdq_prod + 1U) &
+			  CMDQ_IDX_WRP_MASK(smmu->cmdq_log2size);
+
+	return 0;
+}
+
+/*
+ * Submit a batch of commands, followed by a single CMD_SYNC, and wait for
+ * the SMMU to complete all of them. The commands are published to the SMMU
+ * at once, unless they don't fit in the queue.
+ *
+ * Returns 0 on success, and -1 if the SMMU reported a command error.
+ */
+int smmuv3_secure_submit(smmuv3_secure_t *smmu, const smmuv3_cmd_t *cmds,
+			 unsigned int num_cmds)
+{
+	const smmuv3_cmd_t sync = { { SMMU_CMD_SYNC, 0ULL } };
+	uint32_t first = smmu->cmdq_prod;
+	uint32_t cons;
+	unsigned int i;
+
+	assert(smmu->cmdq != 0U);
+	assert((num_cmds == 0U) || (cmds != NULL));
+
+	for (i = 0U; i < num_cmds; i++) {
+		if (smmuv3_cmdq_write(smmu, &cmds[i], &first) != 0)
+			goto cmd_error;
+	}
+
+	if (smmuv3_cmdq_write(smmu, &sync, &first) != 0)
+		goto cmd_error;
+
+	smmuv3_cmdq_publish(smmu, first);
+
+	/* The CMD_SYNC completed once the SMMU consumed it */
+	do {
+		cons = smmuv3_read_cmdq_cons(smmu);
+		if (smmuv3_cmdq_error(cons))
+			goto cmd_error;
+	} while (((cons ^ smmu->cmdq_prod) &
+		  CMDQ_IDX_WRP_MASK(smmu->cmdq_log2size)) != 0U);
+
+	return 0;
+
+cmd_error:
+	ERROR("SMMUv3: Secure command queue error 0x%x\n",
+	      (smmuv3_read_cmdq_cons(smmu) >> SMMU_CMDQ_CONS_ERR_SHIFT) &
+	      SMMU_CMDQ_CONS_ERR_MASK);
+	return -1;
+}
+
+/* Update the enable bits of SMMU_S_CR0 and wait for the SMMU to ack them */
+static void smmuv3_write_s_cr0(uintptr_t base, uint32_t value)
+{
+	mmio_write_32(base + SMMU_S_CR0, value);
+	while (mmio_read_32(base + SMMU_S_CR0ACK) != value)
+		;
+}
+
+/*
+ * Initialize the Secure stream table and command queue of an SMMU, and enable
+ * Secure translation. All the Secure streams abort until their STE is
+ * written with smmuv3_secure_write_ste().
+ *
+ * Returns 0 on success, and -1 on failure.
+ */
+int smmuv3_secure_init(smmuv3_secure_t *smmu)
+{
+	const smmuv3_cmd_t cfgi_all = {
+		{ SMMU_CMD_CFGI_ALL | SMMU_CMD_0_SSEC, SMMU_CMD_1_RANGE_ALL }
+	};
+	uint32_t idr1_reg, s_idr1_reg;
+	size_t strtab_size;
+
+	assert(smmu != NULL);
+	assert(smmu->base != 0U);
+	assert((smmu->strtab != 0U) && (smmu->cmdq != 0U));
+
+	s_idr1_reg = mmio_read_32(smmu->base + SMMU_S_IDR1);
+	idr1_reg = mmio_read_32(smmu->base + SMMU_IDR1);
+
+	if (((s_idr1_reg >> SMMU_S_IDR1_SECURE_IMPL_SHIFT) &
+			SMMU_S_IDR1_SECURE_IMPL_MASK) == 0U) {
+		return -1;
+	}
+
+	if ((smmu->strtab_log2size > ((s_idr1_reg >>
+			SMMU_S_IDR1_S_SIDSIZE_SHIFT) &
+			SMMU_S_IDR1_S_SIDSIZE_MASK)) ||
+	    (smmu->cmdq_log2size > ((idr1_reg >> SMMU_IDR1_CMDQS_SHIFT) &
+			SMMU_IDR1_CMDQS_MASK))) {
+		ERROR("SMMUv3: Secure stream table or command queue too big\n");
+		return -1;
+	}
+
+	smmu->sel2 = ((s_idr1_reg >> SMMU_S_IDR1_SEL2_SHIFT) &
+			SMMU_S_IDR1_SEL2_MASK) != 0U;
+
+	/* The queue and table base registers can only be written when off */
+	smmuv3_write_s_cr0(smmu->base, 0U);
+
+	/* All the STEs are invalid, so the streams abort */
+	strtab_size = (size_t)SMMU_STE_SIZE << smmu->strtab_log2size;
+	(void)memset((void *)smmu->strtab, 0, strtab_size);
+	flush_dcache_range(smmu->strtab, strtab_size);
+
+	mmio_write_32(smmu->base + SMMU_S_CR1,
+		      (SMMU_S_CR1_SH_OSH << SMMU_S_CR1_QUEUE_SH_SHIFT) |
+		      (SMMU_S_CR1_SH_OSH << SMMU_S_CR1_TABLE_SH_SHIFT));
+
+	mmio_write_64(smmu->base + SMMU_S_STRTAB_BASE,
+		      (uint64_t)smmu->strtab & SMMU_STRTAB_BASE_ADDR_MASK);
+	mmio_write_32(smmu->base + SMMU_S_STRTAB_BASE_CFG,
+		      smmu->strtab_log2size &
+		      SMMU_STRTAB_BASE_CFG_LOG2SIZE_MASK);
+
+	mmio_write_64(smmu->base + SMMU_S_CMDQ_BASE,
+		      ((uint64_t)smmu->cmdq & SMMU_CMDQ_BASE_ADDR_MASK) |
+		      (smmu->cmdq_log2size & SMMU_CMDQ_BASE_LOG2SIZE_MASK));
+	mmio_write_32(smmu->base + SMMU_S_CMDQ_PROD, 0U);
+	mmio_write_32(smmu->base + SMMU_S_CMDQ_CONS, 0U);
+	smmu->cmdq_prod = 0U;
+
+	smmuv3_write_s_cr0(smmu->base, SMMU_S_CR0_CMDQEN);
+
+	/*
+	 * Discard any Secure STE cached before. The TLBs are expected to have
+	 * been invalidated by smmuv3_init().
+	 */
+	if (smmuv3_secure_submit(smmu, &cfgi_all, 1U) != 0)
+		return -1;
+
+	smmuv3_write_s_cr0(smmu->base, SMMU_S_CR0_CMDQEN | SMMU_S_CR0_SMMUEN);
+
+	return 0;
+}
+
+/*
+ * Write the SMMU_STE_DWORDS double words of the STE of a Secure stream. A
+ * valid STE is first made invalid, so that the SMMU never observes an STE
+ * partly written. The new STE becomes valid when its dword 0 is written.
+ *
+ * Returns 0 on success, and -1 on failure.
+ */
+int smmuv3_secure_write_ste(smmuv3_secure_t *smmu, unsigned int sid,
+			    const uint64_t *ste)
+{
+	uint64_t *entry;
+	smmuv3_cmd_t cmd;
+	unsigned int i;
+
+	assert(smmu->strtab != 0U);
+	assert(ste != NULL);
+	assert(sid < (U(1) << smmu->strtab_log2size));
+
+	entry = (uint64_t *)(smmu->strtab + ((uintptr_t)sid * SMMU_STE_SIZE));
+	smmuv3_cmd_cfgi_ste(&cmd, sid);
+
+	if ((entry[0] & SMMU_STE_0_V) != 0ULL) {
+		entry[0] &= ~SMMU_STE_0_V;
+		flush_dcache_range((uintptr_t)entry, SMMU_STE_SIZE);
+		if (smmuv3_secure_submit(smmu, &cmd, 1U) != 0)
+			return -1;
+	}
+
+	for (i = 1U; i < SMMU_STE_DWORDS; i++)
+		entry[i] = ste[i];
+	flush_dcache_range((uintptr_t)entry, SMMU_STE_SIZE);
+
+	/* Make the rest of the STE visible before it becomes valid */
+	dsbsy();
+	entry[0] = ste[0];
+	flush_dcache_range((uintptr_t)entry, sizeof(uint64_t));
+
+	return smmuv3_secure_submit(smmu, &cmd, 1U);
+}
+
+/*
+ * Ranges of more than SMMUV3_TLBI_RANGE_MAX 4KB pages are invalidated as a
+ * whole VMID. Stepping by 4KB covers all the translation granules.
+ */
+#define SMMUV3_TLBI_RANGE_MAX		U(32)
+#define SMMUV3_TLBI_PAGE_SHIFT		U(12)
+#define SMMUV3_TLBI_PAGE_SIZE		(U(1) << SMMUV3_TLBI_PAGE_SHIFT)
+
+/*
+ * Invalidate the Secure stage 2 TLB entries of `vmid` for the IPA range
+ * [ipa, ipa + size), e.g. after updating the stage 2 translation tables of a
+ * Secure partition. The page invalidations are batched with a single
+ * CMD_SYNC.
+ *
+ * Returns 0 on success, and -1 on failure.
+ */
+int smmuv3_secure_tlbi_s2_range(smmuv3_secure_t *smmu, unsigned int vmid,
+				uint64_t ipa, size_t size)
+{
+	smmuv3_cmd_t cmds[SMMUV3_TLBI_RANGE_MAX];
+	uint64_t start = ipa & ~((uint64_t)SMMUV3_TLBI_PAGE_SIZE - 1ULL);
+	uint64_t end = ipa + size;
+	unsigned int n = 0U;
+
+	assert(smmu != NULL);
+
+	if (!smmu->sel2) {
+		ERROR("SMMUv3: Secure stage 2 is not implemented\n");
+		return -1;
+	}
+
+	if (size == 0U)
+		return 0;
+
+	if (((end - start + SMMUV3_TLBI_PAGE_SIZE - 1ULL) >>
+			SMMUV3_TLBI_PAGE_SHIFT) > SMMUV3_TLBI_RANGE_MAX) {
+		smmuv3_cmd_tlbi_s12_vmall(&cmds[0], vmid);
+		return smmuv3_secure_submit(smmu, cmds, 1U);
+	}
+
+	for (; start < end; start += SMMUV3_TLBI_PAGE_SIZE)
+		smmuv3_cmd_tlbi_s2_ipa(&cmds[n++], vmid, start);
+
+	return smmuv3_secure_submit(smmu, cmds, n);
+}
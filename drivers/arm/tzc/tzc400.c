@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <tzc400.h>
 #include "tzc_common_private.h"
@@ -21,6 +22,20 @@
 #define TZC_400_REGION_ATTR_0_OFFSET		U(0x110)
 #define TZC_400_REGION_ID_ACCESS_0_OFFSET	U(0x114)
 
+#define TZC_400_MAX_REGIONS			U(9)
+
+/*
+ * Shadow copy of the registers of a region. `dirty` is set when the region
+ * has been updated with tzc400_update_region() and not committed yet.
+ */
+typedef struct tzc400_region {
+	unsigned long long base;
+	unsigned long long top;
+	unsigned int attr;
+	unsigned int id_access;
+	bool dirty;
+} tzc400_region_t;
+
 /*
  * Implementation defined values used to validate inputs later.
  * Filters : max of 4 ; 0 to 3
@@ -32,6 +47,7 @@ typedef struct tzc400_instance {
 	uint8_t addr_width;
 	uint8_t num_filters;
 	uint8_t num_regions;
+	tzc400_region_t region[TZC_400_MAX_REGIONS];
 } tzc400_instance_t;
 
 static tzc400_instance_t tzc400;
@@ -51,6 +67,13 @@ static inline void _tzc400_write_gate_keeper(uintptr_t base, unsigned int val)
 	mmio_write_32(base + GATE_KEEPER_OFF, val);
 }
 
+static inline uint32_t _tzc400_read_region_reg(uintptr_t base,
+				unsigned int region, unsigned int offset)
+{
+	return mmio_read_32(base +
+		TZC_REGION_OFFSET(TZC_400_REGION_SIZE, region) + offset);
+}
+
 /*
  * Get the open status information for all filter units.
  */
@@ -78,6 +101,47 @@ static unsigned int _tzc400_get_gate_keeper(uintptr_t base,
 	return (open_status >> filter) & GATE_KEEPER_FILTER_MASK;
 }
 
+/*
+ * Request the open status of all the filters at once, `open_mask` being a
+ * bitmap of the filters to open. This function is not MP safe.
+ */
+static void _tzc400_set_gate_keepers(uintptr_t base, unsigned int open_mask)
+{
+	_tzc400_write_gate_keeper(base, (open_mask & GATE_KEEPER_OR_MASK) <<
+			      GATE_KEEPER_OR_SHIFT);
+
+	/* Wait here until we see the change reflected in the TZC status. */
+	while ((get_gate_keeper_os(base)) != (open_mask & GATE_KEEPER_OS_MASK))
+		;
+}
+
+/* Read the registers of all the regions into their shadow copy */
+static void _tzc400_read_regions(void)
+{
+	tzc400_region_t *r;
+	unsigned int i;
+
+	for (i = 0U; i < tzc400.num_regions; i++) {
+		r = &tzc400.region[i];
+
+		r->base = _tzc400_read_region_reg(tzc400.base, i,
+				TZC_400_REGION_BASE_LOW_0_OFFSET);
+		r->base |= (unsigned long long)_tzc400_read_region_reg(
+				tzc400.base, i,
+				TZC_400_REGION_BASE_HIGH_0_OFFSET) << 32;
+		r->top = _tzc400_read_region_reg(tzc400.base, i,
+				TZC_400_REGION_TOP_LOW_0_OFFSET);
+		r->top |= (unsigned long long)_tzc400_read_region_reg(
+				tzc400.base, i,
+				TZC_400_REGION_TOP_HIGH_0_OFFSET) << 32;
+		r->attr = _tzc400_read_region_reg(tzc400.base, i,
+				TZC_400_REGION_ATTR_0_OFFSET);
+		r->id_access = _tzc400_read_region_reg(tzc400.base, i,
+				TZC_400_REGION_ID_ACCESS_0_OFFSET);
+		r->dirty = false;
+	}
+}
+
 /* This function is not MP safe. */
 static void _tzc400_set_gate_keeper(uintptr_t base,
 				unsigned int filter,
@@ -93,12 +157,7 @@ static void _tzc400_set_gate_keeper(uintptr_t base,
 	else
 		open_status &= ~(1U << filter);
 
-	_tzc400_write_gate_keeper(base, (open_status & GATE_KEEPER_OR_MASK) <<
-			      GATE_KEEPER_OR_SHIFT);
-
-	/* Wait here until we see the change reflected in the TZC status. */
-	while ((get_gate_keeper_os(base)) != open_status)
-		;
+	_tzc400_set_gate_keepers(base, open_status);
 }
 
 void tzc400_set_action(unsigned int action)
@@ -140,6 +199,10 @@ void tzc400_init(uintptr_t base)
 					BUILD_CONFIG_AW_MASK) + 1U;
 	tzc400.num_regions = (uint8_t)((tzc400_build >> BUILD_CONFIG_NR_SHIFT) &
 					BUILD_CONFIG_NR_MASK) + 1U;
+
+	assert(tzc400.num_regions <= TZC_400_MAX_REGIONS);
+
+	_tzc400_read_regions();
 }
 
 /*
@@ -155,6 +218,9 @@ void tzc400_configure_region0(unsigned int sec_attr,
 	assert(sec_attr <= TZC_REGION_S_RDWR);
 
 	_tzc400_configure_region0(tzc400.base, sec_attr, ns_device_access);
+
+	tzc400.region[0].attr = sec_attr << TZC_REGION_ATTR_SEC_SHIFT;
+	tzc400.region[0].id_access = ns_device_access;
 }
 
 /*
@@ -165,12 +231,11 @@ void tzc400_configure_region0(unsigned int sec_attr,
  * Region 0 is special; it is preferable to use tzc400_configure_region0
  * for this region (see comment for that function).
  */
-void tzc400_configure_region(unsigned int filters,
+static void tzc400_check_region(unsigned int filters,
 			  unsigned int region,
 			  unsigned long long region_base,
 			  unsigned long long region_top,
-			  unsigned int sec_attr,
-			  unsigned int nsaid_permissions)
+			  unsigned int sec_attr)
 {
 	assert(tzc400.base != 0U);
 
@@ -189,10 +254,114 @@ void tzc400_configure_region(unsigned int filters,
 	assert(((region_base | (region_top + 1U)) & (4096U - 1U)) == 0U);
 
 	assert(sec_attr <= TZC_REGION_S_RDWR);
+}
+
+void tzc400_configure_region(unsigned int filters,
+			  unsigned int region,
+			  unsigned long long region_base,
+			  unsigned long long region_top,
+			  unsigned int sec_attr,
+			  unsigned int nsaid_permissions)
+{
+	tzc400_region_t *r = &tzc400.region[region];
+
+	tzc400_check_region(filters, region, region_base, region_top,
+			    sec_attr);
 
 	_tzc400_configure_region(tzc400.base, filters, region, region_base,
 						region_top,
 						sec_attr, nsaid_permissions);
+
+	r->base = region_base;
+	r->top = region_top;
+	r->attr = (sec_attr << TZC_REGION_ATTR_SEC_SHIFT) |
+		  (filters << TZC_REGION_ATTR_F_EN_SHIFT);
+	r->id_access = nsaid_permissions;
+	r->dirty = false;
+}
+
+/*
+ * `tzc400_update_region` updates the shadow copy of a region without
+ * programming the TrustZone controller, so that several regions can be
+ * reprogrammed together by `tzc400_commit_regions`. The region is only
+ * reprogrammed if its configuration changed. The arguments are the same as
+ * for `tzc400_configure_region`.
+ */
+void tzc400_update_region(unsigned int filters,
+			  unsigned int region,
+			  unsigned long long region_base,
+			  unsigned long long region_top,
+			  unsigned int sec_attr,
+			  unsigned int nsaid_permissions)
+{
+	tzc400_region_t *r = &tzc400.region[region];
+	unsigned int attr;
+
+	/* Region 0 has no base and top, see tzc400_configure_region0 */
+	assert(region != 0U);
+	tzc400_check_region(filters, region, region_base, region_top,
+			    sec_attr);
+
+	attr = (sec_attr << TZC_REGION_ATTR_SEC_SHIFT) |
+	       (filters << TZC_REGION_ATTR_F_EN_SHIFT);
+
+	if ((r->base == region_base) && (r->top == region_top) &&
+	    (r->attr == attr) && (r->id_access == nsaid_permissions))
+		return;
+
+	r->base = region_base;
+	r->top = region_top;
+	r->attr = attr;
+	r->id_access = nsaid_permissions;
+	r->dirty = true;
+}
+
+/*
+ * `tzc400_commit_regions` programs all the regions updated since the last
+ * commit. The gate keepers of the filters used by these regions, before or
+ * after the update, are closed once around the programming of all of them,
+ * and then restored to their previous state. The other filters are left open.
+ * This function is not MP safe.
+ */
+void tzc400_commit_regions(void)
+{
+	tzc400_region_t *r;
+	unsigned int i, filters = 0U, open_status;
+
+	assert(tzc400.base != 0U);
+
+	/* Find the filters affected by the update */
+	for (i = 1U; i < tzc400.num_regions; i++) {
+		if (tzc400.region[i].dirty) {
+			filters |= (_tzc400_read_region_reg(tzc400.base, i,
+					TZC_400_REGION_ATTR_0_OFFSET) |
+				    tzc400.region[i].attr) >>
+				   TZC_REGION_ATTR_F_EN_SHIFT;
+		}
+	}
+
+	filters &= TZC_400_REGION_ATTR_F_EN_MASK;
+	if (filters == 0U)
+		return;
+
+	open_status = get_gate_keeper_os(tzc400.base);
+	if ((open_status & filters) != 0U)
+		_tzc400_set_gate_keepers(tzc400.base, open_status & ~filters);
+
+	for (i = 1U; i < tzc400.num_regions; i++) {
+		r = &tzc400.region[i];
+		if (!r->dirty)
+			continue;
+
+		_tzc400_write_region_base(tzc400.base, i, r->base);
+		_tzc400_write_region_top(tzc400.base, i, r->top);
+		_tzc400_write_region_attributes(tzc400.base, i, r->attr);
+		_tzc400_write_region_id_access(tzc400.base, i, r->id_access);
+		r->dirty = false;
+	}
+
+	if ((open_status & filters) != 0U)
+		_tzc400_set_gate_keepers(tzc400.base, open_status);
 }
 
 void tzc400_enable_filters(void)
@@ -4,12 +4,15 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_AUTH
+
 #include <assert.h>
 #include <auth_common.h>
 #include <auth_mod.h>
 #include <cot_def.h>
 #include <crypto_mod.h>
 #include <debug.h>
+#include <event_log.h>
 #include <img_parser_mod.h>
 #include <platform.h>
 #include <platform_def.h>
@@ -28,10 +31,82 @@
 
 #pragma weak plat_set_nv_ctr2
 
+/* Image being authenticated while it is loaded, if any */
+#define INVALID_IMG_ID		(~0U)
+
 /* Pointer to CoT */
 extern const auth_img_desc_t *const cot_desc_ptr;
 extern unsigned int auth_img_flags[MAX_NUMBER_IDS];
 
+static unsigned int incremental_img_id = INVALID_IMG_ID;
+
+#if AUTH_CERT_CACHE
+/*
+ * SHA-256 digests of the certificates authenticated by this boot stage, indexed
+ * by image id. A certificate that is authenticated again with the same content
+ * does not need its signature to be checked again.
+ */
+#define CERT_DIGEST_LEN		32U
+
+static struct {
+	unsigned char digest[CERT_DIGEST_LEN];
+	unsigned int valid;
+} cert_cache[MAX_NUMBER_IDS];
+
+/*
+ * Whether the parameters extracted from an image for its children are still
+ * held in their buffers, indexed by image id. It is cleared when another image
+ * extracts parameters to the same buffers.
+ */
+static unsigned char params_valid[MAX_NUMBER_IDS];
+
+/*
+ * Mark as invalid the parameters of the images sharing a parameter buffer with
+ * `img_desc`, before the parameters of `img_desc` are extracted.
+ */
+static void invalidate_shared_params(const auth_img_desc_t *img_desc)
+{
+	const auth_img_desc_t *other;
+	unsigned int id;
+	int i, j;
+
+	params_valid[img_desc->img_id] = 0U;
+
+	for (id = 0U; id < MAX_NUMBER_IDS; id++) {
+		if (params_valid[id] == 0U) {
+			continue;
+		}
+
+		other = &cot_desc_ptr[id];
+		for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+			if (img_desc->authenticated_data[i].type_desc == NULL) {
+				continue;
+			}
+
+			for (j = 0 ; j < COT_MAX_VERIFIED_PARAMS ; j++) {
+				if (other->authenticated_data[j].data.ptr ==
+				    img_desc->authenticated_data[i].data.ptr) {
+					params_valid[id] = 0U;
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Return 1 if the image has been authenticated by this boot stage and the
+ * parameters it provides to its children are still held, so that it doesn't
+ * need to be loaded and authenticated again to authenticate them. Return 0
+ * otherwise.
+ */
+int auth_mod_has_params(unsigned int img_id)
+{
+	assert(img_id < MAX_NUMBER_IDS);
+
+	return (params_valid[img_id] != 0U) ? 1 : 0;
+}
+#endif /* AUTH_CERT_CACHE */
+
 static int cmp_auth_param_type_desc(const auth_param_type_desc_t *a,
 		const auth_param_type_desc_t *b)
 {
@@ -320,6 +395,79 @@ int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id)
 	return 0;
 }
 
+/*
+ * Get the hash that an image authenticated by hash must match, as extracted
+ * from its parent certificate, e.g. to publish it for an image loaded by a
+ * later boot stage. The parent must have been authenticated. The hash is a DER
+ * encoded DigestInfo, which includes the hash algorithm.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_get_img_hash(unsigned int img_id, void **hash, unsigned int *len)
+{
+	const auth_img_desc_t *img_desc;
+	const auth_method_desc_t *auth_method;
+	unsigned char *der;
+	int rc, i;
+
+	assert(hash != NULL);
+	assert(len != NULL);
+	assert(img_id < MAX_NUMBER_IDS);
+
+	img_desc = &cot_desc_ptr[img_id];
+	if (img_desc->parent == NULL) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		auth_method = &img_desc->img_auth_methods[i];
+		if (auth_method->type != AUTH_METHOD_HASH) {
+			continue;
+		}
+
+		rc = auth_get_param(auth_method->param.hash.hash,
+				img_desc->parent, hash, len);
+		return_if_error(rc);
+
+		/* Trim the buffer to the length of the DER SEQUENCE */
+		der = *hash;
+		if ((*len >= 2U) && (der[0] == 0x30U) && (der[1] < 0x80U) &&
+		    ((der[1] + 2U) <= *len)) {
+			*len = der[1] + 2U;
+		}
+
+		return 0;
+	}
+
+	return 1;
+}
+
+#if MEASURED_BOOT && defined(IMAGE_BL2)
+/*
+ * Measure an image that has just been authenticated. Only the images
+ * authenticated by hash are measured, the measurement is the DigestInfo of
+ * the parent they have been verified against.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+static int auth_measure_img(unsigned int img_id)
+{
+	void *hash;
+	unsigned int len;
+
+	if (auth_mod_get_img_hash(img_id, &hash, &len) != 0) {
+		return 0;
+	}
+
+	return event_log_measure(img_id, hash, len);
+}
+#else
+static inline int auth_measure_img(unsigned int img_id)
+{
+	return 0;
+}
+#endif
+
 /*
  * Initialize the different modules in the authentication framework
  */
@@ -349,6 +497,11 @@ int auth_mod_verify_img(unsigned int img_id,
 	void *param_ptr;
 	unsigned int param_len;
 	int rc, i;
+	int verified = 0;
+#if AUTH_CERT_CACHE
+	unsigned char digest[CERT_DIGEST_LEN];
+	int have_digest = 0;
+#endif
 
 	/* Get the image descriptor from the chain of trust */
 	img_desc = &cot_desc_ptr[img_id];
@@ -357,9 +510,31 @@ int auth_mod_verify_img(unsigned int img_id,
 	rc = img_parser_check_integrity(img_desc->img_type, img_ptr, img_len);
 	return_if_error(rc);
 
+#if AUTH_CERT_CACHE
+	/* Skip the authentication methods if this exact certificate has
+	 * already been authenticated */
+	if ((img_desc->img_type != IMG_RAW) &&
+	    (crypto_mod_calc_hash(CRYPTO_HASH_SHA256, img_ptr, img_len,
+				  digest) == 0)) {
+		have_digest = 1;
+		if (cert_cache[img_id].valid != 0U) {
+			if (memcmp(cert_cache[img_id].digest, digest,
+				   CERT_DIGEST_LEN) == 0) {
+				VERBOSE("Certificate id=%u found in cache\n",
+					img_id);
+				verified = 1;
+			} else {
+				/* The certificates that depend on this one
+				 * must be authenticated again */
+				memset(cert_cache, 0, sizeof(cert_cache));
+			}
+		}
+	}
+#endif
+
 	/* Authenticate the image using the methods indicated in the image
 	 * descriptor. */
-	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+	for (i = 0 ; (verified == 0) && (i < AUTH_METHOD_NUM) ; i++) {
 		auth_method = &img_desc->img_auth_methods[i];
 		switch (auth_method->type) {
 		case AUTH_METHOD_NONE:
@@ -385,6 +560,16 @@ int auth_mod_verify_img(unsigned int img_id,
 		return_if_error(rc);
 	}
 
+	/* Measure the image while the hash of its parent is still valid */
+	if (verified == 0) {
+		rc = auth_measure_img(img_id);
+		return_if_error(rc);
+	}
+
+#if AUTH_CERT_CACHE
+	invalidate_shared_params(img_desc);
+#endif
+
 	/* Extract the parameters indicated in the image descriptor to
 	 * authenticate the children images. */
 	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
@@ -408,8 +593,128 @@ int auth_mod_verify_img(unsigned int img_id,
 				(void *)param_ptr, param_len);
 	}
 
+#if AUTH_CERT_CACHE
+	if (have_digest != 0) {
+		memcpy(cert_cache[img_id].digest, digest, CERT_DIGEST_LEN);
+		cert_cache[img_id].valid = 1U;
+	}
+	params_valid[img_id] = 1U;
+#endif
+
 	/* Mark image as authenticated */
 	auth_img_flags[img_desc->img_id] |= IMG_FLAG_AUTHENTICATED;
 
 	return 0;
 }
+
+/*
+ * Start the authentication of an image before it is loaded, so that it can be
+ * hashed one piece at a time with auth_mod_verify_img_update() as it is read
+ * from storage.
+ *
+ * This is only possible for raw images that are authenticated by hash alone and
+ * do not provide authentication parameters to other images, and only if the
+ * crypto library supports incremental hashing.
+ *
+ * Return: 0 = success, Otherwise = the image must be authenticated with
+ *         auth_mod_verify_img() once it is loaded
+ */
+int auth_mod_verify_img_init(unsigned int img_id)
+{
+	const auth_img_desc_t *img_desc = NULL;
+	const auth_method_param_hash_t *hash_param = NULL;
+	void *hash_der_ptr;
+	unsigned int hash_der_len;
+	int rc, i;
+
+	incremental_img_id = INVALID_IMG_ID;
+
+	/* Get the image descriptor from the chain of trust */
+	img_desc = &cot_desc_ptr[img_id];
+
+	if ((img_desc->img_type != IMG_RAW) || (img_desc->parent == NULL)) {
+		return 1;
+	}
+
+	for (i = 0 ; i < AUTH_METHOD_NUM ; i++) {
+		switch (img_desc->img_auth_methods[i].type) {
+		case AUTH_METHOD_NONE:
+			break;
+		case AUTH_METHOD_HASH:
+			if (hash_param != NULL) {
+				return 1;
+			}
+			hash_param = &img_desc->img_auth_methods[i].param.hash;
+			break;
+		default:
+			return 1;
+		}
+	}
+
+	if (hash_param == NULL) {
+		return 1;
+	}
+
+	for (i = 0 ; i < COT_MAX_VERIFIED_PARAMS ; i++) {
+		if (img_desc->authenticated_data[i].type_desc != NULL) {
+			return 1;
+		}
+	}
+
+	/* Get the hash from the parent image */
+	rc = auth_get_param(hash_param->hash, img_desc->parent,
+			&hash_der_ptr, &hash_der_len);
+	return_if_error(rc);
+
+	rc = crypto_mod_verify_hash_init(hash_der_ptr, hash_der_len);
+	return_if_error(rc);
+
+	incremental_img_id = img_id;
+
+	return 0;
+}
+
+/*
+ * Hash the next piece of the image whose authentication has been started by
+ * auth_mod_verify_img_init()
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_verify_img_update(void *data_ptr, unsigned int data_len)
+{
+	if (incremental_img_id == INVALID_IMG_ID) {
+		return 1;
+	}
+
+	return crypto_mod_verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Complete the authentication of an image started by
+ * auth_mod_verify_img_init(). This must be called once the whole image has
+ * been passed to auth_mod_verify_img_update(), or to abort the authentication
+ * if the image could not be loaded.
+ *
+ * Return: 0 = success, Otherwise = error
+ */
+int auth_mod_verify_img_finish(unsigned int img_id)
+{
+	int rc;
+
+	if (incremental_img_id != img_id) {
+		return 1;
+	}
+
+	incremental_img_id = INVALID_IMG_ID;
+
+	rc = crypto_mod_verify_hash_finish();
+	return_if_error(rc);
+
+	rc = auth_measure_img(img_id);
+	return_if_error(rc);
+
+	/* Mark image as authenticated */
+	auth_img_flags[img_id] |= IMG_FLAG_AUTHENTICATED;
+
+	return 0;
+}
@@ -4,9 +4,13 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_AUTH
+
+#include <arch_helpers.h>
 #include <assert.h>
 #include <crypto_mod.h>
 #include <debug.h>
+#include <errno.h>
 
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 
@@ -38,6 +42,9 @@
  *     SignatureValue ::= BIT STRING
  */
 
+/* Hash engine registered by the platform, if any */
+static const crypto_hash_engine_t *hash_engine;
+
 /*
  * Perform some static checking and call the library initialization function
  */
@@ -102,3 +109,181 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
+
+/*
+ * Start the verification of a hash over data provided in several pieces
+ *
+ * Returns CRYPTO_ERR_UNKNOWN if the library does not support it, in which case
+ * crypto_mod_verify_hash() must be used instead.
+ *
+ * Parameters:
+ *
+ *   digest_info_ptr, digest_info_len: hash to be compared
+ */
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len)
+{
+	assert(digest_info_ptr != NULL);
+	assert(digest_info_len != 0);
+
+	if ((crypto_lib_desc.verify_hash_init == NULL) ||
+	    (crypto_lib_desc.verify_hash_update == NULL) ||
+	    (crypto_lib_desc.verify_hash_finish == NULL)) {
+		return CRYPTO_ERR_UNKNOWN;
+	}
+
+	return crypto_lib_desc.verify_hash_init(digest_info_ptr,
+						digest_info_len);
+}
+
+/*
+ * Add data to the hash started by crypto_mod_verify_hash_init()
+ *
+ * Parameters:
+ *
+ *   data_ptr, data_len: next piece of the data to be hashed
+ */
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+
+	return crypto_lib_desc.verify_hash_update(data_ptr, data_len);
+}
+
+/*
+ * Compare the hash of all the data provided since
+ * crypto_mod_verify_hash_init() with the expected hash
+ */
+int crypto_mod_verify_hash_finish(void)
+{
+	return crypto_lib_desc.verify_hash_finish();
+}
+
+/*
+ * Calculate a hash
+ *
+ * Returns CRYPTO_ERR_UNKNOWN if the library does not support it.
+ *
+ * Parameters:
+ *
+ *   alg: one of the CRYPTO_HASH_* algorithms
+ *   data_ptr, data_len: data to be hashed
+ *   output: resulting hash, large enough for the algorithm
+ */
+int crypto_mod_calc_hash(unsigned int alg, void *data_ptr,
+			 unsigned int data_len, unsigned char *output)
+{
+	assert(data_ptr != NULL);
+	assert(data_len != 0);
+	assert(output != NULL);
+
+	if (crypto_lib_desc.calc_hash == NULL) {
+		return CRYPTO_ERR_UNKNOWN;
+	}
+
+	return crypto_lib_desc.calc_hash(alg, data_ptr, data_len, output);
+}
+
+/*
+ * Register a hash engine to which the crypto library can offload hashes. The
+ * engine must have been initialised by its driver.
+ */
+void crypto_mod_register_hash_engine(const crypto_hash_engine_t *engine)
+{
+	assert(engine != NULL);
+	assert(engine->name != NULL);
+	assert(engine->start != NULL);
+	assert(engine->submit != NULL);
+	assert(engine->poll != NULL);
+	assert(engine->finish != NULL);
+
+	hash_engine = engine;
+	INFO("Using hash engine '%s'\n", engine->name);
+}
+
+/*
+ * Return the registered hash engine if it supports the given CRYPTO_HASH_*
+ * algorithm, NULL otherwise
+ */
+const crypto_hash_engine_t *crypto_mod_get_hash_engine(unsigned int alg)
+{
+	if ((hash_engine == NULL) || ((hash_engine->algs & alg) == 0U)) {
+		return NULL;
+	}
+
+	return hash_engine;
+}
+
+/*
+ * Queue data to be hashed by a hash engine, waiting for room in the queue if
+ * needed. The data is cleaned from the caches so that the engine can read it.
+ */
+int crypto_mod_hash_engine_submit(const crypto_hash_engine_t *engine,
+				  uintptr_t data, size_t len)
+{
+	int ret;
+
+	assert(engine != NULL);
+	assert(len != 0U);
+
+	clean_dcache_range(data, len);
+
+	for (;;) {
+		ret = engine->submit(data, len);
+		if (ret != -EBUSY) {
+			return ret;
+		}
+
+		/* Wait for the queue to drain */
+		ret = engine->poll();
+		if ((ret != 0) && (ret != -EBUSY)) {
+			return ret;
+		}
+	}
+}
+
+/*
+ * Wait for a hash engine to process all the queued data
+ */
+int crypto_mod_hash_engine_wait(const crypto_hash_engine_t *engine)
+{
+	int ret;
+
+	assert(engine != NULL);
+
+	do {
+		ret = engine->poll();
+	} while (ret == -EBUSY);
+
+	return ret;
+}
+
+/*
+ * Calculate the hash of a buffer with a hash engine and wait for the result
+ */
+int crypto_mod_hash_engine_calc(const crypto_hash_engine_t *engine,
+				unsigned int alg, uintptr_t data, size_t len,
+				void *digest, size_t digest_len)
+{
+	int ret;
+
+	assert(engine != NULL);
+
+	ret = engine->start(alg);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = crypto_mod_hash_engine_submit(engine, data, len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = crypto_mod_hash_engine_wait(engine);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return engine->finish(digest, digest_len);
+}
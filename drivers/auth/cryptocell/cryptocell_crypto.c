@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_AUTH
+
 #include <arch_helpers.h>
 #include <crypto_driver.h>
 #include <crypto_mod.h>
@@ -232,21 +234,16 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 }
 
 /*
- * Match a hash
- *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Parse a DigestInfo and return a pointer to the expected SHA256 hash
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   uint8_t **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	uint8_t *p, *end, *hash;
-	CCHashResult_t pubKeyHash;
+	uint8_t *p, *end;
 	size_t len;
 	int rc;
-	CCError_t error;
 
 	/* Digest info should be an MBEDTLS_ASN1_SEQUENCE */
 	p = digest_info_ptr;
@@ -277,13 +274,35 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	if (len != HASH_RESULT_SIZE_IN_BYTES)
 		return CRYPTO_ERR_HASH;
 
+	*hash = p;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	uint8_t *hash;
+	CCHashResult_t pubKeyHash;
+	int rc;
+	CCError_t error;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &hash);
+	if (rc != CRYPTO_SUCCESS)
+		return rc;
+
 	/*
 	 * CryptoCell utilises DMA internally to transfer data. Flush the data
 	 * from caches.
 	 */
 	flush_dcache_range((uintptr_t)data_ptr, data_len);
 
-	hash = p;
 	error = SBROM_CryptoHash((uintptr_t)PLAT_CRYPTOCELL_BASE,
 			(uintptr_t)data_ptr, data_len, pubKeyHash);
 	if (error != CC_OK)
@@ -296,9 +315,129 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * Context of the incremental hash verification. The CryptoCell SBROM library
+ * can only hash a buffer in one go, so the pieces of data must be contiguous
+ * in memory and are hashed by verify_hash_finish(). This still lets the hash
+ * engine run over the whole image in a single DMA transfer.
+ */
+static uint8_t expected_hash[HASH_RESULT_SIZE_IN_BYTES];
+static uintptr_t hash_data_base;
+static size_t hash_data_len;
+static int hash_ctx_active;
+
+/*
+ * Start matching a hash over data passed in several contiguous pieces
+ */
+static int verify_hash_init(void *digest_info_ptr,
+			    unsigned int digest_info_len)
+{
+	uint8_t *hash;
+	int rc;
+
+	hash_ctx_active = 0;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &hash);
+	if (rc != CRYPTO_SUCCESS)
+		return rc;
+
+	memcpy(expected_hash, hash, HASH_RESULT_SIZE_IN_BYTES);
+	hash_data_base = 0;
+	hash_data_len = 0;
+	hash_ctx_active = 1;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Record the next piece of data, which must follow the previous one in memory
+ */
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	if (hash_ctx_active == 0)
+		return CRYPTO_ERR_HASH;
+
+	if (hash_data_len == 0) {
+		hash_data_base = (uintptr_t)data_ptr;
+	} else if ((uintptr_t)data_ptr != hash_data_base + hash_data_len) {
+		hash_ctx_active = 0;
+		return CRYPTO_ERR_HASH;
+	}
+
+	hash_data_len += data_len;
+	if (hash_data_len > UINT32_MAX) {
+		hash_ctx_active = 0;
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Hash all the data and compare it with the expected hash
+ */
+static int verify_hash_finish(void)
+{
+	CCHashResult_t data_hash;
+	CCError_t error;
+	int rc;
+
+	rc = hash_ctx_active;
+	hash_ctx_active = 0;
+	if ((rc == 0) || (hash_data_len == 0))
+		return CRYPTO_ERR_HASH;
+
+	/*
+	 * CryptoCell utilises DMA internally to transfer data. Flush the data
+	 * from caches.
+	 */
+	flush_dcache_range(hash_data_base, hash_data_len);
+
+	error = SBROM_CryptoHash((uintptr_t)PLAT_CRYPTOCELL_BASE,
+			hash_data_base, (uint32_t)hash_data_len, data_hash);
+	if (error != CC_OK)
+		return CRYPTO_ERR_HASH;
+
+	rc = memcmp(data_hash, expected_hash, HASH_RESULT_SIZE_IN_BYTES);
+	if (rc != 0)
+		return CRYPTO_ERR_HASH;
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Calculate a hash. The CryptoCell only supports SHA256.
+ */
+static int calc_hash(unsigned int alg, void *data_ptr,
+		     unsigned int data_len, unsigned char *output)
+{
+	CCHashResult_t data_hash;
+	CCError_t error;
+
+	if (alg != CRYPTO_HASH_SHA256)
+		return CRYPTO_ERR_HASH;
+
+	/*
+	 * CryptoCell utilises DMA internally to transfer data. Flush the data
+	 * from caches.
+	 */
+	flush_dcache_range((uintptr_t)data_ptr, data_len);
+
+	error = SBROM_CryptoHash((uintptr_t)PLAT_CRYPTOCELL_BASE,
+			(uintptr_t)data_ptr, data_len, data_hash);
+	if (error != CC_OK)
+		return CRYPTO_ERR_HASH;
+
+	memcpy(output, data_hash, HASH_RESULT_SIZE_IN_BYTES);
+
+	return CRYPTO_SUCCESS;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_INCREMENTAL(LIB_NAME, init, verify_signature, verify_hash,
+				verify_hash_init, verify_hash_update,
+				verify_hash_finish, calc_hash);
 
 
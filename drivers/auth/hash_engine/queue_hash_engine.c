@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Reference driver for a hash engine fed through a ring of DMA descriptors.
+ *
+ * Software writes descriptors at the tail of the ring and advances QHE_QTAIL.
+ * The engine fetches the data of each descriptor, updates the hash and
+ * advances QHE_QHEAD. Once all the data has been processed, writing
+ * QHE_FINAL_START pads the message and the digest can be read from the
+ * QHE_DIGEST registers when QHE_STATUS_DONE is set.
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <crypto_mod.h>
+#include <errno.h>
+#include <mmio.h>
+#include <platform_def.h>
+#include <queue_hash_engine.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/* DMA descriptor as fetched by the engine */
+typedef struct qhe_desc {
+	uint64_t addr;
+	uint32_t len;
+	uint32_t reserved;
+} qhe_desc_t;
+
+static qhe_desc_t qhe_queue[QHE_QUEUE_DEPTH] __aligned(CACHE_WRITEBACK_GRANULE);
+static unsigned int qhe_tail;
+static uintptr_t qhe_base;
+
+static int qhe_start(unsigned int alg)
+{
+	uint32_t ctrl = QHE_CTRL_ENABLE | QHE_CTRL_RESET;
+
+	switch (alg) {
+	case CRYPTO_HASH_SHA256:
+		ctrl |= QHE_CTRL_ALG_SHA256;
+		break;
+	case CRYPTO_HASH_SHA384:
+		ctrl |= QHE_CTRL_ALG_SHA384;
+		break;
+	case CRYPTO_HASH_SHA512:
+		ctrl |= QHE_CTRL_ALG_SHA512;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if ((mmio_read_32(qhe_base + QHE_STATUS_OFF) & QHE_STATUS_BUSY) != 0U) {
+		return -EBUSY;
+	}
+
+	/* The reset clears the hash state and both ring indices */
+	mmio_write_32(qhe_base + QHE_CTRL_OFF, ctrl);
+	qhe_tail = 0U;
+
+	return 0;
+}
+
+static int qhe_submit(uintptr_t data, size_t len)
+{
+	unsigned int next = (qhe_tail + 1U) % QHE_QUEUE_DEPTH;
+	qhe_desc_t *desc = &qhe_queue[qhe_tail];
+
+	if (len > UINT32_MAX) {
+		return -EINVAL;
+	}
+
+	/* One descriptor is kept free to tell a full ring from an empty one */
+	if (next == mmio_read_32(qhe_base + QHE_QHEAD_OFF)) {
+		return -EBUSY;
+	}
+
+	desc->addr = (uint64_t)data;
+	desc->len = (uint32_t)len;
+	desc->reserved = 0U;
+	/* The cache maintenance completes with a DSB before the doorbell */
+	clean_dcache_range((uintptr_t)desc, sizeof(*desc));
+
+	qhe_tail = next;
+	mmio_write_32(qhe_base + QHE_QTAIL_OFF, qhe_tail);
+
+	return 0;
+}
+
+static int qhe_poll(void)
+{
+	uint32_t status = mmio_read_32(qhe_base + QHE_STATUS_OFF);
+
+	if ((status & QHE_STATUS_ERROR) != 0U) {
+		return -EIO;
+	}
+
+	if (mmio_read_32(qhe_base + QHE_QHEAD_OFF) != qhe_tail) {
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+static int qhe_finish(void *digest, size_t digest_len)
+{
+	uint8_t *out = digest;
+	uint32_t status, word;
+	size_t i;
+
+	assert((digest_len % sizeof(uint32_t)) == 0U);
+
+	if (digest_len > QHE_DIGEST_MAX_SIZE) {
+		return -EINVAL;
+	}
+
+	mmio_write_32(qhe_base + QHE_FINAL_OFF, QHE_FINAL_START);
+
+	do {
+		status = mmio_read_32(qhe_base + QHE_STATUS_OFF);
+		if ((status & QHE_STATUS_ERROR) != 0U) {
+			return -EIO;
+		}
+	} while ((status & QHE_STATUS_DONE) == 0U);
+
+	/* The digest registers hold the digest as big endian words */
+	for (i = 0U; i < digest_len; i += sizeof(uint32_t)) {
+		word = mmio_read_32(qhe_base + QHE_DIGEST_OFF + i);
+		out[i] = (uint8_t)(word >> 24);
+		out[i + 1U] = (uint8_t)(word >> 16);
+		out[i + 2U] = (uint8_t)(word >> 8);
+		out[i + 3U] = (uint8_t)word;
+	}
+
+	return 0;
+}
+
+static crypto_hash_engine_t qhe_engine = {
+	.name = "queue hash engine",
+	.start = qhe_start,
+	.submit = qhe_submit,
+	.poll = qhe_poll,
+	.finish = qhe_finish,
+};
+
+/*
+ * Initialise the engine at 'base' and register it to the crypto module.
+ * 'algs' is the bitmask of CRYPTO_HASH_* algorithms it implements.
+ */
+void queue_hash_engine_init(uintptr_t base, unsigned int algs)
+{
+	uint64_t queue = (uint64_t)(uintptr_t)qhe_queue;
+
+	assert(base != 0U);
+	assert(algs != 0U);
+
+	qhe_base = base;
+	qhe_engine.algs = algs;
+
+	mmio_write_32(qhe_base + QHE_CTRL_OFF, QHE_CTRL_RESET);
+	mmio_write_32(qhe_base + QHE_QBASE_LO_OFF, (uint32_t)queue);
+	mmio_write_32(qhe_base + QHE_QBASE_HI_OFF, (uint32_t)(queue >> 32));
+	mmio_write_32(qhe_base + QHE_QSIZE_OFF, QHE_QUEUE_DEPTH);
+	mmio_write_32(qhe_base + QHE_CTRL_OFF, QHE_CTRL_ENABLE);
+
+	crypto_mod_register_hash_engine(&qhe_engine);
+}
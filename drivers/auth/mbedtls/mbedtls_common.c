@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_AUTH
+
 #include <assert.h>
 #include <debug.h>
 /* mbed TLS headers */
@@ -13,6 +15,61 @@
 #include <mbedtls_config.h>
 #include <platform.h>
 #include <stddef.h>
+#include <string.h>
+#include <utils_def.h>
+
+#if TF_MBEDTLS_MEASURE_HEAP
+/*
+ * The unused part of the heap is filled with a pattern when it is set up. The
+ * allocator writes its metadata and zeroes every block it hands out, so the
+ * highest byte that no longer holds the pattern gives the peak extent of the
+ * heap, fragmentation included. The start of the heap is skipped as it holds
+ * the metadata of the initial free block.
+ */
+#define HEAP_FILL_PATTERN	0xA5U
+#define HEAP_FILL_OFFSET	128U
+
+/* Granularity of the recommended heap size */
+#define HEAP_SIZE_ROUND		1024U
+
+static unsigned char *heap_base;
+static size_t heap_len;
+static size_t heap_peak;
+
+static void heap_fill(void *heap_addr, size_t heap_size)
+{
+	heap_base = heap_addr;
+	heap_len = heap_size;
+	heap_peak = HEAP_FILL_OFFSET;
+
+	if (heap_size > HEAP_FILL_OFFSET) {
+		memset(heap_base + HEAP_FILL_OFFSET, HEAP_FILL_PATTERN,
+		       heap_size - HEAP_FILL_OFFSET);
+	}
+}
+
+/*
+ * Report the heap used by mbed TLS after the given operation and the heap size
+ * that would have been enough so far.
+ */
+void mbedtls_heap_report(const char *op)
+{
+	size_t prev_peak = heap_peak;
+	size_t i;
+
+	for (i = heap_len; i > heap_peak; i--) {
+		if (heap_base[i - 1U] != HEAP_FILL_PATTERN) {
+			break;
+		}
+	}
+	heap_peak = i;
+
+	NOTICE("mbed TLS heap: %zu/%zu bytes used after %s (+%zu)\n",
+	       heap_peak, heap_len, op, heap_peak - prev_peak);
+	NOTICE("mbed TLS heap: recommended TF_MBEDTLS_HEAP_SIZE %zu\n",
+	       round_up(heap_peak, HEAP_SIZE_ROUND));
+}
+#endif /* TF_MBEDTLS_MEASURE_HEAP */
 
 static void cleanup(void)
 {
@@ -45,6 +102,9 @@ void mbedtls_init(void)
 
 		/* Initialize the mbed TLS heap */
 		mbedtls_memory_buffer_alloc_init(heap_addr, heap_size);
+#if TF_MBEDTLS_MEASURE_HEAP
+		heap_fill(heap_addr, heap_size);
+#endif
 
 #ifdef MBEDTLS_PLATFORM_SNPRINTF_ALT
 		mbedtls_platform_set_snprintf(snprintf);
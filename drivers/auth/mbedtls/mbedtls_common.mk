@@ -55,6 +55,8 @@ LIBMBEDTLS_SRCS		:= $(addprefix ${MBEDTLS_DIR}/library/,	\
 ifeq (${TF_MBEDTLS_KEY_ALG},)
     ifeq (${KEY_ALG}, ecdsa)
         TF_MBEDTLS_KEY_ALG		:=	ecdsa
+    else ifeq (${KEY_ALG}, ecdsa_p384)
+        TF_MBEDTLS_KEY_ALG		:=	ecdsa_p384
     else
         TF_MBEDTLS_KEY_ALG		:=	rsa
     endif
@@ -70,6 +72,8 @@ endif
 
 ifeq (${TF_MBEDTLS_KEY_ALG},ecdsa)
     TF_MBEDTLS_KEY_ALG_ID	:=	TF_MBEDTLS_ECDSA
+else ifeq (${TF_MBEDTLS_KEY_ALG},ecdsa_p384)
+    TF_MBEDTLS_KEY_ALG_ID	:=	TF_MBEDTLS_ECDSA_P384
 else ifeq (${TF_MBEDTLS_KEY_ALG},rsa)
     TF_MBEDTLS_KEY_ALG_ID	:=	TF_MBEDTLS_RSA
 else ifeq (${TF_MBEDTLS_KEY_ALG},rsa+ecdsa)
@@ -78,9 +82,14 @@ else
     $(error "TF_MBEDTLS_KEY_ALG=${TF_MBEDTLS_KEY_ALG} not supported on mbed TLS")
 endif
 
+# Report the heap used by mbed TLS to help sizing TF_MBEDTLS_HEAP_SIZE
+TF_MBEDTLS_MEASURE_HEAP	?=	0
+$(eval $(call assert_boolean,TF_MBEDTLS_MEASURE_HEAP))
+
 # Needs to be set to drive mbed TLS configuration correctly
 $(eval $(call add_define,TF_MBEDTLS_KEY_ALG_ID))
 $(eval $(call add_define,TF_MBEDTLS_HASH_ALG_ID))
+$(eval $(call add_define,TF_MBEDTLS_MEASURE_HEAP))
 
 
 $(eval $(call MAKE_LIB,mbedtls))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -131,23 +131,53 @@ end1:
 	mbedtls_pk_free(&pk);
 end2:
 	mbedtls_free(sig_opts);
+	mbedtls_heap_report("signature verification");
 	return rc;
 }
 
 /*
- * Match a hash
- *
- * Digest info is passed in DER format following the ASN.1 structure detailed
- * above.
+ * Convert an mbed TLS hash type to the corresponding CRYPTO_HASH_* algorithm,
+ * or 0 if it cannot be offloaded
  */
-static int verify_hash(void *data_ptr, unsigned int data_len,
-		       void *digest_info_ptr, unsigned int digest_info_len)
+static unsigned int md_type_to_engine_alg(mbedtls_md_type_t md_alg)
+{
+	switch (md_alg) {
+	case MBEDTLS_MD_SHA256:
+		return CRYPTO_HASH_SHA256;
+	case MBEDTLS_MD_SHA384:
+		return CRYPTO_HASH_SHA384;
+	case MBEDTLS_MD_SHA512:
+		return CRYPTO_HASH_SHA512;
+	default:
+		return 0U;
+	}
+}
+
+/*
+ * Return the hash engine to use for the given hash algorithm, if any
+ */
+static const crypto_hash_engine_t *get_hash_engine(
+					const mbedtls_md_info_t *md_info)
+{
+	unsigned int alg = md_type_to_engine_alg(mbedtls_md_get_type(md_info));
+
+	if (alg == 0U) {
+		return NULL;
+	}
+
+	return crypto_mod_get_hash_engine(alg);
+}
+
+/*
+ * Parse a DigestInfo and return the hash algorithm and the expected hash
+ */
+static int get_digest_info(void *digest_info_ptr, unsigned int digest_info_len,
+			   const mbedtls_md_info_t **md_info,
+			   unsigned char **hash)
 {
 	mbedtls_asn1_buf hash_oid, params;
 	mbedtls_md_type_t md_alg;
-	const mbedtls_md_info_t *md_info;
-	unsigned char *p, *end, *hash;
-	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	unsigned char *p, *end;
 	size_t len;
 	int rc;
 
@@ -171,8 +201,8 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_HASH;
 	}
 
-	md_info = mbedtls_md_info_from_type(md_alg);
-	if (md_info == NULL) {
+	*md_info = mbedtls_md_info_from_type(md_alg);
+	if (*md_info == NULL) {
 		return CRYPTO_ERR_HASH;
 	}
 
@@ -183,14 +213,45 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Length of hash must match the algorithm's size */
-	if (len != mbedtls_md_get_size(md_info)) {
+	if (len != mbedtls_md_get_size(*md_info)) {
 		return CRYPTO_ERR_HASH;
 	}
-	hash = p;
+	*hash = p;
 
-	/* Calculate the hash of the data */
-	p = (unsigned char *)data_ptr;
-	rc = mbedtls_md(md_info, p, data_len, data_hash);
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Match a hash
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	const crypto_hash_engine_t *engine;
+	unsigned char *p, *hash;
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	/* Calculate the hash of the data, using the hash engine if possible */
+	engine = get_hash_engine(md_info);
+	if (engine != NULL) {
+		rc = crypto_mod_hash_engine_calc(engine,
+				md_type_to_engine_alg(mbedtls_md_get_type(md_info)),
+				(uintptr_t)data_ptr, data_len,
+				data_hash, mbedtls_md_get_size(md_info));
+	} else {
+		p = (unsigned char *)data_ptr;
+		rc = mbedtls_md(md_info, p, data_len, data_hash);
+	}
 	if (rc != 0) {
 		return CRYPTO_ERR_HASH;
 	}
@@ -204,7 +265,193 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 	return CRYPTO_SUCCESS;
 }
 
+/*
+ * Context of the incremental hash verification. Only one verification can be
+ * in progress at a time. If the hash is offloaded to a hash engine, hash_engine
+ * points to it and hash_ctx is not used.
+ */
+static mbedtls_md_context_t hash_ctx;
+static const crypto_hash_engine_t *hash_engine;
+static unsigned char expected_hash[MBEDTLS_MD_MAX_SIZE];
+static size_t expected_hash_len;
+static int hash_ctx_active;
+
+static void hash_ctx_release(void)
+{
+	if ((hash_ctx_active != 0) && (hash_engine == NULL)) {
+		mbedtls_md_free(&hash_ctx);
+	}
+
+	hash_engine = NULL;
+	hash_ctx_active = 0;
+}
+
+/*
+ * Start matching a hash over data passed in several pieces
+ *
+ * Digest info is passed in DER format following the ASN.1 structure detailed
+ * above. The expected hash is copied so that the digest info does not need to
+ * remain valid until verify_hash_finish() is called.
+ */
+static int verify_hash_init(void *digest_info_ptr,
+			    unsigned int digest_info_len)
+{
+	const mbedtls_md_info_t *md_info;
+	unsigned char *hash;
+	int rc;
+
+	hash_ctx_release();
+
+	rc = get_digest_info(digest_info_ptr, digest_info_len, &md_info, &hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	expected_hash_len = mbedtls_md_get_size(md_info);
+	memcpy(expected_hash, hash, expected_hash_len);
+
+	hash_engine = get_hash_engine(md_info);
+	if (hash_engine != NULL) {
+		rc = hash_engine->start(
+			md_type_to_engine_alg(mbedtls_md_get_type(md_info)));
+		if (rc != 0) {
+			hash_engine = NULL;
+			return CRYPTO_ERR_HASH;
+		}
+
+		hash_ctx_active = 1;
+		return CRYPTO_SUCCESS;
+	}
+
+	mbedtls_md_init(&hash_ctx);
+	hash_ctx_active = 1;
+
+	rc = mbedtls_md_setup(&hash_ctx, md_info, 0);
+	if (rc == 0) {
+		rc = mbedtls_md_starts(&hash_ctx);
+	}
+	if (rc != 0) {
+		hash_ctx_release();
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Hash the next piece of data. When a hash engine is used, this returns as soon
+ * as the data is queued, so that the caller can load the next piece while the
+ * engine processes this one.
+ */
+static int verify_hash_update(void *data_ptr, unsigned int data_len)
+{
+	int rc;
+
+	if (hash_ctx_active == 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (hash_engine != NULL) {
+		rc = crypto_mod_hash_engine_submit(hash_engine,
+						   (uintptr_t)data_ptr,
+						   data_len);
+	} else {
+		rc = mbedtls_md_update(&hash_ctx, (unsigned char *)data_ptr,
+				       data_len);
+	}
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Compare the hash of all the data with the expected hash and release the
+ * context
+ */
+static int verify_hash_finish(void)
+{
+	unsigned char data_hash[MBEDTLS_MD_MAX_SIZE];
+	int rc;
+
+	if (hash_ctx_active == 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	if (hash_engine != NULL) {
+		rc = crypto_mod_hash_engine_wait(hash_engine);
+		if (rc == 0) {
+			rc = hash_engine->finish(data_hash, expected_hash_len);
+		}
+	} else {
+		rc = mbedtls_md_finish(&hash_ctx, data_hash);
+	}
+
+	hash_ctx_release();
+	mbedtls_heap_report("hash verification");
+
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	/* Compare values */
+	rc = memcmp(data_hash, expected_hash, expected_hash_len);
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * Calculate a hash, using the hash engine if possible
+ */
+static int calc_hash(unsigned int alg, void *data_ptr,
+		     unsigned int data_len, unsigned char *output)
+{
+	const mbedtls_md_info_t *md_info;
+	const crypto_hash_engine_t *engine;
+	mbedtls_md_type_t md_alg;
+	int rc;
+
+	switch (alg) {
+	case CRYPTO_HASH_SHA256:
+		md_alg = MBEDTLS_MD_SHA256;
+		break;
+	case CRYPTO_HASH_SHA384:
+		md_alg = MBEDTLS_MD_SHA384;
+		break;
+	case CRYPTO_HASH_SHA512:
+		md_alg = MBEDTLS_MD_SHA512;
+		break;
+	default:
+		return CRYPTO_ERR_HASH;
+	}
+
+	md_info = mbedtls_md_info_from_type(md_alg);
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	engine = crypto_mod_get_hash_engine(alg);
+	if (engine != NULL) {
+		rc = crypto_mod_hash_engine_calc(engine, alg,
+				(uintptr_t)data_ptr, data_len,
+				output, mbedtls_md_get_size(md_info));
+	} else {
+		rc = mbedtls_md(md_info, data_ptr, data_len, output);
+	}
+	if (rc != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash);
+REGISTER_CRYPTO_LIB_INCREMENTAL(LIB_NAME, init, verify_signature, verify_hash,
+				verify_hash_init, verify_hash_update,
+				verify_hash_finish, calc_hash);
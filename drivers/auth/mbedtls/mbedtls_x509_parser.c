@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,6 +16,7 @@
 #include <assert.h>
 #include <img_parser_mod.h>
 #include <mbedtls_common.h>
+#include <platform_def.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -31,6 +32,18 @@
 
 #define LIB_NAME	"mbed TLS X509v3"
 
+/* Number of extensions indexed during the integrity check */
+#ifndef MAX_CERT_EXTENSIONS
+#define MAX_CERT_EXTENSIONS		8
+#endif
+
+/* Extension located during the integrity check */
+typedef struct cert_ext_s {
+	char oid[MAX_OID_STR_LEN];
+	void *data;
+	unsigned int len;
+} cert_ext_t;
+
 /* Temporary variables to speed up the authentication parameters search. These
  * variables are assigned once during the integrity check and used any time an
  * authentication parameter is requested, so we do not have to parse the image
@@ -40,6 +53,9 @@ static mbedtls_asn1_buf v3_ext;
 static mbedtls_asn1_buf pk;
 static mbedtls_asn1_buf sig_alg;
 static mbedtls_asn1_buf signature;
+static cert_ext_t cert_exts[MAX_CERT_EXTENSIONS];
+static unsigned int cert_ext_count;
+static int cert_ext_overflow;
 
 /*
  * Clear all static temporary variables.
@@ -57,18 +73,51 @@ static void clear_temp_vars(void)
 	ZERO_AND_CLEAN(pk);
 	ZERO_AND_CLEAN(sig_alg);
 	ZERO_AND_CLEAN(signature);
+	ZERO_AND_CLEAN(cert_exts);
+	ZERO_AND_CLEAN(cert_ext_count);
+	ZERO_AND_CLEAN(cert_ext_overflow);
 
 #undef ZERO_AND_CLEAN
 }
 
 /*
- * Get X509v3 extension
+ * Record an extension found during the integrity check so that it can be
+ * retrieved later without walking the extensions again. If the table is full,
+ * get_ext() falls back to walking the extensions.
+ */
+static void index_ext(mbedtls_asn1_buf *extn_oid, unsigned char *data,
+		      size_t len)
+{
+	cert_ext_t *cert_ext;
+	int oid_len;
+
+	if (cert_ext_count == MAX_CERT_EXTENSIONS) {
+		cert_ext_overflow = 1;
+		return;
+	}
+
+	cert_ext = &cert_exts[cert_ext_count];
+	oid_len = mbedtls_oid_get_numeric_string(cert_ext->oid,
+						 MAX_OID_STR_LEN, extn_oid);
+	if ((oid_len < 0) || (oid_len != strlen(cert_ext->oid))) {
+		/* An OID that can't be requested, don't index it */
+		cert_ext_overflow = 1;
+		return;
+	}
+
+	cert_ext->data = (void *)data;
+	cert_ext->len = (unsigned int)len;
+	cert_ext_count++;
+}
+
+/*
+ * Walk the X509v3 extensions to find one that has not been indexed
  *
  * Global variable 'v3_ext' must point to the extensions region
  * in the certificate. No need to check for errors since the image has passed
  * the integrity check.
  */
-static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+static int walk_ext(const char *oid, void **ext, unsigned int *ext_len)
 {
 	int oid_len;
 	size_t len;
@@ -129,6 +178,30 @@ static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
 	return IMG_PARSER_ERR_NOT_FOUND;
 }
 
+/*
+ * Get X509v3 extension
+ */
+static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+{
+	unsigned int i;
+
+	assert(oid != NULL);
+
+	for (i = 0U; i < cert_ext_count; i++) {
+		if (strcmp(oid, cert_exts[i].oid) == 0) {
+			*ext = cert_exts[i].data;
+			*ext_len = cert_exts[i].len;
+			return IMG_PARSER_OK;
+		}
+	}
+
+	if (cert_ext_overflow != 0) {
+		return walk_ext(oid, ext, ext_len);
+	}
+
+	return IMG_PARSER_ERR_NOT_FOUND;
+}
+
 
 /*
  * Check the integrity of the certificate ASN.1 structure.
@@ -144,7 +217,7 @@ static int cert_parse(void *img, unsigned int img_len)
 	int ret, is_critical;
 	size_t len;
 	unsigned char *p, *end, *crt_end;
-	mbedtls_asn1_buf sig_alg1, sig_alg2;
+	mbedtls_asn1_buf sig_alg1, sig_alg2, extn_oid;
 
 	p = (unsigned char *)img;
 	len = img_len;
@@ -309,8 +382,10 @@ static int cert_parse(void *img, unsigned int img_len)
 	v3_ext.len = (p + len) - v3_ext.p;
 
 	/*
-	 * Check extensions integrity
+	 * Check extensions integrity and index them
 	 */
+	cert_ext_count = 0U;
+	cert_ext_overflow = 0;
 	while (p < end) {
 		ret = mbedtls_asn1_get_tag(&p, end, &len,
 					   MBEDTLS_ASN1_CONSTRUCTED |
@@ -320,11 +395,14 @@ static int cert_parse(void *img, unsigned int img_len)
 		}
 
 		/* Get extension ID */
-		ret = mbedtls_asn1_get_tag(&p, end, &len, MBEDTLS_ASN1_OID);
+		ret = mbedtls_asn1_get_tag(&p, end, &extn_oid.len,
+					   MBEDTLS_ASN1_OID);
 		if (ret != 0) {
 			return IMG_PARSER_ERR_FORMAT;
 		}
-		p += len;
+		extn_oid.tag = MBEDTLS_ASN1_OID;
+		extn_oid.p = p;
+		p += extn_oid.len;
 
 		/* Get optional critical */
 		ret = mbedtls_asn1_get_bool(&p, end, &is_critical);
@@ -338,6 +416,7 @@ static int cert_parse(void *img, unsigned int img_len)
 		if (ret != 0) {
 			return IMG_PARSER_ERR_FORMAT;
 		}
+		index_ext(&extn_oid, p, len);
 		p += len;
 	}
 
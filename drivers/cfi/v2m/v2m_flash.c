@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <mmio.h>
 #include <v2m_flash.h>
@@ -22,6 +23,7 @@
  * model
  */
 #define DWS_WORD_PROGRAM_RETRIES	1000
+#define DWS_BUFFER_PROGRAM_RETRIES	(DWS_WORD_PROGRAM_RETRIES * NOR_BUFFER_WORDS)
 #define DWS_WORD_ERASE_RETRIES		3000000
 #define DWS_WORD_LOCK_RETRIES		1000
 
@@ -125,6 +127,83 @@ int nor_word_program(uintptr_t base_addr, unsigned long data)
 	return ret;
 }
 
+/*
+ * Program up to one write buffer with the write to buffer command. The words
+ * must not cross a NOR_BUFFER_SIZE boundary.
+ */
+static int nor_program_buffer(uintptr_t base_addr, const uint32_t *data,
+			      size_t nwords)
+{
+	unsigned long retries = DWS_WORD_PROGRAM_RETRIES;
+	uint32_t status;
+	size_t i;
+	int ret;
+
+	nor_send_cmd(base_addr, NOR_CMD_CLEAR_STATUS_REG);
+
+	/* Wait for a write buffer to be available */
+	do {
+		nor_send_cmd(base_addr, NOR_CMD_WRITE_TO_BUFFER);
+		status = mmio_read_32(base_addr);
+		if ((status & NOR_CMD_END) == NOR_CMD_END)
+			break;
+	} while (retries-- > 0);
+
+	if ((status & NOR_CMD_END) != NOR_CMD_END) {
+		nor_send_cmd(base_addr, NOR_CMD_READ_ARRAY);
+		return -EBUSY;
+	}
+
+	/* Word count minus one, then the data, then the confirm command */
+	nor_send_cmd(base_addr, nwords - 1);
+	for (i = 0; i < nwords; i++)
+		mmio_write_32(base_addr + (i << 2), data[i]);
+	nor_send_cmd(base_addr, NOR_CMD_BUFFERED_PROGRAM_ACK);
+
+	ret = nor_poll_dws(base_addr, DWS_BUFFER_PROGRAM_RETRIES);
+	if (ret == 0)
+		ret = nor_full_status_check(base_addr);
+	nor_send_cmd(base_addr, NOR_CMD_READ_ARRAY);
+
+	return ret;
+}
+
+/*
+ * This function programs nwords words in the flash, using the write buffer
+ * to program up to NOR_BUFFER_WORDS words per status poll instead of one.
+ * As with nor_word_program, it can only reset bits that were previously set.
+ * Return values:
+ *  0 = success
+ *  otherwise it returns a negative value
+ */
+int nor_buffered_program(uintptr_t base_addr, const uint32_t *data,
+			 size_t nwords)
+{
+	size_t n;
+	int ret;
+
+	assert((base_addr & 3U) == 0U);
+	assert(data != NULL);
+
+	while (nwords > 0U) {
+		/* Stop at the end of the current write buffer */
+		n = NOR_BUFFER_WORDS -
+			((base_addr & (NOR_BUFFER_SIZE - 1U)) >> 2);
+		if (n > nwords)
+			n = nwords;
+
+		ret = nor_program_buffer(base_addr, data, n);
+		if (ret != 0)
+			return ret;
+
+		base_addr += n << 2;
+		data += n;
+		nwords -= n;
+	}
+
+	return 0;
+}
+
 /*
  * Erase a full 256K block
  * Return values:
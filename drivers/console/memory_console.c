@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <memory_console.h>
+#include <platform.h>
+#include <string.h>
+
+#if !MULTI_CONSOLE_API
+#error "The memory console requires MULTI_CONSOLE_API=1"
+#endif
+
+/*
+ * Memory console. Each CPU writes its log to its own ring, so no lock is
+ * needed and writing a character never waits on a device. The oldest
+ * characters of a ring are overwritten when it is full.
+ *
+ * The ring of a CPU is drained to the deferred consoles (see
+ * CONSOLE_FLAG_DEFERRED) when that CPU calls console_flush(). Without any
+ * deferred console, the log is only kept in memory.
+ */
+
+int console_register(console_t *console);
+
+static char *console_mem_ring_buf(console_mem_t *mem, unsigned int cpu)
+{
+	return (char *)(mem->base + (cpu * mem->ring_size));
+}
+
+static int console_mem_putc(int c, console_t *console)
+{
+	console_mem_t *mem = (console_mem_t *)console;
+	unsigned int cpu = plat_my_core_pos();
+	console_mem_ring_t *ring = &mem->ring[cpu];
+
+	console_mem_ring_buf(mem, cpu)[ring->head % mem->ring_size] = (char)c;
+	ring->head++;
+
+	return c;
+}
+
+static int console_mem_getc(console_t *console)
+{
+	/* There is no input on a memory console */
+	return ERROR_NO_VALID_CONSOLE;
+}
+
+/* Drain the ring of the current CPU to the deferred consoles */
+static int console_mem_flush(console_t *console)
+{
+	console_mem_t *mem = (console_mem_t *)console;
+	unsigned int cpu = plat_my_core_pos();
+	console_mem_ring_t *ring = &mem->ring[cpu];
+	const char *buf = console_mem_ring_buf(mem, cpu);
+	size_t head = ring->head;
+	size_t i = ring->tail;
+
+	/* Skip the characters that have been overwritten */
+	if ((head - i) > mem->ring_size)
+		i = head - mem->ring_size;
+
+	for (; i != head; i++)
+		(void)console_deferred_putc(buf[i % mem->ring_size]);
+
+	ring->tail = head;
+
+	return 0;
+}
+
+int console_mem_register(uintptr_t base, size_t size,
+			 console_mem_t *console)
+{
+	console_t mem_console = {
+		.putc = console_mem_putc,
+		.getc = console_mem_getc,
+		.flush = console_mem_flush,
+		.flags = CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME,
+	};
+
+	assert(console != NULL);
+
+	if ((base == 0U) || ((size / PLATFORM_CORE_COUNT) == 0U))
+		return 0;
+
+	(void)memcpy(&console->console, &mem_console, sizeof(mem_console));
+	console->base = base;
+	console->ring_size = size / PLATFORM_CORE_COUNT;
+	(void)memset(console->ring, 0, sizeof(console->ring));
+
+	return console_register(&console->console);
+}
@@ -69,13 +69,18 @@ void console_set_scope(console_t *console, unsigned int scope)
 	console->flags = (console->flags & ~CONSOLE_FLAG_SCOPE_MASK) | scope;
 }
 
-int console_putc(int c)
+/*
+ * Output a character on the consoles registered for the current state whose
+ * flags masked by `mask` are `flags`.
+ */
+static int console_putc_flags(int c, unsigned int mask, unsigned int flags)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
 
 	for (console = console_list; console != NULL; console = console->next)
-		if (console->flags & console_state) {
+		if ((console->flags & console_state) &&
+		    ((console->flags & mask) == flags)) {
 			int ret = console->putc(c, console);
 			if ((err == ERROR_NO_VALID_CONSOLE) || (ret < err))
 				err = ret;
@@ -84,6 +89,21 @@ int console_putc(int c)
 	return err;
 }
 
+int console_putc(int c)
+{
+	/* Deferred consoles are only written directly in crash state */
+	if (console_state == CONSOLE_FLAG_CRASH)
+		return console_putc_flags(c, 0U, 0U);
+
+	return console_putc_flags(c, CONSOLE_FLAG_DEFERRED, 0U);
+}
+
+int console_deferred_putc(int c)
+{
+	return console_putc_flags(c, CONSOLE_FLAG_DEFERRED,
+				  CONSOLE_FLAG_DEFERRED);
+}
+
 int console_getc(void)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
@@ -104,13 +124,18 @@ int console_getc(void)
 	return err;
 }
 
-int console_flush(void)
+/*
+ * Flush the consoles registered for the current state whose flags masked by
+ * `mask` are `flags`.
+ */
+static int console_flush_flags(unsigned int mask, unsigned int flags)
 {
 	int err = ERROR_NO_VALID_CONSOLE;
 	console_t *console;
 
 	for (console = console_list; console != NULL; console = console->next)
-		if (console->flags & console_state) {
+		if ((console->flags & console_state) &&
+		    ((console->flags & mask) == flags)) {
 			int ret = console->flush(console);
 			if ((err == ERROR_NO_VALID_CONSOLE) || (ret < err))
 				err = ret;
@@ -119,4 +144,23 @@ int console_flush(void)
 	return err;
 }
 
+int console_flush(void)
+{
+	int err, ret;
+
+	/*
+	 * Flush the deferred consoles last, once the memory consoles have
+	 * been drained to them.
+	 */
+	err = console_flush_flags(CONSOLE_FLAG_DEFERRED, 0U);
+	ret = console_flush_flags(CONSOLE_FLAG_DEFERRED,
+				  CONSOLE_FLAG_DEFERRED);
+
+	if ((err == ERROR_NO_VALID_CONSOLE) ||
+	    ((ret != ERROR_NO_VALID_CONSOLE) && (ret < err)))
+		err = ret;
+
+	return err;
+}
+
 #endif	/* MULTI_CONSOLE_API */
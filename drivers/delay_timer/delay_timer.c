@@ -25,23 +25,29 @@ void udelay(uint32_t usec)
 		(timer_ops->clk_div != 0U) &&
 		(timer_ops->get_timer_value != NULL));
 
+	uint32_t (*get_timer_value)(void) = timer_ops->get_timer_value;
 	uint32_t start, delta, total_delta;
+	uint64_t ticks;
 
-	assert(usec < (UINT32_MAX / timer_ops->clk_div));
+	start = get_timer_value();
 
-	start = timer_ops->get_timer_value();
+	/*
+	 * Compute the number of ticks to wait once, in 64-bit so that the
+	 * product does not overflow for long delays.
+	 */
+	ticks = div_round_up((uint64_t)usec * timer_ops->clk_div,
+			     (uint64_t)timer_ops->clk_mult);
+	assert(ticks < UINT32_MAX);
 
 	/* Add an extra tick to avoid delaying less than requested. */
-	total_delta =
-		div_round_up(usec * timer_ops->clk_div,
-						timer_ops->clk_mult) + 1U;
+	total_delta = (uint32_t)ticks + 1U;
 
 	do {
 		/*
 		 * If the timer value wraps around, the subtraction will
 		 * overflow and it will still give the correct result.
 		 */
-		delta = start - timer_ops->get_timer_value(); /* Decreasing counter */
+		delta = start - get_timer_value(); /* Decreasing counter */
 
 	} while (delta < total_delta);
 }
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <dma.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <string.h>
+#include <utils_def.h>
+
+static const dma_ops_t *dma_ops;
+
+/* Destination of the copy in progress, if dma_len isn't 0 */
+static uintptr_t dma_dst;
+static size_t dma_len;
+
+/*
+ * Start copying `len` bytes from `src` to `dst` with the DMA engine and
+ * return without waiting. Both addresses and `len` must be aligned to the
+ * alignment of the engine, and `len` must not exceed its largest copy. Return
+ * 0 on success, -ENODEV if there is no engine, -EINVAL if it can't do the
+ * copy, -EBUSY if a copy is already in progress or another negative error
+ * code from the engine. The destination must not be accessed until
+ * dma_copy_wait() has returned.
+ */
+int dma_copy_start(uintptr_t dst, uintptr_t src, size_t len)
+{
+	int ret;
+
+	if (dma_ops == NULL)
+		return -ENODEV;
+
+	if ((len == 0U) || (len > dma_ops->max_len) ||
+	    (((dst | src | len) & (dma_ops->align - 1U)) != 0U))
+		return -EINVAL;
+
+	if (dma_len != 0U)
+		return -EBUSY;
+
+	/* Whole cache lines are written, so dirty lines can be discarded */
+	clean_dcache_range(src, len);
+	inv_dcache_range(dst, len);
+
+	ret = dma_ops->submit(dst, src, len);
+	if (ret == 0) {
+		dma_dst = dst;
+		dma_len = len;
+	}
+
+	return ret;
+}
+
+/*
+ * Wait for the copy started by dma_copy_start() to complete. Return 0 on
+ * success or the error code of the engine.
+ */
+int dma_copy_wait(void)
+{
+	int ret;
+
+	if (dma_len == 0U)
+		return 0;
+
+	do {
+		ret = dma_ops->poll();
+	} while (ret == -EBUSY);
+
+	/* Discard the lines speculatively fetched during the copy */
+	inv_dcache_range(dma_dst, dma_len);
+	dma_len = 0U;
+
+	return ret;
+}
+
+/*
+ * Copy `len` bytes from `src` to `dst` and wait for the copy to complete. The
+ * aligned part of the copy is done by the DMA engine, in as many transfers as
+ * needed, and the rest with memcpy(). Everything is copied with memcpy() if
+ * there is no engine or if it can't access the buffers. Return 0 on success
+ * or the error code of the engine.
+ */
+int dma_copy(uintptr_t dst, uintptr_t src, size_t len)
+{
+	size_t chunk;
+	int ret;
+
+	if ((dma_ops != NULL) &&
+	    (((dst | src) & (dma_ops->align - 1U)) == 0U)) {
+		while (len >= dma_ops->align) {
+			chunk = MIN(round_down(len, dma_ops->align),
+				    dma_ops->max_len);
+
+			ret = dma_copy_start(dst, src, chunk);
+			if (ret == -EINVAL)
+				break;
+			if (ret == 0)
+				ret = dma_copy_wait();
+			if (ret != 0)
+				return ret;
+
+			dst += chunk;
+			src += chunk;
+			len -= chunk;
+		}
+	}
+
+	(void)memcpy((void *)dst, (const void *)src, len);
+
+	return 0;
+}
+
+/*
+ * Register the operations of the DMA engine of the platform. The engine must
+ * have been initialised by its driver.
+ */
+void dma_init(const dma_ops_t *ops_ptr)
+{
+	assert(ops_ptr != NULL);
+	assert(ops_ptr->submit != NULL);
+	assert(ops_ptr->poll != NULL);
+	assert((ops_ptr->align != 0U) && IS_POWER_OF_TWO(ops_ptr->align) &&
+	       ((ops_ptr->align % CACHE_WRITEBACK_GRANULE) == 0U));
+	assert((ops_ptr->max_len != 0U) &&
+	       ((ops_ptr->max_len % ops_ptr->align) == 0U));
+
+	dma_ops = ops_ptr;
+}
@@ -13,6 +13,7 @@
 #include <mmc.h>
 #include <errno.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <string.h>
 
 static void imx_usdhc_initialize(void);
@@ -103,14 +104,15 @@ static void imx_usdhc_initialize(void)
 	mmio_clrsetbits32(reg_base + WATERMARKLEV, WMKLV_MASK, 16 | (16 << 16));
 }
 
-#define FSL_CMD_RETRIES	1000
+#define FSL_CMD_TIMEOUT_US	1000
 
 static int imx_usdhc_send_cmd(struct mmc_cmd *cmd)
 {
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
 	unsigned int xfertype = 0, mixctl = 0, multiple = 0, data = 0, err = 0;
 	unsigned int state, flags = INTSTATEN_CC | INTSTATEN_CTOE;
-	unsigned int cmd_retries = 0;
+	uint64_t timeout;
+	bool timed_out = false;
 
 	assert(cmd);
 
@@ -181,14 +183,19 @@ static int imx_usdhc_send_cmd(struct mmc_cmd *cmd)
 	mmio_write_32(reg_base + XFERTYPE, xfertype);
 
 	/* Wait for the command done */
-	do {
+	timeout = timeout_init_us(FSL_CMD_TIMEOUT_US);
+	for (;;) {
 		state = mmio_read_32(reg_base + INTSTAT);
-		if (cmd_retries)
-			udelay(1);
-	} while ((!(state & flags)) && ++cmd_retries < FSL_CMD_RETRIES);
+		if (state & flags)
+			break;
+		if (timeout_elapsed(timeout)) {
+			timed_out = true;
+			break;
+		}
+	}
 
-	if ((state & (INTSTATEN_CTOE | CMD_ERR)) || cmd_retries == FSL_CMD_RETRIES) {
-		if (cmd_retries == FSL_CMD_RETRIES)
+	if ((state & (INTSTATEN_CTOE | CMD_ERR)) || timed_out) {
+		if (timed_out)
 			err = -ETIMEDOUT;
 		else
 			err = -EIO;
@@ -5,10 +5,12 @@
  */
 
 #include <assert.h>
+#include <cassert.h>
 #include <debug.h>
 #include <errno.h>
 #include <io_block.h>
 #include <io_driver.h>
+#include <io_pool.h>
 #include <io_storage.h>
 #include <platform_def.h>
 #include <string.h>
@@ -52,69 +54,215 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.dev_close	= block_dev_close,
 };
 
-static block_dev_state_t state_pool[MAX_IO_BLOCK_DEVICES];
+static block_dev_state_t state_store[MAX_IO_BLOCK_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_IO_BLOCK_DEVICES];
 
-/* Track number of allocated block state */
-static unsigned int block_dev_count;
+/* Allocated block states, the device info of a state has the same index */
+static IO_POOL_ARRAY(state_pool, state_store);
 
-io_type_t device_type_block(void)
+CASSERT(MAX_IO_BLOCK_DEVICES <= IO_POOL_MAX_OBJECTS,
+	assert_max_io_block_devices);
+
+#if IO_BLOCK_CACHE_LINES
+/*
+ * Read cache of IO_BLOCK_CACHE_LINES lines of CACHE_LINE_SIZE bytes, shared by
+ * all the block devices. It serves the small and unaligned reads, the large
+ * aligned reads go straight to the device. A miss on the line following the
+ * last line accessed fills up to CACHE_READ_AHEAD lines in a single device
+ * read. Lines are evicted in least recently used order. A write to a device
+ * invalidates its lines.
+ */
+#define CACHE_LINE_SIZE		U(0x1000)
+#define CACHE_READ_AHEAD	4U
+
+typedef struct {
+	/* Device of the line, NULL if the line is invalid */
+	const io_block_dev_spec_t	*dev_spec;
+	/* Address of the line on the device, and number of valid bytes */
+	size_t				addr;
+	size_t				len;
+	unsigned int			last_use;
+} cache_tag_t;
+
+static cache_tag_t cache_tags[IO_BLOCK_CACHE_LINES];
+static uint8_t cache_data[IO_BLOCK_CACHE_LINES][CACHE_LINE_SIZE];
+static unsigned int cache_clock;
+
+/* Line following the last line accessed, to detect sequential reads */
+static const io_block_dev_spec_t *cache_next_dev;
+static size_t cache_next_addr;
+
+static void cache_invalidate(const io_block_dev_spec_t *dev_spec)
 {
-	return IO_TYPE_BLOCK;
+	unsigned int i;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if (cache_tags[i].dev_spec == dev_spec)
+			cache_tags[i].dev_spec = NULL;
+	}
+	if (cache_next_dev == dev_spec)
+		cache_next_dev = NULL;
 }
 
-/* Locate a block state in the pool, specified by address */
-static int find_first_block_state(const io_block_dev_spec_t *dev_spec,
-				  unsigned int *index_out)
+static int cache_lookup(const io_block_dev_spec_t *dev_spec, size_t addr)
 {
-	int result = -ENOENT;
-	for (int index = 0; index < MAX_IO_BLOCK_DEVICES; ++index) {
-		/* dev_spec is used as identifier since it's unique */
-		if (state_pool[index].dev_spec == dev_spec) {
-			result = 0;
-			*index_out = index;
-			break;
-		}
+	unsigned int i;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if ((cache_tags[i].dev_spec == dev_spec) &&
+		    (cache_tags[i].addr == addr))
+			return (int)i;
 	}
-	return result;
+	return -1;
+}
+
+/* Return the line to replace: an invalid line, else the least recently used */
+static unsigned int cache_victim(void)
+{
+	unsigned int i, victim = 0U;
+
+	for (i = 0U; i < IO_BLOCK_CACHE_LINES; i++) {
+		if (cache_tags[i].dev_spec == NULL)
+			return i;
+		if ((cache_clock - cache_tags[i].last_use) >
+		    (cache_clock - cache_tags[victim].last_use))
+			victim = i;
+	}
+	return victim;
+}
+
+/*
+ * Read `num` lines from `addr` through the underlying buffer of the device and
+ * copy them to the cache. Return the index of the line at `addr`, or -1 if it
+ * couldn't be read.
+ */
+static int cache_fill(const io_block_dev_spec_t *dev_spec, size_t addr,
+		      unsigned int num)
+{
+	const io_block_spec_t *buf = &dev_spec->buffer;
+	size_t request, nbytes, len;
+	unsigned int i, line;
+	int first = -1, hit;
+
+	if (num > (buf->length / CACHE_LINE_SIZE))
+		num = buf->length / CACHE_LINE_SIZE;
+	if (num == 0U)
+		return -1;
+
+	request = num * CACHE_LINE_SIZE;
+	nbytes = dev_spec->ops.read((int)(addr / dev_spec->block_size),
+				    buf->offset, request);
+	if (nbytes > request)
+		nbytes = request;
+
+	for (i = 0U; (i * CACHE_LINE_SIZE) < nbytes; i++) {
+		len = nbytes - (i * CACHE_LINE_SIZE);
+		if (len > CACHE_LINE_SIZE)
+			len = CACHE_LINE_SIZE;
+
+		/* Don't evict a line already holding this data */
+		hit = cache_lookup(dev_spec, addr + (i * CACHE_LINE_SIZE));
+		line = (hit >= 0) ? (unsigned int)hit : cache_victim();
+
+		memcpy(cache_data[line],
+		       (void *)(buf->offset + (i * CACHE_LINE_SIZE)), len);
+		cache_tags[line].dev_spec = dev_spec;
+		cache_tags[line].addr = addr + (i * CACHE_LINE_SIZE);
+		cache_tags[line].len = len;
+		cache_tags[line].last_use = cache_clock++;
+		if (i == 0U)
+			first = (int)line;
+	}
+
+	return first;
+}
+
+/*
+ * Copy up to `left` bytes at the current position of `cur` to `buffer`, from
+ * the line holding the current position. Return the number of bytes copied,
+ * 0 if the read must go through the device.
+ */
+static size_t cache_read(block_dev_state_t *cur, uintptr_t buffer,
+			 size_t left)
+{
+	const io_block_dev_spec_t *dev_spec = cur->dev_spec;
+	size_t addr, line_addr, off, nbytes;
+	unsigned int num;
+	int line;
+
+	if ((CACHE_LINE_SIZE % dev_spec->block_size) != 0U)
+		return 0;
+
+	addr = cur->base + cur->file_pos;
+	line_addr = addr & ~((size_t)CACHE_LINE_SIZE - 1U);
+	off = addr - line_addr;
+
+	line = cache_lookup(dev_spec, line_addr);
+	if (line < 0) {
+		num = ((dev_spec == cache_next_dev) &&
+		       (line_addr == cache_next_addr)) ? CACHE_READ_AHEAD : 1U;
+		line = cache_fill(dev_spec, line_addr, num);
+		if (line < 0)
+			return 0;
+	}
+
+	cache_next_dev = dev_spec;
+	cache_next_addr = line_addr + CACHE_LINE_SIZE;
+
+	if (off >= cache_tags[line].len)
+		return 0;
+
+	nbytes = cache_tags[line].len - off;
+	if (nbytes > left)
+		nbytes = left;
+
+	memcpy((void *)buffer, &cache_data[line][off], nbytes);
+	cache_tags[line].last_use = cache_clock++;
+
+	return nbytes;
+}
+#endif /* IO_BLOCK_CACHE_LINES */
+
+io_type_t device_type_block(void)
+{
+	return IO_TYPE_BLOCK;
 }
 
 /* Allocate a device info from the pool and return a pointer to it */
 static int allocate_dev_info(io_dev_info_t **dev_info)
 {
-	int result = -ENOMEM;
+	block_dev_state_t *state;
+	unsigned int index;
+
 	assert(dev_info != NULL);
 
-	if (block_dev_count < MAX_IO_BLOCK_DEVICES) {
-		unsigned int index = 0;
-		result = find_first_block_state(NULL, &index);
-		assert(result == 0);
-		/* initialize dev_info */
-		dev_info_pool[index].funcs = &block_dev_funcs;
-		dev_info_pool[index].info = (uintptr_t)&state_pool[index];
-		*dev_info = &dev_info_pool[index];
-		++block_dev_count;
-	}
+	state = io_pool_alloc(&state_pool, &index);
+	if (state == NULL)
+		return -ENOMEM;
 
-	return result;
+	/* initialize dev_info */
+	dev_info_pool[index].funcs = &block_dev_funcs;
+	dev_info_pool[index].info = (uintptr_t)state;
+	*dev_info = &dev_info_pool[index];
+
+	return 0;
 }
 
 
 /* Release a device info to the pool */
 static int free_dev_info(io_dev_info_t *dev_info)
 {
-	int result;
-	unsigned int index = 0;
 	block_dev_state_t *state;
+	int result;
+
 	assert(dev_info != NULL);
 
 	state = (block_dev_state_t *)dev_info->info;
-	result = find_first_block_state(state->dev_spec, &index);
-	if (result ==  0) {
+	result = io_pool_free(&state_pool, state);
+	if (result == 0) {
 		/* free if device info is valid */
 		zeromem(state, sizeof(block_dev_state_t));
 		zeromem(dev_info, sizeof(io_dev_info_t));
-		--block_dev_count;
 	}
 
 	return result;
@@ -236,6 +384,14 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * When file_pos and the destination are both block aligned, the whole
+ * blocks of the request are read straight into the caller's buffer without
+ * going through the underlying buffer. The size of each of these direct
+ * requests is limited to `max_direct_read` if the device sets it, to the size
+ * of the underlying buffer otherwise, so that the low level driver never sees
+ * a request bigger than it can handle. Only the unaligned head and tail of a
+ * request go through the underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -292,6 +448,44 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+#if IO_BLOCK_CACHE_LINES
+		/* Only the reads smaller than a cache line use the cache */
+		if (left < CACHE_LINE_SIZE) {
+			nbytes = cache_read(cur, buffer + count, left);
+			if (nbytes != 0) {
+				cur->file_pos += nbytes;
+				count += nbytes;
+				continue;
+			}
+		}
+#endif
+
+		if ((skip == 0) && (left >= block_size) &&
+		    (((buffer + count) & (block_size - 1)) == 0)) {
+			/*
+			 * Both file_pos and the destination are block
+			 * aligned, so read the whole blocks directly into
+			 * the caller's buffer.
+			 */
+			request = left & ~(block_size - 1);
+			if (cur->dev_spec->max_direct_read != 0U) {
+				if (request > cur->dev_spec->max_direct_read)
+					request = cur->dev_spec->max_direct_read;
+			} else if (request > buf->length) {
+				request = buf->length;
+			}
+
+			nbytes = ops->read(lba, buffer + count, request);
+			if (nbytes == 0)
+				return -EIO;
+			if (nbytes > request)
+				nbytes = request;
+
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if (skip + left > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -381,6 +575,10 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 	       (ops->read != 0) &&
 	       (ops->write != 0));
 
+#if IO_BLOCK_CACHE_LINES
+	cache_invalidate(cur->dev_spec);
+#endif
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to write in every iteration, because it will depend
@@ -522,6 +720,9 @@ static int block_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
 
 static int block_dev_close(io_dev_info_t *dev_info)
 {
+#if IO_BLOCK_CACHE_LINES
+	cache_invalidate(((block_dev_state_t *)dev_info->info)->dev_spec);
+#endif
 	return free_dev_info(dev_info);
 }
 
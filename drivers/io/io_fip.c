@@ -5,15 +5,18 @@
  */
 
 #include <assert.h>
+#include <cassert.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <errno.h>
 #include <firmware_image_package.h>
 #include <io_driver.h>
 #include <io_fip.h>
+#include <io_pool.h>
 #include <io_storage.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <utils.h>
@@ -34,6 +37,12 @@
 typedef struct {
 	unsigned int file_pos;
 	fip_toc_entry_t entry;
+	/*
+	 * Backend handle kept open for as long as the file is open, and the
+	 * current position of the backend within the FIP.
+	 */
+	uintptr_t backend_handle;
+	size_t backend_pos;
 } file_state_t;
 
 /*
@@ -58,11 +67,39 @@ static file_state_t current_file = {0};
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
-static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
+#if FIP_TOC_CACHE_ENTRIES
+/* Maximum number of ToC entries read from the backend in one go */
+#define FIP_TOC_READ_BATCH	8U
+
+/*
+ * In-memory copy of the ToC of the FIP, sorted by UUID. It is built by
+ * fip_dev_init() and lets fip_file_open() locate a file without reading the
+ * ToC from the backend again. If the ToC has more entries than
+ * FIP_TOC_CACHE_ENTRIES, the cache is left invalid and the ToC is scanned
+ * from the backend instead.
+ */
+typedef struct {
+	uuid_t uuid;
+	uint64_t offset_address;
+	uint64_t size;
+} toc_cache_entry_t;
+
+static struct {
+	bool valid;
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
+	unsigned int num_entries;
+	toc_cache_entry_t entries[FIP_TOC_CACHE_ENTRIES];
+} toc_cache;
+#endif /* FIP_TOC_CACHE_ENTRIES */
+
+static fip_dev_state_t state_store[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
 
-/* Track number of allocated fip devices */
-static unsigned int fip_dev_count;
+/* Allocated fip states, the device info of a state has the same index */
+static IO_POOL_ARRAY(state_pool, state_store);
+
+CASSERT(MAX_FIP_DEVICES <= IO_POOL_MAX_OBJECTS, assert_max_fip_devices);
 
 /* Firmware Image Package driver functions */
 static int fip_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
@@ -94,6 +131,105 @@ static inline int is_valid_header(fip_toc_header_t *header)
 }
 
 
+#if FIP_TOC_CACHE_ENTRIES
+/*
+ * Read the ToC of the FIP from the backend and store it in the ToC cache. The
+ * backend must be positioned right after the FIP header. Entries are read in
+ * batches, making sure that the backend is never read beyond the start of the
+ * first payload so that the read always stays within the FIP.
+ */
+static int toc_cache_build(uintptr_t backend_handle)
+{
+	fip_toc_entry_t batch[FIP_TOC_READ_BATCH];
+	size_t pos = sizeof(fip_toc_header_t);
+	size_t toc_limit = 0;
+	size_t bytes_read;
+	unsigned int i, j, count;
+	int result;
+
+	toc_cache.valid = false;
+	toc_cache.num_entries = 0;
+
+	for (;;) {
+		/* Only read a single entry until the ToC limit is known */
+		count = 1U;
+		if (toc_limit > pos) {
+			count = (toc_limit - pos) / sizeof(fip_toc_entry_t);
+			if (count > FIP_TOC_READ_BATCH)
+				count = FIP_TOC_READ_BATCH;
+			else if (count == 0U)
+				count = 1U;
+		}
+
+		result = io_read(backend_handle, (uintptr_t)batch,
+				 count * sizeof(fip_toc_entry_t), &bytes_read);
+		if ((result != 0) ||
+		    (bytes_read != (count * sizeof(fip_toc_entry_t)))) {
+			return -EIO;
+		}
+		pos += bytes_read;
+
+		for (i = 0U; i < count; i++) {
+			if (compare_uuids(&batch[i].uuid, &uuid_null) == 0) {
+				/* End of the ToC */
+				toc_cache.valid = true;
+				return 0;
+			}
+
+			if (toc_cache.num_entries == FIP_TOC_CACHE_ENTRIES)
+				return -ENOMEM;
+
+			/* Insert the entry while keeping the cache sorted */
+			for (j = toc_cache.num_entries; j > 0U; j--) {
+				if (compare_uuids(&toc_cache.entries[j - 1U].uuid,
+						  &batch[i].uuid) < 0)
+					break;
+				toc_cache.entries[j] = toc_cache.entries[j - 1U];
+			}
+			toc_cache.entries[j].uuid = batch[i].uuid;
+			toc_cache.entries[j].offset_address =
+				batch[i].offset_address;
+			toc_cache.entries[j].size = batch[i].size;
+			toc_cache.num_entries++;
+
+			/* The ToC ends before the first payload */
+			if ((toc_limit == 0U) ||
+			    (batch[i].offset_address < toc_limit))
+				toc_limit = batch[i].offset_address;
+		}
+	}
+}
+
+/* Look up a UUID in the ToC cache. Returns 0 and fills entry if found. */
+static int toc_cache_lookup(const uuid_t *uuid, fip_toc_entry_t *entry)
+{
+	unsigned int low = 0U;
+	unsigned int high = toc_cache.num_entries;
+	unsigned int mid;
+	int cmp;
+
+	while (low < high) {
+		mid = low + ((high - low) / 2U);
+		cmp = compare_uuids(&toc_cache.entries[mid].uuid, uuid);
+		if (cmp == 0) {
+			entry->uuid = toc_cache.entries[mid].uuid;
+			entry->offset_address =
+				toc_cache.entries[mid].offset_address;
+			entry->size = toc_cache.entries[mid].size;
+			entry->flags = 0;
+			return 0;
+		} else if (cmp < 0) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	return -ENOENT;
+}
+#endif /* FIP_TOC_CACHE_ENTRIES */
+
+
 /* Identify the device type as a virtual driver */
 static io_type_t device_type_fip(void)
 {
@@ -118,63 +254,39 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.dev_close = fip_dev_close,
 };
 
-/* Locate a file state in the pool, specified by address */
-static int find_first_fip_state(const uintptr_t dev_spec,
-				  unsigned int *index_out)
-{
-	int result = -ENOENT;
-	unsigned int index;
-
-	for (index = 0; index < (unsigned int)MAX_FIP_DEVICES; ++index) {
-		/* dev_spec is used as identifier since it's unique */
-		if (state_pool[index].dev_spec == dev_spec) {
-			result = 0;
-			*index_out = index;
-			break;
-		}
-	}
-	return result;
-}
-
-
 /* Allocate a device info from the pool and return a pointer to it */
 static int allocate_dev_info(io_dev_info_t **dev_info)
 {
-	int result = -ENOMEM;
+	fip_dev_state_t *state;
+	unsigned int index;
 
 	assert(dev_info != NULL);
 
-	if (fip_dev_count < (unsigned int)MAX_FIP_DEVICES) {
-		unsigned int index = 0;
-
-		result = find_first_fip_state(0, &index);
-		assert(result == 0);
-		/* initialize dev_info */
-		dev_info_pool[index].funcs = &fip_dev_funcs;
-		dev_info_pool[index].info =
-				(uintptr_t)&state_pool[index];
-		*dev_info = &dev_info_pool[index];
-		++fip_dev_count;
-	}
+	state = io_pool_alloc(&state_pool, &index);
+	if (state == NULL)
+		return -ENOMEM;
 
-	return result;
+	/* initialize dev_info */
+	dev_info_pool[index].funcs = &fip_dev_funcs;
+	dev_info_pool[index].info = (uintptr_t)state;
+	*dev_info = &dev_info_pool[index];
+
+	return 0;
 }
 
 /* Release a device info to the pool */
 static int free_dev_info(io_dev_info_t *dev_info)
 {
-	int result;
-	unsigned int index = 0;
 	fip_dev_state_t *state;
+	int result;
 
 	assert(dev_info != NULL);
 
 	state = (fip_dev_state_t *)dev_info->info;
-	result = find_first_fip_state(state->dev_spec, &index);
-	if (result ==  0) {
+	result = io_pool_free(&state_pool, state);
+	if (result == 0) {
 		/* free if device info is valid */
 		zeromem(state, sizeof(fip_dev_state_t));
-		--fip_dev_count;
 	}
 
 	return result;
@@ -250,6 +362,24 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 		}
 	}
 
+#if FIP_TOC_CACHE_ENTRIES
+	/* Cache the ToC unless it has already been done for this backend */
+	if ((result == 0) &&
+	    (!toc_cache.valid ||
+	     (toc_cache.dev_handle != backend_dev_handle) ||
+	     (toc_cache.image_spec != backend_image_spec))) {
+		if (toc_cache_build(backend_handle) == 0) {
+			toc_cache.dev_handle = backend_dev_handle;
+			toc_cache.image_spec = backend_image_spec;
+			VERBOSE("FIP ToC cached (%u entries).\n",
+				toc_cache.num_entries);
+		} else {
+			/* Not fatal, the ToC will be read from the backend */
+			VERBOSE("FIP ToC not cached.\n");
+		}
+	}
+#endif
+
 	io_close(backend_handle);
 
  fip_dev_init_exit:
@@ -265,6 +395,10 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
 
+#if FIP_TOC_CACHE_ENTRIES
+	toc_cache.valid = false;
+#endif
+
 	return free_dev_info(dev_info);
 }
 
@@ -277,6 +411,7 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	uintptr_t backend_handle;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)spec;
 	size_t bytes_read;
+	unsigned int toc_entries = 0;
 	int found_file = 0;
 
 	assert(uuid_spec != NULL);
@@ -302,6 +437,29 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		goto fip_file_open_exit;
 	}
 
+#if FIP_TOC_CACHE_ENTRIES
+	if (toc_cache.valid && (toc_cache.dev_handle == backend_dev_handle) &&
+	    (toc_cache.image_spec == backend_image_spec)) {
+		if (toc_cache_lookup(&uuid_spec->uuid,
+				     &current_file.entry) != 0) {
+			/* Did not find the file in the FIP. */
+			current_file.entry.offset_address = 0;
+			result = -ENOENT;
+			goto fip_file_open_close;
+		}
+
+		/*
+		 * The backend position is unknown to us, so the first read
+		 * always seeks to the start of the file.
+		 */
+		current_file.file_pos = 0;
+		current_file.backend_handle = backend_handle;
+		current_file.backend_pos = 0;
+		entity->info = (uintptr_t)&current_file;
+		goto fip_file_open_exit;
+	}
+#endif
+
 	/* Seek past the FIP header into the Table of Contents */
 	result = io_seek(backend_handle, IO_SEEK_SET, sizeof(fip_toc_header_t));
 	if (result != 0) {
@@ -317,6 +475,7 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 				 sizeof(current_file.entry),
 				 &bytes_read);
 		if (result == 0) {
+			toc_entries++;
 			if (compare_uuids(&current_file.entry.uuid,
 					  &uuid_spec->uuid) == 0) {
 				found_file = 1;
@@ -331,10 +490,15 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 	if (found_file == 1) {
 		/* All fine. Update entity info with file state and return. Set
 		 * the file position to 0. The 'current_file.entry' holds the
-		 * base and size of the file.
+		 * base and size of the file. The backend is kept open until the
+		 * file is closed so that reads do not need to re-open it.
 		 */
 		current_file.file_pos = 0;
+		current_file.backend_handle = backend_handle;
+		current_file.backend_pos = sizeof(fip_toc_header_t) +
+					   (toc_entries * sizeof(fip_toc_entry_t));
 		entity->info = (uintptr_t)&current_file;
+		goto fip_file_open_exit;
 	} else {
 		/* Did not find the file in the FIP. */
 		current_file.entry.offset_address = 0;
@@ -369,60 +533,54 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	file_state_t *fp;
 	size_t file_offset;
 	size_t bytes_read;
-	uintptr_t backend_handle;
 
 	assert(entity != NULL);
 	assert(length_read != NULL);
 	assert(entity->info != (uintptr_t)NULL);
 
-	/* Open the backend, attempt to access the blob image */
-	result = io_open(backend_dev_handle, backend_image_spec,
-			 &backend_handle);
-	if (result != 0) {
-		WARN("Failed to open FIP (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_exit;
-	}
-
 	fp = (file_state_t *)entity->info;
+	assert(fp->backend_handle != (uintptr_t)NULL);
 
-	/* Seek to the position in the FIP where the payload lives */
+	/*
+	 * Seek to the position in the FIP where the payload lives. This is
+	 * not needed when reading sequentially through the file.
+	 */
 	file_offset = fp->entry.offset_address + fp->file_pos;
-	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
-	if (result != 0) {
-		WARN("fip_file_read: failed to seek\n");
-		result = -ENOENT;
-		goto fip_file_read_close;
+	if (fp->backend_pos != file_offset) {
+		result = io_seek(fp->backend_handle, IO_SEEK_SET, file_offset);
+		if (result != 0) {
+			WARN("fip_file_read: failed to seek\n");
+			return -ENOENT;
+		}
+		fp->backend_pos = file_offset;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
+	result = io_read(fp->backend_handle, buffer, length, &bytes_read);
 	if (result != 0) {
 		/* We cannot read our data. Fail. */
 		WARN("Failed to read payload (%i)\n", result);
-		result = -ENOENT;
-		goto fip_file_read_close;
-	} else {
-		/* Set caller length and new file position. */
-		*length_read = bytes_read;
-		fp->file_pos += bytes_read;
+		/* The backend position is unknown, force a seek next time */
+		fp->backend_pos = 0;
+		return -ENOENT;
 	}
 
-/* Close the backend. */
- fip_file_read_close:
-	io_close(backend_handle);
+	/* Set caller length and new file position. */
+	*length_read = bytes_read;
+	fp->file_pos += bytes_read;
+	fp->backend_pos += bytes_read;
 
- fip_file_read_exit:
-	return result;
+	return 0;
 }
 
 
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
-	/* Clear our current file pointer.
+	/* Close the backend and clear our current file pointer.
 	 * If we had malloc() we would free() here.
 	 */
 	if (current_file.entry.offset_address != 0) {
+		io_close(current_file.backend_handle);
 		zeromem(&current_file, sizeof(current_file));
 	}
 
@@ -450,3 +608,26 @@ int register_io_dev_fip(const io_dev_connector_t **dev_con)
 
 	return result;
 }
+
+/*
+ * Get the offset in the FIP and the size of a file opened with io_open() on a
+ * FIP device, e.g. so that a later boot stage can read it from the FIP itself.
+ * Returns -ENOTSUP if the file is not in a FIP.
+ */
+int fip_get_file_location(uintptr_t handle, uint64_t *offset, uint64_t *size)
+{
+	const io_entity_t *entity = (io_entity_t *)handle;
+	const file_state_t *fp;
+
+	assert(entity != NULL);
+	assert((offset != NULL) && (size != NULL));
+
+	if (entity->dev_handle->funcs->type() != IO_TYPE_FIRMWARE_IMAGE_PACKAGE)
+		return -ENOTSUP;
+
+	fp = (const file_state_t *)entity->info;
+	*offset = fp->entry.offset_address;
+	*size = fp->entry.size;
+
+	return 0;
+}
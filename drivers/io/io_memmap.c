@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <dma.h>
 #include <io_driver.h>
 #include <io_memmap.h>
 #include <io_storage.h>
@@ -29,6 +30,10 @@ typedef struct {
 
 static file_state_t current_file = {0};
 
+/* Flash controller of the device, NULL if it has none to set up */
+static const io_memmap_dev_spec_t *memmap_dev_spec;
+static int memmap_fast_read_enabled;
+
 /* Identify the device type as memmap */
 static io_type_t device_type_memmap(void)
 {
@@ -37,6 +42,8 @@ static io_type_t device_type_memmap(void)
 
 /* Memmap device functions */
 static int memmap_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
+static int memmap_dev_init(io_dev_info_t *dev_info,
+			   const uintptr_t init_params);
 static int memmap_block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			     io_entity_t *entity);
 static int memmap_block_seek(io_entity_t *entity, int mode,
@@ -63,7 +70,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.read = memmap_block_read,
 	.write = memmap_block_write,
 	.close = memmap_block_close,
-	.dev_init = NULL,
+	.dev_init = memmap_dev_init,
 	.dev_close = memmap_dev_close,
 };
 
@@ -75,13 +82,49 @@ static const io_dev_info_t memmap_dev_info = {
 };
 
 
-/* Open a connection to the memmap device */
-static int memmap_dev_open(const uintptr_t dev_spec __unused,
+/*
+ * Open a connection to the memmap device. `dev_spec` is either NULL or an
+ * io_memmap_dev_spec_t describing the flash controller behind the mapping.
+ */
+static int memmap_dev_open(const uintptr_t dev_spec,
 			   io_dev_info_t **dev_info)
 {
 	assert(dev_info != NULL);
 	*dev_info = (io_dev_info_t *)&memmap_dev_info; /* cast away const */
 
+	if ((const io_memmap_dev_spec_t *)dev_spec != memmap_dev_spec) {
+		memmap_dev_spec = (const io_memmap_dev_spec_t *)dev_spec;
+		memmap_fast_read_enabled = 0;
+	}
+
+	return 0;
+}
+
+
+/*
+ * Initialise the memmap device: switch its flash controller to its fast read
+ * mode, once, before the first image is read through the mapping.
+ */
+static int memmap_dev_init(io_dev_info_t *dev_info __unused,
+			   const uintptr_t init_params __unused)
+{
+	int result;
+
+	if ((memmap_dev_spec == NULL) ||
+	    (memmap_dev_spec->fast_read_init == NULL) ||
+	    (memmap_fast_read_enabled != 0))
+		return 0;
+
+	result = memmap_dev_spec->fast_read_init();
+	if (result != 0) {
+		/* The default read mode of the controller still works */
+		WARN("Failed to enable the flash fast read mode (%i)\n",
+		     result);
+		return 0;
+	}
+
+	memmap_fast_read_enabled = 1;
+
 	return 0;
 }
 
@@ -178,7 +221,16 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 	pos_after = fp->file_pos + length;
 	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
 
+#if DMA_ENGINE
+	if (dma_copy(buffer, fp->base + fp->file_pos, length) != 0)
+		return -EIO;
+#else
+	/*
+	 * memcpy() copies mutually aligned buffers with the widest loads
+	 * available, which the flash controllers turn into read bursts.
+	 */
 	memcpy((void *)buffer, (void *)(fp->base + fp->file_pos), length);
+#endif
 
 	*length_read = length;
 
@@ -10,8 +10,20 @@
 #include <io_storage.h>
 #include <platform_def.h>
 #include <semihosting.h>
+#include <utils_def.h>
 
+/*
+ * State of a file open on the semi-hosting device. The length of the file is
+ * only asked to the host once, with SYS_FLEN, and the position is tracked so
+ * that reads can be clamped to the end of the file without a trap.
+ */
+typedef struct {
+	long		handle;		/* 0 if the entry is free */
+	long		length;		/* -1 until known */
+	size_t		file_pos;
+} sh_file_state_t;
 
+static sh_file_state_t sh_files[MAX_IO_HANDLES];
 
 /* Identify the device type as semihosting */
 static io_type_t device_type_sh(void)
@@ -72,80 +84,120 @@ static int sh_dev_open(const uintptr_t dev_spec __unused,
 static int sh_file_open(io_dev_info_t *dev_info __unused,
 		const uintptr_t spec, io_entity_t *entity)
 {
-	int result = -ENOENT;
 	long sh_result;
 	const io_file_spec_t *file_spec = (const io_file_spec_t *)spec;
+	sh_file_state_t *fp = NULL;
+	unsigned int i;
 
 	assert(file_spec != NULL);
 	assert(entity != NULL);
 
+	for (i = 0U; i < ARRAY_SIZE(sh_files); i++) {
+		if (sh_files[i].handle == 0) {
+			fp = &sh_files[i];
+			break;
+		}
+	}
+	if (fp == NULL)
+		return -ENOMEM;
+
 	sh_result = semihosting_file_open(file_spec->path, file_spec->mode);
+	if (sh_result <= 0)
+		return -ENOENT;
 
-	if (sh_result > 0) {
-		entity->info = (uintptr_t)sh_result;
-		result = 0;
-	}
-	return result;
+	fp->handle = sh_result;
+	fp->length = -1;
+	fp->file_pos = 0U;
+	entity->info = (uintptr_t)fp;
+
+	return 0;
 }
 
 
 /* Seek to a particular file offset on the semi-hosting device */
 static int sh_file_seek(io_entity_t *entity, int mode, ssize_t offset)
 {
-	long file_handle, sh_result;
+	sh_file_state_t *fp;
+	long sh_result;
 
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	fp = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_seek(file_handle, offset);
+	sh_result = semihosting_file_seek(fp->handle, offset);
+	if (sh_result != 0)
+		return -ENOENT;
 
-	return (sh_result == 0) ? 0 : -ENOENT;
+	fp->file_pos = (size_t)offset;
+
+	return 0;
 }
 
 
 /* Return the size of a file on the semi-hosting device */
 static int sh_file_len(io_entity_t *entity, size_t *length)
 {
-	int result = -ENOENT;
+	sh_file_state_t *fp;
 
 	assert(entity != NULL);
 	assert(length != NULL);
 
-	long sh_handle = (long)entity->info;
-	long sh_result = semihosting_file_length(sh_handle);
+	fp = (sh_file_state_t *)entity->info;
 
-	if (sh_result >= 0) {
-		result = 0;
-		*length = (size_t)sh_result;
+	if (fp->length < 0) {
+		fp->length = semihosting_file_length(fp->handle);
+		if (fp->length < 0)
+			return -ENOENT;
 	}
 
-	return result;
+	*length = (size_t)fp->length;
+
+	return 0;
 }
 
 
-/* Read data from a file on the semi-hosting device */
+/*
+ * Read data from a file on the semi-hosting device. The data is read straight
+ * into the destination buffer, with a single SYS_READ unless the host returns
+ * less than requested before the end of the file.
+ */
 static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		size_t *length_read)
 {
-	int result = -ENOENT;
+	sh_file_state_t *fp;
+	size_t total = 0U;
+	size_t bytes, left;
 	long sh_result;
-	size_t bytes = length;
-	long file_handle;
 
 	assert(entity != NULL);
 	assert(length_read != NULL);
 
-	file_handle = (long)entity->info;
+	fp = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_read(file_handle, &bytes, buffer);
+	/* Don't trap to the host to find out that the file has ended */
+	if (fp->length >= 0) {
+		left = 0U;
+		if (fp->file_pos < (size_t)fp->length)
+			left = (size_t)fp->length - fp->file_pos;
+		length = MIN(length, left);
+	}
 
-	if (sh_result >= 0) {
-		*length_read = (bytes != length) ? bytes : length;
-		result = 0;
+	while (total < length) {
+		bytes = length - total;
+		sh_result = semihosting_file_read(fp->handle, &bytes,
+						  buffer + total);
+		if ((sh_result < 0) || (bytes == 0U))
+			break;
+		total += bytes;
 	}
 
-	return result;
+	if ((total == 0U) && (length != 0U))
+		return -ENOENT;
+
+	fp->file_pos += total;
+	*length_read = total;
+
+	return 0;
 }
 
 
@@ -153,19 +205,23 @@ static int sh_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 		size_t length, size_t *length_written)
 {
+	sh_file_state_t *fp;
 	long sh_result;
-	long file_handle;
 	size_t bytes = length;
 
 	assert(entity != NULL);
 	assert(length_written != NULL);
 
-	file_handle = (long)entity->info;
+	fp = (sh_file_state_t *)entity->info;
 
-	sh_result = semihosting_file_write(file_handle, &bytes, buffer);
+	sh_result = semihosting_file_write(fp->handle, &bytes, buffer);
 
 	*length_written = length - bytes;
 
+	/* The file may have grown */
+	fp->file_pos += length - bytes;
+	fp->length = -1;
+
 	return (sh_result == 0) ? 0 : -ENOENT;
 }
 
@@ -173,14 +229,17 @@ static int sh_file_write(io_entity_t *entity, const uintptr_t buffer,
 /* Close a file on the semi-hosting device */
 static int sh_file_close(io_entity_t *entity)
 {
+	sh_file_state_t *fp;
 	long sh_result;
-	long file_handle;
 
 	assert(entity != NULL);
 
-	file_handle = (long)entity->info;
+	fp = (sh_file_state_t *)entity->info;
+
+	sh_result = semihosting_file_close(fp->handle);
 
-	sh_result = semihosting_file_close(file_handle);
+	fp->handle = 0;
+	entity->info = 0U;
 
 	return (sh_result >= 0) ? 0 : -ENOENT;
 }
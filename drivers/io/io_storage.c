@@ -5,21 +5,19 @@
  */
 
 #include <assert.h>
+#include <cassert.h>
 #include <io_driver.h>
+#include <io_pool.h>
 #include <io_storage.h>
 #include <platform_def.h>
 #include <stddef.h>
 
 
 /* Storage for a fixed maximum number of IO entities, definable by platform */
-static io_entity_t entity_pool[MAX_IO_HANDLES];
+static io_entity_t entity_store[MAX_IO_HANDLES];
+static IO_POOL_ARRAY(entity_pool, entity_store);
 
-/* Simple way of tracking used storage - each entry is NULL or a pointer to an
- * entity */
-static io_entity_t *entity_map[MAX_IO_HANDLES];
-
-/* Track number of allocated entities */
-static unsigned int entity_count;
+CASSERT(MAX_IO_HANDLES <= IO_POOL_MAX_OBJECTS, assert_max_io_handles);
 
 /* Array of fixed maximum of registered devices, definable by platform */
 static const io_dev_info_t *devices[MAX_IO_DEVICES];
@@ -90,53 +88,23 @@ static void set_handle(uintptr_t *handle, io_entity_t *entity)
 }
 
 
-/* Locate an entity in the pool, specified by address */
-static int find_first_entity(const io_entity_t *entity, unsigned int *index_out)
-{
-	int result = -ENOENT;
-	for (unsigned int index = 0; index < MAX_IO_HANDLES; ++index) {
-		if (entity_map[index] == entity) {
-			result = 0;
-			*index_out = index;
-			break;
-		}
-	}
-	return result;
-}
-
-
 /* Allocate an entity from the pool and return a pointer to it */
 static int allocate_entity(io_entity_t **entity)
 {
-	int result = -ENOMEM;
 	assert(entity != NULL);
 
-	if (entity_count < MAX_IO_HANDLES) {
-		unsigned int index = 0;
-		result = find_first_entity(NULL, &index);
-		assert(result == 0);
-		*entity = entity_map[index] = &entity_pool[index];
-		++entity_count;
-	}
+	*entity = io_pool_alloc(&entity_pool, NULL);
 
-	return result;
+	return (*entity != NULL) ? 0 : -ENOMEM;
 }
 
 
 /* Release an entity back to the pool */
 static int free_entity(const io_entity_t *entity)
 {
-	int result;
-	unsigned int index = 0;
 	assert(entity != NULL);
 
-	result = find_first_entity(entity, &index);
-	if (result ==  0) {
-		entity_map[index] = NULL;
-		--entity_count;
-	}
-
-	return result;
+	return io_pool_free(&entity_pool, entity);
 }
 
 
@@ -126,20 +126,20 @@ static inline uint32_t polling_with_timeout(uintptr_t addr, uint32_t val,
 					    uint32_t usec_timeout,
 					    enum reg_width_type type)
 {
+	uint64_t timeout = timeout_init_us(usec_timeout);
 	uint32_t data;
 
 	do {
-		udelay(1);
 		if (type == REG_16BIT)
 			data = mmio_read_16(addr) & mask;
 		else
 			data = mmio_read_32(addr) & mask;
-	} while (data != val  && --usec_timeout > 0);
 
-	if (usec_timeout == 0)
-		return data;
+		if (data == val)
+			return 0;
+	} while (!timeout_elapsed(timeout));
 
-	return 0;
+	return data;
 }
 
 static inline void reg_set(uintptr_t addr, uint32_t data, uint32_t mask)
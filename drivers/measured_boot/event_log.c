@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <event_log.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdio.h>
+#include <string.h>
+#include <tbbr_img_def.h>
+
+/*
+ * The measurements are the digests of the images authenticated by hash, as
+ * given by the DigestInfo of their parent certificate. An image is only
+ * measured once it matched this digest, so the log never requires another
+ * pass over the image.
+ */
+#ifndef PLAT_EVENT_LOG_MAX_SIZE
+#define PLAT_EVENT_LOG_MAX_SIZE		U(1024)
+#endif
+
+/* Size of the TCG_PCR_EVENT header, including its Spec ID Event03 */
+#define SPEC_ID_EVENT_SIZE		(16U + 4U + 4U + 4U + 4U + 1U)
+#define PCR_EVENT_HDR_SIZE		(4U + 4U + 20U + 4U + SPEC_ID_EVENT_SIZE)
+
+/* Size of a TCG_PCR_EVENT2 with a single digest, without its event data */
+#define PCR_EVENT2_SIZE(digest_len)	(4U + 4U + 4U + 2U + (digest_len) + 4U)
+
+static uint8_t event_log[PLAT_EVENT_LOG_MAX_SIZE];
+static size_t event_log_size;
+
+/* Algorithm of the log, set by its first measurement */
+static unsigned int event_log_alg;
+
+/* Names of the images in the log */
+static const char *const event_log_names[MAX_NUMBER_IDS] = {
+	[BL2_IMAGE_ID] = "BL_2",
+	[SCP_BL2_IMAGE_ID] = "SCP_BL_2",
+	[BL31_IMAGE_ID] = "BL_31",
+	[BL32_IMAGE_ID] = "BL_32",
+	[BL32_EXTRA1_IMAGE_ID] = "BL32_EXTRA1",
+	[BL32_EXTRA2_IMAGE_ID] = "BL32_EXTRA2",
+	[BL33_IMAGE_ID] = "BL_33",
+	[HW_CONFIG_ID] = "HW_CONFIG",
+	[TB_FW_CONFIG_ID] = "TB_FW_CONFIG",
+	[SOC_FW_CONFIG_ID] = "SOC_FW_CONFIG",
+	[TOS_FW_CONFIG_ID] = "TOS_FW_CONFIG",
+	[NT_FW_CONFIG_ID] = "NT_FW_CONFIG",
+};
+
+#pragma weak bl2_plat_mboot_extend
+#pragma weak bl2_plat_mboot_finish
+
+int bl2_plat_mboot_extend(unsigned int pcr, unsigned int alg_id,
+			  const uint8_t *digest, unsigned int digest_len)
+{
+	return 0;
+}
+
+void bl2_plat_mboot_finish(const uint8_t *log, size_t log_size)
+{
+}
+
+static uint8_t *put8(uint8_t *p, unsigned int value)
+{
+	*p = (uint8_t)value;
+	return p + 1;
+}
+
+static uint8_t *put16(uint8_t *p, unsigned int value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	return p + 2;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t value)
+{
+	p = put16(p, value & 0xffffU);
+	return put16(p, value >> 16);
+}
+
+/*
+ * Extract the hash algorithm and the digest of a DER encoded DigestInfo:
+ *
+ *   DigestInfo ::= SEQUENCE {
+ *       digestAlgorithm SEQUENCE { OBJECT IDENTIFIER, NULL OPTIONAL },
+ *       digest OCTET STRING }
+ *
+ * Only the SHA-2 algorithms of the NIST hash algorithm arc are accepted, whose
+ * DigestInfo always fits the short form of the DER lengths.
+ *
+ * Return 0 on success, -EINVAL otherwise.
+ */
+static int parse_digest_info(const uint8_t *der, unsigned int len,
+			     unsigned int *alg_id, const uint8_t **digest,
+			     unsigned int *digest_len)
+{
+	static const uint8_t sha2_oid[] = {
+		0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02
+	};
+	const uint8_t *end, *alg_end;
+
+	if ((len < 2U) || (der[0] != 0x30U) || (der[1] > (len - 2U)))
+		return -EINVAL;
+	end = der + 2U + der[1];
+	der += 2;
+
+	/* digestAlgorithm */
+	if (((end - der) < 2) || (der[0] != 0x30U) ||
+	    (der[1] > (unsigned int)(end - der - 2)))
+		return -EINVAL;
+	alg_end = der + 2U + der[1];
+	der += 2;
+
+	if (((alg_end - der) < (int)(sizeof(sha2_oid) + 1U)) ||
+	    (memcmp(der, sha2_oid, sizeof(sha2_oid)) != 0))
+		return -EINVAL;
+
+	switch (der[sizeof(sha2_oid)]) {
+	case 0x01U:
+		*alg_id = TPM_ALG_SHA256;
+		*digest_len = 32U;
+		break;
+	case 0x02U:
+		*alg_id = TPM_ALG_SHA384;
+		*digest_len = 48U;
+		break;
+	case 0x03U:
+		*alg_id = TPM_ALG_SHA512;
+		*digest_len = 64U;
+		break;
+	default:
+		return -EINVAL;
+	}
+	der += sizeof(sha2_oid) + 1U;
+
+	/* The parameters are either absent or NULL */
+	if ((der != alg_end) &&
+	    (((alg_end - der) != 2) || (der[0] != 0x05U) || (der[1] != 0U)))
+		return -EINVAL;
+	der = alg_end;
+
+	/* digest */
+	if (((end - der) != (int)(2U + *digest_len)) || (der[0] != 0x04U) ||
+	    (der[1] != *digest_len))
+		return -EINVAL;
+
+	*digest = der + 2;
+
+	return 0;
+}
+
+/* Write the TCG_PCR_EVENT header of the log, for the algorithm `alg_id` */
+static void event_log_init(unsigned int alg_id, unsigned int digest_len)
+{
+	uint8_t *p = event_log;
+
+	assert(sizeof(event_log) >= PCR_EVENT_HDR_SIZE);
+
+	/* pcrIndex, eventType and the SHA-1 digest, unused */
+	p = put32(p, 0U);
+	p = put32(p, EV_NO_ACTION);
+	(void)memset(p, 0, 20U);
+	p += 20;
+	p = put32(p, SPEC_ID_EVENT_SIZE);
+
+	/* Spec ID Event03 */
+	(void)memcpy(p, EVENT_LOG_SPEC_ID_SIGNATURE,
+		     sizeof(EVENT_LOG_SPEC_ID_SIGNATURE));
+	p += 16;
+	/* platformClass, client */
+	p = put32(p, 0U);
+	/* specVersionMinor, specVersionMajor, specErrata and uintnSize */
+	p = put8(p, 0U);
+	p = put8(p, 2U);
+	p = put8(p, 2U);
+	p = put8(p, (sizeof(uintptr_t) == 8U) ? 2U : 1U);
+	/* numberOfAlgorithms and digestSizes */
+	p = put32(p, 1U);
+	p = put16(p, alg_id);
+	p = put16(p, digest_len);
+	/* vendorInfoSize */
+	p = put8(p, 0U);
+
+	assert((size_t)(p - event_log) == PCR_EVENT_HDR_SIZE);
+
+	event_log_alg = alg_id;
+	event_log_size = PCR_EVENT_HDR_SIZE;
+}
+
+/*
+ * Record the measurement of the image `img_id`, whose authenticated digest is
+ * given by the DigestInfo `digest_info`, in the event log, and extend the PCR
+ * of the platform with it.
+ *
+ * Return 0 on success, a negative error code otherwise.
+ */
+int event_log_measure(unsigned int img_id, const void *digest_info,
+		      unsigned int digest_info_len)
+{
+	const uint8_t *digest;
+	unsigned int alg_id, digest_len, name_len;
+	char name[EVENT_LOG_NAME_MAX];
+	uint8_t *p;
+	int rc;
+
+	assert(digest_info != NULL);
+	assert(img_id < MAX_NUMBER_IDS);
+
+	rc = parse_digest_info(digest_info, digest_info_len, &alg_id, &digest,
+			       &digest_len);
+	if (rc != 0) {
+		ERROR("Measured boot: Invalid digest for image id=%u\n",
+		      img_id);
+		return rc;
+	}
+
+	if (event_log_size == 0U) {
+		event_log_init(alg_id, digest_len);
+	} else if (alg_id != event_log_alg) {
+		ERROR("Measured boot: Image id=%u is not hashed with the"
+		      " algorithm of the log\n", img_id);
+		return -EINVAL;
+	}
+
+	if (event_log_names[img_id] != NULL) {
+		(void)strlcpy(name, event_log_names[img_id], sizeof(name));
+	} else {
+		(void)snprintf(name, sizeof(name), "IMAGE_%u", img_id);
+	}
+	name_len = (unsigned int)strlen(name) + 1U;
+
+	if ((sizeof(event_log) - event_log_size) <
+	    (PCR_EVENT2_SIZE(digest_len) + name_len)) {
+		ERROR("Measured boot: Event log full\n");
+		return -ENOMEM;
+	}
+
+	rc = bl2_plat_mboot_extend(EVENT_LOG_PCR, alg_id, digest, digest_len);
+	if (rc != 0) {
+		ERROR("Measured boot: Failed to extend PCR%u for image id=%u\n",
+		      EVENT_LOG_PCR, img_id);
+		return rc;
+	}
+
+	/* TCG_PCR_EVENT2 */
+	p = &event_log[event_log_size];
+	p = put32(p, EVENT_LOG_PCR);
+	p = put32(p, EV_POST_CODE);
+	/* TPML_DIGEST_VALUES */
+	p = put32(p, 1U);
+	p = put16(p, alg_id);
+	(void)memcpy(p, digest, digest_len);
+	p += digest_len;
+	p = put32(p, name_len);
+	(void)memcpy(p, name, name_len);
+	p += name_len;
+
+	event_log_size = (size_t)(p - event_log);
+
+	VERBOSE("Measured boot: Image id=%u recorded as %s\n", img_id, name);
+
+	return 0;
+}
+
+/*
+ * Hand the event log over to the platform once BL2 has loaded all the images,
+ * so that it is published to the next boot stages. The size is 0 if no image
+ * has been measured.
+ */
+void event_log_finish(void)
+{
+	bl2_plat_mboot_finish(event_log, event_log_size);
+}
@@ -21,6 +21,9 @@
 
 #define MULT_BY_512K_SHIFT		19
 
+/* Maximum number of blocks that can be set with CMD23 */
+#define CMD23_MAX_BLOCK_COUNT		U(0xFFFF)
+
 static const struct mmc_ops *ops;
 static unsigned int mmc_ocr_value;
 static struct mmc_csd_emmc mmc_csd;
@@ -28,6 +31,8 @@ static unsigned char mmc_ext_csd[512] __aligned(16);
 static unsigned int mmc_flags;
 static struct mmc_device_info *mmc_dev_info;
 static unsigned int rca;
+static struct mmc_adma2_desc *adma2_table;
+static unsigned int adma2_table_count;
 
 static const unsigned char tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 26, 30, 35, 40, 45, 52, 55, 60, 70, 80
@@ -42,6 +47,11 @@ static bool is_cmd23_enabled(void)
 	return ((mmc_flags & MMC_FLAG_CMD23) != 0U);
 }
 
+static bool is_adma2_enabled(void)
+{
+	return (adma2_table != NULL) && (ops->prepare_adma2 != NULL);
+}
+
 static int mmc_send_cmd(unsigned int idx, unsigned int arg,
 			unsigned int r_type, unsigned int *r_data)
 {
@@ -325,6 +335,127 @@ static int mmc_fill_device_info(void)
 	return 0;
 }
 
+/*
+ * Switch the device and the host controller to a new timing mode. The status
+ * of the device is only checked once the host runs with the new timing, as the
+ * device may not answer correctly before.
+ */
+static int mmc_switch_timing(unsigned int timing, unsigned int clk,
+			     unsigned int width)
+{
+	int ret;
+
+	ret = mmc_send_cmd(MMC_CMD(6),
+			   EXTCSD_WRITE_BYTES | EXTCSD_CMD(CMD_EXTCSD_HS_TIMING) |
+			   EXTCSD_VALUE(timing) | EXTCSD_CMD_SET_NORMAL,
+			   MMC_RESPONSE_R1B, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_timing(timing);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_ios(clk, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_device_state();
+		if (ret < 0) {
+			return ret;
+		}
+	} while (ret == MMC_STATE_PRG);
+
+	return 0;
+}
+
+/*
+ * HS400 can only be entered from HS200 once the tuning has been performed,
+ * going through the HS mode to switch the bus to DDR (JEDEC eMMC 5.1).
+ */
+static int mmc_select_hs400(void)
+{
+	int ret;
+
+	ret = mmc_switch_timing(MMC_TIMING_HS, MMC_HS_MAX_CLK_RATE,
+				MMC_BUS_WIDTH_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, MMC_BUS_WIDTH_DDR_8);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_switch_timing(MMC_TIMING_HS400, MMC_HS200_MAX_CLK_RATE,
+				 MMC_BUS_WIDTH_DDR_8);
+}
+
+/*
+ * Select the fastest bus mode allowed by the platform flags and supported by
+ * both the host controller and the device. The bus width must already have
+ * been set with mmc_set_ios(). If the device cannot be switched, it is left in
+ * the mode selected by mmc_set_ios().
+ */
+static int mmc_select_bus_mode(unsigned int bus_width)
+{
+	int ret;
+	unsigned int device_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+
+	if ((mmc_flags & (MMC_FLAG_HS200 | MMC_FLAG_HS400)) == 0U) {
+		return 0;
+	}
+
+	if ((mmc_dev_info->mmc_dev_type != MMC_IS_EMMC) ||
+	    (ops->set_timing == NULL) || (ops->execute_tuning == NULL)) {
+		WARN("MMC: HS200/HS400 not supported, keeping current mode\n");
+		return 0;
+	}
+
+	/* HS200 only works with a 4-bit or 8-bit SDR bus */
+	if (((bus_width != MMC_BUS_WIDTH_4) &&
+	     (bus_width != MMC_BUS_WIDTH_8)) ||
+	    ((device_type & MMC_DEVICE_TYPE_HS200) == 0U)) {
+		VERBOSE("MMC: HS200 not available\n");
+		return 0;
+	}
+
+	ret = mmc_switch_timing(MMC_TIMING_HS200, MMC_HS200_MAX_CLK_RATE,
+				bus_width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->execute_tuning(MMC_CMD_SEND_TUNING_BLOCK_HS200);
+	if (ret != 0) {
+		ERROR("MMC: HS200 tuning failed (%d)\n", ret);
+		return ret;
+	}
+
+	mmc_dev_info->max_bus_freq = MMC_HS200_MAX_CLK_RATE;
+
+	if (((mmc_flags & MMC_FLAG_HS400) == 0U) ||
+	    (bus_width != MMC_BUS_WIDTH_8) ||
+	    ((device_type & MMC_DEVICE_TYPE_HS400) == 0U)) {
+		VERBOSE("MMC: HS200 mode selected\n");
+		return 0;
+	}
+
+	ret = mmc_select_hs400();
+	if (ret != 0) {
+		return ret;
+	}
+
+	VERBOSE("MMC: HS400 mode selected\n");
+
+	return 0;
+}
+
 static int sd_send_op_cond(void)
 {
 	int n;
@@ -491,25 +622,29 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		return ret;
 	}
 
-	return mmc_fill_device_info();
+	ret = mmc_fill_device_info();
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_select_bus_mode(bus_width);
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+/*
+ * Issue the commands of a multi-block read whose DMA has already been set up,
+ * and wait for the end of the transfer.
+ */
+static size_t mmc_read_transfer(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
 
-	assert((ops != NULL) &&
-	       (ops->read != NULL) &&
-	       (size != 0U) &&
-	       ((size & MMC_BLOCK_MASK) == 0U));
-
-	ret = ops->prepare(lba, buf, size);
-	if (ret != 0) {
-		return 0;
-	}
-
 	if (is_cmd23_enabled()) {
+		if ((size / MMC_BLOCK_SIZE) > CMD23_MAX_BLOCK_COUNT) {
+			VERBOSE("MMC: too many blocks for CMD23\n");
+			return 0;
+		}
+
 		/* Set block count */
 		ret = mmc_send_cmd(MMC_CMD(23), size / MMC_BLOCK_SIZE,
 				   MMC_RESPONSE_R1, NULL);
@@ -561,6 +696,135 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 	return size;
 }
 
+/*
+ * Fill the ADMA2 descriptor table so that a single transfer scatters its
+ * data to all the entries of the list. Returns the total size of the
+ * transfer, or 0 if the table is too small.
+ */
+static size_t mmc_adma2_fill(const struct mmc_sg_entry *sg, unsigned int count)
+{
+	unsigned int i, n = 0U;
+	size_t total = 0U;
+
+	for (i = 0U; i < count; i++) {
+		uintptr_t buf = sg[i].buf;
+		size_t left = sg[i].size;
+
+		assert((buf & 7U) == 0U);
+
+		while (left > 0U) {
+			size_t len = MIN(left, (size_t)MMC_ADMA2_MAX_LEN);
+
+			if (n == adma2_table_count) {
+				VERBOSE("MMC: ADMA2 descriptor table too small\n");
+				return 0;
+			}
+
+			adma2_table[n].attr = MMC_ADMA2_ATTR_VALID |
+					      MMC_ADMA2_ATTR_ACT_TRAN;
+			/* A length of 0 encodes the maximum length */
+			adma2_table[n].len = (uint16_t)(len & 0xFFFFU);
+			adma2_table[n].addr_lo = (uint32_t)buf;
+			adma2_table[n].addr_hi = (uint32_t)((uint64_t)buf >> 32);
+
+			n++;
+			buf += len;
+			left -= len;
+			total += len;
+		}
+	}
+
+	if (n == 0U) {
+		return 0;
+	}
+
+	adma2_table[n - 1U].attr |= MMC_ADMA2_ATTR_END;
+	flush_dcache_range((uintptr_t)adma2_table,
+			   n * sizeof(struct mmc_adma2_desc));
+
+	return total;
+}
+
+/*
+ * Read consecutive blocks into a list of buffers. When the platform driver
+ * supports ADMA2 and a descriptor table has been registered, the whole list is
+ * read with a single command sequence. Otherwise, each buffer is read in turn.
+ */
+size_t mmc_read_blocks_sg(int lba, const struct mmc_sg_entry *sg,
+			  unsigned int count)
+{
+	unsigned int i;
+	size_t size, read_size;
+
+	assert((ops != NULL) &&
+	       (ops->read != NULL) &&
+	       (sg != NULL) &&
+	       (count != 0U));
+
+	if (!is_adma2_enabled()) {
+		read_size = 0U;
+		for (i = 0U; i < count; i++) {
+			size = mmc_read_blocks(lba, sg[i].buf, sg[i].size);
+			read_size += size;
+			if (size != sg[i].size) {
+				break;
+			}
+			lba += size / MMC_BLOCK_SIZE;
+		}
+
+		return read_size;
+	}
+
+	for (i = 0U; i < count; i++) {
+		assert((sg[i].size != 0U) &&
+		       ((sg[i].size & MMC_BLOCK_MASK) == 0U));
+		flush_dcache_range(sg[i].buf, sg[i].size);
+	}
+
+	size = mmc_adma2_fill(sg, count);
+	if (size == 0U) {
+		return 0;
+	}
+
+	if (ops->prepare_adma2(lba, (uintptr_t)adma2_table, size) != 0) {
+		return 0;
+	}
+
+	read_size = mmc_read_transfer(lba, 0, size);
+
+	for (i = 0U; i < count; i++) {
+		inv_dcache_range(sg[i].buf, sg[i].size);
+	}
+
+	return read_size;
+}
+
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	int ret;
+
+	assert((ops != NULL) &&
+	       (ops->read != NULL) &&
+	       (size != 0U) &&
+	       ((size & MMC_BLOCK_MASK) == 0U));
+
+	if (is_adma2_enabled()) {
+		struct mmc_sg_entry sg = {
+			.buf = buf,
+			.size = size,
+		};
+
+		return mmc_read_blocks_sg(lba, &sg, 1U);
+	}
+
+	ret = ops->prepare(lba, buf, size);
+	if (ret != 0) {
+		return 0;
+	}
+
+	return mmc_read_transfer(lba, buf, size);
+}
+
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
 	int ret;
@@ -732,3 +996,16 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 
 	return mmc_enumerate(clk, width);
 }
+
+/*
+ * Register the memory used to build ADMA2 descriptor tables. It must be
+ * accessible by the host controller DMA. Passing a NULL table disables ADMA2.
+ */
+void mmc_adma2_init(struct mmc_adma2_desc *table, unsigned int count)
+{
+	assert((table == NULL) || (count != 0U));
+	assert(((uintptr_t)table & 7U) == 0U);
+
+	adma2_table = table;
+	adma2_table_count = count;
+}
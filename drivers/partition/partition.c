@@ -5,16 +5,40 @@
  */
 
 #include <assert.h>
+#include <cdefs.h>
 #include <debug.h>
 #include <gpt.h>
 #include <io_storage.h>
 #include <mbr.h>
 #include <partition.h>
 #include <platform.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <tf_crc32.h>
+#include <utils.h>
+
+/*
+ * The GPT header and entries are read in bursts of GPT_BURST_SIZE bytes
+ * instead of one entry at a time. The buffer is block aligned so that block
+ * devices read it directly.
+ */
+#define GPT_BURST_SIZE			(8 * PARTITION_BLOCK_SIZE)
+
+/*
+ * Open addressing hash table of the partition names, holding the index of
+ * each entry of the list plus one. It is at least twice as large as the list
+ * so that the probe sequences stay short.
+ */
+#define PARTITION_INDEX_SIZE		256
+#define PARTITION_INDEX_MASK		(PARTITION_INDEX_SIZE - 1)
+
+CASSERT(PARTITION_INDEX_SIZE >= (2 * PLAT_PARTITION_MAX_ENTRIES),
+	assert_partition_index_size);
 
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static uint8_t gpt_burst[GPT_BURST_SIZE] __aligned(PARTITION_BLOCK_SIZE);
+static uint8_t name_index[PARTITION_INDEX_SIZE];
 partition_entry_list_t list;
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
@@ -72,64 +96,128 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 	return 0;
 }
 
+/* FNV-1a hash of a partition name */
+static unsigned int hash_name(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+
+	return hash & PARTITION_INDEX_MASK;
+}
+
 /*
- * Load GPT header and check the GPT signature.
+ * Index the names of the entries of the list. The entries are inserted in
+ * order, so a lookup finds the first entry of a given name, like a linear
+ * scan of the list would.
+ */
+static void build_name_index(void)
+{
+	unsigned int h;
+	int i;
+
+	zeromem(name_index, sizeof(name_index));
+	for (i = 0; i < list.entry_count; i++) {
+		h = hash_name(list.list[i].name);
+		while (name_index[h] != 0U) {
+			h = (h + 1U) & PARTITION_INDEX_MASK;
+		}
+		name_index[h] = (uint8_t)(i + 1);
+	}
+}
+
+/*
+ * Load GPT header and check the GPT signature and CRC.
  * If partiton numbers could be found, check & update it.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
+	uint32_t crc;
 	int result;
 
 	result = io_seek(image_handle, IO_SEEK_SET, GPT_HEADER_OFFSET);
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
-		return result;
+	result = io_read(image_handle, (uintptr_t)gpt_burst,
+			 PARTITION_BLOCK_SIZE, &bytes_read);
+	if ((result != 0) || (PARTITION_BLOCK_SIZE != bytes_read)) {
+		return -EIO;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-		   sizeof(header.signature)) != 0) {
+	memcpy(header, gpt_burst, sizeof(gpt_header_t));
+	if (memcmp(header->signature, GPT_SIGNATURE,
+		   sizeof(header->signature)) != 0) {
+		return -EINVAL;
+	}
+
+	/* The CRC covers the header with its CRC field cleared */
+	if ((header->size < sizeof(gpt_header_t)) ||
+	    (header->size > PARTITION_BLOCK_SIZE)) {
+		return -EINVAL;
+	}
+	zeromem(gpt_burst + offsetof(gpt_header_t, header_crc),
+		sizeof(header->header_crc));
+	crc = crc32(0U, gpt_burst, header->size);
+	if (crc != header->header_crc) {
+		WARN("Invalid GPT header CRC\n");
+		return -EINVAL;
+	}
+
+	if (header->part_size != sizeof(gpt_entry_t)) {
 		return -EINVAL;
 	}
 
 	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
+	list.entry_count = header->list_num;
 	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
 		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
 	}
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the whole array of GPT entries in bursts, computing its CRC on the way,
+ * and parse the entries that fit in the list.
+ */
+static int verify_partition_gpt(uintptr_t image_handle,
+				const gpt_header_t *header)
 {
-	size_t bytes_read;
-	int result;
-
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
-		return -EINVAL;
-	return result;
-}
+	size_t left, request, bytes_read, j;
+	uint32_t crc = 0U;
+	int result, i = 0, parsing = 1;
 
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
+	left = (size_t)header->list_num * sizeof(gpt_entry_t);
+	while (left > 0U) {
+		request = (left < GPT_BURST_SIZE) ? left : GPT_BURST_SIZE;
+		result = io_read(image_handle, (uintptr_t)gpt_burst, request,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != request)) {
+			return -EIO;
+		}
+		crc = crc32(crc, gpt_burst, request);
+		left -= request;
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
+		for (j = 0U; parsing && (j < request);
+		     j += sizeof(gpt_entry_t)) {
+			if ((i == list.entry_count) ||
+			    (parse_gpt_entry((gpt_entry_t *)&gpt_burst[j],
+					     &list.list[i]) != 0)) {
+				parsing = 0;
+				break;
+			}
+			i++;
 		}
 	}
+
+	if (crc != header->part_crc) {
+		WARN("Invalid GPT entries CRC\n");
+		list.entry_count = 0;
+		return -EINVAL;
+	}
 	if (i == 0) {
 		return -EINVAL;
 	}
@@ -139,6 +227,7 @@ static int verify_partition_gpt(uintptr_t image_handle)
 	 */
 	list.entry_count = i;
 	dump_entries(list.entry_count);
+	build_name_index();
 
 	return 0;
 }
@@ -147,6 +236,7 @@ int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
 	mbr_entry_t mbr_entry;
+	gpt_header_t header;
 	int result;
 
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
@@ -168,11 +258,11 @@ int load_partition_table(unsigned int image_id)
 		return result;
 	}
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
+		result = load_gpt_header(image_handle, &header);
 		assert(result == 0);
 		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
 		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = verify_partition_gpt(image_handle, &header);
 	} else {
 		/* MBR type isn't supported yet. */
 		result = -EINVAL;
@@ -185,9 +275,14 @@ exit:
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
+	unsigned int h;
 	int i;
 
-	for (i = 0; i < list.entry_count; i++) {
+	assert(name != NULL);
+
+	for (h = hash_name(name); name_index[h] != 0U;
+	     h = (h + 1U) & PARTITION_INDEX_MASK) {
+		i = name_index[h] - 1;
 		if (strcmp(name, list.list[i].name) == 0) {
 			return &list.list[i];
 		}
@@ -6,6 +6,8 @@
 
 #include <stdint.h>
 #include <arch_helpers.h>
+#include <dma.h>
+#include <errno.h>
 #include <string.h>
 #include <mmio.h>
 #include "rcar_def.h"
@@ -93,13 +95,6 @@ static void dma_start(uintptr_t dst, uint32_t src, uint32_t len)
 
 static void dma_end(void)
 {
-	while ((mmio_read_32(DMA_DMACHCR) & DMACHCR_TE_BIT) == 0) {
-		if ((mmio_read_32(DMA_DMACHCR) & DMACHCR_CHE_BIT) != 0U) {
-			ERROR("BL2: DMA - Channel Address Error\n");
-			panic();
-			break;
-		}
-	}
 	/* DMA transfer Disable */
 	mmio_clrbits_32(DMA_DMACHCR, DMACHCR_DE_BIT);
 	while ((mmio_read_32(DMA_DMACHCR) & DMACHCR_DE_BIT) != 0)
@@ -110,38 +105,47 @@ static void dma_end(void)
 	mmio_write_32(DMA_DMACHCLR, DMA_USE_CHANNEL);
 }
 
-void rcar_dma_exec(uintptr_t dst, uint32_t src, uint32_t len)
+static int rcar_dma_submit(uintptr_t dst, uintptr_t src, size_t len)
 {
-	uint32_t dma_len = len;
+	/* The generic code only submits aligned copies within the limit */
+	if ((src > UINT32_MAX) ||
+	    ((dst & UINT32_MAX) + len > DMADAR_BOUNDARY_ADDR) ||
+	    (dst + len > DMA_DST_LIMIT))
+		return -EINVAL;
 
-	if (len & DMA_FRACTION_MASK)
-		dma_len = (len + DMA_SIZE_UNIT) & ~DMA_FRACTION_MASK;
+	dma_start(dst, (uint32_t)src, (uint32_t)len);
 
-	if (!dma_len || dma_len > DMA_LENGTH_LIMIT) {
-		ERROR("BL2: DMA - size invalid, length (0x%x)\n", dma_len);
-		panic();
-	}
+	return 0;
+}
 
-	if (src & DMA_FRACTION_MASK) {
-		ERROR("BL2: DMA - source address invalid (0x%x), "
-			"length (0x%x)\n", src, dma_len);
-		panic();
-	}
+static int rcar_dma_poll(void)
+{
+	uint32_t chcr = mmio_read_32(DMA_DMACHCR);
 
-	if ((dst & UINT32_MAX) + dma_len > DMADAR_BOUNDARY_ADDR	||
-	    (dst + dma_len > DMA_DST_LIMIT)			||
-	    (dst & DMA_FRACTION_MASK)) {
-		ERROR("BL2: DMA - destination address invalid (0x%lx), "
-		      "length (0x%x)\n", dst, dma_len);
-		panic();
+	if ((chcr & DMACHCR_CHE_BIT) != 0U) {
+		ERROR("BL2: DMA - Channel Address Error\n");
+		dma_end();
+		return -EIO;
 	}
 
-	dma_start(dst, src, dma_len);
+	if ((chcr & DMACHCR_TE_BIT) == 0U)
+		return -EBUSY;
+
 	dma_end();
+
+	return 0;
 }
 
+static const dma_ops_t rcar_dma_ops = {
+	.align = DMA_SIZE_UNIT,
+	.max_len = DMA_LENGTH_LIMIT,
+	.submit = rcar_dma_submit,
+	.poll = rcar_dma_poll
+};
+
 void rcar_dma_init(void)
 {
 	dma_enable();
 	dma_setup();
+	dma_init(&rcar_dma_ops);
 }
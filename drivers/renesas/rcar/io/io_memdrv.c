@@ -5,6 +5,7 @@
  */
 
 #include <debug.h>
+#include <dma.h>
 #include <io_driver.h>
 #include <io_storage.h>
 #include <string.h>
@@ -14,8 +15,6 @@
 #include "io_memdrv.h"
 #include "rcar_def.h"
 
-extern void rcar_dma_exec(uintptr_t dst, uint32_t src, uint32_t len);
-
 static int32_t memdrv_dev_open(const uintptr_t dev __attribute__ ((unused)),
 			       io_dev_info_t **dev_info);
 static int32_t memdrv_dev_close(io_dev_info_t *dev_info);
@@ -85,7 +84,10 @@ static int32_t memdrv_block_read(io_entity_t *entity, uintptr_t buffer,
 		return IO_FAIL;
 	}
 
-	rcar_dma_exec(buffer, fp->base + fp->file_pos, length);
+	if (dma_copy(buffer, fp->base + fp->file_pos, length) != 0) {
+		ERROR("BL2: DMA - copy failed\n");
+		return IO_FAIL;
+	}
 	fp->file_pos += length;
 	*cnt = length;
 
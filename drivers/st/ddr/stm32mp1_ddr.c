@@ -292,6 +292,23 @@ static void set_reg(const struct ddr_info *priv,
 	}
 }
 
+/*
+ * Print the registers of a type, e.g. to report the DQS training results so
+ * that they can be set as st,phy-cal in the device tree.
+ */
+static void dump_reg(const struct ddr_info *priv, enum reg_type type)
+{
+	unsigned int i;
+	uint32_t base_addr = get_base_addr(priv, ddr_registers[type].base);
+	const struct reg_desc *desc = ddr_registers[type].desc;
+
+	for (i = 0; i < ddr_registers[type].size; i++) {
+		VERBOSE("%s %s = 0x%x\n", ddr_registers[type].name,
+			desc[i].name,
+			mmio_read_32(base_addr + desc[i].offset));
+	}
+}
+
 static void stm32mp1_ddrphy_idone_wait(struct stm32mp1_ddrphy *phy)
 {
 	uint32_t pgsr;
@@ -788,7 +805,9 @@ void stm32mp1_ddr_init(struct ddr_info *priv,
 	 */
 	set_reg(priv, REGPHY_REG, &config->p_reg);
 	set_reg(priv, REGPHY_TIMING, &config->p_timing);
-	set_reg(priv, REGPHY_CAL, &config->p_cal);
+	if (config->p_cal_present) {
+		set_reg(priv, REGPHY_CAL, &config->p_cal);
+	}
 
 	/* DDR3 = don't set DLLOFF for init mode */
 	if ((config->c_reg.mstr &
@@ -849,37 +868,49 @@ void stm32mp1_ddr_init(struct ddr_info *priv,
 		stm32mp1_ddr3_dll_off(priv);
 	}
 
-	VERBOSE("DDR DQS training : ");
-
 	/*
-	 *  8. Disable Auto refresh and power down by setting
-	 *    - RFSHCTL3.dis_au_refresh = 1
-	 *    - PWRCTL.powerdown_en = 0
-	 *    - DFIMISC.dfiinit_complete_en = 0
+	 * The DQS training can be skipped when its results, from a previous
+	 * boot, are given by the device tree.
 	 */
-	stm32mp1_refresh_disable(priv->ctl);
-
-	/*
-	 *  9. Program PUBL PGCR to enable refresh during training
-	 *     and rank to train
-	 *     not done => keep the programed value in PGCR
-	 */
-
-	/*
-	 * 10. configure PUBL PIR register to specify which training step
-	 * to run
-	 * Warning : RVTRN  is not supported by this PUBL
-	 */
-	stm32mp1_ddrphy_init(priv->phy, DDRPHYC_PIR_QSTRN);
-
-	/* 11. monitor PUB PGSR.IDONE to poll cpmpletion of training sequence */
-	stm32mp1_ddrphy_idone_wait(priv->phy);
-
-	/*
-	 * 12. set back registers in step 8 to the orginal values if desidered
-	 */
-	stm32mp1_refresh_restore(priv->ctl, config->c_reg.rfshctl3,
-				 config->c_reg.pwrctl);
+	if (!config->p_cal_present) {
+		VERBOSE("DDR DQS training : ");
+
+		/*
+		 *  8. Disable Auto refresh and power down by setting
+		 *    - RFSHCTL3.dis_au_refresh = 1
+		 *    - PWRCTL.powerdown_en = 0
+		 *    - DFIMISC.dfiinit_complete_en = 0
+		 */
+		stm32mp1_refresh_disable(priv->ctl);
+
+		/*
+		 *  9. Program PUBL PGCR to enable refresh during training
+		 *     and rank to train
+		 *     not done => keep the programed value in PGCR
+		 */
+
+		/*
+		 * 10. configure PUBL PIR register to specify which training
+		 * step to run
+		 * Warning : RVTRN  is not supported by this PUBL
+		 */
+		stm32mp1_ddrphy_init(priv->phy, DDRPHYC_PIR_QSTRN);
+
+		/*
+		 * 11. monitor PUB PGSR.IDONE to poll cpmpletion of training
+		 * sequence
+		 */
+		stm32mp1_ddrphy_idone_wait(priv->phy);
+
+		/*
+		 * 12. set back registers in step 8 to the orginal values if
+		 * desidered
+		 */
+		stm32mp1_refresh_restore(priv->ctl, config->c_reg.rfshctl3,
+					 config->c_reg.pwrctl);
+
+		dump_reg(priv, REGPHY_CAL);
+	}
 
 	/* Enable uMCTL2 AXI port 0 */
 	mmio_setbits_32((uint32_t)&priv->ctl->pctrl_0, DDRCTRL_PCTRL_N_PORT_EN);
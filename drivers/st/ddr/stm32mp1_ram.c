@@ -165,29 +165,90 @@ static uint32_t ddr_check_size(void)
 	return offset;
 }
 
+/*
+ * Run the checks of the DDR once it is initialized. It is run with the data
+ * cache disabled, before data have been put in DDR.
+ * Return 0 if the DDR works, -EIO otherwise.
+ */
+static int ddr_test(uint32_t size)
+{
+	uint32_t uret;
+
+	uret = ddr_test_data_bus();
+	if (uret != 0U) {
+		ERROR("DDR data bus test: can't access memory @ 0x%x\n",
+		      uret);
+		return -EIO;
+	}
+
+	uret = ddr_test_addr_bus();
+	if (uret != 0U) {
+		ERROR("DDR addr bus test: can't access memory @ 0x%x\n",
+		      uret);
+		return -EIO;
+	}
+
+	uret = ddr_check_size();
+	if (uret < size) {
+		ERROR("DDR size: 0x%x does not match DT config: 0x%x\n",
+		      uret, size);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static void stm32mp1_ddr_start(struct ddr_info *priv,
+			       struct stm32mp1_ddr_config *config)
+{
+	/* Disable axidcg clock gating during init */
+	mmio_clrbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
+
+	stm32mp1_ddr_init(priv, config);
+
+	/* Enable axidcg clock gating */
+	mmio_setbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
+
+	priv->info.size = config->info.size;
+
+	VERBOSE("%s : ram size(%x, %x)\n", __func__,
+		(uint32_t)priv->info.base, (uint32_t)priv->info.size);
+}
+
 static int stm32mp1_ddr_setup(void)
 {
 	struct ddr_info *priv = &ddr_priv_data;
 	int ret;
 	struct stm32mp1_ddr_config config;
 	int node, len;
-	uint32_t tamp_clk_off = 0, uret, idx;
+	uint32_t tamp_clk_off = 0, idx;
 	void *fdt;
 
 #define PARAM(x, y)							\
 	{								\
 		.name = x,						\
 		.offset = offsetof(struct stm32mp1_ddr_config, y),	\
-		.size = sizeof(config.y) / sizeof(uint32_t)		\
+		.size = sizeof(config.y) / sizeof(uint32_t),		\
+		.present = NULL						\
+	}
+
+#define PARAM_OPT(x, y)							\
+	{								\
+		.name = x,						\
+		.offset = offsetof(struct stm32mp1_ddr_config, y),	\
+		.size = sizeof(config.y) / sizeof(uint32_t),		\
+		.present = &config.y##_present				\
 	}
 
 #define CTL_PARAM(x) PARAM("st,ctl-"#x, c_##x)
 #define PHY_PARAM(x) PARAM("st,phy-"#x, p_##x)
+#define PHY_PARAM_OPT(x) PARAM_OPT("st,phy-"#x, p_##x)
 
 	const struct {
 		const char *name; /* Name in DT */
 		const uint32_t offset; /* Offset in config struct */
 		const uint32_t size;   /* Size of parameters */
+		bool * const present;  /* Presence of an optional parameter */
 	} param[] = {
 		CTL_PARAM(reg),
 		CTL_PARAM(timing),
@@ -195,7 +256,7 @@ static int stm32mp1_ddr_setup(void)
 		CTL_PARAM(perf),
 		PHY_PARAM(reg),
 		PHY_PARAM(timing),
-		PHY_PARAM(cal)
+		PHY_PARAM_OPT(cal)
 	};
 
 	if (fdt_get_address(&fdt) == 0) {
@@ -228,6 +289,12 @@ static int stm32mp1_ddr_setup(void)
 
 		VERBOSE("%s: %s[0x%x] = %d\n", __func__,
 			param[idx].name, param[idx].size, ret);
+		if (param[idx].present != NULL) {
+			*param[idx].present = (ret == 0);
+			if (ret == -FDT_ERR_NOTFOUND) {
+				continue;
+			}
+		}
 		if (ret != 0) {
 			ERROR("%s: Cannot read %s\n",
 			      __func__, param[idx].name);
@@ -248,40 +315,25 @@ static int stm32mp1_ddr_setup(void)
 		}
 	}
 
-	/* Disable axidcg clock gating during init */
-	mmio_clrbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
-
-	stm32mp1_ddr_init(priv, &config);
-
-	/* Enable axidcg clock gating */
-	mmio_setbits_32(priv->rcc + RCC_DDRITFCR, RCC_DDRITFCR_AXIDCGEN);
-
-	priv->info.size = config.info.size;
-
-	VERBOSE("%s : ram size(%x, %x)\n", __func__,
-		(uint32_t)priv->info.base, (uint32_t)priv->info.size);
+	stm32mp1_ddr_start(priv, &config);
 
 	dcsw_op_all(DC_OP_CISW);
 	write_sctlr(read_sctlr() & ~SCTLR_C_BIT);
 
-	uret = ddr_test_data_bus();
-	if (uret != 0U) {
-		ERROR("DDR data bus test: can't access memory @ 0x%x\n",
-		      uret);
-		panic();
-	}
-
-	uret = ddr_test_addr_bus();
-	if (uret != 0U) {
-		ERROR("DDR addr bus test: can't access memory @ 0x%x\n",
-		      uret);
-		panic();
+	ret = ddr_test(config.info.size);
+	if ((ret != 0) && config.p_cal_present) {
+		/*
+		 * The calibration values no longer fit the DDR, e.g. because
+		 * it has been replaced or the temperature has changed a lot:
+		 * run the DQS training.
+		 */
+		WARN("DDR: st,phy-cal rejected, training the DDR\n");
+		config.p_cal_present = false;
+		stm32mp1_ddr_start(priv, &config);
+		ret = ddr_test(config.info.size);
 	}
 
-	uret = ddr_check_size();
-	if (uret < config.info.size) {
-		ERROR("DDR size: 0x%x does not match DT config: 0x%x\n",
-		      uret, config.info.size);
+	if (ret != 0) {
 		panic();
 	}
 
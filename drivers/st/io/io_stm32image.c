@@ -227,16 +227,12 @@ static int stm32image_partition_size(io_entity_t *entity, size_t *length)
 	return 0;
 }
 
-static int check_header(boot_api_image_header_t *header, uintptr_t buffer)
+static int check_header(boot_api_image_header_t *header)
 {
-	uint32_t i;
-	uint32_t img_checksum = 0;
-
 	/*
-	 * Check header/payload validity:
+	 * Check header validity:
 	 *	- Header magic
 	 *	- Header version
-	 *	- Payload checksum
 	 */
 	if (header->magic != BOOT_API_IMAGE_HEADER_MAGIC_NB) {
 		ERROR("Header magic\n");
@@ -248,14 +244,59 @@ static int check_header(boot_api_image_header_t *header, uintptr_t buffer)
 		return -EINVAL;
 	}
 
-	for (i = 0; i < header->image_length; i++) {
+	return 0;
+}
+
+/*
+ * Add the bytes of the payload in [buffer, buffer + length) to the checksum,
+ * ignoring the padding past the image length.
+ */
+static uint32_t update_checksum(uint32_t img_checksum, uintptr_t buffer,
+				size_t length, size_t *payload_left)
+{
+	size_t i;
+
+	length = MIN(length, *payload_left);
+	*payload_left -= length;
+
+	for (i = 0; i < length; i++) {
 		img_checksum += *(uint8_t *)(buffer + i);
 	}
 
-	if (header->payload_checksum != img_checksum) {
-		ERROR("Checksum: 0x%x (awaited: 0x%x)\n", img_checksum,
-		      header->payload_checksum);
-		return -EINVAL;
+	return img_checksum;
+}
+
+/*
+ * Read the payload from the backend in chunks, checksumming each chunk while
+ * it is still in the cache instead of walking the whole image again in DDR.
+ */
+static int read_payload(uintptr_t backend_handle, uintptr_t buffer,
+			size_t length, size_t *length_read,
+			uint32_t *img_checksum, size_t *payload_left)
+{
+	size_t chunk, chunk_read;
+	int result;
+
+	*length_read = 0U;
+
+	while (*length_read < length) {
+		chunk = MIN(length - *length_read,
+			    (size_t)STM32_IMAGE_READ_CHUNK);
+
+		result = io_read(backend_handle, buffer + *length_read, chunk,
+				 &chunk_read);
+		if (result != 0) {
+			return result;
+		}
+
+		*img_checksum = update_checksum(*img_checksum,
+						buffer + *length_read,
+						chunk_read, payload_left);
+		*length_read += chunk_read;
+
+		if (chunk_read < chunk) {
+			break;
+		}
 	}
 
 	return 0;
@@ -266,6 +307,8 @@ static int stm32image_partition_read(io_entity_t *entity, uintptr_t buffer,
 				     size_t length, size_t *length_read)
 {
 	int result = 0, offset, local_length = 0;
+	uint32_t img_checksum;
+	size_t payload_left;
 	uint8_t *local_buffer = (uint8_t *)buffer;
 	boot_api_image_header_t *header =
 		(boot_api_image_header_t *)first_lba_buffer;
@@ -295,10 +338,23 @@ static int stm32image_partition_read(io_entity_t *entity, uintptr_t buffer,
 			}
 		}
 
+		result = check_header(header);
+		if (result != 0) {
+			ERROR("Header check failed\n");
+			header->magic = 0;
+			break;
+		}
+
+		payload_left = header->image_length;
+
 		/* Part of image already loaded with the header */
 		memcpy(local_buffer, (uint8_t *)first_lba_buffer +
 		       sizeof(boot_api_image_header_t),
 		       MAX_LBA_SIZE - sizeof(boot_api_image_header_t));
+		img_checksum = update_checksum(0U, (uintptr_t)local_buffer,
+					       MAX_LBA_SIZE -
+					       sizeof(boot_api_image_header_t),
+					       &payload_left);
 		local_buffer += MAX_LBA_SIZE - sizeof(boot_api_image_header_t);
 		offset = MAX_LBA_SIZE;
 
@@ -332,8 +388,9 @@ static int stm32image_partition_read(io_entity_t *entity, uintptr_t buffer,
 			break;
 		}
 
-		result = io_read(backend_handle, (uintptr_t)local_buffer,
-				 local_length, length_read);
+		result = read_payload(backend_handle, (uintptr_t)local_buffer,
+				      local_length, length_read,
+				      &img_checksum, &payload_left);
 
 		/* Adding part of size already read from header */
 		*length_read += MAX_LBA_SIZE - sizeof(boot_api_image_header_t);
@@ -345,8 +402,10 @@ static int stm32image_partition_read(io_entity_t *entity, uintptr_t buffer,
 			break;
 		}
 
-		result = check_header(header, buffer);
-		if (result != 0) {
+		if ((payload_left != 0U) ||
+		    (header->payload_checksum != img_checksum)) {
+			ERROR("Checksum: 0x%x (awaited: 0x%x)\n", img_checksum,
+			      header->payload_checksum);
 			ERROR("Header check failed\n");
 			*length_read = 0;
 			header->magic = 0;
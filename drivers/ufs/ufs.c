@@ -25,8 +25,38 @@
 
 #define MAX_PRDT_SIZE			0x40000		/* 256KB */
 
+/*
+ * The UTP Transfer Request List, holding the UTRD of each slot, takes the first
+ * UFS_DESC_SIZE bytes of the descriptor memory, and is followed by the UTP
+ * Command Descriptor of each slot. The list is at a fixed address, so that
+ * requests can be outstanding on several slots at once.
+ *
+ * The rest of the descriptor memory is shared out between the UCDs, so that
+ * their PRDT can map multi-megabyte transfers. Only the first UFS_DESC_SIZE
+ * bytes of a UCD, which hold the UPIUs, are cleared for each request. The PRDT
+ * offset is a 16-bit count of double words, which bounds the size of a UCD.
+ */
+#define UFS_UTRL_SIZE			UFS_DESC_SIZE
+#define UFS_MIN_DESC_SIZE		(UFS_UTRL_SIZE + UFS_DESC_SIZE)
+#define UFS_MAX_SLOTS			(CAP_NUTRS_MASK + 1)
+#define MAX_UCD_SIZE			0x40000		/* 256KB */
+#define UCD_BASE(slot)			(ufs_params.desc_base + UFS_UTRL_SIZE + \
+					 ((slot) * ucd_size))
+
+/* Offset of the PRDT in a UCD, after its Command and Response UPIUs */
+#define PRDT_OFFSET			(ALIGN_8(sizeof(cmd_upiu_t)) +	\
+					 ALIGN_8(sizeof(resp_upiu_t)))
+
+/* Largest transfer of a READ(10) or WRITE(10) */
+#define MAX_CMD_XFER_SIZE		((size_t)UINT16_MAX << UFS_BLOCK_SHIFT)
+
 static ufs_params_t ufs_params;
 static int nutrs;	/* Number of UTP Transfer Request Slots */
+static size_t ucd_size;	/* Size of the UCD of each slot */
+static size_t max_xfer_size;	/* Largest transfer of a request */
+
+/* Slots taken by a request whose doorbell isn't rung yet */
+static unsigned int slots_reserved;
 
 int ufshc_send_uic_cmd(uintptr_t base, uic_cmd_t *cmd)
 {
@@ -156,7 +186,7 @@ static int get_empty_slot(int *slot)
 	unsigned int data;
 	int i;
 
-	data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
+	data = mmio_read_32(ufs_params.reg_base + UTRLDBR) | slots_reserved;
 	for (i = 0; i < nutrs; i++) {
 		if ((data & 1) == 0)
 			break;
@@ -168,30 +198,36 @@ static int get_empty_slot(int *slot)
 	return 0;
 }
 
-static void get_utrd(utp_utrd_t *utrd)
+/* Set the addresses of the UTRD and UCD of `slot` in `utrd` */
+static void ufs_utrd_layout(utp_utrd_t *utrd, int slot)
 {
-	uintptr_t base;
-	int slot = 0, result;
-	utrd_header_t *hd;
-
-	assert(utrd != NULL);
-	result = get_empty_slot(&slot);
-	assert(result == 0);
-
 	/* clear utrd */
 	memset((void *)utrd, 0, sizeof(utp_utrd_t));
-	base = ufs_params.desc_base + (slot * UFS_DESC_SIZE);
-	/* clear the descriptor */
-	memset((void *)base, 0, UFS_DESC_SIZE);
 
-	utrd->header = base;
+	utrd->header = ufs_params.desc_base + (slot * sizeof(utrd_header_t));
 	utrd->task_tag = slot + 1;
 	/* CDB address should be aligned with 128 bytes */
-	utrd->upiu = ALIGN_CDB(utrd->header + sizeof(utrd_header_t));
+	utrd->upiu = ALIGN_CDB(UCD_BASE(slot));
 	utrd->resp_upiu = ALIGN_8(utrd->upiu + sizeof(cmd_upiu_t));
 	utrd->size_upiu = utrd->resp_upiu - utrd->upiu;
 	utrd->size_resp_upiu = ALIGN_8(sizeof(resp_upiu_t));
 	utrd->prdt = utrd->resp_upiu + utrd->size_resp_upiu;
+}
+
+static void get_utrd(utp_utrd_t *utrd)
+{
+	int slot = 0, result;
+	utrd_header_t *hd;
+
+	assert(utrd != NULL);
+	result = get_empty_slot(&slot);
+	assert(result == 0);
+	slots_reserved |= 1U << slot;
+
+	ufs_utrd_layout(utrd, slot);
+	/* clear the descriptors */
+	memset((void *)utrd->header, 0, sizeof(utrd_header_t));
+	memset((void *)UCD_BASE(slot), 0, UFS_DESC_SIZE);
 
 	hd = (utrd_header_t *)utrd->header;
 	hd->ucdba = utrd->upiu & UINT32_MAX;
@@ -215,12 +251,6 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	unsigned int lba_cnt;
 	int prdt_size;
 
-
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->upiu >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	upiu = (cmd_upiu_t *)utrd->upiu;
 
@@ -282,8 +312,12 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 		assert(lba_cnt <= UINT16_MAX);
 		prdt = (prdt_t *)utrd->prdt;
 
+		assert(length <= max_xfer_size);
 		prdt_size = 0;
 		while (length > 0) {
+			/* Only the UPIUs have been cleared */
+			prdt->reserved0 = 0;
+			prdt->reserved1 = 0;
 			prdt->dba = (unsigned int)(buf & UINT32_MAX);
 			prdt->dbau = (unsigned int)((buf >> 32) & UINT32_MAX);
 			/* prdt->dbc counts from 0 */
@@ -304,7 +338,13 @@ static int ufs_prepare_cmd(utp_utrd_t *utrd, uint8_t op, uint8_t lun,
 	}
 
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, sizeof(utrd_header_t));
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
+	/* The PRDT of a large transfer goes past the cleared part of the UCD */
+	if ((utrd->prdt + utrd->size_prdt) > (utrd->upiu + UFS_DESC_SIZE))
+		flush_dcache_range(utrd->upiu + UFS_DESC_SIZE,
+				   utrd->prdt + utrd->size_prdt -
+				   (utrd->upiu + UFS_DESC_SIZE));
 	return 0;
 }
 
@@ -319,12 +359,6 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 	hd = (utrd_header_t *)utrd->header;
 	query_upiu = (query_upiu_t *)utrd->upiu;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
-
 	hd->i = 1;
 	hd->ct = CT_UFS_STORAGE;
 	hd->ocs = OCS_MASK;
@@ -363,7 +397,8 @@ static int ufs_prepare_query(utp_utrd_t *utrd, uint8_t op, uint8_t idn,
 		break;
 	}
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, sizeof(utrd_header_t));
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 	return 0;
 }
 
@@ -372,11 +407,6 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	utrd_header_t *hd;
 	nop_out_upiu_t *nop_out;
 
-	mmio_write_32(ufs_params.reg_base + UTRLBA,
-		      utrd->header & UINT32_MAX);
-	mmio_write_32(ufs_params.reg_base + UTRLBAU,
-		      (utrd->header >> 32) & UINT32_MAX);
-
 	hd = (utrd_header_t *)utrd->header;
 	nop_out = (nop_out_upiu_t *)utrd->upiu;
 
@@ -387,15 +417,15 @@ static void ufs_prepare_nop_out(utp_utrd_t *utrd)
 	nop_out->trans_type = 0;
 	nop_out->task_tag = utrd->task_tag;
 	flush_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
-	flush_dcache_range((uintptr_t)utrd->header, UFS_DESC_SIZE);
+	flush_dcache_range((uintptr_t)utrd->header, sizeof(utrd_header_t));
+	flush_dcache_range((uintptr_t)utrd->upiu, UFS_DESC_SIZE);
 }
 
-static void ufs_send_request(int task_tag)
+/* Ring the doorbell of all the `slots` at once */
+static void ufs_send_requests(unsigned int slots)
 {
 	unsigned int data;
-	int slot;
 
-	slot = task_tag - 1;
 	/* clear all interrupts */
 	mmio_write_32(ufs_params.reg_base + IS, ~0);
 
@@ -408,7 +438,28 @@ static void ufs_send_request(int task_tag)
 	       UTRIACR_IATOVAL(0xFF);
 	mmio_write_32(ufs_params.reg_base + UTRIACR, data);
 	/* send request */
-	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, 1 << slot);
+	slots_reserved &= ~slots;
+	mmio_setbits_32(ufs_params.reg_base + UTRLDBR, slots);
+}
+
+static void ufs_send_request(int task_tag)
+{
+	ufs_send_requests(1U << (task_tag - 1));
+}
+
+/* Wait for the completion of the requests of all the `slots` */
+static int ufs_wait_requests(unsigned int slots)
+{
+	unsigned int data;
+
+	do {
+		data = mmio_read_32(ufs_params.reg_base + IS);
+		if ((data & ~(UFS_INT_UCCS | UFS_INT_UTRCS)) != 0)
+			return -EIO;
+		data = mmio_read_32(ufs_params.reg_base + UTRLDBR);
+	} while ((data & slots) != 0);
+
+	return 0;
 }
 
 static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
@@ -420,7 +471,8 @@ static int ufs_check_resp(utp_utrd_t *utrd, int trans_type)
 
 	hd = (utrd_header_t *)utrd->header;
 	resp = (resp_upiu_t *)utrd->resp_upiu;
-	inv_dcache_range((uintptr_t)hd, UFS_DESC_SIZE);
+	inv_dcache_range((uintptr_t)hd, sizeof(utrd_header_t));
+	inv_dcache_range(utrd->upiu, UFS_DESC_SIZE);
 	inv_dcache_range((uintptr_t)utrd, sizeof(utp_utrd_t));
 	do {
 		data = mmio_read_32(ufs_params.reg_base + IS);
@@ -601,7 +653,7 @@ void ufs_read_capacity(int lun, unsigned int *num, unsigned int *size)
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE) &&
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE) &&
 	       (num != NULL) && (size != NULL));
 
 	/* align buf address */
@@ -648,9 +700,8 @@ size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE));
 
-	memset((void *)buf, 0, size);
 	get_utrd(&utrd);
 	ufs_prepare_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf, size);
 	ufs_send_request(utrd.task_tag);
@@ -664,6 +715,80 @@ size_t ufs_read_blocks(int lun, int lba, uintptr_t buf, size_t size)
 	return size - resp->res_trans_cnt;
 }
 
+/*
+ * Read `size` bytes from `lba` like ufs_read_blocks(), but split the read in
+ * up to one request per slot, each with its own PRDT, and ring the doorbell
+ * of all of them at once, so that the device processes them concurrently.
+ * Return the number of bytes read, which is less than `size` on error.
+ */
+size_t ufs_read_blocks_queued(int lun, int lba, uintptr_t buf, size_t size)
+{
+	utp_utrd_t utrd;
+	utrd_header_t *hd;
+	resp_upiu_t *resp;
+	size_t len[UFS_MAX_SLOTS];
+	int slot[UFS_MAX_SLOTS];
+	size_t chunk, total = 0, done;
+	unsigned int slots;
+	int i, n;
+
+	assert((ufs_params.reg_base != 0) &&
+	       (ufs_params.desc_base != 0) &&
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE) &&
+	       ((size & UFS_BLOCK_MASK) == 0));
+
+	while (size > 0) {
+		/* Spread what is left over all the slots */
+		chunk = (size + nutrs - 1) / nutrs;
+		chunk = (chunk + UFS_BLOCK_MASK) & ~UFS_BLOCK_MASK;
+		if (chunk < MAX_PRDT_SIZE)
+			chunk = MAX_PRDT_SIZE;
+		if (chunk > max_xfer_size)
+			chunk = max_xfer_size;
+
+		slots = 0;
+		for (n = 0; (n < nutrs) && (size > 0); n++) {
+			if (get_empty_slot(&slot[n]) != 0)
+				break;
+			len[n] = (size < chunk) ? size : chunk;
+			get_utrd(&utrd);
+			slot[n] = utrd.task_tag - 1;
+			ufs_prepare_cmd(&utrd, CDBCMD_READ_10, lun, lba, buf,
+					len[n]);
+			slots |= 1U << slot[n];
+			lba += len[n] >> UFS_BLOCK_SHIFT;
+			buf += len[n];
+			size -= len[n];
+		}
+		assert(n > 0);
+
+		ufs_send_requests(slots);
+		if (ufs_wait_requests(slots) != 0)
+			return total;
+
+		for (i = 0; i < n; i++) {
+			ufs_utrd_layout(&utrd, slot[i]);
+			hd = (utrd_header_t *)utrd.header;
+			resp = (resp_upiu_t *)utrd.resp_upiu;
+			inv_dcache_range(utrd.header, sizeof(utrd_header_t));
+			inv_dcache_range(utrd.upiu, UFS_DESC_SIZE);
+#ifdef UFS_RESP_DEBUG
+			dump_upiu(&utrd);
+#endif
+			if ((hd->ocs != OCS_SUCCESS) ||
+			    ((resp->trans_type & TRANS_TYPE_CODE_MASK) !=
+			     RESPONSE_UPIU))
+				return total;
+			done = len[i] - be32toh(resp->res_trans_cnt);
+			total += done;
+			if (done != len[i])
+				return total;
+		}
+	}
+
+	return total;
+}
+
 size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 {
 	utp_utrd_t utrd;
@@ -672,7 +797,7 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 
 	assert((ufs_params.reg_base != 0) &&
 	       (ufs_params.desc_base != 0) &&
-	       (ufs_params.desc_size >= UFS_DESC_SIZE));
+	       (ufs_params.desc_size >= UFS_MIN_DESC_SIZE));
 
 	memset((void *)buf, 0, size);
 	get_utrd(&utrd);
@@ -688,15 +813,43 @@ size_t ufs_write_blocks(int lun, int lba, const uintptr_t buf, size_t size)
 	return size - resp->res_trans_cnt;
 }
 
-static void ufs_enum(void)
+/* Set up the UTP Transfer Request List, which must not be running */
+static void ufs_utrl_init(void)
 {
-	unsigned int blk_num, blk_size;
-	int i;
+	uintptr_t base = ufs_params.desc_base;
 
 	/* 0 means 1 slot */
 	nutrs = (mmio_read_32(ufs_params.reg_base + CAP) & CAP_NUTRS_MASK) + 1;
-	if (nutrs > (ufs_params.desc_size / UFS_DESC_SIZE))
-		nutrs = ufs_params.desc_size / UFS_DESC_SIZE;
+	if (nutrs > ((ufs_params.desc_size - UFS_UTRL_SIZE) / UFS_DESC_SIZE))
+		nutrs = (ufs_params.desc_size - UFS_UTRL_SIZE) / UFS_DESC_SIZE;
+	slots_reserved = 0;
+
+	ucd_size = ((ufs_params.desc_size - UFS_UTRL_SIZE) / nutrs) &
+		   ~(UFS_DESC_SIZE - 1);
+	if (ucd_size > MAX_UCD_SIZE)
+		ucd_size = MAX_UCD_SIZE;
+
+	/* PRDTL is a 16-bit count of double words too */
+	max_xfer_size = (ucd_size - PRDT_OFFSET) / sizeof(prdt_t);
+	if (max_xfer_size > (UINT16_MAX / (sizeof(prdt_t) >> 2)))
+		max_xfer_size = UINT16_MAX / (sizeof(prdt_t) >> 2);
+	max_xfer_size *= MAX_PRDT_SIZE;
+	if (max_xfer_size > MAX_CMD_XFER_SIZE)
+		max_xfer_size = MAX_CMD_XFER_SIZE;
+
+	memset((void *)base, 0, UFS_UTRL_SIZE);
+	flush_dcache_range(base, UFS_UTRL_SIZE);
+
+	mmio_write_32(ufs_params.reg_base + UTRLRSR, 0);
+	mmio_write_32(ufs_params.reg_base + UTRLBA, base & UINT32_MAX);
+	mmio_write_32(ufs_params.reg_base + UTRLBAU,
+		      (base >> 32) & UINT32_MAX);
+}
+
+static void ufs_enum(void)
+{
+	unsigned int blk_num, blk_size;
+	int i;
 
 	ufs_verify_init();
 	ufs_verify_ready();
@@ -738,7 +891,8 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 	assert((params != NULL) &&
 	       (params->reg_base != 0) &&
 	       (params->desc_base != 0) &&
-	       (params->desc_size >= UFS_DESC_SIZE));
+	       ((params->desc_base & (UFS_UTRL_SIZE - 1)) == 0) &&
+	       (params->desc_size >= UFS_MIN_DESC_SIZE));
 
 	memcpy(&ufs_params, params, sizeof(ufs_params_t));
 
@@ -766,6 +920,8 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 		result = ufshc_dme_get(0x1568, 0, &data);
 		assert(result == 0);
 		assert((data > 0) && (data <= 3));
+
+		ufs_utrl_init();
 	} else {
 		assert((ops != NULL) && (ops->phy_init != NULL) &&
 		       (ops->phy_set_pwr_mode != NULL));
@@ -775,6 +931,7 @@ int ufs_init(const ufs_ops_t *ops, ufs_params_t *params)
 		result = ufshc_link_startup(ufs_params.reg_base);
 		assert(result == 0);
 
+		ufs_utrl_init();
 		ufs_enum();
 
 		ufs_get_device_info(&card);
@@ -7,6 +7,17 @@
 #ifndef BL2_H
 #define BL2_H
 
+/*
+ * Image loaded by the benchmark of the loading path (BL2_IO_BENCHMARK=1). The
+ * image is decompressed after it is loaded if BL2_IO_BENCH_COMPRESSED is set.
+ */
+#define BL2_IO_BENCH_COMPRESSED		(1U << 0)
+
+typedef struct bl2_io_bench_image {
+	unsigned int image_id;
+	unsigned int flags;
+} bl2_io_bench_image_t;
+
 void bl2_main(void);
 
 #endif /* BL2_H */
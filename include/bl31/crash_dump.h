@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CRASH_DUMP_H
+#define CRASH_DUMP_H
+
+#include <utils_def.h>
+
+/*
+ * Layout of the crash records written by BL31 with CRASH_DUMP_TO_MEMORY=1.
+ *
+ * The platform reserves PLAT_CRASH_DUMP_SIZE bytes of memory at
+ * PLAT_CRASH_DUMP_BASE, which hold one record of CRASH_DUMP_RECORD_SIZE bytes
+ * per CPU, in the order of the core positions. The region must be mapped in
+ * BL31 and preserved across a reset so that the next boot can collect the
+ * records. All the fields are 64-bit wide. The magic and version field is
+ * written last, so a record is only valid when it matches CRASH_DUMP_MAGIC and
+ * CRASH_DUMP_VERSION. The collector clears it once the record has been read.
+ *
+ * The system registers are in the order of the crash console output. The CPU
+ * specific registers are the ones reported by the cpu_reg_dump handler of the
+ * cpu_ops matching the MIDR of the record, up to CRASH_DUMP_CPU_REGS_MAX.
+ */
+#define CRASH_DUMP_MAGIC		U(0x48535243)	/* "CRSH" */
+#define CRASH_DUMP_VERSION		U(1)
+
+/* Values of the reason field */
+#define CRASH_DUMP_REASON_PANIC		U(0)
+#define CRASH_DUMP_REASON_EXCEPTION	U(1)
+#define CRASH_DUMP_REASON_INTERRUPT	U(2)
+
+#define CRASH_DUMP_EL3_SYSREGS_COUNT	U(11)
+#define CRASH_DUMP_NON_EL3_SYSREGS_COUNT	U(35)
+#define CRASH_DUMP_CPU_REGS_MAX		U(8)
+
+/* Offsets of the fields of a record */
+#define CRASH_DUMP_MAGIC_VERSION	U(0x0)	/* Magic in the low 32 bits */
+#define CRASH_DUMP_REASON		U(0x8)
+#define CRASH_DUMP_MPIDR		U(0x10)
+#define CRASH_DUMP_MIDR			U(0x18)
+#define CRASH_DUMP_TIMESTAMP		U(0x20)	/* CNTPCT_EL0 */
+#define CRASH_DUMP_GPREGS		U(0x30)	/* x0 - x30 */
+#define CRASH_DUMP_EL3_SYSREGS		U(0x128)
+#define CRASH_DUMP_NON_EL3_SYSREGS	U(0x180)
+#define CRASH_DUMP_CPU_REGS		U(0x298)
+#define CRASH_DUMP_END			U(0x2d8)
+
+/* Records are aligned to a cache line so that they can be cleaned apart */
+#define CRASH_DUMP_RECORD_SIZE		U(0x300)
+
+#ifndef __ASSEMBLY__
+
+#include <cassert.h>
+#include <stdint.h>
+
+typedef struct crash_dump_record {
+	uint64_t magic_version;
+	uint64_t reason;
+	uint64_t mpidr;
+	uint64_t midr;
+	uint64_t timestamp;
+	uint64_t reserved;
+	uint64_t gpregs[31];
+	uint64_t el3_sysregs[CRASH_DUMP_EL3_SYSREGS_COUNT];
+	uint64_t non_el3_sysregs[CRASH_DUMP_NON_EL3_SYSREGS_COUNT];
+	uint64_t cpu_regs[CRASH_DUMP_CPU_REGS_MAX];
+} crash_dump_record_t;
+
+CASSERT(CRASH_DUMP_GPREGS == __builtin_offsetof(crash_dump_record_t, gpregs),
+	assert_crash_dump_gpregs_offset_mismatch);
+CASSERT(CRASH_DUMP_EL3_SYSREGS ==
+	__builtin_offsetof(crash_dump_record_t, el3_sysregs),
+	assert_crash_dump_el3_sysregs_offset_mismatch);
+CASSERT(CRASH_DUMP_NON_EL3_SYSREGS ==
+	__builtin_offsetof(crash_dump_record_t, non_el3_sysregs),
+	assert_crash_dump_non_el3_sysregs_offset_mismatch);
+CASSERT(CRASH_DUMP_CPU_REGS ==
+	__builtin_offsetof(crash_dump_record_t, cpu_regs),
+	assert_crash_dump_cpu_regs_offset_mismatch);
+CASSERT(CRASH_DUMP_END == sizeof(crash_dump_record_t),
+	assert_crash_dump_size_mismatch);
+CASSERT(CRASH_DUMP_END <= CRASH_DUMP_RECORD_SIZE,
+	assert_crash_dump_record_size);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* CRASH_DUMP_H */
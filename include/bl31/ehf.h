@@ -59,6 +59,11 @@ typedef struct {
 
 	/* Non-secure priority mask value stashed during Secure execution */
 	uint8_t ns_pri_mask;
+
+#if EL3_EXCEPTION_PMR_TRACKING
+	/* Priority mask value programmed for the highest active priority */
+	uint8_t pri_mask;
+#endif
 } __aligned(sizeof(uint64_t)) pe_exc_data_t;
 
 typedef int (*ehf_handler_t)(uint32_t intr_raw, uint32_t flags, void *handle,
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SECURE_BUDGET_H
+#define SECURE_BUDGET_H
+
+#include <stdint.h>
+
+/*
+ * Time budget of the yielding calls handled by a Secure Payload
+ * (SECURE_TIME_BUDGET=1).
+ *
+ * A dispatcher starts the budget each time it enters S-EL1 to process or
+ * resume a yielding call, and stops it when the call returns to the Non-secure
+ * world. If the call is still running once PLAT_SECURE_BUDGET_US microseconds
+ * have elapsed, the timer interrupt of the platform, an EL3 interrupt, is taken
+ * from S-EL1 however the Secure Payload masks its interrupts. BL31 then calls
+ * the `preempt` function of the dispatcher, which must return to the
+ * Non-secure world with the same protocol as when a Non-secure interrupt
+ * preempts the call.
+ */
+typedef uint64_t (*secure_budget_preempt_t)(void *handle);
+
+void secure_budget_init(void);
+void secure_budget_start(secure_budget_preempt_t preempt);
+void secure_budget_stop(void);
+
+#endif /* SECURE_BUDGET_H */
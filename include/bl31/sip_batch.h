@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SIP_BATCH_H
+#define SIP_BATCH_H
+
+#include <cassert.h>
+#include <runtime_svc.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Batches of SiP calls made by the Normal world with a single SMC
+ * (SIP_BATCH=1).
+ *
+ * The platform reserves a buffer of Non-secure memory, mapped in BL31, that
+ * is split in one area per CPU. A CPU writes the records of the calls it wants
+ * to make at the start of its area, then makes the batch call of the SiP
+ * service, which runs the calls in order through the handler of the service
+ * and writes the values each call returns in X0-X7 back into its record.
+ */
+typedef struct sip_batch_rec {
+	uint64_t smc_fid;
+	uint64_t args[4];	/* X1-X4 */
+	uint64_t ret[8];	/* X0-X7 */
+} sip_batch_rec_t;
+
+CASSERT(sizeof(sip_batch_rec_t) == 104U, assert_sip_batch_rec_size);
+
+/*
+ * Predicate of the SiP service telling whether a call can be batched. A
+ * batched call must only return values in X0-X7: it can't change the state
+ * that the caller returns to, e.g. its entrypoint or execution state.
+ */
+typedef bool (*sip_batch_allowed_t)(uint32_t smc_fid);
+
+/* Error codes of the batch calls */
+#define SIP_BATCH_E_PARAM	(-2)
+#define SIP_BATCH_E_DENIED	(-3)
+
+unsigned int sip_batch_max_records(void);
+int sip_batch_run(uint32_t batch_fid, unsigned int num,
+		  rt_svc_handle_t handler, sip_batch_allowed_t allowed,
+		  void *cookie, u_register_t flags, unsigned int *done);
+
+#endif /* SIP_BATCH_H */
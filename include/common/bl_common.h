@@ -34,6 +34,8 @@
 
 #define IMAGE_ATTRIB_SKIP_LOADING	U(0x02)
 #define IMAGE_ATTRIB_PLAT_SETUP		U(0x04)
+/* The image is left for a later boot stage to load */
+#define IMAGE_ATTRIB_DEFERRED		U(0x08)
 
 #define INVALID_IMAGE_ID		U(0xFFFFFFFF)
 
@@ -85,6 +87,11 @@ IMPORT_SYM(unsigned long, __BL2U_END__,		BL2U_END);
 #elif defined(IMAGE_BL31)
 IMPORT_SYM(unsigned long, __BL31_START__,	BL31_START);
 IMPORT_SYM(unsigned long, __BL31_END__,		BL31_END);
+#if BL31_IN_XIP_MEM
+IMPORT_SYM(unsigned long, __BL31_ROM_END__,	BL31_ROM_END);
+IMPORT_SYM(unsigned long, __BL31_RAM_START__,	BL31_RAM_BASE);
+IMPORT_SYM(unsigned long, __BL31_RAM_END__,	BL31_RAM_LIMIT);
+#endif
 #elif defined(IMAGE_BL32)
 IMPORT_SYM(unsigned long, __BL32_END__,		BL32_END);
 #endif /* IMAGE_BLX */
@@ -124,6 +131,29 @@ typedef struct image_info {
 	uint32_t image_max_size;
 } image_info_t;
 
+/*****************************************************************************
+ * Description of an image loaded in parts by load_auth_split_image(). The
+ * first `head_size` bytes of the image are loaded at the image base, then
+ * `split()` is called to fill in `parts` with the addresses that the rest of
+ * the image is loaded at, in order. The parts must cover the rest of the image
+ * exactly.
+ *****************************************************************************/
+#define IMAGE_SPLIT_MAX_PARTS		U(2)
+
+typedef struct image_part {
+	uintptr_t base;
+	size_t size;
+} image_part_t;
+
+typedef struct image_split {
+	size_t head_size;
+	int (*split)(struct image_split *split, image_info_t *image_data,
+		     size_t image_size);
+	void *cookie;
+	image_part_t parts[IMAGE_SPLIT_MAX_PARTS];
+	unsigned int num_parts;
+} image_split_t;
+
 /*****************************************************************************
  * The image descriptor struct definition.
  *****************************************************************************/
@@ -179,6 +209,11 @@ int is_mem_free(uintptr_t free_base, size_t free_size,
 		uintptr_t addr, size_t size);
 
 int load_auth_image(unsigned int image_id, image_info_t *image_data);
+int load_unauth_image(unsigned int image_id, image_info_t *image_data);
+int load_auth_split_image(unsigned int image_id, image_info_t *image_data,
+			  image_split_t *split);
+int auth_deferred_image(unsigned int image_id, image_info_t *image_data,
+			void **hash, unsigned int *hash_len);
 
 #if TRUSTED_BOARD_BOOT && defined(DYN_DISABLE_AUTH)
 /*
@@ -27,6 +27,24 @@
 #define LOG_LEVEL_INFO			U(40)
 #define LOG_LEVEL_VERBOSE		U(50)
 
+/*
+ * Log modules. The log level of each module can be changed at runtime, see
+ * tf_log_set_module_level(). The messages of a source file are attributed to
+ * the module selected by defining LOG_MODULE before including any header,
+ * for example:
+ *
+ * #define LOG_MODULE LOG_MODULE_PSCI
+ *
+ * and to the generic module otherwise.
+ */
+#define LOG_MODULE_ID_GENERIC		U(0)
+#define LOG_MODULE_ID_PSCI		U(1)
+#define LOG_MODULE_ID_SDEI		U(2)
+#define LOG_MODULE_ID_SPM		U(3)
+#define LOG_MODULE_ID_GIC		U(4)
+#define LOG_MODULE_ID_AUTH		U(5)
+#define LOG_MODULE_COUNT		U(6)
+
 #ifndef __ASSEMBLY__
 #include <cdefs.h>
 #include <console.h>
@@ -45,6 +63,25 @@
 #define LOG_MARKER_INFO			"\x28"	/* 40 */
 #define LOG_MARKER_VERBOSE		"\x32"	/* 50 */
 
+/*
+ * Define Module Markers corresponding to each log module, which are embedded
+ * in the format string after the Log Marker. The generic module has no marker.
+ * A Module Marker has LOG_MODULE_MARKER_BIT set and the module ID in the other
+ * bits.
+ */
+#define LOG_MODULE_MARKER_BIT		U(0x80)
+
+#define LOG_MODULE_GENERIC		""
+#define LOG_MODULE_PSCI			"\x81"	/* 1 */
+#define LOG_MODULE_SDEI			"\x82"	/* 2 */
+#define LOG_MODULE_SPM			"\x83"	/* 3 */
+#define LOG_MODULE_GIC			"\x84"	/* 4 */
+#define LOG_MODULE_AUTH			"\x85"	/* 5 */
+
+#ifndef LOG_MODULE
+#define LOG_MODULE			LOG_MODULE_GENERIC
+#endif
+
 /*
  * If the log output is too low then this macro is used in place of tf_log()
  * below. The intent is to get the compiler to evaluate the function call for
@@ -58,33 +95,33 @@
 	} while (false)
 
 #if LOG_LEVEL >= LOG_LEVEL_ERROR
-# define ERROR(...)	tf_log(LOG_MARKER_ERROR __VA_ARGS__)
+# define ERROR(...)	tf_log(LOG_MARKER_ERROR LOG_MODULE __VA_ARGS__)
 #else
-# define ERROR(...)	no_tf_log(LOG_MARKER_ERROR __VA_ARGS__)
+# define ERROR(...)	no_tf_log(LOG_MARKER_ERROR LOG_MODULE __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_NOTICE
-# define NOTICE(...)	tf_log(LOG_MARKER_NOTICE __VA_ARGS__)
+# define NOTICE(...)	tf_log(LOG_MARKER_NOTICE LOG_MODULE __VA_ARGS__)
 #else
-# define NOTICE(...)	no_tf_log(LOG_MARKER_NOTICE __VA_ARGS__)
+# define NOTICE(...)	no_tf_log(LOG_MARKER_NOTICE LOG_MODULE __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_WARNING
-# define WARN(...)	tf_log(LOG_MARKER_WARNING __VA_ARGS__)
+# define WARN(...)	tf_log(LOG_MARKER_WARNING LOG_MODULE __VA_ARGS__)
 #else
-# define WARN(...)	no_tf_log(LOG_MARKER_WARNING __VA_ARGS__)
+# define WARN(...)	no_tf_log(LOG_MARKER_WARNING LOG_MODULE __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-# define INFO(...)	tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# define INFO(...)	tf_log(LOG_MARKER_INFO LOG_MODULE __VA_ARGS__)
 #else
-# define INFO(...)	no_tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# define INFO(...)	no_tf_log(LOG_MARKER_INFO LOG_MODULE __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-# define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE LOG_MODULE __VA_ARGS__)
 #else
-# define VERBOSE(...)	no_tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# define VERBOSE(...)	no_tf_log(LOG_MARKER_VERBOSE LOG_MODULE __VA_ARGS__)
 #endif
 
 #if ENABLE_BACKTRACE
@@ -107,6 +144,7 @@ void __dead2 __stack_chk_fail(void);
 
 void tf_log(const char *fmt, ...) __printflike(1, 2);
 void tf_log_set_max_level(unsigned int log_level);
+int tf_log_set_module_level(unsigned int module, unsigned int log_level);
 
 #endif /* __ASSEMBLY__ */
 #endif /* DEBUG_H */
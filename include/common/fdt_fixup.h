@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Batched modifications of a Device Tree Blob */
+
+#ifndef FDT_FIXUP_H
+#define FDT_FIXUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * The fixups of a DTB are collected first, with the nodes given by their
+ * offsets in the original DTB, which don't change while fixups are added.
+ * fdt_fixup_apply() then writes the modified DTB in a single pass, instead of
+ * moving the rest of the DTB each time a property or a node is added, as the
+ * libfdt read-write functions do.
+ */
+#ifndef FDT_FIXUP_MAX_PROPS
+#define FDT_FIXUP_MAX_PROPS		32U
+#endif
+
+#ifndef FDT_FIXUP_MAX_NODES
+#define FDT_FIXUP_MAX_NODES		8U
+#endif
+
+/* Maximum total length of the property names not in the original DTB */
+#ifndef FDT_FIXUP_MAX_STRINGS
+#define FDT_FIXUP_MAX_STRINGS		128U
+#endif
+
+/* Handles of the nodes added by fdt_fixup_add_node() */
+#define FDT_FIXUP_NEW_NODE_BASE		0x40000000
+#define FDT_FIXUP_NEW_NODE(_i)		(FDT_FIXUP_NEW_NODE_BASE + (int)(_i))
+
+typedef struct fdt_fixup_prop {
+	int node;
+	uint32_t nameoff;
+	const char *name;
+	/* NULL to delete the property */
+	const void *val;
+	int len;
+	/* Storage of the values set by the typed helpers */
+	uint8_t buf[8];
+	bool done;
+} fdt_fixup_prop_t;
+
+typedef struct fdt_fixup_node {
+	int parent;
+	const char *name;
+} fdt_fixup_node_t;
+
+typedef struct fdt_fixup {
+	const void *fdt;
+	fdt_fixup_prop_t props[FDT_FIXUP_MAX_PROPS];
+	unsigned int num_props;
+	fdt_fixup_node_t nodes[FDT_FIXUP_MAX_NODES];
+	unsigned int num_nodes;
+	char strings[FDT_FIXUP_MAX_STRINGS];
+	unsigned int strings_len;
+	/* First error of the fixups added, reported by fdt_fixup_apply() */
+	int err;
+} fdt_fixup_t;
+
+int fdt_fixup_init(fdt_fixup_t *fx, const void *fdt);
+int fdt_fixup_add_node(fdt_fixup_t *fx, int parent, const char *name);
+int fdt_fixup_setprop(fdt_fixup_t *fx, int node, const char *name,
+		const void *val, int len);
+int fdt_fixup_setprop_u32(fdt_fixup_t *fx, int node, const char *name,
+		uint32_t val);
+int fdt_fixup_setprop_u64(fdt_fixup_t *fx, int node, const char *name,
+		uint64_t val);
+int fdt_fixup_setprop_string(fdt_fixup_t *fx, int node, const char *name,
+		const char *str);
+int fdt_fixup_delprop(fdt_fixup_t *fx, int node, const char *name);
+int fdt_fixup_size(const fdt_fixup_t *fx);
+int fdt_fixup_apply(fdt_fixup_t *fx, void *buf, int bufsize);
+
+#endif /* FDT_FIXUP_H */
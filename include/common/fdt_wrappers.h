@@ -9,9 +9,18 @@
 #ifndef FDT_WRAPPERS_H
 #define FDT_WRAPPERS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* Number of cells, given total length in bytes. Each cell is 4 bytes long */
 #define NCELLS(len) ((len) / 4U)
 
+int fdtw_path_offset(const void *dtb, const char *path);
+int fdtw_node_offset_by_compatible(const void *dtb, const char *compatible);
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle);
+const void *fdtw_getprop(const void *dtb, int node, const char *name,
+		int *lenp);
+void fdtw_cache_invalidate(void);
 int fdtw_read_cells(const void *dtb, int node, const char *prop,
 		unsigned int cells, void *value);
 int fdtw_read_array(const void *dtb, int node, const char *prop,
@@ -16,9 +16,26 @@ typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
 			     uintptr_t *out_buf, size_t out_len,
 			     uintptr_t work_buf, size_t work_len);
 
+/*
+ * Streaming decompressor. Compressed data is passed to update() in chunks, in
+ * order. Each chunk is fully consumed before update() returns, so the caller
+ * can reuse the chunk buffer for the next one.
+ */
+typedef struct stream_decompressor {
+	int (*init)(uintptr_t out_buf, size_t out_len,
+		    uintptr_t work_buf, size_t work_len);
+	int (*update)(uintptr_t in_buf, size_t in_len);
+	int (*finish)(uintptr_t *out_buf);
+} stream_decompressor_t;
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *decompressor);
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  const stream_decompressor_t *decompressor);
+int image_decompress_load(unsigned int image_id, struct image_info *info);
+
 #endif /* IMAGE_DECOMPRESS_H */
@@ -10,6 +10,7 @@
 #include <bl_common.h>		/* to include exception types */
 #include <cassert.h>
 #include <smccc_helpers.h>	/* to include SMCCC definitions */
+#include <spinlock.h>
 #include <utils_def.h>
 
 /*******************************************************************************
@@ -31,6 +32,23 @@
 #endif /* AARCH32 */
 #define SIZEOF_RT_SVC_DESC	(U(1) << RT_SVC_SIZE_LOG2)
 
+/*
+ * Constants to allow the assembler access the table of handlers bound to a
+ * single SMC Function ID (see runtime_svc_register_fid()). The table is an
+ * open addressing hash table indexed by (fid ^ (fid >> 24)), which separates
+ * the calls of the different standard services for a given call type.
+ */
+#define RT_SVC_FID_TABLE_SIZE	U(32)
+#define RT_SVC_FID_SIZE_LOG2	U(4)
+#define RT_SVC_FID_FID		U(0)
+#define RT_SVC_FID_FLAGS	U(4)
+#define RT_SVC_FID_HANDLE	U(8)
+#define SIZEOF_RT_SVC_FID	(U(1) << RT_SVC_FID_SIZE_LOG2)
+
+/* Flag of a handler registered with runtime_svc_register_leaf_fid() */
+#define RT_SVC_FID_LEAF_BIT	U(0)
+#define RT_SVC_FID_LEAF		(U(1) << RT_SVC_FID_LEAF_BIT)
+
 
 /*
  * In SMCCC 1.X, the function identifier has 6 bits for the owning entity number
@@ -80,6 +98,35 @@ typedef struct rt_svc_desc {
 	rt_svc_handle_t handle;
 } rt_svc_desc_t;
 
+/*
+ * Part of the initialisation of a runtime service which can be run after the
+ * cold boot, passed to runtime_svc_defer_init(). With RT_SVC_DEFERRED_INIT=1,
+ * it is run on the first CPU brought up by PSCI CPU_ON, or on the first call
+ * of runtime_svc_deferred_ready() if earlier: the service calls it before
+ * using the state set up by the initialisation, e.g. on each of its SMCs.
+ * The `init` function must not be in the __init section.
+ */
+typedef struct rt_svc_deferred {
+	const char *name;
+	rt_svc_init_t init;
+	struct rt_svc_deferred *next;
+	spinlock_t lock;
+	volatile unsigned int state;
+} rt_svc_deferred_t;
+
+#define DEFINE_RT_SVC_DEFERRED(_name, _init)				\
+	rt_svc_deferred_t _name = {					\
+		.name = #_name,						\
+		.init = (_init)						\
+	}
+
+/* Entry of the table of handlers bound to a single SMC Function ID */
+typedef struct rt_svc_fid {
+	uint32_t smc_fid;
+	uint32_t flags;
+	rt_svc_handle_t handle;
+} rt_svc_fid_t;
+
 /*
  * Convenience macros to declare a service descriptor
  */
@@ -143,6 +190,19 @@ CASSERT(RT_SVC_DESC_INIT == __builtin_offsetof(rt_svc_desc_t, init), \
 CASSERT(RT_SVC_DESC_HANDLE == __builtin_offsetof(rt_svc_desc_t, handle), \
 	assert_rt_svc_desc_handle_offset_mismatch);
 
+#if RT_SVC_FID_HANDLERS
+CASSERT((sizeof(rt_svc_fid_t) == SIZEOF_RT_SVC_FID), \
+	assert_sizeof_rt_svc_fid_mismatch);
+CASSERT(RT_SVC_FID_FID == __builtin_offsetof(rt_svc_fid_t, smc_fid), \
+	assert_rt_svc_fid_fid_offset_mismatch);
+CASSERT(RT_SVC_FID_FLAGS == __builtin_offsetof(rt_svc_fid_t, flags), \
+	assert_rt_svc_fid_flags_offset_mismatch);
+CASSERT(RT_SVC_FID_HANDLE == __builtin_offsetof(rt_svc_fid_t, handle), \
+	assert_rt_svc_fid_handle_offset_mismatch);
+CASSERT(IS_POWER_OF_TWO(RT_SVC_FID_TABLE_SIZE), \
+	assert_rt_svc_fid_table_size_power_of_two);
+#endif
+
 
 #if SMCCC_MAJOR_VERSION == 1
 /*
@@ -189,6 +249,9 @@ static inline uint32_t get_rt_desc_idx(uint32_t oen, uint32_t is_vendor)
  * Function & variable prototypes
  ******************************************************************************/
 void runtime_svc_init(void);
+void runtime_svc_defer_init(rt_svc_deferred_t *deferred);
+int runtime_svc_deferred_ready(rt_svc_deferred_t *deferred);
+void runtime_svc_deferred_init(void);
 uintptr_t handle_runtime_svc(uint32_t smc_fid, void *cookie, void *handle,
 						unsigned int flags);
 IMPORT_SYM(uintptr_t, __RT_SVC_DESCS_START__,		RT_SVC_DESCS_START);
@@ -197,5 +260,12 @@ void init_crash_reporting(void);
 
 extern uint8_t rt_svc_descs_indices[MAX_RT_SVCS];
 
+#if RT_SVC_FID_HANDLERS
+int runtime_svc_register_fid(uint32_t smc_fid, rt_svc_handle_t handle);
+int runtime_svc_register_leaf_fid(uint32_t smc_fid, rt_svc_handle_t handle);
+
+extern rt_svc_fid_t rt_svc_fid_table[RT_SVC_FID_TABLE_SIZE];
+#endif
+
 #endif /*__ASSEMBLY__*/
 #endif /* RUNTIME_SVC_H */
@@ -90,6 +90,8 @@ typedef enum node_types {
 void ccn_init(const ccn_desc_t *plat_ccn_desc);
 void ccn_enter_snoop_dvm_domain(unsigned long long master_iface_map);
 void ccn_exit_snoop_dvm_domain(unsigned long long master_iface_map);
+void ccn_update_snoop_dvm_domain(unsigned long long enter_iface_map,
+				 unsigned long long exit_iface_map);
 void ccn_enter_dvm_domain(unsigned long long master_iface_map);
 void ccn_exit_dvm_domain(unsigned long long master_iface_map);
 void ccn_set_l3_run_mode(unsigned int mode);
@@ -22,6 +22,31 @@
 /* Constant to categorize LPI interrupt */
 #define MIN_LPI_ID		U(8192)
 
+/* Constants to categorise the GICv3.1 extended PPIs and SPIs */
+#define MIN_EPPI_ID		U(1056)
+#define MAX_EPPI_ID		U(1119)
+#define MIN_ESPI_ID		U(4096)
+#define MAX_ESPI_ID		U(5119)
+
+#define TOTAL_EPPI_INTR_NUM	(MAX_EPPI_ID - MIN_EPPI_ID + U(1))
+#define TOTAL_ESPI_INTR_NUM	(MAX_ESPI_ID - MIN_ESPI_ID + U(1))
+
+/*
+ * Whether an interrupt ID is an extended PPI or SPI. These are only handled by
+ * the driver if GIC_EXT_INTID is set.
+ */
+#define IS_EPPI(id)	((GIC_EXT_INTID != 0) &&			\
+			 ((id) >= MIN_EPPI_ID) && ((id) <= MAX_EPPI_ID))
+#define IS_ESPI(id)	((GIC_EXT_INTID != 0) &&			\
+			 ((id) >= MIN_ESPI_ID) && ((id) <= MAX_ESPI_ID))
+
+/* Whether an interrupt ID is handled by the Redistributor of each CPU */
+#define IS_PCPU_INTR(id)	(((id) < MIN_SPI_ID) || IS_EPPI(id))
+
+/* Whether an interrupt ID is a SGI, PPI or SPI, extended or not */
+#define IS_VALID_INTR_ID(id)	(((id) <= MAX_SPI_ID) || IS_EPPI(id) ||	\
+				 IS_ESPI(id))
+
 /* GICv3 can only target up to 16 PEs with SGI */
 #define GICV3_MAX_SGI_TARGETS	U(16)
 
@@ -41,6 +66,20 @@
 #define GICD_IROUTER		U(0x6000)
 #define GICD_PIDR2_GICV3	U(0xffe8)
 
+/* GICv3.1 Distributor registers of the extended SPIs */
+#define GICD_IGROUPRE		U(0x1000)
+#define GICD_ISENABLERE		U(0x1200)
+#define GICD_ICENABLERE		U(0x1400)
+#define GICD_ISPENDRE		U(0x1600)
+#define GICD_ICPENDRE		U(0x1800)
+#define GICD_ISACTIVERE		U(0x1a00)
+#define GICD_ICACTIVERE		U(0x1c00)
+#define GICD_IPRIORITYRE	U(0x2000)
+#define GICD_ICFGRE		U(0x3000)
+#define GICD_IGRPMODRE		U(0x3400)
+#define GICD_NSACRE		U(0x3600)
+#define GICD_IROUTERE		U(0x8000)
+
 #define IGRPMODR_SHIFT		5
 
 /* GICD_CTLR bit definitions */
@@ -68,6 +107,14 @@
 #define CTLR_E1NWF_BIT			BIT_32(CTLR_E1NWF_SHIFT)
 #define GICD_CTLR_RWP_BIT		BIT_32(GICD_CTLR_RWP_SHIFT)
 
+/* GICD_TYPER shifts and masks */
+#define TYPER_ESPI_SHIFT	8
+#define TYPER_ESPI_RANGE_SHIFT	27
+
+#define TYPER_ESPI_RANGE_MASK	U(0x1f)
+
+#define TYPER_ESPI_BIT		BIT_32(TYPER_ESPI_SHIFT)
+
 /* GICD_IROUTER shifts and masks */
 #define IROUTER_SHIFT		0
 #define IROUTER_IRM_SHIFT	31
@@ -76,13 +123,20 @@
 #define GICV3_IRM_PE		U(0)
 #define GICV3_IRM_ANY		U(1)
 
+/* Values of GICV3_SECURE_SPI_ROUTING */
+#define GICV3_SPI_ROUTING_BOOT_PE	0
+#define GICV3_SPI_ROUTING_ROUND_ROBIN	1
+#define GICV3_SPI_ROUTING_1_OF_N	2
+
 #define NUM_OF_DIST_REGS	30
 
 /*******************************************************************************
  * GICv3 Re-distributor interface registers & constants
  ******************************************************************************/
 #define GICR_PCPUBASE_SHIFT	0x11
+#define GICR_V4_PCPUBASE_SHIFT	0x12
 #define GICR_SGIBASE_OFFSET	U(65536)	/* 64 KB */
+#define GICR_VLPIBASE_OFFSET	U(131072)	/* 128 KB */
 #define GICR_CTLR		U(0x0)
 #define GICR_TYPER		U(0x08)
 #define GICR_WAKER		U(0x14)
@@ -100,6 +154,8 @@
 #define GICR_ICFGR1		(GICR_SGIBASE_OFFSET + U(0xc04))
 #define GICR_IGRPMODR0		(GICR_SGIBASE_OFFSET + U(0xd00))
 #define GICR_NSACR		(GICR_SGIBASE_OFFSET + U(0xe00))
+#define GICR_VPROPBASER		(GICR_VLPIBASE_OFFSET + U(0x70))
+#define GICR_VPENDBASER		(GICR_VLPIBASE_OFFSET + U(0x78))
 
 /* GICR_CTLR bit definitions */
 #define GICR_CTLR_UWP_SHIFT	31
@@ -110,6 +166,10 @@
 #define GICR_CTLR_RWP_BIT	BIT_32(GICR_CTLR_RWP_SHIFT)
 #define GICR_CTLR_EN_LPIS_BIT	BIT_32(0)
 
+/* GICR_VPENDBASER bit definitions */
+#define GICR_VPENDBASER_VALID_BIT	BIT_64(63)
+#define GICR_VPENDBASER_DIRTY_BIT	BIT_64(60)
+
 /* GICR_WAKER bit definitions */
 #define WAKER_CA_SHIFT		2
 #define WAKER_PS_SHIFT		1
@@ -124,12 +184,16 @@
 #define TYPER_AFF_VAL_SHIFT	32
 #define TYPER_PROC_NUM_SHIFT	8
 #define TYPER_LAST_SHIFT	4
+#define TYPER_VLPIS_SHIFT	1
+#define TYPER_PPI_NUM_SHIFT	27
 
 #define TYPER_AFF_VAL_MASK	U(0xffffffff)
 #define TYPER_PROC_NUM_MASK	U(0xffff)
 #define TYPER_LAST_MASK		U(0x1)
+#define TYPER_PPI_NUM_MASK	U(0x1f)
 
 #define TYPER_LAST_BIT		BIT_32(TYPER_LAST_SHIFT)
+#define TYPER_VLPIS_BIT		BIT_32(TYPER_VLPIS_SHIFT)
 
 #define NUM_OF_REDIST_REGS	30
 
@@ -262,6 +326,13 @@ static inline void gicv3_end_of_interrupt(unsigned int id)
 #define GICR_NUM_REGS(reg_name)	\
 	DIV_ROUND_UP_2EVAL(TOTAL_PCPU_INTR_NUM, (1 << reg_name ## _SHIFT))
 
+/* Same for the registers of the extended SPIs and PPIs */
+#define GICD_NUM_EREGS(reg_name)	\
+	DIV_ROUND_UP_2EVAL(TOTAL_ESPI_INTR_NUM, (1 << reg_name ## _SHIFT))
+
+#define GICR_NUM_EREGS(reg_name)	\
+	DIV_ROUND_UP_2EVAL(TOTAL_EPPI_INTR_NUM, (1 << reg_name ## _SHIFT))
+
 /* Interrupt ID mask for HPPIR, AHPPIR, IAR and AIAR CPU Interface registers */
 #define INT_ID_MASK	U(0xffffff)
 
@@ -321,6 +392,10 @@ typedef struct gicv3_redist_ctx {
 	uint64_t gicr_propbaser;
 	uint64_t gicr_pendbaser;
 
+	/* GICv4 virtual LPI registers, only valid if GICR_TYPER.VLPIS is set */
+	uint64_t gicr_vpropbaser;
+	uint64_t gicr_vpendbaser;
+
 	/* 32 bits registers */
 	uint32_t gicr_ctlr;
 	uint32_t gicr_igroupr0;
@@ -332,6 +407,20 @@ typedef struct gicv3_redist_ctx {
 	uint32_t gicr_icfgr1;
 	uint32_t gicr_igrpmodr0;
 	uint32_t gicr_nsacr;
+
+#if GIC_EXT_INTID
+	/* Registers of the extended PPIs, if GICR_TYPER.PPInum is not 0 */
+	uint32_t gicr_igroupre[GICR_NUM_EREGS(IGROUPR)];
+	uint32_t gicr_isenablere[GICR_NUM_EREGS(ISENABLER)];
+	uint32_t gicr_ispendre[GICR_NUM_EREGS(ISPENDR)];
+	uint32_t gicr_isactivere[GICR_NUM_EREGS(ISACTIVER)];
+	uint32_t gicr_ipriorityre[GICR_NUM_EREGS(IPRIORITYR)];
+	uint32_t gicr_icfgre[GICR_NUM_EREGS(ICFGR)];
+	uint32_t gicr_igrpmodre[GICR_NUM_EREGS(IGRPMODR)];
+#endif
+
+	/* Redistributor the Secure configuration registers were saved from */
+	unsigned int cfg_proc_num;
 } gicv3_redist_ctx_t;
 
 typedef struct gicv3_dist_ctx {
@@ -348,6 +437,19 @@ typedef struct gicv3_dist_ctx {
 	uint32_t gicd_icfgr[GICD_NUM_REGS(ICFGR)];
 	uint32_t gicd_igrpmodr[GICD_NUM_REGS(IGRPMODR)];
 	uint32_t gicd_nsacr[GICD_NUM_REGS(NSACR)];
+
+#if GIC_EXT_INTID
+	/* Registers of the extended SPIs, if GICD_TYPER.ESPI is set */
+	uint64_t gicd_iroutere[TOTAL_ESPI_INTR_NUM];
+	uint32_t gicd_igroupre[GICD_NUM_EREGS(IGROUPR)];
+	uint32_t gicd_isenablere[GICD_NUM_EREGS(ISENABLER)];
+	uint32_t gicd_ispendre[GICD_NUM_EREGS(ISPENDR)];
+	uint32_t gicd_isactivere[GICD_NUM_EREGS(ISACTIVER)];
+	uint32_t gicd_ipriorityre[GICD_NUM_EREGS(IPRIORITYR)];
+	uint32_t gicd_icfgre[GICD_NUM_EREGS(ICFGR)];
+	uint32_t gicd_igrpmodre[GICD_NUM_EREGS(IGRPMODR)];
+	uint32_t gicd_nsacre[GICD_NUM_EREGS(NSACR)];
+#endif
 } gicv3_dist_ctx_t;
 
 typedef struct gicv3_its_ctx {
@@ -367,6 +469,8 @@ void gicv3_driver_init(const gicv3_driver_data_t *plat_driver_data);
 void gicv3_distif_init(void);
 void gicv3_rdistif_init(unsigned int proc_num);
 void gicv3_rdistif_on(unsigned int proc_num);
+void gicv3_rdistif_on_start(unsigned int proc_num);
+void gicv3_rdistif_on_wait(unsigned int proc_num);
 void gicv3_rdistif_off(unsigned int proc_num);
 void gicv3_cpuif_enable(unsigned int proc_num);
 void gicv3_cpuif_disable(unsigned int proc_num);
@@ -400,6 +504,10 @@ void gicv3_set_interrupt_type(unsigned int id, unsigned int proc_num,
 void gicv3_raise_secure_g0_sgi(unsigned int sgi_num, u_register_t target);
 void gicv3_set_spi_routing(unsigned int id, unsigned int irm,
 		u_register_t mpidr);
+void gicv3_route_secure_spis(unsigned int irm, const u_register_t *mpidrs,
+		unsigned int mpidr_num);
+void gicv3_reroute_secure_spis(u_register_t mpidr, const u_register_t *mpidrs,
+		unsigned int mpidr_num);
 void gicv3_set_interrupt_pending(unsigned int id, unsigned int proc_num);
 void gicv3_clear_interrupt_pending(unsigned int id, unsigned int proc_num);
 unsigned int gicv3_set_pmr(unsigned int mask);
@@ -7,21 +7,142 @@
 #ifndef SMMU_V3_H
 #define SMMU_V3_H
 
-#include <stdint.h>
 #include <utils_def.h>
 
 /* SMMUv3 register offsets from device base */
+#define SMMU_IDR1	U(0x0004)
 #define SMMU_S_IDR1	U(0x8004)
+#define SMMU_S_CR0	U(0x8020)
+#define SMMU_S_CR0ACK	U(0x8024)
+#define SMMU_S_CR1	U(0x8028)
 #define SMMU_S_INIT	U(0x803c)
+#define SMMU_S_STRTAB_BASE	U(0x8080)
+#define SMMU_S_STRTAB_BASE_CFG	U(0x8088)
+#define SMMU_S_CMDQ_BASE	U(0x8090)
+#define SMMU_S_CMDQ_PROD	U(0x8098)
+#define SMMU_S_CMDQ_CONS	U(0x809c)
+
+/* SMMU_IDR1 register fields */
+#define SMMU_IDR1_CMDQS_SHIFT	21
+#define SMMU_IDR1_CMDQS_MASK	U(0x1f)
 
 /* SMMU_S_IDR1 register fields */
 #define SMMU_S_IDR1_SECURE_IMPL_SHIFT	31
 #define SMMU_S_IDR1_SECURE_IMPL_MASK	U(0x1)
+#define SMMU_S_IDR1_SEL2_SHIFT		29
+#define SMMU_S_IDR1_SEL2_MASK		U(0x1)
+#define SMMU_S_IDR1_S_SIDSIZE_SHIFT	0
+#define SMMU_S_IDR1_S_SIDSIZE_MASK	U(0x3f)
+
+/* SMMU_S_CR0 register fields */
+#define SMMU_S_CR0_SMMUEN		(U(1) << 0)
+#define SMMU_S_CR0_CMDQEN		(U(1) << 3)
+
+/* SMMU_S_CR1 register fields. The cacheability fields are 0: Non-cacheable */
+#define SMMU_S_CR1_QUEUE_SH_SHIFT	4
+#define SMMU_S_CR1_TABLE_SH_SHIFT	10
+#define SMMU_S_CR1_SH_OSH		U(0x2)
 
 /* SMMU_S_INIT register fields */
 #define SMMU_S_INIT_INV_ALL_MASK	U(0x1)
 
+/* SMMU_S_STRTAB_BASE and SMMU_S_CMDQ_BASE register fields */
+#define SMMU_STRTAB_BASE_ADDR_MASK	ULL(0x000fffffffffffc0)
+#define SMMU_CMDQ_BASE_ADDR_MASK	ULL(0x000fffffffffffe0)
+#define SMMU_CMDQ_BASE_LOG2SIZE_MASK	ULL(0x1f)
+
+/* SMMU_S_STRTAB_BASE_CFG register fields. The stream table is linear. */
+#define SMMU_STRTAB_BASE_CFG_LOG2SIZE_MASK	U(0x3f)
+
+/* SMMU_S_CMDQ_PROD and SMMU_S_CMDQ_CONS register fields */
+#define SMMU_CMDQ_CONS_ERR_SHIFT	24
+#define SMMU_CMDQ_CONS_ERR_MASK		U(0x7f)
+
+/* Stream table entries */
+#define SMMU_STE_DWORDS			U(8)
+#define SMMU_STE_SIZE			(SMMU_STE_DWORDS * U(8))
+#define SMMU_STE_0_V			ULL(1)
+#define SMMU_STE_0_CONFIG_SHIFT		1
+#define SMMU_STE_0_CONFIG_ABORT		ULL(0x0)
+#define SMMU_STE_0_CONFIG_BYPASS	ULL(0x4)
+#define SMMU_STE_0_CONFIG_S2		ULL(0x6)
+
+/* Commands */
+#define SMMU_CMD_SIZE			U(16)
+#define SMMU_CMD_CFGI_STE		ULL(0x03)
+#define SMMU_CMD_CFGI_ALL		ULL(0x04)
+#define SMMU_CMD_TLBI_S12_VMALL		ULL(0x28)
+#define SMMU_CMD_TLBI_S2_IPA		ULL(0x2a)
+#define SMMU_CMD_SYNC			ULL(0x46)
+
+#define SMMU_CMD_0_SSEC			(ULL(1) << 10)
+#define SMMU_CMD_0_SID_SHIFT		32
+#define SMMU_CMD_0_VMID_SHIFT		32
+#define SMMU_CMD_1_LEAF			ULL(1)
+#define SMMU_CMD_1_RANGE_ALL		ULL(31)
+#define SMMU_CMD_1_IPA_MASK		ULL(0x000ffffffffff000)
+
+#ifndef __ASSEMBLY__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Secure state of an SMMUv3, for the Secure stream table and command queue
+ * managed by smmuv3_secure_*(). The platform provides the memory of the
+ * queue and of the table, aligned to their size and at least to 64 bytes.
+ */
+typedef struct smmuv3_secure {
+	/* Set by the platform before smmuv3_secure_init() */
+	uintptr_t base;
+	uintptr_t strtab;
+	unsigned int strtab_log2size;	/* Number of STEs, log2 */
+	uintptr_t cmdq;
+	unsigned int cmdq_log2size;	/* Number of commands, log2 */
+
+	/* Set by the driver */
+	uint32_t cmdq_prod;
+	bool sel2;			/* Secure stage 2 is implemented */
+} smmuv3_secure_t;
+
+typedef struct smmuv3_cmd {
+	uint64_t dw[2];
+} smmuv3_cmd_t;
 
 int smmuv3_init(uintptr_t smmu_base);
 
+int smmuv3_secure_init(smmuv3_secure_t *smmu);
+int smmuv3_secure_submit(smmuv3_secure_t *smmu, const smmuv3_cmd_t *cmds,
+			 unsigned int num_cmds);
+int smmuv3_secure_write_ste(smmuv3_secure_t *smmu, unsigned int sid,
+			    const uint64_t *ste);
+int smmuv3_secure_tlbi_s2_range(smmuv3_secure_t *smmu, unsigned int vmid,
+				uint64_t ipa, size_t size);
+
+static inline void smmuv3_cmd_cfgi_ste(smmuv3_cmd_t *cmd, unsigned int sid)
+{
+	cmd->dw[0] = SMMU_CMD_CFGI_STE | SMMU_CMD_0_SSEC |
+		     ((uint64_t)sid << SMMU_CMD_0_SID_SHIFT);
+	cmd->dw[1] = SMMU_CMD_1_LEAF;
+}
+
+static inline void smmuv3_cmd_tlbi_s12_vmall(smmuv3_cmd_t *cmd,
+					     unsigned int vmid)
+{
+	cmd->dw[0] = SMMU_CMD_TLBI_S12_VMALL |
+		     ((uint64_t)(vmid & 0xffffU) << SMMU_CMD_0_VMID_SHIFT);
+	cmd->dw[1] = 0ULL;
+}
+
+static inline void smmuv3_cmd_tlbi_s2_ipa(smmuv3_cmd_t *cmd,
+					  unsigned int vmid, uint64_t ipa)
+{
+	cmd->dw[0] = SMMU_CMD_TLBI_S2_IPA |
+		     ((uint64_t)(vmid & 0xffffU) << SMMU_CMD_0_VMID_SHIFT);
+	cmd->dw[1] = (ipa & SMMU_CMD_1_IPA_MASK) | SMMU_CMD_1_LEAF;
+}
+
+#endif /* __ASSEMBLY__ */
+
 #endif /* SMMU_V3_H */
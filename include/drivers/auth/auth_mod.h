@@ -34,9 +34,16 @@ typedef struct auth_img_desc_s {
 /* Public functions */
 void auth_mod_init(void);
 int auth_mod_get_parent_id(unsigned int img_id, unsigned int *parent_id);
+int auth_mod_get_img_hash(unsigned int img_id, void **hash, unsigned int *len);
 int auth_mod_verify_img(unsigned int img_id,
 			void *img_ptr,
 			unsigned int img_len);
+int auth_mod_verify_img_init(unsigned int img_id);
+int auth_mod_verify_img_update(void *data_ptr, unsigned int data_len);
+int auth_mod_verify_img_finish(unsigned int img_id);
+#if AUTH_CERT_CACHE
+int auth_mod_has_params(unsigned int img_id);
+#endif
 
 /* Macro to register a CoT defined as an array of auth_img_desc_t */
 #define REGISTER_COT(_cot) \
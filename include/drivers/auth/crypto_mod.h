@@ -7,6 +7,9 @@
 #ifndef CRYPTO_MOD_H
 #define CRYPTO_MOD_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* Return values */
 enum crypto_ret_value {
 	CRYPTO_SUCCESS = 0,
@@ -16,6 +19,43 @@ enum crypto_ret_value {
 	CRYPTO_ERR_UNKNOWN
 };
 
+/* Hash algorithms that can be offloaded to a hash engine */
+#define CRYPTO_HASH_SHA256		(1U << 0)
+#define CRYPTO_HASH_SHA384		(1U << 1)
+#define CRYPTO_HASH_SHA512		(1U << 2)
+
+/*
+ * Hash engine descriptor
+ *
+ * A hash engine is a hardware accelerator that computes hashes asynchronously,
+ * typically by fetching the data with DMA from a queue of descriptors. The
+ * crypto library offloads hashes to it when one is registered and it supports
+ * the algorithm. Data passed to submit() has been cleaned from the caches.
+ */
+typedef struct crypto_hash_engine_s {
+	const char *name;
+
+	/* Bitmask of the supported CRYPTO_HASH_* algorithms */
+	unsigned int algs;
+
+	/* Start a new hash with the given CRYPTO_HASH_* algorithm. Return 0
+	 * on success, a negative error code otherwise */
+	int (*start)(unsigned int alg);
+
+	/* Queue the next piece of data to be hashed and return without
+	 * waiting for it to be processed. Return 0 on success, -EBUSY if the
+	 * queue is full or another negative error code */
+	int (*submit)(uintptr_t data, size_t len);
+
+	/* Return 0 once all the queued data has been processed, -EBUSY while
+	 * it is in progress or another negative error code */
+	int (*poll)(void);
+
+	/* Complete the hash once all the data has been processed and copy
+	 * the digest. Return 0 on success, a negative error code otherwise */
+	int (*finish)(void *digest, size_t digest_len);
+} crypto_hash_engine_t;
+
 /*
  * Cryptographic library descriptor
  */
@@ -37,6 +77,21 @@ typedef struct crypto_lib_desc_s {
 	/* Verify a hash. Return one of the 'enum crypto_ret_value' options */
 	int (*verify_hash)(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+
+	/* Verify a hash incrementally (optional). verify_hash_init() sets up
+	 * the comparison with the given hash, verify_hash_update() is then
+	 * called for each consecutive piece of data and verify_hash_finish()
+	 * compares the hashes. Return one of the 'enum crypto_ret_value'
+	 * options */
+	int (*verify_hash_init)(void *digest_info_ptr,
+				unsigned int digest_info_len);
+	int (*verify_hash_update)(void *data_ptr, unsigned int data_len);
+	int (*verify_hash_finish)(void);
+
+	/* Calculate a hash with one of the CRYPTO_HASH_* algorithms
+	 * (optional). Return one of the 'enum crypto_ret_value' options */
+	int (*calc_hash)(unsigned int alg, void *data_ptr,
+			 unsigned int data_len, unsigned char *output);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -47,6 +102,20 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *pk_ptr, unsigned int pk_len);
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len);
+int crypto_mod_verify_hash_init(void *digest_info_ptr,
+				unsigned int digest_info_len);
+int crypto_mod_verify_hash_update(void *data_ptr, unsigned int data_len);
+int crypto_mod_verify_hash_finish(void);
+int crypto_mod_calc_hash(unsigned int alg, void *data_ptr,
+			 unsigned int data_len, unsigned char *output);
+void crypto_mod_register_hash_engine(const crypto_hash_engine_t *engine);
+const crypto_hash_engine_t *crypto_mod_get_hash_engine(unsigned int alg);
+int crypto_mod_hash_engine_submit(const crypto_hash_engine_t *engine,
+				  uintptr_t data, size_t len);
+int crypto_mod_hash_engine_wait(const crypto_hash_engine_t *engine);
+int crypto_mod_hash_engine_calc(const crypto_hash_engine_t *engine,
+				unsigned int alg, uintptr_t data, size_t len,
+				void *digest, size_t digest_len);
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash) \
@@ -57,6 +126,25 @@ int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 		.verify_hash = _verify_hash \
 	}
 
+/*
+ * Macro to register a cryptographic library that also supports incremental
+ * hash verification and hash calculation
+ */
+#define REGISTER_CRYPTO_LIB_INCREMENTAL(_name, _init, _verify_signature, \
+					_verify_hash, _verify_hash_init, \
+					_verify_hash_update, \
+					_verify_hash_finish, _calc_hash) \
+	const crypto_lib_desc_t crypto_lib_desc = { \
+		.name = _name, \
+		.init = _init, \
+		.verify_signature = _verify_signature, \
+		.verify_hash = _verify_hash, \
+		.verify_hash_init = _verify_hash_init, \
+		.verify_hash_update = _verify_hash_update, \
+		.verify_hash_finish = _verify_hash_finish, \
+		.calc_hash = _calc_hash \
+	}
+
 extern const crypto_lib_desc_t crypto_lib_desc;
 
 #endif /* CRYPTO_MOD_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,4 +9,12 @@
 
 void mbedtls_init(void);
 
+#if TF_MBEDTLS_MEASURE_HEAP
+void mbedtls_heap_report(const char *op);
+#else
+static inline void mbedtls_heap_report(const char *op)
+{
+}
+#endif
+
 #endif /* MBEDTLS_COMMON_H */
@@ -12,6 +12,7 @@
 #define TF_MBEDTLS_RSA			1
 #define TF_MBEDTLS_ECDSA		2
 #define TF_MBEDTLS_RSA_AND_ECDSA	3
+#define TF_MBEDTLS_ECDSA_P384		4
 
 /*
  * Hash algorithms currently supported on mbed TLS libraries
@@ -58,6 +59,10 @@
 #define MBEDTLS_ECDSA_C
 #define MBEDTLS_ECP_C
 #define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA_P384)
+#define MBEDTLS_ECDSA_C
+#define MBEDTLS_ECP_C
+#define MBEDTLS_ECP_DP_SECP384R1_ENABLED
 #elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
 #define MBEDTLS_RSA_C
 #define MBEDTLS_X509_RSASSA_PSS_SUPPORT
@@ -94,10 +99,13 @@
 
 /*
  * Determine Mbed TLS heap size
+ * 16384 = 16*1024
  * 13312 = 13*1024
  * 7168 = 7*1024
  */
-#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA) \
+#if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA_P384)
+#define TF_MBEDTLS_HEAP_SIZE		U(16384)
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA) \
 	|| (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA_AND_ECDSA)
 #define TF_MBEDTLS_HEAP_SIZE		U(13312)
 #elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef QUEUE_HASH_ENGINE_H
+#define QUEUE_HASH_ENGINE_H
+
+#include <utils_def.h>
+
+/*
+ * Register map of a generic hash engine fed through a ring of DMA descriptors.
+ * Drivers for real hash accelerators can be derived from this one by adapting
+ * the register map and the descriptor format.
+ */
+#define QHE_CTRL_OFF			UL(0x000)
+#define QHE_STATUS_OFF			UL(0x004)
+#define QHE_QBASE_LO_OFF		UL(0x008)
+#define QHE_QBASE_HI_OFF		UL(0x00c)
+#define QHE_QSIZE_OFF			UL(0x010)
+#define QHE_QTAIL_OFF			UL(0x014)
+#define QHE_QHEAD_OFF			UL(0x018)
+#define QHE_FINAL_OFF			UL(0x01c)
+#define QHE_DIGEST_OFF			UL(0x040)
+
+/* Register field definitions */
+#define QHE_CTRL_ENABLE			(U(1) << 0)
+#define QHE_CTRL_RESET			(U(1) << 1)
+#define QHE_CTRL_ALG_SHIFT		U(4)
+#define QHE_CTRL_ALG_MASK		(U(3) << QHE_CTRL_ALG_SHIFT)
+#define QHE_CTRL_ALG_SHA256		(U(0) << QHE_CTRL_ALG_SHIFT)
+#define QHE_CTRL_ALG_SHA384		(U(1) << QHE_CTRL_ALG_SHIFT)
+#define QHE_CTRL_ALG_SHA512		(U(2) << QHE_CTRL_ALG_SHIFT)
+
+#define QHE_STATUS_BUSY			(U(1) << 0)
+#define QHE_STATUS_ERROR		(U(1) << 1)
+#define QHE_STATUS_DONE			(U(1) << 2)
+
+#define QHE_FINAL_START			(U(1) << 0)
+
+/* Number of descriptors in the ring */
+#define QHE_QUEUE_DEPTH			U(8)
+
+/* Maximum size of a digest in bytes */
+#define QHE_DIGEST_MAX_SIZE		U(64)
+
+#ifndef __ASSEMBLY__
+
+#include <stdint.h>
+
+/* Public high level API */
+
+void queue_hash_engine_init(uintptr_t base, unsigned int algs);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* QUEUE_HASH_ENGINE_H */
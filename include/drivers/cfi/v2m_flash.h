@@ -7,6 +7,7 @@
 #ifndef V2M_FLASH_H
 #define V2M_FLASH_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* First bus cycle */
@@ -20,6 +21,7 @@
 #define NOR_CMD_BLOCK_ERASE		0x20
 #define NOR_CMD_LOCK_UNLOCK		0x60
 #define NOR_CMD_BLOCK_ERASE_ACK		0xD0
+#define NOR_CMD_BUFFERED_PROGRAM_ACK	0xD0
 
 /* Second bus cycle */
 #define NOR_LOCK_BLOCK			0x01
@@ -35,9 +37,18 @@
 #define NOR_BLS				(1 << 1)
 #define NOR_BWS				(1 << 0)
 
+/*
+ * Write buffer, in 32 bit words. Each chip buffers 32 16 bit words, so a
+ * buffered program covers 128 aligned bytes of the interleaved flash.
+ */
+#define NOR_BUFFER_WORDS		32U
+#define NOR_BUFFER_SIZE			(NOR_BUFFER_WORDS * 4U)
+
 /* Public API */
 void nor_send_cmd(uintptr_t base_addr, unsigned long cmd);
 int nor_word_program(uintptr_t base_addr, unsigned long data);
+int nor_buffered_program(uintptr_t base_addr, const uint32_t *data,
+			 size_t nwords);
 int nor_lock(uintptr_t base_addr);
 int nor_unlock(uintptr_t base_addr);
 int nor_erase(uintptr_t base_addr);
@@ -21,7 +21,13 @@
 #define CONSOLE_FLAG_CRASH		(U(1) << 2)
 /* Bits 3 to 7 reserved for additional scopes in future expansion. */
 #define CONSOLE_FLAG_SCOPE_MASK		((U(1) << 8) - 1)
-/* Bits 8 to 31 reserved for non-scope use in future expansion. */
+/*
+ * A deferred console only outputs the characters drained to it by a memory
+ * console (see memory_console.h), except in crash state where it outputs
+ * characters directly.
+ */
+#define CONSOLE_FLAG_DEFERRED		(U(1) << 8)
+/* Bits 9 to 31 reserved for non-scope use in future expansion. */
 
 /* Returned by getc callbacks when receive FIFO is empty. */
 #define ERROR_NO_PENDING_CHAR		(-1)
@@ -67,6 +73,8 @@ void console_set_scope(console_t *console, unsigned int scope);
 void console_switch_state(unsigned int new_state);
 /* Output a character on all consoles registered for the current state. */
 int console_putc(int c);
+/* Output a character on the deferred consoles registered for current state. */
+int console_deferred_putc(int c);
 /* Read a character (blocking) from any console registered for current state. */
 int console_getc(void);
 /* Flush all consoles registered for the current state. */
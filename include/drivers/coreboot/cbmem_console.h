@@ -11,6 +11,7 @@
 
 #define CONSOLE_T_CBMC_BASE	CONSOLE_T_DRVDATA
 #define CONSOLE_T_CBMC_SIZE	(CONSOLE_T_DRVDATA + REGSZ)
+#define CONSOLE_T_CBMC_CURSOR	(CONSOLE_T_DRVDATA + REGSZ + 4)
 
 #ifndef __ASSEMBLER__
 
@@ -18,6 +19,7 @@ typedef struct {
 	console_t console;
 	uintptr_t base;
 	uint32_t size;
+	uint32_t cursor;
 } console_cbmc_t;
 
 int console_cbmc_register(uintptr_t base, console_cbmc_t *console);
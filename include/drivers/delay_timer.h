@@ -7,6 +7,8 @@
 #ifndef DELAY_TIMER_H
 #define DELAY_TIMER_H
 
+#include <arch_helpers.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /********************************************************************
@@ -23,6 +25,34 @@ typedef struct timer_ops {
 	uint32_t clk_div;
 } timer_ops_t;
 
+/********************************************************************
+ * Timeouts for polling loops. They read the generic timer counter
+ * directly, so a driver can poll a register until a deadline without
+ * calling udelay() on every iteration:
+ *
+ *	uint64_t timeout = timeout_init_us(100);
+ *
+ *	while ((mmio_read_32(reg) & BIT) == 0U) {
+ *		if (timeout_elapsed(timeout))
+ *			return -ETIMEDOUT;
+ *	}
+ ********************************************************************/
+
+static inline uint64_t timeout_cnt_us2cnt(uint32_t us)
+{
+	return ((uint64_t)us * (uint64_t)read_cntfrq_el0()) / 1000000U;
+}
+
+static inline uint64_t timeout_init_us(uint32_t us)
+{
+	return read_cntpct_el0() + timeout_cnt_us2cnt(us);
+}
+
+static inline bool timeout_elapsed(uint64_t expire_cnt)
+{
+	return read_cntpct_el0() > expire_cnt;
+}
+
 void mdelay(uint32_t msec);
 void udelay(uint32_t usec);
 void timer_init(const timer_ops_t *ops_ptr);
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Memory to memory copies offloaded to a DMA engine of the platform, with
+ * DMA_ENGINE=1. The platform driver of the engine registers its operations
+ * with dma_init(). Addresses are physical addresses, which the images using
+ * the engine map with identical virtual addresses.
+ *
+ * The generic code does the cache maintenance of the copies: the source is
+ * cleaned before the engine reads it, and the destination is invalidated
+ * before and after the engine writes it.
+ */
+typedef struct dma_ops {
+	/* Alignment in bytes of the addresses and sizes of the copies, a
+	 * multiple of CACHE_WRITEBACK_GRANULE */
+	size_t align;
+	/* Largest copy in bytes, a multiple of align */
+	size_t max_len;
+
+	/* Start copying `len` bytes from `src` to `dst` and return without
+	 * waiting. Return 0 on success, -EINVAL if the engine can't access the
+	 * buffers or another negative error code */
+	int (*submit)(uintptr_t dst, uintptr_t src, size_t len);
+
+	/* Return 0 once the copy has completed, -EBUSY while it is in
+	 * progress or another negative error code if it failed */
+	int (*poll)(void);
+} dma_ops_t;
+
+void dma_init(const dma_ops_t *ops_ptr);
+int dma_copy_start(uintptr_t dst, uintptr_t src, size_t len);
+int dma_copy_wait(void);
+int dma_copy(uintptr_t dst, uintptr_t src, size_t len);
+
+#endif /* DMA_H */
@@ -19,6 +19,11 @@ typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	/*
+	 * Largest request read directly into the caller's buffer, or 0 to use
+	 * the length of `buffer`.
+	 */
+	size_t		max_direct_read;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
@@ -7,8 +7,11 @@
 #ifndef IO_FIP_H
 #define IO_FIP_H
 
+#include <stdint.h>
+
 struct io_dev_connector;
 
 int register_io_dev_fip(const struct io_dev_connector **dev_con);
+int fip_get_file_location(uintptr_t handle, uint64_t *offset, uint64_t *size);
 
 #endif /* IO_FIP_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2014-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,20 @@
 
 struct io_dev_connector;
 
+/*
+ * Optional device specification of the memmap device, passed to io_dev_open()
+ * in place of NULL when the mapping is backed by a flash controller, e.g. a
+ * QSPI or NOR controller in memory-mapped mode.
+ *
+ * `fast_read_init` switches the controller to its fastest memory-mapped read
+ * mode, e.g. quad or octal DTR fast read. It is called once, by io_dev_init(),
+ * before the images are read. It returns 0 on success; on error the
+ * controller must be left in a working read mode, which is used instead.
+ */
+typedef struct io_memmap_dev_spec {
+	int (*fast_read_init)(void);
+} io_memmap_dev_spec_t;
+
 int register_io_dev_memmap(const struct io_dev_connector **dev_con);
 
 #endif /* IO_MEMMAP_H */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IO_POOL_H
+#define IO_POOL_H
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Pool of statically allocated objects that can be allocated and freed in
+ * constant time, used by the IO layer and its drivers for their entities and
+ * device states. Unlike the object pools of object_pool.h, objects are given
+ * back to the pool when a handle is closed.
+ *
+ * The objects in use are tracked by a bitmap, so a pool holds at most
+ * IO_POOL_MAX_OBJECTS objects.
+ */
+#define IO_POOL_MAX_OBJECTS	32U
+
+typedef struct io_pool {
+	/* Objects back store, its objects size and number */
+	void *const objects;
+	const size_t obj_size;
+	const unsigned int capacity;
+
+	/* Bit N is set if object N is allocated */
+	uint32_t used;
+} io_pool_t;
+
+/* Create a pool out of an array of pre-allocated objects */
+#define IO_POOL_ARRAY(_pool_name, _obj_array)				\
+	io_pool_t _pool_name = {					\
+		.objects = (_obj_array),				\
+		.obj_size = sizeof((_obj_array)[0]),			\
+		.capacity = ARRAY_SIZE(_obj_array),			\
+		.used = 0U,						\
+	}
+
+/*
+ * Allocate an object from a pool and store its index in `index_out`.
+ * Return the address of the object, NULL if the pool is exhausted.
+ */
+static inline void *io_pool_alloc(io_pool_t *pool, unsigned int *index_out)
+{
+	unsigned int index;
+
+	assert(pool->capacity <= IO_POOL_MAX_OBJECTS);
+
+	if (pool->used == (uint32_t)(((uint64_t)1U << pool->capacity) - 1U))
+		return NULL;
+
+	/* Lowest free object */
+	index = (unsigned int)__builtin_ctz(~pool->used);
+	pool->used |= (uint32_t)1U << index;
+
+	if (index_out != NULL)
+		*index_out = index;
+
+	return (char *)pool->objects + (pool->obj_size * index);
+}
+
+/*
+ * Return the index in the pool of the allocated object `obj`, or -ENOENT if
+ * `obj` isn't an allocated object of the pool.
+ */
+static inline int io_pool_index(const io_pool_t *pool, const void *obj)
+{
+	uintptr_t offset = (uintptr_t)obj - (uintptr_t)pool->objects;
+	size_t index;
+
+	if (((uintptr_t)obj < (uintptr_t)pool->objects) ||
+	    ((offset % pool->obj_size) != 0U))
+		return -ENOENT;
+
+	index = offset / pool->obj_size;
+	if ((index >= pool->capacity) ||
+	    ((pool->used & ((uint32_t)1U << index)) == 0U))
+		return -ENOENT;
+
+	return (int)index;
+}
+
+/*
+ * Give the allocated object `obj` back to its pool.
+ * Return 0 on success, -ENOENT if `obj` isn't an allocated object of the pool.
+ */
+static inline int io_pool_free(io_pool_t *pool, const void *obj)
+{
+	int index = io_pool_index(pool, obj);
+
+	if (index < 0)
+		return index;
+
+	pool->used &= ~((uint32_t)1U << (unsigned int)index);
+
+	return 0;
+}
+
+#endif /* IO_POOL_H */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Measured boot event log (MEASURED_BOOT=1), in the crypto agile format of the
+ * TCG PC Client Platform Firmware Profile. The log starts with a
+ * TCG_PCR_EVENT whose event is the Spec ID Event03, which lists the single
+ * hash algorithm used by the log. It is followed by one TCG_PCR_EVENT2 per
+ * image measured by BL2. All the fields are packed and little-endian.
+ */
+
+/* PCR extended with the measurements of all the images */
+#define EVENT_LOG_PCR			0U
+
+/* TCG event types */
+#define EV_POST_CODE			U(0x00000001)
+#define EV_NO_ACTION			U(0x00000003)
+
+/* TCG algorithm identifiers */
+#define TPM_ALG_SHA256			U(0x000B)
+#define TPM_ALG_SHA384			U(0x000C)
+#define TPM_ALG_SHA512			U(0x000D)
+
+#define EVENT_LOG_SPEC_ID_SIGNATURE	"Spec ID Event03"
+
+/* Maximum length of the name of an image in the log, including the NUL */
+#define EVENT_LOG_NAME_MAX		16U
+
+#if MEASURED_BOOT && defined(IMAGE_BL2)
+int event_log_measure(unsigned int img_id, const void *digest_info,
+		      unsigned int digest_info_len);
+void event_log_finish(void);
+#else
+static inline int event_log_measure(unsigned int img_id,
+				    const void *digest_info,
+				    unsigned int digest_info_len)
+{
+	return 0;
+}
+
+static inline void event_log_finish(void)
+{
+}
+#endif
+
+#endif /* EVENT_LOG_H */
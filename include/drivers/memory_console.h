@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MEMORY_CONSOLE_H
+#define MEMORY_CONSOLE_H
+
+#include <console.h>
+#include <platform_def.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Ring of the log of a CPU. `head` is the number of characters written by the
+ * CPU and `tail` the number of characters drained to the deferred consoles.
+ */
+typedef struct console_mem_ring {
+	size_t head;
+	size_t tail;
+} console_mem_ring_t;
+
+typedef struct {
+	console_t console;
+	uintptr_t base;
+	size_t ring_size;
+	console_mem_ring_t ring[PLATFORM_CORE_COUNT];
+} console_mem_t;
+
+/*
+ * Initialize a memory console and register it in the console list. The buffer
+ * at `base` is split into one ring per CPU. The console is registered with
+ * (CONSOLE_FLAG_BOOT | CONSOLE_FLAG_RUNTIME) scope, as it can't be used in the
+ * crash scope. Return 1 on success, 0 on error.
+ */
+int console_mem_register(uintptr_t base, size_t size,
+			 console_mem_t *console);
+
+#endif /* MEMORY_CONSOLE_H */
@@ -7,12 +7,15 @@
 #ifndef MMC_H
 #define MMC_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <utils_def.h>
 
 #define MMC_BLOCK_SIZE			U(512)
 #define MMC_BLOCK_MASK			(MMC_BLOCK_SIZE - U(1))
 #define MMC_BOOT_CLK_RATE		(400 * 1000)
+#define MMC_HS_MAX_CLK_RATE		(52 * 1000 * 1000)
+#define MMC_HS200_MAX_CLK_RATE		(200 * 1000 * 1000)
 
 #define MMC_CMD(_x)			U(_x)
 
@@ -59,6 +62,7 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_SEC_CNT		212
 
 #define PART_CFG_BOOT_PARTITION1_ENABLE	(U(1) << 3)
@@ -74,6 +78,22 @@
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
 
+/* HS_TIMING values, also used to select the host controller timing */
+#define MMC_TIMING_LEGACY		U(0)
+#define MMC_TIMING_HS			U(1)
+#define MMC_TIMING_HS200		U(2)
+#define MMC_TIMING_HS400		U(3)
+
+/* DEVICE_TYPE bits */
+#define MMC_DEVICE_TYPE_HS200_1V8	BIT(4)
+#define MMC_DEVICE_TYPE_HS200_1V2	BIT(5)
+#define MMC_DEVICE_TYPE_HS400_1V8	BIT(6)
+#define MMC_DEVICE_TYPE_HS400_1V2	BIT(7)
+#define MMC_DEVICE_TYPE_HS200		(MMC_DEVICE_TYPE_HS200_1V8 | \
+					 MMC_DEVICE_TYPE_HS200_1V2)
+#define MMC_DEVICE_TYPE_HS400		(MMC_DEVICE_TYPE_HS400_1V8 | \
+					 MMC_DEVICE_TYPE_HS400_1V2)
+
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
 #define EXTCSD_CLR_BITS			(U(2) << 24)
@@ -103,6 +123,11 @@
 #define MMC_STATE_SLP			10
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
+#define MMC_FLAG_HS200			(U(1) << 1)
+#define MMC_FLAG_HS400			(U(1) << 2)
+
+/* Tuning command for HS200 (eMMC) */
+#define MMC_CMD_SEND_TUNING_BLOCK_HS200	MMC_CMD(21)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
@@ -110,6 +135,14 @@
 #define SD_SCR_BUS_WIDTH_1		BIT(8)
 #define SD_SCR_BUS_WIDTH_4		BIT(10)
 
+/* ADMA2 descriptor attributes (SD Host Controller Simplified Spec 1.13.4) */
+#define MMC_ADMA2_ATTR_VALID		BIT(0)
+#define MMC_ADMA2_ATTR_END		BIT(1)
+#define MMC_ADMA2_ATTR_INT		BIT(2)
+#define MMC_ADMA2_ATTR_ACT_TRAN		(U(2) << 4)
+/* Maximum length of one descriptor, encoded as 0 */
+#define MMC_ADMA2_MAX_LEN		U(0x10000)
+
 struct mmc_cmd {
 	unsigned int	cmd_idx;
 	unsigned int	cmd_arg;
@@ -117,6 +150,37 @@ struct mmc_cmd {
 	unsigned int	resp_data[4];
 };
 
+/*
+ * ADMA2 descriptor with 64-bit addressing. A table of these descriptors lets
+ * the host controller scatter a single multi-block transfer to several
+ * buffers.
+ */
+struct mmc_adma2_desc {
+	uint16_t	attr;
+	uint16_t	len;
+	uint32_t	addr_lo;
+	uint32_t	addr_hi;
+};
+
+/* Destination buffer of a scatter/gather read */
+struct mmc_sg_entry {
+	uintptr_t	buf;
+	size_t		size;
+};
+
+/*
+ * set_timing and execute_tuning are optional, but both are needed to use the
+ * HS200 and HS400 modes of eMMC devices. set_timing switches the host
+ * controller to one of the MMC_TIMING_* modes, the bus clock being set
+ * afterwards with set_ios. execute_tuning runs the sampling point tuning
+ * procedure for the current mode, using the given tuning command.
+ *
+ * prepare_adma2 is optional. When it is provided and an ADMA2 descriptor table
+ * has been registered with mmc_adma2_init(), reads are set up by passing it the
+ * address of the descriptor table instead of calling prepare. read is then
+ * called with buf set to 0 and must only wait for the end of the transfer, as
+ * the cache maintenance of the destination buffers is done by the MMC layer.
+ */
 struct mmc_ops {
 	void (*init)(void);
 	int (*send_cmd)(struct mmc_cmd *cmd);
@@ -124,6 +188,9 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	int (*prepare_adma2)(int lba, uintptr_t desc_table, size_t size);
+	int (*set_timing)(unsigned int timing);
+	int (*execute_tuning)(unsigned int cmd_idx);
 };
 
 struct mmc_csd_emmc {
@@ -223,6 +290,8 @@ struct mmc_device_info {
 };
 
 size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size);
+size_t mmc_read_blocks_sg(int lba, const struct mmc_sg_entry *sg,
+			  unsigned int count);
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_erase_blocks(int lba, size_t size);
 size_t mmc_rpmb_read_blocks(int lba, uintptr_t buf, size_t size);
@@ -231,5 +300,6 @@ size_t mmc_rpmb_erase_blocks(int lba, size_t size);
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info);
+void mmc_adma2_init(struct mmc_adma2_desc *table, unsigned int count);
 
 #endif /* MMC_H */
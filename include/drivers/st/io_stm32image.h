@@ -11,6 +11,8 @@
 #include <partition.h>
 
 #define MAX_LBA_SIZE		512
+/* Size of the reads the payload checksum is computed on */
+#define STM32_IMAGE_READ_CHUNK	0x10000U
 #define MAX_PART_NAME_SIZE	(EFI_NAMELEN + 1)
 #define STM32_PART_NUM		(PLAT_PARTITION_MAX_ENTRIES - STM32_TF_A_COPIES)
 
@@ -156,6 +156,11 @@
 #define ID_AA64MMFR0_EL1_PARANGE_SHIFT	U(0)
 #define ID_AA64MMFR0_EL1_PARANGE_MASK	ULL(0xf)
 
+/* ID_AA64ISAR0_EL1 definitions */
+#define ID_AA64ISAR0_TLB_SHIFT	U(56)
+#define ID_AA64ISAR0_TLB_MASK	ULL(0xf)
+#define ID_AA64ISAR0_TLB_RANGE	ULL(0x2)
+
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_GPI_SHIFT	U(28)
 #define ID_AA64ISAR1_GPI_WIDTH	U(4)
@@ -508,6 +513,7 @@
  * TTBR Definitions
  */
 #define TTBR_CNP_BIT		ULL(0x1)
+#define TTBR_ASID_SHIFT		U(48)
 
 /*
  * CTR_EL0 definitions
@@ -525,6 +531,13 @@
 
 #define MAX_CACHE_LINE_SIZE	U(0x800) /* 2KB */
 
+/*
+ * DCZID_EL0 definitions
+ */
+#define DCZID_BS_SHIFT		U(0)
+#define DCZID_BS_MASK		U(0xf)
+#define DCZID_DZP_BIT		U(4)
+
 /* Physical timer control register bit fields shifts and masks */
 #define CNTP_CTL_ENABLE_SHIFT   U(0)
 #define CNTP_CTL_IMASK_SHIFT    U(1)
@@ -599,6 +612,31 @@
 #define TLBI_ADDR_MASK		ULL(0x00000FFFFFFFFFFF)
 #define TLBI_ADDR(x)		(((x) >> TLBI_ADDR_SHIFT) & TLBI_ADDR_MASK)
 
+/*
+ * Operand of the TLB range invalidation instructions of ARMv8.4-TLBI. A range
+ * covers (NUM + 1) * 2^(5 * SCALE + 1) pages of the translation granule TG
+ * starting at the page of BaseADDR.
+ */
+#define TLBI_RANGE_TG_4KB	ULL(1)
+#define TLBI_RANGE_TG_16KB	ULL(2)
+#define TLBI_RANGE_TG_64KB	ULL(3)
+#define TLBI_RANGE_TG_SHIFT	U(46)
+#define TLBI_RANGE_SCALE_SHIFT	U(44)
+#define TLBI_RANGE_SCALE_MAX	U(3)
+#define TLBI_RANGE_NUM_SHIFT	U(39)
+#define TLBI_RANGE_NUM_MASK	ULL(0x1f)
+#define TLBI_RANGE_BADDR_MASK	ULL(0x0000001FFFFFFFFF)
+#define TLBI_RANGE_PAGES_SHIFT(scale)	((U(5) * (scale)) + U(1))
+#define TLBI_RANGE_MAX_PAGES	\
+	((TLBI_RANGE_NUM_MASK + ULL(1)) << \
+	 TLBI_RANGE_PAGES_SHIFT(TLBI_RANGE_SCALE_MAX))
+#define TLBI_RANGE(tg, va, num, scale)					\
+	(((unsigned long long)(tg) << TLBI_RANGE_TG_SHIFT) |		\
+	 ((unsigned long long)(scale) << TLBI_RANGE_SCALE_SHIFT) |	\
+	 (((unsigned long long)(num) & TLBI_RANGE_NUM_MASK) <<		\
+	  TLBI_RANGE_NUM_SHIFT) |						\
+	 (((va) >> TLBI_ADDR_SHIFT) & TLBI_RANGE_BADDR_MASK))
+
 /*******************************************************************************
  * Definitions of register offsets and fields in the CNTCTLBase Frame of the
  * system level implementation of the Generic Timer.
@@ -711,10 +749,15 @@
  ******************************************************************************/
 #define PMBLIMITR_EL1		S3_0_C9_C10_0
 
+/* PMBLIMITR_EL1 definitions */
+#define PMBLIMITR_EL1_E_BIT	(ULL(1) << 0)
+
 /*******************************************************************************
  * Definitions for system register interface to MPAM
  ******************************************************************************/
 #define MPAMIDR_EL1		S3_0_C10_C4_4
+#define MPAM0_EL1		S3_0_C10_C5_1
+#define MPAM1_EL1		S3_0_C10_C5_0
 #define MPAM2_EL2		S3_4_C10_C5_0
 #define MPAMHCR_EL2		S3_4_C10_C4_0
 #define MPAM3_EL3		S3_6_C10_C5_0
@@ -789,6 +832,14 @@
 
 #define MPAMIDR_HAS_HCR_BIT		(ULL(1) << 17)
 
+/* MPAM0_EL1/MPAM1_EL1 fields */
+#define MPAMn_PARTID_I_SHIFT		U(0)
+#define MPAMn_PARTID_D_SHIFT		U(16)
+#define MPAMn_PARTID_MASK		ULL(0xffff)
+#define MPAMn_PMG_I_SHIFT		U(32)
+#define MPAMn_PMG_D_SHIFT		U(40)
+#define MPAMn_PMG_MASK			ULL(0xff)
+
 /*******************************************************************************
  * RAS system registers
  *******************************************************************************/
@@ -124,6 +124,7 @@ DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3)
 DEFINE_SYSOP_TYPE_FUNC(tlbi, alle3is)
 #endif
 DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1)
+DEFINE_SYSOP_TYPE_FUNC(tlbi, vmalle1is)
 
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vaae1is)
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vaale1is)
@@ -137,6 +138,27 @@ DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vae3is)
 DEFINE_SYSOP_TYPE_PARAM_FUNC(tlbi, vale3is)
 #endif
 
+/*
+ * TLB range invalidation instructions of ARMv8.4-TLBI. They are written with
+ * their system instruction encoding so that they can be built with assemblers
+ * that don't know about them. They must only be used on CPUs that implement
+ * them, see ID_AA64ISAR0_EL1.TLB.
+ */
+static inline void tlbirvaae1is(uint64_t v)
+{
+	__asm__ ("sys #0, c8, c2, #3, %0" : : "r" (v));
+}
+
+static inline void tlbirvae2is(uint64_t v)
+{
+	__asm__ ("sys #4, c8, c2, #1, %0" : : "r" (v));
+}
+
+static inline void tlbirvae3is(uint64_t v)
+{
+	__asm__ ("sys #6, c8, c2, #1, %0" : : "r" (v));
+}
+
 /*******************************************************************************
  * Cache maintenance accessor prototypes
  ******************************************************************************/
@@ -166,6 +188,7 @@ void inv_dcache_range(uintptr_t addr, size_t size);
 
 void dcsw_op_louis(u_register_t op_type);
 void dcsw_op_all(u_register_t op_type);
+void dcsw_clean_shared_slice(unsigned int slice, unsigned int nslices);
 
 void disable_mmu_el1(void);
 void disable_mmu_el3(void);
@@ -181,6 +204,7 @@ void disable_mmu_icache_el3(void);
 
 DEFINE_SYSREG_RW_FUNCS(par_el1)
 DEFINE_SYSREG_READ_FUNC(id_pfr1_el1)
+DEFINE_SYSREG_READ_FUNC(id_aa64isar0_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64isar1_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64pfr0_el1)
 DEFINE_SYSREG_READ_FUNC(id_aa64dfr0_el1)
@@ -346,6 +370,8 @@ DEFINE_RENAME_SYSREG_RW_FUNCS(amcntenclr1_el0, AMCNTENCLR1_EL0)
 DEFINE_RENAME_SYSREG_RW_FUNCS(amcntenset1_el0, AMCNTENSET1_EL0)
 
 DEFINE_RENAME_SYSREG_READ_FUNC(mpamidr_el1, MPAMIDR_EL1)
+DEFINE_RENAME_SYSREG_RW_FUNCS(mpam0_el1, MPAM0_EL1)
+DEFINE_RENAME_SYSREG_RW_FUNCS(mpam1_el1, MPAM1_EL1)
 DEFINE_RENAME_SYSREG_RW_FUNCS(mpam3_el3, MPAM3_EL3)
 DEFINE_RENAME_SYSREG_RW_FUNCS(mpam2_el2, MPAM2_EL2)
 DEFINE_RENAME_SYSREG_RW_FUNCS(mpamhcr_el2, MPAMHCR_EL2)
@@ -59,6 +59,19 @@
 #define SMC_SET_GP(_h, _g, _v)					\
 	write_ctx_reg((get_gpregs_ctx(_h)), (_g), (_v))
 
+/*
+ * The general purpose registers of the caller are all saved in its context on
+ * entry in EL3, and restored from it on exit. A handler that takes more
+ * arguments than X1-X4, or returns more results than SMC_RET8(), can access
+ * X0-X17 in place as the uint64_t SMC_REGS(_h)[n], which holds Xn.
+ * SMC_PAYLOAD(_h) is a buffer of SMC_PAYLOAD_MAX_SIZE bytes held by X1-X17,
+ * for SMC64 calls only.
+ */
+#define SMC_REGS(_h)						\
+	(&(get_gpregs_ctx(_h))->_regs[CTX_GPREG_X0 >> DWORD_SHIFT])
+#define SMC_PAYLOAD(_h)		((void *)&SMC_REGS(_h)[1])
+#define SMC_PAYLOAD_MAX_SIZE	(SMCCC_NUM_ARG_REGS * sizeof(uint64_t))
+
 /*
  * Convenience macros to access EL3 context registers using handle provided to
  * SMC handler. These take the offset values defined in context.h
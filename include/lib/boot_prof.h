@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef BOOT_PROF_H
+#define BOOT_PROF_H
+
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Layout of the boot timeline (BOOT_PROFILING=1) at PLAT_BOOT_PROF_BASE. The
+ * memory is shared by BL1, BL2 and BL31: the first boot stage initializes the
+ * header, then each stage appends one entry per event, time-stamped with the
+ * physical count of the system counter. An entry is published by updating
+ * `num_entries` after writing it.
+ */
+#define BOOT_PROF_SIGNATURE		U(0x46525042)	/* "BPRF" */
+#define BOOT_PROF_VERSION		U(1)
+
+/* Boot stages recording the events */
+#define BOOT_PROF_BL1			U(1)
+#define BOOT_PROF_BL2			U(2)
+#define BOOT_PROF_BL31			U(3)
+
+/*
+ * Events. The `id` of an entry is the image ID for the image events, or
+ * BOOT_PROF_NO_ID when decompressing an image loaded beforehand. It is the
+ * index of the runtime service descriptor for the service init events, and
+ * the next image ID or security state for BOOT_PROF_STAGE_EXIT in BL1 and
+ * BL31 respectively. It is BOOT_PROF_NO_ID otherwise.
+ */
+#define BOOT_PROF_STAGE_ENTRY		U(0)
+#define BOOT_PROF_STAGE_EXIT		U(1)
+#define BOOT_PROF_LOAD_START		U(2)
+#define BOOT_PROF_LOAD_END		U(3)
+#define BOOT_PROF_AUTH_START		U(4)
+#define BOOT_PROF_AUTH_END		U(5)
+#define BOOT_PROF_DECOMP_START		U(6)
+#define BOOT_PROF_DECOMP_END		U(7)
+#define BOOT_PROF_SVC_INIT_START	U(8)
+#define BOOT_PROF_SVC_INIT_END		U(9)
+
+#define BOOT_PROF_NO_ID			U(0xffffffff)
+
+#ifndef __ASSEMBLY__
+
+struct boot_prof_hdr {
+	uint32_t signature;
+	uint32_t version;
+	uint32_t max_entries;
+	uint32_t num_entries;
+	/* Number of events not recorded because the timeline was full */
+	uint32_t lost;
+	uint32_t reserved;
+};
+
+struct boot_prof_entry {
+	uint64_t timestamp;
+	uint8_t stage;
+	uint8_t event;
+	uint16_t reserved;
+	uint32_t id;
+};
+
+#if BOOT_PROFILING && \
+	(defined(IMAGE_BL1) || defined(IMAGE_BL2) || defined(IMAGE_BL31))
+void boot_prof_record(unsigned int event, unsigned int id);
+int boot_prof_get_entry(unsigned int index, struct boot_prof_entry *entry,
+		unsigned int *num_entries);
+void boot_prof_rewind(unsigned int num_entries);
+#else
+static inline void boot_prof_record(unsigned int event, unsigned int id)
+{
+}
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* BOOT_PROF_H */
@@ -15,6 +15,10 @@
 #define CLUSTERCFR_EL1		S3_0_C15_C3_0
 #define CLUSTERIDR_EL1		S3_0_C15_C3_1
 #define CLUSTERACTLR_EL1	S3_0_C15_C3_3
+#define CLUSTERTHREADSID_EL1	S3_0_C15_C4_0
+#define CLUSTERACPSID_EL1	S3_0_C15_C4_1
+#define CLUSTERSTASHSID_EL1	S3_0_C15_C4_2
+#define CLUSTERPARTCR_EL1	S3_0_C15_C4_3
 
 /********************************************************************
  * DSU control registers bit fields				    *
@@ -25,6 +29,19 @@
 #define CLUSTERIDR_VAR_BITS	U(4)
 #define CLUSTERCFR_ACP_SHIFT	U(11)
 
+/*
+ * L3 cache partitioning: CLUSTERPARTCR_EL1 has one 4-bit field per scheme ID,
+ * in which bit n allows the scheme ID to allocate into the L3 portion (group)
+ * n. The scheme IDs of the threads, of the ACP and of the stash requests are
+ * programmed in CLUSTERTHREADSID_EL1, CLUSTERACPSID_EL1 and
+ * CLUSTERSTASHSID_EL1.
+ */
+#define DSU_SCHEME_ID_MASK	U(0x7)
+#define DSU_NUM_L3_GROUPS	U(4)
+#define DSU_L3_GROUPS_MASK	U(0xf)
+#define CLUSTERPARTCR_GROUPS(_sid, _groups)				\
+	(((_groups) & DSU_L3_GROUPS_MASK) << ((_sid) * DSU_NUM_L3_GROUPS))
+
 /********************************************************************
  * Masks applied for DSU errata workarounds			    *
  ********************************************************************/
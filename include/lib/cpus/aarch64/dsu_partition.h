@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DSU_PARTITION_H
+#define DSU_PARTITION_H
+
+#include <dsu_def.h>
+#include <stdint.h>
+
+/*
+ * L3 cache partitioning of a DynamIQ Shared Unit (DSU_L3_PARTITIONING=1). The
+ * platform assigns L3 portions to scheme IDs, and a scheme ID to each world.
+ * Whenever a CPU enters a world, its thread scheme ID is switched to the one
+ * of that world, so that the lines it allocates only evict lines from the
+ * portions of that world.
+ */
+typedef struct dsu_partition_config {
+	/* CLUSTERPARTCR_EL1, built with CLUSTERPARTCR_GROUPS() */
+	uint32_t partcr;
+	/* Thread scheme IDs of the Secure and Non-secure worlds */
+	uint8_t secure_sid;
+	uint8_t ns_sid;
+	/* Scheme IDs of the ACP and of the stash requests */
+	uint8_t acp_sid;
+	uint8_t stash_sid;
+} dsu_partition_config_t;
+
+void dsu_partition_setup(void);
+void dsu_world_switch(unsigned int security_state);
+
+#endif /* DSU_PARTITION_H */
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef DCACHE_BATCH_H
+#define DCACHE_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Batch of data cache maintenance operations by VA. The ranges added to a
+ * batch are extended to whole cache lines and merged with the ranges they
+ * overlap or touch, so that no line is maintained twice. The operations are
+ * issued without barriers and dcache_batch_finish() completes them all with a
+ * single DSB, where flush_dcache_range() and clean_dcache_range() issue one
+ * DSB per range.
+ *
+ * A batch is only used by the CPU that initialised it, usually on its stack.
+ * The ranges are only guaranteed to be maintained once dcache_batch_finish()
+ * has returned.
+ */
+
+/* Operations of a batch */
+#define DCACHE_BATCH_FLUSH		U(0)	/* Clean and invalidate */
+#define DCACHE_BATCH_CLEAN		U(1)
+
+/* Number of disjoint ranges held before their operations are issued */
+#define DCACHE_BATCH_MAX_RANGES		U(8)
+
+typedef struct dcache_batch {
+	unsigned int op;
+	unsigned int line_size;
+	unsigned int count;
+	unsigned int issued;
+	struct {
+		uintptr_t base;
+		uintptr_t end;
+	} ranges[DCACHE_BATCH_MAX_RANGES];
+} dcache_batch_t;
+
+void dcache_batch_init(dcache_batch_t *batch, unsigned int op);
+void dcache_batch_add(dcache_batch_t *batch, uintptr_t addr, size_t size);
+void dcache_batch_finish(dcache_batch_t *batch);
+
+#endif /* DCACHE_BATCH_H */
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef EL3_PROF_H
+#define EL3_PROF_H
+
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Sampling profiler of BL31 (EL3_PROFILER=1). Once started on a CPU, the
+ * secure physical timer of that CPU interrupts it every `period` ticks of the
+ * system counter. When the interrupt is taken while BL31 is handling an SMC,
+ * ELR_EL3 is recorded in the sample ring of the CPU. When it is taken from a
+ * lower EL, it is delivered through the EHF at PLAT_EL3_PROF_PRI and only
+ * counted, so that the share of the time spent in BL31 can be computed.
+ */
+
+/* Error codes */
+#define EL3_PROF_E_INVAL		(-2)
+
+/* Maximum number of samples returned by one call of el3_prof_read() */
+#define EL3_PROF_READ_MAX		U(6)
+
+#ifndef __ASSEMBLY__
+
+#if EL3_PROFILER
+void el3_prof_init(void);
+int el3_prof_start(uint64_t period);
+void el3_prof_stop(uint64_t *lower_el_samples, uint64_t *lost_samples);
+unsigned int el3_prof_read(uint64_t *samples, unsigned int max_samples);
+
+/* Called by the FIQ vector of EL3, returns 1 if the sample was taken */
+int el3_prof_sample(uint64_t pc);
+#endif
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* EL3_PROF_H */
@@ -124,6 +124,27 @@
 #define CTX_SYSREGS_END		CTX_TIMER_SYSREGS_OFF
 #endif /* __NS_TIMER_SWITCH__ */
 
+/*
+ * Optional groups of EL1 system registers. The secure payload dispatcher
+ * declares the groups that its secure payload uses with
+ * cm_set_el1_sysregs_groups() and the other groups are left alone when
+ * switching worlds, so the registers keep the Non-secure values.
+ *
+ * The AArch32 registers are only used when EL1 is in AArch32 state. The kernel
+ * registers (CSSELR_EL1, TTBR1_EL1, PAR_EL1 and CONTEXTIDR_EL1) are only used
+ * by an operating system at EL1, not by a partition running at S-EL0 behind a
+ * minimal S-EL1 shim, which can't access them. The registers that keep one
+ * world from interfering with the other (PMCR_EL0 and the NS timer) and the
+ * ones the S-EL1 exception vectors and translation regime depend on are always
+ * switched.
+ */
+#define CTX_EL1_SYSREGS_AARCH32_SHIFT	U(0)
+#define CTX_EL1_SYSREGS_AARCH32		(U(1) << CTX_EL1_SYSREGS_AARCH32_SHIFT)
+#define CTX_EL1_SYSREGS_KERNEL_SHIFT	U(1)
+#define CTX_EL1_SYSREGS_KERNEL		(U(1) << CTX_EL1_SYSREGS_KERNEL_SHIFT)
+#define CTX_EL1_SYSREGS_ALL		(CTX_EL1_SYSREGS_AARCH32 | \
+					 CTX_EL1_SYSREGS_KERNEL)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
  * structure at their correct offsets.
@@ -174,9 +195,17 @@
 #define CTX_FPREGS_END		U(0)
 #endif
 
+/*
+ * The CVE-2018-3639 mitigation state is only needed by the dynamic mitigation,
+ * so there is no need to reserve space for it in the context otherwise.
+ */
 #define CTX_CVE_2018_3639_OFFSET	(CTX_FPREGS_OFFSET + CTX_FPREGS_END)
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 #define CTX_CVE_2018_3639_DISABLE	U(0)
 #define CTX_CVE_2018_3639_END		U(0x10) /* Align to the next 16 byte boundary */
+#else
+#define CTX_CVE_2018_3639_END		U(0)
+#endif
 
 #ifndef __ASSEMBLY__
 
@@ -201,7 +230,9 @@
 #define CTX_FPREG_ALL		(CTX_FPREGS_END >> DWORD_SHIFT)
 #endif
 #define CTX_EL3STATE_ALL	(CTX_EL3STATE_END >> DWORD_SHIFT)
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 #define CTX_CVE_2018_3639_ALL	(CTX_CVE_2018_3639_END >> DWORD_SHIFT)
+#endif
 
 /*
  * AArch64 general purpose register context structure. Usually x0-x18,
@@ -235,7 +266,9 @@ DEFINE_REG_STRUCT(fp_regs, CTX_FPREG_ALL);
 DEFINE_REG_STRUCT(el3_state, CTX_EL3STATE_ALL);
 
 /* Function pointer used by CVE-2018-3639 dynamic mitigation */
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 DEFINE_REG_STRUCT(cve_2018_3639, CTX_CVE_2018_3639_ALL);
+#endif
 
 /*
  * Macros to access members of any of the above structures using their
@@ -261,7 +294,9 @@ typedef struct cpu_context {
 #if CTX_INCLUDE_FPREGS
 	fp_regs_t fpregs_ctx;
 #endif
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 	cve_2018_3639_t cve_2018_3639_ctx;
+#endif
 } cpu_context_t;
 
 /* Macros to access members of the 'cpu_context_t' structure */
@@ -271,7 +306,9 @@ typedef struct cpu_context {
 #endif
 #define get_sysregs_ctx(h)	(&((cpu_context_t *) h)->sysregs_ctx)
 #define get_gpregs_ctx(h)	(&((cpu_context_t *) h)->gpregs_ctx)
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 #define get_cve_2018_3639_ctx(h)	(&((cpu_context_t *) h)->cve_2018_3639_ctx)
+#endif
 
 /*
  * Compile time assertions related to the 'cpu_context' structure to
@@ -288,8 +325,12 @@ CASSERT(CTX_FPREGS_OFFSET == __builtin_offsetof(cpu_context_t, fpregs_ctx), \
 #endif
 CASSERT(CTX_EL3STATE_OFFSET == __builtin_offsetof(cpu_context_t, el3state_ctx), \
 	assert_core_context_el3state_offset_mismatch);
+#if DYNAMIC_WORKAROUND_CVE_2018_3639
 CASSERT(CTX_CVE_2018_3639_OFFSET == __builtin_offsetof(cpu_context_t, cve_2018_3639_ctx), \
 	assert_core_context_cve_2018_3639_offset_mismatch);
+#endif
+CASSERT((CTX_CVE_2018_3639_OFFSET + CTX_CVE_2018_3639_END) ==
+	sizeof(cpu_context_t), assert_core_context_size_mismatch);
 
 /*
  * Helper macro to set the general purpose registers that correspond to
@@ -330,8 +371,8 @@ CASSERT(CTX_CVE_2018_3639_OFFSET == __builtin_offsetof(cpu_context_t, cve_2018_3
 /*******************************************************************************
  * Function prototypes
  ******************************************************************************/
-void el1_sysregs_context_save(el1_sys_regs_t *regs);
-void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_save(el1_sys_regs_t *regs, unsigned int groups);
+void el1_sysregs_context_restore(el1_sys_regs_t *regs, unsigned int groups);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
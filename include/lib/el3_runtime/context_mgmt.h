@@ -32,11 +32,18 @@ void cm_init_my_context(const struct entry_point_info *ep);
 void cm_init_context_by_index(unsigned int cpu_idx,
 			      const struct entry_point_info *ep);
 void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep);
+void cm_setup_context_from(cpu_context_t *ctx, const cpu_context_t *tmpl,
+			   const entry_point_info_t *ep);
 void cm_prepare_el3_exit(uint32_t security_state);
 
 #ifndef AARCH32
+void cm_set_el1_sysregs_groups(unsigned int groups);
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
+#if CTX_INCLUDE_FPREGS
+void cm_fpregs_context_save(uint32_t security_state);
+void cm_fpregs_context_restore(uint32_t security_state);
+#endif
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
 			uintptr_t entrypoint, uint32_t spsr);
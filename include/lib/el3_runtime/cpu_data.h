@@ -16,15 +16,23 @@
 #error "Crash reporting is not supported in AArch32"
 #endif
 #define CPU_DATA_CPU_OPS_PTR		0x0
+#define CPU_DATA_PMF_TS0_OFFSET		0x8
 #define CPU_DATA_CRASH_BUF_OFFSET	0x4
 
 #else /* AARCH32 */
 
 /* Offsets for the cpu_data structure */
-#define CPU_DATA_CRASH_BUF_OFFSET	0x18
+#define CPU_DATA_NS_CONTEXT_OFFSET	0x8
+#define CPU_DATA_CPU_OPS_PTR		0x10
+#define CPU_DATA_PMF_TS0_OFFSET		0x18
+/*
+ * The crash buffer is only used when reporting a crash, so it is kept out of
+ * the cache line of the other fields, which holds everything read by the EL3
+ * exception entry path.
+ */
+#define CPU_DATA_CRASH_BUF_OFFSET	CACHE_WRITEBACK_GRANULE
 /* need enough space in crash buffer to save 8 registers */
 #define CPU_DATA_CRASH_BUF_SIZE		64
-#define CPU_DATA_CPU_OPS_PTR		0x10
 
 #endif /* AARCH32 */
 
@@ -44,7 +52,6 @@
 #if ENABLE_RUNTIME_INSTRUMENTATION
 /* Temporary space to store PMF timestamps from assembly code */
 #define CPU_DATA_PMF_TS_COUNT		1
-#define CPU_DATA_PMF_TS0_OFFSET		CPU_DATA_CRASH_BUF_END
 #define CPU_DATA_PMF_TS0_IDX		0
 #endif
 
@@ -76,6 +83,10 @@
  * It is aligned to the cache line boundary to allow efficient concurrent
  * manipulation of these pointers on different cpus
  *
+ * The frequently used fields come first and must fit in the first cache line,
+ * so that an exception taken to EL3 only touches that line of the structure.
+ * The crash buffer, only used when reporting a crash, starts the next line.
+ *
  * TODO: Add other commonly used variables to this (tf_issues#90)
  *
  * The data structure and the _cpu_data accessors should not be used directly
@@ -87,9 +98,6 @@ typedef struct cpu_data {
 	void *cpu_context[2];
 #endif
 	uintptr_t cpu_ops_ptr;
-#if CRASH_REPORTING
-	u_register_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3];
-#endif
 #if ENABLE_RUNTIME_INSTRUMENTATION
 	uint64_t cpu_data_pmf_ts[CPU_DATA_PMF_TS_COUNT];
 #endif
@@ -100,6 +108,10 @@ typedef struct cpu_data {
 #if defined(IMAGE_BL31) && EL3_EXCEPTION_HANDLING
 	pe_exc_data_t ehf_data;
 #endif
+#if CRASH_REPORTING
+	u_register_t crash_buf[CPU_DATA_CRASH_BUF_SIZE >> 3]
+		__aligned(CACHE_WRITEBACK_GRANULE);
+#endif
 } __aligned(CACHE_WRITEBACK_GRANULE) cpu_data_t;
 
 extern cpu_data_t percpu_data[PLATFORM_CORE_COUNT];
@@ -118,6 +130,12 @@ CASSERT(CPU_DATA_CPU_OPS_PTR == __builtin_offsetof
 		(cpu_data_t, cpu_ops_ptr),
 		assert_cpu_data_cpu_ops_ptr_offset_mismatch);
 
+#ifndef AARCH32
+CASSERT(CPU_DATA_NS_CONTEXT_OFFSET == __builtin_offsetof
+		(cpu_data_t, cpu_context[NON_SECURE]),
+		assert_cpu_data_ns_context_offset_mismatch);
+#endif
+
 #if ENABLE_RUNTIME_INSTRUMENTATION
 CASSERT(CPU_DATA_PMF_TS0_OFFSET == __builtin_offsetof
 		(cpu_data_t, cpu_data_pmf_ts[0]),
@@ -9,6 +9,20 @@
 
 #define __pubsub_start_sym(event)	__pubsub_##event##_start
 #define __pubsub_end_sym(event)		__pubsub_##event##_end
+#define __pubsub_call_sym(event)	__pubsub_##event##_call
+
+/*
+ * With PUBSUB_STATIC_DISPATCH=1, BL31 publishes each event by calling a call
+ * chain instead of iterating its subscribers. The call chain of an event is
+ * built at link time out of one direct call per subscriber, which are placed
+ * between an entry and an exit sequence by the linker script. An event without
+ * subscriber is published by calling the return of its exit sequence.
+ */
+#if PUBSUB_STATIC_DISPATCH && defined(IMAGE_BL31)
+#define PUBSUB_CALL_CHAINS	1
+#else
+#define PUBSUB_CALL_CHAINS	0
+#endif
 
 #ifdef __LINKER__
 
@@ -21,11 +35,44 @@
  * contexts. In linker context, this collects pubsub sections for each event,
  * placing guard symbols around each.
  */
-#define REGISTER_PUBSUB_EVENT(event) \
+#define REGISTER_PUBSUB_SECTIONS(event) \
 	__pubsub_start_sym(event) = .; \
 	KEEP(*(__pubsub_section(event))); \
 	__pubsub_end_sym(event) = .
 
+#define REGISTER_PUBSUB_EVENT(event)	REGISTER_PUBSUB_SECTIONS(event)
+
+#define __pubsub_calls_start_sym(event)	__pubsub_calls_##event##_start
+#define __pubsub_calls_end_sym(event)	__pubsub_calls_##event##_end
+
+/*
+ * Collect the call chain of an event around the direct calls placed by
+ * SUBSCRIBE_TO_EVENT. The last instruction of the exit sequence is the return
+ * of the chain. The linker script places the call chains in an executable
+ * region by including pubsub_events.h with REGISTER_PUBSUB_EVENT redefined
+ * to this macro.
+ */
+#define REGISTER_PUBSUB_CALL_CHAIN(event) \
+	__pubsub_entry_##event = .; \
+	KEEP(*(__pubsub_calls_##event##_entry)); \
+	__pubsub_calls_start_sym(event) = .; \
+	KEEP(*(__pubsub_calls_##event)); \
+	__pubsub_calls_end_sym(event) = .; \
+	KEEP(*(__pubsub_calls_##event##_exit)); \
+	__pubsub_call_sym(event) = (__pubsub_calls_start_sym(event) == \
+			__pubsub_calls_end_sym(event)) ? \
+			(. - 4) : __pubsub_entry_##event
+
+#elif defined(__ASSEMBLY__)
+
+/* For the assembler ... */
+
+/*
+ * In assembler context, REGISTER_PUBSUB_EVENT emits the entry and exit
+ * sequences of the call chain of the event, see pubsub_call_chains.S.
+ */
+#define REGISTER_PUBSUB_EVENT(event)	pubsub_call_chain event
+
 #else /* __LINKER__ */
 
 /* For the compiler ... */
@@ -41,9 +88,16 @@
  * In compiler context, REGISTER_PUBSUB_EVENT declares the per-event symbols
  * exported by the linker required for the other pubsub macros to work.
  */
+#if PUBSUB_CALL_CHAINS
+#define REGISTER_PUBSUB_EVENT(event) \
+	extern pubsub_cb_t __pubsub_start_sym(event)[]; \
+	extern pubsub_cb_t __pubsub_end_sym(event)[]; \
+	void __pubsub_call_sym(event)(const void *arg)
+#else
 #define REGISTER_PUBSUB_EVENT(event) \
 	extern pubsub_cb_t __pubsub_start_sym(event)[]; \
 	extern pubsub_cb_t __pubsub_end_sym(event)[]
+#endif
 
 /*
  * Have the function func called back when the specified event happens. This
@@ -52,9 +106,24 @@
  *
  * The extern declaration is there to satisfy MISRA C-2012 rule 8.4.
  */
+#if PUBSUB_CALL_CHAINS
+/*
+ * The function address is still placed into the pubsub section for
+ * for_each_subscriber, and a direct call to the function is added to the call
+ * chain of the event. The argument of the event is kept in x19 by the chain.
+ */
+#define SUBSCRIBE_TO_EVENT(event, func) \
+	extern pubsub_cb_t __cb_func_##func##event __pubsub_section(event); \
+	pubsub_cb_t __cb_func_##func##event __pubsub_section(event) = (func); \
+	__asm__(".pushsection __pubsub_calls_" #event ", \"ax\", %progbits\n" \
+		"	mov	x0, x19\n" \
+		"	bl	" #func "\n" \
+		".popsection\n")
+#else
 #define SUBSCRIBE_TO_EVENT(event, func) \
 	extern pubsub_cb_t __cb_func_##func##event __pubsub_section(event); \
 	pubsub_cb_t __cb_func_##func##event __pubsub_section(event) = (func)
+#endif
 
 /*
  * Iterate over subscribed handlers for a defined event. 'event' is the name of
@@ -69,6 +138,10 @@
  * Publish a defined event supplying an argument. All subscribed handlers are
  * invoked, but the return value of handlers are ignored for now.
  */
+#if PUBSUB_CALL_CHAINS
+#define PUBLISH_EVENT_ARG(event, arg) \
+	__pubsub_call_sym(event)(arg)
+#else
 #define PUBLISH_EVENT_ARG(event, arg) \
 	do { \
 		pubsub_cb_t *subscriber; \
@@ -76,6 +149,7 @@
 			(*subscriber)(arg); \
 		} \
 	} while (0)
+#endif
 
 /* Publish a defined event with NULL argument */
 #define PUBLISH_EVENT(event)	PUBLISH_EVENT_ARG(event, NULL)
@@ -83,5 +157,5 @@
 /* Subscriber callback type */
 typedef void* (*pubsub_cb_t)(const void *arg);
 
-#endif	/* __LINKER__ */
+#endif	/* __LINKER__, __ASSEMBLY__ */
 #endif /* PUBSUB_H */
@@ -17,6 +17,12 @@
  */
 REGISTER_PUBSUB_EVENT(psci_cpu_on_finish);
 
+/*
+ * Event published before a CPU is powered down via the PSCI CPU OFF API, while
+ * its data cache is still enabled.
+ */
+REGISTER_PUBSUB_EVENT(psci_cpu_off_start);
+
 /*
  * These events are published before/after a CPU has been powered down/up
  * via the PSCI CPU SUSPEND API.
@@ -31,6 +31,19 @@
 CASSERT(AMU_GROUP1_COUNTERS_MASK <= 0xffff, invalid_amu_group1_counters_mask);
 CASSERT(AMU_GROUP1_NR_COUNTERS <= 16, invalid_amu_group1_nr_counters);
 
+/*
+ * PMF time-stamp IDs of the per-world activity statistics (AMU_WORLD_STATS).
+ * Each ID holds, for a CPU, the total increment of a group 0 counter while the
+ * CPU was running a security state: the ID is the group 0 counter index for
+ * the Secure world, plus AMU_STATS_NS_OFFSET for the Non-secure world.
+ */
+#define AMU_STATS_CORE_CYCLES		U(0)
+#define AMU_STATS_CONST_CYCLES		U(1)
+#define AMU_STATS_INST_RETIRED		U(2)
+#define AMU_STATS_MEM_STALL		U(3)
+#define AMU_STATS_NS_OFFSET		U(4)
+#define AMU_STATS_TOTAL_IDS		U(8)
+
 bool amu_supported(void);
 void amu_enable(bool el2_unused);
 
@@ -43,4 +56,7 @@ uint64_t amu_group1_cnt_read(int idx);
 void amu_group1_cnt_write(int idx, uint64_t val);
 void amu_group1_set_evtype(int idx, unsigned int val);
 
+/* Per-world activity statistics */
+void amu_world_switch(unsigned int security_state);
+
 #endif /* AMU_H */
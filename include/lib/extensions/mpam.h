@@ -7,9 +7,26 @@
 #ifndef MPAM_H
 #define MPAM_H
 
+#include <arch.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Value of MPAM0_EL1 and MPAM1_EL1 assigning both the instruction and the data
+ * accesses to the partition `_partid` and the performance monitoring group
+ * `_pmg`.
+ */
+#define MPAM_PARTID_PMG(_partid, _pmg)					\
+	((((uint64_t)(_partid) & MPAMn_PARTID_MASK) << MPAMn_PARTID_I_SHIFT) |\
+	 (((uint64_t)(_partid) & MPAMn_PARTID_MASK) << MPAMn_PARTID_D_SHIFT) |\
+	 (((uint64_t)(_pmg) & MPAMn_PMG_MASK) << MPAMn_PMG_I_SHIFT) |	\
+	 (((uint64_t)(_pmg) & MPAMn_PMG_MASK) << MPAMn_PMG_D_SHIFT))
 
 bool mpam_supported(void);
 void mpam_enable(bool el2_unused);
 
+/* Per-world partitions (MPAM_WORLD_PARTID) */
+void mpam_world_switch(unsigned int security_state);
+void mpam_set_secure_partid(uint64_t partid_pmg);
+
 #endif /* MPAM_H */
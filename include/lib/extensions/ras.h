@@ -153,6 +153,11 @@ struct err_record_info {
 
 	/* Error record access mechanism */
 	unsigned int access:1;
+
+#if RAS_EA_DEFERRED
+	/* System counter value at the last deferred handling of the group */
+	uint64_t last_handled;
+#endif
 };
 
 struct err_record_mapping {
@@ -194,6 +199,9 @@ static inline int ras_err_ser_probe_sysreg(const struct err_record_info *info,
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 void ras_init(void);
+#if RAS_EA_DEFERRED
+int ras_ea_process_deferred(unsigned int security_state);
+#endif
 
 #endif /* __ASSEMBLY__ */
 
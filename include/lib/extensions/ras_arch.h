@@ -162,6 +162,9 @@
 #define EABORT_AET_WIDTH	U(3)
 #define EABORT_AET_MASK		U(0x7)
 
+/* Corrected error type in Asynchronous exception syndrome */
+#define EABORT_AET_CE		U(0x6)
+
 /* DFSC field in Asynchronous exception syndrome */
 #define EABORT_DFSC_SHIFT	U(0)
 #define EABORT_DFSC_WIDTH	U(6)
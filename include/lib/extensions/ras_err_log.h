@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef RAS_ERR_LOG_H
+#define RAS_ERR_LOG_H
+
+/*
+ * Layout of the RAS error log (RAS_ERR_LOG=1), shared with the Non-secure
+ * world at PLAT_RAS_ERR_LOG_BASE. The log starts with a header, followed by
+ * `max_entries` entries. EL3 appends one entry per error record found in
+ * error, then dispatches the PLAT_RAS_ERR_LOG_SDEI_EVENT SDEI event. The
+ * client consumes the first `num_entries` entries and sets `num_entries` back
+ * to 0 before completing the event.
+ */
+#define RAS_ERR_LOG_SIGNATURE		U(0x474c5245)	/* "ERLG" */
+#define RAS_ERR_LOG_VERSION		U(1)
+
+#ifndef __ASSEMBLY__
+
+#include <ras.h>
+#include <stdint.h>
+
+struct ras_err_log_hdr {
+	uint32_t signature;
+	uint32_t version;
+	uint32_t max_entries;
+	uint32_t num_entries;
+	/* Number of errors not logged because the log was full */
+	uint32_t lost;
+	uint32_t reserved;
+};
+
+struct ras_err_log_entry {
+	/* Index of the error record group in the platform error records */
+	uint32_t group;
+	/* Index of the error record in the group */
+	uint32_t record;
+	/* ERR<n>STATUS, ERR<n>ADDR, ERR<n>MISC0 and ERR<n>MISC1 of the record */
+	uint64_t status;
+	uint64_t addr;
+	uint64_t misc0;
+	uint64_t misc1;
+};
+
+int ras_err_log_handler(const struct err_record_info *info, int probe_data,
+		const struct err_handler_data *const data);
+unsigned int ras_err_log_scan(void);
+int ras_err_log_report(unsigned int security_state);
+int ras_err_log_poll(unsigned int security_state);
+
+#endif /* __ASSEMBLY__ */
+
+#endif /* RAS_ERR_LOG_H */
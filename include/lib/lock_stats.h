@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LOCK_STATS_H
+#define LOCK_STATS_H
+
+#include <cdefs.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Contention statistics of the locks of BL31 (ENABLE_LOCK_STATS=1). A lock, or
+ * an array of locks, or an array of structures that embed a lock, is given a
+ * name with REGISTER_LOCK_STATS(). Each time a spin lock or a bakery lock at an
+ * address within the registered object is acquired, the acquisition is counted
+ * and, if the lock was not free, so is the time spent waiting for it, in ticks
+ * of the system counter. The counters are only updated with the lock held.
+ */
+
+/* Error codes */
+#define LOCK_STATS_E_PARAM		(-2)
+
+typedef struct lock_stats {
+	const char *name;
+	uintptr_t base;
+	size_t size;
+	uint64_t acquisitions;
+	uint64_t contended;
+	uint64_t wait_ticks;
+} lock_stats_t;
+
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+
+#define REGISTER_LOCK_STATS(_name, _lock)				\
+	static lock_stats_t lock_stats_ ## _name			\
+		__section("lock_stats") __used = {			\
+		.name = #_name,						\
+		.base = (uintptr_t)&(_lock),				\
+		.size = sizeof(_lock)					\
+	}
+
+void lock_stats_record(const void *lock, bool contended, uint64_t ticks);
+int lock_stats_get(unsigned int index, lock_stats_t *stats,
+		   unsigned int *num_locks);
+
+#else
+
+#define REGISTER_LOCK_STATS(_name, _lock)
+
+#endif
+
+#endif /* LOCK_STATS_H */
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LZ4_H
+#define TF_LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Magic number at the start of an LZ4 frame, stored little-endian */
+#define LZ4_FRAME_MAGIC		0x184D2204U
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+#endif /* TF_LZ4_H */
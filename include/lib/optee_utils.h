@@ -11,5 +11,8 @@
 int parse_optee_header(entry_point_info_t *header_ep,
 	image_info_t *pager_image_info,
 	image_info_t *paged_image_info);
+image_split_t *optee_get_image_split(entry_point_info_t *header_ep,
+	image_info_t *pager_image_info,
+	image_info_t *paged_image_info);
 
 #endif /* OPTEE_UTILS_H */
@@ -35,12 +35,23 @@
 #define PMF_CACHE_MAINT		(U(1) << 0)
 #define PMF_NO_CACHE_MAINT	U(0)
 
+/*
+ * Flag passed to PMF_SMC_GET_TIMESTAMPS to copy all the time-stamp ids of
+ * the service rather than the given one.
+ */
+#define PMF_ALL_TIMESTAMP_IDS	(U(1) << 1)
+
 /*
  * Defines for PMF SMC function ids.
  */
 #define PMF_SMC_GET_TIMESTAMP_32	U(0x82000010)
 #define PMF_SMC_GET_TIMESTAMP_64	U(0xC2000010)
-#define PMF_NUM_SMC_CALLS		2
+#define PMF_SMC_GET_SUSPEND_TRACE	U(0xC2000011)
+#define PMF_SMC_GET_SDEI_STATS		U(0xC2000012)
+#define PMF_SMC_GET_TIMESTAMPS		U(0xC2000013)
+#define PMF_NUM_SMC_CALLS		(2 + ENABLE_PSCI_SUSPEND_TRACE + \
+					 SDEI_EVENT_STATS + \
+					 ENABLE_PMF_BULK_TIMESTAMPS)
 
 /*
  * The macros below are used to identify
@@ -53,6 +64,11 @@
 /* Following are the supported PMF service IDs */
 #define PMF_PSCI_STAT_SVC_ID	0
 #define PMF_RT_INSTR_SVC_ID	1
+#define PMF_SMC_HIST_SVC_ID	2
+#define PMF_TSPD_SVC_ID		3
+#define PMF_AMU_SVC_ID		4
+#define PMF_PLAT_SVC_ID		5	/* Reserved for the platform */
+#define PMF_TLKD_SVC_ID		6
 
 #if ENABLE_PMF
 /*
@@ -131,23 +147,24 @@
 	PMF_REGISTER_SERVICE(_name, _svcid, _totalid, _flags)	\
 	PMF_DEFINE_SERVICE_DESC(_name, PMF_ARM_TIF_IMPL_ID,	\
 			_svcid, _totalid, NULL,			\
-			pmf_get_timestamp_by_mpidr_ ## _name)
+			pmf_get_timestamp_by_mpidr_ ## _name,	\
+			pmf_get_timestamp_by_index_ ## _name)
 
 /*
  * This macro is used to register a PMF service that has an SMC interface
  * but provides its own service-specific PMF functions.
  */
 #define PMF_REGISTER_SERVICE_SMC_OWN(_name, _implid, _svcid, _totalid,	\
-		 _init, _getts)						\
+		 _init, _getts, _getts_by_index)			\
 	PMF_DEFINE_SERVICE_DESC(_name, _implid, _svcid, _totalid,	\
-		 _init, _getts)
+		 _init, _getts, _getts_by_index)
 
 #else
 
 #define PMF_REGISTER_SERVICE(_name, _svcid, _totalid, _flags)
 #define PMF_REGISTER_SERVICE_SMC(_name, _svcid, _totalid, _flags)
 #define PMF_REGISTER_SERVICE_SMC_OWN(_name, _implid, _svcid, _totalid,	\
-				_init, _getts)
+				_init, _getts, _getts_by_index)
 #define PMF_DECLARE_CAPTURE_TIMESTAMP(_name)
 #define PMF_DECLARE_GET_TIMESTAMP(_name)
 #define PMF_CAPTURE_TIMESTAMP(_name, _tid, _flags)
@@ -164,6 +181,11 @@ int pmf_get_timestamp_smc(unsigned int tid,
 		u_register_t mpidr,
 		unsigned int flags,
 		unsigned long long *ts_value);
+int pmf_get_timestamps_smc(unsigned int tid,
+		uintptr_t buf,
+		size_t size,
+		unsigned int flags,
+		unsigned int *count);
 int pmf_setup(void);
 uintptr_t pmf_smc_handler(unsigned int smc_fid,
 		u_register_t x1,
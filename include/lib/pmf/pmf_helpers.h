@@ -21,6 +21,9 @@ typedef int (*pmf_svc_init_t)(void);
 typedef unsigned long long (*pmf_svc_get_ts_t)(unsigned int tid,
 		 u_register_t mpidr,
 		 unsigned int flags);
+typedef unsigned long long (*pmf_svc_get_ts_by_index_t)(unsigned int tid,
+		 unsigned int cpuid,
+		 unsigned int flags);
 
 /*
  * This is the definition of PMF service desc.
@@ -40,6 +43,9 @@ typedef struct pmf_svc_desc {
 
 	/* PMF service time-stamp retrieval handler */
 	pmf_svc_get_ts_t get_ts;
+
+	/* PMF service time-stamp retrieval handler by CPU index, optional */
+	pmf_svc_get_ts_by_index_t get_ts_by_index;
 } pmf_svc_desc_t;
 
 /*
@@ -128,7 +134,7 @@ typedef struct pmf_svc_desc {
  * This is needed for services that require SMC handling.
  */
 #define PMF_DEFINE_SERVICE_DESC(_name, _implid, _svcid, _totalid,	\
-		_init, _getts_by_mpidr) 				\
+		_init, _getts_by_mpidr, _getts_by_index)		\
 	static const pmf_svc_desc_t __pmf_desc_ ## _name 		\
 	__section("pmf_svc_descs") __used = {		 		\
 		.h.type = PARAM_EP, 					\
@@ -143,7 +149,8 @@ typedef struct pmf_svc_desc {
 				(((_totalid) << PMF_TID_SHIFT) &	\
 						PMF_TID_MASK)),		\
 		.init = _init,						\
-		.get_ts = _getts_by_mpidr				\
+		.get_ts = _getts_by_mpidr,				\
+		.get_ts_by_index = _getts_by_index			\
 	};
 
 /* PMF internal functions */
@@ -25,6 +25,13 @@
 #define PSCI_NUM_NON_CPU_PWR_DOMAINS	(PSCI_NUM_PWR_DOMAINS - \
 					 PLATFORM_CORE_COUNT)
 
+/*******************************************************************************
+ * Number of local power states of a power level whose statistics are tracked
+ ******************************************************************************/
+#ifndef PLAT_MAX_PWR_LVL_STATES
+#define PLAT_MAX_PWR_LVL_STATES		2U
+#endif
+
 /* This is the power level corresponding to a CPU */
 #define PSCI_CPU_PWR_LVL	U(0)
 
@@ -58,6 +65,7 @@
 #define PSCI_NODE_HW_STATE_AARCH64	U(0xc400000d)
 #define PSCI_SYSTEM_SUSPEND_AARCH32	U(0x8400000E)
 #define PSCI_SYSTEM_SUSPEND_AARCH64	U(0xc400000E)
+#define PSCI_SET_SUSPEND_MODE		U(0x8400000F)
 #define PSCI_STAT_RESIDENCY_AARCH32	U(0x84000010)
 #define PSCI_STAT_RESIDENCY_AARCH64	U(0xc4000010)
 #define PSCI_STAT_COUNT_AARCH32		U(0x84000011)
@@ -71,8 +79,12 @@
 /*
  * Number of PSCI calls (above) implemented
  */
-#if ENABLE_PSCI_STAT
+#if ENABLE_PSCI_STAT && PSCI_OS_INIT_MODE
+#define PSCI_NUM_CALLS			U(23)
+#elif ENABLE_PSCI_STAT
 #define PSCI_NUM_CALLS			U(22)
+#elif PSCI_OS_INIT_MODE
+#define PSCI_NUM_CALLS			U(19)
 #else
 #define PSCI_NUM_CALLS			U(18)
 #endif
@@ -205,6 +217,15 @@ typedef enum {
 	AFF_STATE_ON_PENDING = U(2)
 } aff_info_state_t;
 
+/*
+ * These are the modes of the PSCI_SET_SUSPEND_MODE API. The definitions of these
+ * modes can be found in Section 5.20 of the PSCI specification (ARM DEN 0022D).
+ */
+typedef enum {
+	PLAT_COORD = U(0),
+	OS_INIT = U(1)
+} suspend_mode_t;
+
 /*
  * These are the power states reported by PSCI_NODE_HW_STATE API for the
  * specified CPU. The definitions of these states can be found in Section 5.15.3
@@ -288,6 +309,16 @@ typedef struct psci_cpu_data {
 	plat_local_state_t local_state;
 } psci_cpu_data_t;
 
+#if ENABLE_PSCI_STAT
+/*******************************************************************************
+ * Residency and number of entries of a local power state of a power domain
+ ******************************************************************************/
+typedef struct psci_stat {
+	u_register_t residency;
+	u_register_t count;
+} psci_stat_t;
+#endif
+
 /*******************************************************************************
  * Structure populated by platform specific code to export routines which
  * perform common low level power management functions
@@ -322,6 +353,10 @@ typedef struct plat_psci_ops {
 	int (*write_mem_protect)(int val);
 	int (*system_reset2)(int is_vendor,
 				int reset_type, u_register_t cookie);
+	u_register_t (*get_pwr_lvl_break_even)(
+				    plat_local_state_t pwr_domain_state,
+				    unsigned int pwrlvl,
+				    plat_local_state_t *demoted_state);
 } plat_psci_ops_t;
 
 /*******************************************************************************
@@ -331,6 +366,11 @@ unsigned int psci_version(void);
 int psci_cpu_on(u_register_t target_cpu,
 		uintptr_t entrypoint,
 		u_register_t context_id);
+int psci_cpu_on_batch(u_register_t target_cpu,
+		      u_register_t cpu_mask,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      u_register_t *on_mask);
 int psci_cpu_suspend(unsigned int power_state,
 		     uintptr_t entrypoint,
 		     u_register_t context_id);
@@ -344,6 +384,13 @@ u_register_t psci_migrate_info_up_cpu(void);
 int psci_node_hw_state(u_register_t target_cpu,
 		       unsigned int power_level);
 int psci_features(unsigned int psci_fid);
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode);
+#endif
+#if ENABLE_PSCI_STAT
+int psci_stat_get_pwr_domain(unsigned int pd_idx, unsigned int *pwr_lvl,
+			     psci_stat_t *stats);
+#endif
 void __dead2 psci_power_down_wfi(void);
 void psci_arch_setup(void);
 
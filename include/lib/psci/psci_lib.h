@@ -88,6 +88,9 @@ void psci_warmboot_entrypoint(void);
 void psci_register_spd_pm_hook(const spd_pm_ops_t *pm);
 void psci_prepare_next_non_secure_ctx(
 			  entry_point_info_t *next_image_info);
+#if PSCI_PRESET_CPU_ON_CONTEXT
+void psci_preset_cpu_on_context(const entry_point_info_t *ns_ep);
+#endif
 #endif /* __ASSEMBLY__ */
 
 #endif /* PSCI_LIB_H */
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PSCI_PREBUILT_TOPOLOGY_H
+#define PSCI_PREBUILT_TOPOLOGY_H
+
+#include <platform_def.h>
+#include <psci.h>
+#include <stdint.h>
+
+/*
+ * Power domain topology of the platform generated at build time by the
+ * topology_gen host tool (PREBUILT_PSCI_TOPOLOGY=1) from the source file given
+ * in BLx_PSCI_TOPOLOGY. The tables hold the power domain tree as populated by
+ * psci_setup() from plat_get_power_domain_tree_desc(), and the direct lookup
+ * of the core index of a MPIDR matching plat_core_pos_by_mpidr().
+ */
+typedef struct psci_prebuilt_pd_node {
+	unsigned int parent_node;
+	int cpu_start_idx;
+	unsigned int ncpus;
+	unsigned char level;
+} psci_prebuilt_pd_node_t;
+
+/* Only the first psci_prebuilt_non_cpu_node_count nodes are in the tree */
+extern const unsigned int psci_prebuilt_non_cpu_node_count;
+extern const psci_prebuilt_pd_node_t
+	psci_prebuilt_non_cpu_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+extern const unsigned int psci_prebuilt_cpu_parent[PLATFORM_CORE_COUNT];
+
+/* MPIDR of each core index, checked against the platform in debug builds */
+extern const u_register_t psci_prebuilt_cpu_mpidr[PLATFORM_CORE_COUNT];
+
+int psci_prebuilt_core_pos_by_mpidr(u_register_t mpidr);
+
+#endif /* PSCI_PREBUILT_TOPOLOGY_H */
@@ -17,9 +17,66 @@
 #define RT_INSTR_EXIT_CFLUSH		U(5)
 #define RT_INSTR_TOTAL_IDS		U(6)
 
+/*
+ * SMC latency histograms. Each SMC is counted in a bucket that depends on its
+ * owning entity and call type, and in the bin of that bucket that holds its
+ * latency: bin N counts the SMCs that took from 2^N to 2^(N+1) - 1 ticks of
+ * the system counter, the last bin counts any longer SMC. The count of a bin
+ * of a CPU is read through the PMF interface using the time-stamp id
+ * (bucket * RT_INSTR_SMC_HIST_BINS + bin).
+ */
+#define RT_INSTR_SMC_BKT_ARM_ARCH	U(0)
+#define RT_INSTR_SMC_BKT_CPU		U(1)
+#define RT_INSTR_SMC_BKT_SIP		U(2)
+#define RT_INSTR_SMC_BKT_OEM		U(3)
+#define RT_INSTR_SMC_BKT_STD		U(4)
+#define RT_INSTR_SMC_BKT_STD_HYP	U(5)
+#define RT_INSTR_SMC_BKT_VEN_HYP	U(6)
+#define RT_INSTR_SMC_BKT_TAP		U(7)
+#define RT_INSTR_SMC_BKT_TOS		U(8)
+#define RT_INSTR_SMC_BKT_YIELD		U(9)
+#define RT_INSTR_SMC_BKT_OTHER		U(10)
+#define RT_INSTR_SMC_HIST_BUCKETS	U(11)
+#define RT_INSTR_SMC_HIST_BINS		U(16)
+#define RT_INSTR_SMC_HIST_TOTAL_IDS	(RT_INSTR_SMC_HIST_BUCKETS * \
+					 RT_INSTR_SMC_HIST_BINS)
+
+/* Number of CPU_SUSPEND calls kept in the suspend trace of each CPU */
+#define RT_INSTR_SUSPEND_TRACE_DEPTH	U(64)
+
 #ifndef __ASSEMBLY__
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Record of a CPU_SUSPEND call in the suspend trace, holding the time-stamps
+ * of the runtime instrumentation for the call. A time-stamp that was not taken
+ * during the call, such as the entry into the low power state of a suspend
+ * that was abandoned, is 0.
+ */
+typedef struct rt_instr_suspend_rec {
+	uint64_t enter_ts;
+	uint64_t hw_low_pwr_ts;
+	uint64_t wake_ts;
+	uint64_t exit_ts;
+	uint32_t power_state;
+	uint32_t reserved;
+} rt_instr_suspend_rec_t;
+
 PMF_DECLARE_CAPTURE_TIMESTAMP(rt_instr_svc)
 PMF_DECLARE_GET_TIMESTAMP(rt_instr_svc)
+
+#if ENABLE_SMC_LATENCY_HIST
+void rt_instr_smc_hist_record(uint32_t smc_fid);
+#endif
+
+#if ENABLE_PSCI_SUSPEND_TRACE
+void rt_instr_suspend_trace_start(unsigned int power_state);
+void rt_instr_suspend_trace_record(void);
+int rt_instr_suspend_trace_export(u_register_t mpidr, uintptr_t buf,
+				  size_t size, unsigned int *count,
+				  unsigned int *lost);
+#endif
 #endif /* __ASSEMBLY__ */
 
 #endif /* RUNTIME_INSTR_H */
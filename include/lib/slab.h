@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <object_pool.h>
+#include <platform_def.h>
+#include <spinlock.h>
+#include <utils_def.h>
+
+/*
+ * Cache of statically allocated objects that can be allocated and freed in
+ * constant time by the runtime services of BL31.
+ *
+ * The objects are taken from an object pool the first time they are allocated.
+ * Freed objects are kept in a magazine of the CPU that frees them, and are
+ * reused by the next allocations made on that CPU, so each CPU usually only
+ * takes its own lock. When a magazine is full or empty, half of it is moved to
+ * or from the depot shared by all the CPUs. An allocation only takes objects
+ * from the magazines of other CPUs once the depot and the pool are exhausted.
+ *
+ * The objects aren't written to by the cache, so they keep their contents
+ * while they are free.
+ */
+#ifndef SLAB_MAGAZINE_SIZE
+#define SLAB_MAGAZINE_SIZE	4U
+#endif
+
+CASSERT((SLAB_MAGAZINE_SIZE >= 2U) && ((SLAB_MAGAZINE_SIZE % 2U) == 0U),
+	assert_slab_magazine_size);
+
+typedef struct slab_magazine {
+	spinlock_t lock;
+	unsigned int num;
+	void *objs[SLAB_MAGAZINE_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) slab_magazine_t;
+
+typedef struct slab_cache {
+	/* Objects never allocated yet */
+	struct object_pool *const pool;
+
+	/* Magazines of the CPUs */
+	slab_magazine_t *const magazines;
+
+	/* Freed objects that don't fit in the magazines, and their number */
+	void **const depot;
+	size_t depot_num;
+
+	/* Lock of the pool and the depot */
+	spinlock_t lock;
+} slab_cache_t;
+
+/* Create a static slab cache out of an array of pre-allocated objects */
+#define SLAB_CACHE_ARRAY(_cache_name, _obj_array)			\
+	static OBJECT_POOL_ARRAY(_cache_name ## _pool, (_obj_array));	\
+	static slab_magazine_t						\
+		_cache_name ## _magazines[PLATFORM_CORE_COUNT];		\
+	static void *_cache_name ## _depot[ARRAY_SIZE(_obj_array)];	\
+	static slab_cache_t _cache_name = {				\
+		.pool = &(_cache_name ## _pool),			\
+		.magazines = (_cache_name ## _magazines),		\
+		.depot = (_cache_name ## _depot),			\
+		.depot_num = 0U,					\
+	}
+
+void *slab_alloc(slab_cache_t *cache);
+void slab_free(slab_cache_t *cache, void *obj);
+
+#endif /* SLAB_H */
@@ -20,7 +20,7 @@
 						SMCCC_VERSION_MINOR_SHIFT))
 
 #if SMCCC_MAJOR_VERSION == 1
-# define SMCCC_MINOR_VERSION U(1)
+# define SMCCC_MINOR_VERSION U(2)
 # include <smccc_v1.h>
 #elif SMCCC_MAJOR_VERSION == 2
 # define SMCCC_MINOR_VERSION U(0)
@@ -29,6 +29,13 @@
 # error "Unsupported version of SMCCC."
 #endif
 
+/*
+ * Number of registers that pass the arguments (X1-X17) and the results
+ * (X0-X17) of SMC64 calls from SMCCC v1.2.
+ */
+#define SMCCC_NUM_ARG_REGS	U(17)
+#define SMCCC_NUM_RES_REGS	U(18)
+
 /* Various flags passed to SMC handlers */
 #define SMC_FROM_SECURE		(U(0) << 0)
 #define SMC_FROM_NON_SECURE	(U(1) << 0)
@@ -18,6 +18,30 @@ typedef struct spinlock {
 void spin_lock(spinlock_t *lock);
 void spin_unlock(spinlock_t *lock);
 
+/* Returns 1 if the lock was acquired. Only available on AArch64. */
+int spin_trylock(spinlock_t *lock);
+
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+/*
+ * Count the acquisitions of the spin locks registered with
+ * REGISTER_LOCK_STATS(). Call (spin_lock)() to acquire a lock uncounted.
+ */
+void spin_lock_stats(spinlock_t *lock);
+#define spin_lock(_lock)	spin_lock_stats(_lock)
+#endif
+
+/*
+ * Ticket locks are granted in the order they are requested. They take one
+ * atomic operation when uncontended. Only available on AArch64.
+ */
+typedef struct ticketlock {
+	volatile uint16_t owner;
+	volatile uint16_t next;
+} ticketlock_t;
+
+void ticket_lock(ticketlock_t *lock);
+void ticket_unlock(ticketlock_t *lock);
+
 #else
 
 /* Spin lock definitions for use in assembly */
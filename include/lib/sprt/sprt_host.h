@@ -7,6 +7,7 @@
 #define SPRT_HOST_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "sprt_common.h"
 
@@ -23,4 +24,14 @@ int sprt_push_message(void *buffer_base,
 		      const struct sprt_queue_entry_message *message,
 		      int queue_num);
 
+/*
+ * Push up to `num` messages to the queue number `queue_num` in a buffer that
+ * has been initialized by `sprt_initialize_queues`. The messages are made
+ * visible to the Secure Partition at once. Returns the number of messages
+ * pushed.
+ */
+uint32_t sprt_push_messages(void *buffer_base,
+			    const struct sprt_queue_entry_message *messages,
+			    uint32_t num, int queue_num);
+
 #endif /* SPRT_HOST_H */
@@ -65,10 +65,15 @@ unsigned long long tcr_physical_addr_size_bits(unsigned long long max_addr);
  * D4.2.5 in the ARMv8-A Architecture Reference Manual (DDI 0487A.j) for more
  * information.
  *
+ * For a 16 KB page size, level 0 supports 48-bit address spaces, level 1 47 to
+ * 37 bits, level 2 36 to 26 bits and level 3 25 bits. For a 64 KB page size,
+ * level 1 supports 48 to 43 bits, level 2 42 to 30 bits and level 3 29 to 25
+ * bits, level 0 is not used.
+ *
  * For example, for a 35-bit address space (i.e. virt_addr_space_size ==
  * 1 << 35), TCR.TxSZ will be programmed to (64 - 35) = 29. According to Table
  * D4-11 in the ARM ARM, the initial lookup level for an address space like that
- * is 1.
+ * is 1 with 4 KB granularity.
  *
  * Note that this macro assumes that the given virtual address space size is
  * valid. Therefore, the caller is expected to check it is the case using the
@@ -78,6 +83,8 @@ unsigned long long tcr_physical_addr_size_bits(unsigned long long max_addr);
 	(((_virt_addr_space_sz) > (ULL(1) << L0_XLAT_ADDRESS_SHIFT))	\
 	? 0U								\
 	 : (((_virt_addr_space_sz) > (ULL(1) << L1_XLAT_ADDRESS_SHIFT))	\
-	 ? 1U : 2U))
+	 ? 1U								\
+	 : (((_virt_addr_space_sz) > (ULL(1) << L2_XLAT_ADDRESS_SHIFT))	\
+	 ? 2U : 3U)))
 
 #endif /* XLAT_TABLES_AARCH64_H */
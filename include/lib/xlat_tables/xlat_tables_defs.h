@@ -19,6 +19,8 @@
 #define TWO_MB_SHIFT		U(21)
 #define ONE_GB_SHIFT		U(30)
 #define FOUR_KB_SHIFT		U(12)
+#define SIXTEEN_KB_SHIFT	U(14)
+#define SIXTY_FOUR_KB_SHIFT	U(16)
 
 #define ONE_GB_INDEX(x)		((x) >> ONE_GB_SHIFT)
 #define TWO_MB_INDEX(x)		((x) >> TWO_MB_SHIFT)
@@ -66,9 +68,22 @@
 
 /*
  * The ARMv8-A architecture allows translation granule sizes of 4KB, 16KB or
- * 64KB. However, only 4KB are supported at the moment.
+ * 64KB. The granule is selected at build time with XLAT_GRANULE_SIZE, and
+ * defaults to 4KB. Only the 4KB granule is supported in AArch32.
  */
+#ifndef XLAT_GRANULE_SIZE
+#define XLAT_GRANULE_SIZE	PAGE_SIZE_4KB
+#endif
+
+#if XLAT_GRANULE_SIZE == PAGE_SIZE_4KB
 #define PAGE_SIZE_SHIFT		FOUR_KB_SHIFT
+#elif XLAT_GRANULE_SIZE == PAGE_SIZE_16KB
+#define PAGE_SIZE_SHIFT		SIXTEEN_KB_SHIFT
+#elif XLAT_GRANULE_SIZE == PAGE_SIZE_64KB
+#define PAGE_SIZE_SHIFT		SIXTY_FOUR_KB_SHIFT
+#else
+#error "Invalid XLAT_GRANULE_SIZE"
+#endif
 #define PAGE_SIZE		(U(1) << PAGE_SIZE_SHIFT)
 #define PAGE_SIZE_MASK		(PAGE_SIZE - U(1))
 #define IS_PAGE_ALIGNED(addr)	(((addr) & PAGE_SIZE_MASK) == U(0))
@@ -99,12 +114,26 @@
 #define XLAT_BLOCK_MASK(level)	(XLAT_BLOCK_SIZE(level) - UL(1))
 /* Mask to get the address bits common to a block of a certain table level*/
 #define XLAT_ADDR_MASK(level)	(~XLAT_BLOCK_MASK(level))
+
+/*
+ * Number of adjacent entries of a table of the given level that can be grouped
+ * with the Contiguous hint, and size of the memory mapped by such a group.
+ */
+#if PAGE_SIZE == PAGE_SIZE_4KB
+#define XLAT_CONT_ENTRIES(level)	U(16)
+#elif PAGE_SIZE == PAGE_SIZE_16KB
+#define XLAT_CONT_ENTRIES(level)	\
+	(((level) == XLAT_TABLE_LEVEL_MAX) ? U(128) : U(32))
+#else
+#define XLAT_CONT_ENTRIES(level)	U(32)
+#endif
+#define XLAT_CONT_SIZE(level)	\
+	((unsigned long long)XLAT_CONT_ENTRIES(level) << XLAT_ADDR_SHIFT(level))
 /*
  * Extract from the given virtual address the index into the given lookup level.
- * This macro assumes the system is using the 4KB translation granule.
  */
 #define XLAT_TABLE_IDX(virtual_addr, level)	\
-	(((virtual_addr) >> XLAT_ADDR_SHIFT(level)) & ULL(0x1FF))
+	(((virtual_addr) >> XLAT_ADDR_SHIFT(level)) & XLAT_TABLE_ENTRIES_MASK)
 
 /*
  * The ARMv8 translation table descriptor format defines AP[2:1] as the Access
@@ -208,6 +208,32 @@ typedef struct xlat_ctx xlat_ctx_t;
 void init_xlat_tables(void);
 void init_xlat_tables_ctx(xlat_ctx_t *ctx);
 
+/*
+ * Translation tables generated at build time by tools/xlat_gen from a static
+ * memory map of the BL image (see PREBUILT_XLAT_TABLES). They are read-only, so
+ * no region can be added or changed once they are in use.
+ */
+typedef struct xlat_prebuilt_tables {
+	const uint64_t *base_table;
+	unsigned int base_table_entries;
+	int xlat_regime;
+	unsigned long long pa_max_address;
+	uintptr_t va_max_address;
+	unsigned long long max_pa;
+	uintptr_t max_va;
+} xlat_prebuilt_tables_t;
+
+/* Tables of the current BL image, if they have been generated. */
+extern const xlat_prebuilt_tables_t xlat_prebuilt_tables;
+
+/*
+ * Use translation tables generated at build time instead of building them from
+ * the list of mmap regions. The tables must have been generated for the same
+ * translation regime and address space sizes as the context.
+ */
+void init_xlat_tables_prebuilt_ctx(xlat_ctx_t *ctx,
+				   const xlat_prebuilt_tables_t *tables);
+
 /*
  * Fill all fields of a dynamic translation tables context. It must be done
  * either statically with REGISTER_XLAT_CONTEXT() or at runtime with this
@@ -217,7 +243,19 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 			    uintptr_t va_max, struct mmap_region *mmap,
 			    unsigned int mmap_num, uint64_t **tables,
 			    unsigned int tables_num, uint64_t *base_table,
-			    int xlat_regime, int *mapped_regions);
+			    int xlat_regime, int *mapped_regions,
+			    int *next_free);
+
+/*
+ * Give an Address Space Identifier to the translation tables of a context of
+ * the EL1&0 translation regime, before they are initialized. The regions are
+ * then mapped as non-global, and the caller must program the ASID in TTBR0
+ * along with the base table. ASID 0 is for global mappings, and is the
+ * default.
+ */
+#define XLAT_ASID_MAX	U(0xff)
+
+void xlat_set_asid_ctx(xlat_ctx_t *ctx, unsigned int asid);
 
 /*
  * Add a static region with defined base PA and base VA. This function can only
@@ -344,6 +382,38 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr);
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr);
 
+/*
+ * Change the memory attributes of several memory regions at once. Each region
+ * follows the same rules as in xlat_change_mem_attributes_ctx(). All the
+ * descriptors are updated before the TLBs are invalidated, so there is a single
+ * synchronisation for the whole batch instead of one per region.
+ *
+ * Return 0 on success, a negative value on error. All the regions are checked
+ * before any of them is changed, so in case of error the memory attributes
+ * remain unchanged and this function has no effect.
+ *
+ * ctx
+ *   Translation context to work on.
+ * changes:
+ *   Array of the regions to change and of their new attributes. If regions
+ *   overlap, the attributes of the last one apply.
+ * count:
+ *   Number of elements of the array.
+ *
+ * The notes of xlat_change_mem_attributes_ctx() also apply.
+ */
+typedef struct xlat_attr_change {
+	uintptr_t base_va;
+	size_t size;
+	uint32_t attr;
+} xlat_attr_change_t;
+
+int xlat_change_mem_attributes_batch_ctx(const xlat_ctx_t *ctx,
+					 const xlat_attr_change_t *changes,
+					 unsigned int count);
+int xlat_change_mem_attributes_batch(const xlat_attr_change_t *changes,
+				     unsigned int count);
+
 /*
  * Query the memory attributes of a memory page in a set of translation tables.
  *
@@ -363,5 +433,28 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				uint32_t *attr);
 int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr);
 
+/*
+ * Query the number of sub-tables (all the translation tables but the base one)
+ * of a set of initialized translation tables. This helps sizing the tables of
+ * a context, e.g. MAX_XLAT_TABLES for the tables of the BL image: the highest
+ * number of sub-tables in use is the number of sub-tables the context needs
+ * for the regions mapped so far, including the dynamic regions since removed.
+ *
+ * ctx
+ *   Translation context to work on.
+ * used
+ *   If not NULL, output parameter where to store the number of sub-tables in
+ *   use.
+ * max_used
+ *   If not NULL, output parameter where to store the highest number of
+ *   sub-tables in use at the same time since the tables were initialized.
+ * total
+ *   If not NULL, output parameter where to store the number of sub-tables of
+ *   the context.
+ */
+void xlat_get_tables_usage_ctx(const xlat_ctx_t *ctx, int *used,
+			       int *max_used, int *total);
+void xlat_get_tables_usage(int *used, int *max_used, int *total);
+
 #endif /*__ASSEMBLY__*/
 #endif /* XLAT_TABLES_V2_H */
@@ -28,6 +28,12 @@
 /* Forward declaration */
 struct mmap_region;
 
+/*
+ * Number of direct-mapped entries of the cache of the attributes looked up in
+ * a translation context. It must be a power of two.
+ */
+#define XLAT_ATTR_CACHE_SIZE	U(4)
+
 /*
  * Helper macro to define an mmap_region_t.  This macro allows to specify all
  * the fields of the structure but its parameter list is not guaranteed to
@@ -74,10 +80,24 @@ struct xlat_ctx {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+	/*
+	 * List of the tables with no region mapped in them. It starts at index
+	 * tables_free_head, and tables_next_free[i] is the index of the table
+	 * after table i in the list, or -1 for the last table.
+	 */
+	int *tables_next_free;
+	int tables_free_head;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 	int next_table;
 
+	/*
+	 * Number of sub-tables currently in use, and highest number of
+	 * sub-tables in use at the same time since the tables were initialized.
+	 */
+	int used_tables;
+	int max_used_tables;
+
 	/*
 	 * Base translation table. It doesn't need to have the same amount of
 	 * entries as the ones used for other levels.
@@ -104,14 +124,32 @@ struct xlat_ctx {
 	 * the EL*_REGIME defines.
 	 */
 	int xlat_regime;
+
+	/*
+	 * Address Space Identifier of the tables, only for the EL1&0
+	 * translation regime. If it isn't 0, the regions are mapped as
+	 * non-global, so that switching between contexts with different
+	 * ASIDs doesn't require TLB invalidations.
+	 */
+	unsigned int asid;
+
+	/*
+	 * Cache of the attributes of the blocks and pages looked up by
+	 * xlat_get_mem_attributes_ctx(), or NULL. It has XLAT_ATTR_CACHE_SIZE
+	 * direct-mapped entries, followed by the last entry that was hit.
+	 */
+	uintptr_t *attr_cache;
 };
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 #define XLAT_ALLOC_DYNMAP_STRUCT(_ctx_name, _xlat_tables_count)		\
-	static int _ctx_name##_mapped_regions[_xlat_tables_count];
+	static int _ctx_name##_mapped_regions[_xlat_tables_count];	\
+	static int _ctx_name##_next_free[_xlat_tables_count];
 
 #define XLAT_REGISTER_DYNMAP_STRUCT(_ctx_name)				\
-	.tables_mapped_regions = _ctx_name##_mapped_regions,
+	.tables_mapped_regions = _ctx_name##_mapped_regions,		\
+	.tables_next_free = _ctx_name##_next_free,			\
+	.tables_free_head = -1,
 #else
 #define XLAT_ALLOC_DYNMAP_STRUCT(_ctx_name, _xlat_tables_count)		\
 	/* do nothing */
@@ -142,6 +180,8 @@ struct xlat_ctx {
 									\
 	XLAT_ALLOC_DYNMAP_STRUCT(_ctx_name, _xlat_tables_count)		\
 									\
+	static uintptr_t _ctx_name##_attr_cache[XLAT_ATTR_CACHE_SIZE + 1U];\
+									\
 	static xlat_ctx_t _ctx_name##_xlat_ctx = {			\
 		.va_max_address = (_virt_addr_space_size) - 1UL,	\
 		.pa_max_address = (_phy_addr_space_size) - 1ULL,	\
@@ -158,7 +198,11 @@ struct xlat_ctx {
 		.max_pa = 0U,						\
 		.max_va = 0U,						\
 		.next_table = 0,					\
+		.used_tables = 0,					\
+		.max_used_tables = 0,					\
 		.initialized = false,					\
+		.asid = 0U,						\
+		.attr_cache = _ctx_name##_attr_cache,			\
 	}
 
 #endif /*__ASSEMBLY__*/
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_CRC32_H
+#define TF_CRC32_H
+
+/*
+ * CRC-32 of lib/zlib/crc32.c, for the users outside of zlib, which don't see
+ * its headers. It is declared with the types zlib defines uLong, Bytef and
+ * uInt as. `crc` is the CRC of the previous data, 0 to start.
+ */
+unsigned long crc32(unsigned long crc, const unsigned char *buf,
+		    unsigned int len);
+
+#endif /* TF_CRC32_H */
@@ -7,10 +7,18 @@
 #ifndef TF_GUNZIP_H
 #define TF_GUNZIP_H
 
+#include <image_decompress.h>
 #include <stddef.h>
 #include <stdint.h>
 
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len);
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len);
+int gunzip_stream_finish(uintptr_t *out_buf);
+
+extern const stream_decompressor_t gunzip_stream_decompressor;
+
 #endif /* TF_GUNZIP_H */
@@ -58,6 +58,11 @@
 #define ARM_SHARED_RAM_BASE		ARM_TRUSTED_SRAM_BASE
 #define ARM_SHARED_RAM_SIZE		UL(0x00001000)	/* 4 KB */
 
+/* The boot timeline (BOOT_PROFILING=1) takes the top half of the shared RAM */
+#define PLAT_BOOT_PROF_BASE		(ARM_SHARED_RAM_BASE +		\
+					 (ARM_SHARED_RAM_SIZE / 2U))
+#define PLAT_BOOT_PROF_SIZE		(ARM_SHARED_RAM_SIZE / 2U)
+
 /* The remaining Trusted SRAM is used to load the BL images */
 #define ARM_BL_RAM_BASE			(ARM_SHARED_RAM_BASE +	\
 					 ARM_SHARED_RAM_SIZE)
@@ -145,6 +150,13 @@
 #define ARM_NS_DRAM1_END		(ARM_NS_DRAM1_BASE +		\
 					 ARM_NS_DRAM1_SIZE - 1)
 
+/*
+ * The benchmark of the loading path (BL2_IO_BENCHMARK=1) runs before BL2 loads
+ * the images, so it loads its images where BL33 is loaded
+ */
+#define PLAT_BL2_IO_BENCH_BUF_BASE	PLAT_ARM_NS_IMAGE_OFFSET
+#define PLAT_BL2_IO_BENCH_BUF_SIZE	UL(0x10000000)
+
 #define ARM_DRAM1_BASE			ULL(0x80000000)
 #define ARM_DRAM1_SIZE			ULL(0x80000000)
 #define ARM_DRAM1_END			(ARM_DRAM1_BASE +		\
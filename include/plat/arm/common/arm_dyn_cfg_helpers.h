@@ -18,5 +18,8 @@ int arm_get_dtb_mbedtls_heap_info(void *dtb, void **heap_addr,
 	size_t *heap_size);
 int arm_set_dtb_mbedtls_heap_info(void *dtb, void *heap_addr,
 	size_t heap_size);
+int arm_dyn_add_deferred_image(void *dtb, size_t dtb_max_size,
+	unsigned int image_id, uint64_t fip_offset, uint64_t size,
+	const void *hash, unsigned int hash_len);
 
 #endif /* ARM_DYN_CFG_HELPERS_H */
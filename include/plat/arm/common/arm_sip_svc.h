@@ -19,8 +19,40 @@
 /* Function ID for requesting state switch of lower EL */
 #define ARM_SIP_SVC_EXE_STATE_SWITCH	U(0x82000020)
 
+/* Function ID for powering on several CPUs at once */
+#define ARM_SIP_SVC_CPU_ON_BATCH	U(0xc2000021)
+
+/* Function ID for setting the log level of a log module */
+#define ARM_SIP_SVC_SET_LOG_LEVEL	U(0x82000022)
+
+/* Error codes of ARM_SIP_SVC_SET_LOG_LEVEL */
+#define LOG_LEVEL_E_PARAM		(-2)
+
+/* Function ID for reading an entry of the boot timeline */
+#define ARM_SIP_SVC_GET_BOOT_PROF	U(0xc2000023)
+
+/* Error codes of ARM_SIP_SVC_GET_BOOT_PROF */
+#define BOOT_PROF_E_PARAM		(-2)
+
+/* Function IDs for controlling the EL3 profiler of the calling CPU */
+#define ARM_SIP_SVC_EL3_PROF_START	U(0x82000024)
+#define ARM_SIP_SVC_EL3_PROF_STOP	U(0xc2000025)
+#define ARM_SIP_SVC_EL3_PROF_READ	U(0xc2000026)
+
+/* Function ID for reading the statistics of a registered lock */
+#define ARM_SIP_SVC_GET_LOCK_STATS	U(0xc2000027)
+
+/* Function ID for reading the PSCI statistics of a power domain */
+#define ARM_SIP_SVC_GET_PSCI_STATS	U(0xc2000028)
+
+/* Error codes of ARM_SIP_SVC_GET_PSCI_STATS */
+#define PSCI_STATS_E_PARAM		(-2)
+
+/* Function ID for running a batch of SiP calls */
+#define ARM_SIP_SVC_BATCH		U(0xc2000029)
+
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		U(0x0)
-#define ARM_SIP_SVC_VERSION_MINOR		U(0x2)
+#define ARM_SIP_SVC_VERSION_MINOR		U(0x9)
 
 #endif /* ARM_SIP_SVC_H */
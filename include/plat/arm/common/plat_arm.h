@@ -76,12 +76,15 @@ void arm_setup_romlib(void);
 #define ARM_INSTANTIATE_LOCK	static DEFINE_BAKERY_LOCK(arm_lock)
 #define ARM_LOCK_GET_INSTANCE	(&arm_lock)
 
+/* One lock per SCMI channel */
 #if !HW_ASSISTED_COHERENCY
-#define ARM_SCMI_INSTANTIATE_LOCK	DEFINE_BAKERY_LOCK(arm_scmi_lock)
+#define ARM_SCMI_INSTANTIATE_LOCK	\
+	DEFINE_BAKERY_LOCK(arm_scmi_lock[PLAT_ARM_SCMI_CHANNEL_COUNT])
 #else
-#define ARM_SCMI_INSTANTIATE_LOCK	spinlock_t arm_scmi_lock
+#define ARM_SCMI_INSTANTIATE_LOCK	\
+	spinlock_t arm_scmi_lock[PLAT_ARM_SCMI_CHANNEL_COUNT]
 #endif
-#define ARM_SCMI_LOCK_GET_INSTANCE	(&arm_scmi_lock)
+#define ARM_SCMI_LOCK_GET_INSTANCE(_ch)	(&arm_scmi_lock[(_ch)])
 
 /*
  * These are wrapper macros to the Coherent Memory Bakery Lock API.
@@ -238,6 +241,7 @@ void plat_arm_gic_init(void);
 void plat_arm_gic_cpuif_enable(void);
 void plat_arm_gic_cpuif_disable(void);
 void plat_arm_gic_redistif_on(void);
+void plat_arm_gic_redistif_on_start(void);
 void plat_arm_gic_redistif_off(void);
 void plat_arm_gic_pcpu_init(void);
 void plat_arm_gic_save(void);
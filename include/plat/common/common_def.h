@@ -56,7 +56,8 @@
  * originally lives in Trusted ROM and needs to be relocated in Trusted SRAM at
  * run-time. Therefore, the read-write data in ROM can be mapped with the same
  * memory attributes as the read-only data region. For this reason, BL1 uses
- * different macros.
+ * different macros. The same applies to BL2 and BL31 when they execute in place
+ * (BL2_IN_XIP_MEM=1 and BL31_IN_XIP_MEM=1).
  *
  * Note that BL1_ROM_END is not necessarily aligned on a page boundary as it
  * just points to the end of BL1's actual content in Trusted ROM. Therefore it
@@ -73,6 +74,11 @@
 #define BL2_RO_DATA_BASE	BL_RO_DATA_BASE
 #define BL2_RO_DATA_END		round_up(BL2_ROM_END, PAGE_SIZE)
 #endif /* BL2_IN_XIP_MEM */
+#if BL31_IN_XIP_MEM
+#define BL31_CODE_END		BL_CODE_END
+#define BL31_RO_DATA_BASE	BL_RO_DATA_BASE
+#define BL31_RO_DATA_END	round_up(BL31_ROM_END, PAGE_SIZE)
+#endif /* BL31_IN_XIP_MEM */
 #else
 #define BL_RO_DATA_BASE		UL(0)
 #define BL_RO_DATA_END		UL(0)
@@ -82,6 +88,11 @@
 #define BL2_RO_DATA_END		UL(0)
 #define BL2_CODE_END		round_up(BL2_ROM_END, PAGE_SIZE)
 #endif /* BL2_IN_XIP_MEM */
+#if BL31_IN_XIP_MEM
+#define BL31_RO_DATA_BASE	UL(0)
+#define BL31_RO_DATA_END	UL(0)
+#define BL31_CODE_END		round_up(BL31_ROM_END, PAGE_SIZE)
+#endif /* BL31_IN_XIP_MEM */
 #endif /* SEPARATE_CODE_AND_RODATA */
 
 #endif /* COMMON_DEF_H */
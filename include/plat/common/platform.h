@@ -23,6 +23,9 @@ struct bl_params;
 struct mmap_region;
 struct secure_partition_boot_info;
 struct sp_res_desc;
+struct dsu_partition_config;
+struct image_split;
+struct bl2_io_bench_image;
 
 /*******************************************************************************
  * plat_get_rotpk_info() flags
@@ -125,6 +128,24 @@ void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr);
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 
+/* MPAM platform functions */
+#if MPAM_WORLD_PARTID
+void plat_mpam_msc_setup(void);
+uint64_t plat_mpam_get_partid_pmg(unsigned int security_state);
+uint64_t plat_mpam_get_sp_partid_pmg(unsigned int sp_index);
+#endif
+
+/* DSU L3 partitioning platform functions */
+#if DSU_L3_PARTITIONING
+const struct dsu_partition_config *plat_dsu_get_partition_config(void);
+#endif
+
+/* Secure time budget platform functions */
+#if SECURE_TIME_BUDGET
+void plat_secure_budget_timer_arm(uint64_t cval);
+void plat_secure_budget_timer_disarm(void);
+#endif
+
 /*
  * The following function is mandatory when the
  * firmware update feature is used.
@@ -160,6 +181,12 @@ __dead2 void bl1_plat_fwu_done(void *client_cookie, void *reserved);
 int bl1_plat_handle_pre_image_load(unsigned int image_id);
 int bl1_plat_handle_post_image_load(unsigned int image_id);
 
+/*
+ * This BL1 function is used by BL1_WARM_RESUME to know whether the current
+ * reset preserved the memory of the record of the images.
+ */
+int bl1_plat_is_warm_resume(void);
+
 /*******************************************************************************
  * Mandatory BL2 functions
  ******************************************************************************/
@@ -174,12 +201,29 @@ struct meminfo *bl2_plat_sec_mem_layout(void);
  */
 int bl2_plat_handle_pre_image_load(unsigned int image_id);
 int bl2_plat_handle_post_image_load(unsigned int image_id);
+int bl2_plat_handle_deferred_image(unsigned int image_id, const void *hash,
+				   unsigned int hash_len);
+struct image_split *bl2_plat_get_image_split(unsigned int image_id);
 
 
 /*******************************************************************************
  * Optional BL2 functions (may be overridden)
  ******************************************************************************/
+int bl2_plat_mboot_extend(unsigned int pcr, unsigned int alg_id,
+			  const uint8_t *digest, unsigned int digest_len);
+void bl2_plat_mboot_finish(const uint8_t *log, size_t log_size);
 
+/*******************************************************************************
+ * Mandatory BL2 functions when BL2_SECONDARY_HASH=1
+ ******************************************************************************/
+int plat_bl2_secondary_start(uintptr_t entrypoint);
+__dead2 void plat_bl2_secondary_exit(void);
+
+/*******************************************************************************
+ * Mandatory BL2 functions when BL2_IO_BENCHMARK=1
+ ******************************************************************************/
+const struct bl2_io_bench_image *plat_bl2_io_bench_get_images(
+						unsigned int *num_images);
 
 /*******************************************************************************
  * Mandatory BL2 at EL3 functions: Must be implemented if BL2_AT_EL3 image is
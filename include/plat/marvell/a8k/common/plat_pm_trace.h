@@ -35,10 +35,31 @@ struct pm_trace_ctrl {
 	unsigned int trace_count;
 };
 
+/*
+ * Entry of the trace ring kept by BL31 for each core, in addition to the MSS
+ * queue. The time stamp is read from the generic counter, which has a higher
+ * resolution than the MSS timer and isn't stopped in the low power states.
+ */
+struct pm_trace_ring_entry {
+	/* generic counter value */
+	unsigned long long timestamp;
+
+	/* MSS timer value, as in the MSS queue */
+	unsigned int mss_timestamp;
+
+	/* trace info, as in the MSS queue */
+	unsigned int trace_info;
+};
+
+/* Number of entries of the trace ring of each core, a power of two */
+#define PM_TRACE_RING_ENTRIES		(64)
+
 /* trace size definition */
 #define AP_MSS_ATF_CORE_INFO_SIZE	(256)
 #define AP_MSS_ATF_CORE_ENTRY_SIZE	(8)
 #define AP_MSS_ATF_TRACE_SIZE_MASK	(0xFF)
+#define AP_MSS_ATF_CORE_CTRL_STRIDE	(0x10)
+#define AP_MSS_ATF_CORE_INFO_STRIDE	(0x800)
 
 /* trace address definition */
 #define AP_MSS_TIMER_BASE		(MVEBU_REGS_BASE_MASK + 0x580110)
@@ -70,17 +91,7 @@ struct pm_trace_ctrl {
 
 #ifdef PM_TRACE_ENABLE
 
-/* trace API definition */
-void pm_core_0_trace(unsigned int trace);
-void pm_core_1_trace(unsigned int trace);
-void pm_core_2_trace(unsigned int trace);
-void pm_core_3_trace(unsigned int trace);
-
-typedef void (*core_trace_func)(unsigned int);
-
-extern core_trace_func funcTbl[PLATFORM_CORE_COUNT];
-
-#define PM_TRACE(trace) funcTbl[plat_my_core_pos()](trace)
+#define PM_TRACE(trace) pm_trace_add(trace, plat_my_core_pos())
 
 #else
 
@@ -96,4 +107,13 @@ extern core_trace_func funcTbl[PLATFORM_CORE_COUNT];
  */
 void pm_trace_add(unsigned int trace, unsigned int core);
 
+/*******************************************************************************
+ * pm_trace_read
+ *
+ * DESCRIPTION: Read entry number seq of the trace ring of a core
+ ******************************************************************************
+ */
+int pm_trace_read(unsigned int core, unsigned int seq,
+		  struct pm_trace_ring_entry *entry, unsigned int *count);
+
 #endif /* PLAT_PM_TRACE_H */
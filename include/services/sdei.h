@@ -7,6 +7,7 @@
 #ifndef SDEI_H
 #define SDEI_H
 
+#include <lock_stats.h>
 #include <spinlock.h>
 #include <utils_def.h>
 
@@ -127,6 +128,8 @@
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
+	REGISTER_LOCK_STATS(sdei_prv, _private); \
+	REGISTER_LOCK_STATS(sdei_shr, _shared); \
 	const sdei_mapping_t sdei_global_mappings[] = { \
 		[SDEI_MAP_IDX_PRIV_] = { \
 			.map = (_private), \
@@ -140,6 +143,24 @@
 
 typedef uint8_t sdei_state_t;
 
+#if SDEI_EVENT_STATS
+/* Statistics of a duration, in ticks of the system counter */
+typedef struct sdei_time_stats {
+	uint64_t min;
+	uint64_t max;
+	uint64_t total;
+} sdei_time_stats_t;
+
+/* Delivery statistics of SDEI event */
+typedef struct sdei_ev_stats {
+	uint32_t dispatches;		/* Dispatches to the client */
+	uint32_t completions;		/* Completions by the client */
+	uint32_t masked_triggers;	/* Triggers while the PE was masked */
+	sdei_time_stats_t dispatch_lat;	/* From interrupt to dispatch */
+	sdei_time_stats_t handler_time;	/* From dispatch to completion */
+} sdei_ev_stats_t;
+#endif
+
 /* Runtime data of SDEI event */
 typedef struct sdei_entry {
 	uint64_t ep;		/* Entry point */
@@ -149,6 +170,10 @@ typedef struct sdei_entry {
 
 	/* Event handler states: registered, enabled, running */
 	sdei_state_t state;
+
+#if SDEI_EVENT_STATS
+	sdei_ev_stats_t stats;
+#endif
 } sdei_entry_t;
 
 /* Mapping of SDEI events to interrupts, and associated data */
@@ -157,7 +182,11 @@ typedef struct sdei_ev_map {
 	unsigned int intr;	/* Physical interrupt number for a bound map */
 	unsigned int map_flags;	/* Mapping flags, see SDEI_MAPF_* */
 	int reg_count;		/* Registration count */
+#if USE_TICKET_LOCKS
+	ticketlock_t lock;	/* Per-event lock */
+#else
 	spinlock_t lock;	/* Per-event lock */
+#endif
 } sdei_ev_map_t;
 
 typedef struct sdei_mapping {
@@ -180,4 +209,15 @@ void sdei_init(void);
 /* Public API to dispatch an event to Normal world */
 int sdei_dispatch_event(int ev_num);
 
+#if SDEI_EVENT_STATS
+/* Statistics returned by sdei_event_get_stats() */
+#define SDEI_STATS_COUNTS		U(0)
+#define SDEI_STATS_DISPATCH_LATENCY	U(1)
+#define SDEI_STATS_HANDLER_TIME		U(2)
+#define SDEI_STATS_VALUES		U(3)
+
+int sdei_event_get_stats(int ev_num, uint64_t mpidr, unsigned int sel,
+		uint64_t *values);
+#endif
+
 #endif /* SDEI_H */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TB_FW_CFG_BLOB_H
+#define TB_FW_CFG_BLOB_H
+
+#include <stdint.h>
+
+/*
+ * Layout of the TB_FW_CONFIG blob, generated from the TB_FW_CONFIG DTB by the
+ * cfgblob host tool, and used in place of the DTB on Arm platforms built with
+ * ARM_TB_FW_CONFIG_BLOB=1. All the properties of the "arm,tb_fw" node are at
+ * fixed offsets, in little-endian. A property missing from the DTB is flagged
+ * as such in `flags` or in the `valid` field of its load information.
+ *
+ * New fields are only appended, with a new version: a reader accepts any
+ * version from its own one, as long as `size` covers the fields it reads.
+ */
+#define TB_FW_CFG_BLOB_MAGIC		0x47464342U	/* "BCFG" */
+#define TB_FW_CFG_BLOB_VERSION		1U
+
+/* Index of each configuration in the load information */
+#define TB_FW_CFG_BLOB_HW_CONFIG	0U
+#define TB_FW_CFG_BLOB_SOC_FW_CONFIG	1U
+#define TB_FW_CFG_BLOB_TOS_FW_CONFIG	2U
+#define TB_FW_CFG_BLOB_NT_FW_CONFIG	3U
+#define TB_FW_CFG_BLOB_NUM_CONFIGS	4U
+
+/* Properties present in the blob */
+#define TB_FW_CFG_BLOB_DISABLE_AUTH	(1U << 0)
+#define TB_FW_CFG_BLOB_MBEDTLS_HEAP	(1U << 1)
+
+typedef struct tb_fw_cfg_blob_load_info {
+	/* <config>_addr and <config>_max_size properties */
+	uint64_t addr;
+	uint32_t max_size;
+	uint32_t valid;
+} tb_fw_cfg_blob_load_info_t;
+
+typedef struct tb_fw_cfg_blob {
+	uint32_t magic;
+	uint32_t version;
+	/* Size of the blob in bytes */
+	uint32_t size;
+	uint32_t flags;
+	uint32_t disable_auth;
+	uint32_t reserved;
+	/* Written by BL1 for BL2 if TB_FW_CFG_BLOB_MBEDTLS_HEAP is set */
+	uint64_t mbedtls_heap_addr;
+	uint64_t mbedtls_heap_size;
+	tb_fw_cfg_blob_load_info_t config[TB_FW_CFG_BLOB_NUM_CONFIGS];
+} tb_fw_cfg_blob_t;
+
+#endif /* TB_FW_CFG_BLOB_H */
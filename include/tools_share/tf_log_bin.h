@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LOG_BIN_H
+#define TF_LOG_BIN_H
+
+#include <stdint.h>
+
+/*
+ * Layout of the binary log of an image built with LOG_BINARY=1, as decoded by
+ * the logdecode host tool. The log starts with a header, followed by one ring
+ * of 64-bit words per CPU.
+ *
+ * Each message is recorded in the ring of its CPU as a record word, the
+ * address of its format string in the image and one word per argument. An
+ * argument is stored sign-extended or zero-extended to 64 bits according to its
+ * conversion; a string argument is stored as the address of the string. A
+ * record never wraps around the end of the ring: the unused words at the end
+ * of the ring are set to 0 and the record starts at the beginning.
+ */
+#define TF_LOG_BIN_MAGIC		0x4e49424c4f474654ULL	/* "TFLOGBIN" */
+
+#define TF_LOG_BIN_REC_MAGIC		0x7f10U
+#define TF_LOG_BIN_REC_MAGIC_SHIFT	48
+#define TF_LOG_BIN_REC_LEVEL_SHIFT	8
+#define TF_LOG_BIN_REC_LEVEL_MASK	0xffU
+#define TF_LOG_BIN_REC_NARGS_MASK	0xffU
+
+/* Maximum number of arguments recorded for a message */
+#define TF_LOG_BIN_MAX_ARGS		8U
+
+#define TF_LOG_BIN_REC(_level, _nargs)					\
+	(((uint64_t)TF_LOG_BIN_REC_MAGIC << TF_LOG_BIN_REC_MAGIC_SHIFT) |\
+	 ((uint64_t)(_level) << TF_LOG_BIN_REC_LEVEL_SHIFT) |		\
+	 (uint64_t)(_nargs))
+
+#define TF_LOG_BIN_IS_REC(_word)					\
+	(((_word) >> TF_LOG_BIN_REC_MAGIC_SHIFT) == TF_LOG_BIN_REC_MAGIC)
+
+typedef struct tf_log_bin_hdr {
+	uint64_t magic;
+	/* Number of CPUs, and of rings */
+	uint32_t cpus;
+	/* Number of words of each ring */
+	uint32_t ring_words;
+} tf_log_bin_hdr_t;
+
+/* Ring of a CPU. `head` is the index of the next word to write. */
+typedef struct tf_log_bin_ring_hdr {
+	uint64_t head;
+	/* Non-zero once the ring has wrapped around */
+	uint64_t wrapped;
+} tf_log_bin_ring_hdr_t;
+
+#endif /* TF_LOG_BIN_H */
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <boot_prof.h>
+#include <cassert.h>
+#include <dcache_batch.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <stdbool.h>
+
+/*
+ * Boot timeline. The events of all the boot stages are appended to the same
+ * timeline, which BL31 then exports to the Normal world. The events are only
+ * recorded by the primary CPU during the cold boot, so no lock is needed.
+ */
+#define BOOT_PROF_MAX_ENTRIES						\
+	((PLAT_BOOT_PROF_SIZE - sizeof(struct boot_prof_hdr)) /	\
+	 sizeof(struct boot_prof_entry))
+
+CASSERT(PLAT_BOOT_PROF_SIZE >= (sizeof(struct boot_prof_hdr) +
+	sizeof(struct boot_prof_entry)), assert_boot_prof_size);
+
+#if defined(IMAGE_BL1)
+#define BOOT_PROF_STAGE		BOOT_PROF_BL1
+#define BOOT_PROF_FIRST_STAGE	1
+#elif defined(IMAGE_BL2)
+#define BOOT_PROF_STAGE		BOOT_PROF_BL2
+#define BOOT_PROF_FIRST_STAGE	BL2_AT_EL3
+#else
+#define BOOT_PROF_STAGE		BOOT_PROF_BL31
+#define BOOT_PROF_FIRST_STAGE	RESET_TO_BL31
+#endif
+
+/* Whether this stage has checked the header of the timeline */
+static bool boot_prof_started;
+
+static struct boot_prof_hdr *boot_prof_get_hdr(void)
+{
+	struct boot_prof_hdr *hdr = (struct boot_prof_hdr *)PLAT_BOOT_PROF_BASE;
+
+	if (boot_prof_started)
+		return hdr;
+	boot_prof_started = true;
+
+	/*
+	 * The first stage starts a new timeline. A later stage starts one too
+	 * if the previous stages weren't built with BOOT_PROFILING.
+	 */
+	if ((BOOT_PROF_FIRST_STAGE != 0) ||
+	    (hdr->signature != BOOT_PROF_SIGNATURE) ||
+	    (hdr->max_entries != BOOT_PROF_MAX_ENTRIES)) {
+		hdr->signature = BOOT_PROF_SIGNATURE;
+		hdr->version = BOOT_PROF_VERSION;
+		hdr->max_entries = BOOT_PROF_MAX_ENTRIES;
+		hdr->num_entries = 0U;
+		hdr->lost = 0U;
+		hdr->reserved = 0U;
+	}
+
+	return hdr;
+}
+
+/*
+ * Record `event` of this boot stage in the timeline. The entry and the header
+ * are cleaned to memory, so that the next stage finds them whatever the state
+ * of its MMU and caches.
+ */
+void boot_prof_record(unsigned int event, unsigned int id)
+{
+	struct boot_prof_hdr *hdr = boot_prof_get_hdr();
+	struct boot_prof_entry *entry;
+	uint32_t n = hdr->num_entries;
+	dcache_batch_t batch;
+
+	if (n >= BOOT_PROF_MAX_ENTRIES) {
+		hdr->lost++;
+		flush_dcache_range((uintptr_t)hdr, sizeof(*hdr));
+		return;
+	}
+
+	entry = (struct boot_prof_entry *)(hdr + 1) + n;
+	entry->timestamp = read_cntpct_el0();
+	entry->stage = (uint8_t)BOOT_PROF_STAGE;
+	entry->event = (uint8_t)event;
+	entry->reserved = 0U;
+	entry->id = id;
+	hdr->num_entries = n + 1U;
+
+	/* The first entries share cache lines with the header */
+	dcache_batch_init(&batch, DCACHE_BATCH_FLUSH);
+	dcache_batch_add(&batch, (uintptr_t)entry, sizeof(*entry));
+	dcache_batch_add(&batch, (uintptr_t)hdr, sizeof(*hdr));
+	dcache_batch_finish(&batch);
+}
+
+/*
+ * Copy entry `index` of the timeline to `entry`, and return the number of
+ * entries in `num_entries`. Returns 0 on success, -EINVAL if there is no such
+ * entry.
+ */
+int boot_prof_get_entry(unsigned int index, struct boot_prof_entry *entry,
+		unsigned int *num_entries)
+{
+	const struct boot_prof_hdr *hdr = boot_prof_get_hdr();
+
+	assert(entry != NULL);
+	assert(num_entries != NULL);
+
+	*num_entries = hdr->num_entries;
+	if (index >= hdr->num_entries)
+		return -EINVAL;
+
+	*entry = ((const struct boot_prof_entry *)(hdr + 1))[index];
+
+	return 0;
+}
+
+/*
+ * Discard the entries of the timeline from index `num_entries` onwards, e.g.
+ * the events of a benchmark that must not appear in the timeline of the boot.
+ */
+void boot_prof_rewind(unsigned int num_entries)
+{
+	struct boot_prof_hdr *hdr = boot_prof_get_hdr();
+
+	if (num_entries >= hdr->num_entries)
+		return;
+
+	hdr->num_entries = num_entries;
+	flush_dcache_range((uintptr_t)hdr, sizeof(*hdr));
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <dsu_partition.h>
+#include <ep_info.h>
+#include <platform.h>
+#include <pubsub_events.h>
+
+/* Scheme ID that never matches the one programmed in CLUSTERTHREADSID_EL1 */
+#define DSU_SID_UNKNOWN		U(0xff)
+
+DEFINE_RENAME_SYSREG_WRITE_FUNC(clusterthreadsid_el1, CLUSTERTHREADSID_EL1)
+DEFINE_RENAME_SYSREG_WRITE_FUNC(clusteracpsid_el1, CLUSTERACPSID_EL1)
+DEFINE_RENAME_SYSREG_WRITE_FUNC(clusterstashsid_el1, CLUSTERSTASHSID_EL1)
+DEFINE_RENAME_SYSREG_WRITE_FUNC(clusterpartcr_el1, CLUSTERPARTCR_EL1)
+
+static const dsu_partition_config_t *dsu_config;
+
+/* Thread scheme ID currently programmed on each CPU */
+static uint8_t dsu_cur_sid[PLATFORM_CORE_COUNT];
+
+/*
+ * Program the L3 partitions of the cluster of the calling CPU. The cluster
+ * registers are lost when the cluster is powered down, and the thread scheme ID
+ * when the CPU is, so this is done on each CPU as it is powered on.
+ */
+static void *dsu_partition_init(const void *arg)
+{
+	if (dsu_config == NULL)
+		return (void *)0;
+
+	write_clusterpartcr_el1(dsu_config->partcr);
+	write_clusteracpsid_el1(dsu_config->acp_sid);
+	write_clusterstashsid_el1(dsu_config->stash_sid);
+	isb();
+
+	dsu_cur_sid[plat_my_core_pos()] = DSU_SID_UNKNOWN;
+
+	return (void *)0;
+}
+
+/*
+ * Fetch the configuration of the platform and program it on the primary CPU.
+ * This function is called once during the BL31 cold boot. A platform without
+ * a configuration leaves the L3 shared by all the scheme IDs.
+ */
+void dsu_partition_setup(void)
+{
+	dsu_config = plat_dsu_get_partition_config();
+	if (dsu_config == NULL)
+		return;
+
+	assert((dsu_config->secure_sid & ~DSU_SCHEME_ID_MASK) == 0U);
+	assert((dsu_config->ns_sid & ~DSU_SCHEME_ID_MASK) == 0U);
+	assert((dsu_config->acp_sid & ~DSU_SCHEME_ID_MASK) == 0U);
+	assert((dsu_config->stash_sid & ~DSU_SCHEME_ID_MASK) == 0U);
+
+	(void)dsu_partition_init(NULL);
+}
+
+/*
+ * Program the thread scheme ID of `security_state`, which the calling CPU is
+ * about to enter. This function is meant to be invoked by the context
+ * management library when the next ERET context is set. The write is skipped
+ * when the scheme ID doesn't change, e.g. for a PSCI call that returns to the
+ * Non-secure world.
+ */
+void dsu_world_switch(unsigned int security_state)
+{
+	unsigned int core_pos;
+	uint8_t sid;
+
+	if (dsu_config == NULL)
+		return;
+
+	sid = (security_state == SECURE) ? dsu_config->secure_sid :
+					   dsu_config->ns_sid;
+
+	core_pos = plat_my_core_pos();
+	if (dsu_cur_sid[core_pos] == sid)
+		return;
+
+	write_clusterthreadsid_el1(sid);
+	dsu_cur_sid[core_pos] = sid;
+}
+
+SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, dsu_partition_init);
+SUBSCRIBE_TO_EVENT(psci_suspend_pwrdown_finish, dsu_partition_init);
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cassert.h>
+#include <cdefs.h>
+#include <ehf.h>
+#include <el3_prof.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <stdbool.h>
+#include <utils_def.h>
+
+#ifndef PLAT_EL3_PROF_PRI
+#error "Platform must define PLAT_EL3_PROF_PRI for the EL3 profiler"
+#endif
+
+/* The ring indices wrap with a mask */
+CASSERT(IS_POWER_OF_TWO(EL3_PROFILER_SAMPLES),
+	assert_el3_prof_samples_power_of_two);
+
+/*
+ * Samples of a CPU, oldest first. The ring is only accessed by its CPU, with
+ * FIQs masked outside of the sampling handlers, so that a sample can't be
+ * taken while it is updated.
+ */
+typedef struct el3_prof_ring {
+	uint64_t period;
+	uint64_t lower_el_samples;
+	uint64_t lost_samples;
+	unsigned int head;
+	unsigned int count;
+	bool running;
+	uint64_t samples[EL3_PROFILER_SAMPLES];
+} __aligned(CACHE_WRITEBACK_GRANULE) el3_prof_ring_t;
+
+static el3_prof_ring_t el3_prof_rings[PLATFORM_CORE_COUNT];
+
+static el3_prof_ring_t *el3_prof_this_ring(void)
+{
+	return &el3_prof_rings[plat_my_core_pos()];
+}
+
+/*
+ * Take a sample if the secure physical timer is running for the profiler and
+ * has expired, and program the next expiry. Return true in that case.
+ */
+static bool el3_prof_timer_expired(const el3_prof_ring_t *ring)
+{
+	if (!ring->running ||
+	    (get_cntp_ctl_istatus(read_cntps_ctl_el1()) == 0U))
+		return false;
+
+	/* Deasserts the interrupt until the next period */
+	write_cntps_tval_el1(ring->period);
+
+	return true;
+}
+
+int el3_prof_sample(uint64_t pc)
+{
+	el3_prof_ring_t *ring = el3_prof_this_ring();
+
+	if (!el3_prof_timer_expired(ring))
+		return 0;
+
+	if (ring->count == EL3_PROFILER_SAMPLES) {
+		ring->lost_samples++;
+	} else {
+		ring->samples[(ring->head + ring->count) &
+			      (EL3_PROFILER_SAMPLES - 1U)] = pc;
+		ring->count++;
+	}
+
+	return 1;
+}
+
+/*
+ * Handler of the timer interrupt when it is taken from a lower EL. The time
+ * isn't spent in BL31, so the sample is only counted.
+ */
+static int el3_prof_interrupt_handler(uint32_t intr_raw, uint32_t flags,
+		void *handle, void *cookie)
+{
+	el3_prof_ring_t *ring = el3_prof_this_ring();
+
+	if (el3_prof_timer_expired(ring))
+		ring->lower_el_samples++;
+
+	plat_ic_end_of_interrupt(intr_raw);
+
+	return 0;
+}
+
+/*
+ * Start profiling the calling CPU, with a sample every `period` ticks of the
+ * system counter. The samples and counters of a previous run are discarded.
+ * Return 0 on success, EL3_PROF_E_INVAL if the period doesn't fit in the
+ * timer.
+ */
+int el3_prof_start(uint64_t period)
+{
+	el3_prof_ring_t *ring = el3_prof_this_ring();
+	u_register_t daif;
+
+	if ((period == 0U) || (period > (uint64_t)INT32_MAX))
+		return EL3_PROF_E_INVAL;
+
+	daif = read_daif();
+	write_daifset(DAIF_FIQ_BIT);
+
+	ring->period = period;
+	ring->lower_el_samples = 0U;
+	ring->lost_samples = 0U;
+	ring->head = 0U;
+	ring->count = 0U;
+	ring->running = true;
+
+	write_cntps_tval_el1(period);
+	write_cntps_ctl_el1(U(1) << CNTP_CTL_ENABLE_SHIFT);
+
+	write_daif(daif);
+
+	return 0;
+}
+
+/*
+ * Stop profiling the calling CPU and return the number of samples taken from
+ * lower ELs and of the samples lost because the ring was full. The samples
+ * still in the ring can be read afterwards.
+ */
+void el3_prof_stop(uint64_t *lower_el_samples, uint64_t *lost_samples)
+{
+	el3_prof_ring_t *ring = el3_prof_this_ring();
+	u_register_t daif;
+
+	assert((lower_el_samples != NULL) && (lost_samples != NULL));
+
+	daif = read_daif();
+	write_daifset(DAIF_FIQ_BIT);
+
+	ring->running = false;
+	write_cntps_ctl_el1(0U);
+
+	*lower_el_samples = ring->lower_el_samples;
+	*lost_samples = ring->lost_samples;
+
+	write_daif(daif);
+}
+
+/*
+ * Remove up to `max_samples` of the oldest samples of the calling CPU from its
+ * ring and copy them to `samples`. Return the number of samples copied.
+ */
+unsigned int el3_prof_read(uint64_t *samples, unsigned int max_samples)
+{
+	el3_prof_ring_t *ring = el3_prof_this_ring();
+	unsigned int i, n;
+	u_register_t daif;
+
+	assert(samples != NULL);
+
+	daif = read_daif();
+	write_daifset(DAIF_FIQ_BIT);
+
+	n = MIN(ring->count, max_samples);
+	for (i = 0U; i < n; i++) {
+		samples[i] = ring->samples[ring->head];
+		ring->head = (ring->head + 1U) & (EL3_PROFILER_SAMPLES - 1U);
+	}
+	ring->count -= n;
+
+	write_daif(daif);
+
+	return n;
+}
+
+void __init el3_prof_init(void)
+{
+	ehf_register_priority_handler(PLAT_EL3_PROF_PRI,
+				      el3_prof_interrupt_handler);
+}
@@ -11,6 +11,7 @@
 #include <bl_common.h>
 #include <context.h>
 #include <context_mgmt.h>
+#include <dsu_partition.h>
 #include <interrupt_mgmt.h>
 #include <mpam.h>
 #include <platform.h>
@@ -23,6 +24,8 @@
 #include <sve.h>
 #include <utils.h>
 
+/* Optional EL1 system register groups switched between the security states */
+static unsigned int el1_sysregs_groups = CTX_EL1_SYSREGS_ALL;
 
 /*******************************************************************************
  * Context management library initialisation routine. This library is used by
@@ -226,6 +229,43 @@ void cm_setup_context(cpu_context_t *ctx, const entry_point_info_t *ep)
 	memcpy(gp_regs, (void *)&ep->args, sizeof(aapcs64_params_t));
 }
 
+/*******************************************************************************
+ * Same as cm_setup_context() but starting from a context `tmpl` that
+ * cm_setup_context() has already initialised for an entrypoint with the same
+ * security state, attributes and SPSR as `ep`. Only the fields that depend on
+ * the entrypoint address and arguments, or on state that may have changed
+ * since the template was made, are computed again.
+ ******************************************************************************/
+void cm_setup_context_from(cpu_context_t *ctx, const cpu_context_t *tmpl,
+			   const entry_point_info_t *ep)
+{
+	el3_state_t *state;
+#ifdef IMAGE_BL31
+	uint32_t scr_el3;
+#endif
+
+	assert((ctx != NULL) && (tmpl != NULL));
+	assert(read_ctx_reg(get_el3state_ctx(tmpl), CTX_SPSR_EL3) == ep->spsr);
+
+	memcpy(ctx, tmpl, sizeof(*ctx));
+
+	write_ctx_reg(get_sysregs_ctx(ctx), CTX_ACTLR_EL1, read_actlr_el1());
+
+	state = get_el3state_ctx(ctx);
+#ifdef IMAGE_BL31
+	/* The interrupt routing model may have changed since */
+	scr_el3 = (uint32_t)read_ctx_reg(state, CTX_SCR_EL3);
+	scr_el3 &= ~(SCR_FIQ_BIT | SCR_IRQ_BIT);
+	scr_el3 |= get_scr_el3_from_routing_model(
+				GET_SECURITY_STATE(ep->h.attr));
+	write_ctx_reg(state, CTX_SCR_EL3, scr_el3);
+#endif
+	write_ctx_reg(state, CTX_ELR_EL3, ep->pc);
+
+	memcpy(get_gpregs_ctx(ctx), (const void *)&ep->args,
+	       sizeof(aapcs64_params_t));
+}
+
 /*******************************************************************************
  * Enable architecture extensions on first entry to Non-secure world.
  * When EL2 is implemented but unused `el2_unused` is non-zero, otherwise
@@ -460,6 +500,19 @@ void cm_prepare_el3_exit(uint32_t security_state)
 	cm_set_next_eret_context(security_state);
 }
 
+/*******************************************************************************
+ * This function is used by the secure payload dispatcher to declare the
+ * optional EL1 system register groups (CTX_EL1_SYSREGS_*) that the secure
+ * payload uses. The other groups are not saved or restored when switching
+ * worlds. It must be called before the first entry into the secure payload.
+ ******************************************************************************/
+void cm_set_el1_sysregs_groups(unsigned int groups)
+{
+	assert((groups & ~CTX_EL1_SYSREGS_ALL) == 0U);
+
+	el1_sysregs_groups = groups;
+}
+
 /*******************************************************************************
  * The next four functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
@@ -472,7 +525,7 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_save(get_sysregs_ctx(ctx));
+	el1_sysregs_context_save(get_sysregs_ctx(ctx), el1_sysregs_groups);
 
 #if IMAGE_BL31
 	if (security_state == SECURE)
@@ -489,7 +542,7 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
-	el1_sysregs_context_restore(get_sysregs_ctx(ctx));
+	el1_sysregs_context_restore(get_sysregs_ctx(ctx), el1_sysregs_groups);
 
 #if IMAGE_BL31
 	if (security_state == SECURE)
@@ -499,6 +552,68 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 #endif
 }
 
+#if CTX_INCLUDE_FPREGS
+/*******************************************************************************
+ * The next two functions are used by runtime services to save and restore the
+ * FP registers on the 'cpu_context' structure for the specified security
+ * state, in the same places as the EL1 context.
+ *
+ * With CTX_LAZY_FPREGS, the Non-secure FP registers are kept in the hardware and
+ * entering the Secure world only sets CPTR_EL3.TFP. The first FP access of the
+ * Secure world traps to EL3, where lazy_fpregs_trap_handler swaps the FP
+ * registers and clears the trap. When the Secure world is left, the FP
+ * registers are only swapped back if that has happened.
+ ******************************************************************************/
+void cm_fpregs_context_save(uint32_t security_state)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+#if CTX_LAZY_FPREGS
+	if (security_state == NON_SECURE)
+		return;
+
+	if ((read_cptr_el3() & TFP_BIT) != 0U) {
+		/* The Secure world has not used the FP registers */
+		write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+		isb();
+		return;
+	}
+
+	fpregs_context_save(get_fpregs_ctx(ctx));
+
+	ctx = cm_get_context(NON_SECURE);
+	assert(ctx != NULL);
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+#else
+	fpregs_context_save(get_fpregs_ctx(ctx));
+#endif
+}
+
+void cm_fpregs_context_restore(uint32_t security_state)
+{
+#if CTX_LAZY_FPREGS
+	assert(cm_get_context(security_state) != NULL);
+
+	if (security_state == NON_SECURE)
+		return;
+
+	/* No explicit ISB required here as ERET covers it */
+	write_cptr_el3(read_cptr_el3() | TFP_BIT);
+#else
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+#endif
+}
+#endif /* CTX_INCLUDE_FPREGS */
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
@@ -597,5 +712,17 @@ void cm_set_next_eret_context(uint32_t security_state)
 	ctx = cm_get_context(security_state);
 	assert(ctx != NULL);
 
+#if IMAGE_BL31 && AMU_WORLD_STATS
+	amu_world_switch(security_state);
+#endif
+
+#if IMAGE_BL31 && MPAM_WORLD_PARTID
+	mpam_world_switch(security_state);
+#endif
+
+#if IMAGE_BL31 && DSU_L3_PARTITIONING
+	dsu_world_switch(security_state);
+#endif
+
 	cm_set_next_context(ctx);
 }
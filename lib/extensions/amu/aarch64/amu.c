@@ -9,7 +9,9 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <ep_info.h>
 #include <platform.h>
+#include <pmf.h>
 #include <pubsub_events.h>
 #include <stdbool.h>
 
@@ -22,6 +24,26 @@ struct amu_ctx {
 
 static struct amu_ctx amu_ctxs[PLATFORM_CORE_COUNT];
 
+#if AMU_WORLD_STATS
+/*
+ * Per-world activity statistics. The group 0 counters are sampled when a CPU
+ * switches to another security state, and their increments since the previous
+ * switch are added to the totals of the security state the CPU was running.
+ * The totals are published as PMF time-stamps, see AMU_STATS_*.
+ */
+struct amu_world_ctx {
+	uint64_t totals[AMU_STATS_TOTAL_IDS];
+	uint64_t group0_cnts[AMU_GROUP0_NR_COUNTERS];
+	unsigned int security_state;
+	bool started;
+};
+
+static struct amu_world_ctx amu_world_ctxs[PLATFORM_CORE_COUNT];
+
+PMF_REGISTER_SERVICE_SMC(amu_svc, PMF_AMU_SVC_ID, AMU_STATS_TOTAL_IDS,
+			 PMF_STORE_ENABLE)
+#endif
+
 bool amu_supported(void)
 {
 	uint64_t features;
@@ -116,6 +138,47 @@ void amu_group1_set_evtype(int idx, unsigned int val)
 	isb();
 }
 
+#if AMU_WORLD_STATS
+/*
+ * Account the activity of the calling CPU to the security state it was
+ * running, before it switches to `security_state`. This function is meant to
+ * be invoked by the context management library when the next ERET context is
+ * set. Nothing is accounted when the security state doesn't change.
+ */
+void amu_world_switch(unsigned int security_state)
+{
+	struct amu_world_ctx *ctx = &amu_world_ctxs[plat_my_core_pos()];
+	unsigned int offset;
+	uint64_t cnt;
+	int i;
+
+	if (ctx->started && (ctx->security_state == security_state))
+		return;
+
+	if (!amu_supported())
+		return;
+
+	offset = (ctx->security_state == NON_SECURE) ?
+		AMU_STATS_NS_OFFSET : 0U;
+
+	for (i = 0; i < AMU_GROUP0_NR_COUNTERS; i++) {
+		cnt = amu_group0_cnt_read_internal(i);
+
+		if (ctx->started) {
+			ctx->totals[offset + i] += cnt - ctx->group0_cnts[i];
+			PMF_WRITE_TIMESTAMP(amu_svc, offset + i,
+					    PMF_NO_CACHE_MAINT,
+					    ctx->totals[offset + i]);
+		}
+
+		ctx->group0_cnts[i] = cnt;
+	}
+
+	ctx->security_state = security_state;
+	ctx->started = true;
+}
+#endif /* AMU_WORLD_STATS */
+
 static void *amu_context_save(const void *arg)
 {
 	struct amu_ctx *ctx = &amu_ctxs[plat_my_core_pos()];
@@ -6,12 +6,48 @@
 
 #include <arch.h>
 #include <arch_helpers.h>
+#include <ep_info.h>
 #include <mpam.h>
+#include <platform.h>
 #include <stdbool.h>
 
+#if MPAM_WORLD_PARTID
+/*
+ * Per-world partitions. Whenever a CPU enters the Secure world, EL3 assigns the
+ * Secure EL1 and EL0 accesses to the partition selected by the platform, or by
+ * the SPM for the secure partition being entered. The partition programmed by
+ * the Non-secure world is saved when it is left and restored when it is
+ * entered again.
+ */
+struct mpam_world_ctx {
+	uint64_t ns_mpam0;
+	uint64_t ns_mpam1;
+	uint64_t secure_partid_pmg;
+	unsigned int security_state;
+	bool started;
+};
+
+static struct mpam_world_ctx mpam_world_ctxs[PLATFORM_CORE_COUNT];
+
+static struct mpam_world_ctx *mpam_get_world_ctx(void)
+{
+	struct mpam_world_ctx *ctx = &mpam_world_ctxs[plat_my_core_pos()];
+
+	if (!ctx->started) {
+		ctx->ns_mpam0 = plat_mpam_get_partid_pmg(NON_SECURE);
+		ctx->ns_mpam1 = ctx->ns_mpam0;
+		ctx->secure_partid_pmg = plat_mpam_get_partid_pmg(SECURE);
+		ctx->security_state = NON_SECURE;
+		ctx->started = true;
+	}
+
+	return ctx;
+}
+#endif /* MPAM_WORLD_PARTID */
+
 bool mpam_supported(void)
 {
-	uint64_t features = read_id_aa64dfr0_el1() >> ID_AA64PFR0_MPAM_SHIFT;
+	uint64_t features = read_id_aa64pfr0_el1() >> ID_AA64PFR0_MPAM_SHIFT;
 
 	return ((features & ID_AA64PFR0_MPAM_MASK) != 0U);
 }
@@ -38,3 +74,48 @@ void mpam_enable(bool el2_unused)
 			write_mpamhcr_el2(0);
 	}
 }
+
+#if MPAM_WORLD_PARTID
+/*
+ * Program the MPAM partition of the lower ELs of `security_state`, which the
+ * calling CPU is about to enter. This function is meant to be invoked by the
+ * context management library when the next ERET context is set.
+ */
+void mpam_world_switch(unsigned int security_state)
+{
+	struct mpam_world_ctx *ctx;
+
+	if (!mpam_supported())
+		return;
+
+	ctx = mpam_get_world_ctx();
+
+	if (security_state == NON_SECURE) {
+		if (ctx->security_state != NON_SECURE) {
+			write_mpam0_el1(ctx->ns_mpam0);
+			write_mpam1_el1(ctx->ns_mpam1);
+		}
+	} else {
+		if (ctx->security_state == NON_SECURE) {
+			ctx->ns_mpam0 = read_mpam0_el1();
+			ctx->ns_mpam1 = read_mpam1_el1();
+		}
+
+		/* The partition of the Secure world may change at each entry */
+		write_mpam0_el1(ctx->secure_partid_pmg);
+		write_mpam1_el1(ctx->secure_partid_pmg);
+	}
+
+	ctx->security_state = security_state;
+}
+
+/*
+ * Select the partition, built with MPAM_PARTID_PMG(), assigned to the Secure
+ * world by the next mpam_world_switch() into it on the calling CPU. The SPM
+ * calls this function with the partition of each secure partition it enters.
+ */
+void mpam_set_secure_partid(uint64_t partid_pmg)
+{
+	mpam_get_world_ctx()->secure_partid_pmg = partid_pmg;
+}
+#endif /* MPAM_WORLD_PARTID */
@@ -5,24 +5,215 @@
  */
 
 #include <arch_helpers.h>
+#include <context_mgmt.h>
 #include <debug.h>
 #include <ea_handle.h>
 #include <ehf.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <ras.h>
 #include <ras_arch.h>
+#include <spinlock.h>
 #include <stdbool.h>
 
 #ifndef PLAT_RAS_PRI
 # error Platform must define RAS priority value
 #endif
 
+/*
+ * Probe an error record group until it signals no error, and call its handler
+ * for each error found. Return the first non-zero value returned by the
+ * handler, or 0, and add the number of errors handled to `n_handled`.
+ */
+static int ras_handle_group(struct err_record_info *info,
+		const struct err_handler_data *err_data, unsigned int *n_handled)
+{
+	int probe_data, ret;
+
+	assert(info->probe != NULL);
+	assert(info->handler != NULL);
+
+	while (info->probe(info, &probe_data) != 0) {
+		ret = info->handler(info, probe_data, err_data);
+		if (ret != 0)
+			return ret;
+
+		(*n_handled)++;
+	}
+
+	return 0;
+}
+
+#if RAS_EA_DEFERRED
+/*
+ * Deferred handling of the corrected errors signalled by External Aborts. The
+ * External Abort handler only queues the syndrome in a ring of the CPU and
+ * returns, so that a burst of corrected errors doesn't hold the CPU in EL3.
+ * The error record groups are probed and handled later, in bulk, by
+ * ras_ea_process_deferred(), each group at most once per
+ * PLAT_RAS_EA_MIN_INTERVAL_MS.
+ */
+#ifndef PLAT_RAS_EA_RING_SIZE
+#define PLAT_RAS_EA_RING_SIZE		U(16)
+#endif
+
+#ifndef PLAT_RAS_EA_MIN_INTERVAL_MS
+#define PLAT_RAS_EA_MIN_INTERVAL_MS	U(10)
+#endif
+
+struct ras_ea_entry {
+	uint64_t syndrome;
+	uint64_t timestamp;
+	unsigned int ea_reason;
+};
+
+struct ras_ea_ring {
+	struct ras_ea_entry entries[PLAT_RAS_EA_RING_SIZE];
+	unsigned int head;
+	unsigned int count;
+	/* Number of External Aborts not queued because the ring was full */
+	unsigned int lost;
+};
+
+/*
+ * A ring is only accessed by its CPU, with External Aborts taken to EL3 not
+ * handled by this framework, so it needs no lock.
+ */
+static struct ras_ea_ring ras_ea_rings[PLATFORM_CORE_COUNT];
+
+static spinlock_t ras_ea_deferred_lock;
+
+/* Whether a group was skipped by the rate limit with errors to handle */
+static bool ras_ea_deferred_retry;
+
+/*
+ * Only corrected errors, whose syndrome is architected, are deferred. The
+ * other errors may need to be contained before the faulting context resumes.
+ */
+static bool ras_ea_is_deferrable(unsigned int ea_reason, uint64_t syndrome)
+{
+	if ((ea_reason != ERROR_EA_ASYNC) && (ea_reason != ERROR_EA_ESB))
+		return false;
+
+	if ((syndrome & BIT_64(SERROR_IDS_BIT)) != 0ULL)
+		return false;
+
+	if (((syndrome >> EABORT_DFSC_SHIFT) & EABORT_DFSC_MASK) !=
+	    DFSC_SERROR)
+		return false;
+
+	return ((syndrome >> EABORT_AET_SHIFT) & EABORT_AET_MASK) ==
+		EABORT_AET_CE;
+}
+
+static void ras_ea_defer(unsigned int ea_reason, uint64_t syndrome)
+{
+	struct ras_ea_ring *ring = &ras_ea_rings[plat_my_core_pos()];
+	struct ras_ea_entry *entry;
+
+	if (ring->count == PLAT_RAS_EA_RING_SIZE) {
+		ring->lost++;
+		return;
+	}
+
+	entry = &ring->entries[(ring->head + ring->count) %
+			       PLAT_RAS_EA_RING_SIZE];
+	entry->syndrome = syndrome;
+	entry->timestamp = read_cntpct_el0();
+	entry->ea_reason = ea_reason;
+	ring->count++;
+}
+
+/* Claim a group for handling, unless it was handled too recently */
+static bool ras_ea_rate_limit_pass(struct err_record_info *info, uint64_t now,
+		uint64_t interval)
+{
+	bool pass;
+
+	spin_lock(&ras_ea_deferred_lock);
+	pass = (info->last_handled == 0ULL) ||
+		((now - info->last_handled) >= interval);
+	if (pass)
+		info->last_handled = now;
+	else
+		ras_ea_deferred_retry = true;
+	spin_unlock(&ras_ea_deferred_lock);
+
+	return pass;
+}
+
+/*
+ * Handle the errors deferred by the External Abort handler. The platform calls
+ * this function periodically, e.g. from the handler of a Secure timer
+ * interrupt, with `security_state` the state that was interrupted. The queued
+ * syndromes of the calling CPU are drained, and all the error record groups
+ * not handled in the last PLAT_RAS_EA_MIN_INTERVAL_MS are probed and handled;
+ * the others are retried at the next call. Return the number of errors
+ * handled, or the first non-zero value returned by an error handler if it is
+ * negative.
+ */
+int ras_ea_process_deferred(unsigned int security_state)
+{
+	struct ras_ea_ring *ring = &ras_ea_rings[plat_my_core_pos()];
+	struct err_record_info *info;
+	unsigned int i, n_handled = 0U;
+	uint64_t now, interval;
+	bool retry;
+	int ret;
+
+	const struct err_handler_data err_data = {
+		.version = ERR_HANDLER_VERSION,
+		.ea_reason = ERROR_EA_ASYNC,
+		.interrupt = 0,
+		.syndrome = (ring->count != 0U) ? (uint32_t)
+			ring->entries[ring->head].syndrome : 0U,
+		.flags = security_state & 1U,
+		.cookie = NULL,
+		.handle = cm_get_context(security_state)
+	};
+
+	spin_lock(&ras_ea_deferred_lock);
+	retry = ras_ea_deferred_retry;
+	ras_ea_deferred_retry = false;
+	spin_unlock(&ras_ea_deferred_lock);
+
+	if ((ring->count == 0U) && (ring->lost == 0U) && !retry)
+		return 0;
+
+	for (i = 0U; i < ring->count; i++) {
+		VERBOSE("RAS: deferred EA %u syndrome 0x%llx at %llu\n",
+			ring->entries[ring->head].ea_reason,
+			ring->entries[ring->head].syndrome,
+			ring->entries[ring->head].timestamp);
+		ring->head = (ring->head + 1U) % PLAT_RAS_EA_RING_SIZE;
+	}
+	if (ring->lost != 0U)
+		WARN("RAS: %u deferred EAs not queued\n", ring->lost);
+	ring->count = 0U;
+	ring->lost = 0U;
+
+	now = read_cntpct_el0();
+	interval = (read_cntfrq_el0() * PLAT_RAS_EA_MIN_INTERVAL_MS) / 1000U;
+
+	for_each_err_record_info(i, info) {
+		if (!ras_ea_rate_limit_pass(info, now, interval))
+			continue;
+
+		ret = ras_handle_group(info, &err_data, &n_handled);
+		if (ret < 0)
+			return ret;
+	}
+
+	return (int)n_handled;
+}
+#endif /* RAS_EA_DEFERRED */
+
 /* Handler that receives External Aborts on RAS-capable systems */
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
 {
 	unsigned int i, n_handled = 0;
-	int probe_data, ret;
+	int ret;
 	struct err_record_info *info;
 
 	const struct err_handler_data err_data = {
@@ -35,22 +226,17 @@ int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		.handle = handle
 	};
 
-	for_each_err_record_info(i, info) {
-		assert(info->probe != NULL);
-		assert(info->handler != NULL);
-
-		/* Continue probing until the record group signals no error */
-		while (true) {
-			if (info->probe(info, &probe_data) == 0)
-				break;
-
-			/* Handle error */
-			ret = info->handler(info, probe_data, &err_data);
-			if (ret != 0)
-				return ret;
+#if RAS_EA_DEFERRED
+	if (ras_ea_is_deferrable(ea_reason, syndrome)) {
+		ras_ea_defer(ea_reason, syndrome);
+		return 1;
+	}
+#endif
 
-			n_handled++;
-		}
+	for_each_err_record_info(i, info) {
+		ret = ras_handle_group(info, &err_data, &n_handled);
+		if (ret != 0)
+			return ret;
 	}
 
 	return (n_handled != 0U) ? 1 : 0;
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl_common.h>
+#include <cassert.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <interrupt_mgmt.h>
+#include <platform_def.h>
+#include <ras.h>
+#include <ras_arch.h>
+#include <ras_err_log.h>
+#include <sdei.h>
+#include <spinlock.h>
+#include <stdbool.h>
+
+#if !SDEI_SUPPORT
+#error "The RAS error log requires SDEI_SUPPORT=1"
+#endif
+
+/*
+ * RAS error log. The error record groups using ras_err_log_handler() are
+ * scanned together: on a RAS notification for any of them, or when the
+ * platform polls them, every record in error is logged to the shared memory
+ * log and cleared, and the Non-secure world gets a single SDEI event for all
+ * of them.
+ */
+#define RAS_ERR_LOG_MAX_ENTRIES						\
+	((PLAT_RAS_ERR_LOG_SIZE - sizeof(struct ras_err_log_hdr)) /	\
+	 sizeof(struct ras_err_log_entry))
+
+CASSERT(PLAT_RAS_ERR_LOG_SIZE >= (sizeof(struct ras_err_log_hdr) +
+	sizeof(struct ras_err_log_entry)), assert_ras_err_log_size);
+
+static spinlock_t ras_err_log_lock;
+
+/* Whether errors have been logged since the last SDEI event */
+static bool ras_err_log_pending;
+
+static struct ras_err_log_hdr *ras_err_log_get_hdr(void)
+{
+	struct ras_err_log_hdr *hdr =
+		(struct ras_err_log_hdr *)PLAT_RAS_ERR_LOG_BASE;
+
+	if (hdr->signature != RAS_ERR_LOG_SIGNATURE) {
+		hdr->version = RAS_ERR_LOG_VERSION;
+		hdr->max_entries = RAS_ERR_LOG_MAX_ENTRIES;
+		hdr->num_entries = 0U;
+		hdr->lost = 0U;
+		hdr->reserved = 0U;
+		dmbish();
+		hdr->signature = RAS_ERR_LOG_SIGNATURE;
+	}
+
+	return hdr;
+}
+
+static void ras_err_log_append(struct ras_err_log_hdr *hdr,
+		const struct ras_err_log_entry *entry)
+{
+	struct ras_err_log_entry *entries = (struct ras_err_log_entry *)
+		(hdr + 1);
+	uint32_t n = hdr->num_entries;
+
+	/* The header is writable by the Non-secure world */
+	if (n >= RAS_ERR_LOG_MAX_ENTRIES) {
+		hdr->lost++;
+		return;
+	}
+
+	entries[n] = *entry;
+
+	/* Publish the entry after its contents */
+	dmbish();
+	hdr->num_entries = n + 1U;
+}
+
+/* Log and clear the memory-mapped Standard Error Records in error */
+static unsigned int ras_err_log_scan_memmap(struct ras_err_log_hdr *hdr,
+		unsigned int group, const struct err_record_info *info)
+{
+	struct ras_err_log_entry entry;
+	uintptr_t base = info->memmap.base_addr;
+	unsigned int size_num_k = info->memmap.size_num_k;
+	unsigned int num_records, i, n = 0U;
+	uint64_t gsr;
+
+	assert(base != 0UL);
+	assert(size_num_k == STD_ERR_NODE_SIZE_NUM_K);
+
+	num_records = (unsigned int)
+		(mmio_read_32(ERR_DEVID(base, size_num_k)) & ERR_DEVID_MASK);
+
+	/*
+	 * A group register shows error status for 2^6 error records, so only
+	 * the records flagged in it are read.
+	 */
+	for (i = 0U; i < ((num_records + 63U) >> 6U); i++) {
+		gsr = mmio_read_64(ERR_GSR(base, size_num_k, i));
+
+		while (gsr != 0ULL) {
+			entry.record = (i << 6U) +
+				(unsigned int)__builtin_ctzll(gsr);
+			gsr &= gsr - 1ULL;
+
+			entry.status = ser_get_status(base, entry.record);
+			if (ERR_STATUS_GET_FIELD(entry.status, V) == 0U)
+				continue;
+
+			entry.group = group;
+			entry.addr = ser_get_addr(base, entry.record);
+			entry.misc0 = ser_get_misc0(base, entry.record);
+			entry.misc1 = ser_get_misc1(base, entry.record);
+			ras_err_log_append(hdr, &entry);
+
+			ser_set_status(base, entry.record, entry.status);
+			n++;
+		}
+	}
+
+	return n;
+}
+
+/* Log and clear the System register Standard Error Records in error */
+static unsigned int ras_err_log_scan_sysreg(struct ras_err_log_hdr *hdr,
+		unsigned int group, const struct err_record_info *info)
+{
+	struct ras_err_log_entry entry;
+	unsigned int i, n = 0U;
+
+	for (i = 0U; i < info->sysreg.num_idx; i++) {
+		ser_sys_select_record(info->sysreg.idx_start + i);
+
+		entry.status = read_erxstatus_el1();
+		if (ERR_STATUS_GET_FIELD(entry.status, V) == 0U)
+			continue;
+
+		entry.group = group;
+		entry.record = i;
+		entry.addr = read_erxaddr_el1();
+		entry.misc0 = read_erxmisc0_el1();
+		entry.misc1 = read_erxmisc1_el1();
+		ras_err_log_append(hdr, &entry);
+
+		write_erxstatus_el1(entry.status);
+		n++;
+	}
+
+	return n;
+}
+
+/*
+ * Scan, in one pass, all the error record groups using ras_err_log_handler().
+ * The records in error are logged and cleared. Return the number of records
+ * found in error.
+ */
+unsigned int ras_err_log_scan(void)
+{
+	struct ras_err_log_hdr *hdr;
+	struct err_record_info *info;
+	unsigned int i, n = 0U;
+
+	spin_lock(&ras_err_log_lock);
+
+	hdr = ras_err_log_get_hdr();
+
+	for_each_err_record_info(i, info) {
+		if (info->handler != ras_err_log_handler)
+			continue;
+
+		if (info->access == ERR_ACCESS_MEMMAP)
+			n += ras_err_log_scan_memmap(hdr, i, info);
+		else
+			n += ras_err_log_scan_sysreg(hdr, i, info);
+	}
+
+	if (n != 0U)
+		ras_err_log_pending = true;
+
+	spin_unlock(&ras_err_log_lock);
+
+	return n;
+}
+
+/*
+ * Dispatch the PLAT_RAS_ERR_LOG_SDEI_EVENT event on this CPU if errors have
+ * been logged since the last dispatch. `security_state` is the state that was
+ * interrupted by the RAS notification, and which is resumed afterwards. Return
+ * 0 if nothing had to be reported or the event completed, -1 otherwise.
+ */
+int ras_err_log_report(unsigned int security_state)
+{
+	int ret;
+
+	spin_lock(&ras_err_log_lock);
+	if (!ras_err_log_pending) {
+		spin_unlock(&ras_err_log_lock);
+		return 0;
+	}
+	ras_err_log_pending = false;
+	spin_unlock(&ras_err_log_lock);
+
+	/*
+	 * The SDEI dispatcher resumes the saved Non-secure context, so save
+	 * the live EL1 context of the interrupted state first.
+	 */
+	cm_el1_sysregs_context_save(security_state);
+
+	ret = sdei_dispatch_event(PLAT_RAS_ERR_LOG_SDEI_EVENT);
+	if (ret != 0) {
+		/* Report the errors with the next event instead */
+		WARN("RAS: Failed to dispatch the error log event\n");
+		spin_lock(&ras_err_log_lock);
+		ras_err_log_pending = true;
+		spin_unlock(&ras_err_log_lock);
+	}
+
+	if (security_state == SECURE) {
+		cm_el1_sysregs_context_restore(SECURE);
+		cm_set_next_eret_context(SECURE);
+	}
+
+	return ret;
+}
+
+/*
+ * Scan the error records and report the errors found, for platforms polling
+ * their error records periodically, e.g. from a timer interrupt handler.
+ * Return the number of records found in error, or -1 if they couldn't be
+ * reported.
+ */
+int ras_err_log_poll(unsigned int security_state)
+{
+	unsigned int n = ras_err_log_scan();
+
+	if (ras_err_log_report(security_state) != 0)
+		return -1;
+
+	return (int)n;
+}
+
+/*
+ * Error handler for the error record groups to aggregate in the error log.
+ * Whichever group signalled the error, all the groups using this handler are
+ * scanned and reported together.
+ */
+int ras_err_log_handler(const struct err_record_info *info, int probe_data,
+		const struct err_handler_data *const data)
+{
+	assert(data != NULL);
+
+	(void)ras_err_log_scan();
+	(void)ras_err_log_report(get_interrupt_src_ss(data->flags));
+
+	return 0;
+}
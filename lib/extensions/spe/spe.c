@@ -72,7 +72,7 @@ void spe_disable(void)
 
 	/* Disable profiling buffer */
 	v = read_pmblimitr_el1();
-	v &= ~(1ULL << 0);
+	v &= ~PMBLIMITR_EL1_E_BIT;
 	write_pmblimitr_el1(v);
 	isb();
 }
@@ -82,6 +82,15 @@ static void *spe_drain_buffers_hook(const void *arg)
 	if (!spe_supported())
 		return (void *)-1;
 
+	/*
+	 * Nothing can be buffered while the profiling buffer is disabled, which
+	 * is the case whenever the Non-secure world isn't profiling. The buffer
+	 * is otherwise left enabled: profiling is prohibited in Secure state by
+	 * MDCR_EL3.NSPB, and resumes when the Non-secure world is entered again.
+	 */
+	if ((read_pmblimitr_el1() & PMBLIMITR_EL1_E_BIT) == 0U)
+		return (void *)0;
+
 	/* Drain buffered data */
 	psb_csync();
 	dsbnsh();
@@ -9,10 +9,7 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,	\
 			assert.c			\
 			exit.c				\
 			memchr.c			\
-			memcmp.c			\
-			memcpy.c			\
 			memmove.c			\
-			memset.c			\
 			printf.c			\
 			putchar.c			\
 			puts.c				\
@@ -20,10 +17,26 @@ LIBC_SRCS	:=	$(addprefix lib/libc/,	\
 			strchr.c			\
 			strcmp.c			\
 			strlcpy.c			\
-			strlen.c			\
 			strncmp.c			\
 			strnlen.c			\
 			strrchr.c)
 
+# AArch64 has optimised assembly versions of the memory copy, fill and
+# compare primitives and of strlen(). Other architectures use the generic C
+# implementations.
+ifeq (${ARCH},aarch64)
+LIBC_SRCS	+=	$(addprefix lib/libc/aarch64/,	\
+			memcmp.S			\
+			memcpy.S			\
+			memset.S			\
+			strlen.S)
+else
+LIBC_SRCS	+=	$(addprefix lib/libc/,	\
+			memcmp.c			\
+			memcpy.c			\
+			memset.c			\
+			strlen.c)
+endif
+
 INCLUDES	+=	-Iinclude/lib/libc		\
 			-Iinclude/lib/libc/$(ARCH)	\
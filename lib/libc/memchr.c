@@ -5,13 +5,45 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
+
+#if UINTPTR_MAX > 0xffffffffU
+#define ONES	0x0101010101010101U
+#define HIGHS	0x8080808080808080U
+#else
+#define ONES	0x01010101U
+#define HIGHS	0x80808080U
+#endif
+
+/* Non-zero if one of the bytes of the word x is zero. */
+#define HAS_ZERO(x)	(((x) - ONES) & ~(x) & HIGHS)
 
 void *memchr(const void *src, int c, size_t len)
 {
-	const char *s = src;
+	const unsigned char *s = src;
+	const uintptr_t *ws;
+	unsigned char ch = (unsigned char)c;
+	uintptr_t mask = ch * ONES;
+
+	/* Look for the byte byte per byte until the pointer is aligned. */
+	while ((len != 0U) &&
+	       (((uintptr_t)s & (sizeof(uintptr_t) - 1U)) != 0U)) {
+		if (*s == ch)
+			return (void *) s;
+		s++;
+		len--;
+	}
+
+	/* Skip the words that do not contain the byte. */
+	ws = (const uintptr_t *)s;
+	while ((len >= sizeof(uintptr_t)) && (HAS_ZERO(*ws ^ mask) == 0U)) {
+		ws++;
+		len -= sizeof(uintptr_t);
+	}
 
+	s = (const unsigned char *)ws;
 	while (len--) {
-		if (*s == c)
+		if (*s == ch)
 			return (void *) s;
 		s++;
 	}
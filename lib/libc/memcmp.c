@@ -5,14 +5,42 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 
 int memcmp(const void *s1, const void *s2, size_t len)
 {
 	const unsigned char *s = s1;
 	const unsigned char *d = s2;
+	const uintptr_t *ws;
+	const uintptr_t *wd;
 	unsigned char sc;
 	unsigned char dc;
 
+	/*
+	 * If both buffers can be word-aligned, skip over the identical words
+	 * and let the byte loop find the first difference.
+	 */
+	if ((((uintptr_t)s ^ (uintptr_t)d) & (sizeof(uintptr_t) - 1U)) == 0U) {
+		while ((len != 0U) &&
+		       (((uintptr_t)s & (sizeof(uintptr_t) - 1U)) != 0U)) {
+			if (*s != *d)
+				return (*s - *d);
+			s++;
+			d++;
+			len--;
+		}
+
+		ws = (const uintptr_t *)s;
+		wd = (const uintptr_t *)d;
+		while ((len >= sizeof(uintptr_t)) && (*ws == *wd)) {
+			ws++;
+			wd++;
+			len -= sizeof(uintptr_t);
+		}
+		s = (const unsigned char *)ws;
+		d = (const unsigned char *)wd;
+	}
+
 	while (len--) {
 		sc = *s++;
 		dc = *d++;
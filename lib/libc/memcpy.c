@@ -5,12 +5,37 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 
 void *memcpy(void *dst, const void *src, size_t len)
 {
 	const char *s = src;
 	char *d = dst;
 
+	/*
+	 * If both buffers can be aligned to the same boundary, copy one word at
+	 * a time once the head has been copied byte per byte. Unaligned
+	 * accesses are never issued.
+	 */
+	if ((len >= sizeof(uintptr_t)) &&
+	    ((((uintptr_t)s ^ (uintptr_t)d) & (sizeof(uintptr_t) - 1U)) == 0U)) {
+		const uintptr_t *ws;
+		uintptr_t *wd;
+
+		while (((uintptr_t)d & (sizeof(uintptr_t) - 1U)) != 0U) {
+			*d++ = *s++;
+			len--;
+		}
+
+		ws = (const uintptr_t *)s;
+		wd = (uintptr_t *)d;
+		for (; len >= sizeof(uintptr_t); len -= sizeof(uintptr_t))
+			*wd++ = *ws++;
+
+		s = (const char *)ws;
+		d = (char *)wd;
+	}
+
 	while (len--)
 		*d++ = *s++;
 
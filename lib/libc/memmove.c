@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdint.h>
 #include <string.h>
 
 void *memmove(void *dst, const void *src, size_t len)
@@ -24,6 +25,31 @@ void *memmove(void *dst, const void *src, size_t len)
 		const char *end = dst;
 		const char *s = (const char *)src + len;
 		char *d = (char *)dst + len;
+
+		/*
+		 * ...one word at a time if both buffers can be aligned to the
+		 * same boundary, once the tail has been copied byte per byte.
+		 */
+		if ((len >= sizeof(uintptr_t)) &&
+		    ((((uintptr_t)s ^ (uintptr_t)d) &
+		      (sizeof(uintptr_t) - 1U)) == 0U)) {
+			const uintptr_t *ws;
+			uintptr_t *wd;
+
+			while (((uintptr_t)d & (sizeof(uintptr_t) - 1U)) != 0U) {
+				*--d = *--s;
+				len--;
+			}
+
+			ws = (const uintptr_t *)s;
+			wd = (uintptr_t *)d;
+			for (; len >= sizeof(uintptr_t); len -= sizeof(uintptr_t))
+				*--wd = *--ws;
+
+			s = (const char *)ws;
+			d = (char *)wd;
+		}
+
 		while (d != end)
 			*--d = *--s;
 	}
@@ -5,11 +5,35 @@
  */
 
 #include <stddef.h>
+#include <stdint.h>
 
 void *memset(void *dst, int val, size_t count)
 {
 	char *ptr = dst;
+	uintptr_t *wptr;
+	uintptr_t fill = (unsigned char)val;
 
+	/* Fill byte per byte until the pointer is word-aligned. */
+	while ((count != 0U) &&
+	       (((uintptr_t)ptr & (sizeof(uintptr_t) - 1U)) != 0U)) {
+		*ptr++ = val;
+		count--;
+	}
+
+	/* Duplicate the fill byte to the rest of the word. */
+	fill |= fill << 8;
+	fill |= fill << 16;
+#if UINTPTR_MAX > 0xffffffffU
+	fill |= fill << 32;
+#endif
+
+	/* Use word writes for as long as possible. */
+	wptr = (uintptr_t *)ptr;
+	for (; count >= sizeof(uintptr_t); count -= sizeof(uintptr_t))
+		*wptr++ = fill;
+
+	/* Handle the remaining part byte per byte. */
+	ptr = (char *)wptr;
 	while (count--)
 		*ptr++ = val;
 
@@ -37,14 +37,53 @@
  * All rights reserved.
  */
 
+#include <stdint.h>
 #include <string.h>
 
+#if UINTPTR_MAX > 0xffffffffU
+#define ONES	0x0101010101010101U
+#define HIGHS	0x8080808080808080U
+#else
+#define ONES	0x01010101U
+#define HIGHS	0x80808080U
+#endif
+
+/* Non-zero if one of the bytes of the word x is zero. */
+#define HAS_ZERO(x)	(((x) - ONES) & ~(x) & HIGHS)
+
 /*
  * Compare strings.
  */
 int
 strcmp(const char *s1, const char *s2)
 {
+	const uintptr_t *w1, *w2;
+
+	/*
+	 * If both strings can be word-aligned, skip over the identical words
+	 * that do not hold the terminator, then finish byte per byte.
+	 */
+	if ((((uintptr_t)s1 ^ (uintptr_t)s2) & (sizeof(uintptr_t) - 1U)) == 0U) {
+		while (((uintptr_t)s1 & (sizeof(uintptr_t) - 1U)) != 0U) {
+			if (*s1 != *s2)
+				return (*(const unsigned char *)s1 -
+					*(const unsigned char *)s2);
+			if (*s1 == '\0')
+				return (0);
+			s1++;
+			s2++;
+		}
+
+		w1 = (const uintptr_t *)s1;
+		w2 = (const uintptr_t *)s2;
+		while ((*w1 == *w2) && (HAS_ZERO(*w1) == 0U)) {
+			w1++;
+			w2++;
+		}
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
 	while (*s1 == *s2++)
 		if (*s1++ == '\0')
 			return (0);
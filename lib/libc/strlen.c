@@ -4,12 +4,41 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdint.h>
 #include <string.h>
 
+#if UINTPTR_MAX > 0xffffffffU
+#define ONES	0x0101010101010101U
+#define HIGHS	0x8080808080808080U
+#else
+#define ONES	0x01010101U
+#define HIGHS	0x80808080U
+#endif
+
+/* Non-zero if one of the bytes of the word x is zero. */
+#define HAS_ZERO(x)	(((x) - ONES) & ~(x) & HIGHS)
+
 size_t strlen(const char *s)
 {
 	const char *cursor = s;
+	const uintptr_t *wcursor;
+
+	/* Look for the terminator byte per byte until cursor is aligned. */
+	while (((uintptr_t)cursor & (sizeof(uintptr_t) - 1U)) != 0U) {
+		if (*cursor == '\0')
+			return cursor - s;
+		cursor++;
+	}
+
+	/*
+	 * Skip the words without a zero byte. An aligned word never crosses
+	 * the end of the mapping holding the string.
+	 */
+	wcursor = (const uintptr_t *)cursor;
+	while (HAS_ZERO(*wcursor) == 0U)
+		wcursor++;
 
+	cursor = (const char *)wcursor;
 	while (*cursor)
 		cursor++;
 
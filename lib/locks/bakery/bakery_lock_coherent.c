@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <bakery_lock.h>
 #include <cpu_data.h>
+#include <lock_stats.h>
 #include <platform.h>
 #include <string.h>
 
@@ -93,6 +94,10 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	unsigned int they, me;
 	unsigned int my_ticket, my_prio, their_ticket;
 	unsigned int their_bakery_data;
+	bool contended = false;
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+	uint64_t start = read_cntpct_el0();
+#endif
 
 	me = plat_my_core_pos();
 
@@ -128,6 +133,7 @@ void bakery_lock_get(bakery_lock_t *bakery)
 			 * to have it dropped to 0; or drop and probably content
 			 * again for the same lock to have an even higher value)
 			 */
+			contended = true;
 			do {
 				wfe();
 			} while (their_ticket ==
@@ -140,6 +146,18 @@ void bakery_lock_get(bakery_lock_t *bakery)
 	 * critical section read values after the lock is acquired.
 	 */
 	dmbld();
+
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+	/*
+	 * Unlike the lock, the statistics are in normal memory, so they can
+	 * only be updated with the data cache enabled.
+	 */
+	if ((read_sctlr_el3() & SCTLR_C_BIT) != 0U)
+		lock_stats_record(bakery, contended,
+				  contended ? (read_cntpct_el0() - start) : 0U);
+#else
+	(void)contended;
+#endif
 }
 
 
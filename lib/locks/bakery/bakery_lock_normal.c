@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <bakery_lock.h>
 #include <cpu_data.h>
+#include <lock_stats.h>
 #include <platform.h>
 #include <string.h>
 #include <utils_def.h>
@@ -162,6 +163,10 @@ void bakery_lock_get(bakery_lock_t *lock)
 	unsigned int my_ticket, my_prio, their_ticket;
 	bakery_info_t *their_bakery_info;
 	unsigned int their_bakery_data;
+	bool contended = false;
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+	uint64_t start = read_cntpct_el0();
+#endif
 
 	me = plat_my_core_pos();
 #ifdef AARCH32
@@ -207,6 +212,7 @@ void bakery_lock_get(bakery_lock_t *lock)
 			 * to have it dropped to 0; or drop and probably content
 			 * again for the same lock to have an even higher value)
 			 */
+			contended = true;
 			do {
 				wfe();
 				read_cache_op((uintptr_t)their_bakery_info, is_cached);
@@ -220,6 +226,15 @@ void bakery_lock_get(bakery_lock_t *lock)
 	 * critical section read values after the lock is acquired.
 	 */
 	dmbld();
+
+#if ENABLE_LOCK_STATS && defined(IMAGE_BL31)
+	/* The statistics are in cacheable memory */
+	if (is_cached != 0U)
+		lock_stats_record(lock, contended,
+				  contended ? (read_cntpct_el0() - start) : 0U);
+#else
+	(void)contended;
+#endif
 }
 
 void bakery_lock_release(bakery_lock_t *lock)
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <lock_stats.h>
+#include <spinlock.h>
+#include <utils_def.h>
+
+IMPORT_SYM(uintptr_t, __LOCK_STATS_START__,	LOCK_STATS_START);
+IMPORT_SYM(uintptr_t, __LOCK_STATS_END__,	LOCK_STATS_END);
+
+#define LOCK_STATS_NUM							\
+	((unsigned int)((LOCK_STATS_END - LOCK_STATS_START) /		\
+			sizeof(lock_stats_t)))
+
+static lock_stats_t *lock_stats_find(uintptr_t lock)
+{
+	lock_stats_t *stats = (lock_stats_t *)LOCK_STATS_START;
+	unsigned int i;
+
+	for (i = 0U; i < LOCK_STATS_NUM; i++) {
+		if ((lock >= stats[i].base) &&
+		    (lock < (stats[i].base + stats[i].size)))
+			return &stats[i];
+	}
+
+	return NULL;
+}
+
+/*
+ * Account one acquisition of a lock. It must be called with the lock held, so
+ * that a registered object is only updated by one CPU at a time.
+ */
+void lock_stats_record(const void *lock, bool contended, uint64_t ticks)
+{
+	lock_stats_t *stats = lock_stats_find((uintptr_t)lock);
+
+	if (stats == NULL)
+		return;
+
+	stats->acquisitions++;
+	if (contended) {
+		stats->contended++;
+		stats->wait_ticks += ticks;
+	}
+}
+
+void spin_lock_stats(spinlock_t *lock)
+{
+	uint64_t start;
+
+	if (spin_trylock(lock) != 0) {
+		lock_stats_record(lock, false, 0U);
+		return;
+	}
+
+	start = read_cntpct_el0();
+	(spin_lock)(lock);
+	lock_stats_record(lock, true, read_cntpct_el0() - start);
+}
+
+/*
+ * Return the statistics of the registered object at the given index, and the
+ * number of registered objects. The counters are read without holding the
+ * locks, so they may be slightly out of step with each other.
+ */
+int lock_stats_get(unsigned int index, lock_stats_t *stats,
+		   unsigned int *num_locks)
+{
+	const lock_stats_t *s = (const lock_stats_t *)LOCK_STATS_START;
+
+	*num_locks = LOCK_STATS_NUM;
+	if (index >= LOCK_STATS_NUM)
+		return LOCK_STATS_E_PARAM;
+
+	*stats = s[index];
+
+	return 0;
+}
@@ -0,0 +1,14 @@
+#
+# Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+ifneq (${LZ4_MK},1)
+LZ4_MK		:=	1
+
+LZ4_SOURCES	:=	lib/lz4/tf_lz4.c
+
+INCLUDES	+=	-Iinclude/lib/lz4
+
+endif
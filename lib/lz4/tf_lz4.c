@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <debug.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <tf_lz4.h>
+
+/* Skippable frames have a magic number in the 0x184D2A50-0x184D2A5F range */
+#define LZ4_SKIPPABLE_MAGIC		0x184D2A50U
+#define LZ4_SKIPPABLE_MAGIC_MASK	0xFFFFFFF0U
+
+/* Frame descriptor FLG byte */
+#define LZ4_FLG_VERSION_SHIFT		6
+#define LZ4_FLG_VERSION_MASK		0x3U
+#define LZ4_FLG_VERSION			0x1U
+#define LZ4_FLG_BLOCK_CHECKSUM		(1U << 4)
+#define LZ4_FLG_CONTENT_SIZE		(1U << 3)
+#define LZ4_FLG_CONTENT_CHECKSUM	(1U << 2)
+#define LZ4_FLG_DICT_ID			(1U << 0)
+
+/* Block size field: the top bit flags blocks stored uncompressed */
+#define LZ4_BLOCK_UNCOMPRESSED		(1U << 31)
+
+/* Sequences */
+#define LZ4_MIN_MATCH			4U
+#define LZ4_RUN_MASK			0xFU
+
+/* Matches shorter than this are copied byte per byte */
+#define LZ4_COPY_CHUNK_MIN		16U
+
+static uint32_t read_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Read the extra length bytes that follow a field of LZ4_RUN_MASK. Return 0
+ * on success or -EIO if the input ends first.
+ */
+static int read_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= iend)
+			return -EIO;
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255U);
+
+	return 0;
+}
+
+/*
+ * Copy len bytes from offset bytes back in the output. The source and the
+ * destination overlap when offset < len, in which case the bytes between the
+ * source and the destination are copied repeatedly, doubling each time.
+ */
+static uint8_t *copy_match(uint8_t *op, size_t offset, size_t len)
+{
+	const uint8_t *match = op - offset;
+	size_t n;
+
+	if (len < LZ4_COPY_CHUNK_MIN) {
+		while (len-- != 0U)
+			*op++ = *match++;
+		return op;
+	}
+
+	if (offset == 1U) {
+		memset(op, *match, len);
+		return op + len;
+	}
+
+	while (len != 0U) {
+		n = (size_t)(op - match);
+		if (n > len)
+			n = len;
+		memcpy(op, match, n);
+		op += n;
+		len -= n;
+	}
+
+	return op;
+}
+
+/*
+ * Decompress one LZ4 block from [ip, iend) to op. Matches may reach back to
+ * ostart, the start of the frame output. Return the end of the output or NULL
+ * if the block is corrupted or does not fit before oend.
+ */
+static uint8_t *decompress_block(const uint8_t *ip, const uint8_t *iend,
+				 uint8_t *ostart, uint8_t *op, uint8_t *oend)
+{
+	size_t len, offset;
+	unsigned int token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Literals */
+		len = token >> 4;
+		if ((len == LZ4_RUN_MASK) && (read_length(&ip, iend, &len) != 0))
+			return NULL;
+		if ((len > (size_t)(iend - ip)) || (len > (size_t)(oend - op)))
+			return NULL;
+		memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		/* The last sequence of a block only has literals */
+		if (ip == iend)
+			break;
+
+		/* Match */
+		if ((iend - ip) < 2)
+			return NULL;
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if ((offset == 0U) || (offset > (size_t)(op - ostart)))
+			return NULL;
+
+		len = token & LZ4_RUN_MASK;
+		if ((len == LZ4_RUN_MASK) && (read_length(&ip, iend, &len) != 0))
+			return NULL;
+		len += LZ4_MIN_MATCH;
+		if (len > (size_t)(oend - op))
+			return NULL;
+
+		op = copy_match(op, offset, len);
+	}
+
+	return op;
+}
+
+/*
+ * Decompress one LZ4 frame starting after its magic number. Return 0 on
+ * success with *ipp and *opp moved past the frame, or -EIO.
+ *
+ * The header checksum, block checksums and content checksum are skipped but
+ * not verified: the images are expected to be authenticated separately.
+ */
+static int decompress_frame(const uint8_t **ipp, const uint8_t *iend,
+			    uint8_t **opp, uint8_t *oend)
+{
+	const uint8_t *ip = *ipp;
+	uint8_t *ostart = *opp;
+	uint8_t *op = *opp;
+	size_t header_len = 3U;
+	uint32_t block_size;
+	unsigned int flg;
+
+	/* FLG, BD and header checksum bytes */
+	if ((iend - ip) < 3)
+		return -EIO;
+
+	flg = ip[0];
+	if (((flg >> LZ4_FLG_VERSION_SHIFT) & LZ4_FLG_VERSION_MASK) !=
+	    LZ4_FLG_VERSION) {
+		ERROR("lz4: unsupported frame version\n");
+		return -EIO;
+	}
+
+	if ((flg & LZ4_FLG_DICT_ID) != 0U) {
+		ERROR("lz4: dictionaries are not supported\n");
+		return -EIO;
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U)
+		header_len += 8U;
+
+	if ((size_t)(iend - ip) < header_len)
+		return -EIO;
+	ip += header_len;
+
+	for (;;) {
+		if ((iend - ip) < 4)
+			return -EIO;
+		block_size = read_le32(ip);
+		ip += 4;
+
+		/* End mark */
+		if (block_size == 0U)
+			break;
+
+		if ((block_size & ~LZ4_BLOCK_UNCOMPRESSED) >
+		    (size_t)(iend - ip))
+			return -EIO;
+
+		if ((block_size & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			block_size &= ~LZ4_BLOCK_UNCOMPRESSED;
+			if (block_size > (size_t)(oend - op))
+				return -EIO;
+			memcpy(op, ip, block_size);
+			op += block_size;
+		} else {
+			op = decompress_block(ip, ip + block_size, ostart, op,
+					      oend);
+			if (op == NULL) {
+				ERROR("lz4: corrupted block\n");
+				return -EIO;
+			}
+		}
+		ip += block_size;
+
+		if ((flg & LZ4_FLG_BLOCK_CHECKSUM) != 0U) {
+			if ((iend - ip) < 4)
+				return -EIO;
+			ip += 4;
+		}
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_CHECKSUM) != 0U) {
+		if ((iend - ip) < 4)
+			return -EIO;
+		ip += 4;
+	}
+
+	*ipp = ip;
+	*opp = op;
+
+	return 0;
+}
+
+/*
+ * unlz4 - decompress LZ4 frame data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused, LZ4 decompresses in place in the output)
+ * @work_len: length of workspace
+ *
+ * Concatenated frames are decompressed one after the other, and skippable
+ * frames are ignored.
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *iend = ip + in_len;
+	uint8_t *op = (uint8_t *)*out_buf;
+	uint8_t *oend = op + out_len;
+	uint32_t magic, skip;
+	int ret = 0;
+
+	while ((iend - ip) >= 4) {
+		magic = read_le32(ip);
+		ip += 4;
+
+		if ((magic & LZ4_SKIPPABLE_MAGIC_MASK) == LZ4_SKIPPABLE_MAGIC) {
+			if ((iend - ip) < 4) {
+				ret = -EIO;
+				break;
+			}
+			skip = read_le32(ip);
+			ip += 4;
+			if (skip > (size_t)(iend - ip)) {
+				ret = -EIO;
+				break;
+			}
+			ip += skip;
+			continue;
+		}
+
+		if (magic != LZ4_FRAME_MAGIC) {
+			ERROR("lz4: bad frame magic 0x%x\n", magic);
+			ret = -EIO;
+			break;
+		}
+
+		ret = decompress_frame(&ip, iend, &op, oend);
+		if (ret != 0)
+			break;
+	}
+
+	if ((ret == 0) && (ip != iend)) {
+		ERROR("lz4: trailing garbage\n");
+		ret = -EIO;
+	}
+
+	VERBOSE("lz4: %lu byte input\n",
+		(unsigned long)((uintptr_t)ip - *in_buf));
+	VERBOSE("lz4: %lu byte output\n",
+		(unsigned long)((uintptr_t)op - *out_buf));
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return ret;
+}
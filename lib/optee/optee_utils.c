@@ -10,6 +10,10 @@
 #include <desc_image_load.h>
 #include <errno.h>
 #include <optee_utils.h>
+#include <stdbool.h>
+#include <string.h>
+#include <utils.h>
+#include <utils_def.h>
 
 /*
  * load_addr_hi and load_addr_lo: image load address.
@@ -47,6 +51,23 @@ typedef struct optee_header {
 	optee_image_t optee_image_list[];
 } optee_header_t;
 
+#define OPTEE_HEADER_MAX_SIZE						\
+	(sizeof(optee_header_t) + (OPTEE_MAX_NUM_IMAGES * sizeof(optee_image_t)))
+
+/*
+ * State of the loading of a paged OP-TEE image from a single image file by
+ * optee_get_image_split().
+ */
+static struct optee_split_ctx {
+	entry_point_info_t *header_ep;
+	image_info_t *pager_image_info;
+	image_info_t *paged_image_info;
+	/* Whether the header was parsed and the parts loaded with it */
+	bool parts_loaded;
+} optee_split_ctx;
+
+static image_split_t optee_image_split;
+
 /*******************************************************************************
  * Check if it is a valid tee header
  * Return 1 if valid
@@ -75,7 +96,7 @@ static inline int tee_validate_header(optee_header_t *header)
  * Return 0 on success or a negative error code otherwise.
  ******************************************************************************/
 static int parse_optee_image(image_info_t *image_info,
-		optee_image_t *image)
+		optee_image_t *image, bool load_image)
 {
 	uintptr_t init_load_addr, free_end, requested_end;
 	size_t init_size;
@@ -121,8 +142,10 @@ static int parse_optee_image(image_info_t *image_info,
 	 * The default attr in image_info is "IMAGE_ATTRIB_SKIP_LOADING", which
 	 * mean the image will not be loaded. Here, we parse the header image to
 	 * know that the extra image need to be loaded, so remove the skip attr.
+	 * The skip attr is kept when the image is loaded with the header.
 	 */
-	image_info->h.attr &= ~IMAGE_ATTRIB_SKIP_LOADING;
+	if (load_image)
+		image_info->h.attr &= ~IMAGE_ATTRIB_SKIP_LOADING;
 
 	/* Update image base and size of image_info */
 	image_info->image_base = init_load_addr;
@@ -132,19 +155,18 @@ static int parse_optee_image(image_info_t *image_info,
 }
 
 /*******************************************************************************
- * Parse the OPTEE header
+ * Parse the OPTEE header at `header`. The pager and paged images are set to be
+ * loaded separately if `load_images` is set.
  * Return 0 on success or a negative error code otherwise.
  ******************************************************************************/
-int parse_optee_header(entry_point_info_t *header_ep,
+static int optee_parse_header(entry_point_info_t *header_ep,
+		optee_header_t *header,
 		image_info_t *pager_image_info,
-		image_info_t *paged_image_info)
-
+		image_info_t *paged_image_info,
+		bool load_images)
 {
-	optee_header_t *header;
 	int num, ret;
 
-	assert(header_ep);
-	header = (optee_header_t *)header_ep->pc;
 	assert(header);
 
 	/* Print the OPTEE header information */
@@ -188,11 +210,11 @@ int parse_optee_header(entry_point_info_t *header_ep,
 		if (header->optee_image_list[num].image_id ==
 				OPTEE_PAGER_IMAGE_ID) {
 			ret = parse_optee_image(pager_image_info,
-				&header->optee_image_list[num]);
+				&header->optee_image_list[num], load_images);
 		} else if (header->optee_image_list[num].image_id ==
 				OPTEE_PAGED_IMAGE_ID) {
 			ret = parse_optee_image(paged_image_info,
-				&header->optee_image_list[num]);
+				&header->optee_image_list[num], load_images);
 		} else {
 			ERROR("Parse optee image failed.\n");
 			return -1;
@@ -231,3 +253,133 @@ int parse_optee_header(entry_point_info_t *header_ep,
 
 	return 0;
 }
+
+/*******************************************************************************
+ * Parse the OPTEE header
+ * Return 0 on success or a negative error code otherwise.
+ ******************************************************************************/
+int parse_optee_header(entry_point_info_t *header_ep,
+		image_info_t *pager_image_info,
+		image_info_t *paged_image_info)
+
+{
+	assert(header_ep);
+
+	/*
+	 * The header of an image loaded by optee_get_image_split() has already
+	 * been parsed, and may since have been overwritten by the pager.
+	 */
+	if (optee_split_ctx.parts_loaded &&
+	    (optee_split_ctx.header_ep == header_ep))
+		return 0;
+
+	return optee_parse_header(header_ep, (optee_header_t *)header_ep->pc,
+			pager_image_info, paged_image_info, true);
+}
+
+/*******************************************************************************
+ * Split callback of optee_get_image_split(), called once the first
+ * OPTEE_HEADER_MAX_SIZE bytes of the image file are loaded at the image base.
+ * Return 0 on success or a negative error code otherwise.
+ ******************************************************************************/
+static int optee_split_image(image_split_t *split, image_info_t *image_data,
+		size_t image_size)
+{
+	struct optee_split_ctx *ctx = split->cookie;
+	uint32_t buf[OPTEE_HEADER_MAX_SIZE / sizeof(uint32_t)];
+	optee_header_t *header = (optee_header_t *)buf;
+	size_t head_size = image_data->image_size;
+	size_t header_size, offset, n;
+	image_info_t *image_info;
+	uintptr_t base;
+	unsigned int i;
+	int ret;
+
+	ctx->parts_loaded = false;
+
+	/* The header is copied as the pager may be loaded over it */
+	zeromem(buf, sizeof(buf));
+	memcpy(buf, (void *)image_data->image_base, head_size);
+
+	if ((head_size < sizeof(optee_header_t)) ||
+	    !tee_validate_header(header)) {
+		/* Plain OPTEE bin without header, loaded whole */
+		if (image_size > image_data->image_max_size)
+			return -EFBIG;
+
+		split->parts[0].base = image_data->image_base + head_size;
+		split->parts[0].size = image_size - head_size;
+		split->num_parts = 1U;
+		image_data->image_size = (uint32_t)image_size;
+		return 0;
+	}
+
+	/* A header image alone is followed by separate pager and paged images */
+	header_size = sizeof(optee_header_t) +
+		(header->nb_images * sizeof(optee_image_t));
+	if (image_size == header_size)
+		return 0;
+
+	ret = optee_parse_header(ctx->header_ep, header, ctx->pager_image_info,
+			ctx->paged_image_info, false);
+	if (ret != 0)
+		return -EINVAL;
+
+	/*
+	 * The images follow the header in the order of the image list. The
+	 * first bytes of the first image may have been loaded with the head.
+	 */
+	offset = header_size;
+	for (i = 0U; i < header->nb_images; i++) {
+		image_info = (header->optee_image_list[i].image_id ==
+			      OPTEE_PAGER_IMAGE_ID) ? ctx->pager_image_info :
+						      ctx->paged_image_info;
+		base = image_info->image_base;
+		n = 0U;
+
+		if (offset < head_size) {
+			n = MIN(head_size - offset,
+				(size_t)image_info->image_size);
+			memmove((void *)base,
+				(void *)(image_data->image_base + offset), n);
+			offset += n;
+		}
+
+		split->parts[i].base = base + n;
+		split->parts[i].size = image_info->image_size - n;
+		offset += split->parts[i].size;
+	}
+	split->num_parts = header->nb_images;
+
+	ctx->parts_loaded = true;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Describe how to load, with load_auth_split_image(), an OPTEE image file made
+ * of the header followed by the pager and paged images. The images are read
+ * straight to the load addresses given by the header, and the entry point and
+ * image information are updated as by parse_optee_header(), which then doesn't
+ * parse the header again. A header image alone, or a plain OPTEE bin without
+ * header, is loaded as with load_auth_image().
+ ******************************************************************************/
+image_split_t *optee_get_image_split(entry_point_info_t *header_ep,
+		image_info_t *pager_image_info,
+		image_info_t *paged_image_info)
+{
+	assert(header_ep);
+	assert(pager_image_info);
+	assert(paged_image_info);
+
+	optee_split_ctx.header_ep = header_ep;
+	optee_split_ctx.pager_image_info = pager_image_info;
+	optee_split_ctx.paged_image_info = paged_image_info;
+	optee_split_ctx.parts_loaded = false;
+
+	optee_image_split.head_size = OPTEE_HEADER_MAX_SIZE;
+	optee_image_split.split = optee_split_image;
+	optee_image_split.cookie = &optee_split_ctx;
+
+	return &optee_image_split;
+}
@@ -13,6 +13,15 @@
 #include <string.h>
 #include <utils_def.h>
 
+#if ENABLE_PMF_BULK_TIMESTAMPS
+#include <platform_def.h>
+#include <xlat_tables_v2.h>
+
+#if !PLAT_XLAT_TABLES_DYNAMIC
+#error "ENABLE_PMF_BULK_TIMESTAMPS requires PLAT_XLAT_TABLES_DYNAMIC in BL31"
+#endif
+#endif
+
 /*******************************************************************************
  * The 'pmf_svc_descs' array holds the PMF service descriptors exported by
  * services by placing them in the 'pmf_svc_descs' linker section.
@@ -173,6 +182,79 @@ int pmf_get_timestamp_smc(unsigned int tid,
 	}
 }
 
+#if ENABLE_PMF_BULK_TIMESTAMPS
+/*
+ * This function copies the time-stamps of all the CPUs for the PMF service
+ * and id given by `tid` to a Non-secure buffer, in a single call. With the
+ * PMF_ALL_TIMESTAMP_IDS flag, all the ids of the service are copied instead.
+ * The time-stamps are stored by CPU index, then by id. The buffer is mapped as
+ * Non-secure memory while the time-stamps are copied, so it can't be used to
+ * write to Secure memory.
+ *
+ * `count` is set to the number of time-stamps to copy, even when the buffer is
+ * too small, in which case nothing is copied and -ENOMEM is returned.
+ */
+int pmf_get_timestamps_smc(unsigned int tid,
+		uintptr_t buf,
+		size_t size,
+		unsigned int flags,
+		unsigned int *count)
+{
+	unsigned long long *dst = (unsigned long long *)buf;
+	pmf_svc_desc_t *svc_desc;
+	unsigned int first_id, num_ids, cpuid, ii;
+	uintptr_t map_base;
+	size_t map_size;
+	int rc;
+
+	assert(count != NULL);
+	*count = 0U;
+
+	svc_desc = get_service(tid);
+	if ((svc_desc == NULL) || (svc_desc->get_ts_by_index == NULL))
+		return -EINVAL;
+
+	if ((flags & PMF_ALL_TIMESTAMP_IDS) != 0U) {
+		first_id = 0U;
+		num_ids = svc_desc->svc_config & PMF_TID_MASK;
+	} else {
+		first_id = tid & PMF_TID_MASK;
+		num_ids = 1U;
+	}
+	tid &= ~PMF_TID_MASK;
+
+	*count = PLATFORM_CORE_COUNT * num_ids;
+
+	if (((buf % sizeof(unsigned long long)) != 0U) || ((buf + size) < buf))
+		return -EINVAL;
+	if (size < (*count * sizeof(unsigned long long)))
+		return -ENOMEM;
+
+	map_base = round_down(buf, PAGE_SIZE);
+	map_size = round_up(buf + size, PAGE_SIZE) - map_base;
+
+	rc = mmap_add_dynamic_region(map_base, map_base, map_size,
+				     MT_MEMORY | MT_RW | MT_NS);
+	if (rc != 0)
+		return rc;
+
+	for (cpuid = 0U; cpuid < PLATFORM_CORE_COUNT; cpuid++) {
+		for (ii = 0U; ii < num_ids; ii++) {
+			*dst++ = svc_desc->get_ts_by_index(tid | (first_id + ii),
+					cpuid, flags & PMF_CACHE_MAINT);
+		}
+	}
+
+	rc = mmap_remove_dynamic_region(map_base, map_size);
+	if (rc != 0) {
+		ERROR("Unable to unmap the PMF time-stamp buffer: %d\n", rc);
+		panic();
+	}
+
+	return 0;
+}
+#endif /* ENABLE_PMF_BULK_TIMESTAMPS */
+
 /*
  * This function can be used to dump `ts` value for given `tid`.
  * Assumption is that the console is already initialized.
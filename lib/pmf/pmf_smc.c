@@ -7,6 +7,8 @@
 #include <debug.h>
 #include <platform.h>
 #include <pmf.h>
+#include <runtime_instr.h>
+#include <sdei.h>
 #include <smccc_helpers.h>
 
 /*
@@ -23,6 +25,15 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 {
 	int rc;
 	unsigned long long ts_value;
+#if ENABLE_PSCI_SUSPEND_TRACE || ENABLE_PMF_BULK_TIMESTAMPS
+	unsigned int count = 0U;
+#endif
+#if ENABLE_PSCI_SUSPEND_TRACE
+	unsigned int lost = 0U;
+#endif
+#if SDEI_EVENT_STATS
+	uint64_t values[SDEI_STATS_VALUES] = { 0U };
+#endif
 
 	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
 
@@ -54,6 +65,50 @@ uintptr_t pmf_smc_handler(unsigned int smc_fid,
 					(unsigned int)x3, &ts_value);
 			SMC_RET2(handle, rc, ts_value);
 		}
+
+#if ENABLE_PMF_BULK_TIMESTAMPS
+		if (smc_fid == PMF_SMC_GET_TIMESTAMPS) {
+			/*
+			 * Copy the time-stamps of all the CPUs for the id x1,
+			 * or all the ids of its service, to the buffer at x2 of
+			 * x3 bytes. x4 holds the flags.
+			 * x0 --> error code.
+			 * x1 --> number of time-stamps.
+			 */
+			rc = pmf_get_timestamps_smc((unsigned int)x1, x2, x3,
+					(unsigned int)x4, &count);
+			SMC_RET2(handle, rc, count);
+		}
+#endif
+
+#if ENABLE_PSCI_SUSPEND_TRACE
+		if (smc_fid == PMF_SMC_GET_SUSPEND_TRACE) {
+			/*
+			 * Copy the suspend trace of the CPU given by x1 to the
+			 * buffer at x2 of x3 bytes.
+			 * x0 --> error code.
+			 * x1 --> number of records copied.
+			 * x2 --> number of records lost.
+			 */
+			rc = rt_instr_suspend_trace_export(x1, x2, x3,
+					&count, &lost);
+			SMC_RET3(handle, rc, count, lost);
+		}
+#endif
+
+#if SDEI_EVENT_STATS
+		if (smc_fid == PMF_SMC_GET_SDEI_STATS) {
+			/*
+			 * Return the statistics x3 of the SDEI event x1, for
+			 * the CPU given by x2 if the event is private.
+			 * x0 --> error code.
+			 * x1 - x3 --> statistics values.
+			 */
+			rc = sdei_event_get_stats((int)x1, x2, (unsigned int)x3,
+					values);
+			SMC_RET4(handle, rc, values[0], values[1], values[2]);
+		}
+#endif
 	}
 
 	WARN("Unimplemented PMF Call: 0x%x \n", smc_fid);
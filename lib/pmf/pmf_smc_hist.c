@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cpu_data.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <runtime_instr.h>
+#include <smccc.h>
+#include <stdint.h>
+#include <utils_def.h>
+
+/*
+ * Per-cpu SMC latency histograms. Each row is only written by its CPU and is
+ * aligned to a cache line so that CPUs do not share lines.
+ */
+typedef struct smc_hist {
+	uint32_t count[RT_INSTR_SMC_HIST_TOTAL_IDS];
+} __aligned(CACHE_WRITEBACK_GRANULE) smc_hist_t;
+
+static smc_hist_t smc_hist[PLATFORM_CORE_COUNT];
+
+/* Return the histogram bucket of an SMC function id */
+static unsigned int smc_hist_bucket(uint32_t smc_fid)
+{
+	unsigned int oen = GET_SMC_OEN(smc_fid);
+
+#if SMCCC_MAJOR_VERSION == 1
+	if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_YIELD)
+		return RT_INSTR_SMC_BKT_YIELD;
+
+	if ((oen >= OEN_TAP_START) && (oen <= OEN_TAP_END))
+		return RT_INSTR_SMC_BKT_TAP;
+
+	if ((oen >= OEN_TOS_START) && (oen <= OEN_TOS_END))
+		return RT_INSTR_SMC_BKT_TOS;
+#endif
+
+	if (oen <= OEN_VEN_HYP_END)
+		return RT_INSTR_SMC_BKT_ARM_ARCH + oen;
+
+	return RT_INSTR_SMC_BKT_OTHER;
+}
+
+/* Return the histogram bin of a latency in system counter ticks */
+static unsigned int smc_hist_bin(unsigned long long ticks)
+{
+	unsigned int bin = 0U;
+
+	while (((ticks >> 1) != 0ULL) && (bin < (RT_INSTR_SMC_HIST_BINS - 1U))) {
+		ticks >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+/*
+ * Count a completed SMC in the histogram of the current CPU. This is called by
+ * the SMC handler once the runtime service has returned. The time-stamp taken
+ * on entry to EL3 is in the per-cpu data.
+ */
+void rt_instr_smc_hist_record(uint32_t smc_fid)
+{
+	unsigned long long ticks;
+	unsigned int tid;
+
+	ticks = read_cntpct_el0() -
+		get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]);
+
+	tid = (smc_hist_bucket(smc_fid) * RT_INSTR_SMC_HIST_BINS) +
+		smc_hist_bin(ticks);
+
+	smc_hist[plat_my_core_pos()].count[tid]++;
+}
+
+/*
+ * PMF handlers returning the count of a histogram bin of the given CPU. The
+ * histograms are always written with the data cache enabled, so no cache
+ * maintenance is needed whatever the flags.
+ */
+static unsigned long long smc_hist_get_count_by_index(unsigned int tid,
+		unsigned int cpuid, unsigned int flags)
+{
+	assert(cpuid < PLATFORM_CORE_COUNT);
+	assert((tid & PMF_TID_MASK) < RT_INSTR_SMC_HIST_TOTAL_IDS);
+
+	return smc_hist[cpuid].count[tid & PMF_TID_MASK];
+}
+
+static unsigned long long smc_hist_get_count(unsigned int tid,
+		u_register_t mpidr, unsigned int flags)
+{
+	int cpuid = plat_core_pos_by_mpidr(mpidr);
+
+	assert(cpuid >= 0);
+
+	return smc_hist_get_count_by_index(tid, (unsigned int)cpuid, flags);
+}
+
+PMF_REGISTER_SERVICE_SMC_OWN(smc_hist, PMF_ARM_TIF_IMPL_ID,
+	PMF_SMC_HIST_SVC_ID, RT_INSTR_SMC_HIST_TOTAL_IDS, NULL,
+	smc_hist_get_count, smc_hist_get_count_by_index)
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <pmf.h>
+#include <runtime_instr.h>
+#include <spinlock.h>
+#include <stdint.h>
+#include <string.h>
+#include <utils_def.h>
+#include <xlat_tables_v2.h>
+
+#if !PLAT_XLAT_TABLES_DYNAMIC
+#error "ENABLE_PSCI_SUSPEND_TRACE requires PLAT_XLAT_TABLES_DYNAMIC in BL31"
+#endif
+
+/*
+ * Per-cpu suspend traces. Each trace is a ring of the last
+ * RT_INSTR_SUSPEND_TRACE_DEPTH CPU_SUSPEND calls of its CPU. The records and
+ * the head count are only written by the owning CPU, the tail count is only
+ * written when the trace is exported, under suspend_trace_lock.
+ */
+typedef struct suspend_trace {
+	rt_instr_suspend_rec_t rec[RT_INSTR_SUSPEND_TRACE_DEPTH];
+	volatile unsigned int head;
+	unsigned int tail;
+} __aligned(CACHE_WRITEBACK_GRANULE) suspend_trace_t;
+
+/*
+ * CPU_SUSPEND call in progress on a CPU. This is kept apart from the trace, in
+ * its own cache line, as it is flushed before the CPU powers down.
+ */
+typedef struct suspend_trace_call {
+	unsigned int pending;
+	unsigned int power_state;
+} __aligned(CACHE_WRITEBACK_GRANULE) suspend_trace_call_t;
+
+static suspend_trace_t suspend_trace[PLATFORM_CORE_COUNT];
+static suspend_trace_call_t suspend_trace_call[PLATFORM_CORE_COUNT];
+static spinlock_t suspend_trace_lock;
+
+/*
+ * Note the start of a CPU_SUSPEND call on the current CPU, so that it is added
+ * to the trace when the call returns to the Non-secure world.
+ */
+void rt_instr_suspend_trace_start(unsigned int power_state)
+{
+	suspend_trace_call_t *call = &suspend_trace_call[plat_my_core_pos()];
+
+	call->power_state = power_state;
+	call->pending = 1U;
+
+	/* The call may complete in the warm boot path, with a cold cache */
+	flush_dcache_range((uintptr_t)call, sizeof(*call));
+}
+
+/*
+ * Add the CPU_SUSPEND call in progress on the current CPU, if any, to its
+ * trace. This is called once the exit time-stamp of the PSCI call has been
+ * taken, either by the Standard Service or at the end of the warm boot path.
+ * At both points the line of the time-stamps of the CPU is valid in its data
+ * cache, so no cache maintenance is needed to read them.
+ */
+void rt_instr_suspend_trace_record(void)
+{
+	unsigned int cpuid = plat_my_core_pos();
+	suspend_trace_call_t *call = &suspend_trace_call[cpuid];
+	suspend_trace_t *trace = &suspend_trace[cpuid];
+	rt_instr_suspend_rec_t *rec;
+
+	if (call->pending == 0U)
+		return;
+
+	call->pending = 0U;
+
+	rec = &trace->rec[trace->head % RT_INSTR_SUSPEND_TRACE_DEPTH];
+
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_ENTER_PSCI, cpuid,
+				   PMF_NO_CACHE_MAINT, rec->enter_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_ENTER_HW_LOW_PWR,
+				   cpuid, PMF_NO_CACHE_MAINT,
+				   rec->hw_low_pwr_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_EXIT_HW_LOW_PWR,
+				   cpuid, PMF_NO_CACHE_MAINT, rec->wake_ts);
+	PMF_GET_TIMESTAMP_BY_INDEX(rt_instr_svc, RT_INSTR_EXIT_PSCI, cpuid,
+				   PMF_NO_CACHE_MAINT, rec->exit_ts);
+
+	/* Time-stamps older than the call were left by a previous call */
+	if (rec->hw_low_pwr_ts < rec->enter_ts)
+		rec->hw_low_pwr_ts = 0ULL;
+	if (rec->wake_ts < rec->enter_ts)
+		rec->wake_ts = 0ULL;
+
+	rec->power_state = call->power_state;
+	rec->reserved = 0U;
+
+	/* Write the record before the count that publishes it */
+	dmbish();
+	trace->head = trace->head + 1U;
+}
+
+/*
+ * Copy the records of the trace of a CPU that have not been exported yet to a
+ * Non-secure buffer, oldest first, and remove them from the trace. The buffer
+ * is mapped as Non-secure memory while the records are copied, so it can't be
+ * used to write to Secure memory.
+ *
+ * On success, `count` is the number of records copied and `lost` the number of
+ * records that were overwritten since the previous export. The oldest record
+ * is also counted as lost if the CPU was writing over it during the copy.
+ */
+int rt_instr_suspend_trace_export(u_register_t mpidr, uintptr_t buf,
+				  size_t size, unsigned int *count,
+				  unsigned int *lost)
+{
+	rt_instr_suspend_rec_t *dst = (rt_instr_suspend_rec_t *)buf;
+	suspend_trace_t *trace;
+	uintptr_t map_base;
+	size_t map_size;
+	unsigned int head, first, drop, n, i;
+	int cpuid, rc;
+
+	cpuid = plat_core_pos_by_mpidr(mpidr);
+	if (cpuid < 0)
+		return -EINVAL;
+
+	size = MIN(size, sizeof(suspend_trace[0].rec));
+	if ((size < sizeof(rt_instr_suspend_rec_t)) ||
+	    ((buf % sizeof(uint64_t)) != 0U) || ((buf + size) < buf))
+		return -EINVAL;
+
+	map_base = round_down(buf, PAGE_SIZE);
+	map_size = round_up(buf + size, PAGE_SIZE) - map_base;
+
+	rc = mmap_add_dynamic_region(map_base, map_base, map_size,
+				     MT_MEMORY | MT_RW | MT_NS);
+	if (rc != 0)
+		return rc;
+
+	trace = &suspend_trace[cpuid];
+
+	spin_lock(&suspend_trace_lock);
+
+	head = trace->head;
+
+	/* Read the records after the count that published them */
+	dmbishld();
+
+	first = trace->tail;
+	if ((head - first) > RT_INSTR_SUSPEND_TRACE_DEPTH)
+		first = head - RT_INSTR_SUSPEND_TRACE_DEPTH;
+
+	n = MIN(head - first,
+		(unsigned int)(size / sizeof(rt_instr_suspend_rec_t)));
+	for (i = 0U; i < n; i++)
+		dst[i] = trace->rec[(first + i) % RT_INSTR_SUSPEND_TRACE_DEPTH];
+
+	/*
+	 * Drop the records that the CPU has overwritten during the copy. The
+	 * record after the last published one may be being written.
+	 */
+	dmbishld();
+	head = trace->head + 1U;
+
+	drop = 0U;
+	if ((head - first) > RT_INSTR_SUSPEND_TRACE_DEPTH)
+		drop = MIN(head - first - RT_INSTR_SUSPEND_TRACE_DEPTH, n);
+
+	if (drop != 0U) {
+		(void)memmove(dst, &dst[drop],
+			      (n - drop) * sizeof(rt_instr_suspend_rec_t));
+	}
+
+	*count = n - drop;
+	*lost = (first - trace->tail) + drop;
+	trace->tail = first + n;
+
+	spin_unlock(&suspend_trace_lock);
+
+	rc = mmap_remove_dynamic_region(map_base, map_size);
+	if (rc != 0) {
+		ERROR("Unable to unmap the suspend trace buffer: %d\n", rc);
+		panic();
+	}
+
+	return 0;
+}
@@ -4,13 +4,17 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_PSCI
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
 #include <context.h>
 #include <context_mgmt.h>
+#include <dcache_batch.h>
 #include <debug.h>
+#include <lock_stats.h>
 #include <platform.h>
 #include <string.h>
 #include <utils.h>
@@ -33,14 +37,28 @@ const spd_pm_ops_t *psci_spd_pm;
  * local states requested for a particular non cpu power domain by each cpu
  * within the domain.
  *
- * TODO: Dense packing of the requested states will cause cache thrashing
- * when multiple power domains write to it. If we allocate the requested
- * states at each power level in a cache-line aligned per-domain memory,
- * the cache thrashing can be avoided.
+ * Dense packing of the requested states will cause cache thrashing when
+ * multiple CPUs write to it. With PSCI_PD_CACHE_ALIGN, the requested states of
+ * each CPU are kept in their own cache line instead, so that a CPU only ever
+ * writes to its own line, and they are gathered for state coordination.
  */
+#if PSCI_PD_CACHE_ALIGN
+typedef struct psci_req_pwr_states {
+	plat_local_state_t state[PLAT_MAX_PWR_LVL];
+} __aligned(CACHE_WRITEBACK_GRANULE) psci_req_pwr_states_t;
+
+static psci_req_pwr_states_t psci_req_local_pwr_states[PLATFORM_CORE_COUNT];
+
+#define psci_req_local_pwr_state(lvl_idx, cpu_idx)	\
+	(psci_req_local_pwr_states[(cpu_idx)].state[(lvl_idx)])
+#else
 static plat_local_state_t
 	psci_req_local_pwr_states[PLAT_MAX_PWR_LVL][PLATFORM_CORE_COUNT];
 
+#define psci_req_local_pwr_state(lvl_idx, cpu_idx)	\
+	(psci_req_local_pwr_states[(lvl_idx)][(cpu_idx)])
+#endif
+
 
 /*******************************************************************************
  * Arrays that hold the platform's power domain tree information for state
@@ -57,6 +75,7 @@ __section("tzfw_coherent_mem")
 
 /* Lock for PSCI state coordination */
 DEFINE_PSCI_LOCK(psci_locks[PSCI_NUM_NON_CPU_PWR_DOMAINS]);
+REGISTER_LOCK_STATS(psci, psci_locks);
 
 cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 
@@ -65,6 +84,13 @@ cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
  ******************************************************************************/
 const plat_psci_ops_t *psci_plat_pm_ops;
 
+#if PSCI_OS_INIT_MODE
+/*******************************************************************************
+ * The suspend mode selected by the OS with PSCI_SET_SUSPEND_MODE
+ ******************************************************************************/
+suspend_mode_t psci_suspend_mode = PLAT_COORD;
+#endif
+
 /******************************************************************************
  * Check that the maximum power level supported by the platform makes sense
  *****************************************************************************/
@@ -72,6 +98,15 @@ CASSERT((PLAT_MAX_PWR_LVL <= PSCI_MAX_PWR_LVL) &&
 	(PLAT_MAX_PWR_LVL >= PSCI_CPU_PWR_LVL),
 	assert_platform_max_pwrlvl_check);
 
+#ifdef PLAT_HW_FLUSH_PWR_LVL
+/******************************************************************************
+ * Check that the power level cleaned by the hardware is above the CPU level
+ *****************************************************************************/
+CASSERT((PLAT_HW_FLUSH_PWR_LVL > PSCI_CPU_PWR_LVL) &&
+	(PLAT_HW_FLUSH_PWR_LVL <= PLAT_MAX_PWR_LVL),
+	assert_platform_hw_flush_pwrlvl_check);
+#endif
+
 /*
  * The plat_local_state used by the platform is one of these types: RUN,
  * RETENTION and OFF. The platform can define further sub-states for each type
@@ -209,7 +244,7 @@ static void psci_set_req_local_pwr_state(unsigned int pwrlvl,
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Warray-bounds"
-	psci_req_local_pwr_states[pwrlvl - 1U][cpu_idx] = req_pwr_state;
+	psci_req_local_pwr_state(pwrlvl - 1U, cpu_idx) = req_pwr_state;
 #pragma GCC diagnostic pop
 }
 
@@ -224,7 +259,7 @@ void __init psci_init_req_local_pwr_states(void)
 
 	for (pwrlvl = 0U; pwrlvl < PLAT_MAX_PWR_LVL; pwrlvl++) {
 		for (core = 0; core < PLATFORM_CORE_COUNT; core++) {
-			psci_req_local_pwr_states[pwrlvl][core] =
+			psci_req_local_pwr_state(pwrlvl, core) =
 				PLAT_MAX_OFF_STATE;
 		}
 	}
@@ -237,13 +272,29 @@ void __init psci_init_req_local_pwr_states(void)
  * an ancestor. These requested states will be used to determine a suitable
  * target state for this power domain during psci state coordination. An
  * assertion is added to prevent us from accessing the CPU power level.
+ *
+ * With PSCI_PD_CACHE_ALIGN, the states are gathered into the 'states' array
+ * of size 'ncpus'. Otherwise the array is not used.
  *****************************************************************************/
-static plat_local_state_t *psci_get_req_local_pwr_states(unsigned int pwrlvl,
-							 int cpu_idx)
+static const plat_local_state_t *psci_get_req_local_pwr_states(
+		unsigned int pwrlvl, int cpu_idx, unsigned int ncpus,
+		plat_local_state_t *states)
 {
 	assert(pwrlvl > PSCI_CPU_PWR_LVL);
 
+#if PSCI_PD_CACHE_ALIGN
+	unsigned int i;
+
+	assert(ncpus <= (unsigned int)PLATFORM_CORE_COUNT);
+
+	for (i = 0U; i < ncpus; i++)
+		states[i] = psci_req_local_pwr_state(pwrlvl - 1U,
+						     (unsigned int)cpu_idx + i);
+
+	return states;
+#else
 	return &psci_req_local_pwr_states[pwrlvl - 1U][cpu_idx];
+#endif
 }
 
 /*
@@ -276,15 +327,16 @@ static plat_local_state_t get_non_cpu_pd_node_local_state(
 }
 
 /*
- * Update local state of non-CPU power domain node from a cached CPU; perform
- * any required cache maintenance operation afterwards.
+ * Update local state of non-CPU power domain node from a cached CPU; add any
+ * required cache maintenance operation to `batch`, which the caller finishes
+ * once the nodes of all the levels have been updated.
  */
 static void set_non_cpu_pd_node_local_state(unsigned int parent_idx,
-		plat_local_state_t state)
+		plat_local_state_t state, dcache_batch_t __unused *batch)
 {
 	psci_non_cpu_pd_nodes[parent_idx].local_state = state;
 #if !(USE_COHERENT_MEM || HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-	flush_dcache_range(
+	dcache_batch_add(batch,
 			(uintptr_t) &psci_non_cpu_pd_nodes[parent_idx],
 			sizeof(psci_non_cpu_pd_nodes[parent_idx]));
 #endif
@@ -327,6 +379,7 @@ static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 {
 	unsigned int parent_idx, lvl;
 	const plat_local_state_t *pd_state = target_state->pwr_domain_state;
+	dcache_batch_t batch;
 
 	psci_set_cpu_local_state(pd_state[PSCI_CPU_PWR_LVL]);
 
@@ -339,10 +392,13 @@ static void psci_set_target_local_pwr_states(unsigned int end_pwrlvl,
 	parent_idx = psci_cpu_pd_nodes[plat_my_core_pos()].parent_node;
 
 	/* Copy the local_state from state_info */
+	dcache_batch_init(&batch, DCACHE_BATCH_FLUSH);
 	for (lvl = 1U; lvl <= end_pwrlvl; lvl++) {
-		set_non_cpu_pd_node_local_state(parent_idx, pd_state[lvl]);
+		set_non_cpu_pd_node_local_state(parent_idx, pd_state[lvl],
+						&batch);
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
+	dcache_batch_finish(&batch);
 }
 
 
@@ -372,17 +428,20 @@ void psci_get_parent_pwr_domain_nodes(int cpu_idx,
 void psci_set_pwr_domains_to_run(unsigned int end_pwrlvl)
 {
 	unsigned int parent_idx, cpu_idx = plat_my_core_pos(), lvl;
+	dcache_batch_t batch;
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
 
 	/* Reset the local_state to RUN for the non cpu power domains. */
+	dcache_batch_init(&batch, DCACHE_BATCH_FLUSH);
 	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
 		set_non_cpu_pd_node_local_state(parent_idx,
-				PSCI_LOCAL_STATE_RUN);
+				PSCI_LOCAL_STATE_RUN, &batch);
 		psci_set_req_local_pwr_state(lvl,
 					     cpu_idx,
 					     PSCI_LOCAL_STATE_RUN);
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
+	dcache_batch_finish(&batch);
 
 	/* Set the affinity info state to ON */
 	psci_set_aff_info_state(AFF_STATE_ON);
@@ -417,7 +476,13 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
 	int start_idx;
 	unsigned int ncpus;
-	plat_local_state_t target_state, *req_states;
+	plat_local_state_t target_state;
+	const plat_local_state_t *req_states;
+#if PSCI_PD_CACHE_ALIGN
+	plat_local_state_t req_states_buf[PLATFORM_CORE_COUNT];
+#else
+	plat_local_state_t *req_states_buf = NULL;
+#endif
 
 	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
 	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
@@ -430,15 +495,27 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 		psci_set_req_local_pwr_state(lvl, cpu_idx,
 					     state_info->pwr_domain_state[lvl]);
 
+#if PSCI_LOCKLESS_SUSPEND || PSCI_LOCKLESS_RESUME
+		/*
+		 * Order the update before reading the requested states of the
+		 * other CPUs, which may be suspending or resuming without the
+		 * locks (see psci_do_state_coordination_lockless() and
+		 * psci_get_lockless_resume_pwrlvl()).
+		 */
+		dmbish();
+#endif
+
 		/* Get the requested power states for this power level */
 		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
-		req_states = psci_get_req_local_pwr_states(lvl, start_idx);
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		req_states = psci_get_req_local_pwr_states(lvl, start_idx,
+							   ncpus,
+							   req_states_buf);
 
 		/*
 		 * Let the platform coordinate amongst the requested states at
 		 * this power level and return the target local power state.
 		 */
-		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
 		target_state = plat_get_target_pwr_state(lvl,
 							 req_states,
 							 ncpus);
@@ -469,6 +546,269 @@ void psci_do_state_coordination(unsigned int end_pwrlvl,
 	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
 }
 
+#if PSCI_OS_INIT_MODE
+/******************************************************************************
+ * This function verifies that the current CPU is the last running CPU of its
+ * ancestor power domain at 'pwrlvl'. If 'pwrlvl' is the CPU power level, the
+ * CPU is trivially the last one.
+ *****************************************************************************/
+static bool psci_is_last_cpu_to_idle_at_pwrlvl(unsigned int pwrlvl)
+{
+	unsigned int lvl, parent_idx, cpu_idx, my_idx = plat_my_core_pos();
+	unsigned int start_idx, ncpus;
+
+	if (pwrlvl == PSCI_CPU_PWR_LVL)
+		return true;
+
+	parent_idx = psci_cpu_pd_nodes[my_idx].parent_node;
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl < pwrlvl; lvl++)
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+
+	start_idx = (unsigned int)psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+
+	for (cpu_idx = start_idx; cpu_idx < (start_idx + ncpus); cpu_idx++) {
+		if (cpu_idx == my_idx)
+			continue;
+
+		if (is_local_state_run(
+			psci_get_cpu_local_state_by_idx((int)cpu_idx)) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/******************************************************************************
+ * This function is the OS-initiated mode version of
+ * psci_do_state_coordination(). The OS is responsible for the coordination in
+ * this mode, so instead of negotiating the target states, it verifies that the
+ * states requested in 'state_info' are the ones the platform would select
+ * given the requests of all the CPUs, and that the current CPU is the last
+ * running CPU at the highest requested power level.
+ *
+ * It returns PSCI_E_DENIED if another CPU of a power domain to suspend is still
+ * running, or PSCI_E_INVALID_PARAMS if the states requested by the CPUs are
+ * inconsistent. In both cases, the requested states of the current CPU are
+ * left unchanged. On success, the target states are updated in the power
+ * domain nodes.
+ *
+ * This function must be called with the power domain locks held.
+ *****************************************************************************/
+int psci_validate_state_coordination(unsigned int end_pwrlvl,
+				     psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	int start_idx;
+	unsigned int ncpus;
+	int rc = PSCI_E_SUCCESS;
+	plat_local_state_t target_state;
+	plat_local_state_t prev[PLAT_MAX_PWR_LVL];
+	const plat_local_state_t *req_states;
+#if PSCI_PD_CACHE_ALIGN
+	plat_local_state_t req_states_buf[PLATFORM_CORE_COUNT];
+#else
+	plat_local_state_t *req_states_buf = NULL;
+#endif
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	/* Save the previous requested states and update them */
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		prev[lvl - 1U] = psci_req_local_pwr_state(lvl - 1U, cpu_idx);
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+	}
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		/* Get the requested power states for this power level */
+		start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+		ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+		req_states = psci_get_req_local_pwr_states(lvl, start_idx,
+							   ncpus,
+							   req_states_buf);
+
+		/*
+		 * Let the platform coordinate amongst the requested states at
+		 * this power level and check that the result is the state the
+		 * OS asked for.
+		 */
+		target_state = plat_get_target_pwr_state(lvl,
+							 req_states,
+							 ncpus);
+
+		if (state_info->pwr_domain_state[lvl] != target_state) {
+			rc = (is_local_state_run(target_state) != 0) ?
+				PSCI_E_DENIED : PSCI_E_INVALID_PARAMS;
+			break;
+		}
+
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	/*
+	 * The OS may only power down a power domain from its last running CPU.
+	 * The levels above 'end_pwrlvl' are left running, so only this one
+	 * needs checking.
+	 */
+	if ((rc == PSCI_E_SUCCESS) &&
+	    !psci_is_last_cpu_to_idle_at_pwrlvl(end_pwrlvl))
+		rc = PSCI_E_DENIED;
+
+	if (rc != PSCI_E_SUCCESS) {
+		/* Restore the previous requested states */
+		for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+			psci_set_req_local_pwr_state(lvl, cpu_idx,
+						     prev[lvl - 1U]);
+		return rc;
+	}
+
+	/* Update the target state in the power domain nodes */
+	psci_set_target_local_pwr_states(end_pwrlvl, state_info);
+
+	return PSCI_E_SUCCESS;
+}
+#endif /* PSCI_OS_INIT_MODE */
+
+#if PSCI_LOCKLESS_SUSPEND
+/******************************************************************************
+ * This function is the lock-free version of psci_do_state_coordination() for
+ * the common case of a CPU suspending while another CPU of its cluster is
+ * running. The target state of the cluster, and thus of its ancestors, is RUN
+ * then, so only the CPU local state needs to be updated.
+ *
+ * This CPU publishes its requested states before reading the ones of the other
+ * CPUs. A CPU coordinating with the locks held does the same, so at least one
+ * of two CPUs suspending at the same time sees the request of the other, and
+ * the last CPU of the cluster always sees every request.
+ *
+ * It returns 1 if the target states have been coordinated in 'state_info', or
+ * 0 if all the other CPUs of the cluster are suspending too, in which case the
+ * caller must take the locks and call psci_do_state_coordination().
+ *****************************************************************************/
+int psci_do_state_coordination_lockless(unsigned int end_pwrlvl,
+					psci_power_state_t *state_info)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	unsigned int i, ncpus;
+	int start_idx;
+
+	assert((end_pwrlvl > PSCI_CPU_PWR_LVL) &&
+	       (end_pwrlvl <= PLAT_MAX_PWR_LVL));
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     state_info->pwr_domain_state[lvl]);
+
+	/* Order the updates before reading the states of the other CPUs */
+	dmbish();
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+
+	for (i = (unsigned int)start_idx;
+	     i < ((unsigned int)start_idx + ncpus); i++) {
+		if (i == cpu_idx)
+			continue;
+
+		if (is_local_state_run(psci_req_local_pwr_state(
+				PSCI_CPU_PWR_LVL, i)) != 0)
+			break;
+	}
+
+	if (i == ((unsigned int)start_idx + ncpus))
+		return 0;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		state_info->pwr_domain_state[lvl] = PSCI_LOCAL_STATE_RUN;
+
+	/*
+	 * The power domain nodes are already in the RUN state as a CPU of the
+	 * cluster is running. Need to flush as local_state might be accessed
+	 * with Data Cache disabled during power on.
+	 */
+	psci_set_cpu_local_state(state_info->pwr_domain_state[PSCI_CPU_PWR_LVL]);
+	psci_flush_cpu_data(psci_svc_cpu_data.local_state);
+
+	return 1;
+}
+#endif /* PSCI_LOCKLESS_SUSPEND */
+
+#if PSCI_LOCKLESS_RESUME
+/******************************************************************************
+ * This function is called by a CPU waking up from a suspend to 'end_pwrlvl'.
+ * It resets the requested states of the CPU to RUN, then checks if the power
+ * domains above the CPU are known to be running, i.e. the other CPUs of the
+ * cluster request the RUN state for the cluster and the power domain nodes
+ * are in the RUN state.
+ *
+ * This CPU publishes its requested states before reading the ones of the other
+ * CPUs, and a CPU coordinating with the locks held does the same. So either
+ * the coordinating CPU sees this CPU running, or this CPU sees the request of
+ * the coordinating CPU. In the first case the cluster can't be suspended
+ * behind the back of this CPU, so it only needs to resume its own power level
+ * and can skip the locks.
+ *
+ * It returns the power level to resume: PSCI_CPU_PWR_LVL if the power domains
+ * above the CPU are running, or 'end_pwrlvl' if the caller has to take the
+ * locks and look up the states the power domains have emerged from.
+ *****************************************************************************/
+unsigned int psci_get_lockless_resume_pwrlvl(unsigned int end_pwrlvl)
+{
+	unsigned int lvl, parent_idx, cpu_idx = plat_my_core_pos();
+	unsigned int i, ncpus;
+	int start_idx;
+
+	assert(end_pwrlvl <= PLAT_MAX_PWR_LVL);
+
+	if (end_pwrlvl == PSCI_CPU_PWR_LVL)
+		return end_pwrlvl;
+
+#if PSCI_OS_INIT_MODE
+	/*
+	 * In OS-initiated mode the last CPU of a power domain is found from
+	 * the local state of the other CPUs rather than from their requests.
+	 */
+	if (psci_suspend_mode == OS_INIT)
+		return end_pwrlvl;
+#endif
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++)
+		psci_set_req_local_pwr_state(lvl, cpu_idx,
+					     PSCI_LOCAL_STATE_RUN);
+
+	/* Order the updates before reading the states of the other CPUs */
+	dmbish();
+
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	start_idx = psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+
+	for (i = (unsigned int)start_idx;
+	     i < ((unsigned int)start_idx + ncpus); i++) {
+		if (i == cpu_idx)
+			continue;
+
+		if (is_local_state_run(psci_req_local_pwr_state(
+				PSCI_CPU_PWR_LVL, i)) == 0)
+			return end_pwrlvl;
+	}
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= end_pwrlvl; lvl++) {
+		if (is_local_state_run(
+			get_non_cpu_pd_node_local_state(parent_idx)) == 0)
+			return end_pwrlvl;
+
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	return PSCI_CPU_PWR_LVL;
+}
+#endif /* PSCI_LOCKLESS_RESUME */
+
 /******************************************************************************
  * This function validates a suspend request by making sure that if a standby
  * state is requested then no power level is turned off and the highest power
@@ -607,7 +947,7 @@ void psci_release_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx)
  ******************************************************************************/
 int psci_validate_mpidr(u_register_t mpidr)
 {
-	if (plat_core_pos_by_mpidr(mpidr) < 0)
+	if (psci_core_pos_by_mpidr(mpidr) < 0)
 		return PSCI_E_INVALID_PARAMS;
 
 	return PSCI_E_SUCCESS;
@@ -779,6 +1119,14 @@ void psci_warmboot_entrypoint(void)
 	 */
 	end_pwrlvl = get_power_on_target_pwrlvl();
 
+#if PSCI_LOCKLESS_RESUME
+	/*
+	 * If the power domains above this CPU are still running, only the CPU
+	 * power level has to be resumed, which needs no lock.
+	 */
+	end_pwrlvl = psci_get_lockless_resume_pwrlvl(end_pwrlvl);
+#endif
+
 	/*
 	 * This function acquires the lock corresponding to each power level so
 	 * that by the time all locks are taken, the system topology is snapshot
@@ -952,6 +1300,16 @@ void psci_do_pwrdown_sequence(unsigned int power_level)
 	 */
 	prepare_cpu_pwr_dwn(power_level);
 #else
+#ifdef PLAT_HW_FLUSH_PWR_LVL
+	/*
+	 * The hardware cleans the caches of the power domains at and above
+	 * PLAT_HW_FLUSH_PWR_LVL when they are powered down, so only the CPU
+	 * power down operations of the level below are needed.
+	 */
+	if (power_level >= PLAT_HW_FLUSH_PWR_LVL)
+		power_level = PLAT_HW_FLUSH_PWR_LVL - 1U;
+#endif
+
 	/*
 	 * Without hardware-assisted coherency, the CPU drivers disable data
 	 * caches, then perform cache-maintenance operations in software.
@@ -964,3 +1322,38 @@ void psci_do_pwrdown_sequence(unsigned int power_level)
 	psci_do_pwrdown_cache_maintenance(power_level);
 #endif
 }
+
+#if PSCI_PARALLEL_CACHE_CLEAN
+/*******************************************************************************
+ * Clean a slice of the caches that this CPU shares with the other CPUs of its
+ * parent power domain, before it powers down at the CPU level. The caches are
+ * split between the CPUs of the parent that go off before the last one, and
+ * the Nth of these CPUs to go off cleans the Nth slice. The last CPU then has
+ * less dirty data to write back when it powers the parent down, e.g. for
+ * SYSTEM_SUSPEND. This is best effort: a CPU that is being turned off at the
+ * same time may clean the same slice.
+ ******************************************************************************/
+void psci_clean_shared_cache_slice(unsigned int cpu_idx)
+{
+	unsigned int parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+	unsigned int start_idx =
+		(unsigned int)psci_non_cpu_pd_nodes[parent_idx].cpu_start_idx;
+	unsigned int ncpus = psci_non_cpu_pd_nodes[parent_idx].ncpus;
+	unsigned int i, slice = 0U;
+
+	for (i = start_idx; i < (start_idx + ncpus); i++) {
+		if (i == cpu_idx)
+			continue;
+
+		flush_cpu_data_by_index(i, psci_svc_cpu_data.aff_info_state);
+		if (psci_get_aff_info_state_by_idx((int)i) == AFF_STATE_OFF)
+			slice++;
+	}
+
+	/* The last CPU to go off flushes the shared caches itself */
+	if ((slice + 1U) >= ncpus)
+		return;
+
+	dcsw_clean_shared_slice(slice, ncpus - 1U);
+}
+#endif
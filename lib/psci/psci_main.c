@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_PSCI
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <arm_arch_svc.h>
@@ -44,6 +46,60 @@ int psci_cpu_on(u_register_t target_cpu,
 	return psci_cpu_on_start(target_cpu, &ep);
 }
 
+/*******************************************************************************
+ * Power on the cpus selected by 'cpu_mask' in a single call. Bit 'i' of the
+ * mask selects the cpu whose mpidr is 'target_cpu' with its lowest affinity
+ * field incremented by 'i'. That is the Aff1 field if the MT bit is set in
+ * 'target_cpu', and the Aff0 field otherwise. All the cpus start at the same
+ * entry point with the same context id.
+ *
+ * The mask of the cpus which have been powered on is returned in 'on_mask'.
+ * This is not a PSCI call, it is meant to be exposed by platforms as a SiP call.
+ ******************************************************************************/
+int psci_cpu_on_batch(u_register_t target_cpu,
+		      u_register_t cpu_mask,
+		      uintptr_t entrypoint,
+		      u_register_t context_id,
+		      u_register_t *on_mask)
+{
+	int rc;
+	unsigned int i, shift;
+	entry_point_info_t ep;
+
+	assert(on_mask != NULL);
+	*on_mask = 0U;
+
+	if (((psci_caps & define_psci_cap(PSCI_CPU_ON_AARCH64)) == 0U) ||
+	    (cpu_mask == 0U))
+		return PSCI_E_INVALID_PARAMS;
+
+	shift = ((target_cpu & MPIDR_MT_MASK) != 0U) ?
+		MPIDR_AFF1_SHIFT : MPIDR_AFF0_SHIFT;
+
+	/* Determine if all the cpus exist */
+	for (i = 0U; i < 64U; i++) {
+		if (((cpu_mask >> i) & 1U) == 0U)
+			continue;
+
+		if ((((target_cpu >> shift) & MPIDR_AFFLVL_MASK) + i) >
+		    MPIDR_AFFLVL_MASK)
+			return PSCI_E_INVALID_PARAMS;
+
+		rc = psci_validate_mpidr(target_cpu +
+					 ((u_register_t)i << shift));
+		if (rc != PSCI_E_SUCCESS)
+			return PSCI_E_INVALID_PARAMS;
+	}
+
+	/* Validate the entry point and get the entry_point_info */
+	rc = psci_validate_entry_point(&ep, entrypoint, context_id);
+	if (rc != PSCI_E_SUCCESS)
+		return rc;
+
+	return psci_cpu_on_batch_start(target_cpu, shift, cpu_mask, &ep,
+				       on_mask);
+}
+
 unsigned int psci_version(void)
 {
 	return PSCI_MAJOR_VER | PSCI_MINOR_VER;
@@ -71,16 +127,45 @@ int psci_cpu_suspend(unsigned int power_state,
 	 */
 	is_power_down_state = psci_get_pstate_type(power_state);
 
+#if PSCI_OS_INIT_MODE
+	/*
+	 * In OS-initiated mode the requested states are used as they are, so
+	 * they have to be checked here rather than by the state coordination.
+	 */
+	if (psci_suspend_mode == OS_INIT) {
+		rc = psci_validate_suspend_req(&state_info,
+					       is_power_down_state);
+		if (rc != PSCI_E_SUCCESS)
+			return rc;
+	}
+#endif
+
 	/* Sanity check the requested suspend levels */
 	assert(psci_validate_suspend_req(&state_info, is_power_down_state)
 			== PSCI_E_SUCCESS);
 
+#if PSCI_STAT_IDLE_PREDICT
+	/*
+	 * Avoid powering down the power domains above this CPU if they are
+	 * not expected to be idle for long enough. The OS has already made
+	 * this decision in OS-initiated mode.
+	 */
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == PLAT_COORD)
+#endif
+		psci_stats_predict_suspend_state(&state_info);
+#endif
+
 	target_pwrlvl = psci_find_target_suspend_lvl(&state_info);
 	if (target_pwrlvl == PSCI_INVALID_PWR_LVL) {
 		ERROR("Invalid target power level for suspend operation\n");
 		panic();
 	}
 
+#if ENABLE_PSCI_SUSPEND_TRACE
+	rt_instr_suspend_trace_start(power_state);
+#endif
+
 	/* Fast path for CPU standby.*/
 	if (is_cpu_standby_req(is_power_down_state, target_pwrlvl)) {
 		if  (psci_plat_pm_ops->cpu_standby == NULL)
@@ -138,14 +223,13 @@ int psci_cpu_suspend(unsigned int power_state,
 	 * Do what is needed to enter the power down state. Upon success,
 	 * enter the final wfi which will power down this CPU. This function
 	 * might return if the power down was abandoned for any reason, e.g.
-	 * arrival of an interrupt
+	 * arrival of an interrupt, or if the request was rejected in
+	 * OS-initiated mode.
 	 */
-	psci_cpu_suspend_start(&ep,
-			    target_pwrlvl,
-			    &state_info,
-			    is_power_down_state);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      target_pwrlvl,
+				      &state_info,
+				      is_power_down_state);
 }
 
 
@@ -185,12 +269,10 @@ int psci_system_suspend(uintptr_t entrypoint, u_register_t context_id)
 	 * might return if the power down was abandoned for any reason, e.g.
 	 * arrival of an interrupt
 	 */
-	psci_cpu_suspend_start(&ep,
-			    PLAT_MAX_PWR_LVL,
-			    &state_info,
-			    PSTATE_TYPE_POWERDOWN);
-
-	return PSCI_E_SUCCESS;
+	return psci_cpu_suspend_start(&ep,
+				      PLAT_MAX_PWR_LVL,
+				      &state_info,
+				      PSTATE_TYPE_POWERDOWN);
 }
 
 int psci_cpu_off(void)
@@ -224,7 +306,7 @@ int psci_affinity_info(u_register_t target_affinity,
 		return PSCI_E_INVALID_PARAMS;
 
 	/* Calculate the cpu index of the target */
-	target_idx = plat_core_pos_by_mpidr(target_affinity);
+	target_idx = psci_core_pos_by_mpidr(target_affinity);
 	if (target_idx == -1)
 		return PSCI_E_INVALID_PARAMS;
 
@@ -353,10 +435,12 @@ int psci_features(unsigned int psci_fid)
 	if ((psci_fid == PSCI_CPU_SUSPEND_AARCH32) ||
 	    (psci_fid == PSCI_CPU_SUSPEND_AARCH64)) {
 		/*
-		 * The trusted firmware does not support OS Initiated Mode.
+		 * The trusted firmware only supports OS Initiated Mode when
+		 * built with PSCI_OS_INIT_MODE.
 		 */
 		unsigned int ret = ((FF_PSTATE << FF_PSTATE_SHIFT) |
-			(((FF_SUPPORTS_OS_INIT_MODE == 1U) ? 0U : 1U)
+			(((PSCI_OS_INIT_MODE != 0) ?
+				FF_SUPPORTS_OS_INIT_MODE : 0U)
 				<< FF_MODE_SUPPORT_SHIFT));
 		return (int) ret;
 	}
@@ -365,6 +449,41 @@ int psci_features(unsigned int psci_fid)
 	return PSCI_E_SUCCESS;
 }
 
+#if PSCI_OS_INIT_MODE
+int psci_set_suspend_mode(unsigned int mode)
+{
+	int cpu_idx, my_idx = (int) plat_my_core_pos();
+
+	if ((mode != PLAT_COORD) && (mode != OS_INIT))
+		return PSCI_E_INVALID_PARAMS;
+
+	if (psci_suspend_mode == mode)
+		return PSCI_E_SUCCESS;
+
+	/*
+	 * The mode can only be changed while no CPU is suspended, i.e. every
+	 * other CPU is either running or powered off. The state of the other
+	 * CPUs is flushed first as in psci_affinity_info().
+	 */
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		if (cpu_idx == my_idx)
+			continue;
+
+		flush_cpu_data_by_index((unsigned int)cpu_idx,
+					psci_svc_cpu_data);
+
+		if ((psci_get_aff_info_state_by_idx(cpu_idx) == AFF_STATE_ON) &&
+		    (is_local_state_run(
+			psci_get_cpu_local_state_by_idx(cpu_idx)) == 0))
+			return PSCI_E_DENIED;
+	}
+
+	psci_suspend_mode = (suspend_mode_t)mode;
+
+	return PSCI_E_SUCCESS;
+}
+#endif
+
 /*******************************************************************************
  * PSCI top level handler for servicing SMCs.
  ******************************************************************************/
@@ -448,6 +567,12 @@ u_register_t psci_smc_handler(uint32_t smc_fid,
 			ret = (u_register_t)psci_features(r1);
 			break;
 
+#if PSCI_OS_INIT_MODE
+		case PSCI_SET_SUSPEND_MODE:
+			ret = (u_register_t)psci_set_suspend_mode(r1);
+			break;
+#endif
+
 #if ENABLE_PSCI_STAT
 		case PSCI_STAT_RESIDENCY_AARCH32:
 			ret = psci_stat_residency(r1, r2);
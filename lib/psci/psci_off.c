@@ -10,6 +10,7 @@
 #include <debug.h>
 #include <platform.h>
 #include <pmf.h>
+#include <pubsub_events.h>
 #include <runtime_instr.h>
 #include <string.h>
 #include "psci_private.h"
@@ -71,6 +72,8 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 			goto exit;
 	}
 
+	PUBLISH_EVENT(psci_cpu_off_start);
+
 	/*
 	 * This function is passed the requested state info and
 	 * it returns the negotiated state info for each power level upto
@@ -94,6 +97,15 @@ int psci_do_cpu_off(unsigned int end_pwrlvl)
 		PMF_CACHE_MAINT);
 #endif
 
+#if PSCI_PARALLEL_CACHE_CLEAN
+	/*
+	 * Share the cleaning of the caches of the parent power domain if it
+	 * stays on after this CPU.
+	 */
+	if (psci_find_max_off_lvl(&state_info) == PSCI_CPU_PWR_LVL)
+		psci_clean_shared_cache_slice((unsigned int)idx);
+#endif
+
 	/*
 	 * Arch. management. Initiate power down sequence.
 	 */
@@ -12,6 +12,7 @@
 #include <debug.h>
 #include <platform.h>
 #include <pubsub_events.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include "psci_private.h"
 
@@ -44,6 +45,55 @@ static int cpu_on_validate_state(aff_info_state_t aff_state)
 	return PSCI_E_SUCCESS;
 }
 
+#if PSCI_PRESET_CPU_ON_CONTEXT
+/*
+ * Non-secure context made at cold boot for the entrypoints of CPU_ON, and the
+ * SPSR and attributes of the entrypoint it was made for. Only the address and
+ * the arguments of the entrypoint then need to be filled in on CPU_ON.
+ */
+static cpu_context_t psci_ns_ctx_preset;
+static uint32_t psci_ns_ctx_preset_spsr;
+static uint32_t psci_ns_ctx_preset_attr;
+static bool psci_ns_ctx_preset_valid;
+
+/*******************************************************************************
+ * Prepare the Non-secure context of the CPUs turned on by CPU_ON, with the SPSR
+ * and attributes of `ns_ep`. It is called by the primary CPU at cold boot,
+ * with the entrypoint of the Non-secure image as it is usually entered in the
+ * same mode as the one it later asks the CPUs to be turned on in.
+ ******************************************************************************/
+void __init psci_preset_cpu_on_context(const entry_point_info_t *ns_ep)
+{
+	assert(ns_ep != NULL);
+	assert(GET_SECURITY_STATE(ns_ep->h.attr) == NON_SECURE);
+
+	cm_setup_context(&psci_ns_ctx_preset, ns_ep);
+	psci_ns_ctx_preset_spsr = ns_ep->spsr;
+	psci_ns_ctx_preset_attr = ns_ep->h.attr;
+	psci_ns_ctx_preset_valid = true;
+}
+#endif /* PSCI_PRESET_CPU_ON_CONTEXT */
+
+/*******************************************************************************
+ * Store the re-entry information of the target cpu for the non-secure world.
+ ******************************************************************************/
+static void psci_cpu_on_init_context(int target_idx,
+				     const entry_point_info_t *ep)
+{
+#if PSCI_PRESET_CPU_ON_CONTEXT
+	if (psci_ns_ctx_preset_valid &&
+	    (ep->spsr == psci_ns_ctx_preset_spsr) &&
+	    (EP_GET_EE(ep->h.attr) == EP_GET_EE(psci_ns_ctx_preset_attr)) &&
+	    (EP_GET_ST(ep->h.attr) == EP_GET_ST(psci_ns_ctx_preset_attr))) {
+		cm_setup_context_from(cm_get_context_by_index(
+					(unsigned int)target_idx, NON_SECURE),
+				      &psci_ns_ctx_preset, ep);
+		return;
+	}
+#endif
+	cm_init_context_by_index((unsigned int)target_idx, ep);
+}
+
 /*******************************************************************************
  * Generic handler which is called to physically power on a cpu identified by
  * its mpidr. It performs the generic, architectural, platform setup and state
@@ -59,7 +109,7 @@ int psci_cpu_on_start(u_register_t target_cpu,
 {
 	int rc;
 	aff_info_state_t target_aff_state;
-	int target_idx = plat_core_pos_by_mpidr(target_cpu);
+	int target_idx = psci_core_pos_by_mpidr(target_cpu);
 
 	/* Calling function must supply valid input arguments */
 	assert(target_idx >= 0);
@@ -144,7 +194,7 @@ int psci_cpu_on_start(u_register_t target_cpu,
 
 	if (rc == PSCI_E_SUCCESS)
 		/* Store the re-entry information for the non-secure world. */
-		cm_init_context_by_index((unsigned int)target_idx, ep);
+		psci_cpu_on_init_context(target_idx, ep);
 	else {
 		/* Restore the state on error. */
 		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_OFF);
@@ -157,6 +207,117 @@ exit:
 	return rc;
 }
 
+/*******************************************************************************
+ * Generic handler which is called to physically power on several cpus in one
+ * go. The cpus are the ones selected by the bits set in 'cpu_mask', bit 'i'
+ * selecting the cpu with the mpidr 'target_cpu + (i << shift)'. All the cpus
+ * are expected to be valid.
+ *
+ * The requests are handled in two passes. The first one validates the state of
+ * each cpu and stashes its entry point information, keeping the cpu lock held
+ * so that the cpu can't use its context before it has been initialised. The
+ * second one calls the platform handler for each prepared cpu and releases its
+ * lock. The mask of the cpus which have been powered on is returned in
+ * 'on_mask', and the first error encountered, if any, is returned.
+ ******************************************************************************/
+int psci_cpu_on_batch_start(u_register_t target_cpu,
+			    unsigned int shift,
+			    u_register_t cpu_mask,
+			    const entry_point_info_t *ep,
+			    u_register_t *on_mask)
+{
+	int rc, ret = PSCI_E_SUCCESS;
+	int target_idx;
+	unsigned int i;
+	u_register_t mpidr, prepared = 0U;
+	aff_info_state_t target_aff_state;
+
+	assert((ep != NULL) && (on_mask != NULL));
+	assert((psci_plat_pm_ops->pwr_domain_on != NULL) &&
+	       (psci_plat_pm_ops->pwr_domain_on_finish != NULL));
+
+	*on_mask = 0U;
+
+	/* Prepare the cpus, see psci_cpu_on_start() */
+	for (i = 0U; i < 64U; i++) {
+		if (((cpu_mask >> i) & 1U) == 0U)
+			continue;
+
+		mpidr = target_cpu + ((u_register_t)i << shift);
+		target_idx = psci_core_pos_by_mpidr(mpidr);
+		assert(target_idx >= 0);
+
+		psci_spin_lock_cpu(target_idx);
+
+		flush_cpu_data_by_index((unsigned int)target_idx,
+					psci_svc_cpu_data.aff_info_state);
+		rc = cpu_on_validate_state(
+			psci_get_aff_info_state_by_idx(target_idx));
+		if (rc != PSCI_E_SUCCESS) {
+			psci_spin_unlock_cpu(target_idx);
+			if (ret == PSCI_E_SUCCESS)
+				ret = rc;
+			continue;
+		}
+
+		if ((psci_spd_pm != NULL) && (psci_spd_pm->svc_on != NULL))
+			psci_spd_pm->svc_on(mpidr);
+
+		psci_set_aff_info_state_by_idx(target_idx, AFF_STATE_ON_PENDING);
+		flush_cpu_data_by_index((unsigned int)target_idx,
+					psci_svc_cpu_data.aff_info_state);
+
+		target_aff_state = psci_get_aff_info_state_by_idx(target_idx);
+		if (target_aff_state != AFF_STATE_ON_PENDING) {
+			assert(target_aff_state == AFF_STATE_OFF);
+			psci_set_aff_info_state_by_idx(target_idx,
+						       AFF_STATE_ON_PENDING);
+			flush_cpu_data_by_index((unsigned int)target_idx,
+					psci_svc_cpu_data.aff_info_state);
+
+			assert(psci_get_aff_info_state_by_idx(target_idx) ==
+			       AFF_STATE_ON_PENDING);
+		}
+
+		/*
+		 * Store the re-entry information for the non-secure world. The
+		 * cpu is not powered on yet, so the context is simply
+		 * overwritten by the next CPU_ON if the power on fails.
+		 */
+		psci_cpu_on_init_context(target_idx, ep);
+
+		prepared |= (u_register_t)1U << i;
+	}
+
+	/* Power on the prepared cpus */
+	for (i = 0U; i < 64U; i++) {
+		if (((prepared >> i) & 1U) == 0U)
+			continue;
+
+		mpidr = target_cpu + ((u_register_t)i << shift);
+		target_idx = psci_core_pos_by_mpidr(mpidr);
+
+		rc = psci_plat_pm_ops->pwr_domain_on(mpidr);
+		assert((rc == PSCI_E_SUCCESS) || (rc == PSCI_E_INTERN_FAIL));
+
+		if (rc == PSCI_E_SUCCESS) {
+			*on_mask |= (u_register_t)1U << i;
+		} else {
+			/* Restore the state on error. */
+			psci_set_aff_info_state_by_idx(target_idx,
+						       AFF_STATE_OFF);
+			flush_cpu_data_by_index((unsigned int)target_idx,
+					psci_svc_cpu_data.aff_info_state);
+			if (ret == PSCI_E_SUCCESS)
+				ret = rc;
+		}
+
+		psci_spin_unlock_cpu(target_idx);
+	}
+
+	return ret;
+}
+
 /*******************************************************************************
  * The following function finish an earlier power on request. They
  * are called by the common finisher routine in psci_common.c. The `state_info`
@@ -12,7 +12,9 @@
 #include <bakery_lock.h>
 #include <bl_common.h>
 #include <cpu_data.h>
+#include <platform.h>
 #include <psci.h>
+#include <psci_prebuilt_topology.h>
 #include <spinlock.h>
 #include <stdbool.h>
 
@@ -100,6 +102,30 @@ static inline bool is_cpu_standby_req(unsigned int is_power_down_state,
 	return (is_power_down_state == 0U) && (retn_lvl == 0U);
 }
 
+/*
+ * Linear index of the CPU `mpidr`, or -1 if it's invalid. With
+ * PREBUILT_PSCI_TOPOLOGY, it's looked up in the table generated at build time
+ * instead of being computed by the platform.
+ */
+static inline int psci_core_pos_by_mpidr(u_register_t mpidr)
+{
+#if PREBUILT_PSCI_TOPOLOGY
+	return psci_prebuilt_core_pos_by_mpidr(mpidr);
+#else
+	return plat_core_pos_by_mpidr(mpidr);
+#endif
+}
+
+/*
+ * With PSCI_PD_CACHE_ALIGN, each power domain node is kept in its own cache
+ * line so that the CPUs of different power domains don't share lines.
+ */
+#if PSCI_PD_CACHE_ALIGN
+#define __psci_pd_aligned	__aligned(CACHE_WRITEBACK_GRANULE)
+#else
+#define __psci_pd_aligned
+#endif
+
 /*******************************************************************************
  * The following two data structures implement the power domain tree. The tree
  * is used to track the state of all the nodes i.e. power domain instances
@@ -133,7 +159,7 @@ typedef struct non_cpu_pwr_domain_node {
 
 	/* For indexing the psci_lock array*/
 	unsigned char lock_index;
-} non_cpu_pd_node_t;
+} __psci_pd_aligned non_cpu_pd_node_t;
 
 typedef struct cpu_pwr_domain_node {
 	u_register_t mpidr;
@@ -151,7 +177,7 @@ typedef struct cpu_pwr_domain_node {
 	 * when multiple CPUs try to turn ON the same target CPU.
 	 */
 	spinlock_t cpu_lock;
-} cpu_pd_node_t;
+} __psci_pd_aligned cpu_pd_node_t;
 
 /*******************************************************************************
  * The following are helpers and declarations of locks.
@@ -159,9 +185,14 @@ typedef struct cpu_pwr_domain_node {
 #if HW_ASSISTED_COHERENCY
 /*
  * On systems where participant CPUs are cache-coherent, we can use spinlocks
- * instead of bakery locks.
+ * instead of bakery locks. Ticket locks can be used to serve the CPUs in the
+ * order they have requested the lock.
  */
+#if USE_TICKET_LOCKS
+#define DEFINE_PSCI_LOCK(_name)		ticketlock_t _name
+#else
 #define DEFINE_PSCI_LOCK(_name)		spinlock_t _name
+#endif
 #define DECLARE_PSCI_LOCK(_name)	extern DEFINE_PSCI_LOCK(_name)
 
 /* One lock is required per non-CPU power domain node */
@@ -188,12 +219,20 @@ static inline void psci_dsbish(void)
 
 static inline void psci_lock_get(non_cpu_pd_node_t *non_cpu_pd_node)
 {
+#if USE_TICKET_LOCKS
+	ticket_lock(&psci_locks[non_cpu_pd_node->lock_index]);
+#else
 	spin_lock(&psci_locks[non_cpu_pd_node->lock_index]);
+#endif
 }
 
 static inline void psci_lock_release(non_cpu_pd_node_t *non_cpu_pd_node)
 {
+#if USE_TICKET_LOCKS
+	ticket_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
+#else
 	spin_unlock(&psci_locks[non_cpu_pd_node->lock_index]);
+#endif
 }
 
 #else /* if HW_ASSISTED_COHERENCY == 0 */
@@ -249,6 +288,9 @@ extern const plat_psci_ops_t *psci_plat_pm_ops;
 extern non_cpu_pd_node_t psci_non_cpu_pd_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS];
 extern cpu_pd_node_t psci_cpu_pd_nodes[PLATFORM_CORE_COUNT];
 extern unsigned int psci_caps;
+#if PSCI_OS_INIT_MODE
+extern suspend_mode_t psci_suspend_mode;
+#endif
 
 /*******************************************************************************
  * SPD's power management hooks registered with PSCI
@@ -273,6 +315,17 @@ void psci_get_parent_pwr_domain_nodes(int cpu_idx,
 				      unsigned int *node_index);
 void psci_do_state_coordination(unsigned int end_pwrlvl,
 				psci_power_state_t *state_info);
+#if PSCI_OS_INIT_MODE
+int psci_validate_state_coordination(unsigned int end_pwrlvl,
+				     psci_power_state_t *state_info);
+#endif
+#if PSCI_LOCKLESS_SUSPEND
+int psci_do_state_coordination_lockless(unsigned int end_pwrlvl,
+					psci_power_state_t *state_info);
+#endif
+#if PSCI_LOCKLESS_RESUME
+unsigned int psci_get_lockless_resume_pwrlvl(unsigned int end_pwrlvl);
+#endif
 void psci_acquire_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx);
 void psci_release_pwr_domain_locks(unsigned int end_pwrlvl, int cpu_idx);
 int psci_validate_suspend_req(const psci_power_state_t *state_info,
@@ -284,6 +337,9 @@ void psci_print_power_domain_map(void);
 unsigned int psci_is_last_on_cpu(void);
 int psci_spd_migrate_info(u_register_t *mpidr);
 void psci_do_pwrdown_sequence(unsigned int power_level);
+#if PSCI_PARALLEL_CACHE_CLEAN
+void psci_clean_shared_cache_slice(unsigned int cpu_idx);
+#endif
 
 /*
  * CPU power down is directly called only when HW_ASSISTED_COHERENCY is
@@ -295,6 +351,11 @@ void prepare_cpu_pwr_dwn(unsigned int power_level);
 /* Private exported functions from psci_on.c */
 int psci_cpu_on_start(u_register_t target_cpu,
 		      const entry_point_info_t *ep);
+int psci_cpu_on_batch_start(u_register_t target_cpu,
+			    unsigned int shift,
+			    u_register_t cpu_mask,
+			    const entry_point_info_t *ep,
+			    u_register_t *on_mask);
 
 void psci_cpu_on_finish(int cpu_idx, const psci_power_state_t *state_info);
 
@@ -302,7 +363,7 @@ void psci_cpu_on_finish(int cpu_idx, const psci_power_state_t *state_info);
 int psci_do_cpu_off(unsigned int end_pwrlvl);
 
 /* Private exported functions from psci_suspend.c */
-void psci_cpu_suspend_start(const entry_point_info_t *ep,
+int psci_cpu_suspend_start(const entry_point_info_t *ep,
 			unsigned int end_pwrlvl,
 			psci_power_state_t *state_info,
 			unsigned int is_power_down_state);
@@ -327,6 +388,9 @@ u_register_t psci_stat_residency(u_register_t target_cpu,
 			unsigned int power_state);
 u_register_t psci_stat_count(u_register_t target_cpu,
 			unsigned int power_state);
+#if PSCI_STAT_IDLE_PREDICT
+void psci_stats_predict_suspend_state(psci_power_state_t *state_info);
+#endif
 
 /* Private exported functions from psci_mem_protect.c */
 u_register_t psci_mem_protect(unsigned int enable);
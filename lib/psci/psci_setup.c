@@ -71,6 +71,7 @@ static void __init psci_init_pwr_domain_node(unsigned char node_idx,
 	}
 }
 
+#if !PREBUILT_PSCI_TOPOLOGY
 /*******************************************************************************
  * This functions updates cpu_start_idx and ncpus field for each of the node in
  * psci_non_cpu_pd_nodes[]. It does so by comparing the parent nodes of each of
@@ -161,6 +162,36 @@ static void __init populate_power_domain_tree(const unsigned char *topology)
 	assert((int) j == PLATFORM_CORE_COUNT);
 }
 
+#else /* PREBUILT_PSCI_TOPOLOGY */
+/*******************************************************************************
+ * Populate the power domain tree from the tables generated at build time by
+ * topology_gen, which also hold the CPU limits of the non CPU power domains.
+ * In debug builds, check that the platform maps the MPIDRs of the tables to
+ * the same linear indices.
+ ******************************************************************************/
+static void __init populate_prebuilt_power_domain_tree(void)
+{
+	const psci_prebuilt_pd_node_t *node;
+	unsigned int i;
+
+	for (i = 0U; i < psci_prebuilt_non_cpu_node_count; i++) {
+		node = &psci_prebuilt_non_cpu_nodes[i];
+		psci_init_pwr_domain_node((unsigned char)i, node->parent_node,
+					  node->level);
+		psci_non_cpu_pd_nodes[i].cpu_start_idx = node->cpu_start_idx;
+		psci_non_cpu_pd_nodes[i].ncpus = node->ncpus;
+	}
+
+	for (i = 0U; i < (unsigned int)PLATFORM_CORE_COUNT; i++) {
+		assert(plat_core_pos_by_mpidr(psci_prebuilt_cpu_mpidr[i]) ==
+		       (int)i);
+		psci_init_pwr_domain_node((unsigned char)i,
+					  psci_prebuilt_cpu_parent[i],
+					  (unsigned char)PSCI_CPU_PWR_LVL);
+	}
+}
+#endif /* PREBUILT_PSCI_TOPOLOGY */
+
 /*******************************************************************************
  * This function does the architectural setup and takes the warm boot
  * entry-point `mailbox_ep` as an argument. The function also initializes the
@@ -186,13 +217,19 @@ static void __init populate_power_domain_tree(const unsigned char *topology)
  ******************************************************************************/
 int __init psci_setup(const psci_lib_args_t *lib_args)
 {
+#if !PREBUILT_PSCI_TOPOLOGY
 	const unsigned char *topology_tree;
+#endif
 
 	assert(VERIFY_PSCI_LIB_ARGS_V1(lib_args));
 
 	/* Do the Architectural initialization */
 	psci_arch_setup();
 
+#if PREBUILT_PSCI_TOPOLOGY
+	/* Populate the power domain arrays from the generated tables */
+	populate_prebuilt_power_domain_tree();
+#else
 	/* Query the topology map from the platform */
 	topology_tree = plat_get_power_domain_tree_desc();
 
@@ -201,6 +238,7 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 
 	/* Update the CPU limits for each node in psci_non_cpu_pd_nodes */
 	psci_update_pwrlvl_limits();
+#endif
 
 	/* Populate the mpidr field of cpu node for this CPU */
 	psci_cpu_pd_nodes[plat_my_core_pos()].mpidr =
@@ -238,6 +276,9 @@ int __init psci_setup(const psci_lib_args_t *lib_args)
 		psci_caps |=  define_psci_cap(PSCI_CPU_SUSPEND_AARCH64);
 		if (psci_plat_pm_ops->get_sys_suspend_power_state != NULL)
 			psci_caps |=  define_psci_cap(PSCI_SYSTEM_SUSPEND_AARCH64);
+#if PSCI_OS_INIT_MODE
+		psci_caps |=  define_psci_cap(PSCI_SET_SUSPEND_MODE);
+#endif
 	}
 	if (psci_plat_pm_ops->system_off != NULL)
 		psci_caps |=  define_psci_cap(PSCI_SYSTEM_OFF);
@@ -4,21 +4,25 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_PSCI
+
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <stdbool.h>
 #include "psci_private.h"
 
-#ifndef PLAT_MAX_PWR_LVL_STATES
-#define PLAT_MAX_PWR_LVL_STATES		2U
-#endif
-
-/* Following structure is used for PSCI STAT */
-typedef struct psci_stat {
-	u_register_t residency;
-	u_register_t count;
-} psci_stat_t;
+/*
+ * Following structure holds the PSCI STAT values of a power domain. They are
+ * only updated by one CPU at a time, which keeps `seq` odd while it writes
+ * them, so that they can be read by any CPU without taking a lock.
+ */
+typedef struct psci_stat_pd {
+	unsigned int seq;
+	psci_stat_t stat[PLAT_MAX_PWR_LVL_STATES];
+} psci_stat_pd_t;
 
 /*
  * Following is used to keep track of the last cpu
@@ -31,10 +35,147 @@ static int last_cpu_in_non_cpu_pd[PSCI_NUM_NON_CPU_PWR_DOMAINS] = {
  * Following are used to store PSCI STAT values for
  * CPU and non CPU power domains.
  */
-static psci_stat_t psci_cpu_stat[PLATFORM_CORE_COUNT]
-				[PLAT_MAX_PWR_LVL_STATES];
-static psci_stat_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS]
-				[PLAT_MAX_PWR_LVL_STATES];
+static psci_stat_pd_t psci_cpu_stat[PLATFORM_CORE_COUNT];
+static psci_stat_pd_t psci_non_cpu_stat[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+/* Account an exit from a low power state in the stats of a power domain */
+static void psci_stat_pd_update(psci_stat_pd_t *pd, int stat_idx,
+				u_register_t residency)
+{
+	volatile psci_stat_pd_t *vpd = pd;
+
+	vpd->seq++;
+	dmbishst();
+
+	vpd->stat[stat_idx].residency += residency;
+	vpd->stat[stat_idx].count++;
+
+	dmbishst();
+	vpd->seq++;
+}
+
+/*
+ * Take a consistent snapshot of the stats of all the local states of a power
+ * domain. The copy is retried if the stats are updated while it is made.
+ */
+static void psci_stat_pd_read(const psci_stat_pd_t *pd, psci_stat_t *stats)
+{
+	const volatile psci_stat_pd_t *vpd = pd;
+	unsigned int seq, i;
+
+	do {
+		seq = vpd->seq;
+		dmbish();
+
+		for (i = 0U; i < PLAT_MAX_PWR_LVL_STATES; i++) {
+			stats[i].residency = vpd->stat[i].residency;
+			stats[i].count = vpd->stat[i].count;
+		}
+
+		dmbish();
+	} while (((seq & 1U) != 0U) || (vpd->seq != seq));
+}
+
+#if PSCI_STAT_IDLE_PREDICT
+/*
+ * Following structure is used to predict the residency of the next idle period
+ * of a power domain. It holds an average of the recent residencies, in which
+ * each new residency has a weight of 1 / 2^PSCI_STAT_PREDICT_SHIFT, whatever
+ * the low power state it was spent in.
+ */
+#define PSCI_STAT_PREDICT_SHIFT		U(2)
+
+typedef struct psci_stat_predict {
+	u_register_t avg_residency;
+	bool valid;
+} psci_stat_predict_t;
+
+static psci_stat_predict_t psci_cpu_predict[PLATFORM_CORE_COUNT];
+static psci_stat_predict_t psci_non_cpu_predict[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+
+static void psci_stat_predict_update(psci_stat_predict_t *predict,
+				     u_register_t residency)
+{
+	if (!predict->valid) {
+		predict->avg_residency = residency;
+		predict->valid = true;
+		return;
+	}
+
+	predict->avg_residency = predict->avg_residency -
+		(predict->avg_residency >> PSCI_STAT_PREDICT_SHIFT) +
+		(residency >> PSCI_STAT_PREDICT_SHIFT);
+}
+
+/*******************************************************************************
+ * This function is passed the local power states requested for each power
+ * domain (state_info) by a CPU_SUSPEND call. If the idle period predicted for
+ * a power domain above the CPU level is shorter than the break-even time of
+ * the requested power down state, the request is demoted to the shallower
+ * state given by the platform, a retention state or a power down state.
+ *
+ * The idle period of a power domain ends when any of its CPUs wakes up, so it
+ * is predicted as the shortest of the recent residencies of the power domain
+ * and of the current CPU. As the idle period of a power domain can't be longer
+ * than the one of its children, once a level is demoted all the higher levels
+ * requested to power down must be demoted too. If one of them can't be, the
+ * request is left unchanged.
+ ******************************************************************************/
+void psci_stats_predict_suspend_state(psci_power_state_t *state_info)
+{
+	unsigned int lvl, first_lvl = PSCI_INVALID_PWR_LVL, parent_idx;
+	int cpu_idx = (int) plat_my_core_pos();
+	u_register_t predicted, break_even;
+	plat_local_state_t local_state;
+	plat_local_state_t demoted[PLAT_MAX_PWR_LVL + 1U];
+	const psci_stat_predict_t *predict;
+
+	assert(state_info != NULL);
+
+	if ((psci_plat_pm_ops->get_pwr_lvl_break_even == NULL) ||
+	    !psci_cpu_predict[cpu_idx].valid)
+		return;
+
+	predicted = psci_cpu_predict[cpu_idx].avg_residency;
+	parent_idx = psci_cpu_pd_nodes[cpu_idx].parent_node;
+
+	for (lvl = PSCI_CPU_PWR_LVL + 1U; lvl <= PLAT_MAX_PWR_LVL; lvl++) {
+		local_state = state_info->pwr_domain_state[lvl];
+		if (is_local_state_off(local_state) == 0)
+			break;
+
+		break_even = psci_plat_pm_ops->get_pwr_lvl_break_even(
+				local_state, lvl, &demoted[lvl]);
+
+		if (first_lvl == PSCI_INVALID_PWR_LVL) {
+			predict = &psci_non_cpu_predict[parent_idx];
+			if (predict->valid &&
+			    (predict->avg_residency < predicted))
+				predicted = predict->avg_residency;
+
+			if ((break_even != 0U) && (predicted < break_even))
+				first_lvl = lvl;
+		} else if (break_even == 0U) {
+			/* A higher level can't be demoted */
+			return;
+		}
+
+		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
+	}
+
+	if (first_lvl == PSCI_INVALID_PWR_LVL)
+		return;
+
+	for (lvl = first_lvl; lvl <= PLAT_MAX_PWR_LVL; lvl++) {
+		if (is_local_state_off(state_info->pwr_domain_state[lvl]) == 0)
+			break;
+
+		assert((demoted[lvl] != PSCI_LOCAL_STATE_RUN) &&
+		       (demoted[lvl] < state_info->pwr_domain_state[lvl]));
+		state_info->pwr_domain_state[lvl] = demoted[lvl];
+	}
+}
+#endif /* PSCI_STAT_IDLE_PREDICT */
 
 /*
  * This functions returns the index into the `psci_stat_t` array given the
@@ -124,8 +265,10 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 	    state_info, cpu_idx);
 
 	/* Update CPU stats. */
-	psci_cpu_stat[cpu_idx][stat_idx].residency += residency;
-	psci_cpu_stat[cpu_idx][stat_idx].count++;
+	psci_stat_pd_update(&psci_cpu_stat[cpu_idx], stat_idx, residency);
+#if PSCI_STAT_IDLE_PREDICT
+	psci_stat_predict_update(&psci_cpu_predict[cpu_idx], residency);
+#endif
 
 	/*
 	 * Check what power domains above CPU were off
@@ -156,8 +299,12 @@ void psci_stats_update_pwr_up(unsigned int end_pwrlvl,
 		stat_idx = get_stat_idx(local_state, lvl);
 
 		/* Update non cpu stats */
-		psci_non_cpu_stat[parent_idx][stat_idx].residency += residency;
-		psci_non_cpu_stat[parent_idx][stat_idx].count++;
+		psci_stat_pd_update(&psci_non_cpu_stat[parent_idx], stat_idx,
+				    residency);
+#if PSCI_STAT_IDLE_PREDICT
+		psci_stat_predict_update(&psci_non_cpu_predict[parent_idx],
+					 residency);
+#endif
 
 		parent_idx = psci_non_cpu_pd_nodes[parent_idx].parent_node;
 	}
@@ -177,9 +324,10 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 	int stat_idx;
 	psci_power_state_t state_info = { {PSCI_LOCAL_STATE_RUN} };
 	plat_local_state_t local_state;
+	psci_stat_t stats[PLAT_MAX_PWR_LVL_STATES];
 
 	/* Validate the target_cpu parameter and determine the cpu index */
-	target_idx = (unsigned int) plat_core_pos_by_mpidr(target_cpu);
+	target_idx = (unsigned int) psci_core_pos_by_mpidr(target_cpu);
 	if (target_idx == (unsigned int) -1)
 		return PSCI_E_INVALID_PARAMS;
 
@@ -211,10 +359,44 @@ static int psci_get_stat(u_register_t target_cpu, unsigned int power_state,
 			parent_idx = SPECULATION_SAFE_VALUE(psci_non_cpu_pd_nodes[parent_idx].parent_node);
 
 		/* Get the non cpu power domain stats */
-		*psci_stat = psci_non_cpu_stat[parent_idx][stat_idx];
+		psci_stat_pd_read(&psci_non_cpu_stat[parent_idx], stats);
 	} else {
 		/* Get the cpu power domain stats */
-		*psci_stat = psci_cpu_stat[target_idx][stat_idx];
+		psci_stat_pd_read(&psci_cpu_stat[target_idx], stats);
+	}
+
+	*psci_stat = stats[stat_idx];
+
+	return PSCI_E_SUCCESS;
+}
+
+/*******************************************************************************
+ * This function returns a snapshot of the stats of all the local states of a
+ * power domain, so that they can be exported in bulk. The CPU power domains
+ * are numbered from 0 to PLATFORM_CORE_COUNT - 1, in the order of their core
+ * positions, and are followed by the non CPU power domains. `stats` must hold
+ * PLAT_MAX_PWR_LVL_STATES entries, and the power level of the domain is
+ * returned in `pwr_lvl`.
+ ******************************************************************************/
+int psci_stat_get_pwr_domain(unsigned int pd_idx, unsigned int *pwr_lvl,
+			     psci_stat_t *stats)
+{
+	unsigned int idx;
+
+	assert((pwr_lvl != NULL) && (stats != NULL));
+
+	if (pd_idx >= (unsigned int) PSCI_NUM_PWR_DOMAINS)
+		return PSCI_E_INVALID_PARAMS;
+
+	if (pd_idx < (unsigned int) PLATFORM_CORE_COUNT) {
+		idx = SPECULATION_SAFE_VALUE(pd_idx);
+		*pwr_lvl = PSCI_CPU_PWR_LVL;
+		psci_stat_pd_read(&psci_cpu_stat[idx], stats);
+	} else {
+		idx = SPECULATION_SAFE_VALUE(pd_idx) -
+			(unsigned int) PLATFORM_CORE_COUNT;
+		*pwr_lvl = psci_non_cpu_pd_nodes[idx].level;
+		psci_stat_pd_read(&psci_non_cpu_stat[idx], stats);
 	}
 
 	return PSCI_E_SUCCESS;
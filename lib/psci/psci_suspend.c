@@ -28,6 +28,14 @@ static void psci_suspend_to_standby_finisher(int cpu_idx,
 {
 	psci_power_state_t state_info;
 
+#if PSCI_LOCKLESS_RESUME
+	/*
+	 * If the power domains above this CPU are still running, only the CPU
+	 * power level has to be resumed, which needs no lock.
+	 */
+	end_pwrlvl = psci_get_lockless_resume_pwrlvl(end_pwrlvl);
+#endif
+
 	psci_acquire_pwr_domain_locks(end_pwrlvl,
 				cpu_idx);
 
@@ -145,14 +153,19 @@ static void psci_suspend_to_pwrdown_start(unsigned int end_pwrlvl,
  *
  * All the required parameter checks are performed at the beginning and after
  * the state transition has been done, no further error is expected and it is
- * not possible to undo any of the actions taken beyond that point.
+ * not possible to undo any of the actions taken beyond that point. The only
+ * exception is the OS-initiated mode, where the requested states are checked
+ * against the other CPUs once the locks are taken, and the request is rejected
+ * with an error code if they don't match.
  ******************************************************************************/
-void psci_cpu_suspend_start(const entry_point_info_t *ep,
-			    unsigned int end_pwrlvl,
-			    psci_power_state_t *state_info,
-			    unsigned int is_power_down_state)
+int psci_cpu_suspend_start(const entry_point_info_t *ep,
+			   unsigned int end_pwrlvl,
+			   psci_power_state_t *state_info,
+			   unsigned int is_power_down_state)
 {
+	int rc = PSCI_E_SUCCESS;
 	int skip_wfi = 0;
+	int locked = 1;
 	int idx = (int) plat_my_core_pos();
 
 	/*
@@ -162,13 +175,27 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 	assert((psci_plat_pm_ops->pwr_domain_suspend != NULL) &&
 	       (psci_plat_pm_ops->pwr_domain_suspend_finish != NULL));
 
+#if PSCI_LOCKLESS_SUSPEND
+	/*
+	 * If another CPU of the cluster is running, only this CPU is suspended
+	 * and the power domain locks are not needed.
+	 */
+	if ((end_pwrlvl > PSCI_CPU_PWR_LVL) &&
+#if PSCI_OS_INIT_MODE
+	    (psci_suspend_mode == PLAT_COORD) &&
+#endif
+	    (psci_do_state_coordination_lockless(end_pwrlvl, state_info) != 0))
+		locked = 0;
+#endif
+
 	/*
 	 * This function acquires the lock corresponding to each power
 	 * level so that by the time all locks are taken, the system topology
 	 * is snapshot and state management can be done safely.
 	 */
-	psci_acquire_pwr_domain_locks(end_pwrlvl,
-				      idx);
+	if (locked != 0)
+		psci_acquire_pwr_domain_locks(end_pwrlvl,
+					      idx);
 
 	/*
 	 * We check if there are any pending interrupts after the delay
@@ -180,12 +207,29 @@ void psci_cpu_suspend_start(const entry_point_info_t *ep,
 		goto exit;
 	}
 
-	/*
-	 * This function is passed the requested state info and
-	 * it returns the negotiated state info for each power level upto
-	 * the end level specified.
-	 */
-	psci_do_state_coordination(end_pwrlvl, state_info);
+#if PSCI_OS_INIT_MODE
+	if (psci_suspend_mode == OS_INIT) {
+		/*
+		 * The OS has coordinated the states itself, only check that
+		 * they are consistent with the other CPUs.
+		 */
+		rc = psci_validate_state_coordination(end_pwrlvl, state_info);
+		if (rc != PSCI_E_SUCCESS) {
+			skip_wfi = 1;
+			goto exit;
+		}
+	} else {
+#endif
+		/*
+		 * This function is passed the requested state info and
+		 * it returns the negotiated state info for each power level
+		 * upto the end level specified.
+		 */
+		if (locked != 0)
+			psci_do_state_coordination(end_pwrlvl, state_info);
+#if PSCI_OS_INIT_MODE
+	}
+#endif
 
 #if ENABLE_PSCI_STAT
 	/* Update the last cpu for each level till end_pwrlvl */
@@ -212,10 +256,11 @@ exit:
 	 * Release the locks corresponding to each power level in the
 	 * reverse order to which they were acquired.
 	 */
-	psci_release_pwr_domain_locks(end_pwrlvl,
-				  idx);
+	if (locked != 0)
+		psci_release_pwr_domain_locks(end_pwrlvl,
+					  idx);
 	if (skip_wfi == 1)
-		return;
+		return rc;
 
 	if (is_power_down_state != 0U) {
 #if ENABLE_RUNTIME_INSTRUMENTATION
@@ -262,6 +307,8 @@ exit:
 	 * context retaining suspend finisher.
 	 */
 	psci_suspend_to_standby_finisher(idx, end_pwrlvl);
+
+	return PSCI_E_SUCCESS;
 }
 
 /*******************************************************************************
@@ -37,4 +37,11 @@
 26	mbedtls	mbedtls_x509_get_sig_alg
 27	mbedtls	mbedtls_md_info_from_type
 28	c	exit
-29	c	atexit
\ No newline at end of file
+29	c	atexit
+30	mbedtls	mbedtls_md_init
+31	mbedtls	mbedtls_md_free
+32	mbedtls	mbedtls_md_setup
+33	mbedtls	mbedtls_md_starts
+34	mbedtls	mbedtls_md_update
+35	mbedtls	mbedtls_md_finish
+36	mbedtls	mbedtls_md_get_type
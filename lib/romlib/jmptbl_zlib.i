@@ -0,0 +1,19 @@
+#
+# Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Functions of the zlib core appended to the jump table when ROMLIB_ZLIB=1.
+# The indexes follow the ones of jmptbl.i. The gzip wrapper of TF-A
+# (tf_gunzip.c) stays in the images as it uses their log functions.
+#
+# Format:
+# index	lib	function	[patch]
+
+37	z	inflateInit_
+38	z	inflateInit2_
+39	z	inflate
+40	z	inflateEnd
+41	z	inflateReset
+42	z	adler32
+43	z	crc32
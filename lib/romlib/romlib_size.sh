@@ -0,0 +1,87 @@
+#!/bin/sh
+# Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Report, for each image, the size of the romlib code it uses, i.e. the code it
+# would link if it wasn't built with USE_ROMLIB=1. This is the size of the
+# functions called through the wrappers, found in the link map of the image,
+# and of the romlib functions they call in turn. The functions only called
+# through pointers (e.g. the mbed TLS message digest wrappers) aren't counted,
+# so it is a lower bound.
+
+set -e
+
+romlib=romlib.elf
+
+for i
+do
+	case $i in
+	-r)
+		romlib=$2
+		shift 2
+		;;
+	--)
+		shift
+		break
+		;;
+	-*)
+		echo usage: romlib_size.sh [-r romlib.elf] map ... >&2
+		exit 1
+		;;
+	esac
+done
+
+tmp=`mktemp`
+trap "rm -f $tmp" EXIT INT QUIT
+
+# Size of the functions and calls between them in the romlib
+{
+	${CROSS_COMPILE}nm -S -t d --defined-only "$romlib" |
+	awk '$3 ~ /^[tT]$/ {print "size", $4, $2 + 0}'
+
+	${CROSS_COMPILE}objdump -d "$romlib" |
+	awk '/^[0-9a-f]+ <.*>:$/ {fn = substr($2, 2, length($2) - 3)}
+	     ($3 == "bl" || $3 == "b") && $5 ~ /^</ {
+		callee = $5
+		sub(/^</, "", callee)
+		sub(/[+>].*$/, "", callee)
+		if (callee != fn)
+			print "call", fn, callee
+	     }'
+} > $tmp
+
+printf "romlib: %d bytes\n" `wc -c < "${romlib%.elf}.bin"`
+
+for map
+do
+	sed -n 's/.*libwrappers\.a([a-z]*_\([A-Za-z0-9_]*\)\.o).*/\1/p' "$map" |
+	sort -u |
+	awk -v image=`basename "$map" .map` '
+	FNR == NR {
+		if ($1 == "size")
+			size[$2] = $3
+		else
+			calls[$2] = calls[$2] " " $3
+		next
+	}
+	{
+		fn[++n] = $1
+		seen[$1] = 1
+	}
+	END {
+		direct = n
+		for (i = 1; i <= n; i++) {
+			total += size[fn[i]]
+			m = split(calls[fn[i]], callee, " ")
+			for (j = 1; j <= m; j++) {
+				if (!(callee[j] in seen)) {
+					seen[callee[j]] = 1
+					fn[++n] = callee[j]
+				}
+			}
+		}
+		printf "%s: %d romlib functions called, %d bytes of code shared\n",
+		       image, direct, total
+	}' $tmp -
+done
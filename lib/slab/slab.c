@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <platform.h>
+#include <slab.h>
+
+/*
+ * Fill half of an empty magazine from the depot, or else from the pool. It
+ * must be called with the lock of the magazine held.
+ */
+static void slab_magazine_refill(slab_cache_t *cache, slab_magazine_t *mag)
+{
+	struct object_pool *pool = cache->pool;
+
+	assert(mag->num == 0U);
+
+	spin_lock(&(cache->lock));
+
+	while ((mag->num < (SLAB_MAGAZINE_SIZE / 2U)) &&
+	       (cache->depot_num > 0U)) {
+		cache->depot_num--;
+		mag->objs[mag->num] = cache->depot[cache->depot_num];
+		mag->num++;
+	}
+
+	while ((mag->num < (SLAB_MAGAZINE_SIZE / 2U)) &&
+	       (pool->used < pool->capacity)) {
+		mag->objs[mag->num] = pool_alloc(pool);
+		mag->num++;
+	}
+
+	spin_unlock(&(cache->lock));
+}
+
+/*
+ * Move half of a full magazine to the depot. It must be called with the lock
+ * of the magazine held.
+ */
+static void slab_magazine_flush(slab_cache_t *cache, slab_magazine_t *mag)
+{
+	assert(mag->num == SLAB_MAGAZINE_SIZE);
+
+	spin_lock(&(cache->lock));
+
+	while (mag->num > (SLAB_MAGAZINE_SIZE / 2U)) {
+		assert(cache->depot_num < cache->pool->capacity);
+		mag->num--;
+		cache->depot[cache->depot_num] = mag->objs[mag->num];
+		cache->depot_num++;
+	}
+
+	spin_unlock(&(cache->lock));
+}
+
+/*
+ * Allocate an object from a cache. Return its address, or NULL if all the
+ * objects of the cache are in use.
+ */
+void *slab_alloc(slab_cache_t *cache)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	slab_magazine_t *mag = &(cache->magazines[core_pos]);
+	void *obj = NULL;
+	unsigned int i;
+
+	spin_lock(&(mag->lock));
+
+	if (mag->num == 0U)
+		slab_magazine_refill(cache, mag);
+
+	if (mag->num > 0U) {
+		mag->num--;
+		obj = mag->objs[mag->num];
+	}
+
+	spin_unlock(&(mag->lock));
+
+	if (obj != NULL)
+		return obj;
+
+	/*
+	 * The only free objects left, if any, are in the magazines of other
+	 * CPUs. Only one magazine is locked at a time.
+	 */
+	for (i = 0U; (i < PLATFORM_CORE_COUNT) && (obj == NULL); i++) {
+		if (i == core_pos)
+			continue;
+
+		mag = &(cache->magazines[i]);
+
+		spin_lock(&(mag->lock));
+
+		if (mag->num > 0U) {
+			mag->num--;
+			obj = mag->objs[mag->num];
+		}
+
+		spin_unlock(&(mag->lock));
+	}
+
+	return obj;
+}
+
+/* Give back an object allocated with slab_alloc() to its cache */
+void slab_free(slab_cache_t *cache, void *obj)
+{
+	slab_magazine_t *mag = &(cache->magazines[plat_my_core_pos()]);
+
+	assert(obj != NULL);
+
+	spin_lock(&(mag->lock));
+
+	if (mag->num == SLAB_MAGAZINE_SIZE)
+		slab_magazine_flush(cache, mag);
+
+	mag->objs[mag->num] = obj;
+	mag->num++;
+
+	spin_unlock(&(mag->lock));
+}
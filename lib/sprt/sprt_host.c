@@ -32,9 +32,7 @@ void sprt_initialize_queues(void *buffer_base, size_t buffer_size)
 	sprt_queue_init(non_blocking_base, non_blocking_num, SPRT_QUEUE_ENTRY_MSG_SIZE);
 }
 
-int sprt_push_message(void *buffer_base,
-		      const struct sprt_queue_entry_message *message,
-		      int queue_num)
+static struct sprt_queue *sprt_get_queue(void *buffer_base, int queue_num)
 {
 	struct sprt_queue *q = buffer_base;
 
@@ -44,5 +42,20 @@ int sprt_push_message(void *buffer_base,
 		q = (struct sprt_queue *) next_addr;
 	}
 
-	return sprt_queue_push(q, message);
+	return q;
+}
+
+int sprt_push_message(void *buffer_base,
+		      const struct sprt_queue_entry_message *message,
+		      int queue_num)
+{
+	return sprt_queue_push(sprt_get_queue(buffer_base, queue_num), message);
+}
+
+uint32_t sprt_push_messages(void *buffer_base,
+			    const struct sprt_queue_entry_message *messages,
+			    uint32_t num, int queue_num)
+{
+	return sprt_queue_push_batch(sprt_get_queue(buffer_base, queue_num),
+				     messages, num);
 }
@@ -6,11 +6,53 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
 #include "sprt_queue.h"
 
+/*
+ * Each queue has a single producer, that only writes idx_write, and a single
+ * consumer, that only writes idx_read. An entry is written before idx_write is
+ * moved past it and read before idx_read is moved past it, so each side only
+ * needs to load the index of the other side with acquire semantics and to
+ * store its own index with release semantics. Several producers (or consumers)
+ * of the same queue must serialise with each other.
+ *
+ * The queue is in a structure shared with the Secure Partition, so the
+ * indices are accessed through pointers to aligned 32-bit words in order to
+ * avoid the byte accesses that the packed attribute of the structure allows.
+ */
+#define SPRT_QUEUE_IDX(queue, field)					\
+	((volatile uint32_t *)((uintptr_t)(queue) +			\
+			       offsetof(struct sprt_queue, field)))
+
+static uint32_t sprt_queue_load_acquire(volatile uint32_t *idx)
+{
+	uint32_t val = *idx;
+
+	__asm__ volatile("dmb ishld" ::: "memory");
+
+	return val;
+}
+
+static void sprt_queue_store_release(volatile uint32_t *idx, uint32_t val)
+{
+	__asm__ volatile("dmb ish" ::: "memory");
+
+	*idx = val;
+}
+
+static uint32_t sprt_queue_next_idx(const struct sprt_queue *queue,
+				    uint32_t idx)
+{
+	/* Avoid the division, entry_num isn't a power of two in general */
+	idx++;
+
+	return (idx == queue->entry_num) ? 0U : idx;
+}
+
 void sprt_queue_init(void *queue_base, uint32_t entry_num, uint32_t entry_size)
 {
 	assert(queue_base != NULL);
@@ -24,16 +66,18 @@ void sprt_queue_init(void *queue_base, uint32_t entry_num, uint32_t entry_size)
 	queue->idx_write = 0U;
 	queue->idx_read = 0U;
 
-	memset(queue->data, 0, entry_num * entry_size);
+	/*
+	 * The data isn't cleared, entries are always written before they are
+	 * made visible to the consumer.
+	 */
 }
 
 int sprt_queue_is_empty(void *queue_base)
 {
 	assert(queue_base != NULL);
 
-	struct sprt_queue *queue = (struct sprt_queue *)queue_base;
-
-	return (queue->idx_write == queue->idx_read);
+	return (*SPRT_QUEUE_IDX(queue_base, idx_write) ==
+		*SPRT_QUEUE_IDX(queue_base, idx_read));
 }
 
 int sprt_queue_is_full(void *queue_base)
@@ -42,63 +86,103 @@ int sprt_queue_is_full(void *queue_base)
 
 	struct sprt_queue *queue = (struct sprt_queue *)queue_base;
 
-	uint32_t idx_next_write = (queue->idx_write + 1) % queue->entry_num;
+	uint32_t idx_next_write = sprt_queue_next_idx(queue,
+				*SPRT_QUEUE_IDX(queue_base, idx_write));
 
-	return (idx_next_write == queue->idx_read);
+	return (idx_next_write == *SPRT_QUEUE_IDX(queue_base, idx_read));
 }
 
-int sprt_queue_push(void *queue_base, const void *entry)
+uint32_t sprt_queue_push_batch(void *queue_base, const void *entries,
+			       uint32_t num)
 {
-	assert(entry != NULL);
+	assert(entries != NULL);
 	assert(queue_base != NULL);
 
-	if (sprt_queue_is_full(queue_base) != 0) {
-		return -ENOMEM;
-	}
-
 	struct sprt_queue *queue = (struct sprt_queue *)queue_base;
+	const uint8_t *src_entry = entries;
+	uint32_t idx_write = *SPRT_QUEUE_IDX(queue_base, idx_write);
+	uint32_t idx_read =
+		sprt_queue_load_acquire(SPRT_QUEUE_IDX(queue_base, idx_read));
+	uint32_t count;
+
+	for (count = 0U; count < num; count++) {
+		uint32_t idx_next_write = sprt_queue_next_idx(queue, idx_write);
+
+		if (idx_next_write == idx_read) {
+			break;
+		}
 
-	uint8_t *dst_entry = &queue->data[queue->entry_size * queue->idx_write];
+		memcpy(&queue->data[queue->entry_size * idx_write], src_entry,
+		       queue->entry_size);
 
-	memcpy(dst_entry, entry, queue->entry_size);
+		src_entry += queue->entry_size;
+		idx_write = idx_next_write;
+	}
 
 	/*
 	 * Make sure that the message data is visible before increasing the
-	 * counter of available messages.
+	 * counter of available messages. All the messages are published at
+	 * once.
 	 */
-	__asm__ volatile("dmb st" ::: "memory");
-
-	queue->idx_write = (queue->idx_write + 1) % queue->entry_num;
-
-	__asm__ volatile("dmb st" ::: "memory");
+	if (count > 0U) {
+		sprt_queue_store_release(SPRT_QUEUE_IDX(queue_base, idx_write),
+					 idx_write);
+	}
 
-	return 0;
+	return count;
 }
 
-int sprt_queue_pop(void *queue_base, void *entry)
+uint32_t sprt_queue_pop_batch(void *queue_base, void *entries, uint32_t num)
 {
-	assert(entry != NULL);
+	assert(entries != NULL);
 	assert(queue_base != NULL);
 
-	if (sprt_queue_is_empty(queue_base) != 0) {
-		return -ENOENT;
-	}
-
 	struct sprt_queue *queue = (struct sprt_queue *)queue_base;
-
-	uint8_t *src_entry = &queue->data[queue->entry_size * queue->idx_read];
-
-	memcpy(entry, src_entry, queue->entry_size);
+	uint8_t *dst_entry = entries;
+	uint32_t idx_read = *SPRT_QUEUE_IDX(queue_base, idx_read);
+	uint32_t idx_write =
+		sprt_queue_load_acquire(SPRT_QUEUE_IDX(queue_base, idx_write));
+	uint32_t count;
+
+	for (count = 0U; count < num; count++) {
+		if (idx_read == idx_write) {
+			break;
+		}
+
+		memcpy(dst_entry, &queue->data[queue->entry_size * idx_read],
+		       queue->entry_size);
+
+		dst_entry += queue->entry_size;
+		idx_read = sprt_queue_next_idx(queue, idx_read);
+	}
 
 	/*
-	 * Make sure that the message data is visible before increasing the
-	 * counter of read messages.
+	 * Make sure that the message data has been read before increasing the
+	 * counter of read messages, so that the entries aren't overwritten
+	 * while they are being read.
 	 */
-	__asm__ volatile("dmb st" ::: "memory");
+	if (count > 0U) {
+		sprt_queue_store_release(SPRT_QUEUE_IDX(queue_base, idx_read),
+					 idx_read);
+	}
 
-	queue->idx_read = (queue->idx_read + 1) % queue->entry_num;
+	return count;
+}
 
-	__asm__ volatile("dmb st" ::: "memory");
+int sprt_queue_push(void *queue_base, const void *entry)
+{
+	if (sprt_queue_push_batch(queue_base, entry, 1U) == 0U) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int sprt_queue_pop(void *queue_base, void *entry)
+{
+	if (sprt_queue_pop_batch(queue_base, entry, 1U) == 0U) {
+		return -ENOENT;
+	}
 
 	return 0;
 }
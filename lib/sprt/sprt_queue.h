@@ -9,7 +9,11 @@
 
 #include <stdint.h>
 
-/* Struct that defines a queue. Not to be used directly. */
+/*
+ * Struct that defines a queue. Not to be used directly. A queue can only be
+ * used by one producer and one consumer at a time, or the producers (or the
+ * consumers) must serialise with each other.
+ */
 struct __attribute__((__packed__)) sprt_queue {
 	uint32_t entry_num;	/* Number of entries */
 	uint32_t entry_size;	/* Size of an entry */
@@ -32,6 +36,20 @@ int sprt_queue_is_empty(void *queue_base);
 /* Returns 1 if the queue is full, 0 otherwise */
 int sprt_queue_is_full(void *queue_base);
 
+/*
+ * Pushes up to `num` entries into the queue, in order, and makes them visible
+ * to the consumer at once. Returns the number of entries pushed, which is less
+ * than `num` if the queue is full.
+ */
+uint32_t sprt_queue_push_batch(void *queue_base, const void *entries,
+			       uint32_t num);
+
+/*
+ * Pops up to `num` entries from the queue, in order. Returns the number of
+ * entries popped, which is less than `num` if the queue is empty.
+ */
+uint32_t sprt_queue_pop_batch(void *queue_base, void *entries, uint32_t num);
+
 /*
  * Pushes a new entry intro the queue. Returns 0 on success, -ENOMEM if the
  * queue is full.
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <dcache_batch.h>
+#include <utils_def.h>
+
+/*
+ * Initialise an empty batch of operations `op`. The size of the smallest data
+ * cache line is read from CTR once for the whole batch.
+ */
+void dcache_batch_init(dcache_batch_t *batch, unsigned int op)
+{
+	unsigned int dminline;
+
+	assert(batch != NULL);
+	assert((op == DCACHE_BATCH_FLUSH) || (op == DCACHE_BATCH_CLEAN));
+
+	dminline = (unsigned int)(read_ctr_el0() >> CTR_DMINLINE_SHIFT) &
+		   CTR_DMINLINE_MASK;
+
+	batch->op = op;
+	batch->line_size = 4U << dminline;
+	batch->count = 0U;
+	batch->issued = 0U;
+}
+
+/* Issue the operations of the ranges of the batch, without a barrier */
+static void dcache_batch_issue(dcache_batch_t *batch)
+{
+	unsigned int i;
+	uintptr_t addr;
+
+	for (i = 0U; i < batch->count; i++) {
+		for (addr = batch->ranges[i].base; addr < batch->ranges[i].end;
+		     addr += batch->line_size) {
+			if (batch->op == DCACHE_BATCH_FLUSH)
+				dccivac(addr);
+			else
+				dccvac(addr);
+		}
+	}
+
+	batch->issued += batch->count;
+	batch->count = 0U;
+}
+
+void dcache_batch_add(dcache_batch_t *batch, uintptr_t addr, size_t size)
+{
+	uintptr_t base, end;
+	unsigned int i = 0U;
+
+	assert(batch != NULL);
+
+	if (size == 0U)
+		return;
+
+	base = round_down(addr, (uintptr_t)batch->line_size);
+	end = round_up(addr + size, (uintptr_t)batch->line_size);
+
+	/*
+	 * Merge the range with the ones it overlaps or touches. The merged
+	 * range replaces them and is compared with all the others again, as
+	 * it may now touch ranges it didn't.
+	 */
+	while (i < batch->count) {
+		if ((base <= batch->ranges[i].end) &&
+		    (end >= batch->ranges[i].base)) {
+			base = MIN(base, batch->ranges[i].base);
+			end = MAX(end, batch->ranges[i].end);
+			batch->count--;
+			batch->ranges[i] = batch->ranges[batch->count];
+			i = 0U;
+		} else {
+			i++;
+		}
+	}
+
+	if (batch->count == DCACHE_BATCH_MAX_RANGES)
+		dcache_batch_issue(batch);
+
+	batch->ranges[batch->count].base = base;
+	batch->ranges[batch->count].end = end;
+	batch->count++;
+}
+
+/*
+ * Issue the remaining operations of the batch and wait for all of them to
+ * complete. Nothing is done for a batch without ranges.
+ */
+void dcache_batch_finish(dcache_batch_t *batch)
+{
+	assert(batch != NULL);
+
+	dcache_batch_issue(batch);
+	if (batch->issued != 0U)
+		dsbsy();
+	batch->issued = 0U;
+}
@@ -15,6 +15,10 @@
 #error xlat tables v2 must be used with HW_ASSISTED_COHERENCY
 #endif
 
+#if PAGE_SIZE != PAGE_SIZE_4KB
+#error xlat tables v2 must be used with a translation granule other than 4KB
+#endif
+
 CASSERT(CHECK_VIRT_ADDR_SPACE_SIZE(PLAT_VIRT_ADDR_SPACE_SIZE),
 	assert_valid_virt_addr_space_size);
 
@@ -90,6 +90,48 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+/*
+ * Maximum number of pages invalidated one at a time by
+ * xlat_arch_tlbi_va_range(). Above it, all the TLB entries of the translation
+ * regime are invalidated instead.
+ */
+#define XLAT_TLBI_MAX_PAGES	XLAT_TABLE_ENTRIES
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	unsigned long long pages;
+
+	pages = (round_up((unsigned long long)va + size, PAGE_SIZE) -
+		 round_down((unsigned long long)va, PAGE_SIZE)) / PAGE_SIZE;
+	va = round_down(va, PAGE_SIZE);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if (pages > XLAT_TLBI_MAX_PAGES) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbiallis();
+		} else {
+			assert(xlat_regime == EL2_REGIME);
+			tlbiallhis();
+		}
+		return;
+	}
+
+	for (; pages != 0ULL; pages--) {
+		if (xlat_regime == EL1_EL0_REGIME) {
+			tlbimvaais(TLBI_ADDR(va));
+		} else {
+			assert(xlat_regime == EL2_REGIME);
+			tlbimvahis(TLBI_ADDR(va));
+		}
+		va += PAGE_SIZE;
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/* Invalidate all entries from branch predictors. */
@@ -139,14 +139,29 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
 	}
 }
 
-void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
-{
-	/*
-	 * Ensure the translation table write has drained into memory before
-	 * invalidating the TLB entry.
-	 */
-	dsbishst();
+/*
+ * Maximum number of pages invalidated one at a time by
+ * xlat_arch_tlbi_va_range() when the TLB range invalidation instructions are
+ * not implemented. Above it, all the TLB entries of the translation regime are
+ * invalidated instead: it is cheaper than hundreds of broadcast invalidations,
+ * and the TLBs are refilled on demand.
+ */
+#define XLAT_TLBI_MAX_PAGES	U(512)
+
+/* Translation granule fields of the TCR and of the TLB range operands */
+#if PAGE_SIZE == PAGE_SIZE_4KB
+#define XLAT_TCR_TG0		TCR_TG0_4K
+#define XLAT_TLBI_RANGE_TG	TLBI_RANGE_TG_4KB
+#elif PAGE_SIZE == PAGE_SIZE_16KB
+#define XLAT_TCR_TG0		TCR_TG0_16K
+#define XLAT_TLBI_RANGE_TG	TLBI_RANGE_TG_16KB
+#else
+#define XLAT_TCR_TG0		TCR_TG0_64K
+#define XLAT_TLBI_RANGE_TG	TLBI_RANGE_TG_64KB
+#endif
 
+static void xlat_arch_tlbi_page(uintptr_t va, int xlat_regime)
+{
 	/*
 	 * This function only supports invalidation of TLB entries for the EL3
 	 * and EL1&0 translation regimes.
@@ -167,6 +182,114 @@ void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
 	}
 }
 
+static void xlat_arch_tlbi_all(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		assert(xlat_arch_current_el() >= 1U);
+		tlbivmalle1is();
+	} else if (xlat_regime == EL2_REGIME) {
+		assert(xlat_arch_current_el() >= 2U);
+		tlbialle2is();
+	} else {
+		assert(xlat_regime == EL3_REGIME);
+		assert(xlat_arch_current_el() >= 3U);
+		tlbialle3is();
+	}
+}
+
+static bool xlat_arch_is_tlbi_range_supported(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_TLB_SHIFT) &
+		ID_AA64ISAR0_TLB_MASK) >= ID_AA64ISAR0_TLB_RANGE;
+}
+
+/*
+ * Invalidate `pages` pages starting at `va` with TLB range invalidations. Each
+ * SCALE covers 5 bits of the page count, from bit 1 upwards, so there is at
+ * most one invalidation per SCALE, plus one by VA for an odd page count.
+ */
+static void xlat_arch_tlbi_range(uintptr_t va, unsigned long long pages,
+				 int xlat_regime)
+{
+	unsigned long long num, op;
+	unsigned int scale = 0U;
+
+	assert(pages < TLBI_RANGE_MAX_PAGES);
+
+	if ((pages % 2ULL) != 0ULL) {
+		xlat_arch_tlbi_page(va, xlat_regime);
+		va += PAGE_SIZE;
+		pages--;
+	}
+
+	while (pages != 0ULL) {
+		assert(scale <= TLBI_RANGE_SCALE_MAX);
+
+		num = (pages >> TLBI_RANGE_PAGES_SHIFT(scale)) &
+			TLBI_RANGE_NUM_MASK;
+		if (num != 0ULL) {
+			op = TLBI_RANGE(XLAT_TLBI_RANGE_TG, va, num - 1ULL,
+					scale);
+
+			if (xlat_regime == EL1_EL0_REGIME) {
+				assert(xlat_arch_current_el() >= 1U);
+				tlbirvaae1is(op);
+			} else if (xlat_regime == EL2_REGIME) {
+				assert(xlat_arch_current_el() >= 2U);
+				tlbirvae2is(op);
+			} else {
+				assert(xlat_regime == EL3_REGIME);
+				assert(xlat_arch_current_el() >= 3U);
+				tlbirvae3is(op);
+			}
+
+			num <<= TLBI_RANGE_PAGES_SHIFT(scale);
+			va += (uintptr_t)(num * PAGE_SIZE);
+			pages -= num;
+		}
+
+		scale++;
+	}
+}
+
+void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime)
+{
+	/*
+	 * Ensure the translation table write has drained into memory before
+	 * invalidating the TLB entry.
+	 */
+	dsbishst();
+
+	xlat_arch_tlbi_page(va, xlat_regime);
+}
+
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime)
+{
+	unsigned long long pages;
+
+	pages = (round_up((unsigned long long)va + size, PAGE_SIZE) -
+		 round_down((unsigned long long)va, PAGE_SIZE)) / PAGE_SIZE;
+	va = round_down(va, PAGE_SIZE);
+
+	/*
+	 * Ensure the translation table writes have drained into memory before
+	 * invalidating the TLB entries.
+	 */
+	dsbishst();
+
+	if ((pages < TLBI_RANGE_MAX_PAGES) &&
+	    xlat_arch_is_tlbi_range_supported()) {
+		xlat_arch_tlbi_range(va, pages, xlat_regime);
+	} else if (pages > XLAT_TLBI_MAX_PAGES) {
+		xlat_arch_tlbi_all(xlat_regime);
+	} else {
+		for (; pages != 0ULL; pages--) {
+			xlat_arch_tlbi_page(va, xlat_regime);
+			va += PAGE_SIZE;
+		}
+	}
+}
+
 void xlat_arch_tlbi_va_sync(void)
 {
 	/*
@@ -206,6 +329,9 @@ void setup_mmu_cfg(uint64_t *params, unsigned int flags,
 	uint64_t mair, ttbr0, tcr;
 	uintptr_t virtual_addr_space_size;
 
+	/* The tables have been built for the granule selected at build time. */
+	assert(xlat_arch_is_granule_size_supported(PAGE_SIZE));
+
 	/* Set attributes in the right indices of the MAIR. */
 	mair = MAIR_ATTR_SET(ATTR_DEVICE, ATTR_DEVICE_INDEX);
 	mair |= MAIR_ATTR_SET(ATTR_IWBWA_OWBWA_NTR, ATTR_IWBWA_OWBWA_NTR_INDEX);
@@ -226,7 +352,7 @@ void setup_mmu_cfg(uint64_t *params, unsigned int flags,
 	 */
 	int t0sz = 64 - __builtin_ctzll(virtual_addr_space_size);
 
-	tcr = (uint64_t) t0sz;
+	tcr = (uint64_t) t0sz | XLAT_TCR_TG0;
 
 	/*
 	 * Set the cacheability and shareability attributes for memory
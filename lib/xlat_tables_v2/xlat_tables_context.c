@@ -25,6 +25,14 @@ uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 REGISTER_XLAT_CONTEXT(tf, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
 		PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
 
+#if PREBUILT_XLAT_TABLES
+/*
+ * Only defined if translation tables have been generated for the BL image, see
+ * the BLx_XLAT_MMAP platform makefile variables.
+ */
+#pragma weak xlat_prebuilt_tables
+#endif
+
 void mmap_add_region(unsigned long long base_pa, uintptr_t base_va, size_t size,
 		     unsigned int attr)
 {
@@ -104,6 +112,13 @@ void __init init_xlat_tables(void)
 		tf_xlat_ctx.xlat_regime = EL3_REGIME;
 	}
 
+#if PREBUILT_XLAT_TABLES
+	if (&xlat_prebuilt_tables != NULL) {
+		init_xlat_tables_prebuilt_ctx(&tf_xlat_ctx,
+					      &xlat_prebuilt_tables);
+		return;
+	}
+#endif
 	init_xlat_tables_ctx(&tf_xlat_ctx);
 }
 
@@ -112,11 +127,22 @@ int xlat_get_mem_attributes(uintptr_t base_va, uint32_t *attr)
 	return xlat_get_mem_attributes_ctx(&tf_xlat_ctx, base_va, attr);
 }
 
+void xlat_get_tables_usage(int *used, int *max_used, int *total)
+{
+	xlat_get_tables_usage_ctx(&tf_xlat_ctx, used, max_used, total);
+}
+
 int xlat_change_mem_attributes(uintptr_t base_va, size_t size, uint32_t attr)
 {
 	return xlat_change_mem_attributes_ctx(&tf_xlat_ctx, base_va, size, attr);
 }
 
+int xlat_change_mem_attributes_batch(const xlat_attr_change_t *changes,
+				     unsigned int count)
+{
+	return xlat_change_mem_attributes_batch_ctx(&tf_xlat_ctx, changes, count);
+}
+
 /*
  * If dynamic allocation of new regions is disabled then by the time we call the
  * function enabling the MMU, we'll have registered all the memory regions to
@@ -25,6 +25,26 @@ static inline void xlat_clean_dcache_range(uintptr_t addr, size_t size)
 		clean_dcache_range(addr, size);
 }
 
+/*
+ * Counts a table that is about to be used, and updates the highest number of
+ * tables used at the same time. This is the number of tables that the context
+ * needs, so it is printed when it increases after the initialization of the
+ * tables, when dynamic regions are mapped.
+ */
+static void xlat_table_count_used(xlat_ctx_t *ctx)
+{
+	ctx->used_tables++;
+
+	if (ctx->used_tables > ctx->max_used_tables) {
+		ctx->max_used_tables = ctx->used_tables;
+
+		if (ctx->initialized) {
+			VERBOSE("Translation tables: %d sub-tables used out of %d\n",
+				ctx->max_used_tables, ctx->tables_num);
+		}
+	}
+}
+
 #if PLAT_XLAT_TABLES_DYNAMIC
 
 /*
@@ -35,31 +55,49 @@ static inline void xlat_clean_dcache_range(uintptr_t addr, size_t size)
 
 /*
  * Returns the index of the array corresponding to the specified translation
- * table.
+ * table. The tables are contiguous, so it is computed from the address.
  */
 static int xlat_table_get_index(const xlat_ctx_t *ctx, const uint64_t *table)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables[i] == table)
-			return i;
+	uintptr_t offset = (uintptr_t)table - (uintptr_t)ctx->tables;
 
 	/*
 	 * Maybe we were asked to get the index of the base level table, which
 	 * should never happen.
 	 */
-	assert(false);
+	assert((uintptr_t)table >= (uintptr_t)ctx->tables);
+	assert((offset % XLAT_TABLE_SIZE) == 0U);
+	assert((offset / XLAT_TABLE_SIZE) < (uintptr_t)ctx->tables_num);
+
+	return (int)(offset / XLAT_TABLE_SIZE);
+}
 
-	return -1;
+/* Adds a table that has no region mapped in it to the list of empty tables. */
+static void xlat_table_add_empty(xlat_ctx_t *ctx, int idx)
+{
+	ctx->tables_next_free[idx] = ctx->tables_free_head;
+	ctx->tables_free_head = idx;
+	ctx->used_tables--;
 }
 
-/* Returns a pointer to an empty translation table. */
-static uint64_t *xlat_table_get_empty(const xlat_ctx_t *ctx)
+/*
+ * Returns a pointer to an empty translation table, and removes it from the
+ * list of empty tables.
+ */
+static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables_mapped_regions[i] == 0)
-			return ctx->tables[i];
+	int idx = ctx->tables_free_head;
 
-	return NULL;
+	if (idx < 0)
+		return NULL;
+
+	assert(ctx->tables_mapped_regions[idx] == 0);
+
+	ctx->tables_free_head = ctx->tables_next_free[idx];
+
+	xlat_table_count_used(ctx);
+
+	return ctx->tables[idx];
 }
 
 /* Increments region count for a given table. */
@@ -71,13 +109,22 @@ static void xlat_table_inc_regions_count(const xlat_ctx_t *ctx,
 	ctx->tables_mapped_regions[idx]++;
 }
 
-/* Decrements region count for a given table. */
-static void xlat_table_dec_regions_count(const xlat_ctx_t *ctx,
+/*
+ * Decrements region count for a given table. If no region is left, the table
+ * is added to the list of empty tables. The caller removes the reference to the
+ * table before it can be reused.
+ */
+static void xlat_table_dec_regions_count(xlat_ctx_t *ctx,
 					 const uint64_t *table)
 {
 	int idx = xlat_table_get_index(ctx, table);
 
+	assert(ctx->tables_mapped_regions[idx] > 0);
+
 	ctx->tables_mapped_regions[idx]--;
+
+	if (ctx->tables_mapped_regions[idx] == 0)
+		xlat_table_add_empty(ctx, idx);
 }
 
 /* Returns 0 if the specified table isn't empty, otherwise 1. */
@@ -91,7 +138,10 @@ static bool xlat_table_is_empty(const xlat_ctx_t *ctx, const uint64_t *table)
 /* Returns a pointer to the first empty translation table. */
 static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	assert(ctx->next_table < ctx->tables_num);
+	if (ctx->next_table >= ctx->tables_num)
+		return NULL;
+
+	xlat_table_count_used(ctx);
 
 	return ctx->tables[ctx->next_table++];
 }
@@ -141,6 +191,10 @@ uint64_t xlat_desc(const xlat_ctx_t *ctx, uint32_t attr,
 			/* EL1 mapping requested, no User access granted */
 			desc |= LOWER_ATTRS(AP_NO_ACCESS_UNPRIVILEGED);
 		}
+
+		/* Only let the TLBs use the mapping with the ASID of the tables */
+		if (ctx->asid != 0U)
+			desc |= LOWER_ATTRS(NON_GLOBAL);
 	} else {
 		assert((ctx->xlat_regime == EL2_REGIME) ||
 		       (ctx->xlat_regime == EL3_REGIME));
@@ -233,7 +287,9 @@ typedef enum {
 
 /*
  * Recursive function that writes to the translation tables and unmaps the
- * specified region.
+ * specified region. The TLB entries of the region are not invalidated, the
+ * caller must do it with xlat_arch_tlbi_va_range() once the tables have been
+ * written.
  */
 static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 				     const uintptr_t table_base_va,
@@ -327,7 +383,6 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
 			table_base[table_idx] = INVALID_DESC;
-			xlat_arch_tlbi_va(table_idx_va, ctx->xlat_regime);
 
 		} else if (action == ACTION_RECURSE_INTO_TABLE) {
 
@@ -344,11 +399,8 @@ static void xlat_tables_unmap_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 			/*
 			 * If the subtable is now empty, remove its reference.
 			 */
-			if (xlat_table_is_empty(ctx, subtable)) {
+			if (xlat_table_is_empty(ctx, subtable))
 				table_base[table_idx] = INVALID_DESC;
-				xlat_arch_tlbi_va(table_idx_va,
-						  ctx->xlat_regime);
-			}
 
 		} else {
 			assert(action == ACTION_NONE);
@@ -499,6 +551,45 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+/*
+ * Returns true if the entries of a table from `table_idx` to the end of their
+ * group of XLAT_CONT_ENTRIES(level) entries can be written with the Contiguous
+ * hint. The whole group must be mapped by the region, to a physically
+ * contiguous and suitably aligned range, and all of its entries must be invalid
+ * so that they are all written now and a valid entry never changes its hint.
+ * The region granularity must also allow coarser mappings than this level, as
+ * a region with the granularity of this level is expected to be remapped
+ * piecewise.
+ */
+static bool xlat_tables_cont_hint_allowed(const mmap_region_t *mm,
+		const uint64_t *table_base, unsigned int table_idx,
+		unsigned int table_entries, uintptr_t table_idx_va,
+		unsigned long long table_idx_pa, unsigned int level)
+{
+	if ((level < MIN_LVL_BLOCK_DESC) ||
+	    (mm->granularity <= XLAT_BLOCK_SIZE(level)))
+		return false;
+
+	if (((table_idx % XLAT_CONT_ENTRIES(level)) != 0U) ||
+	    ((table_idx + XLAT_CONT_ENTRIES(level)) > table_entries))
+		return false;
+
+	if ((table_idx_va < mm->base_va) ||
+	    ((table_idx_va - mm->base_va + XLAT_CONT_SIZE(level)) >
+	     (unsigned long long)mm->size))
+		return false;
+
+	if ((table_idx_pa & (XLAT_CONT_SIZE(level) - 1ULL)) != 0ULL)
+		return false;
+
+	for (unsigned int i = 0U; i < XLAT_CONT_ENTRIES(level); i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC)
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -520,6 +611,8 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 	uint64_t *subtable;
 	uint64_t desc;
+	/* Contiguous hint of the entries of the current group */
+	uint64_t cont_hint = 0ULL;
 
 	unsigned int table_idx;
 
@@ -548,6 +641,13 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		table_idx_pa = mm->base_pa + table_idx_va - mm->base_va;
 
+		if ((table_idx % XLAT_CONT_ENTRIES(level)) == 0U) {
+			cont_hint = xlat_tables_cont_hint_allowed(mm,
+					table_base, table_idx, table_entries,
+					table_idx_va, table_idx_pa, level) ?
+				UPPER_ATTRS(CONT_HINT) : 0ULL;
+		}
+
 		action_t action = xlat_tables_map_region_action(mm,
 			(uint32_t)(desc & DESC_MASK), table_idx_pa,
 			table_idx_va, level);
@@ -556,7 +656,7 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 			table_base[table_idx] =
 				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+					  level) | cont_hint;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -985,6 +1085,10 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 				ctx->base_table_entries * sizeof(uint64_t));
 #endif
+			xlat_arch_tlbi_va_range(unmap_mm.base_va, unmap_mm.size,
+						ctx->xlat_regime);
+			xlat_arch_tlbi_va_sync();
+			xlat_attr_cache_flush(ctx);
 			return -ENOMEM;
 		}
 
@@ -1071,7 +1175,15 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
 			ctx->base_table_entries * sizeof(uint64_t));
 #endif
+		/*
+		 * Invalidate the whole region at once, rather than each
+		 * descriptor as it is erased, so that large regions don't
+		 * need one broadcast TLB invalidation per page.
+		 */
+		xlat_arch_tlbi_va_range(mm->base_va, mm->size,
+					ctx->xlat_regime);
 		xlat_arch_tlbi_va_sync();
+		xlat_attr_cache_flush(ctx);
 	}
 
 	/* Remove this region by moving the rest down by one place. */
@@ -1105,7 +1217,8 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 			    uintptr_t va_max, struct mmap_region *mmap,
 			    unsigned int mmap_num, uint64_t **tables,
 			    unsigned int tables_num, uint64_t *base_table,
-			    int xlat_regime, int *mapped_regions)
+			    int xlat_regime, int *mapped_regions,
+			    int *next_free)
 {
 	ctx->xlat_regime = xlat_regime;
 
@@ -1125,14 +1238,28 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 	ctx->base_table_entries = GET_NUM_BASE_LEVEL_ENTRIES(va_space_size);
 
 	ctx->tables_mapped_regions = mapped_regions;
+	ctx->tables_next_free = next_free;
+	ctx->tables_free_head = -1;
 
 	ctx->max_pa = 0;
 	ctx->max_va = 0;
 	ctx->initialized = 0;
+	ctx->asid = 0U;
+	ctx->attr_cache = NULL;
 }
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+void xlat_set_asid_ctx(xlat_ctx_t *ctx, unsigned int asid)
+{
+	assert(ctx != NULL);
+	assert(!ctx->initialized);
+	assert(ctx->xlat_regime == EL1_EL0_REGIME);
+	assert(asid <= XLAT_ASID_MAX);
+
+	ctx->asid = asid;
+}
+
 void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 {
 	assert(ctx != NULL);
@@ -1151,9 +1278,20 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	for (unsigned int i = 0U; i < ctx->base_table_entries; i++)
 		ctx->base_table[i] = INVALID_DESC;
 
-	for (int j = 0; j < ctx->tables_num; j++) {
+#if PLAT_XLAT_TABLES_DYNAMIC
+	ctx->tables_free_head = -1;
+	/* Each table is uncounted when it is added to the list below */
+	ctx->used_tables = ctx->tables_num;
+#else
+	ctx->used_tables = 0;
+#endif
+	ctx->max_used_tables = 0;
+
+	/* The tables are added to the list of empty tables from the last one */
+	for (int j = ctx->tables_num - 1; j >= 0; j--) {
 #if PLAT_XLAT_TABLES_DYNAMIC
 		ctx->tables_mapped_regions[j] = 0;
+		xlat_table_add_empty(ctx, j);
 #endif
 		for (unsigned int i = 0U; i < XLAT_TABLE_ENTRIES; i++)
 			ctx->tables[j][i] = INVALID_DESC;
@@ -1171,6 +1309,10 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 			ERROR("Not enough memory to map region:\n"
 			      " VA:0x%lx  PA:0x%llx  size:0x%zx  attr:0x%x\n",
 			      mm->base_va, mm->base_pa, mm->size, mm->attr);
+			if (ctx->used_tables == ctx->tables_num) {
+				ERROR("All the %d sub-tables are used\n",
+				      ctx->tables_num);
+			}
 			panic();
 		}
 
@@ -1181,7 +1323,87 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	assert(ctx->max_va <= ctx->va_max_address);
 	assert(ctx->max_pa <= ctx->pa_max_address);
 
+	xlat_attr_cache_flush(ctx);
+
 	ctx->initialized = true;
 
 	xlat_tables_print(ctx);
 }
+
+#if ENABLE_ASSERTIONS
+/*
+ * Returns true if two sets of translation tables map the same way, following
+ * their table descriptors.
+ */
+static bool xlat_tables_match(const uint64_t *table, const uint64_t *ref,
+			      unsigned int table_entries, unsigned int level)
+{
+	for (unsigned int i = 0U; i < table_entries; i++) {
+		uint64_t desc = table[i];
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			if ((ref[i] & DESC_MASK) != TABLE_DESC)
+				return false;
+
+			if (!xlat_tables_match(
+				(const uint64_t *)(uintptr_t)(desc & TABLE_ADDR_MASK),
+				(const uint64_t *)(uintptr_t)(ref[i] & TABLE_ADDR_MASK),
+				XLAT_TABLE_ENTRIES, level + 1U))
+				return false;
+
+		} else if (desc != ref[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif /* ENABLE_ASSERTIONS */
+
+void __init init_xlat_tables_prebuilt_ctx(xlat_ctx_t *ctx,
+					  const xlat_prebuilt_tables_t *tables)
+{
+	assert(ctx != NULL);
+	assert(tables != NULL);
+	assert(!ctx->initialized);
+	assert(!is_mmu_enabled_ctx(ctx));
+
+	if ((tables->xlat_regime != ctx->xlat_regime) ||
+	    (tables->base_table_entries != ctx->base_table_entries) ||
+	    (tables->pa_max_address != ctx->pa_max_address) ||
+	    (tables->va_max_address != ctx->va_max_address)) {
+		ERROR("Prebuilt translation tables don't match the context\n");
+		panic();
+	}
+
+	/* The physical address range of the CPU isn't known at build time. */
+	assert(tables->pa_max_address <= xlat_arch_get_max_supported_pa());
+
+#if ENABLE_ASSERTIONS
+	/*
+	 * The prebuilt tables have been generated from the static memory map
+	 * given to the host tool. Check that they also describe the regions
+	 * that have been added at run time, by building the tables from them.
+	 */
+	init_xlat_tables_ctx(ctx);
+
+	if (!xlat_tables_match(tables->base_table, ctx->base_table,
+			       ctx->base_table_entries, ctx->base_level)) {
+		ERROR("Prebuilt translation tables don't match the memory map\n");
+		panic();
+	}
+
+	assert((tables->max_pa == ctx->max_pa) &&
+	       (tables->max_va == ctx->max_va));
+#else
+	xlat_mmap_print(ctx->mmap);
+#endif
+
+	/* The tables are never written, see xlat_prebuilt_tables_t. */
+	ctx->base_table = (uint64_t *)(uintptr_t)tables->base_table;
+	ctx->max_pa = tables->max_pa;
+	ctx->max_va = tables->max_va;
+	xlat_attr_cache_flush(ctx);
+	ctx->initialized = true;
+}
@@ -36,6 +36,32 @@
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+/*
+ * Format of the entries of the attributes cache of a context. An entry holds
+ * the VA of a block or page, its level and its attributes in a single word, so
+ * that it is always read and written atomically: the attributes of a context
+ * can be looked up by several CPUs at the same time. 0 is an invalid entry.
+ */
+#define XLAT_ATTR_CACHE_VA_MASK		(~(uintptr_t)U(0xfff))
+#define XLAT_ATTR_CACHE_VALID		U(0x800)
+#define XLAT_ATTR_CACHE_LEVEL_SHIFT	U(8)
+#define XLAT_ATTR_CACHE_LEVEL_MASK	U(0x3)
+#define XLAT_ATTR_CACHE_ATTR_MASK	U(0xff)
+
+/*
+ * Empty the attributes cache of a context. This must be done whenever a valid
+ * descriptor of its tables is modified. The attributes of the context must not
+ * be looked up at the same time, like its regions mustn't be accessed.
+ */
+static inline void xlat_attr_cache_flush(const xlat_ctx_t *ctx)
+{
+	if (ctx->attr_cache == NULL)
+		return;
+
+	for (unsigned int i = 0U; i <= XLAT_ATTR_CACHE_SIZE; i++)
+		ctx->attr_cache[i] = 0U;
+}
+
 extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 
 /*
@@ -58,8 +84,17 @@ uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime);
 void xlat_arch_tlbi_va(uintptr_t va, int xlat_regime);
 
 /*
- * This function has to be called at the end of any code that uses the function
- * xlat_arch_tlbi_va().
+ * Invalidate all TLB entries that match the virtual addresses of the given
+ * range, with the same scope as xlat_arch_tlbi_va(). Depending on the size of
+ * the range and on the CPU, this is done with TLB range invalidations, one
+ * invalidation per page or by invalidating all the TLB entries of the
+ * translation regime.
+ */
+void xlat_arch_tlbi_va_range(uintptr_t va, size_t size, int xlat_regime);
+
+/*
+ * This function has to be called at the end of any code that uses the
+ * functions xlat_arch_tlbi_va() or xlat_arch_tlbi_va_range().
  */
 void xlat_arch_tlbi_va_sync(void);
 
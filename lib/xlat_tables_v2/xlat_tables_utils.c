@@ -6,6 +6,8 @@
 
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cassert.h>
+#include <dcache_batch.h>
 #include <debug.h>
 #include <errno.h>
 #include <platform_def.h>
@@ -196,7 +198,6 @@ static void xlat_tables_print_internal(xlat_ctx_t *ctx, uintptr_t table_base_va,
 void xlat_tables_print(xlat_ctx_t *ctx)
 {
 	const char *xlat_regime_str;
-	int used_page_tables;
 
 	if (ctx->xlat_regime == EL1_EL0_REGIME) {
 		xlat_regime_str = "1&0";
@@ -217,18 +218,9 @@ void xlat_tables_print(xlat_ctx_t *ctx)
 	VERBOSE("  Entries @initial lookup level: %u\n",
 		ctx->base_table_entries);
 
-#if PLAT_XLAT_TABLES_DYNAMIC
-	used_page_tables = 0;
-	for (int i = 0; i < ctx->tables_num; ++i) {
-		if (ctx->tables_mapped_regions[i] != 0)
-			++used_page_tables;
-	}
-#else
-	used_page_tables = ctx->next_table;
-#endif
-	VERBOSE("  Used %d sub-tables out of %d (spare: %d)\n",
-		used_page_tables, ctx->tables_num,
-		ctx->tables_num - used_page_tables);
+	VERBOSE("  Used %d sub-tables out of %d (spare: %d, peak: %d)\n",
+		ctx->used_tables, ctx->tables_num,
+		ctx->tables_num - ctx->used_tables, ctx->max_used_tables);
 
 	xlat_tables_print_internal(ctx, 0U, ctx->base_table,
 				   ctx->base_table_entries, ctx->base_level);
@@ -410,22 +402,99 @@ static int xlat_get_mem_attributes_internal(const xlat_ctx_t *ctx,
 }
 
 
+CASSERT(((MT_TYPE_MASK | MT_RW | MT_NS | MT_EXECUTE_NEVER | MT_USER) &
+	 ~XLAT_ATTR_CACHE_ATTR_MASK) == 0U, assert_xlat_attr_cache_attr_size);
+
+/*
+ * Returns true if an entry of the attributes cache is valid and describes the
+ * block or page that contains `va`, and gets its attributes.
+ */
+static bool xlat_attr_cache_match(uintptr_t entry, uintptr_t va,
+				  uint32_t *attr)
+{
+	unsigned int level = (unsigned int)(entry >> XLAT_ATTR_CACHE_LEVEL_SHIFT) &
+			     XLAT_ATTR_CACHE_LEVEL_MASK;
+
+	if ((entry & XLAT_ATTR_CACHE_VALID) == 0U)
+		return false;
+
+	if ((va & XLAT_ADDR_MASK(level)) != (entry & XLAT_ATTR_CACHE_VA_MASK))
+		return false;
+
+	*attr = (uint32_t)(entry & XLAT_ATTR_CACHE_ATTR_MASK);
+
+	return true;
+}
+
+/*
+ * The attributes are looked up in the cache of the context before walking the
+ * tables. Callers such as SMC handlers validating buffers tend to ask several
+ * times in a row about the same block or page, which hits the entry of the last
+ * lookup, or about a few ones, which hit the direct-mapped entries.
+ */
 int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				uint32_t *attr)
 {
-	return xlat_get_mem_attributes_internal(ctx, base_va, attr,
-				NULL, NULL, NULL);
-}
+	uintptr_t *last, *slot;
+	uintptr_t entry;
+	unsigned int level;
+	int rc;
 
+	assert(ctx != NULL);
+	assert(attr != NULL);
 
-int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
-				   size_t size, uint32_t attr)
-{
-	/* Note: This implementation isn't optimized. */
+	if (ctx->attr_cache == NULL) {
+		return xlat_get_mem_attributes_internal(ctx, base_va, attr,
+					NULL, NULL, NULL);
+	}
+
+	last = &ctx->attr_cache[XLAT_ATTR_CACHE_SIZE];
+	if (xlat_attr_cache_match(*last, base_va, attr))
+		return 0;
+
+	slot = &ctx->attr_cache[(base_va >> PAGE_SIZE_SHIFT) &
+				(XLAT_ATTR_CACHE_SIZE - 1U)];
+	entry = *slot;
+	if (xlat_attr_cache_match(entry, base_va, attr)) {
+		*last = entry;
+		return 0;
+	}
 
+	rc = xlat_get_mem_attributes_internal(ctx, base_va, attr,
+				NULL, NULL, &level);
+	if (rc != 0)
+		return rc;
+
+	entry = (base_va & XLAT_ADDR_MASK(level)) | XLAT_ATTR_CACHE_VALID |
+		((uintptr_t)level << XLAT_ATTR_CACHE_LEVEL_SHIFT) | *attr;
+	*slot = entry;
+	*last = entry;
+
+	return 0;
+}
+
+void xlat_get_tables_usage_ctx(const xlat_ctx_t *ctx, int *used,
+			       int *max_used, int *total)
+{
 	assert(ctx != NULL);
 	assert(ctx->initialized);
 
+	if (used != NULL)
+		*used = ctx->used_tables;
+	if (max_used != NULL)
+		*max_used = ctx->max_used_tables;
+	if (total != NULL)
+		*total = ctx->tables_num;
+}
+
+
+/*
+ * Check that the attributes of a memory region can be changed, see the
+ * description of xlat_change_mem_attributes_ctx().
+ */
+static int xlat_check_attr_change(const xlat_ctx_t *ctx, uintptr_t base_va,
+				  size_t size, uint32_t attr)
+{
 	unsigned long long virt_addr_space_size =
 		(unsigned long long)ctx->va_max_address + 1U;
 	assert(virt_addr_space_size > 0U);
@@ -458,8 +527,6 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 	VERBOSE("Changing memory attributes of %zu pages starting from address 0x%lx...\n",
 		pages_count, base_va);
 
-	uintptr_t base_va_original = base_va;
-
 	/*
 	 * Sanity checks.
 	 */
@@ -508,10 +575,86 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		base_va += PAGE_SIZE;
 	}
 
-	/* Restore original value. */
-	base_va = base_va_original;
+	return 0;
+}
+
+/*
+ * Remove the Contiguous hint from the group of pages that contains the page at
+ * `va`, if it has it. The group is being partly remapped, so its entries won't
+ * be identical any more. Changing the hint requires a break-before-make
+ * sequence, so the whole group is briefly unmapped: it must not contain the
+ * code or the data used by this function.
+ *
+ * The pages of a group only differ in their output address, so the new
+ * descriptors are rebuilt from the first one rather than saved on the stack.
+ */
+static void xlat_split_cont_group(const xlat_ctx_t *ctx, uintptr_t va)
+{
+	unsigned long long virt_addr_space_size =
+		(unsigned long long)ctx->va_max_address + 1U;
+	uint64_t *entry, *group;
+	uint64_t desc;
+	uintptr_t group_va;
+	unsigned int level, i;
+
+	entry = find_xlat_table_entry(va, ctx->base_table,
+				      ctx->base_table_entries,
+				      virt_addr_space_size, &level);
+	assert((entry != NULL) && (level == XLAT_TABLE_LEVEL_MAX));
 
-	for (unsigned int i = 0U; i < pages_count; ++i) {
+	if ((*entry & UPPER_ATTRS(CONT_HINT)) == 0U)
+		return;
+
+	/* Tables are aligned to their size, so groups are aligned too. */
+	group = (uint64_t *)round_down((uintptr_t)entry,
+			XLAT_CONT_ENTRIES(level) * sizeof(uint64_t));
+	group_va = round_down(va, (uintptr_t)XLAT_CONT_SIZE(level));
+	desc = group[0] & ~UPPER_ATTRS(CONT_HINT);
+
+	for (i = 0U; i < XLAT_CONT_ENTRIES(level); i++)
+		group[i] = INVALID_DESC;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	clean_dcache_range((uintptr_t)group,
+			   XLAT_CONT_ENTRIES(level) * sizeof(uint64_t));
+#endif
+	xlat_arch_tlbi_va_range(group_va, (size_t)XLAT_CONT_SIZE(level),
+				ctx->xlat_regime);
+	xlat_arch_tlbi_va_sync();
+
+	for (i = 0U; i < XLAT_CONT_ENTRIES(level); i++)
+		group[i] = desc + ((uint64_t)i << PAGE_SIZE_SHIFT);
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	clean_dcache_range((uintptr_t)group,
+			   XLAT_CONT_ENTRIES(level) * sizeof(uint64_t));
+#endif
+}
+
+/*
+ * Write the new descriptors of a memory region that has been checked by
+ * xlat_check_attr_change(). The TLBs are not invalidated.
+ */
+static void xlat_apply_attr_change(const xlat_ctx_t *ctx, uintptr_t base_va,
+				   size_t size, uint32_t attr)
+{
+	size_t pages_count = size / PAGE_SIZE;
+	uintptr_t end_va = base_va + size;
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	dcache_batch_t batch;
+
+	dcache_batch_init(&batch, DCACHE_BATCH_CLEAN);
+#endif
+
+	/*
+	 * Only the groups of pages at the ends of the region can be partly
+	 * covered by it. The other ones keep their Contiguous hint, as all of
+	 * their pages get the same attributes.
+	 */
+	if ((base_va % XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX)) != 0U)
+		xlat_split_cont_group(ctx, base_va);
+	if ((end_va % XLAT_CONT_SIZE(XLAT_TABLE_LEVEL_MAX)) != 0U)
+		xlat_split_cont_group(ctx, end_va - PAGE_SIZE);
+
+	for (size_t i = 0U; i < pages_count; ++i) {
 
 		uint32_t old_attr = 0U, new_attr;
 		uint64_t *entry = NULL;
@@ -537,30 +680,78 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		new_attr |= attr & (MT_RW | MT_EXECUTE_NEVER | MT_USER);
 
 		/*
-		 * The break-before-make sequence requires writing an invalid
-		 * descriptor and making sure that the system sees the change
-		 * before writing the new descriptor.
+		 * Only the access permissions and the execute-never bits
+		 * change, so the descriptor can be replaced without a
+		 * break-before-make sequence: the old and new entries can't
+		 * conflict in the TLBs (see section D4.10.1 of the ARMv8-A ARM
+		 * rev C.a). This allows the TLB entries of all the pages to be
+		 * invalidated at once by the caller.
 		 */
-		*entry = INVALID_DESC;
+		*entry = xlat_desc(ctx, new_attr, addr_pa, level) |
+			 (*entry & UPPER_ATTRS(CONT_HINT));
+
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
+		/*
+		 * The pages of a region are usually described by consecutive
+		 * entries of the same tables, which the batch merges into runs
+		 * cleaned with a single barrier.
+		 */
+		dcache_batch_add(&batch, (uintptr_t)entry, sizeof(uint64_t));
 #endif
-		/* Invalidate any cached copy of this mapping in the TLBs. */
-		xlat_arch_tlbi_va(base_va, ctx->xlat_regime);
-
-		/* Ensure completion of the invalidation. */
-		xlat_arch_tlbi_va_sync();
+		base_va += PAGE_SIZE;
+	}
 
-		/* Write new descriptor */
-		*entry = xlat_desc(ctx, new_attr, addr_pa, level);
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		dccvac((uintptr_t)entry);
+	dcache_batch_finish(&batch);
 #endif
-		base_va += PAGE_SIZE;
+}
+
+int xlat_change_mem_attributes_batch_ctx(const xlat_ctx_t *ctx,
+					 const xlat_attr_change_t *changes,
+					 unsigned int count)
+{
+	unsigned int i;
+	int ret;
+
+	assert(ctx != NULL);
+	assert(ctx->initialized);
+	assert((changes != NULL) || (count == 0U));
+
+	/* Check all the regions before changing any of them. */
+	for (i = 0U; i < count; i++) {
+		ret = xlat_check_attr_change(ctx, changes[i].base_va,
+					     changes[i].size, changes[i].attr);
+		if (ret != 0)
+			return ret;
 	}
 
-	/* Ensure that the last descriptor writen is seen by the system. */
-	dsbish();
+	for (i = 0U; i < count; i++) {
+		xlat_apply_attr_change(ctx, changes[i].base_va,
+				       changes[i].size, changes[i].attr);
+	}
+
+	/* Invalidate any cached copy of the old mappings in the TLBs. */
+	for (i = 0U; i < count; i++) {
+		xlat_arch_tlbi_va_range(changes[i].base_va, changes[i].size,
+					ctx->xlat_regime);
+	}
+
+	/* Ensure completion of the invalidations. */
+	xlat_arch_tlbi_va_sync();
+
+	xlat_attr_cache_flush(ctx);
 
 	return 0;
 }
+
+int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
+				   size_t size, uint32_t attr)
+{
+	const xlat_attr_change_t change = {
+		.base_va = base_va,
+		.size = size,
+		.attr = attr
+	};
+
+	return xlat_change_mem_attributes_batch_ctx(ctx, &change, 1U);
+}
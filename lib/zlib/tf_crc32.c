@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include "zutil.h"
+
+/*
+ * CRC-32 computed with the Armv8 CRC32 instructions, which use the same
+ * polynomial as zlib. This replaces lib/zlib/crc32.c, and its lookup tables,
+ * on AArch64 when ENABLE_CRC32_EXTENSION=1.
+ */
+#if !ENABLE_CRC32_EXTENSION || !defined(__aarch64__)
+#error "tf_crc32.c requires ENABLE_CRC32_EXTENSION=1 on AArch64"
+#endif
+
+static inline uint32_t crc32b(uint32_t crc, uint8_t data)
+{
+	__asm__ ("crc32b %w0, %w0, %w1" : "+r" (crc) : "r" (data));
+	return crc;
+}
+
+static inline uint32_t crc32x(uint32_t crc, uint64_t data)
+{
+	__asm__ ("crc32x %w0, %w0, %x1" : "+r" (crc) : "r" (data));
+	return crc;
+}
+
+unsigned long ZEXPORT crc32_z(unsigned long crc, const unsigned char FAR *buf,
+			      z_size_t len)
+{
+	const uint64_t *buf8;
+	uint32_t c;
+
+	if (buf == Z_NULL)
+		return 0UL;
+
+	c = (uint32_t)crc ^ 0xffffffffU;
+
+	/* Align the buffer for the double word loads */
+	while ((len != 0U) && (((uintptr_t)buf & 7U) != 0U)) {
+		c = crc32b(c, *buf++);
+		len--;
+	}
+
+	buf8 = (const uint64_t *)buf;
+	while (len >= 32U) {
+		c = crc32x(c, buf8[0]);
+		c = crc32x(c, buf8[1]);
+		c = crc32x(c, buf8[2]);
+		c = crc32x(c, buf8[3]);
+		buf8 += 4;
+		len -= 32U;
+	}
+	while (len >= 8U) {
+		c = crc32x(c, *buf8++);
+		len -= 8U;
+	}
+
+	buf = (const unsigned char FAR *)buf8;
+	while (len-- != 0U)
+		c = crc32b(c, *buf++);
+
+	return (unsigned long)(c ^ 0xffffffffU);
+}
+
+unsigned long ZEXPORT crc32(unsigned long crc, const unsigned char FAR *buf,
+			    uInt len)
+{
+	return crc32_z(crc, buf, len);
+}
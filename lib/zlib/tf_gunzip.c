@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <errno.h>
+#include <image_decompress.h>
 #include <string.h>
 #include <tf_gunzip.h>
 #include <utils.h>
@@ -99,3 +100,112 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 
 	return ret;
 }
+
+/*
+ * Streaming interface. The decompressor state is kept across calls so that
+ * compressed data can be fed in chunks as it is read from storage.
+ */
+static z_stream gunzip_stream;
+static int gunzip_stream_ended;
+
+/*
+ * gunzip_stream_init - start decompressing a gzip stream
+ * @out_buf: destination of decompressed output
+ * @out_len: length of out_buf
+ * @work_buf: workspace
+ * @work_len: length of workspace
+ */
+int gunzip_stream_init(uintptr_t out_buf, size_t out_len, uintptr_t work_buf,
+		       size_t work_len)
+{
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	memset(&gunzip_stream, 0, sizeof(gunzip_stream));
+	gunzip_stream.next_out = (typeof(gunzip_stream.next_out))out_buf;
+	gunzip_stream.avail_out = out_len;
+	gunzip_stream.zalloc = zcalloc;
+	gunzip_stream.zfree = zfree;
+	gunzip_stream.opaque = (voidpf)0;
+	gunzip_stream_ended = 0;
+
+	zret = inflateInit(&gunzip_stream);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream_update - decompress the next chunk of a gzip stream
+ * @in_buf: chunk of compressed input
+ * @in_len: length of in_buf
+ *
+ * The whole chunk is consumed before returning, so in_buf can be reused by
+ * the caller afterwards. Data past the end of the gzip stream is ignored.
+ */
+int gunzip_stream_update(uintptr_t in_buf, size_t in_len)
+{
+	int zret;
+
+	if (gunzip_stream_ended != 0)
+		return 0;
+
+	gunzip_stream.next_in = (typeof(gunzip_stream.next_in))in_buf;
+	gunzip_stream.avail_in = in_len;
+
+	zret = inflate(&gunzip_stream, Z_NO_FLUSH);
+	if (zret == Z_STREAM_END) {
+		gunzip_stream_ended = 1;
+		return 0;
+	}
+
+	if ((zret == Z_OK) && (gunzip_stream.avail_in == 0U))
+		return 0;
+
+	if (gunzip_stream.msg)
+		ERROR("%s\n", gunzip_stream.msg);
+	ERROR("zlib: inflate failed (ret = %d)\n", zret);
+
+	if (zret == Z_MEM_ERROR)
+		return -ENOMEM;
+	/* Input left over without error means the output buffer is full */
+	if ((zret == Z_OK) || (zret == Z_BUF_ERROR))
+		return -EFBIG;
+
+	return -EIO;
+}
+
+/*
+ * gunzip_stream_finish - complete the decompression of a gzip stream
+ * @out_buf: upon exit, the end of output.
+ */
+int gunzip_stream_finish(uintptr_t *out_buf)
+{
+	int ret = 0;
+
+	if (gunzip_stream_ended == 0) {
+		ERROR("zlib: truncated input\n");
+		ret = -EIO;
+	}
+
+	VERBOSE("zlib: %lu byte input\n", gunzip_stream.total_in);
+	VERBOSE("zlib: %lu byte output\n", gunzip_stream.total_out);
+
+	*out_buf = (uintptr_t)gunzip_stream.next_out;
+
+	inflateEnd(&gunzip_stream);
+
+	return ret;
+}
+
+const stream_decompressor_t gunzip_stream_decompressor = {
+	.init	= gunzip_stream_init,
+	.update	= gunzip_stream_update,
+	.finish	= gunzip_stream_finish,
+};
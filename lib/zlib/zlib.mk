@@ -4,17 +4,43 @@
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
+ifneq (${ZLIB_MK},1)
+ZLIB_MK		:=	1
+
 ZLIB_PATH	:=	lib/zlib
 
 # Imported from zlib 1.2.11 (do not modify them)
-ZLIB_SOURCES	:=	$(addprefix $(ZLIB_PATH)/,	\
+LIBZ_SRCS	:=	$(addprefix $(ZLIB_PATH)/,	\
 					adler32.c	\
-					crc32.c		\
-					inffast.c	\
 					inflate.c	\
 					inftrees.c	\
 					zutil.c)
 
+# With ENABLE_CRC32_EXTENSION=1, AArch64 computes the CRC-32 with the CRC32
+# instructions instead of the imported table driven crc32.c.
+ifeq (${ARCH}-${ENABLE_CRC32_EXTENSION},aarch64-1)
+LIBZ_SRCS	+=	$(ZLIB_PATH)/tf_crc32.c
+else
+LIBZ_SRCS	+=	$(ZLIB_PATH)/crc32.c
+endif
+
+# AArch64 uses a variant of inffast.c with a 64-bit bit accumulator and
+# chunked match copies. Other architectures use the imported inffast.c.
+ifeq (${ARCH},aarch64)
+LIBZ_SRCS	+=	$(ZLIB_PATH)/inffast_chunk.c
+else
+LIBZ_SRCS	+=	$(ZLIB_PATH)/inffast.c
+endif
+
+# With ROMLIB_ZLIB=1, the zlib core is a library shared through the romlib, so
+# the images only link the code implemented for TF.
+ifeq (${ROMLIB_ZLIB},1)
+ZLIB_SOURCES	:=
+$(eval $(call MAKE_LIB,z))
+else
+ZLIB_SOURCES	:=	$(LIBZ_SRCS)
+endif
+
 # Implemented for TF
 ZLIB_SOURCES	+=	$(addprefix $(ZLIB_PATH)/,	\
 					tf_gunzip.c)
@@ -23,3 +49,5 @@ INCLUDES	+=	-Iinclude/lib/zlib
 
 # REVISIT: the following flags need not be given globally
 TF_CFLAGS	+=	-DZ_SOLO -DDEF_WBITS=31
+
+endif
@@ -183,6 +183,15 @@ endef
 
 GZIP_SUFFIX := .gz
 
+# LZ4 (frame format, no checksums)
+define LZ4_RULE
+$(1): $(2)
+	$(ECHO) "  LZ4     $$@"
+	$(Q)lz4 -9 -f -q --no-frame-crc $$< $$@
+endef
+
+LZ4_SUFFIX := .lz4
+
 ################################################################################
 # Auxiliary macros to build TF images from sources
 ################################################################################
@@ -207,6 +216,23 @@ $(OBJ): $(2) $(filter-out %.d,$(MAKEFILE_LIST)) | lib$(3)_dirs
 endef
 
 
+# MAKE_S_LIB builds an assembly source file and generates the dependency file
+#   $(1) = output directory
+#   $(2) = assembly file (%.S)
+#   $(3) = library name
+define MAKE_S_LIB
+$(eval OBJ := $(1)/$(patsubst %.S,%.o,$(notdir $(2))))
+$(eval DEP := $(patsubst %.o,%.d,$(OBJ)))
+
+$(OBJ): $(2) $(filter-out %.d,$(MAKEFILE_LIST)) | lib$(3)_dirs
+	$$(ECHO) "  AS      $$<"
+	$$(Q)$$(AS) $$(ASFLAGS) $(MAKE_DEP) -c $$< -o $$@
+
+-include $(DEP)
+
+endef
+
+
 # MAKE_C builds a C source file and generates the dependency file
 #   $(1) = output directory
 #   $(2) = source file (%.c)
@@ -262,7 +288,65 @@ $(1): $(2) $(filter-out %.d,$(MAKEFILE_LIST)) | bl$(3)_dirs
 
 endef
 
-# MAKE_LIB_OBJS builds both C source files
+# MAKE_XLAT_PREBUILT generates the translation tables of a BL image. The xlat_gen
+# tool is built on the host with the static memory map of the image, and prints
+# the tables as a C source file.
+#   $(1) = output directory
+#   $(2) = source file of the platform defining the static memory map
+#   $(3) = generated C source file
+#   $(4) = BL stage (1, 2, 2u, 31, 32)
+define MAKE_XLAT_PREBUILT
+
+$(eval XLAT_GEN := $(1)/xlat_gen$(BIN_EXT))
+$(eval IMAGE := IMAGE_BL$(call uppercase,$(4)))
+
+# The C library of the host is used instead of the one of the firmware, which
+# is only searched for the headers that the host doesn't have.
+$(XLAT_GEN): ${XLATGENPATH}/xlat_gen.c lib/xlat_tables_v2/xlat_tables_core.c $(2) $(filter-out %.d,$(MAKEFILE_LIST)) | bl$(4)_dirs
+	$$(ECHO) "  HOSTCC  $$@"
+	$$(Q)$$(HOSTCC) -O2 -Wall -std=gnu99 -DAARCH64 -D$(IMAGE) $$(DEFINES) \
+		-include ${XLATGENPATH}/xlat_gen_host.h \
+		$$(filter-out -Iinclude/lib/libc%,$$(INCLUDES)) \
+		-Ilib/xlat_tables_v2 -idirafter include/lib/libc \
+		-idirafter include/lib/libc/aarch64 \
+		${XLATGENPATH}/xlat_gen.c lib/xlat_tables_v2/xlat_tables_core.c \
+		$(2) -o $$@
+
+$(3): $(XLAT_GEN)
+	$$(ECHO) "  XLATGEN $$@"
+	$$(Q)$(XLAT_GEN) > $$@
+
+endef
+
+# MAKE_TOPOLOGY_PREBUILT generates the PSCI power domain topology of a BL image.
+# The topology_gen tool is built on the host with the topology functions of the
+# platform, and prints the topology tables as a C source file.
+#   $(1) = output directory
+#   $(2) = source file of the platform defining the topology functions
+#   $(3) = generated C source file
+#   $(4) = BL stage (1, 2, 2u, 31, 32)
+define MAKE_TOPOLOGY_PREBUILT
+
+$(eval TOPOLOGY_GEN := $(1)/topology_gen$(BIN_EXT))
+$(eval IMAGE := IMAGE_BL$(call uppercase,$(4)))
+
+# As for xlat_gen, the headers of the host C library are searched first.
+$(TOPOLOGY_GEN): ${TOPOLOGYGENPATH}/topology_gen.c $(2) $(filter-out %.d,$(MAKEFILE_LIST)) | bl$(4)_dirs
+	$$(ECHO) "  HOSTCC  $$@"
+	$$(Q)$$(HOSTCC) -O2 -Wall -std=gnu99 -D$(IMAGE) $$(DEFINES) \
+		-include ${TOPOLOGYGENPATH}/topology_gen_host.h \
+		$$(filter-out -Iinclude/lib/libc%,$$(INCLUDES)) \
+		-idirafter include/lib/libc \
+		-idirafter include/lib/libc/$(ARCH) \
+		${TOPOLOGYGENPATH}/topology_gen.c $(2) -o $$@
+
+$(3): $(TOPOLOGY_GEN)
+	$$(ECHO) "  TOPOGEN $$@"
+	$$(Q)$(TOPOLOGY_GEN) > $$@
+
+endef
+
+# MAKE_LIB_OBJS builds both C and assembly source files
 #   $(1) = output directory
 #   $(2) = list of source files
 #   $(3) = name of the library
@@ -271,6 +355,10 @@ define MAKE_LIB_OBJS
         $(eval REMAIN := $(filter-out %.c,$(2)))
         $(eval $(foreach obj,$(C_OBJS),$(call MAKE_C_LIB,$(1),$(obj),$(3))))
 
+        $(eval S_OBJS := $(filter %.S,$(REMAIN)))
+        $(eval REMAIN := $(filter-out %.S,$(REMAIN)))
+        $(eval $(foreach obj,$(S_OBJS),$(call MAKE_S_LIB,$(1),$(obj),$(3))))
+
         $(and $(REMAIN),$(error Unexpected source files present: $(REMAIN)))
 endef
 
@@ -356,7 +444,11 @@ endef
 define MAKE_BL
         $(eval BUILD_DIR  := ${BUILD_PLAT}/bl$(1))
         $(eval BL_SOURCES := $(BL$(call uppercase,$(1))_SOURCES))
-        $(eval SOURCES    := $(BL_SOURCES) $(BL_COMMON_SOURCES) $(PLAT_BL_COMMON_SOURCES))
+        $(eval XLAT_MMAP  := $(BL$(call uppercase,$(1))_XLAT_MMAP))
+        $(eval XLAT_PREBUILT := $(if $(filter 1,$(PREBUILT_XLAT_TABLES)),$(if $(XLAT_MMAP),$(BUILD_DIR)/xlat_prebuilt_tables.c)))
+        $(eval PSCI_TOPOLOGY := $(BL$(call uppercase,$(1))_PSCI_TOPOLOGY))
+        $(eval TOPOLOGY_PREBUILT := $(if $(filter 1,$(PREBUILT_PSCI_TOPOLOGY)),$(if $(PSCI_TOPOLOGY),$(BUILD_DIR)/psci_prebuilt_topology.c)))
+        $(eval SOURCES    := $(BL_SOURCES) $(BL_COMMON_SOURCES) $(PLAT_BL_COMMON_SOURCES) $(XLAT_PREBUILT) $(TOPOLOGY_PREBUILT))
         $(eval OBJS       := $(addprefix $(BUILD_DIR)/,$(call SOURCES_TO_OBJS,$(SOURCES))))
         $(eval LINKERFILE := $(call IMG_LINKERFILE,$(1)))
         $(eval MAPFILE    := $(call IMG_MAPFILE,$(1)))
@@ -386,6 +478,8 @@ bl${1}_dirs: | ${OBJ_DIRS}
 
 $(eval $(call MAKE_OBJS,$(BUILD_DIR),$(SOURCES),$(1)))
 $(eval $(call MAKE_LD,$(LINKERFILE),$(BL_LINKERFILE),$(1)))
+$(if $(XLAT_PREBUILT),$(eval $(call MAKE_XLAT_PREBUILT,$(BUILD_DIR),$(XLAT_MMAP),$(XLAT_PREBUILT),$(1))))
+$(if $(TOPOLOGY_PREBUILT),$(eval $(call MAKE_TOPOLOGY_PREBUILT,$(BUILD_DIR),$(PSCI_TOPOLOGY),$(TOPOLOGY_PREBUILT),$(1))))
 
 ifeq ($(USE_ROMLIB),1)
 $(ELF): romlib.bin
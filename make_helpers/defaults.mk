@@ -16,6 +16,9 @@ AARCH32_INSTRUCTION_SET		:= T32
 # The AArch32 Secure Payload to be built as BL32 image
 AARCH32_SP			:= none
 
+# Flag to account the AMU group 0 counters to the Secure and Non-secure worlds
+AMU_WORLD_STATS			:= 0
+
 # The Target build architecture. Supported values are: aarch64, aarch32.
 ARCH				:= aarch64
 
@@ -23,9 +26,16 @@ ARCH				:= aarch64
 ARM_ARCH_MAJOR			:= 8
 ARM_ARCH_MINOR			:= 0
 
+# Cache the digests of authenticated certificates to avoid checking their
+# signatures again
+AUTH_CERT_CACHE			:= 0
+
 # Base commit to perform code check on
 BASE_COMMIT			:= origin/master
 
+# Check BL2 against the hash recorded at the last cold boot on warm resets
+BL1_WARM_RESUME			:= 0
+
 # Execute BL2 at EL3
 BL2_AT_EL3			:= 0
 
@@ -33,6 +43,18 @@ BL2_AT_EL3			:= 0
 # when BL2_AT_EL3 is 1.
 BL2_IN_XIP_MEM			:= 0
 
+# Benchmark the loading path of BL2 before it loads the images
+BL2_IO_BENCHMARK		:= 0
+
+# Hash the images loaded by BL2 on a secondary CPU
+BL2_SECONDARY_HASH		:= 0
+
+# Execute BL31 in place from XIP memory, only its RW sections are in RAM
+BL31_IN_XIP_MEM			:= 0
+
+# Record a timeline of the boot in BL1, BL2 and BL31
+BOOT_PROFILING			:= 0
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
@@ -41,6 +63,10 @@ COLD_BOOT_SINGLE_CPU		:= 0
 # Makefile system will set this when compiling TF as part of a coreboot image.
 COREBOOT			:= 0
 
+# Write the BL31 crash reports to a memory region of the platform, in addition
+# to the crash console
+CRASH_DUMP_TO_MEMORY		:= 0
+
 # For Chain of Trust
 CREATE_KEYS			:= 1
 
@@ -51,16 +77,37 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch the FP registers between the worlds only when the secure world uses
+# them, by trapping its first access with CPTR_EL3.TFP
+CTX_LAZY_FPREGS			:= 0
+
 # Debug build
 DEBUG				:= 0
 
 # Build platform
 DEFAULT_PLAT			:= fvp
 
+# Flag to let the memory-mapped IO drivers copy through a DMA engine registered
+# by the platform
+DMA_ENGINE			:= 0
+
+# Flag to partition the DSU L3 cache between the Secure and Non-secure worlds
+DSU_L3_PARTITIONING		:= 0
+
 # Enable capability to disable authentication dynamically. Only meant for
 # development platforms.
 DYN_DISABLE_AUTH		:= 0
 
+# Flag to use the Armv8 CRC32 instructions in the AArch64 zlib crc32()
+ENABLE_CRC32_EXTENSION		:= 0
+
+# Flag to count the acquisitions and the contention of the locks of BL31
+ENABLE_LOCK_STATS		:= 0
+
+# Flag to let the AArch64 memset() use DC ZVA to zero large buffers when the
+# MMU is enabled
+ENABLE_MEMSET_DCZVA		:= 0
+
 # Build option to enable MPAM for lower ELs
 ENABLE_MPAM_FOR_LOWER_ELS	:= 0
 
@@ -70,30 +117,60 @@ ENABLE_PIE			:= 0
 # Flag to enable Performance Measurement Framework
 ENABLE_PMF			:= 0
 
+# Flag to enable the SMC that copies all the time-stamps of a PMF service to a
+# Non-secure buffer
+ENABLE_PMF_BULK_TIMESTAMPS	:= 0
+
 # Flag to enable PSCI STATs functionality
 ENABLE_PSCI_STAT		:= 0
 
+# Flag to enable the trace of the CPU_SUSPEND calls of the runtime
+# instrumentation
+ENABLE_PSCI_SUSPEND_TRACE	:= 0
+
 # Flag to enable runtime instrumentation using PMF
 ENABLE_RUNTIME_INSTRUMENTATION	:= 0
 
+# Flag to enable the SMC latency histograms of the runtime instrumentation
+ENABLE_SMC_LATENCY_HIST		:= 0
+
 # Flag to enable stack corruption protection
 ENABLE_STACK_PROTECTOR		:= 0
 
 # Flag to enable exception handling in EL3
 EL3_EXCEPTION_HANDLING		:= 0
 
+# Maximum number of EL3 interrupts handled by the EHF before returning from the
+# exception they were taken with
+EL3_EXCEPTION_INTR_BATCH	:= 1
+
+# Flag to make the EHF track the Priority Mask of nested activations instead of
+# programming it again on deactivation
+EL3_EXCEPTION_PMR_TRACKING	:= 0
+
+# Build flag to include the sampling profiler of BL31, and number of samples
+# held for each CPU
+EL3_PROFILER			:= 0
+EL3_PROFILER_SAMPLES		:= 256
+
 # Build flag to treat usage of deprecated platform and framework APIs as error.
 ERROR_DEPRECATED		:= 0
 
 # Fault injection support
 FAULT_INJECTION_SUPPORT		:= 0
 
+# Number of DTB node and property lookups cached by fdt_wrappers (0 to disable)
+FDT_LOOKUP_CACHE_ENTRIES	:= 0
+
 # Byte alignment that each component in FIP is aligned to
 FIP_ALIGN			:= 0
 
 # Default FIP file name
 FIP_NAME			:= fip.bin
 
+# Number of FIP ToC entries cached in memory by the FIP driver (0 to disable)
+FIP_TOC_CACHE_ENTRIES		:= 0
+
 # Default FWU_FIP file name
 FWU_FIP_NAME			:= fwu_fip.bin
 
@@ -104,6 +181,14 @@ GENERATE_COT			:= 0
 # default, they are for Secure EL1.
 GICV2_G0_FOR_EL3		:= 0
 
+# How the GICv3 driver routes the Secure SPIs: 0 to the boot CPU, 1 spread
+# round-robin over the online CPUs, 2 with 1 of N distribution.
+GICV3_SECURE_SPI_ROUTING	:= 0
+
+# Support the GICv3.1 extended PPI and SPI ranges in the GICv3 driver. Disabled
+# by default.
+GIC_EXT_INTID			:= 0
+
 # Route External Aborts to EL3. Disabled by default; External Aborts are handled
 # by lower ELs.
 HANDLE_EA_EL3_FIRST		:= 0
@@ -112,9 +197,33 @@ HANDLE_EA_EL3_FIRST		:= 0
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Number of 4KB lines of the read cache of the block IO driver (0 to disable)
+IO_BLOCK_CACHE_LINES		:= 0
+
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
+# Size of the chunks in which images are hashed while being loaded (0 to
+# disable)
+LOAD_IMAGE_CHUNK_SIZE		:= 0
+
+# Record the INFO and VERBOSE messages in a binary log instead of printing them
+LOG_BINARY			:= 0
+
+# Record the hashes of the images authenticated by BL2 in a TCG event log
+MEASURED_BOOT			:= 0
+
+# Distance in bytes of the source prefetches of the AArch64 memcpy() streaming
+# loop (0 to disable)
+MEMCPY_PREFETCH_DISTANCE	:= 0
+
+# Minimum size in bytes of the copies streamed with non-temporal stores by the
+# AArch64 memcpy() (0 to disable)
+MEMCPY_STREAM_MIN		:= 0
+
+# Flag to assign the Secure and Non-secure worlds to their own MPAM partitions
+MPAM_WORLD_PARTID		:= 0
+
 # Enable use of the console API allowing multiple consoles to be registered
 # at the same time.
 MULTI_CONSOLE_API		:= 0
@@ -125,6 +234,14 @@ NS_TIMER_SWITCH			:= 0
 # Build PL011 UART driver in minimal generic UART mode
 PL011_GENERIC_UART		:= 0
 
+# Use the PSCI power domain topology generated at build time for the BL images
+# whose topology functions are given by the platform in BLx_PSCI_TOPOLOGY
+PREBUILT_PSCI_TOPOLOGY		:= 0
+
+# Use the translation tables generated at build time for the BL images whose
+# static memory map is given by the platform in BLx_XLAT_MMAP
+PREBUILT_XLAT_TABLES		:= 0
+
 # By default, consider that the platform's reset address is not programmable.
 # The platform Makefile is free to override this value.
 PROGRAMMABLE_RESET_ADDRESS	:= 0
@@ -133,18 +250,67 @@ PROGRAMMABLE_RESET_ADDRESS	:= 0
 # Original format.
 PSCI_EXTENDED_STATE_ID		:= 0
 
+# Let a CPU resume without the power domain locks when another CPU of the
+# cluster is running
+PSCI_LOCKLESS_RESUME		:= 0
+
+# Let CPU_SUSPEND skip the power domain locks when another CPU of the cluster is
+# running
+PSCI_LOCKLESS_SUSPEND		:= 0
+
+# Add support for the PSCI OS-initiated suspend mode
+PSCI_OS_INIT_MODE		:= 0
+
+# Let each CPU turned off clean a slice of the caches it shares with the other
+# CPUs of its cluster
+PSCI_PARALLEL_CACHE_CLEAN	:= 0
+
+# Keep the PSCI power domain nodes and the requested states of each CPU in their
+# own cache lines
+PSCI_PD_CACHE_ALIGN		:= 0
+
+# Prepare at cold boot the Non-secure context of the CPUs turned on by CPU_ON
+PSCI_PRESET_CPU_ON_CONTEXT	:= 0
+
+# Demote the power down of the power domains above the CPUs to retention when
+# the PSCI statistics predict a short idle period
+PSCI_STAT_IDLE_PREDICT		:= 0
+
+# Publish the pubsub events of BL31 through call chains built at link time
+PUBSUB_STATIC_DISPATCH		:= 0
+
+# Queue the corrected errors signalled by External Aborts for deferred handling
+RAS_EA_DEFERRED			:= 0
+
+# Aggregate the RAS errors in a shared memory log reported through SDEI
+RAS_ERR_LOG			:= 0
+
 # Enable RAS support
 RAS_EXTENSION			:= 0
 
 # By default, BL1 acts as the reset handler, not BL31
 RESET_TO_BL31			:= 0
 
+# Share the zlib core through the library at ROM
+ROMLIB_ZLIB			:= 0
+
 # For Chain of Trust
 SAVE_KEYS			:= 0
 
+# Maximum number of SDEI events of the same priority dispatched for one SDEI
+# interrupt exception. The default of 1 dispatches a single event.
+SDEI_DISPATCH_BATCH		:= 1
+
+# Flag to enable the delivery statistics of the SDEI events
+SDEI_EVENT_STATS		:= 0
+
 # Software Delegated Exception support
 SDEI_SUPPORT            	:= 0
 
+# Flag to bound the time a Secure Payload spends in a yielding call before it
+# is preempted
+SECURE_TIME_BUDGET		:= 0
+
 # Whether code and read-only data should be put on separate memory pages. The
 # platform Makefile is free to override this value.
 SEPARATE_CODE_AND_RODATA	:= 0
@@ -153,6 +319,19 @@ SEPARATE_CODE_AND_RODATA	:= 0
 # cores stack
 RECLAIM_INIT_CODE		:= 0
 
+# Look the SMC function ids bound to a handler with runtime_svc_register_fid()
+# up before dispatching the SMC to its runtime service
+RT_SVC_FID_HANDLERS		:= 0
+
+# Run the initialisations deferred by runtime services after the cold boot
+RT_SVC_DEFERRED_INIT		:= 0
+
+# Resolve the cpu_ops of the only CPU type of the platform at build time
+SINGLE_CPU_OPS			:= 0
+
+# Flag to let the Normal world make a batch of SiP calls with a single SMC
+SIP_BATCH			:= 0
+
 # Default to SMCCC Version 1.X
 SMCCC_MAJOR_VERSION		:= 1
 
@@ -190,6 +369,10 @@ V				:= 0
 # platforms).
 WARMBOOT_ENABLE_DCACHE_EARLY	:= 0
 
+# Size in bytes of the translation granule used by the translation tables
+# library and of the pages of the BL images (4096, 16384 or 65536)
+XLAT_GRANULE_SIZE		:= 4096
+
 # Build option to enable/disable the Statistical Profiling Extensions
 ENABLE_SPE_FOR_LOWER_ELS	:= 1
 
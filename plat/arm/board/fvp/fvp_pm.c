@@ -244,6 +244,9 @@ static void fvp_pwr_domain_suspend(const psci_power_state_t *target_state)
  ******************************************************************************/
 static void fvp_pwr_domain_on_finish(const psci_power_state_t *target_state)
 {
+	/* Let the re-distributor power up while the cluster is set up */
+	plat_arm_gic_redistif_on_start();
+
 	fvp_power_domain_on_finish_common(target_state);
 
 	/* Enable the gic cpu interface */
@@ -13,7 +13,8 @@
 #  define PLAT_XLAT_TABLES_DYNAMIC     1
 # endif
 #else
-# if defined(IMAGE_BL31) && RESET_TO_BL31
+# if defined(IMAGE_BL31) && (RESET_TO_BL31 || ENABLE_PSCI_SUSPEND_TRACE || \
+			       ENABLE_PMF_BULK_TIMESTAMPS)
 #  define PLAT_XLAT_TABLES_DYNAMIC     1
 # endif
 #endif /* AARCH32 */
@@ -139,7 +140,8 @@
 #if TRUSTED_BOARD_BOOT
 #if TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA_AND_ECDSA
 # define PLAT_ARM_MAX_BL2_SIZE		UL(0x1F000)
-#elif TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA
+#elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA) || \
+	(TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA_P384)
 # define PLAT_ARM_MAX_BL2_SIZE		UL(0x1D000)
 #else
 # define PLAT_ARM_MAX_BL2_SIZE		UL(0x1C000)
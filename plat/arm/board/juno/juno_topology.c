@@ -5,6 +5,7 @@
  */
 
 #include <arm_def.h>
+#include <assert.h>
 #include <css_pm.h>
 #include <plat_arm.h>
 #include <platform.h>
@@ -21,8 +22,11 @@ static scmi_channel_plat_info_t juno_scmi_plat_info = {
 		.ring_doorbell = &mhu_ring_doorbell,
 };
 
-scmi_channel_plat_info_t *plat_css_get_scmi_info()
+scmi_channel_plat_info_t *plat_css_get_scmi_info(unsigned int channel_id)
 {
+	/* There is a single SCMI channel */
+	assert(channel_id == 0U);
+
 	return &juno_scmi_plat_info;
 }
 
@@ -6,6 +6,7 @@
 
 #include "../../css/drivers/scmi/scmi.h"
 #include "../../css/drivers/mhu/css_mhu_doorbell.h"
+#include <assert.h>
 #include <plat_arm.h>
 #include <platform_def.h>
 
@@ -17,8 +18,11 @@ static scmi_channel_plat_info_t n1sdp_scmi_plat_info = {
 		.ring_doorbell = &mhu_ring_doorbell,
 };
 
-scmi_channel_plat_info_t *plat_css_get_scmi_info()
+scmi_channel_plat_info_t *plat_css_get_scmi_info(unsigned int channel_id)
 {
+	/* There is a single SCMI channel */
+	assert(channel_id == 0U);
+
 	return &n1sdp_scmi_plat_info;
 }
 
@@ -28,7 +28,11 @@ BL31_SOURCES		+=	${SGI_CPU_SOURCES}			\
 
 # Add the FDT_SOURCES and options for Dynamic Config
 FDT_SOURCES		+=	${SGICLARKH_BASE}/fdts/${PLAT}_tb_fw_config.dts
+ifeq (${ARM_TB_FW_CONFIG_BLOB},1)
+TB_FW_CONFIG		:=	${BUILD_PLAT}/${PLAT}_tb_fw_config.bin
+else
 TB_FW_CONFIG		:=	${BUILD_PLAT}/fdts/${PLAT}_tb_fw_config.dtb
+endif
 
 # Add the TB_FW_CONFIG to FIP and specify the same to certtool
 $(eval $(call TOOL_ADD_PAYLOAD,${TB_FW_CONFIG},--tb-fw-config))
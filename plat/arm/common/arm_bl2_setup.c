@@ -6,11 +6,16 @@
 
 #include <arch_helpers.h>
 #include <arm_def.h>
+#include <arm_dyn_cfg_helpers.h>
 #include <assert.h>
+#include <bl2.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <desc_image_load.h>
+#include <errno.h>
 #include <generic_delay_timer.h>
+#include <io_fip.h>
+#include <io_storage.h>
 #ifdef SPD_opteed
 #include <optee_utils.h>
 #endif
@@ -195,6 +200,33 @@ int arm_bl2_handle_post_image_load(unsigned int image_id)
 	return err;
 }
 
+#if defined(SPD_opteed) && defined(AARCH64)
+/*******************************************************************************
+ * Load the pager and paged parts of an OP-TEE image packaged with its header in
+ * the BL32 FIP entry straight to their load addresses.
+ ******************************************************************************/
+image_split_t *bl2_plat_get_image_split(unsigned int image_id)
+{
+	bl_mem_params_node_t *bl_mem_params;
+	bl_mem_params_node_t *pager_mem_params;
+	bl_mem_params_node_t *paged_mem_params;
+
+	if (image_id != BL32_IMAGE_ID)
+		return NULL;
+
+	bl_mem_params = get_bl_mem_params_node(BL32_IMAGE_ID);
+	pager_mem_params = get_bl_mem_params_node(BL32_EXTRA1_IMAGE_ID);
+	paged_mem_params = get_bl_mem_params_node(BL32_EXTRA2_IMAGE_ID);
+	assert(bl_mem_params);
+	assert(pager_mem_params);
+	assert(paged_mem_params);
+
+	return optee_get_image_split(&bl_mem_params->ep_info,
+			&pager_mem_params->image_info,
+			&paged_mem_params->image_info);
+}
+#endif
+
 /*******************************************************************************
  * This function can be used by the platforms to update/use image
  * information for given `image_id`.
@@ -208,3 +240,73 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
 	return arm_bl2_plat_handle_post_image_load(image_id);
 }
+
+#if BL2_IO_BENCHMARK
+/*******************************************************************************
+ * Images loaded by the benchmark of the loading path. Those missing from the
+ * FIP are skipped, so the images to benchmark, e.g. synthetic images of
+ * various sizes, can be packed as BL32_EXTRA1 and BL32_EXTRA2.
+ ******************************************************************************/
+#pragma weak plat_bl2_io_bench_get_images
+
+static const bl2_io_bench_image_t arm_bl2_io_bench_images[] = {
+	{ .image_id = BL31_IMAGE_ID },
+	{ .image_id = BL32_IMAGE_ID },
+	{ .image_id = BL32_EXTRA1_IMAGE_ID },
+	{ .image_id = BL32_EXTRA2_IMAGE_ID },
+	{ .image_id = BL33_IMAGE_ID },
+};
+
+const bl2_io_bench_image_t *plat_bl2_io_bench_get_images(
+						unsigned int *num_images)
+{
+	*num_images = ARRAY_SIZE(arm_bl2_io_bench_images);
+
+	return arm_bl2_io_bench_images;
+}
+#endif /* BL2_IO_BENCHMARK */
+
+/*******************************************************************************
+ * Publish an image deferred to BL33 in NT_FW_CONFIG, with its location in the
+ * FIP and the hash it must match.
+ ******************************************************************************/
+int bl2_plat_handle_deferred_image(unsigned int image_id, const void *hash,
+				   unsigned int hash_len)
+{
+	bl_mem_params_node_t *cfg_mem_params;
+	uintptr_t dev_handle, image_spec, image_handle;
+	uint64_t offset, size;
+	int err;
+
+	cfg_mem_params = get_bl_mem_params_node(NT_FW_CONFIG_ID);
+	if ((cfg_mem_params == NULL) ||
+	    (cfg_mem_params->image_info.image_size == 0U)) {
+		WARN("BL2: No NT_FW_CONFIG to publish image id %u in\n",
+		     image_id);
+		return -ENOENT;
+	}
+
+	err = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (err != 0)
+		return err;
+
+	err = io_open(dev_handle, image_spec, &image_handle);
+	if (err != 0)
+		return err;
+
+	err = fip_get_file_location(image_handle, &offset, &size);
+	(void)io_close(image_handle);
+	if (err != 0)
+		return err;
+
+	if (arm_dyn_add_deferred_image(
+			(void *)cfg_mem_params->image_info.image_base,
+			cfg_mem_params->image_info.image_max_size,
+			image_id, offset, size, hash, hash_len) != 0)
+		return -ENOMEM;
+
+	flush_dcache_range(cfg_mem_params->image_info.image_base,
+			   cfg_mem_params->image_info.image_max_size);
+
+	return 0;
+}
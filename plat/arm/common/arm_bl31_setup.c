@@ -39,10 +39,18 @@ CASSERT(BL31_BASE >= ARM_TB_FW_CONFIG_LIMIT, assert_bl31_base_overflows);
 #pragma weak bl31_plat_arch_setup
 #pragma weak bl31_plat_get_next_image_ep_info
 
+#if BL31_IN_XIP_MEM
+/* Only the RW sections are in RAM, the RO ones are mapped by ARM_MAP_BL_RO */
+#define MAP_BL31_TOTAL		MAP_REGION_FLAT(			\
+					BL31_RAM_BASE,			\
+					BL31_RAM_LIMIT - BL31_RAM_BASE,	\
+					MT_MEMORY | MT_RW | MT_SECURE)
+#else
 #define MAP_BL31_TOTAL		MAP_REGION_FLAT(			\
 					BL31_START,			\
 					BL31_END - BL31_START,		\
 					MT_MEMORY | MT_RW | MT_SECURE)
+#endif
 #if RECLAIM_INIT_CODE
 IMPORT_SYM(unsigned long, __INIT_CODE_START__, BL_INIT_CODE_BASE);
 IMPORT_SYM(unsigned long, __INIT_CODE_END__, BL_INIT_CODE_END);
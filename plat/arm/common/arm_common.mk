@@ -70,6 +70,11 @@ ARM_BL31_IN_DRAM		:=	0
 $(eval $(call assert_boolean,ARM_BL31_IN_DRAM))
 $(eval $(call add_define,ARM_BL31_IN_DRAM))
 
+# Use the TB_FW_CONFIG blob generated by the cfgblob tool instead of the DTB
+ARM_TB_FW_CONFIG_BLOB		:=	0
+$(eval $(call assert_boolean,ARM_TB_FW_CONFIG_BLOB))
+$(eval $(call add_define,ARM_TB_FW_CONFIG_BLOB))
+
 # Process ARM_PLAT_MT flag
 ARM_PLAT_MT			:=	0
 $(eval $(call assert_boolean,ARM_PLAT_MT))
@@ -191,12 +196,32 @@ BL2_SOURCES		+=	drivers/delay_timer/delay_timer.c		\
 # Add `libfdt` and Arm common helpers required for Dynamic Config
 include lib/libfdt/libfdt.mk
 
+ifeq (${ARM_TB_FW_CONFIG_BLOB},1)
+# BL1 doesn't use libfdt, BL2 still needs it for NT_FW_CONFIG
+DYN_CFG_SOURCES		+=	plat/arm/common/arm_dyn_cfg.c		\
+				plat/arm/common/arm_dyn_cfg_blob.c
+
+BL1_SOURCES		+=	${DYN_CFG_SOURCES}
+BL2_SOURCES		+=	${DYN_CFG_SOURCES}				\
+				plat/arm/common/arm_dyn_cfg_helpers.c		\
+				common/fdt_wrappers.c
+
+CFGBLOBPATH		?=	tools/cfgblob
+CFGBLOB			?=	${CFGBLOBPATH}/cfgblob${BIN_EXT}
+
+# Compile the TB_FW_CONFIG DTB into the blob
+${BUILD_PLAT}/%_tb_fw_config.bin: ${BUILD_PLAT}/fdts/%_tb_fw_config.dtb \
+				| ${CFGBLOB}
+	${ECHO} "  CFGBLOB $@"
+	${Q}${CFGBLOB} $< $@
+else
 DYN_CFG_SOURCES		+=	plat/arm/common/arm_dyn_cfg.c		\
 				plat/arm/common/arm_dyn_cfg_helpers.c	\
 				common/fdt_wrappers.c
 
 BL1_SOURCES		+=	${DYN_CFG_SOURCES}
 BL2_SOURCES		+=	${DYN_CFG_SOURCES}
+endif
 
 ifeq (${BL2_AT_EL3},1)
 BL2_SOURCES		+=	plat/arm/common/arm_bl2_el3_setup.c
@@ -242,6 +267,9 @@ endif
 ifeq (${RAS_EXTENSION},1)
 BL31_SOURCES		+=	lib/extensions/ras/std_err_record.c		\
 				lib/extensions/ras/ras_common.c
+ifeq (${RAS_ERR_LOG},1)
+BL31_SOURCES		+=	lib/extensions/ras/ras_err_log.c
+endif
 endif
 
 # SPM uses libfdt in Arm platforms
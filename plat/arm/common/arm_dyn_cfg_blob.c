@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arm_dyn_cfg_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <tb_fw_cfg_blob.h>
+#include <tbbr_img_def.h>
+
+/*
+ * Implementation of the TB_FW_CONFIG helpers for ARM_TB_FW_CONFIG_BLOB=1,
+ * where the TB_FW_CONFIG is a blob pre-parsed on the host instead of a DTB.
+ * The helpers keep the interface of the DTB ones so that arm_dyn_cfg.c is
+ * shared, the `node` argument is meaningless and set to 0.
+ */
+
+/* Index of the load information of `config_id` in the blob, or -1 */
+static int blob_config_index(unsigned int config_id)
+{
+	switch (config_id) {
+	case HW_CONFIG_ID:
+		return (int)TB_FW_CFG_BLOB_HW_CONFIG;
+	case SOC_FW_CONFIG_ID:
+		return (int)TB_FW_CFG_BLOB_SOC_FW_CONFIG;
+	case TOS_FW_CONFIG_ID:
+		return (int)TB_FW_CFG_BLOB_TOS_FW_CONFIG;
+	case NT_FW_CONFIG_ID:
+		return (int)TB_FW_CFG_BLOB_NT_FW_CONFIG;
+	default:
+		return -1;
+	}
+}
+
+/*******************************************************************************
+ * Validate the tb_fw_config is a valid blob.
+ * Arguments:
+ *	void *dtb - pointer to the TB_FW_CONFIG in memory
+ *	int *node - Set to 0.
+ *
+ * Returns 0 on success and -1 on error.
+ ******************************************************************************/
+int arm_dyn_tb_fw_cfg_init(void *dtb, int *node)
+{
+	const tb_fw_cfg_blob_t *blob = dtb;
+
+	assert(dtb != NULL);
+	assert(node != NULL);
+
+	if ((blob->magic != TB_FW_CFG_BLOB_MAGIC) ||
+	    (blob->version < TB_FW_CFG_BLOB_VERSION) ||
+	    (blob->size < sizeof(tb_fw_cfg_blob_t))) {
+		WARN("Invalid blob passed as TB_FW_CONFIG\n");
+		return -1;
+	}
+
+	*node = 0;
+
+	VERBOSE("Dyn cfg: Found TB_FW_CONFIG blob version %u\n",
+		blob->version);
+	return 0;
+}
+
+/*******************************************************************************
+ * Helper to read the load information corresponding to the `config_id` in
+ * the TB_FW_CONFIG blob.
+ *
+ * Returns 0 on success and -1 on error.
+ ******************************************************************************/
+int arm_dyn_get_config_load_info(void *dtb, int node, unsigned int config_id,
+		uint64_t *config_addr, uint32_t *config_size)
+{
+	const tb_fw_cfg_blob_t *blob = dtb;
+	int i;
+
+	assert(dtb != NULL);
+	assert(node == 0);
+	assert(config_addr != NULL);
+	assert(config_size != NULL);
+
+	i = blob_config_index(config_id);
+	if (i < 0) {
+		WARN("Invalid config id %d\n", config_id);
+		return -1;
+	}
+
+	if (blob->config[i].valid == 0U)
+		return -1;
+
+	*config_addr = blob->config[i].addr;
+	*config_size = blob->config[i].max_size;
+
+	VERBOSE("Dyn cfg: Read config_id %d load info from TB_FW_CONFIG 0x%llx 0x%x\n",
+				config_id, (unsigned long long)*config_addr, *config_size);
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Helper to read the `disable_auth` property in the TB_FW_CONFIG blob.
+ *
+ * Returns 0 on success and -1 on error.
+ ******************************************************************************/
+int arm_dyn_get_disable_auth(void *dtb, int node, uint32_t *disable_auth)
+{
+	const tb_fw_cfg_blob_t *blob = dtb;
+
+	assert(dtb != NULL);
+	assert(node == 0);
+	assert(disable_auth != NULL);
+
+	if ((blob->flags & TB_FW_CFG_BLOB_DISABLE_AUTH) == 0U)
+		return -1;
+
+	*disable_auth = blob->disable_auth;
+
+	/* Check if the value is boolean */
+	if ((*disable_auth != 0U) && (*disable_auth != 1U)) {
+		WARN("Invalid value for `disable_auth` %d\n", *disable_auth);
+		return -1;
+	}
+
+	VERBOSE("Dyn cfg: `disable_auth` found with value = %d\n",
+					*disable_auth);
+	return 0;
+}
+
+/*
+ * Reads the Mbed TLS shared heap information from the TB_FW_CONFIG blob.
+ * This function is supposed to be called only by BL2.
+ *
+ * Returns 0 on success and -1 on error.
+ */
+int arm_get_dtb_mbedtls_heap_info(void *dtb, void **heap_addr,
+	size_t *heap_size)
+{
+	const tb_fw_cfg_blob_t *blob = dtb;
+	int node;
+
+	if ((arm_dyn_tb_fw_cfg_init(dtb, &node) < 0) ||
+	    ((blob->flags & TB_FW_CFG_BLOB_MBEDTLS_HEAP) == 0U)) {
+		ERROR("Cannot retrieve Mbed TLS heap information from TB_FW_CONFIG\n");
+		return -1;
+	}
+
+	*heap_addr = (void *)(uintptr_t)blob->mbedtls_heap_addr;
+	*heap_size = (size_t)blob->mbedtls_heap_size;
+
+	return 0;
+}
+
+/*
+ * Writes the Mbed TLS heap address and size in the TB_FW_CONFIG blob.
+ * This function is supposed to be called only by BL1.
+ *
+ * Returns 0 on success and -1 on error.
+ */
+int arm_set_dtb_mbedtls_heap_info(void *dtb, void *heap_addr, size_t heap_size)
+{
+	tb_fw_cfg_blob_t *blob = dtb;
+	int node;
+
+	if ((arm_dyn_tb_fw_cfg_init(dtb, &node) < 0) ||
+	    ((blob->flags & TB_FW_CFG_BLOB_MBEDTLS_HEAP) == 0U)) {
+		ERROR("Unable to write Mbed TLS heap information to TB_FW_CONFIG\n");
+		return -1;
+	}
+
+	blob->mbedtls_heap_addr = (uintptr_t)heap_addr;
+	blob->mbedtls_heap_size = heap_size;
+
+	return 0;
+}
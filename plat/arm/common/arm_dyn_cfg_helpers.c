@@ -10,10 +10,19 @@
 #include <fdt_wrappers.h>
 #include <libfdt.h>
 #include <plat_arm.h>
+#include <stdio.h>
 
 #define DTB_PROP_MBEDTLS_HEAP_ADDR "mbedtls_heap_addr"
 #define DTB_PROP_MBEDTLS_HEAP_SIZE "mbedtls_heap_size"
 
+#define DEFERRED_IMAGES_COMPAT		"arm,deferred_images"
+#define DEFERRED_IMAGE_NODE_NAME_LEN	U(20)
+
+/*
+ * With ARM_TB_FW_CONFIG_BLOB=1, the TB_FW_CONFIG helpers are implemented by
+ * arm_dyn_cfg_blob.c instead.
+ */
+#if !ARM_TB_FW_CONFIG_BLOB
 typedef struct config_load_info_prop {
 	unsigned int config_id;
 	const char *config_addr;
@@ -69,7 +78,7 @@ int arm_dyn_get_config_load_info(void *dtb, int node, unsigned int config_id,
 	assert(fdt_check_header(dtb) == 0);
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	assert(node == fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
+	assert(node == fdtw_node_offset_by_compatible(dtb, "arm,tb_fw"));
 
 	err = fdtw_read_cells(dtb, node, prop_names[i].config_addr, 2,
 				(void *) config_addr);
@@ -116,7 +125,7 @@ int arm_dyn_get_disable_auth(void *dtb, int node, uint32_t *disable_auth)
 	assert(fdt_check_header(dtb) == 0);
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	assert(node == fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw"));
+	assert(node == fdtw_node_offset_by_compatible(dtb, "arm,tb_fw"));
 
 	/* Locate the disable_auth cell and read the value */
 	err = fdtw_read_cells(dtb, node, "disable_auth", 1, disable_auth);
@@ -157,7 +166,7 @@ int arm_dyn_tb_fw_cfg_init(void *dtb, int *node)
 	}
 
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
-	*node = fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw");
+	*node = fdtw_node_offset_by_compatible(dtb, "arm,tb_fw");
 	if (*node < 0) {
 		WARN("The compatible property `arm,tb_fw` not found in the config\n");
 		return -1;
@@ -260,3 +269,73 @@ int arm_set_dtb_mbedtls_heap_info(void *dtb, void *heap_addr, size_t heap_size)
 
 	return 0;
 }
+#endif /* !ARM_TB_FW_CONFIG_BLOB */
+
+/*******************************************************************************
+ * Helper to publish an image deferred to BL33 in the NT_FW_CONFIG DTB. The
+ * image is described by a subnode of the "arm,deferred_images" compatible
+ * node, which is created if needed:
+ *	deferred_images {
+ *		compatible = "arm,deferred_images";
+ *		image-<image_id> {
+ *			image_id  : size : 1 cell
+ *			fip_offset: size : 2 cells
+ *			size      : size : 2 cells
+ *			hash      : DER encoded DigestInfo, if authenticated
+ *		};
+ *	};
+ *
+ * Arguments:
+ *	void *dtb		 - pointer to the NT_FW_CONFIG in memory
+ *	size_t dtb_max_size	 - The size the DTB can be expanded to.
+ *	unsigned int image_id	 - The ID of the deferred image.
+ *	uint64_t fip_offset	 - The offset of the image in the FIP.
+ *	uint64_t size		 - The size of the image.
+ *	const void *hash	 - The hash of the image, or NULL.
+ *	unsigned int hash_len	 - The length of the hash.
+ *
+ * Returns 0 on success and -1 on error.
+ ******************************************************************************/
+int arm_dyn_add_deferred_image(void *dtb, size_t dtb_max_size,
+		unsigned int image_id, uint64_t fip_offset, uint64_t size,
+		const void *hash, unsigned int hash_len)
+{
+	char name[DEFERRED_IMAGE_NODE_NAME_LEN];
+	int parent, node, err;
+
+	assert(dtb != NULL);
+
+	if (fdt_open_into(dtb, dtb, (int)dtb_max_size) != 0) {
+		ERROR("Invalid NT_FW_CONFIG\n");
+		return -1;
+	}
+
+	parent = fdtw_node_offset_by_compatible(dtb, DEFERRED_IMAGES_COMPAT);
+	if (parent < 0) {
+		parent = fdt_add_subnode(dtb, 0, "deferred_images");
+		if ((parent < 0) || (fdt_setprop_string(dtb, parent,
+				"compatible", DEFERRED_IMAGES_COMPAT) != 0))
+			goto no_space;
+	}
+
+	(void)snprintf(name, sizeof(name), "image-%u", image_id);
+	node = fdt_add_subnode(dtb, parent, name);
+	if (node < 0)
+		goto no_space;
+
+	err = fdt_setprop_u32(dtb, node, "image_id", image_id);
+	err |= fdt_setprop_u64(dtb, node, "fip_offset", fip_offset);
+	err |= fdt_setprop_u64(dtb, node, "size", size);
+	if (hash != NULL)
+		err |= fdt_setprop(dtb, node, "hash", hash, (int)hash_len);
+	if (err != 0)
+		goto no_space;
+
+	(void)fdt_pack(dtb);
+
+	return 0;
+
+no_space:
+	ERROR("Unable to add deferred image %u to NT_FW_CONFIG\n", image_id);
+	return -1;
+}
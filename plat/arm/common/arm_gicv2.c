@@ -94,6 +94,11 @@ void plat_arm_gic_redistif_off(void)
 	return;
 }
 
+void plat_arm_gic_redistif_on_start(void)
+{
+	return;
+}
+
 
 /******************************************************************************
  * ARM common helper to save & restore the GICv3 on resume from system suspend.
@@ -22,6 +22,7 @@
 #pragma weak plat_arm_gic_cpuif_disable
 #pragma weak plat_arm_gic_pcpu_init
 #pragma weak plat_arm_gic_redistif_on
+#pragma weak plat_arm_gic_redistif_on_start
 #pragma weak plat_arm_gic_redistif_off
 
 /* The GICv3 driver only needs to be initialized in EL3 */
@@ -136,6 +137,16 @@ void plat_arm_gic_redistif_off(void)
 	gicv3_rdistif_off(plat_my_core_pos());
 }
 
+/******************************************************************************
+ * ARM common helper to start powering on the GIC redistributor interface, so
+ * that it powers up while the CPU does other work. plat_arm_gic_pcpu_init()
+ * then waits for it to be powered.
+ *****************************************************************************/
+void plat_arm_gic_redistif_on_start(void)
+{
+	gicv3_rdistif_on_start(plat_my_core_pos());
+}
+
 /******************************************************************************
  * ARM common helper to save & restore the GICv3 on resume from system suspend
  *****************************************************************************/
@@ -5,10 +5,16 @@
  */
 
 #include <arm_sip_svc.h>
+#include <boot_prof.h>
 #include <debug.h>
+#include <el3_prof.h>
+#include <lock_stats.h>
 #include <plat_arm.h>
 #include <pmf.h>
+#include <psci.h>
 #include <runtime_svc.h>
+#include <sip_batch.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <uuid.h>
 
@@ -18,12 +24,16 @@ DEFINE_SVC_UUID2(arm_sip_svc_uid,
 	0x556d75e2, 0x6033, 0xb54b, 0xb5, 0x75,
 	0x62, 0x79, 0xfd, 0x11, 0x37, 0xff);
 
-static int arm_sip_setup(void)
+#if SIP_BATCH
+/*
+ * All the calls can be batched except the state switch, which changes the
+ * state the caller returns to.
+ */
+static bool arm_sip_batch_allowed(uint32_t smc_fid)
 {
-	if (pmf_setup() != 0)
-		return 1;
-	return 0;
+	return smc_fid != ARM_SIP_SVC_EXE_STATE_SWITCH;
 }
+#endif
 
 /*
  * This function handles ARM defined SiP Calls
@@ -69,6 +79,149 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				(uint32_t) x4, handle);
 		}
 
+	case ARM_SIP_SVC_CPU_ON_BATCH: {
+		u_register_t on_mask;
+		int rc;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		rc = psci_cpu_on_batch(x1, x2, x3, x4, &on_mask);
+		SMC_RET2(handle, (u_register_t)(register_t)rc, on_mask);
+		}
+
+	case ARM_SIP_SVC_SET_LOG_LEVEL:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if (tf_log_set_module_level((unsigned int)x1,
+					    (unsigned int)x2) != 0)
+			SMC_RET1(handle, LOG_LEVEL_E_PARAM);
+
+		SMC_RET1(handle, SMC_OK);
+
+#if BOOT_PROFILING
+	case ARM_SIP_SVC_GET_BOOT_PROF: {
+		struct boot_prof_entry entry;
+		unsigned int num_entries;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if (boot_prof_get_entry((unsigned int)x1, &entry,
+					&num_entries) != 0)
+			SMC_RET2(handle, BOOT_PROF_E_PARAM, num_entries);
+
+		SMC_RET4(handle, SMC_OK, num_entries, entry.timestamp,
+			 (u_register_t)entry.stage |
+			 ((u_register_t)entry.event << 8) |
+			 ((u_register_t)entry.id << 32));
+		}
+#endif
+
+#if EL3_PROFILER
+	case ARM_SIP_SVC_EL3_PROF_START:
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		SMC_RET1(handle, (u_register_t)(register_t)el3_prof_start(x1));
+
+	case ARM_SIP_SVC_EL3_PROF_STOP: {
+		uint64_t lower_el_samples, lost_samples;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		el3_prof_stop(&lower_el_samples, &lost_samples);
+		SMC_RET3(handle, SMC_OK, lower_el_samples, lost_samples);
+		}
+
+	case ARM_SIP_SVC_EL3_PROF_READ: {
+		uint64_t s[EL3_PROF_READ_MAX] = {0};
+		unsigned int n;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		n = el3_prof_read(s, EL3_PROF_READ_MAX);
+		SMC_RET7(handle, n, s[0], s[1], s[2], s[3], s[4], s[5]);
+		}
+#endif
+
+#if ENABLE_LOCK_STATS
+	case ARM_SIP_SVC_GET_LOCK_STATS: {
+		lock_stats_t stats;
+		unsigned int num_locks;
+		u_register_t name = 0U;
+		unsigned int i;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if (lock_stats_get((unsigned int)x1, &stats, &num_locks) != 0)
+			SMC_RET2(handle, LOCK_STATS_E_PARAM, num_locks);
+
+		/* The first 8 characters of the name, little-endian */
+		for (i = 0U; (i < sizeof(name)) && (stats.name[i] != '\0');
+		     i++)
+			name |= (u_register_t)(uint8_t)stats.name[i] << (i * 8U);
+
+		SMC_RET6(handle, SMC_OK, num_locks, stats.acquisitions,
+			 stats.contended, stats.wait_ticks, name);
+		}
+#endif
+
+#if ENABLE_PSCI_STAT
+	case ARM_SIP_SVC_GET_PSCI_STATS: {
+		psci_stat_t stats[PLAT_MAX_PWR_LVL_STATES + 1U] = { {0U} };
+		unsigned int pwr_lvl, first;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if ((x2 >= PLAT_MAX_PWR_LVL_STATES) ||
+		    (psci_stat_get_pwr_domain((unsigned int)x1, &pwr_lvl,
+					      stats) != PSCI_E_SUCCESS))
+			SMC_RET3(handle, PSCI_STATS_E_PARAM,
+				 PSCI_NUM_PWR_DOMAINS, PLAT_MAX_PWR_LVL_STATES);
+
+		/* The entry past the last state stays zero */
+		first = (unsigned int)x2;
+		SMC_RET8(handle, SMC_OK, PSCI_NUM_PWR_DOMAINS,
+			 PLAT_MAX_PWR_LVL_STATES, pwr_lvl,
+			 stats[first].residency, stats[first].count,
+			 stats[first + 1U].residency, stats[first + 1U].count);
+		}
+#endif
+
+#if SIP_BATCH
+	case ARM_SIP_SVC_BATCH: {
+		unsigned int done;
+		int rc;
+
+		/* Allow calls from non-secure only */
+		if (!is_caller_non_secure(flags))
+			SMC_RET1(handle, SMC_UNK);
+
+		if (x1 > sip_batch_max_records())
+			SMC_RET2(handle, SIP_BATCH_E_PARAM,
+				 sip_batch_max_records());
+
+		rc = sip_batch_run(smc_fid, (unsigned int)x1,
+				   arm_sip_handler,
+				   arm_sip_batch_allowed, cookie, flags, &done);
+		SMC_RET2(handle, (u_register_t)(register_t)rc, done);
+		}
+#endif
+
 	case ARM_SIP_SVC_CALL_COUNT:
 		/* PMF calls */
 		call_count += PMF_NUM_SMC_CALLS;
@@ -76,6 +229,37 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+		/* Batched CPU_ON call */
+		call_count += 1;
+
+		/* Log level call */
+		call_count += 1;
+
+#if BOOT_PROFILING
+		/* Boot timeline call */
+		call_count += 1;
+#endif
+
+#if EL3_PROFILER
+		/* EL3 profiler calls */
+		call_count += 3;
+#endif
+
+#if ENABLE_LOCK_STATS
+		/* Lock statistics call */
+		call_count += 1;
+#endif
+
+#if ENABLE_PSCI_STAT
+		/* PSCI statistics call */
+		call_count += 1;
+#endif
+
+#if SIP_BATCH
+		/* Batch call */
+		call_count += 1;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
@@ -93,6 +277,44 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 
 }
 
+#if RT_SVC_FID_HANDLERS
+/* Calls that only return information, bound to the SiP handler as leaf calls */
+static const uint32_t arm_sip_leaf_fids[] = {
+	PMF_SMC_GET_TIMESTAMP_32,
+	PMF_SMC_GET_TIMESTAMP_64,
+#if BOOT_PROFILING
+	ARM_SIP_SVC_GET_BOOT_PROF,
+#endif
+#if ENABLE_LOCK_STATS
+	ARM_SIP_SVC_GET_LOCK_STATS,
+#endif
+#if ENABLE_PSCI_STAT
+	ARM_SIP_SVC_GET_PSCI_STATS,
+#endif
+};
+#endif /* RT_SVC_FID_HANDLERS */
+
+static int arm_sip_setup(void)
+{
+#if RT_SVC_FID_HANDLERS
+	unsigned int i;
+#endif
+
+	if (pmf_setup() != 0)
+		return 1;
+
+#if RT_SVC_FID_HANDLERS
+	for (i = 0U; i < ARRAY_SIZE(arm_sip_leaf_fids); i++) {
+		if (runtime_svc_register_leaf_fid(arm_sip_leaf_fids[i],
+						  arm_sip_handler) != 0)
+			WARN("Failed to bind SMC 0x%x to its handler\n",
+			     arm_sip_leaf_fids[i]);
+	}
+#endif
+
+	return 0;
+}
+
 
 /* Define a runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
@@ -137,6 +137,31 @@ int arm_execution_state_switch(unsigned int smc_fid,
 				DISABLE_ALL_EXCEPTIONS);
 	}
 
+	if (from_el2) {
+		/*
+		 * A hypervisor owns the state of EL1, so only EL2 is reset.
+		 * There is no need to rebuild the whole Non-secure context:
+		 * flip SCR_EL3.RW, set the entry point and reset SCTLR_EL2 as
+		 * cm_prepare_el3_exit() would do. The general purpose registers
+		 * are cleared as they would be for a new context.
+		 */
+		if (caller_64)
+			scr &= ~SCR_RW_BIT;
+		else
+			scr |= SCR_RW_BIT;
+
+		write_ctx_reg(el3_ctx, CTX_SCR_EL3, scr);
+		write_ctx_reg(el3_ctx, CTX_ELR_EL3, pc);
+		write_ctx_reg(el3_ctx, CTX_SPSR_EL3, spsr);
+
+		write_sctlr_el2(((endianness != 0U) ? SCTLR_EE_BIT : 0U) |
+				SCTLR_EL2_RES1);
+
+		zeromem(get_gpregs_ctx(ctx), sizeof(gp_regs_t));
+
+		SMC_RET2(handle, cookie_hi, cookie_lo);
+	}
+
 	/*
 	 * Use the context management library to re-initialize the existing
 	 * context with the execution state flipped. Since the library takes
@@ -81,6 +81,12 @@ endif
 $(eval $(call assert_boolean,CSS_USE_SCMI_SDS_DRIVER))
 $(eval $(call add_define,CSS_USE_SCMI_SDS_DRIVER))
 
+# The SDS region and the SCMI channel leave no room in the shared RAM for the
+# boot timeline
+ifeq (${CSS_USE_SCMI_SDS_DRIVER}-${BOOT_PROFILING},1-1)
+  $(error "BOOT_PROFILING is not supported with CSS_USE_SCMI_SDS_DRIVER=1")
+endif
+
 # Process CSS_NON_SECURE_UART flag
 # This undocumented build option is only to enable debug access to the UART
 # from non secure code, which is useful on some platforms.
@@ -136,6 +136,14 @@ typedef struct scmi_channel {
 	int is_initialized;
 } scmi_channel_t;
 
+/*
+ * Number of SCMI channels of the platform. The platform returns the
+ * information of each channel from plat_css_get_scmi_info().
+ */
+#ifndef PLAT_ARM_SCMI_CHANNEL_COUNT
+#define PLAT_ARM_SCMI_CHANNEL_COUNT		1
+#endif
+
 /* External Common API */
 void *scmi_init(scmi_channel_t *ch);
 int scmi_proto_msg_attr(void *p, uint32_t proto_id, uint32_t command_id,
@@ -147,6 +155,8 @@ int scmi_proto_version(void *p, uint32_t proto_id, uint32_t *version);
  * details on these commands.
  */
 int scmi_pwr_state_set(void *p, uint32_t domain_id, uint32_t scmi_pwr_state);
+void scmi_pwr_state_set_posted(void *p, uint32_t domain_id,
+						uint32_t scmi_pwr_state);
 int scmi_pwr_state_get(void *p, uint32_t domain_id, uint32_t *scmi_pwr_state);
 
 /*
@@ -161,7 +171,7 @@ int scmi_ap_core_set_reset_addr(void *p, uint64_t reset_addr, uint32_t attr);
 int scmi_ap_core_get_reset_addr(void *p, uint64_t *reset_addr, uint32_t *attr);
 
 /* API to get the platform specific SCMI channel information. */
-scmi_channel_plat_info_t *plat_css_get_scmi_info();
+scmi_channel_plat_info_t *plat_css_get_scmi_info(unsigned int channel_id);
 
 /* API to override default PSCI callbacks for platforms that support SCMI. */
 const plat_psci_ops_t *css_scmi_override_pm_ops(plat_psci_ops_t *ops);
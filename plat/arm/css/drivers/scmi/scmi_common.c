@@ -23,16 +23,33 @@
 
 
 /*
- * Private helper function to get exclusive access to SCMI channel.
+ * Private helper function to get exclusive access to SCMI channel. If the
+ * previous command was posted, wait for the SCP to complete it and check its
+ * status.
  */
 void scmi_get_channel(scmi_channel_t *ch)
 {
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	int ret;
+
 	assert(ch->lock);
 	scmi_lock_get(ch->lock);
 
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	/* Wait for the previous command to finish */
+	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
+		;
+
+	/* Read the response after the mailbox status */
+	dmbld();
+
+	if (SCMI_MSG_GET_TOKEN(mbx_mem->msg_header) == SCMI_POSTED_CMD_TOKEN) {
+		SCMI_PAYLOAD_RET_VAL1(mbx_mem->payload, ret);
+		if ((ret != SCMI_E_SUCCESS) && (ret != SCMI_E_QUEUED)) {
+			ERROR("SCMI posted command 0x%x returned 0x%x\n",
+				mbx_mem->msg_header, ret);
+			panic();
+		}
+	}
 }
 
 /*
@@ -70,6 +87,29 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbld();
 }
 
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP
+ * without waiting for the response, and release exclusive access to the
+ * channel. The response is checked by the next scmi_get_channel().
+ */
+void scmi_send_posted_command(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
+	assert(SCMI_MSG_GET_TOKEN(mbx_mem->msg_header) ==
+		SCMI_POSTED_CMD_TOKEN);
+
+	SCMI_MARK_CHANNEL_BUSY(mbx_mem->status);
+
+	/* Make the payload visible to SCP before ringing the doorbell */
+	dmbst();
+
+	ch->info->ring_doorbell(ch->info);
+
+	assert(ch->lock);
+	scmi_lock_release(ch->lock);
+}
+
 /*
  * Private helper function to release exclusive access to SCMI channel.
  */
@@ -166,6 +206,11 @@ void *scmi_init(scmi_channel_t *ch)
 
 	scmi_lock_init(ch->lock);
 
+	/* Don't mistake stale mailbox contents for a posted command */
+	assert(SCMI_IS_CHANNEL_FREE(
+			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->msg_header = 0U;
+
 	ch->is_initialized = 1;
 
 	ret = scmi_proto_version(ch, SCMI_PWR_DMN_PROTO_ID, &version);
@@ -50,6 +50,34 @@ int scmi_pwr_state_set(void *p, uint32_t domain_id,
 	return ret;
 }
 
+/*
+ * API to set the SCMI power domain power state without waiting for the SCP to
+ * acknowledge the command. This is meant for a CPU that is about to power
+ * down: a failure is reported when the channel is next used, by any CPU.
+ */
+void scmi_pwr_state_set_posted(void *p, uint32_t domain_id,
+					uint32_t scmi_pwr_state)
+{
+	mailbox_mem_t *mbx_mem;
+	uint32_t pwr_state_set_msg_flag = SCMI_PWR_STATE_SET_FLAG_ASYNC;
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+
+	validate_scmi_channel(ch);
+
+	scmi_get_channel(ch);
+
+	mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	mbx_mem->msg_header = SCMI_MSG_CREATE(SCMI_PWR_DMN_PROTO_ID,
+			SCMI_PWR_STATE_SET_MSG, SCMI_POSTED_CMD_TOKEN);
+	mbx_mem->len = SCMI_PWR_STATE_SET_MSG_LEN;
+	mbx_mem->flags = SCMI_FLAG_RESP_POLL;
+	SCMI_PAYLOAD_ARG3(mbx_mem->payload, pwr_state_set_msg_flag,
+						domain_id, scmi_pwr_state);
+
+	/* The channel is released once the command is sent */
+	scmi_send_posted_command(ch);
+}
+
 /*
  * API to get the SCMI power domain power state.
  */
@@ -9,6 +9,7 @@
 #include <css_def.h>
 #include <css_pm.h>
 #include <debug.h>
+#include <lock_stats.h>
 #include <plat_arm.h>
 #include <platform.h>
 #include <string.h>
@@ -62,15 +63,26 @@ typedef enum {
 } scmi_power_state_t;
 
 /*
- * The global handle for invoking the SCMI driver APIs after the driver
- * has been initialized.
+ * The handles for invoking the SCMI driver APIs after the driver has been
+ * initialized, one per SCMI channel. A CPU sends its requests on the channel
+ * given by plat_css_core_pos_to_scmi_channel(), so that CPUs using different
+ * channels don't contend for the same channel lock.
  */
-static void *scmi_handle;
+static void *scmi_handles[PLAT_ARM_SCMI_CHANNEL_COUNT];
 
-/* The SCMI channel global object */
-static scmi_channel_t channel;
+/* The SCMI channel global objects */
+static scmi_channel_t scmi_channels[PLAT_ARM_SCMI_CHANNEL_COUNT];
 
 ARM_SCMI_INSTANTIATE_LOCK;
+REGISTER_LOCK_STATS(scmi, arm_scmi_lock);
+
+#ifndef plat_css_core_pos_to_scmi_channel
+#define plat_css_core_pos_to_scmi_channel(core_pos)	\
+		((core_pos) % PLAT_ARM_SCMI_CHANNEL_COUNT)
+#endif
+
+#define get_scmi_handle()	\
+	scmi_handles[plat_css_core_pos_to_scmi_channel(plat_my_core_pos())]
 
 /*
  * Helper function to suspend a CPU power domain and its parent power domains
@@ -87,7 +99,7 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 	/* Check if power down at system power domain level is requested */
 	if (css_system_pwr_state(target_state) == ARM_LOCAL_STATE_OFF) {
 		/* Issue SCMI command for SYSTEM_SUSPEND */
-		ret = scmi_sys_pwr_state_set(scmi_handle,
+		ret = scmi_sys_pwr_state_set(get_scmi_handle(),
 				SCMI_SYS_PWR_FORCEFUL_REQ,
 				SCMI_SYS_PWR_SUSPEND);
 		if (ret != SCMI_E_SUCCESS) {
@@ -126,15 +138,13 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	/*
+	 * Don't wait for the SCP to acknowledge the command, the CPU is about
+	 * to power down. A failure is reported on the next use of the channel.
+	 */
+	scmi_pwr_state_set_posted(get_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
-
-	if (ret != SCMI_E_SUCCESS) {
-		ERROR("SCMI set power state command return 0x%x unexpected\n",
-				ret);
-		panic();
-	}
 #endif
 }
 
@@ -144,7 +154,7 @@ void css_scp_suspend(const struct psci_power_state *target_state)
  */
 void css_scp_off(const struct psci_power_state *target_state)
 {
-	int lvl = 0, ret;
+	int lvl = 0;
 	uint32_t scmi_pwr_state = 0;
 
 	/* At-least the CPU level should be specified to be OFF */
@@ -166,15 +176,10 @@ void css_scp_off(const struct psci_power_state *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	/* As for suspend, don't wait for the SCP to acknowledge the command */
+	scmi_pwr_state_set_posted(get_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[plat_my_core_pos()],
 		scmi_pwr_state);
-
-	if (ret != SCMI_E_QUEUED && ret != SCMI_E_SUCCESS) {
-		ERROR("SCMI set power state command return 0x%x unexpected\n",
-				ret);
-		panic();
-	}
 }
 
 /*
@@ -195,7 +200,7 @@ void css_scp_on(u_register_t mpidr)
 	core_pos = plat_core_pos_by_mpidr(mpidr);
 	assert(core_pos >= 0 && core_pos < PLATFORM_CORE_COUNT);
 
-	ret = scmi_pwr_state_set(scmi_handle,
+	ret = scmi_pwr_state_set(get_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[core_pos],
 		scmi_pwr_state);
 
@@ -226,7 +231,7 @@ int css_scp_get_power_state(u_register_t mpidr, unsigned int power_level)
 	cpu_idx = plat_core_pos_by_mpidr(mpidr);
 	assert(cpu_idx > -1);
 
-	ret = scmi_pwr_state_get(scmi_handle,
+	ret = scmi_pwr_state_get(get_scmi_handle(),
 		plat_css_core_pos_to_scmi_dmn_id_map[cpu_idx],
 		&scmi_pwr_state);
 
@@ -267,7 +272,7 @@ void __dead2 css_scp_system_off(int state)
 	 * Issue SCMI command. First issue a graceful
 	 * request and if that fails force the request.
 	 */
-	ret = scmi_sys_pwr_state_set(scmi_handle,
+	ret = scmi_sys_pwr_state_set(get_scmi_handle(),
 			SCMI_SYS_PWR_FORCEFUL_REQ,
 			state);
 
@@ -321,14 +326,18 @@ static int scmi_ap_core_init(scmi_channel_t *ch)
 
 void __init plat_arm_pwrc_setup(void)
 {
-	channel.info = plat_css_get_scmi_info();
-	channel.lock = ARM_SCMI_LOCK_GET_INSTANCE;
-	scmi_handle = scmi_init(&channel);
-	if (scmi_handle == NULL) {
-		ERROR("SCMI Initialization failed\n");
-		panic();
+	unsigned int i;
+
+	for (i = 0U; i < PLAT_ARM_SCMI_CHANNEL_COUNT; i++) {
+		scmi_channels[i].info = plat_css_get_scmi_info(i);
+		scmi_channels[i].lock = ARM_SCMI_LOCK_GET_INSTANCE(i);
+		scmi_handles[i] = scmi_init(&scmi_channels[i]);
+		if (scmi_handles[i] == NULL) {
+			ERROR("SCMI Initialization failed\n");
+			panic();
+		}
 	}
-	if (scmi_ap_core_init(&channel) < 0) {
+	if (scmi_ap_core_init(&scmi_channels[0]) < 0) {
 		ERROR("SCMI AP core protocol initialization failed\n");
 		panic();
 	}
@@ -344,10 +353,10 @@ const plat_psci_ops_t *css_scmi_override_pm_ops(plat_psci_ops_t *ops)
 	uint32_t msg_attr;
 	int ret;
 
-	assert(scmi_handle);
+	assert(scmi_handles[0] != NULL);
 
 	/* Check that power domain POWER_STATE_SET message is supported */
-	ret = scmi_proto_msg_attr(scmi_handle, SCMI_PWR_DMN_PROTO_ID,
+	ret = scmi_proto_msg_attr(get_scmi_handle(), SCMI_PWR_DMN_PROTO_ID,
 				SCMI_PWR_STATE_SET_MSG, &msg_attr);
 	if (ret != SCMI_E_SUCCESS) {
 		ERROR("Set power state command is not supported by SCMI\n");
@@ -358,13 +367,13 @@ const plat_psci_ops_t *css_scmi_override_pm_ops(plat_psci_ops_t *ops)
 	 * Don't support PSCI NODE_HW_STATE call if SCMI doesn't support
 	 * POWER_STATE_GET message.
 	 */
-	ret = scmi_proto_msg_attr(scmi_handle, SCMI_PWR_DMN_PROTO_ID,
+	ret = scmi_proto_msg_attr(get_scmi_handle(), SCMI_PWR_DMN_PROTO_ID,
 				SCMI_PWR_STATE_GET_MSG, &msg_attr);
 	if (ret != SCMI_E_SUCCESS)
 		ops->get_node_hw_state = NULL;
 
 	/* Check if the SCMI SYSTEM_POWER_STATE_SET message is supported */
-	ret = scmi_proto_msg_attr(scmi_handle, SCMI_SYS_PWR_PROTO_ID,
+	ret = scmi_proto_msg_attr(get_scmi_handle(), SCMI_SYS_PWR_PROTO_ID,
 				SCMI_SYS_PWR_STATE_SET_MSG, &msg_attr);
 	if (ret != SCMI_E_SUCCESS) {
 		/* System power management operations are not supported */
@@ -409,8 +418,8 @@ void plat_arm_program_trusted_mailbox(uintptr_t address)
 {
 	int ret;
 
-	assert(scmi_handle);
-	ret = scmi_ap_core_set_reset_addr(scmi_handle, address,
+	assert(scmi_handles[0] != NULL);
+	ret = scmi_ap_core_set_reset_addr(get_scmi_handle(), address,
 		SCMI_AP_CORE_LOCK_ATTR);
 	if (ret != SCMI_E_SUCCESS) {
 		ERROR("CSS: Failed to program reset address: %d\n", ret);
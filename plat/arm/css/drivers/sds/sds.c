@@ -25,6 +25,19 @@ static uintptr_t sds_mem_base;
 /* Size of the SDS memory region in bytes */
 static size_t sds_mem_size;
 
+/*
+ * Offsets of the structure headers from the base of the SDS memory region,
+ * indexed by structure ID, recorded when the headers are validated. An offset
+ * of 0 means that no structure with this ID was found. Structures with an ID
+ * above SDS_INDEX_MAX_ID are looked up by walking the headers.
+ */
+#define SDS_INDEX_MAX_ID	15U
+
+static uint32_t sds_struct_offset[SDS_INDEX_MAX_ID + 1U];
+
+/* Number of structures in the SDS memory region when it was indexed */
+static unsigned int sds_indexed_count;
+
 /*
  * Perform some non-exhaustive tests to determine whether any of the fields
  * within a Structure Header contain obviously invalid data.
@@ -53,14 +66,17 @@ static int sds_struct_is_valid(uintptr_t header)
 }
 
 /*
- * Validate the SDS structure headers.
+ * Validate the SDS structure headers, and index them by structure ID.
  * Returns SDS_OK on success, SDS_ERR_FAIL on error.
  */
 static int validate_sds_struct_headers(void)
 {
-	unsigned int i, structure_count;
+	unsigned int i, id, structure_count;
 	uintptr_t header;
 
+	memset(sds_struct_offset, 0, sizeof(sds_struct_offset));
+	sds_indexed_count = 0;
+
 	structure_count = GET_SDS_REGION_STRUCTURE_COUNT(sds_mem_base);
 
 	if (structure_count == 0)
@@ -74,8 +90,17 @@ static int validate_sds_struct_headers(void)
 			WARN("SDS: Invalid structure header detected\n");
 			return SDS_ERR_FAIL;
 		}
+
+		/* Keep the first structure of each ID, as the lookup does */
+		id = GET_SDS_HEADER_ID(header);
+		if ((id <= SDS_INDEX_MAX_ID) && (sds_struct_offset[id] == 0U))
+			sds_struct_offset[id] = (uint32_t)(header - sds_mem_base);
+
 		header += GET_SDS_HEADER_STRUCT_SIZE(header) + SDS_HEADER_SIZE;
 	}
+
+	sds_indexed_count = structure_count;
+
 	return SDS_OK;
 }
 
@@ -94,6 +119,22 @@ static int get_struct_header(uint32_t structure_id, struct_header_t **header)
 	if (structure_count == 0)
 		return SDS_ERR_STRUCT_NOT_FOUND;
 
+	/*
+	 * Use the index unless structures were added to the region since it
+	 * was built.
+	 */
+	if ((structure_id <= SDS_INDEX_MAX_ID) &&
+	    (structure_count == sds_indexed_count)) {
+		if (sds_struct_offset[structure_id] == 0U) {
+			*header = NULL;
+			return SDS_ERR_STRUCT_NOT_FOUND;
+		}
+
+		*header = (struct_header_t *)(sds_mem_base +
+				sds_struct_offset[structure_id]);
+		return SDS_OK;
+	}
+
 	current_header = ((uintptr_t)sds_mem_base) + SDS_REGION_DESC_SIZE;
 
 	/* Iterate over structure headers to find one with a matching ID */
@@ -225,7 +266,7 @@ int sds_struct_write(uint32_t structure_id, unsigned int fld_off,
 
 /*
  * Initialize the SDS driver. Also verifies the SDS version and sanity of
- * the SDS structure headers.
+ * the SDS structure headers, and indexes them by structure ID.
  * Returns SDS_OK on success, SDS_ERR_FAIL on error.
  */
 int sds_init(void)
@@ -32,8 +32,11 @@ static scmi_channel_plat_info_t sgi_clark_scmi_plat_info = {
 		.ring_doorbell = &mhuv2_ring_doorbell,
 };
 
-scmi_channel_plat_info_t *plat_css_get_scmi_info()
+scmi_channel_plat_info_t *plat_css_get_scmi_info(unsigned int channel_id)
 {
+	/* There is a single SCMI channel */
+	assert(channel_id == 0U);
+
 	if (sgi_plat_info.platform_id == SGI_CLARK_SID_VER_PART_NUM)
 		return &sgi_clark_scmi_plat_info;
 	else if (sgi_plat_info.platform_id == SGI575_SSC_VER_PART_NUM)
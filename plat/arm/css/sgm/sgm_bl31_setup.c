@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <plat_arm.h>
@@ -19,8 +20,11 @@ static scmi_channel_plat_info_t sgm775_scmi_plat_info = {
 		.ring_doorbell = &mhu_ring_doorbell,
 };
 
-scmi_channel_plat_info_t *plat_css_get_scmi_info()
+scmi_channel_plat_info_t *plat_css_get_scmi_info(unsigned int channel_id)
 {
+	/* There is a single SCMI channel */
+	assert(channel_id == 0U);
+
 	return &sgm775_scmi_plat_info;
 }
 
@@ -7,6 +7,13 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <console.h>
+#if DSU_L3_PARTITIONING
+#include <dsu_partition.h>
+#endif
+#if MPAM_WORLD_PARTID
+#include <ep_info.h>
+#include <mpam.h>
+#endif
 #include <platform.h>
 #if RAS_EXTENSION
 #include <ras.h>
@@ -25,6 +32,16 @@
 #pragma weak plat_sdei_validate_entry_point
 #endif
 
+#if MPAM_WORLD_PARTID
+#pragma weak plat_mpam_msc_setup
+#pragma weak plat_mpam_get_partid_pmg
+#pragma weak plat_mpam_get_sp_partid_pmg
+#endif
+
+#if DSU_L3_PARTITIONING
+#pragma weak plat_dsu_get_partition_config
+#endif
+
 #pragma weak plat_ea_handler
 
 void bl31_plat_runtime_setup(void)
@@ -67,6 +84,45 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode)
 }
 #endif
 
+#if MPAM_WORLD_PARTID
+/*
+ * Default function to configure the MPAM memory system components, which
+ * leaves them in their reset configuration.
+ */
+void plat_mpam_msc_setup(void)
+{
+}
+
+/*
+ * Default function to select the MPAM partition of each world, which assigns
+ * both worlds to the default partition.
+ */
+uint64_t plat_mpam_get_partid_pmg(unsigned int security_state)
+{
+	return MPAM_PARTID_PMG(0U, 0U);
+}
+
+/*
+ * Default function to select the MPAM partition of a secure partition, which
+ * is the partition of the Secure world.
+ */
+uint64_t plat_mpam_get_sp_partid_pmg(unsigned int sp_index)
+{
+	return plat_mpam_get_partid_pmg(SECURE);
+}
+#endif
+
+#if DSU_L3_PARTITIONING
+/*
+ * Default function to configure the L3 partitioning of the DSU, which leaves
+ * the whole L3 cache shared by both worlds.
+ */
+const dsu_partition_config_t *plat_dsu_get_partition_config(void)
+{
+	return NULL;
+}
+#endif
+
 /* RAS functions common to AArch64 ARM platforms */
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
@@ -25,6 +25,7 @@
 #pragma weak bl1_plat_fwu_done
 #pragma weak bl1_plat_handle_pre_image_load
 #pragma weak bl1_plat_handle_post_image_load
+#pragma weak bl1_plat_is_warm_resume
 
 
 unsigned int bl1_plat_get_next_image_id(void)
@@ -44,6 +45,12 @@ int bl1_plat_handle_pre_image_load(unsigned int image_id)
 	return 0;
 }
 
+int bl1_plat_is_warm_resume(void)
+{
+	/* Treat every reset as a cold reset by default. */
+	return 0;
+}
+
 /*
  * Following is the default definition that always
  * returns BL2 image details.
@@ -24,6 +24,8 @@
 #pragma weak bl2_plat_preload_setup
 #pragma weak bl2_plat_handle_pre_image_load
 #pragma weak bl2_plat_handle_post_image_load
+#pragma weak bl2_plat_handle_deferred_image
+#pragma weak bl2_plat_get_image_split
 #pragma weak plat_try_next_boot_source
 #pragma weak plat_get_mbedtls_heap
 
@@ -51,6 +53,18 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 	return 0;
 }
 
+int bl2_plat_handle_deferred_image(unsigned int image_id, const void *hash,
+				   unsigned int hash_len)
+{
+	WARN("BL2: Deferred image id %u is not published\n", image_id);
+	return 0;
+}
+
+image_split_t *bl2_plat_get_image_split(unsigned int image_id)
+{
+	return NULL;
+}
+
 int plat_try_next_boot_source(void)
 {
 	return 0;
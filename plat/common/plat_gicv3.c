@@ -186,12 +186,12 @@ unsigned int plat_ic_get_running_priority(void)
 
 int plat_ic_is_spi(unsigned int id)
 {
-	return (id >= MIN_SPI_ID) && (id <= MAX_SPI_ID);
+	return ((id >= MIN_SPI_ID) && (id <= MAX_SPI_ID)) || IS_ESPI(id);
 }
 
 int plat_ic_is_ppi(unsigned int id)
 {
-	return (id >= MIN_PPI_ID) && (id < MIN_SPI_ID);
+	return ((id >= MIN_PPI_ID) && (id < MIN_SPI_ID)) || IS_EPPI(id);
 }
 
 int plat_ic_is_sgi(unsigned int id)
@@ -17,6 +17,7 @@
 #include <mmio.h>
 #include <platform_def.h>
 #include <semihosting.h>	/* For FOPEN_MODE_... */
+#include <stdint.h>
 #include <string.h>
 #include <ufs.h>
 
@@ -50,6 +51,8 @@ static const io_block_dev_spec_t ufs_dev_spec = {
 		.write	= ufs_write_lun3_blks,
 	},
 	.block_size	= UFS_BLOCK_SIZE,
+	/* ufs_read_blocks_queued() splits the requests itself */
+	.max_direct_read = SIZE_MAX,
 };
 
 static const io_uuid_spec_t scp_bl2_uuid_spec = {
@@ -274,7 +277,7 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 
 size_t ufs_read_lun3_blks(int lba, uintptr_t buf, size_t size)
 {
-	return ufs_read_blocks(3, lba, buf, size);
+	return ufs_read_blocks_queued(3, lba, buf, size);
 }
 
 size_t ufs_write_lun3_blks(int lba, const uintptr_t buf, size_t size)
@@ -5,87 +5,101 @@
  * https://spdx.org/licenses
  */
 
+#include <arch_helpers.h>
+#include <assert.h>
+#include <cassert.h>
+#include <errno.h>
 #include <mmio.h>
 #include <mss_mem.h>
 #include <platform.h>
 #include <plat_pm_trace.h>
+#include <stddef.h>
 
 #ifdef PM_TRACE_ENABLE
 
-/* core trace APIs */
-core_trace_func funcTbl[PLATFORM_CORE_COUNT] = {
-	pm_core_0_trace,
-	pm_core_1_trace,
-	pm_core_2_trace,
-	pm_core_3_trace};
+CASSERT((PM_TRACE_RING_ENTRIES & (PM_TRACE_RING_ENTRIES - 1)) == 0,
+	assert_pm_trace_ring_entries_power_of_two);
+
+/* trace ring of each core, only written by that core */
+static struct pm_trace_ring {
+	struct pm_trace_ring_entry entries[PM_TRACE_RING_ENTRIES];
+	/* number of entries added since boot, wraps around */
+	unsigned int count;
+} pm_trace_rings[PLATFORM_CORE_COUNT];
 
 /*****************************************************************************
- * pm_core0_trace
- * pm_core1_trace
- * pm_core2_trace
- * pm_core_3trace
+ * pm_trace_add
  *
- * This functions set trace info into core cyclic trace queue in MSS SRAM
- * memory space
+ * This function sets trace info into the core cyclic trace queue in MSS SRAM
+ * memory space and into the core trace ring, with a generic counter time
+ * stamp. Once the ring is full the oldest entry is overwritten.
  *****************************************************************************
  */
-void pm_core_0_trace(unsigned int trace)
+void pm_trace_add(unsigned int trace, unsigned int core)
 {
-	unsigned int current_position_core_0 =
-			mmio_read_32(AP_MSS_ATF_CORE_0_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_0_INFO_BASE  +
-		     (current_position_core_0 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_0_INFO_TRACE +
-		     (current_position_core_0 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_0_CTRL_BASE,
-		     ((current_position_core_0 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
-}
+	uintptr_t ctrl, info;
+	struct pm_trace_ring *ring;
+	struct pm_trace_ring_entry *entry;
+	unsigned int current_position, mss_timestamp;
 
-void pm_core_1_trace(unsigned int trace)
-{
-	unsigned int current_position_core_1 =
-			mmio_read_32(AP_MSS_ATF_CORE_1_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_1_INFO_BASE +
-		     (current_position_core_1 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_1_INFO_TRACE +
-		     (current_position_core_1 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_1_CTRL_BASE,
-		     ((current_position_core_1 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
-}
+	assert(core < PLATFORM_CORE_COUNT);
 
-void pm_core_2_trace(unsigned int trace)
-{
-	unsigned int current_position_core_2 =
-			mmio_read_32(AP_MSS_ATF_CORE_2_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_2_INFO_BASE +
-		     (current_position_core_2 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_2_INFO_TRACE +
-		     (current_position_core_2 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_2_CTRL_BASE,
-		     ((current_position_core_2 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
+	ctrl = AP_MSS_ATF_CORE_CTRL_BASE + core * AP_MSS_ATF_CORE_CTRL_STRIDE;
+	current_position = mmio_read_32(ctrl);
+	info = AP_MSS_ATF_CORE_INFO_BASE + core * AP_MSS_ATF_CORE_INFO_STRIDE +
+	       current_position * AP_MSS_ATF_CORE_ENTRY_SIZE;
+	mss_timestamp = mmio_read_32(AP_MSS_TIMER_BASE);
+
+	mmio_write_32(info + offsetof(struct pm_trace_entry, timestamp),
+		      mss_timestamp);
+	mmio_write_32(info + offsetof(struct pm_trace_entry, trace_info),
+		      trace);
+	mmio_write_32(ctrl, (current_position + 1) & AP_MSS_ATF_TRACE_SIZE_MASK);
+
+	ring = &pm_trace_rings[core];
+
+	entry = &ring->entries[ring->count & (PM_TRACE_RING_ENTRIES - 1)];
+	entry->timestamp = read_cntpct_el0();
+	entry->mss_timestamp = mss_timestamp;
+	entry->trace_info = trace;
+
+	/* Publish the entry before the count that makes it readable */
+	dmbishst();
+	ring->count++;
 }
 
-void pm_core_3_trace(unsigned int trace)
+/*****************************************************************************
+ * pm_trace_read
+ *
+ * This function copies entry number seq of the trace ring of a core into
+ * entry and returns the number of entries added to the ring in count. It
+ * returns 0 on success, -EINVAL for an invalid core and -ENOENT if the entry
+ * hasn't been added yet or has already been overwritten. The entry can be
+ * added by its core while it is read, so the count is read again afterwards
+ * to check that the entry wasn't overwritten in the meantime.
+ *****************************************************************************
+ */
+int pm_trace_read(unsigned int core, unsigned int seq,
+		  struct pm_trace_ring_entry *entry, unsigned int *count)
 {
-	unsigned int current_position_core_3 =
-			mmio_read_32(AP_MSS_ATF_CORE_3_CTRL_BASE);
-	mmio_write_32((AP_MSS_ATF_CORE_3_INFO_BASE +
-		     (current_position_core_3 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     mmio_read_32(AP_MSS_TIMER_BASE));
-	mmio_write_32((AP_MSS_ATF_CORE_3_INFO_TRACE +
-		     (current_position_core_3 * AP_MSS_ATF_CORE_ENTRY_SIZE)),
-		     trace);
-	mmio_write_32(AP_MSS_ATF_CORE_3_CTRL_BASE,
-		     ((current_position_core_3 + 1) &
-		     AP_MSS_ATF_TRACE_SIZE_MASK));
+	struct pm_trace_ring *ring;
+
+	if (core >= PLATFORM_CORE_COUNT)
+		return -EINVAL;
+
+	ring = &pm_trace_rings[core];
+
+	*count = ring->count;
+	dmbishld();
+	if ((*count - seq - 1U) >= PM_TRACE_RING_ENTRIES)
+		return -ENOENT;
+
+	*entry = ring->entries[seq & (PM_TRACE_RING_ENTRIES - 1)];
+	dmbishld();
+	*count = ring->count;
+	if ((*count - seq - 1U) >= PM_TRACE_RING_ENTRIES)
+		return -ENOENT;
+
+	return 0;
 }
 #endif /* PM_TRACE_ENABLE */
@@ -8,8 +8,10 @@
 #include <ap_setup.h>
 #include <cache_llc.h>
 #include <debug.h>
+#include <errno.h>
 #include <marvell_plat_priv.h>
 #include <plat_marvell.h>
+#include <plat_pm_trace.h>
 #include <runtime_svc.h>
 #include <smccc.h>
 #include "comphy/phy-comphy-cp110.h"
@@ -33,6 +35,7 @@
 #define MV_SIP_LLC_ENABLE	0x82000011
 #define MV_SIP_PMU_IRQ_ENABLE	0x82000012
 #define MV_SIP_PMU_IRQ_DISABLE	0x82000013
+#define MV_SIP_PM_TRACE_READ	0x82000014
 
 #define MAX_LANE_NR		6
 #define MVEBU_COMPHY_OFFSET	0x441000
@@ -54,6 +57,11 @@ uintptr_t mrvl_sip_smc_handler(uint32_t smc_fid,
 {
 	u_register_t ret;
 	int i;
+#ifdef PM_TRACE_ENABLE
+	struct pm_trace_ring_entry entry;
+	unsigned int count;
+	int err;
+#endif
 
 	debug("%s: got SMC (0x%x) x1 0x%lx, x2 0x%lx, x3 0x%lx\n",
 						 __func__, smc_fid, x1, x2, x3);
@@ -120,6 +128,18 @@ uintptr_t mrvl_sip_smc_handler(uint32_t smc_fid,
 		mvebu_pmu_interrupt_disable();
 		SMC_RET1(handle, 0);
 #endif
+#ifdef PM_TRACE_ENABLE
+	case MV_SIP_PM_TRACE_READ:
+		/* x1: core, x2: entry sequence number */
+		err = pm_trace_read(x1, x2, &entry, &count);
+		if (err == -EINVAL)
+			SMC_RET1(handle, SMC_UNK);
+		if (err != 0)
+			SMC_RET5(handle, err, 0, 0, 0, count);
+
+		SMC_RET5(handle, 0, entry.timestamp, entry.trace_info,
+			 entry.mss_timestamp, count);
+#endif
 
 	default:
 		ERROR("%s: unhandled SMC (0x%x)\n", __func__, smc_fid);
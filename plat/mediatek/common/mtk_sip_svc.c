@@ -10,6 +10,7 @@
 #include <mtk_plat_common.h>
 #include <mtk_sip_svc.h>
 #include <plat_sip_calls.h>
+#include <power_tracer.h>
 #include <runtime_svc.h>
 #include <uuid.h>
 
@@ -66,6 +67,17 @@ uintptr_t mediatek_sip_handler(uint32_t smc_fid,
 			SMC_RET1(handle, ret);
 		}
 #endif
+#if ENABLE_PMF
+		case MTK_SIP_GET_POWER_FLOW_TIMESTAMP: {
+			/* x1: mpidr, x2: power tracer mode */
+			unsigned long long ts;
+
+			if (get_power_flow_timestamp(x1, x2, &ts) != 0)
+				SMC_RET1(handle, MTK_SIP_E_INVALID_PARAM);
+
+			SMC_RET2(handle, MTK_SIP_E_SUCCESS, ts);
+		}
+#endif
 #if MTK_SIP_KERNEL_BOOT_ENABLE
 		case MTK_SIP_KERNEL_BOOT_AARCH32:
 			boot_to_kernel(x1, x2, x3, x4);
@@ -21,10 +21,11 @@
 #define SMC_AARCH64_BIT		0x40000000
 
 /* Number of Mediatek SiP Calls implemented */
-#define MTK_COMMON_SIP_NUM_CALLS	4
+#define MTK_COMMON_SIP_NUM_CALLS	5
 
 /* Mediatek SiP Service Calls function IDs */
 #define MTK_SIP_SET_AUTHORIZED_SECURE_REG	0x82000001
+#define MTK_SIP_GET_POWER_FLOW_TIMESTAMP	0xC2000002
 
 /* For MTK SMC from Secure OS */
 /* 0x82000000 - 0x820000FF & 0xC2000000 - 0xC20000FF */
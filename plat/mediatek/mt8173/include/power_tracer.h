@@ -14,6 +14,15 @@
 #define CLUSTER_DOWN	4
 #define CLUSTER_SUSPEND	5
 
+/*
+ * The time-stamp of the last transition of each mode is kept for each CPU
+ * with PMF, under the platform service ID, with the mode as the time-stamp
+ * ID. It is recorded for the CPU doing the transition.
+ */
+#define POWER_TRACER_TOTAL_IDS	6
+
 void trace_power_flow(unsigned long mpidr, unsigned char mode);
+int get_power_flow_timestamp(unsigned long mpidr, unsigned int mode,
+			     unsigned long long *ts);
 
 #endif /* POWER_TRACER_H */
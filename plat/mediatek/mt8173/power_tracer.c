@@ -5,13 +5,43 @@
  */
 
 #include <arch.h>
+#include <assert.h>
 #include <debug.h>
+#include <errno.h>
+#include <pmf.h>
 #include <power_tracer.h>
 
-#define trace_log(...)  INFO("psci: " __VA_ARGS__)
+#define trace_log(...)  VERBOSE("psci: " __VA_ARGS__)
+
+PMF_REGISTER_SERVICE_SMC(power_tracer, PMF_PLAT_SVC_ID,
+			 POWER_TRACER_TOTAL_IDS, PMF_STORE_ENABLE)
+
+#if ENABLE_PMF
+/*
+ * Return in `ts` the time-stamp of the last transition of `mode` done by the
+ * CPU `mpidr`, or 0 if there was none. The caches may be off when the
+ * time-stamp is captured, so the line is invalidated before it is read.
+ */
+int get_power_flow_timestamp(unsigned long mpidr, unsigned int mode,
+			     unsigned long long *ts)
+{
+	if (mode >= POWER_TRACER_TOTAL_IDS) {
+		*ts = 0;
+		return -EINVAL;
+	}
+
+	return pmf_get_timestamp_smc((PMF_PLAT_SVC_ID << PMF_SVC_ID_SHIFT) |
+				     mode, mpidr, PMF_CACHE_MAINT, ts);
+}
+#endif
 
 void trace_power_flow(unsigned long mpidr, unsigned char mode)
 {
+	assert(mode < POWER_TRACER_TOTAL_IDS);
+
+	/* The caches may be off, so write the time-stamp to memory */
+	PMF_CAPTURE_TIMESTAMP(power_tracer, mode, PMF_CACHE_MAINT);
+
 	switch (mode) {
 	case CPU_UP:
 		trace_log("core %lld:%lld ON\n",
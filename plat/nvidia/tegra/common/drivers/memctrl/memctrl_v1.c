@@ -6,6 +6,7 @@
 
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cdefs.h>
 #include <debug.h>
 #include <memctrl.h>
 #include <memctrl_v1.h>
@@ -127,8 +128,11 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
  *
  * phys_base = physical base of aperture
  * size_in_bytes = size of aperture in bytes
+ * max_clear = ignored, the old aperture is always cleared in one call
  */
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
+int32_t tegra_memctrl_videomem_setup(uint64_t phys_base,
+				     uint32_t size_in_bytes,
+				     uint64_t max_clear __unused)
 {
 	uintptr_t vmem_end_old = video_mem_base + (video_mem_size << 20);
 	uintptr_t vmem_end_new = phys_base + size_in_bytes;
@@ -177,6 +181,8 @@ done:
 	/* store new values */
 	video_mem_base = phys_base;
 	video_mem_size = size_in_bytes >> 20;
+
+	return 0;
 }
 
 /*
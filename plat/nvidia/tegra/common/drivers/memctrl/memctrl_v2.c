@@ -8,21 +8,39 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <debug.h>
+#include <errno.h>
 #include <mce.h>
 #include <memctrl.h>
 #include <memctrl_v2.h>
 #include <mmio.h>
 #include <smmu.h>
+#include <stdbool.h>
 #include <string.h>
 #include <tegra_def.h>
 #include <tegra_platform.h>
 #include <utils.h>
+#include <utils_def.h>
 #include <xlat_tables_v2.h>
 
 /* Video Memory base and size (live values) */
 static uint64_t video_mem_base;
 static uint64_t video_mem_size_mb;
 
+/*
+ * Video Memory carveout being programmed, while the old regions it exposes
+ * are cleared over several calls
+ */
+static bool vmem_resize_pending;
+static uint64_t vmem_resize_base;
+static uint32_t vmem_resize_size;
+
+/* Old regions still to be cleared before the new carveout is programmed */
+static struct {
+	uintptr_t base;
+	uint64_t size;
+} vmem_clear_areas[2];
+static unsigned int vmem_clear_count;
+
 static void tegra_memctrl_reconfig_mss_clients(void)
 {
 #if ENABLE_ROC_FOR_ORDERING_CLIENT_REQUESTS
@@ -590,18 +608,78 @@ static void tegra_clear_videomem(uintptr_t non_overlap_area_start,
 		non_overlap_area_size);
 }
 
+static void tegra_add_videomem_clear_area(uintptr_t base, uint64_t size)
+{
+	assert(vmem_clear_count < ARRAY_SIZE(vmem_clear_areas));
+
+	vmem_clear_areas[vmem_clear_count].base = base;
+	vmem_clear_areas[vmem_clear_count].size = size;
+	vmem_clear_count++;
+}
+
+/*
+ * Clear at most max_clear bytes of the old regions still to be cleared, or
+ * all of them if max_clear is 0. Returns true once all of them are cleared.
+ */
+static bool tegra_clear_videomem_areas(uint64_t max_clear)
+{
+	uint64_t budget = round_up(max_clear, (uint64_t)1 << 20);
+	uint64_t chunk;
+	unsigned int index;
+
+	while (vmem_clear_count > 0U) {
+		index = vmem_clear_count - 1U;
+		chunk = vmem_clear_areas[index].size;
+
+		if (max_clear != 0U) {
+			if (budget == 0U)
+				return false;
+
+			chunk = MIN(chunk, budget);
+			budget -= chunk;
+		}
+
+		tegra_clear_videomem(vmem_clear_areas[index].base, chunk);
+
+		vmem_clear_areas[index].base += chunk;
+		vmem_clear_areas[index].size -= chunk;
+		if (vmem_clear_areas[index].size == 0U)
+			vmem_clear_count--;
+	}
+
+	return true;
+}
+
 /*
  * Program the Video Memory carveout region
  *
  * phys_base = physical base of aperture
  * size_in_bytes = size of aperture in bytes
+ * max_clear = most bytes of the old aperture to clear in this call, or 0
+ *	       to clear all of them
+ *
+ * Returns -EAGAIN when the old aperture still has to be cleared, in which
+ * case the call has to be repeated with the same aperture to resume the
+ * clearing until it returns 0. The old aperture stays protected until then.
+ * Returns -EBUSY if the call is for another aperture.
  */
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
+int32_t tegra_memctrl_videomem_setup(uint64_t phys_base,
+				     uint32_t size_in_bytes,
+				     uint64_t max_clear)
 {
 	uintptr_t vmem_end_old = video_mem_base + (video_mem_size_mb << 20);
 	uintptr_t vmem_end_new = phys_base + size_in_bytes;
 	unsigned long long non_overlap_area_size;
 
+	/* Resume the clearing of the old regions of a previous call */
+	if (vmem_resize_pending) {
+		if ((phys_base != vmem_resize_base) ||
+		    (size_in_bytes != vmem_resize_size))
+			return -EBUSY;
+
+		goto clear;
+	}
+
 	/*
 	 * Setup the Memory controller to restrict CPU accesses to the Video
 	 * Memory region
@@ -634,19 +712,31 @@ void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes)
 	INFO("Cleaning previous Video Memory Carveout\n");
 
 	if (phys_base > vmem_end_old || video_mem_base > vmem_end_new) {
-		tegra_clear_videomem(video_mem_base,
-				     (uint64_t)video_mem_size_mb << 20);
+		tegra_add_videomem_clear_area(video_mem_base,
+				(uint64_t)video_mem_size_mb << 20);
 	} else {
 		if (video_mem_base < phys_base) {
 			non_overlap_area_size = phys_base - video_mem_base;
-			tegra_clear_videomem(video_mem_base, non_overlap_area_size);
+			tegra_add_videomem_clear_area(video_mem_base,
+						      non_overlap_area_size);
 		}
 		if (vmem_end_old > vmem_end_new) {
 			non_overlap_area_size = vmem_end_old - vmem_end_new;
-			tegra_clear_videomem(vmem_end_new, non_overlap_area_size);
+			tegra_add_videomem_clear_area(vmem_end_new,
+						      non_overlap_area_size);
 		}
 	}
 
+	vmem_resize_base = phys_base;
+	vmem_resize_size = size_in_bytes;
+	vmem_resize_pending = true;
+
+clear:
+	if (!tegra_clear_videomem_areas(max_clear))
+		return -EAGAIN;
+
+	vmem_resize_pending = false;
+
 done:
 	/* program the Videomem aperture */
 	tegra_mc_write_32(MC_VIDEO_PROTECT_BASE_LO, (uint32_t)phys_base);
@@ -666,6 +756,8 @@ done:
 	 * CCPLEX.
 	 */
 	mce_update_gsc_videomem();
+
+	return 0;
 }
 
 /*
@@ -25,4 +25,5 @@ BL31_SOURCES		+= 	drivers/console/aarch64/console.S		\
 				${COMMON_DIR}/tegra_platform.c			\
 				${COMMON_DIR}/tegra_pm.c			\
 				${COMMON_DIR}/tegra_sip_calls.c			\
-				${COMMON_DIR}/tegra_topology.c
+				${COMMON_DIR}/tegra_topology.c			\
+				plat/common/plat_psci_common.c
@@ -45,6 +45,7 @@ uint8_t tegra_fake_system_suspend;
 #pragma weak tegra_soc_prepare_system_reset
 #pragma weak tegra_soc_prepare_system_off
 #pragma weak tegra_soc_get_target_pwr_state
+#pragma weak tegra_soc_get_pwr_lvl_break_even
 
 int tegra_soc_pwr_domain_suspend_pwrdown_early(const psci_power_state_t *target_state)
 {
@@ -104,6 +105,13 @@ plat_local_state_t tegra_soc_get_target_pwr_state(unsigned int lvl,
 	return target;
 }
 
+u_register_t tegra_soc_get_pwr_lvl_break_even(plat_local_state_t local_state,
+					      unsigned int pwr_lvl,
+					      plat_local_state_t *demoted_state)
+{
+	return 0;
+}
+
 /*******************************************************************************
  * This handler is called by the PSCI implementation during the `SYSTEM_SUSPEND`
  * call to get the `power_state` parameter. This allows the platform to encode
@@ -310,6 +318,21 @@ int32_t tegra_validate_power_state(unsigned int power_state,
 	return tegra_soc_validate_power_state(power_state, req_state);
 }
 
+/*******************************************************************************
+ * Handler called by the PSCI idle predictor to get the break-even time of a
+ * power down state, and the shallower state to use instead of it when the
+ * power domain is not expected to stay idle for that long.
+ ******************************************************************************/
+u_register_t tegra_get_pwr_lvl_break_even(plat_local_state_t local_state,
+					  unsigned int pwr_lvl,
+					  plat_local_state_t *demoted_state)
+{
+	assert(demoted_state);
+
+	return tegra_soc_get_pwr_lvl_break_even(local_state, pwr_lvl,
+						demoted_state);
+}
+
 /*******************************************************************************
  * Platform handler called to check the validity of the non secure entrypoint.
  ******************************************************************************/
@@ -342,6 +365,7 @@ static const plat_psci_ops_t tegra_plat_psci_ops = {
 	.validate_power_state		= tegra_validate_power_state,
 	.validate_ns_entrypoint		= tegra_validate_ns_entrypoint,
 	.get_sys_suspend_power_state	= tegra_get_sys_suspend_power_state,
+	.get_pwr_lvl_break_even		= tegra_get_pwr_lvl_break_even,
 };
 
 /*******************************************************************************
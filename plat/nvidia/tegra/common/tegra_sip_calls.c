@@ -101,10 +101,16 @@ uintptr_t tegra_sip_handler(uint32_t smc_fid,
 			SMC_RET1(handle, -ENOTSUP);
 		}
 
-		/* new video memory carveout settings */
-		tegra_memctrl_videomem_setup(x1, x2);
+		/*
+		 * New video memory carveout settings. x3 limits the number
+		 * of bytes of the old carveout cleared by this call, when it
+		 * isn't 0. -EAGAIN is then returned until the clearing ends,
+		 * and the caller repeats the SMC with the same arguments to
+		 * resume it.
+		 */
+		err = tegra_memctrl_videomem_setup(x1, x2, x3);
 
-		SMC_RET1(handle, 0);
+		SMC_RET1(handle, err);
 		break;
 
 	/*
@@ -11,7 +11,9 @@ void tegra_memctrl_setup(void);
 void tegra_memctrl_restore_settings(void);
 void tegra_memctrl_tzdram_setup(uint64_t phys_base, uint32_t size_in_bytes);
 void tegra_memctrl_tzram_setup(uint64_t phys_base, uint32_t size_in_bytes);
-void tegra_memctrl_videomem_setup(uint64_t phys_base, uint32_t size_in_bytes);
+int32_t tegra_memctrl_videomem_setup(uint64_t phys_base,
+				     uint32_t size_in_bytes,
+				     uint64_t max_clear);
 void tegra_memctrl_disable_ahb_redirection(void);
 
 #endif /* MEMCTRL_H */
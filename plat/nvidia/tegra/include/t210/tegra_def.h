@@ -32,6 +32,15 @@
 #define PLAT_MAX_RET_STATE		U(1)
 #define PLAT_MAX_OFF_STATE		(PSTATE_ID_SOC_POWERDN + U(1))
 
+/*******************************************************************************
+ * Cluster residency, in microseconds, below which a cluster power down costs
+ * more than a cluster idle. With PSCI_STAT_IDLE_PREDICT, shorter predicted
+ * residencies demote the cluster power down requests to cluster idle.
+ ******************************************************************************/
+#ifndef TEGRA_CLUSTER_PWRDN_BREAK_EVEN_US
+#define TEGRA_CLUSTER_PWRDN_BREAK_EVEN_US	U(10000)
+#endif
+
 /*******************************************************************************
  * GIC memory map
  ******************************************************************************/
@@ -65,6 +65,8 @@ struct tegra_bl31_params {
 /* Declarations for plat_psci_handlers.c */
 int32_t tegra_soc_validate_power_state(unsigned int power_state,
 		psci_power_state_t *req_state);
+u_register_t tegra_soc_get_pwr_lvl_break_even(plat_local_state_t local_state,
+		unsigned int pwr_lvl, plat_local_state_t *demoted_state);
 
 /* Declarations for plat_setup.c */
 const mmap_region_t *plat_get_mmio_map(void);
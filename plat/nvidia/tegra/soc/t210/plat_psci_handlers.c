@@ -109,6 +109,24 @@ plat_local_state_t tegra_soc_get_target_pwr_state(unsigned int lvl,
 	return PSCI_LOCAL_STATE_RUN;
 }
 
+/*******************************************************************************
+ * Platform handler to get the break-even time of a cluster power down. The
+ * PSCI idle predictor demotes the request to a cluster idle when the cluster
+ * is not expected to stay idle for that long.
+ ******************************************************************************/
+u_register_t tegra_soc_get_pwr_lvl_break_even(plat_local_state_t local_state,
+					      unsigned int pwr_lvl,
+					      plat_local_state_t *demoted_state)
+{
+	if ((pwr_lvl == MPIDR_AFFLVL1) &&
+	    (local_state == PSTATE_ID_CLUSTER_POWERDN)) {
+		*demoted_state = PSTATE_ID_CLUSTER_IDLE;
+		return TEGRA_CLUSTER_PWRDN_BREAK_EVEN_US;
+	}
+
+	return 0;
+}
+
 int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 {
 	u_register_t mpidr = read_mpidr();
@@ -130,7 +148,9 @@ int tegra_soc_pwr_domain_suspend(const psci_power_state_t *target_state)
 
 	} else if (stateid_afflvl1 == PSTATE_ID_CLUSTER_IDLE) {
 
-		assert(stateid_afflvl0 == PSTATE_ID_CLUSTER_IDLE);
+		/* A cluster powerdn request may have been demoted */
+		assert((stateid_afflvl0 == PSTATE_ID_CLUSTER_IDLE) ||
+		       (stateid_afflvl0 == PSTATE_ID_CLUSTER_POWERDN));
 
 		/* Prepare for cluster idle */
 		tegra_fc_cluster_idle(mpidr);
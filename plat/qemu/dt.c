@@ -3,20 +3,22 @@
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
+#include <arch.h>
 #include <console.h>
 #include <debug.h>
+#include <fdt_fixup.h>
 #include <libfdt.h>
+#include <platform_def.h>
 #include <psci.h>
 #include <string.h>
 #include "qemu_private.h"
 
-static int append_psci_compatible(void *fdt, int offs, const char *str)
-{
-	return fdt_appendprop(fdt, offs, "compatible", str, strlen(str) + 1);
-}
+/* Compatible strings of the PSCI node, in decreasing order of precedence */
+static const char psci_compatible[] = "arm,psci-1.0\0arm,psci-0.2\0arm,psci";
 
-int dt_add_psci_node(void *fdt)
+int dt_add_psci_node(fdt_fixup_t *fx)
 {
+	const void *fdt = fx->fdt;
 	int offs;
 
 	if (fdt_path_offset(fdt, "/psci") >= 0) {
@@ -27,31 +29,29 @@ int dt_add_psci_node(void *fdt)
 	offs = fdt_path_offset(fdt, "/");
 	if (offs < 0)
 		return -1;
-	offs = fdt_add_subnode(fdt, offs, "psci");
+	offs = fdt_fixup_add_node(fx, offs, "psci");
 	if (offs < 0)
 		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci-1.0"))
-		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci-0.2"))
+	if (fdt_fixup_setprop(fx, offs, "compatible", psci_compatible,
+			      sizeof(psci_compatible)))
 		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci"))
+	if (fdt_fixup_setprop_string(fx, offs, "method", "smc"))
 		return -1;
-	if (fdt_setprop_string(fdt, offs, "method", "smc"))
+	if (fdt_fixup_setprop_u32(fx, offs, "cpu_suspend",
+				  PSCI_CPU_SUSPEND_AARCH64))
 		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_suspend", PSCI_CPU_SUSPEND_AARCH64))
+	if (fdt_fixup_setprop_u32(fx, offs, "cpu_off", PSCI_CPU_OFF))
 		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_off", PSCI_CPU_OFF))
+	if (fdt_fixup_setprop_u32(fx, offs, "cpu_on", PSCI_CPU_ON_AARCH64))
 		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_on", PSCI_CPU_ON_AARCH64))
+	if (fdt_fixup_setprop_u32(fx, offs, "sys_poweroff", PSCI_SYSTEM_OFF))
 		return -1;
-	if (fdt_setprop_u32(fdt, offs, "sys_poweroff", PSCI_SYSTEM_OFF))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "sys_reset", PSCI_SYSTEM_RESET))
+	if (fdt_fixup_setprop_u32(fx, offs, "sys_reset", PSCI_SYSTEM_RESET))
 		return -1;
 	return 0;
 }
 
-static int check_node_compat_prefix(void *fdt, int offs, const char *prefix)
+static int check_node_compat_prefix(const void *fdt, int offs, const char *prefix)
 {
 	const size_t prefix_len = strlen(prefix);
 	size_t l;
@@ -74,10 +74,39 @@ static int check_node_compat_prefix(void *fdt, int offs, const char *prefix)
 	return -1;
 }
 
-int dt_add_psci_cpu_enable_methods(void *fdt)
+/*
+ * Check that the MPIDR in the "reg" property of a CPU node is part of the
+ * topology BL3-1 was built for, so that the normal world is not offered CPUs
+ * PSCI cannot turn on.
+ */
+static int check_cpu_in_topology(const void *fdt, int offs)
 {
+	const fdt32_t *reg;
+	int len;
+	uint32_t mpidr, cluster_id, cpu_id;
+
+	reg = fdt_getprop(fdt, offs, "reg", &len);
+	if (!reg || len < (int)sizeof(*reg))
+		return -1;
+
+	/* With #address-cells = <2> the affinity fields are in the low word */
+	mpidr = fdt32_to_cpu(reg[(len / sizeof(*reg)) - 1]);
+	cluster_id = (mpidr >> MPIDR_AFF1_SHIFT) & MPIDR_AFFLVL_MASK;
+	cpu_id = (mpidr >> MPIDR_AFF0_SHIFT) & MPIDR_AFFLVL_MASK;
+
+	if (cluster_id >= PLATFORM_CLUSTER_COUNT ||
+	    cpu_id >= PLATFORM_MAX_CPUS_PER_CLUSTER)
+		return -1;
+
+	return 0;
+}
+
+int dt_add_psci_cpu_enable_methods(fdt_fixup_t *fx)
+{
+	const void *fdt = fx->fdt;
 	int offs = 0;
 
+	/* The fixups are only applied later, so the offsets remain valid */
 	while (1) {
 		offs = fdt_next_node(fdt, offs, NULL);
 		if (offs < 0)
@@ -86,10 +115,21 @@ int dt_add_psci_cpu_enable_methods(void *fdt)
 			continue; /* already set */
 		if (check_node_compat_prefix(fdt, offs, "arm,cortex-a"))
 			continue; /* no compatible */
-		if (fdt_setprop_string(fdt, offs, "enable-method", "psci"))
+		if (check_cpu_in_topology(fdt, offs)) {
+			const char *status;
+
+			status = fdt_getprop(fdt, offs, "status", NULL);
+			if (status && !strcmp(status, "disabled"))
+				continue; /* already disabled */
+			WARN("CPU node %s is outside the PSCI topology\n",
+			     fdt_get_name(fdt, offs, NULL));
+			if (fdt_fixup_setprop_string(fx, offs, "status",
+						     "disabled"))
+				return -1;
+			continue;
+		}
+		if (fdt_fixup_setprop_string(fx, offs, "enable-method", "psci"))
 			return -1;
-		/* Need to restart scanning as offsets may have changed */
-		offs = 0;
 	}
 	return 0;
 }
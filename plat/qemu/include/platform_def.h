@@ -17,19 +17,18 @@
 
 #define PLATFORM_STACK_SIZE 0x1000
 
-#if ARM_ARCH_MAJOR == 7
-#define PLATFORM_MAX_CPUS_PER_CLUSTER	4
-#define PLATFORM_CLUSTER_COUNT		1
-#define PLATFORM_CLUSTER0_CORE_COUNT	PLATFORM_MAX_CPUS_PER_CLUSTER
-#define PLATFORM_CLUSTER1_CORE_COUNT	0
-#else
-#define PLATFORM_MAX_CPUS_PER_CLUSTER	4
-#define PLATFORM_CLUSTER_COUNT		2
-#define PLATFORM_CLUSTER0_CORE_COUNT	PLATFORM_MAX_CPUS_PER_CLUSTER
-#define PLATFORM_CLUSTER1_CORE_COUNT	PLATFORM_MAX_CPUS_PER_CLUSTER
+#define PLATFORM_MAX_CPUS_PER_CLUSTER	QEMU_MAX_CPUS_PER_CLUSTER
+#define PLATFORM_CLUSTER_COUNT		QEMU_CLUSTER_COUNT
+#define PLATFORM_CORE_COUNT		(PLATFORM_CLUSTER_COUNT * \
+					 PLATFORM_MAX_CPUS_PER_CLUSTER)
+
+/*
+ * The QEMU GICv2 model supports at most 8 CPUs, larger topologies need the
+ * GICv3 model (-machine gic-version=3).
+ */
+#if !QEMU_GICV3 && (PLATFORM_CORE_COUNT > 8)
+# error "QEMU_USE_GIC_DRIVER=QEMU_GICV3 is needed for more than 8 CPUs"
 #endif
-#define PLATFORM_CORE_COUNT		(PLATFORM_CLUSTER0_CORE_COUNT + \
-					 PLATFORM_CLUSTER1_CORE_COUNT)
 
 #define QEMU_PRIMARY_CPU		0
 
@@ -75,12 +74,30 @@
 #define NS_DRAM0_BASE			0x40000000
 #define NS_DRAM0_SIZE			0x3de00000
 
+/*
+ * BL3-1 holds a stack and the per-cpu PSCI and context data for each core.
+ * The default layout has room for 8 cores; larger topologies grow BL3-1 and
+ * the secure SRAM into the unused space below the secure DRAM.
+ */
+#define QEMU_BL31_PER_CORE_SIZE		0x1800
+#if PLATFORM_CORE_COUNT > 8
+# define QEMU_BL31_TOPOLOGY_SIZE	((((PLATFORM_CORE_COUNT - 8) *	\
+					   QEMU_BL31_PER_CORE_SIZE) +	\
+					  0xfff) & ~0xfff)
+#else
+# define QEMU_BL31_TOPOLOGY_SIZE	0
+#endif
+
 #define SEC_SRAM_BASE			0x0e000000
-#define SEC_SRAM_SIZE			0x00060000
+#define SEC_SRAM_SIZE			(0x00060000 + QEMU_BL31_TOPOLOGY_SIZE)
 
 #define SEC_DRAM_BASE			0x0e100000
 #define SEC_DRAM_SIZE			0x00f00000
 
+#if (SEC_SRAM_BASE + SEC_SRAM_SIZE) > SEC_DRAM_BASE
+# error "Too many CPUs for the QEMU secure SRAM"
+#endif
+
 /* Load pageable part of OP-TEE 2MB above secure DRAM base */
 #define QEMU_OPTEE_PAGEABLE_LOAD_BASE	(SEC_DRAM_BASE + 0x00200000)
 #define QEMU_OPTEE_PAGEABLE_LOAD_SIZE	0x00400000
@@ -102,6 +119,10 @@
 #define PLAT_QEMU_HOLD_STATE_WAIT	0
 #define PLAT_QEMU_HOLD_STATE_GO		1
 
+#if PLAT_QEMU_TRUSTED_MAILBOX_SIZE > SHARED_RAM_SIZE
+# error "Too many CPUs for the QEMU trusted mailbox"
+#endif
+
 #define BL_RAM_BASE			(SHARED_RAM_BASE + SHARED_RAM_SIZE)
 #define BL_RAM_SIZE			(SEC_SRAM_SIZE - SHARED_RAM_SIZE)
 
@@ -133,7 +154,8 @@
  * Put BL3-1 at the top of the Trusted SRAM. BL31_BASE is calculated using the
  * current BL3-1 debug size plus a little space for growth.
  */
-#define BL31_BASE			(BL31_LIMIT - 0x20000)
+#define BL31_BASE			(BL31_LIMIT - 0x20000 - \
+					 QEMU_BL31_TOPOLOGY_SIZE)
 #define BL31_LIMIT			(BL_RAM_BASE + BL_RAM_SIZE)
 #define BL31_PROGBITS_LIMIT		BL1_RW_BASE
 
@@ -167,6 +189,10 @@
 
 #define NS_IMAGE_OFFSET			0x60000000
 
+/* Buffer of the BL2 loading benchmark, used before BL33 is loaded there */
+#define PLAT_BL2_IO_BENCH_BUF_BASE	NS_IMAGE_OFFSET
+#define PLAT_BL2_IO_BENCH_BUF_SIZE	0x10000000
+
 #define PLAT_PHY_ADDR_SPACE_SIZE	(1ULL << 32)
 #define PLAT_VIRT_ADDR_SPACE_SIZE	(1ULL << 32)
 #define MAX_MMAP_REGIONS		10
@@ -197,7 +223,11 @@
 #define PLAT_QEMU_FIP_MAX_SIZE		QEMU_FLASH0_SIZE
 
 #define DEVICE0_BASE			0x08000000
+#if QEMU_GICV3
+#define DEVICE0_SIZE			(GICR_BASE + GICR_SIZE - DEVICE0_BASE)
+#else
 #define DEVICE0_SIZE			0x00021000
+#endif
 #define DEVICE1_BASE			0x09000000
 #define DEVICE1_SIZE			0x00041000
 
@@ -207,7 +237,12 @@
 
 #define GICD_BASE			0x8000000
 #define GICC_BASE			0x8010000
+#if QEMU_GICV3
+#define GICR_BASE			0x80a0000
+#define GICR_SIZE			(PLATFORM_CORE_COUNT * 0x20000)
+#else
 #define GICR_BASE			0
+#endif
 
 
 #define QEMU_IRQ_SEC_SGI_0		8
@@ -16,6 +16,51 @@ $(eval $(call add_define,ARMV7_SUPPORTS_GENERIC_TIMER))
 NEED_BL32		:=	yes
 endif # ARMv7
 
+# Default cluster count for QEMU
+ifeq (${ARM_ARCH_MAJOR},7)
+QEMU_CLUSTER_COUNT		:= 1
+else
+QEMU_CLUSTER_COUNT		:= 2
+endif
+
+# Default number of CPUs per cluster on QEMU
+QEMU_MAX_CPUS_PER_CLUSTER	:= 4
+
+# Default GIC driver on QEMU
+QEMU_USE_GIC_DRIVER		:= QEMU_GICV2
+
+ifeq ($(QEMU_CLUSTER_COUNT), 0)
+$(error "Incorrect cluster count specified for QEMU port")
+endif
+ifeq ($(QEMU_MAX_CPUS_PER_CLUSTER), 0)
+$(error "Incorrect CPU count per cluster specified for QEMU port")
+endif
+
+# Pass QEMU_CLUSTER_COUNT to the build system.
+$(eval $(call add_define,QEMU_CLUSTER_COUNT))
+
+# Pass QEMU_MAX_CPUS_PER_CLUSTER to the build system.
+$(eval $(call add_define,QEMU_MAX_CPUS_PER_CLUSTER))
+
+ifeq (${QEMU_USE_GIC_DRIVER}, QEMU_GICV2)
+QEMU_GIC_SOURCES	:=	drivers/arm/gic/v2/gicv2_helpers.c	\
+				drivers/arm/gic/v2/gicv2_main.c		\
+				drivers/arm/gic/common/gic_common.c	\
+				plat/common/plat_gicv2.c
+else ifeq (${QEMU_USE_GIC_DRIVER}, QEMU_GICV3)
+ifeq (${ARCH},aarch32)
+$(error "QEMU_GICV3 is only supported on AArch64 QEMU")
+endif
+QEMU_GIC_SOURCES	:=	drivers/arm/gic/v3/gicv3_helpers.c	\
+				drivers/arm/gic/v3/gicv3_main.c		\
+				drivers/arm/gic/common/gic_common.c	\
+				plat/common/plat_gicv3.c
+else
+$(error "Incorrect GIC driver chosen on QEMU port")
+endif
+
+$(eval $(call add_define,${QEMU_USE_GIC_DRIVER}))
+
 ifeq (${SPD},opteed)
 add-lib-optee 		:= 	yes
 endif
@@ -118,7 +163,8 @@ BL2_SOURCES		+=	drivers/io/io_semihosting.c		\
 				plat/qemu/dt.c				\
 				plat/qemu/qemu_bl2_mem_params_desc.c	\
 				plat/qemu/qemu_image_load.c		\
-				common/desc_image_load.c
+				common/desc_image_load.c		\
+				common/fdt_fixup.c
 
 ifeq ($(add-lib-optee),yes)
 BL2_SOURCES		+=	lib/optee/optee_utils.c
@@ -129,10 +175,7 @@ ifeq (${ARM_ARCH_MAJOR},8)
 BL31_SOURCES		+=	lib/cpus/aarch64/aem_generic.S		\
 				lib/cpus/aarch64/cortex_a53.S		\
 				lib/cpus/aarch64/cortex_a57.S		\
-				drivers/arm/gic/v2/gicv2_helpers.c	\
-				drivers/arm/gic/v2/gicv2_main.c		\
-				drivers/arm/gic/common/gic_common.c	\
-				plat/common/plat_gicv2.c		\
+				${QEMU_GIC_SOURCES}			\
 				plat/common/plat_psci_common.c		\
 				plat/qemu/qemu_pm.c			\
 				plat/qemu/topology.c			\
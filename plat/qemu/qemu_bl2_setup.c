@@ -5,9 +5,11 @@
  */
 #include <arch_helpers.h>
 #include <assert.h>
+#include <bl2.h>
 #include <bl_common.h>
 #include <debug.h>
 #include <desc_image_load.h>
+#include <fdt_fixup.h>
 #include <optee_utils.h>
 #include <libfdt.h>
 #include <platform.h>
@@ -46,26 +48,28 @@ static void update_dt(void)
 {
 	int ret;
 	void *fdt = (void *)(uintptr_t)PLAT_QEMU_DT_BASE;
+	static fdt_fixup_t fx;
 
-	ret = fdt_open_into(fdt, fdt, PLAT_QEMU_DT_MAX_SIZE);
+	ret = fdt_fixup_init(&fx, fdt);
 	if (ret < 0) {
 		ERROR("Invalid Device Tree at %p: error %d\n", fdt, ret);
 		return;
 	}
 
-	if (dt_add_psci_node(fdt)) {
+	if (dt_add_psci_node(&fx)) {
 		ERROR("Failed to add PSCI Device Tree node\n");
 		return;
 	}
 
-	if (dt_add_psci_cpu_enable_methods(fdt)) {
+	if (dt_add_psci_cpu_enable_methods(&fx)) {
 		ERROR("Failed to add PSCI cpu enable methods in Device Tree\n");
 		return;
 	}
 
-	ret = fdt_pack(fdt);
+	/* Write the modified Device Tree in place, in a single pass */
+	ret = fdt_fixup_apply(&fx, fdt, PLAT_QEMU_DT_MAX_SIZE);
 	if (ret < 0)
-		ERROR("Failed to pack Device Tree at %p: error %d\n", fdt, ret);
+		ERROR("Failed to update Device Tree at %p: error %d\n", fdt, ret);
 }
 
 void bl2_platform_setup(void)
@@ -207,6 +211,28 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 	return qemu_bl2_handle_post_image_load(image_id);
 }
 
+#if BL2_IO_BENCHMARK
+/*******************************************************************************
+ * Images loaded by the benchmark of the loading path, from the FIP or through
+ * semihosting. Those that are missing are skipped.
+ ******************************************************************************/
+static const bl2_io_bench_image_t qemu_bl2_io_bench_images[] = {
+	{ .image_id = BL31_IMAGE_ID },
+	{ .image_id = BL32_IMAGE_ID },
+	{ .image_id = BL32_EXTRA1_IMAGE_ID },
+	{ .image_id = BL32_EXTRA2_IMAGE_ID },
+	{ .image_id = BL33_IMAGE_ID },
+};
+
+const bl2_io_bench_image_t *plat_bl2_io_bench_get_images(
+						unsigned int *num_images)
+{
+	*num_images = ARRAY_SIZE(qemu_bl2_io_bench_images);
+
+	return qemu_bl2_io_bench_images;
+}
+#endif /* BL2_IO_BENCHMARK */
+
 uintptr_t plat_get_ns_image_entrypoint(void)
 {
 	return NS_IMAGE_OFFSET;
@@ -7,7 +7,11 @@
 #include <assert.h>
 #include <bl_common.h>
 #include <gic_common.h>
+#if QEMU_GICV3
+#include <gicv3.h>
+#else
 #include <gicv2.h>
+#endif
 #include <platform_def.h>
 #include <platform.h>
 #include "qemu_private.h"
@@ -81,7 +85,7 @@ void bl31_plat_arch_setup(void)
 
 /******************************************************************************
  * On a GICv2 system, the Group 1 secure interrupts are treated as Group 0
- * interrupts.
+ * interrupts. On a GICv3 system they are kept in Group 1 secure.
  *****************************************************************************/
 #define PLATFORM_G1S_PROPS(grp)						\
 	INTR_PROP_DESC(QEMU_IRQ_SEC_SGI_0, GIC_HIGHEST_SEC_PRIORITY,	\
@@ -103,6 +107,33 @@ void bl31_plat_arch_setup(void)
 
 #define PLATFORM_G0_PROPS(grp)
 
+#if QEMU_GICV3
+static const interrupt_prop_t qemu_interrupt_props[] = {
+	PLATFORM_G1S_PROPS(INTR_GROUP1S),
+	PLATFORM_G0_PROPS(INTR_GROUP0)
+};
+
+static uintptr_t qemu_rdistif_base_addrs[PLATFORM_CORE_COUNT];
+
+static const gicv3_driver_data_t plat_gicv3_driver_data = {
+	.gicd_base = GICD_BASE,
+	.gicr_base = GICR_BASE,
+	.interrupt_props = qemu_interrupt_props,
+	.interrupt_props_num = ARRAY_SIZE(qemu_interrupt_props),
+	.rdistif_num = PLATFORM_CORE_COUNT,
+	.rdistif_base_addrs = qemu_rdistif_base_addrs,
+	.mpidr_to_core_pos = plat_qemu_calc_core_pos,
+};
+
+void bl31_platform_setup(void)
+{
+	/* Initialize the gic distributor, redistributor and cpu interfaces */
+	gicv3_driver_init(&plat_gicv3_driver_data);
+	gicv3_distif_init();
+	gicv3_rdistif_init(plat_my_core_pos());
+	gicv3_cpuif_enable(plat_my_core_pos());
+}
+#else
 static const interrupt_prop_t qemu_interrupt_props[] = {
 	PLATFORM_G1S_PROPS(GICV2_INTR_GROUP0),
 	PLATFORM_G0_PROPS(GICV2_INTR_GROUP0)
@@ -123,6 +154,7 @@ void bl31_platform_setup(void)
 	gicv2_pcpu_distif_init();
 	gicv2_cpuif_enable();
 }
+#endif /* QEMU_GICV3 */
 
 unsigned int plat_get_syscnt_freq2(void)
 {
@@ -7,7 +7,11 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
+#if QEMU_GICV3
+#include <gicv3.h>
+#else
 #include <gicv2.h>
+#endif
 #include <platform.h>
 #include <platform_def.h>
 #include <psci.h>
@@ -171,11 +175,19 @@ void qemu_pwr_domain_on_finish(const psci_power_state_t *target_state)
 	assert(target_state->pwr_domain_state[MPIDR_AFFLVL0] ==
 					PLAT_LOCAL_STATE_OFF);
 
+#if QEMU_GICV3
+	/* TODO: This setup is needed only after a cold boot */
+	gicv3_rdistif_init(plat_my_core_pos());
+
+	/* Enable the gic cpu interface */
+	gicv3_cpuif_enable(plat_my_core_pos());
+#else
 	/* TODO: This setup is needed only after a cold boot */
 	gicv2_pcpu_distif_init();
 
 	/* Enable the gic cpu interface */
 	gicv2_cpuif_enable();
+#endif
 }
 
 /*******************************************************************************
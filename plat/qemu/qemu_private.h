@@ -7,6 +7,7 @@
 #ifndef QEMU_PRIVATE_H
 #define QEMU_PRIVATE_H
 
+#include <fdt_fixup.h>
 #include <stdint.h>
 
 #include "../../bl1/bl1_private.h"
@@ -30,8 +31,8 @@ void qemu_configure_mmu_el3(unsigned long total_base, unsigned long total_size,
 void plat_qemu_io_setup(void);
 unsigned int plat_qemu_calc_core_pos(u_register_t mpidr);
 
-int dt_add_psci_node(void *fdt);
-int dt_add_psci_cpu_enable_methods(void *fdt);
+int dt_add_psci_node(fdt_fixup_t *fx);
+int dt_add_psci_cpu_enable_methods(fdt_fixup_t *fx);
 
 void qemu_console_init(void);
 
@@ -5,25 +5,36 @@
  */
 
 #include <arch.h>
+#include <cassert.h>
+#include <limits.h>
 #include <platform_def.h>
 #include <stdint.h>
 #include "qemu_private.h"
 
-/* The power domain tree descriptor */
-static unsigned char power_domain_tree_desc[] = {
-	/* Number of root nodes */
-	PLATFORM_CLUSTER_COUNT,
-	/* Number of children for the first node */
-	PLATFORM_CLUSTER0_CORE_COUNT,
-	/* Number of children for the second node */
-	PLATFORM_CLUSTER1_CORE_COUNT,
-};
+/*
+ * The power domain tree descriptor. Every cluster has the same number of
+ * cores so the per-cluster entries are filled in on first use.
+ */
+static unsigned char power_domain_tree_desc[PLATFORM_CLUSTER_COUNT + 1];
+
+CASSERT(PLATFORM_CLUSTER_COUNT <= UCHAR_MAX, assert_qemu_cluster_count);
+CASSERT(PLATFORM_MAX_CPUS_PER_CLUSTER <= MPIDR_AFFLVL_MASK + 1,
+	assert_qemu_cpus_per_cluster);
 
 /*******************************************************************************
  * This function returns the ARM default topology tree information.
  ******************************************************************************/
 const unsigned char *plat_get_power_domain_tree_desc(void)
 {
+	unsigned int i;
+
+	/* Number of root nodes */
+	power_domain_tree_desc[0] = PLATFORM_CLUSTER_COUNT;
+
+	/* Number of children for each cluster node */
+	for (i = 0; i < PLATFORM_CLUSTER_COUNT; i++)
+		power_domain_tree_desc[i + 1] = PLATFORM_MAX_CPUS_PER_CLUSTER;
+
 	return power_domain_tree_desc;
 }
 
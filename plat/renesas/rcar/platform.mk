@@ -11,6 +11,7 @@ TRUSTED_BOARD_BOOT		:= 1
 RESET_TO_BL31			:= 1
 GENERATE_COT			:= 1
 BL2_AT_EL3			:= 1
+DMA_ENGINE			:= 1
 
 $(eval $(call add_define,PLAT_EXTRA_LD_SCRIPT))
 
@@ -20,17 +20,22 @@
 #include <plat_private.h>
 #include <platform.h>
 #include <platform_def.h>
+#include <pmf.h>
 #include <pmu.h>
 #include <pmu_com.h>
 #include <pwm.h>
 #include <rk3399_def.h>
 #include <secure.h>
 #include <soc.h>
+#include <stdbool.h>
 #include <string.h>
 #include <suspend.h>
 
 DEFINE_BAKERY_LOCK(rockchip_pd_lock);
 
+PMF_REGISTER_SERVICE_SMC(rk3399_resume, PMF_PLAT_SVC_ID,
+	RK3399_PMF_TOTAL_IDS, PMF_STORE_ENABLE)
+
 static uint32_t cpu_warm_boot_addr;
 static char store_sram[SRAM_BIN_LIMIT + SRAM_TEXT_LIMIT + SRAM_DATA_LIMIT];
 static uint32_t store_cru[CRU_SDIO0_CON1 / 4 + 1];
@@ -1066,6 +1071,7 @@ static void resume_gpio(void)
 
 void sram_save(void)
 {
+	static bool sram_text_saved;
 	size_t text_size = (char *)&__bl31_sram_text_real_end -
 			   (char *)&__bl31_sram_text_start;
 	size_t data_size = (char *)&__bl31_sram_data_real_end -
@@ -1073,7 +1079,15 @@ void sram_save(void)
 	size_t incbin_size = (char *)&__sram_incbin_real_end -
 			     (char *)&__sram_incbin_start;
 
-	memcpy(&store_sram[0], &__bl31_sram_text_start, text_size);
+	/*
+	 * The sram text is mapped read-only, so its copy made at the first
+	 * suspend stays valid. The data and the M0 binary, which holds the M0
+	 * parameters and variables, change and are saved at every suspend.
+	 */
+	if (!sram_text_saved) {
+		memcpy(&store_sram[0], &__bl31_sram_text_start, text_size);
+		sram_text_saved = true;
+	}
 	memcpy(&store_sram[text_size], &__bl31_sram_data_start, data_size);
 	memcpy(&store_sram[text_size + data_size], &__sram_incbin_start,
 	       incbin_size);
@@ -1394,6 +1408,9 @@ int rockchip_soc_sys_pwr_dm_resume(void)
 	uint32_t wait_cnt = 0;
 	uint32_t status = 0;
 
+	PMF_CAPTURE_TIMESTAMP(rk3399_resume, RK3399_PMF_RESUME_START,
+			      PMF_NO_CACHE_MAINT);
+
 	plat_rockchip_restore_gpio();
 	cru_register_restore();
 	grf_register_restore();
@@ -1401,12 +1418,19 @@ int rockchip_soc_sys_pwr_dm_resume(void)
 	resume_uart();
 	resume_apio();
 	resume_gpio();
+
+	PMF_CAPTURE_TIMESTAMP(rk3399_resume, RK3399_PMF_RESUME_REGS,
+			      PMF_NO_CACHE_MAINT);
+
 	enable_nodvfs_plls();
 	enable_pwms();
 	/* PWM regulators take time to come up; give 300us to be safe. */
 	udelay(300);
 	enable_dvfs_plls();
 
+	PMF_CAPTURE_TIMESTAMP(rk3399_resume, RK3399_PMF_RESUME_PLLS,
+			      PMF_NO_CACHE_MAINT);
+
 	secure_sgrf_init();
 	secure_sgrf_ddr_rgn_init();
 
@@ -1462,6 +1486,9 @@ int rockchip_soc_sys_pwr_dm_resume(void)
 	pmu_scu_b_pwrup();
 	pmu_power_domains_resume();
 
+	PMF_CAPTURE_TIMESTAMP(rk3399_resume, RK3399_PMF_RESUME_PDS,
+			      PMF_NO_CACHE_MAINT);
+
 	restore_abpll();
 	clr_hw_idle(BIT(PMU_CLR_CENTER1) |
 				BIT(PMU_CLR_ALIVE) |
@@ -1483,6 +1510,9 @@ int rockchip_soc_sys_pwr_dm_resume(void)
 
 	ddr_prepare_for_sys_resume();
 
+	PMF_CAPTURE_TIMESTAMP(rk3399_resume, RK3399_PMF_RESUME_DONE,
+			      PMF_NO_CACHE_MAINT);
+
 	return 0;
 }
 
@@ -133,6 +133,19 @@ struct pmu_slpdata_s {
 	uint32_t sdio_qos[CPU_AXI_QOS_NUM_REGS];
 };
 
+/*
+ * Time-stamps of the stages of the system resume, in the PMF service
+ * PMF_PLAT_SVC_ID. START is taken when the resume handler starts, after the
+ * DDR and the SRAM have been restored from the PMU SRAM, and each other one
+ * when the stage it names is done.
+ */
+#define RK3399_PMF_RESUME_START		U(0)
+#define RK3399_PMF_RESUME_REGS		U(1)	/* CRU, GRF, WDT, UART, GPIO */
+#define RK3399_PMF_RESUME_PLLS		U(2)	/* PLLs and PWM regulators */
+#define RK3399_PMF_RESUME_PDS		U(3)	/* Cluster B and power domains */
+#define RK3399_PMF_RESUME_DONE		U(4)
+#define RK3399_PMF_TOTAL_IDS		U(5)
+
 extern uint32_t clst_warmboot_data[PLATFORM_CLUSTER_COUNT];
 
 extern void sram_func_set_ddrctl_pll(uint32_t pll_src);
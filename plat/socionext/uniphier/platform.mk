@@ -104,11 +104,21 @@ ifeq (${FIP_GZIP},1)
 
 include lib/zlib/zlib.mk
 
-BL2_SOURCES		+=	common/image_decompress.c		\
-				$(ZLIB_SOURCES)
+BL2_SOURCES		+=	$(ZLIB_SOURCES)
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
+# decompress images while they are read instead of staging them in full
+ifeq (${FIP_GZIP_STREAM},1)
+ifeq (${TRUSTED_BOARD_BOOT},1)
+$(error FIP_GZIP_STREAM=1 is not supported with TRUSTED_BOARD_BOOT=1)
+endif
+ifeq (${FIP_LZ4},1)
+$(error FIP_GZIP_STREAM=1 is not supported with FIP_LZ4=1)
+endif
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP_STREAM))
+endif
+
 # compress all images loaded by BL2
 SCP_BL2_PRE_TOOL_FILTER	:= GZIP
 BL31_PRE_TOOL_FILTER	:= GZIP
@@ -117,6 +127,26 @@ BL33_PRE_TOOL_FILTER	:= GZIP
 
 endif
 
+ifeq (${FIP_LZ4},1)
+
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	$(LZ4_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_LZ4))
+
+# compress all images loaded by BL2, unless overridden per image
+SCP_BL2_PRE_TOOL_FILTER	:= LZ4
+BL31_PRE_TOOL_FILTER	:= LZ4
+BL32_PRE_TOOL_FILTER	:= LZ4
+BL33_PRE_TOOL_FILTER	:= LZ4
+
+endif
+
+ifneq ($(filter 1,${FIP_GZIP} ${FIP_LZ4}),)
+BL2_SOURCES		+=	common/image_decompress.c
+endif
+
 .PHONY: bl2_gzip
 bl2_gzip: $(BUILD_PLAT)/bl2.bin.gz
 %.gz: %
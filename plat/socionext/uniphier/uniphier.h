@@ -88,4 +88,7 @@ unsigned int uniphier_calc_core_pos(u_register_t mpidr);
 #define UNIPHIER_IMAGE_BUF_SIZE		((UNIPHIER_NS_DRAM_LIMIT) - \
 					 (UNIPHIER_IMAGE_BUF_BASE))
 
+/* staging size of compressed data when decompressing while loading */
+#define UNIPHIER_IMAGE_CHUNK_SIZE	0x00010000
+
 #endif /* UNIPHIER_H */
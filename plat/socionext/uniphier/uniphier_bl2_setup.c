@@ -15,6 +15,9 @@
 #ifdef UNIPHIER_DECOMPRESS_GZIP
 #include <tf_gunzip.h>
 #endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+#include <tf_lz4.h>
+#endif
 #include <xlat_tables_v2.h>
 
 #include "uniphier.h"
@@ -22,6 +25,10 @@
 #define BL2_END			(unsigned long)(&__BL2_END__)
 #define BL2_SIZE		((BL2_END) - (BL2_BASE))
 
+#if defined(UNIPHIER_DECOMPRESS_GZIP) || defined(UNIPHIER_DECOMPRESS_LZ4)
+#define UNIPHIER_DECOMPRESS
+#endif
+
 static int uniphier_bl2_kick_scp;
 
 void bl2_el3_early_platform_setup(u_register_t x0, u_register_t x1,
@@ -115,18 +122,68 @@ bl_params_t *plat_get_next_bl_params(void)
 	return get_next_bl_params_from_mem_params_desc();
 }
 
-void bl2_plat_preload_setup(void)
+#if defined(UNIPHIER_DECOMPRESS) && !defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
+/*
+ * Pick the decompressor from the header of the image, so that each image in
+ * the FIP can use the compression that suits it best.
+ */
+static int uniphier_decompress(uintptr_t *in_buf, size_t in_len,
+			       uintptr_t *out_buf, size_t out_len,
+			       uintptr_t work_buf, size_t work_len)
 {
+	const uint8_t *magic = (const uint8_t *)*in_buf;
+
+	if (in_len < 4U)
+		return -EINVAL;
+
 #ifdef UNIPHIER_DECOMPRESS_GZIP
+	if ((magic[0] == 0x1fU) && (magic[1] == 0x8bU))
+		return gunzip(in_buf, in_len, out_buf, out_len,
+			      work_buf, work_len);
+#endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+	if ((magic[0] | (magic[1] << 8) | (magic[2] << 16) |
+	     ((uint32_t)magic[3] << 24)) == LZ4_FRAME_MAGIC)
+		return unlz4(in_buf, in_len, out_buf, out_len,
+			     work_buf, work_len);
+#endif
+
+	ERROR("Unknown image compression\n");
+	return -EINVAL;
+}
+#endif
+
+void bl2_plat_preload_setup(void)
+{
+#if defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
+	image_decompress_stream_init(UNIPHIER_IMAGE_BUF_BASE,
+				     UNIPHIER_IMAGE_BUF_SIZE,
+				     UNIPHIER_IMAGE_CHUNK_SIZE,
+				     &gunzip_stream_decompressor);
+#elif defined(UNIPHIER_DECOMPRESS)
 	image_decompress_init(UNIPHIER_IMAGE_BUF_BASE,
 			      UNIPHIER_IMAGE_BUF_SIZE,
-			      gunzip);
+			      uniphier_decompress);
 #endif
 }
 
 int bl2_plat_handle_pre_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#if defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
+	struct image_info *image_info;
+	int ret;
+
+	image_info = uniphier_get_image_info(image_id);
+
+	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+		ret = image_decompress_load(image_id, image_info);
+		if (ret)
+			return ret;
+
+		/* The image is now in place, do not let BL2 load it again. */
+		image_info->h.attr |= IMAGE_ATTRIB_SKIP_LOADING;
+	}
+#elif defined(UNIPHIER_DECOMPRESS)
 	image_decompress_prepare(uniphier_get_image_info(image_id));
 #endif
 	return 0;
@@ -134,7 +191,7 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#if defined(UNIPHIER_DECOMPRESS) && !defined(UNIPHIER_DECOMPRESS_GZIP_STREAM)
 	struct image_info *image_info;
 	int ret;
 
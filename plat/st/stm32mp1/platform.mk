@@ -76,6 +76,11 @@ BL2_SOURCES		+=	drivers/mmc/mmc.c					\
 				drivers/st/io/io_mmc.c					\
 				drivers/st/mmc/stm32_sdmmc2.c
 
+# The partition driver checks the CRCs of the GPT with the zlib crc32()
+include lib/zlib/zlib.mk
+
+BL2_SOURCES		+=	lib/zlib/crc32.c
+
 BL2_SOURCES		+=	drivers/st/ddr/stm32mp1_ddr.c				\
 				drivers/st/ddr/stm32mp1_ram.c
 
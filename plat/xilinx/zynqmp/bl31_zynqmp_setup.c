@@ -190,6 +190,10 @@ void bl31_plat_arch_setup(void)
 		MAP_REGION_FLAT(BL_COHERENT_RAM_BASE,
 				BL_COHERENT_RAM_END - BL_COHERENT_RAM_BASE,
 				MT_DEVICE | MT_RW | MT_SECURE),
+#ifdef ZYNQMP_PM_SHMEM_BASE
+		MAP_REGION_FLAT(ZYNQMP_PM_SHMEM_BASE, ZYNQMP_PM_SHMEM_SIZE,
+				MT_MEMORY | MT_RW | MT_NS),
+#endif
 		{0}
 	};
 
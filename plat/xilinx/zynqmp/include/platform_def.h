@@ -84,7 +84,11 @@
  ******************************************************************************/
 #define PLAT_PHY_ADDR_SPACE_SIZE	(1ULL << 32)
 #define PLAT_VIRT_ADDR_SPACE_SIZE	(1ULL << 32)
+#ifndef ZYNQMP_PM_SHMEM_BASE
 #define MAX_MMAP_REGIONS		7
+#else
+#define MAX_MMAP_REGIONS		8
+#endif
 #define MAX_XLAT_TABLES			5
 
 #define CACHE_WRITEBACK_SHIFT   6
@@ -38,6 +38,15 @@ ifdef ZYNQMP_BL32_MEM_BASE
     $(eval $(call add_define,ZYNQMP_BL32_MEM_SIZE))
 endif
 
+ifdef ZYNQMP_PM_SHMEM_BASE
+    $(eval $(call add_define,ZYNQMP_PM_SHMEM_BASE))
+
+    ifndef ZYNQMP_PM_SHMEM_SIZE
+        $(error "ZYNQMP_PM_SHMEM_BASE defined without ZYNQMP_PM_SHMEM_SIZE")
+    endif
+    $(eval $(call add_define,ZYNQMP_PM_SHMEM_SIZE))
+endif
+
 ZYNQMP_CONSOLE	?=	cadence
 $(eval $(call add_define_val,ZYNQMP_CONSOLE,ZYNQMP_CONSOLE_ID_${ZYNQMP_CONSOLE}))
 
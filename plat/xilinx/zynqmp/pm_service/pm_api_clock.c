@@ -2319,6 +2319,18 @@ enum pm_ret_status pm_api_clock_get_name(unsigned int clock_id, char *name)
 	return PM_RET_SUCCESS;
 }
 
+/**
+ * pm_clock_node_topology - Encode a clock topology node
+ * @node	Topology node of a clock
+ *
+ * Return: Returns the type and flags of the node packed in one word.
+ */
+static uint32_t pm_clock_node_topology(const struct pm_clock_node *node)
+{
+	return node->type | (node->clkflags << CLK_CLKFLAGS_SHIFT) |
+	       (node->typeflags << CLK_TYPEFLAGS_SHIFT);
+}
+
 /**
  * pm_api_clock_get_topology() - PM call to request a clock's topology
  * @clock_id	Clock ID
@@ -2358,14 +2370,69 @@ enum pm_ret_status pm_api_clock_get_topology(unsigned int clock_id,
 	for (i = 0; i < 3U; i++) {
 		if ((index + i) == num_nodes)
 			break;
-		topology[i] =  clock_nodes[index + i].type;
-		topology[i] |= clock_nodes[index + i].clkflags <<
-					CLK_CLKFLAGS_SHIFT;
-		topology[i] |= clock_nodes[index + i].typeflags <<
-					CLK_TYPEFLAGS_SHIFT;
+		topology[i] = pm_clock_node_topology(&clock_nodes[index + i]);
+	}
+
+	return PM_RET_SUCCESS;
+}
+
+/**
+ * pm_api_clock_get_all_topology() - PM call to copy the topology of clocks
+ *				     into the PM shared memory
+ * @first	ID of the first clock to copy
+ * @nclocks	Number of clocks copied
+ * @size	Number of bytes written in the shared memory
+ *
+ * This function is used by master to get the topology of all the clocks
+ * with a few calls, instead of one call per 3 topology nodes of each clock.
+ * The clocks from @first onwards are written in order at the start of the
+ * shared memory, as many as fit. Each clock is written as a word holding
+ * its number of topology nodes, followed by its nodes encoded as by
+ * pm_api_clock_get_topology(). Invalid and external clocks have no node.
+ * The next call starts with clock @first + @nclocks, until CLK_MAX.
+ *
+ * @return	Returns status, either success or error+reason
+ */
+enum pm_ret_status pm_api_clock_get_all_topology(unsigned int first,
+						 uint32_t *nclocks,
+						 uint32_t *size)
+{
+#ifdef ZYNQMP_PM_SHMEM_BASE
+	uint32_t *buf = (uint32_t *)ZYNQMP_PM_SHMEM_BASE;
+	size_t max_words = ZYNQMP_PM_SHMEM_SIZE / sizeof(uint32_t);
+	size_t words = 0U;
+	struct pm_clock_node *clock_nodes;
+	unsigned int clock_id, num_nodes, i;
+
+	if (first >= CLK_MAX)
+		return PM_RET_ERROR_ARGS;
+
+	for (clock_id = first; clock_id < CLK_MAX; clock_id++) {
+		num_nodes = 0U;
+		if (pm_clock_valid(clock_id) &&
+		    (pm_clock_type(clock_id) == CLK_TYPE_OUTPUT))
+			num_nodes = clocks[clock_id].num_nodes;
+
+		if ((words + 1U + num_nodes) > max_words)
+			break;
+
+		buf[words++] = num_nodes;
+		clock_nodes = *clocks[clock_id].nodes;
+		for (i = 0U; i < num_nodes; i++)
+			buf[words++] = pm_clock_node_topology(&clock_nodes[i]);
 	}
 
+	/* The shared memory can't even hold the first clock */
+	if (clock_id == first)
+		return PM_RET_ERROR_ARGS;
+
+	*nclocks = clock_id - first;
+	*size = words * sizeof(uint32_t);
+
 	return PM_RET_SUCCESS;
+#else
+	return PM_RET_ERROR_NOTSUPPORTED;
+#endif
 }
 
 /**
@@ -280,6 +280,9 @@ enum pm_ret_status pm_api_clock_get_num_clocks(unsigned int *nclocks);
 enum pm_ret_status pm_api_clock_get_topology(unsigned int clock_id,
 					     unsigned int index,
 					     uint32_t *topology);
+enum pm_ret_status pm_api_clock_get_all_topology(unsigned int first,
+						 uint32_t *nclocks,
+						 uint32_t *size);
 enum pm_ret_status pm_api_clock_get_fixedfactor_params(unsigned int clock_id,
 						       uint32_t *mul,
 						       uint32_t *div);
@@ -11,6 +11,7 @@
 
 #include <arch_helpers.h>
 #include <platform.h>
+#include <stdbool.h>
 #include "pm_api_clock.h"
 #include "pm_api_ioctl.h"
 #include "pm_api_pinctrl.h"
@@ -563,15 +564,38 @@ enum pm_ret_status pm_fpga_get_status(unsigned int *value)
  * @value       Buffer for return values. Must be large enough
  *		to hold 8 bytes.
  *
+ * The silicon ID never changes, so it is only requested from the PMU until
+ * it has been returned once, and then returned from a copy kept in EL3
+ * without an IPI round trip.
+ *
  * @return      Returns silicon ID registers
  */
 enum pm_ret_status pm_get_chipid(uint32_t *value)
 {
+	static uint32_t chipid[2];
+	static bool chipid_valid;
 	uint32_t payload[PAYLOAD_ARG_CNT];
+	enum pm_ret_status ret;
 
-	/* Send request to the PMU */
-	PM_PACK_PAYLOAD1(payload, PM_GET_CHIPID);
-	return pm_ipi_send_sync(primary_proc, payload, value, 2);
+	if (!chipid_valid) {
+		/* Send request to the PMU */
+		PM_PACK_PAYLOAD1(payload, PM_GET_CHIPID);
+		ret = pm_ipi_send_sync(primary_proc, payload, chipid, 2);
+		if (ret != PM_RET_SUCCESS)
+			return ret;
+
+		/* Publish the ID before the flag to the other CPUs */
+		dmbishst();
+		chipid_valid = true;
+	} else {
+		/* Read the ID after the flag that published it */
+		dmbishld();
+	}
+
+	value[0] = chipid[0];
+	value[1] = chipid[1];
+
+	return PM_RET_SUCCESS;
 }
 
 /**
@@ -784,6 +808,25 @@ static enum pm_ret_status pm_clock_get_topology(unsigned int clock_id,
 	return pm_api_clock_get_topology(clock_id, index, topology);
 }
 
+/**
+ * pm_clock_get_all_topology() - PM call to copy the topology of clocks into
+ *				 the PM shared memory
+ * @first	ID of the first clock to copy
+ * @nclocks	Number of clocks copied
+ * @size	Number of bytes written in the shared memory
+ *
+ * This function is used by master to get the topology of all the clocks
+ * with a few calls. The next call starts with clock @first + @nclocks.
+ *
+ * @return	Returns status, either success or error+reason
+ */
+static enum pm_ret_status pm_clock_get_all_topology(unsigned int first,
+						    uint32_t *nclocks,
+						    uint32_t *size)
+{
+	return pm_api_clock_get_all_topology(first, nclocks, size);
+}
+
 /**
  * pm_clock_get_fixedfactor_params() - PM call to request a clock's fixed factor
  *				 parameters for fixed clock
@@ -1159,6 +1202,10 @@ enum pm_ret_status pm_query_data(enum pm_query_id qid,
 		ret = pm_clock_get_num_clocks(&data[1]);
 		data[0] = (unsigned int)ret;
 		break;
+	case PM_QID_CLOCK_GET_ALL_TOPOLOGY:
+		ret = pm_clock_get_all_topology(arg1, &data[1], &data[2]);
+		data[0] = (unsigned int)ret;
+		break;
 	default:
 		ret = PM_RET_ERROR_ARGS;
 		WARN("Unimplemented query service call: 0x%x\n", qid);
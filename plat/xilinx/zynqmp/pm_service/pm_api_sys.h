@@ -24,6 +24,7 @@ enum pm_query_id {
 	PM_QID_PINCTRL_GET_FUNCTION_GROUPS,
 	PM_QID_PINCTRL_GET_PIN_GROUPS,
 	PM_QID_CLOCK_GET_NUM_CLOCKS,
+	PM_QID_CLOCK_GET_ALL_TOPOLOGY,
 };
 
 /**********************************************************
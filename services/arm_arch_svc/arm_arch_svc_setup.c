@@ -10,6 +10,7 @@
 #include <runtime_svc.h>
 #include <smccc.h>
 #include <smccc_helpers.h>
+#include <utils_def.h>
 #include <wa_cve_2017_5715.h>
 #include <wa_cve_2018_3639.h>
 
@@ -121,12 +122,45 @@ static uintptr_t arm_arch_svc_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if RT_SVC_FID_HANDLERS
+/*
+ * None of the Arm Architecture Service calls does more than returning values,
+ * so they are all bound to its handler as leaf calls.
+ */
+static int32_t arm_arch_svc_setup(void)
+{
+	static const uint32_t leaf_fids[] = {
+		SMCCC_VERSION,
+		SMCCC_ARCH_FEATURES,
+#if WORKAROUND_CVE_2017_5715
+		SMCCC_ARCH_WORKAROUND_1,
+#endif
+#if WORKAROUND_CVE_2018_3639
+		SMCCC_ARCH_WORKAROUND_2,
+#endif
+	};
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(leaf_fids); i++) {
+		if (runtime_svc_register_leaf_fid(leaf_fids[i],
+				arm_arch_svc_smc_handler) != 0)
+			WARN("Failed to bind SMC 0x%x to its handler\n",
+			     leaf_fids[i]);
+	}
+
+	return 0;
+}
+#define ARM_ARCH_SVC_SETUP	arm_arch_svc_setup
+#else
+#define ARM_ARCH_SVC_SETUP	NULL
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Register Standard Service Calls as runtime service */
 DECLARE_RT_SVC(
 		arm_arch_svc,
 		OEN_ARM_START,
 		OEN_ARM_END,
 		SMC_TYPE_FAST,
-		NULL,
+		ARM_ARCH_SVC_SETUP,
 		arm_arch_svc_smc_handler
 );
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2013-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -43,6 +43,9 @@ optee_context_t opteed_sp_context[OPTEED_CORE_COUNT];
 uint32_t opteed_rw;
 
 static int32_t opteed_init(void);
+#if RT_SVC_FID_HANDLERS
+static void opteed_register_fid_handlers(void);
+#endif
 
 /*******************************************************************************
  * This function is the handler registered for S-EL1 interrupts by the
@@ -134,6 +137,15 @@ static int32_t opteed_setup(void)
 				dt_addr,
 				&opteed_sp_context[linear_id]);
 
+#if RT_SVC_FID_HANDLERS
+	opteed_register_fid_handlers();
+#endif
+
+	/* The AArch32 EL1 registers are only used by an AArch32 OPTEE */
+	cm_set_el1_sysregs_groups(CTX_EL1_SYSREGS_KERNEL |
+				  ((opteed_rw == OPTEE_AARCH32) ?
+				   CTX_EL1_SYSREGS_AARCH32 : 0U));
+
 	/*
 	 * All OPTEED initialization done. Now register our init function with
 	 * BL31 for deferred invocation
@@ -179,6 +191,101 @@ static int32_t opteed_init(void)
 }
 
 
+/*******************************************************************************
+ * This function passes a fresh request from the non-secure client to OPTEE.
+ * The parameters are in x1-x7. It saves the non-secure state and arranges the
+ * entry into OPTEE, which will take place upon exit from the SMC handler.
+ ******************************************************************************/
+static uintptr_t opteed_enter_optee(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 void *handle)
+{
+	uint32_t linear_id = plat_my_core_pos();
+	optee_context_t *optee_ctx = &opteed_sp_context[linear_id];
+
+	assert(handle == cm_get_context(NON_SECURE));
+
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+	/*
+	 * We are done stashing the non-secure context. Ask the
+	 * OPTEE to do the work now.
+	 */
+
+	/*
+	 * Verify if there is a valid context to use, copy the
+	 * operation type and parameters to the secure context
+	 * and jump to the fast smc entry point in the secure
+	 * payload.
+	 */
+	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
+
+	/* Set appropriate entry for SMC.
+	 * We expect OPTEE to manage the PSTATE.I and PSTATE.F
+	 * flags as appropriate.
+	 */
+	if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST) {
+		cm_set_elr_el3(SECURE, (uint64_t)
+				&optee_vector_table->fast_smc_entry);
+	} else {
+		cm_set_elr_el3(SECURE, (uint64_t)
+				&optee_vector_table->yield_smc_entry);
+	}
+
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		      CTX_GPREG_X4,
+		      read_ctx_reg(get_gpregs_ctx(handle),
+				   CTX_GPREG_X4));
+	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		      CTX_GPREG_X5,
+		      read_ctx_reg(get_gpregs_ctx(handle),
+				   CTX_GPREG_X5));
+	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		      CTX_GPREG_X6,
+		      read_ctx_reg(get_gpregs_ctx(handle),
+				   CTX_GPREG_X6));
+	/* Propagate hypervisor client ID */
+	write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
+		      CTX_GPREG_X7,
+		      read_ctx_reg(get_gpregs_ctx(handle),
+				   CTX_GPREG_X7));
+
+	SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
+}
+
+/*******************************************************************************
+ * This function returns the result from the secure client of an earlier
+ * request to the non-secure client. The results are in x1-x4. It copies them
+ * into the non-secure context, saves the secure state and returns to the
+ * non-secure state.
+ ******************************************************************************/
+static uintptr_t opteed_return_call_done(u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *handle)
+{
+	cpu_context_t *ns_cpu_context;
+
+	assert(handle == cm_get_context(SECURE));
+	cm_el1_sysregs_context_save(SECURE);
+
+	/* Get a reference to the non-secure context */
+	ns_cpu_context = cm_get_context(NON_SECURE);
+	assert(ns_cpu_context);
+
+	/* Restore non-secure state */
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
+}
+
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -205,66 +312,8 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 	 * Determine which security state this SMC originated from
 	 */
 
-	if (is_caller_non_secure(flags)) {
-		/*
-		 * This is a fresh request from the non-secure client.
-		 * The parameters are in x1 and x2. Figure out which
-		 * registers need to be preserved, save the non-secure
-		 * state and send the request to the secure payload.
-		 */
-		assert(handle == cm_get_context(NON_SECURE));
-
-		cm_el1_sysregs_context_save(NON_SECURE);
-
-		/*
-		 * We are done stashing the non-secure context. Ask the
-		 * OPTEE to do the work now.
-		 */
-
-		/*
-		 * Verify if there is a valid context to use, copy the
-		 * operation type and parameters to the secure context
-		 * and jump to the fast smc entry point in the secure
-		 * payload. Entry into S-EL1 will take place upon exit
-		 * from this function.
-		 */
-		assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
-
-		/* Set appropriate entry for SMC.
-		 * We expect OPTEE to manage the PSTATE.I and PSTATE.F
-		 * flags as appropriate.
-		 */
-		if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST) {
-			cm_set_elr_el3(SECURE, (uint64_t)
-					&optee_vector_table->fast_smc_entry);
-		} else {
-			cm_set_elr_el3(SECURE, (uint64_t)
-					&optee_vector_table->yield_smc_entry);
-		}
-
-		cm_el1_sysregs_context_restore(SECURE);
-		cm_set_next_eret_context(SECURE);
-
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
-			      CTX_GPREG_X4,
-			      read_ctx_reg(get_gpregs_ctx(handle),
-					   CTX_GPREG_X4));
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
-			      CTX_GPREG_X5,
-			      read_ctx_reg(get_gpregs_ctx(handle),
-					   CTX_GPREG_X5));
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
-			      CTX_GPREG_X6,
-			      read_ctx_reg(get_gpregs_ctx(handle),
-					   CTX_GPREG_X6));
-		/* Propagate hypervisor client ID */
-		write_ctx_reg(get_gpregs_ctx(&optee_ctx->cpu_ctx),
-			      CTX_GPREG_X7,
-			      read_ctx_reg(get_gpregs_ctx(handle),
-					   CTX_GPREG_X7));
-
-		SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
-	}
+	if (is_caller_non_secure(flags))
+		return opteed_enter_optee(smc_fid, x1, x2, x3, handle);
 
 	/*
 	 * Returning from OPTEE
@@ -353,24 +402,7 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 	 * either case execution should resume in the normal world.
 	 */
 	case TEESMC_OPTEED_RETURN_CALL_DONE:
-		/*
-		 * This is the result from the secure client of an
-		 * earlier request. The results are in x0-x3. Copy it
-		 * into the non-secure context, save the secure state
-		 * and return to the non-secure state.
-		 */
-		assert(handle == cm_get_context(SECURE));
-		cm_el1_sysregs_context_save(SECURE);
-
-		/* Get a reference to the non-secure context */
-		ns_cpu_context = cm_get_context(NON_SECURE);
-		assert(ns_cpu_context);
-
-		/* Restore non-secure state */
-		cm_el1_sysregs_context_restore(NON_SECURE);
-		cm_set_next_eret_context(NON_SECURE);
-
-		SMC_RET4(ns_cpu_context, x1, x2, x3, x4);
+		return opteed_return_call_done(x1, x2, x3, x4, handle);
 
 	/*
 	 * OPTEE has finished handling a S-EL1 FIQ interrupt. Execution
@@ -396,6 +428,105 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 	}
 }
 
+#if RT_SVC_FID_HANDLERS
+/*******************************************************************************
+ * Handlers bound to the SMCs made on every OPTEE invocation: the yielding calls
+ * of the non-secure client and the return of OPTEE from them. They skip the
+ * dispatch by the runtime service framework and by opteed_smc_handler(), and
+ * fall back on the latter for any other caller.
+ ******************************************************************************/
+static uintptr_t opteed_yield_smc_handler(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *cookie,
+			 void *handle,
+			 u_register_t flags)
+{
+	if (is_caller_non_secure(flags))
+		return opteed_enter_optee(smc_fid, x1, x2, x3, handle);
+
+	return opteed_smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle,
+				  flags);
+}
+
+/*
+ * Return of the non-secure client from an RPC of OPTEE. The call is made on
+ * every RPC and always resumes the suspended OPTEE thread through the yielding
+ * call entry, so the secure context of this cpu is set up directly. OPTEE
+ * takes the thread id and the results of the RPC from x1-x5 and the hypervisor
+ * client ID from x7.
+ */
+static uintptr_t opteed_return_from_rpc_smc_handler(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *cookie,
+			 void *handle,
+			 u_register_t flags)
+{
+	optee_context_t *optee_ctx;
+	gp_regs_t *ns_gpregs, *s_gpregs;
+
+	if (is_caller_secure(flags))
+		return opteed_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					  handle, flags);
+
+	assert(handle == cm_get_context(NON_SECURE));
+
+	optee_ctx = &opteed_sp_context[plat_my_core_pos()];
+	assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
+
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+	write_ctx_reg(get_el3state_ctx(&optee_ctx->cpu_ctx), CTX_ELR_EL3,
+		      (uint64_t)&optee_vector_table->yield_smc_entry);
+
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	ns_gpregs = get_gpregs_ctx(handle);
+	s_gpregs = get_gpregs_ctx(&optee_ctx->cpu_ctx);
+	write_ctx_reg(s_gpregs, CTX_GPREG_X4,
+		      read_ctx_reg(ns_gpregs, CTX_GPREG_X4));
+	write_ctx_reg(s_gpregs, CTX_GPREG_X5,
+		      read_ctx_reg(ns_gpregs, CTX_GPREG_X5));
+	write_ctx_reg(s_gpregs, CTX_GPREG_X7,
+		      read_ctx_reg(ns_gpregs, CTX_GPREG_X7));
+
+	SMC_RET4(&optee_ctx->cpu_ctx, smc_fid, x1, x2, x3);
+}
+
+static uintptr_t opteed_call_done_smc_handler(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *cookie,
+			 void *handle,
+			 u_register_t flags)
+{
+	if (is_caller_secure(flags))
+		return opteed_return_call_done(x1, x2, x3, x4, handle);
+
+	return opteed_smc_handler(smc_fid, x1, x2, x3, x4, cookie, handle,
+				  flags);
+}
+
+static void opteed_register_fid_handlers(void)
+{
+	if ((runtime_svc_register_fid(OPTEE_SMC_CALL_WITH_ARG,
+				opteed_yield_smc_handler) != 0) ||
+	    (runtime_svc_register_fid(OPTEE_SMC_CALL_RETURN_FROM_RPC,
+				opteed_return_from_rpc_smc_handler) != 0) ||
+	    (runtime_svc_register_fid(TEESMC_OPTEED_RETURN_CALL_DONE,
+				opteed_call_done_smc_handler) != 0))
+		WARN("OPTEED: Failed to bind SMCs to their handlers\n");
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Define an OPTEED runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
 	opteed_fast,
@@ -120,4 +120,11 @@
 #define TEESMC_OPTEED_RETURN_SYSTEM_RESET_DONE \
 	TEESMC_OPTEED_RV(TEESMC_OPTEED_FUNCID_RETURN_SYSTEM_RESET_DONE)
 
+/*
+ * Yielding calls made by the normal world on every OPTEE invocation, as defined
+ * in optee_smc.h in OPTEE
+ */
+#define OPTEE_SMC_CALL_RETURN_FROM_RPC	0x32000003
+#define OPTEE_SMC_CALL_WITH_ARG		0x32000004
+
 #endif /*TEESMC_OPTEED_H*/
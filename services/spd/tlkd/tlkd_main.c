@@ -21,6 +21,7 @@
 #include <debug.h>
 #include <errno.h>
 #include <platform.h>
+#include <pmf.h>
 #include <runtime_svc.h>
 #include <stddef.h>
 #include <tlk.h>
@@ -29,6 +30,11 @@
 
 extern const spd_pm_ops_t tlkd_pm_ops;
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+PMF_REGISTER_SERVICE_SMC(tlkd_svc, PMF_TLKD_SVC_ID, TLKD_PMF_TOTAL_IDS,
+	PMF_STORE_ENABLE)
+#endif
+
 /*******************************************************************************
  * Per-cpu Secure Payload state
  ******************************************************************************/
@@ -45,6 +51,9 @@ DEFINE_SVC_UUID2(tlk_uuid,
 	0x46, 0x1f, 0xba, 0x97, 0x7f, 0x63);
 
 static int32_t tlkd_init(void);
+#if RT_SVC_FID_HANDLERS
+static void tlkd_register_fid_handlers(void);
+#endif
 
 /*******************************************************************************
  * Secure Payload Dispatcher setup. The SPD finds out the SP entrypoint and type
@@ -84,6 +93,10 @@ static int32_t tlkd_setup(void)
 		tlk_ep_info->pc,
 		&tlk_ctx);
 
+#if RT_SVC_FID_HANDLERS
+	tlkd_register_fid_handlers();
+#endif
+
 	/*
 	 * All TLK SPD initialization done. Now register our init function
 	 * with BL31 for deferred invocation
@@ -125,6 +138,77 @@ static int32_t tlkd_init(void)
 	return tlkd_synchronous_sp_entry(&tlk_ctx);
 }
 
+/*******************************************************************************
+ * This function sends a yielding SMC call from the non-secure client to TLK,
+ * either a fresh request or the resumption of a preempted one. The caller has
+ * checked the state of the yielding call. The non-secure state is saved and the
+ * entry into TLK takes place upon exit from the SMC handler.
+ ******************************************************************************/
+static uintptr_t tlkd_enter_yield_smc(uint32_t smc_fid,
+				      u_register_t x1,
+				      u_register_t x2,
+				      u_register_t x3)
+{
+	gp_regs_t *gp_regs;
+
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+	/*
+	 * Verify if there is a valid context to use.
+	 */
+	assert(&tlk_ctx.cpu_ctx == cm_get_context(SECURE));
+
+	/*
+	 * Mark the SP state as active.
+	 */
+	set_yield_smc_active_flag(tlk_ctx.state);
+
+	/*
+	 * We are done stashing the non-secure context. Ask the
+	 * secure payload to do the work now.
+	 */
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+
+	/*
+	 * TLK is a 32-bit Trusted OS and so expects the SMC
+	 * arguments via r0-r7. TLK expects the monitor frame
+	 * registers to be 64-bits long. Hence, we pass x0 in
+	 * r0-r1, x1 in r2-r3, x3 in r4-r5 and x4 in r6-r7.
+	 *
+	 * As smc_fid is a uint32 value, r1 contains 0.
+	 */
+	gp_regs = get_gpregs_ctx(&tlk_ctx.cpu_ctx);
+	write_ctx_reg(gp_regs, CTX_GPREG_X4, (uint32_t)x2);
+	write_ctx_reg(gp_regs, CTX_GPREG_X5, (uint32_t)(x2 >> 32));
+	write_ctx_reg(gp_regs, CTX_GPREG_X6, (uint32_t)x3);
+	write_ctx_reg(gp_regs, CTX_GPREG_X7, (uint32_t)(x3 >> 32));
+	SMC_RET4(&tlk_ctx.cpu_ctx, smc_fid, 0, (uint32_t)x1,
+		(uint32_t)(x1 >> 32));
+}
+
+/*******************************************************************************
+ * This function resumes the yielding SMC call that TLK reported as preempted.
+ * The caller has checked that there is such a call. The time the call spent
+ * preempted is accounted in the statistics.
+ ******************************************************************************/
+static uintptr_t tlkd_resume_yield_smc(u_register_t x1,
+				       u_register_t x2,
+				       u_register_t x3)
+{
+	tlk_yield_stats_t *stats = &tlk_ctx.yield_stats;
+
+	stats->resumes++;
+	stats->preempt_ticks += read_cntpct_el0() - stats->preempt_ts;
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(tlkd_svc, TLKD_PMF_YIELD_RESUME,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
+	return tlkd_enter_yield_smc(TLK_RESUME_FID, x1, x2, x3);
+}
+
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -143,7 +227,6 @@ static uintptr_t tlkd_smc_handler(uint32_t smc_fid,
 			 u_register_t flags)
 {
 	cpu_context_t *ns_cpu_context;
-	gp_regs_t *gp_regs;
 	uint32_t ns;
 	uint64_t par;
 
@@ -169,6 +252,14 @@ static uintptr_t tlkd_smc_handler(uint32_t smc_fid,
 			SMC_RET1(handle, SMC_UNK);
 
 		assert(handle == cm_get_context(SECURE));
+
+		tlk_ctx.yield_stats.preempts++;
+		tlk_ctx.yield_stats.preempt_ts = read_cntpct_el0();
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(tlkd_svc, TLKD_PMF_YIELD_PREEMPT,
+				      PMF_NO_CACHE_MAINT);
+#endif
+
 		cm_el1_sysregs_context_save(SECURE);
 
 		/* Get a reference to the non-secure context */
@@ -226,45 +317,19 @@ static uintptr_t tlkd_smc_handler(uint32_t smc_fid,
 		if (smc_fid == TLK_RESUME_FID) {
 			if (!get_yield_smc_active_flag(tlk_ctx.state))
 				SMC_RET1(handle, SMC_UNK);
-		} else {
-			if (get_yield_smc_active_flag(tlk_ctx.state))
-				SMC_RET1(handle, SMC_UNK);
-		}
 
-		cm_el1_sysregs_context_save(NON_SECURE);
-
-		/*
-		 * Verify if there is a valid context to use.
-		 */
-		assert(&tlk_ctx.cpu_ctx == cm_get_context(SECURE));
+			return tlkd_resume_yield_smc(x1, x2, x3);
+		}
 
-		/*
-		 * Mark the SP state as active.
-		 */
-		set_yield_smc_active_flag(tlk_ctx.state);
+		if (get_yield_smc_active_flag(tlk_ctx.state))
+			SMC_RET1(handle, SMC_UNK);
 
-		/*
-		 * We are done stashing the non-secure context. Ask the
-		 * secure payload to do the work now.
-		 */
-		cm_el1_sysregs_context_restore(SECURE);
-		cm_set_next_eret_context(SECURE);
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(tlkd_svc, TLKD_PMF_YIELD_START,
+				      PMF_NO_CACHE_MAINT);
+#endif
 
-		/*
-		 * TLK is a 32-bit Trusted OS and so expects the SMC
-		 * arguments via r0-r7. TLK expects the monitor frame
-		 * registers to be 64-bits long. Hence, we pass x0 in
-		 * r0-r1, x1 in r2-r3, x3 in r4-r5 and x4 in r6-r7.
-		 *
-		 * As smc_fid is a uint32 value, r1 contains 0.
-		 */
-		gp_regs = get_gpregs_ctx(&tlk_ctx.cpu_ctx);
-		write_ctx_reg(gp_regs, CTX_GPREG_X4, (uint32_t)x2);
-		write_ctx_reg(gp_regs, CTX_GPREG_X5, (uint32_t)(x2 >> 32));
-		write_ctx_reg(gp_regs, CTX_GPREG_X6, (uint32_t)x3);
-		write_ctx_reg(gp_regs, CTX_GPREG_X7, (uint32_t)(x3 >> 32));
-		SMC_RET4(&tlk_ctx.cpu_ctx, smc_fid, 0, (uint32_t)x1,
-			(uint32_t)(x1 >> 32));
+		return tlkd_enter_yield_smc(smc_fid, x1, x2, x3);
 
 	/*
 	 * Translate NS/EL1-S virtual addresses.
@@ -311,6 +376,11 @@ static uintptr_t tlkd_smc_handler(uint32_t smc_fid,
 		 */
 		clr_yield_smc_active_flag(tlk_ctx.state);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+		PMF_CAPTURE_TIMESTAMP(tlkd_svc, TLKD_PMF_YIELD_DONE,
+				      PMF_NO_CACHE_MAINT);
+#endif
+
 		/* Get a reference to the non-secure context */
 		ns_cpu_context = cm_get_context(NON_SECURE);
 		assert(ns_cpu_context);
@@ -404,6 +474,42 @@ static uintptr_t tlkd_smc_handler(uint32_t smc_fid,
 	SMC_RET1(handle, SMC_UNK);
 }
 
+#if RT_SVC_FID_HANDLERS
+/*******************************************************************************
+ * Handler bound to TLK_RESUME_FID, which the non-secure client makes after each
+ * preemption of a yielding call. It skips the dispatch by the runtime service
+ * framework and by tlkd_smc_handler(). Only the boot CPU and the preempted
+ * call flag are checked before resuming, as they protect TLK from an entry on
+ * another CPU or at a stale preemption point. Other callers fall back on
+ * tlkd_smc_handler().
+ ******************************************************************************/
+static uintptr_t tlkd_resume_smc_handler(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *cookie,
+			 void *handle,
+			 u_register_t flags)
+{
+	if (is_caller_secure(flags) || (boot_cpu != plat_my_core_pos()))
+		return tlkd_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					handle, flags);
+
+	if (!get_yield_smc_active_flag(tlk_ctx.state))
+		SMC_RET1(handle, SMC_UNK);
+
+	return tlkd_resume_yield_smc(x1, x2, x3);
+}
+
+static void tlkd_register_fid_handlers(void)
+{
+	if (runtime_svc_register_fid(TLK_RESUME_FID,
+				     tlkd_resume_smc_handler) != 0)
+		WARN("TLKD: Failed to bind TLK_RESUME_FID to its handler\n");
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Define a SPD runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
 	tlkd_tos_fast,
@@ -75,6 +75,19 @@
 #include <cassert.h>
 #include <stdint.h>
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+/*
+ * Local time-stamp ids of the yielding calls of TLK, in the PMF service
+ * PMF_TLKD_SVC_ID. PREEMPT is taken when TLK reports that a call has been
+ * preempted and RESUME when the non-secure client resumes it.
+ */
+#define TLKD_PMF_YIELD_START	U(0)
+#define TLKD_PMF_YIELD_PREEMPT	U(1)
+#define TLKD_PMF_YIELD_RESUME	U(2)
+#define TLKD_PMF_YIELD_DONE	U(3)
+#define TLKD_PMF_TOTAL_IDS	U(4)
+#endif
+
 /* AArch64 callee saved general purpose register context structure. */
 DEFINE_REG_STRUCT(c_rt_regs, TLKD_C_RT_CTX_ENTRIES);
 
@@ -86,6 +99,22 @@ DEFINE_REG_STRUCT(c_rt_regs, TLKD_C_RT_CTX_ENTRIES);
 CASSERT(TLKD_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
 	assert_tlkd_c_rt_regs_size_mismatch);
 
+/*******************************************************************************
+ * Statistics of the preemptions of the yielding calls of TLK, to be inspected
+ * from a debugger or a crash dump.
+ * 'preempts'      - number of times TLK reported a preempted call
+ * 'resumes'       - number of resumptions of a preempted call
+ * 'preempt_ticks' - system counter ticks spent preempted, from the preemption
+ *                   of each call to its resumption
+ * 'preempt_ts'    - system counter value at the last preemption
+ ******************************************************************************/
+typedef struct tlk_yield_stats {
+	uint64_t preempts;
+	uint64_t resumes;
+	uint64_t preempt_ticks;
+	uint64_t preempt_ts;
+} tlk_yield_stats_t;
+
 /*******************************************************************************
  * Structure which helps the SPD to maintain the per-cpu state of the SP.
  * 'state'          - collection of flags to track SP state e.g. on/off
@@ -93,6 +122,7 @@ CASSERT(TLKD_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into the SP.
  * 'cpu_ctx'        - space to maintain SP architectural state
+ * 'yield_stats'    - preemption statistics of the yielding calls
  * 'saved_tsp_args' - space to store arguments for TSP arithmetic operations
  *                    which will queried using the TSP_GET_ARGS SMC by TSP.
  ******************************************************************************/
@@ -101,6 +131,7 @@ typedef struct tlk_context {
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
+	tlk_yield_stats_t yield_stats;
 } tlk_context_t;
 
 /*******************************************************************************
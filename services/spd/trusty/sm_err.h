@@ -18,5 +18,10 @@
 #define SM_ERR_NOT_SUPPORTED		-8
 #define SM_ERR_NOT_ALLOWED		-9	/* SMC call not allowed */
 #define SM_ERR_END_OF_INPUT		-10
+#define SM_ERR_PANIC			-11
+#define SM_ERR_FIQ_INTERRUPTED		-12
+#define SM_ERR_CPU_IDLE			-13	/* SMC call waiting for another CPU */
+#define SM_ERR_NOP_INTERRUPTED		-14	/* Got interrupted. Call back with new SMC_SC_NOP */
+#define SM_ERR_NOP_DONE			-15	/* Cpu idle after SMC_SC_NOP (not an error) */
 
 #endif /* SM_ERR_H */
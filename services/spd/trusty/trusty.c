@@ -60,6 +60,12 @@ struct args trusty_context_switch_helper(void **sp, void *smc_params);
 
 static uint32_t current_vmid;
 
+/*
+ * Maximum number of calls to Trusty made by BL31 for one SMC_YC_NOP of the
+ * non-secure driver when TRUSTY_NOP_LOOP is set.
+ */
+#define TRUSTY_NOP_LOOP_MAX	16U
+
 static struct trusty_cpu_ctx *get_trusty_ctx(void)
 {
 	return &trusty_cpu_ctx[plat_my_core_pos()];
@@ -101,10 +107,12 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 	 * To avoid the additional overhead in PSCI flow, skip FP context
 	 * saving/restoring in case of CPU suspend and resume, asssuming that
 	 * when it's needed the PSCI caller has preserved FP context before
-	 * going here.
+	 * going here. The lazy FP switch has no cost when Trusty doesn't use
+	 * FP, so it is always done.
 	 */
-	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_save(get_fpregs_ctx(cm_get_context(security_state)));
+	if ((CTX_LAZY_FPREGS != 0) ||
+	    (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME))
+		cm_fpregs_context_save(security_state);
 	cm_el1_sysregs_context_save(security_state);
 
 	ctx->saved_security_state = security_state;
@@ -113,14 +121,40 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 	assert(ctx->saved_security_state == !security_state);
 
 	cm_el1_sysregs_context_restore(security_state);
-	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+	if ((CTX_LAZY_FPREGS != 0) ||
+	    (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME))
+		cm_fpregs_context_restore(security_state);
 
 	cm_set_next_eret_context(security_state);
 
 	return ret;
 }
 
+/*
+ * Forward an SMC_YC_NOP to Trusty. With TRUSTY_NOP_LOOP, Trusty is called
+ * again with a new NOP while it reports that it has more work to do, as the
+ * non-secure driver would do, unless an interrupt is pending. Pending
+ * interrupts are left to the non-secure world, which Trusty returned to for
+ * them.
+ */
+static struct args trusty_nop(u_register_t x1, u_register_t x2,
+			      u_register_t x3)
+{
+	struct args ret;
+	unsigned int n = 0U;
+
+	ret = trusty_context_switch(NON_SECURE, SMC_YC_NOP, x1, x2, x3);
+
+	while ((TRUSTY_NOP_LOOP != 0) &&
+	       (ret.r0 == (uint64_t)SM_ERR_NOP_INTERRUPTED) &&
+	       (++n < TRUSTY_NOP_LOOP_MAX) &&
+	       (plat_ic_get_pending_interrupt_type() == INTR_TYPE_INVAL)) {
+		ret = trusty_context_switch(NON_SECURE, SMC_YC_NOP, 0, 0, 0);
+	}
+
+	return ret;
+}
+
 static uint64_t trusty_fiq_handler(uint32_t id,
 				   uint32_t flags,
 				   void *handle,
@@ -268,8 +302,11 @@ static uintptr_t trusty_smc_handler(uint32_t smc_fid,
 				SMC_RET1(handle, SM_ERR_BUSY);
 			}
 			current_vmid = vmid;
-			ret = trusty_context_switch(NON_SECURE, smc_fid, x1,
-				x2, x3);
+			if (smc_fid == SMC_YC_NOP)
+				ret = trusty_nop(x1, x2, x3);
+			else
+				ret = trusty_context_switch(NON_SECURE, smc_fid,
+					x1, x2, x3);
 			current_vmid = 0;
 			SMC_RET1(handle, ret.r0);
 		}
@@ -293,7 +330,7 @@ static int32_t trusty_init(void)
 	ep_info = bl31_plat_get_next_image_ep_info(SECURE);
 	assert(ep_info);
 
-	fpregs_context_save(get_fpregs_ctx(cm_get_context(NON_SECURE)));
+	cm_fpregs_context_save(NON_SECURE);
 	cm_el1_sysregs_context_save(NON_SECURE);
 
 	cm_set_context(&ctx->cpu_ctx, SECURE);
@@ -310,7 +347,7 @@ static int32_t trusty_init(void)
 	}
 
 	cm_el1_sysregs_context_restore(SECURE);
-	fpregs_context_restore(get_fpregs_ctx(cm_get_context(SECURE)));
+	cm_fpregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
 	ctx->saved_security_state = ~0; /* initial saved state is invalid */
@@ -319,7 +356,7 @@ static int32_t trusty_init(void)
 	trusty_context_switch_helper(&ctx->saved_sp, &zero_args);
 
 	cm_el1_sysregs_context_restore(NON_SECURE);
-	fpregs_context_restore(get_fpregs_ctx(cm_get_context(NON_SECURE)));
+	cm_fpregs_context_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
 	return 1;
@@ -431,6 +468,10 @@ static int32_t trusty_setup(void)
 	(void)memset(&ep_info->args, 0, sizeof(ep_info->args));
 	plat_trusty_set_boot_args(&ep_info->args);
 
+	/* The AArch32 EL1 registers are only used by a 32 bit image */
+	cm_set_el1_sysregs_groups(CTX_EL1_SYSREGS_KERNEL |
+				  (aarch32 ? CTX_EL1_SYSREGS_AARCH32 : 0U));
+
 	/* register init handler */
 	bl31_register_bl32_init(trusty_init);
 
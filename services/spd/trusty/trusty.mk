@@ -15,4 +15,11 @@ endif
 
 NEED_BL32		:=	yes
 
+# Flag used to make BL31 call Trusty again on SMC_YC_NOP while it has more work
+# and no interrupt is pending, instead of returning to the non-secure driver.
+TRUSTY_NOP_LOOP		:=	0
+
+$(eval $(call assert_boolean,TRUSTY_NOP_LOOP))
+$(eval $(call add_define,TRUSTY_NOP_LOOP))
+
 CTX_INCLUDE_FPREGS	:=	1
@@ -23,13 +23,20 @@
 #include <ehf.h>
 #include <errno.h>
 #include <platform.h>
+#include <pmf.h>
 #include <runtime_svc.h>
+#include <secure_budget.h>
 #include <stddef.h>
 #include <string.h>
 #include <tsp.h>
 #include <uuid.h>
 #include "tspd_private.h"
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+PMF_REGISTER_SERVICE_SMC(tspd_svc, PMF_TSPD_SVC_ID, TSPD_PMF_TOTAL_IDS,
+	PMF_STORE_ENABLE)
+#endif
+
 /*******************************************************************************
  * Address of the entrypoint vector table in the Secure Payload. It is
  * initialised once on the primary core after a cold boot.
@@ -48,6 +55,9 @@ DEFINE_SVC_UUID2(tsp_uuid,
 	0x71, 0x68, 0xca, 0x50, 0xf3, 0xfa);
 
 int32_t tspd_init(void);
+#if RT_SVC_FID_HANDLERS
+static void tspd_register_fid_handlers(void);
+#endif
 
 /*
  * This helper function handles Secure EL1 preemption. The preemption could be
@@ -60,6 +70,16 @@ uint64_t tspd_handle_sp_preemption(void *handle)
 	cpu_context_t *ns_cpu_context;
 
 	assert(handle == cm_get_context(SECURE));
+
+#if SECURE_TIME_BUDGET
+	secure_budget_stop();
+#endif
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(tspd_svc, TSPD_PMF_YIELD_PREEMPT,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
 	cm_el1_sysregs_context_save(SECURE);
 	/* Get a reference to the non-secure context */
 	ns_cpu_context = cm_get_context(NON_SECURE);
@@ -174,6 +194,20 @@ static uint64_t tspd_ns_interrupt_handler(uint32_t id,
 }
 #endif
 
+#if SECURE_TIME_BUDGET
+/*******************************************************************************
+ * This function is called by BL31 when the time budget of the Yielding SMC Call
+ * being processed by the TSP runs out. The call is preempted as if by a Non
+ * secure interrupt.
+ ******************************************************************************/
+static uint64_t tspd_budget_preempt(void *handle)
+{
+	disable_intr_rm_local(INTR_TYPE_NS, SECURE);
+
+	return tspd_handle_sp_preemption(handle);
+}
+#endif
+
 /*******************************************************************************
  * Secure Payload Dispatcher setup. The SPD finds out the SP entrypoint and type
  * (aarch32/aarch64) if not already known and initialises the context for entry
@@ -217,6 +251,13 @@ static int32_t tspd_setup(void)
 				tsp_ep_info->pc,
 				&tspd_sp_context[linear_id]);
 
+	/* An AArch64 TSP doesn't use the AArch32 EL1 registers */
+	cm_set_el1_sysregs_groups(CTX_EL1_SYSREGS_KERNEL);
+
+#if RT_SVC_FID_HANDLERS
+	tspd_register_fid_handlers();
+#endif
+
 #if TSP_INIT_ASYNC
 	bl31_set_next_image_type(SECURE);
 #else
@@ -265,6 +306,51 @@ int32_t tspd_init(void)
 }
 
 
+/*******************************************************************************
+ * This function resumes the Yielding SMC Call preempted on this cpu, at the
+ * point where the TSP was preempted. The caller has checked that there is such
+ * a call. The non-secure state is saved and the entry into the TSP takes place
+ * upon exit from the SMC handler.
+ ******************************************************************************/
+static uintptr_t tspd_resume_yield_smc(tsp_context_t *tsp_ctx)
+{
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(tspd_svc, TSPD_PMF_YIELD_RESUME,
+			      PMF_NO_CACHE_MAINT);
+#endif
+
+#if TSP_NS_INTR_ASYNC_PREEMPT
+	/*
+	 * Enable the routing of NS interrupts to EL3 during resumption
+	 * of a Yielding SMC Call on this core.
+	 */
+	enable_intr_rm_local(INTR_TYPE_NS, SECURE);
+#endif
+
+#if EL3_EXCEPTION_HANDLING
+	/*
+	 * Allow the resumed yielding SMC processing to be preempted by
+	 * Non-secure interrupts. Also, supply the preemption return
+	 * code for TSP.
+	 */
+	ehf_allow_ns_preemption(TSP_PREEMPTED);
+#endif
+
+#if SECURE_TIME_BUDGET
+	secure_budget_start(tspd_budget_preempt);
+#endif
+
+	/*
+	 * We just need to return to the preempted point in TSP and the
+	 * execution will resume as normal.
+	 */
+	cm_el1_sysregs_context_restore(SECURE);
+	cm_set_next_eret_context(SECURE);
+	SMC_RET0(&tsp_ctx->cpu_ctx);
+}
+
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
  * range from the non-secure state as defined in the SMC Calling Convention
@@ -532,6 +618,11 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 				cm_set_elr_el3(SECURE, (uint64_t)
 						&tsp_vectors->fast_smc_entry);
 			} else {
+#if ENABLE_RUNTIME_INSTRUMENTATION
+				PMF_CAPTURE_TIMESTAMP(tspd_svc,
+						      TSPD_PMF_YIELD_START,
+						      PMF_NO_CACHE_MAINT);
+#endif
 				set_yield_smc_active_flag(tsp_ctx->state);
 				cm_set_elr_el3(SECURE, (uint64_t)
 						&tsp_vectors->yield_smc_entry);
@@ -556,6 +647,14 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 				 */
 				ehf_allow_ns_preemption(TSP_PREEMPTED);
 #endif
+
+#if SECURE_TIME_BUDGET
+				/*
+				 * Bound the time spent by the TSP in this call
+				 * even if it masks Non-secure interrupts.
+				 */
+				secure_budget_start(tspd_budget_preempt);
+#endif
 			}
 
 			cm_el1_sysregs_context_restore(SECURE);
@@ -579,7 +678,15 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 			cm_el1_sysregs_context_restore(NON_SECURE);
 			cm_set_next_eret_context(NON_SECURE);
 			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_YIELD) {
+#if ENABLE_RUNTIME_INSTRUMENTATION
+				PMF_CAPTURE_TIMESTAMP(tspd_svc,
+						      TSPD_PMF_YIELD_DONE,
+						      PMF_NO_CACHE_MAINT);
+#endif
 				clr_yield_smc_active_flag(tsp_ctx->state);
+#if SECURE_TIME_BUDGET
+				secure_budget_stop();
+#endif
 #if TSP_NS_INTR_ASYNC_PREEMPT
 				/*
 				 * Disable the routing of NS interrupts to EL3
@@ -639,8 +746,7 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 
 		/*
 		 * This is a resume request from the non-secure client.
-		 * save the non-secure state and send the request to
-		 * the secure payload.
+		 * Resume the preempted call if there is one.
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
@@ -648,35 +754,7 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 		if (!get_yield_smc_active_flag(tsp_ctx->state))
 			SMC_RET1(handle, SMC_UNK);
 
-		cm_el1_sysregs_context_save(NON_SECURE);
-
-		/*
-		 * We are done stashing the non-secure context. Ask the
-		 * secure payload to do the work now.
-		 */
-#if TSP_NS_INTR_ASYNC_PREEMPT
-		/*
-		 * Enable the routing of NS interrupts to EL3 during resumption
-		 * of a Yielding SMC Call on this core.
-		 */
-		enable_intr_rm_local(INTR_TYPE_NS, SECURE);
-#endif
-
-#if EL3_EXCEPTION_HANDLING
-		/*
-		 * Allow the resumed yielding SMC processing to be preempted by
-		 * Non-secure interrupts. Also, supply the preemption return
-		 * code for TSP.
-		 */
-		ehf_allow_ns_preemption(TSP_PREEMPTED);
-#endif
-
-		/* We just need to return to the preempted point in
-		 * TSP and the execution will resume as normal.
-		 */
-		cm_el1_sysregs_context_restore(SECURE);
-		cm_set_next_eret_context(SECURE);
-		SMC_RET0(&tsp_ctx->cpu_ctx);
+		return tspd_resume_yield_smc(tsp_ctx);
 
 		/*
 		 * This is a request from the secure payload for more arguments
@@ -713,6 +791,45 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 	SMC_RET1(handle, SMC_UNK);
 }
 
+#if RT_SVC_FID_HANDLERS
+/*******************************************************************************
+ * Handler bound to TSP_FID_RESUME, which the non-secure client makes after each
+ * preemption of a Yielding SMC Call. It skips the dispatch by the runtime
+ * service framework and by tspd_smc_handler(). Only the preempted call flag is
+ * checked before resuming, as it is what protects the TSP from an entry at a
+ * stale preemption point. Secure callers fall back on tspd_smc_handler().
+ ******************************************************************************/
+static uintptr_t tspd_resume_smc_handler(uint32_t smc_fid,
+			 u_register_t x1,
+			 u_register_t x2,
+			 u_register_t x3,
+			 u_register_t x4,
+			 void *cookie,
+			 void *handle,
+			 u_register_t flags)
+{
+	tsp_context_t *tsp_ctx;
+
+	if (is_caller_secure(flags))
+		return tspd_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+					handle, flags);
+
+	tsp_ctx = &tspd_sp_context[plat_my_core_pos()];
+
+	if (!get_yield_smc_active_flag(tsp_ctx->state))
+		SMC_RET1(handle, SMC_UNK);
+
+	return tspd_resume_yield_smc(tsp_ctx);
+}
+
+static void tspd_register_fid_handlers(void)
+{
+	if (runtime_svc_register_fid(TSP_FID_RESUME,
+				     tspd_resume_smc_handler) != 0)
+		WARN("TSPD: Failed to bind TSP_FID_RESUME to its handler\n");
+}
+#endif /* RT_SVC_FID_HANDLERS */
+
 /* Define a SPD runtime service descriptor for fast SMC calls */
 DECLARE_RT_SVC(
 	tspd_fast,
@@ -203,6 +203,20 @@ typedef struct tsp_context {
 /* TSPD power management handlers */
 extern const spd_pm_ops_t tspd_pm;
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+/*
+ * Local time-stamp ids of the yielding calls of the TSP, in the PMF service
+ * PMF_TSPD_SVC_ID. PREEMPT is taken when the TSP is preempted by a Non-secure
+ * interrupt, so the time a Non-secure interrupt waited behind the TSP is at
+ * most the time between the last START or RESUME and PREEMPT.
+ */
+#define TSPD_PMF_YIELD_START	U(0)
+#define TSPD_PMF_YIELD_PREEMPT	U(1)
+#define TSPD_PMF_YIELD_RESUME	U(2)
+#define TSPD_PMF_YIELD_DONE	U(3)
+#define TSPD_PMF_TOTAL_IDS	U(4)
+#endif
+
 /*******************************************************************************
  * Forward declarations
  ******************************************************************************/
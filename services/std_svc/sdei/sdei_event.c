@@ -11,13 +11,13 @@
 #define MAP_OFF(_map, _mapping) ((_map) - (_mapping)->map)
 
 /*
- * Get SDEI entry with the given mapping: on success, returns pointer to SDEI
- * entry. On error, returns NULL.
+ * Get SDEI entry with the given mapping, for the CPU 'cpu' if the event is
+ * private: on success, returns pointer to SDEI entry. On error, returns NULL.
  *
  * Both shared and private maps are stored in single-dimensional array. Private
  * event entries are kept for each PE forming a 2D array.
  */
-sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
+sdei_entry_t *get_cpu_event_entry(sdei_ev_map_t *map, unsigned int cpu)
 {
 	const sdei_mapping_t *mapping;
 	sdei_entry_t *cpu_priv_base;
@@ -33,7 +33,8 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 		idx = MAP_OFF(map, mapping);
 
 		/* Base of private mappings for this CPU */
-		base_idx = plat_my_core_pos() * ((unsigned int) mapping->num_maps);
+		assert(cpu < PLATFORM_CORE_COUNT);
+		base_idx = cpu * ((unsigned int) mapping->num_maps);
 		cpu_priv_base = &sdei_private_event_table[base_idx];
 
 		/*
@@ -49,6 +50,13 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/* Get SDEI entry with the given mapping, for this CPU if it's private */
+sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
+{
+	return get_cpu_event_entry(map, is_event_private(map) ?
+			plat_my_core_pos() : 0U);
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -73,6 +81,33 @@ sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared)
 	return NULL;
 }
 
+/*
+ * Find event mapping for a given event number in one mapping. The maps of each
+ * mapping are sorted in the increasing order of event number, as checked by
+ * sdei_class_init(), so this is a binary search.
+ */
+static sdei_ev_map_t *find_event_map_in(const sdei_mapping_t *mapping,
+		int ev_num)
+{
+	sdei_ev_map_t *map;
+	size_t lo = 0U, hi = mapping->num_maps, mid;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		map = &mapping->map[mid];
+
+		if (map->ev_num == ev_num)
+			return map;
+
+		if (map->ev_num < ev_num)
+			lo = mid + 1U;
+		else
+			hi = mid;
+	}
+
+	return NULL;
+}
+
 /*
  * Find event mapping for a given event number: On success returns pointer to
  * the event mapping. On error, returns NULL.
@@ -81,18 +116,12 @@ sdei_ev_map_t *find_event_map(int ev_num)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i, j;
+	unsigned int i;
 
-	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
-	 */
 	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
-			if (map->ev_num == ev_num)
-				return map;
-		}
+		map = find_event_map_in(mapping, ev_num);
+		if (map != NULL)
+			return map;
 	}
 
 	return NULL;
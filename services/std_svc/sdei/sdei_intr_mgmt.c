@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SDEI
+
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>
@@ -39,6 +41,11 @@ typedef struct sdei_dispatch_context {
 	/* CVE-2018-3639 mitigation state */
 	uint64_t disable_cve_2018_3639;
 #endif
+
+#if SDEI_EVENT_STATS
+	/* System counter at the time of dispatch */
+	uint64_t dispatch_ts;
+#endif
 } sdei_dispatch_context_t;
 
 /* Per-CPU SDEI state data */
@@ -150,6 +157,44 @@ static sdei_dispatch_context_t *get_outstanding_dispatch(void)
 	return &state->dispatch_stack[state->stack_top - 1U];
 }
 
+#if SDEI_EVENT_STATS
+/* Account a duration of 'ticks' in the statistics, the 'count'th one */
+static void update_time_stats(sdei_time_stats_t *stats, uint64_t ticks,
+		uint32_t count)
+{
+	if ((count == 1U) || (ticks < stats->min))
+		stats->min = ticks;
+	if (ticks > stats->max)
+		stats->max = ticks;
+	stats->total += ticks;
+}
+
+/*
+ * Account the dispatch of an event, whose interrupt was handled or whose
+ * explicit dispatch was requested at the system counter value 'start_ts'. The
+ * dispatch context must be the outstanding one.
+ */
+static void record_dispatch_stats(sdei_ev_map_t *map, sdei_entry_t *se,
+		uint64_t start_ts)
+{
+	sdei_dispatch_context_t *disp_ctx = get_outstanding_dispatch();
+	uint64_t now = read_cntpct_el0();
+
+	assert((disp_ctx != NULL) && (disp_ctx->map == map));
+	disp_ctx->dispatch_ts = now;
+
+	if (is_event_shared(map))
+		sdei_map_lock(map);
+
+	se->stats.dispatches++;
+	update_time_stats(&se->stats.dispatch_lat, now - start_ts,
+			se->stats.dispatches);
+
+	if (is_event_shared(map))
+		sdei_map_unlock(map);
+}
+#endif
+
 static sdei_dispatch_context_t *save_event_ctx(sdei_ev_map_t *map,
 		void *tgt_ctx)
 {
@@ -290,6 +335,10 @@ static void handle_masked_trigger(sdei_ev_map_t *map, sdei_entry_t *se,
 	if (map->ev_num == SDEI_EVENT_0)
 		return;
 
+#if SDEI_EVENT_STATS
+	se->stats.masked_triggers++;
+#endif
+
 	/*
 	 * For a private event, or for a shared event specifically routed to
 	 * this CPU, we disable interrupt, leave the interrupt pending, and do
@@ -334,19 +383,27 @@ static void handle_masked_trigger(sdei_ev_map_t *map, sdei_entry_t *se,
 	plat_ic_end_of_interrupt(intr_raw);
 }
 
-/* SDEI main interrupt handler */
-int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
-		void *cookie)
+/*
+ * Handle the acknowledged SDEI interrupt 'intr_raw', which interrupted the
+ * 'sec_state' world whose context is 'handle'. Return the map of the event if
+ * it was dispatched, in which case the Non-secure context is active when this
+ * returns and the Secure context, if interrupted, remains to be resumed.
+ * Return NULL otherwise.
+ */
+static sdei_ev_map_t *sdei_handle_intr(uint32_t intr_raw,
+		unsigned int sec_state, void *handle)
 {
 	sdei_entry_t *se;
 	cpu_context_t *ctx;
 	sdei_ev_map_t *map;
 	const sdei_dispatch_context_t *disp_ctx;
-	unsigned int sec_state;
 	sdei_cpu_state_t *state;
 	uint32_t intr;
 	struct jmpbuf dispatch_jmp;
 	const uint64_t mpidr = read_mpidr_el1();
+#if SDEI_EVENT_STATS
+	const uint64_t intr_ts = read_cntpct_el0();
+#endif
 
 	/*
 	 * To handle an event, the following conditions must be true:
@@ -402,7 +459,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		if (is_event_shared(map))
 			sdei_map_unlock(map);
 
-		return 0;
+		return NULL;
 	}
 
 	/* Insert load barrier for signalled SDEI event */
@@ -438,7 +495,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		if (is_event_shared(map))
 			sdei_map_unlock(map);
 
-		return 0;
+		return NULL;
 	}
 
 	disp_ctx = get_outstanding_dispatch();
@@ -459,8 +516,6 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		assert(disp_ctx == NULL);
 	}
 
-	sec_state = get_interrupt_src_ss(flags);
-
 	if (is_event_shared(map))
 		sdei_map_unlock(map);
 
@@ -480,22 +535,14 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 
 	/* Synchronously dispatch event */
 	setup_ns_dispatch(map, se, ctx, &dispatch_jmp);
+#if SDEI_EVENT_STATS
+	record_dispatch_stats(map, se, intr_ts);
+#endif
 	begin_sdei_synchronous_dispatch(&dispatch_jmp);
 
 	/*
 	 * We reach here when client completes the event.
 	 *
-	 * If the cause of dispatch originally interrupted the Secure world,
-	 * resume Secure.
-	 *
-	 * No need to save the Non-secure context ahead of a world switch: the
-	 * Non-secure context was fully saved before dispatch, and has been
-	 * returned to its pre-dispatch state.
-	 */
-	if (sec_state == SECURE)
-		restore_and_resume_secure_context();
-
-	/*
 	 * The event was dispatched after receiving SDEI interrupt. With
 	 * the event handling completed, EOI the corresponding
 	 * interrupt.
@@ -506,6 +553,105 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	}
 	plat_ic_end_of_interrupt(intr_raw);
 
+	return map;
+}
+
+#if SDEI_DISPATCH_BATCH > 1
+/*
+ * Acknowledge the next pending SDEI interrupt, if its event has the same
+ * priority as the event of 'map' that just completed, and return it. Return
+ * INTR_ID_UNAVAILABLE otherwise.
+ *
+ * The pending interrupts of the GIC are the queue of the events of this PE
+ * that wait for a dispatch. Dispatching the next one straight away saves the
+ * return to the interrupted context and the exception it would take right
+ * away to dispatch it.
+ */
+static uint32_t sdei_ack_next_intr(sdei_ev_map_t *map)
+{
+	sdei_ev_map_t *next;
+	uint32_t intr_raw;
+	unsigned int intr, acked;
+
+	if (plat_ic_get_pending_interrupt_type() != INTR_TYPE_EL3)
+		return INTR_ID_UNAVAILABLE;
+
+	intr = plat_ic_get_pending_interrupt_id();
+	if (intr == INTR_ID_UNAVAILABLE)
+		return INTR_ID_UNAVAILABLE;
+
+	next = find_event_map_by_intr(intr, (plat_ic_is_spi(intr) != 0));
+	if ((next == NULL) ||
+			(is_event_critical(next) != is_event_critical(map)))
+		return INTR_ID_UNAVAILABLE;
+
+	intr_raw = plat_ic_acknowledge_interrupt();
+	acked = plat_ic_get_interrupt_id(intr_raw);
+	if (acked == INTR_ID_UNAVAILABLE)
+		return INTR_ID_UNAVAILABLE;
+
+	/*
+	 * Another interrupt became the highest priority pending one in the
+	 * meantime. It may not be an SDEI interrupt, so leave it pending, to be
+	 * taken once this exception returns.
+	 */
+	if (acked != intr) {
+		plat_ic_set_interrupt_pending(acked);
+		plat_ic_end_of_interrupt(intr_raw);
+		return INTR_ID_UNAVAILABLE;
+	}
+
+	return intr_raw;
+}
+#endif
+
+/* SDEI main interrupt handler */
+int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
+		void *cookie)
+{
+	sdei_ev_map_t *map;
+	unsigned int sec_state = get_interrupt_src_ss(flags);
+
+	/* The mappings of the events are needed to find the interrupt's */
+	(void) sdei_check_ready();
+
+	map = sdei_handle_intr(intr_raw, sec_state, handle);
+	if (map == NULL)
+		return 0;
+
+#if SDEI_DISPATCH_BATCH > 1
+	/*
+	 * Dispatch the next pending events of the same priority, up to
+	 * SDEI_DISPATCH_BATCH events. They interrupt the Non-secure context,
+	 * which is active and has been returned to its pre-dispatch state.
+	 */
+	for (unsigned int count = 1U; count < SDEI_DISPATCH_BATCH; count++) {
+		sdei_ev_map_t *next;
+
+		intr_raw = sdei_ack_next_intr(map);
+		if (intr_raw == INTR_ID_UNAVAILABLE)
+			break;
+
+		next = sdei_handle_intr(intr_raw, NON_SECURE,
+				cm_get_context(NON_SECURE));
+		if (next == NULL)
+			break;
+
+		map = next;
+	}
+#endif
+
+	/*
+	 * If the cause of dispatch originally interrupted the Secure world,
+	 * resume Secure.
+	 *
+	 * No need to save the Non-secure context ahead of a world switch: the
+	 * Non-secure context was fully saved before dispatch, and has been
+	 * returned to its pre-dispatch state.
+	 */
+	if (sec_state == SECURE)
+		restore_and_resume_secure_context();
+
 	return 0;
 }
 
@@ -528,12 +674,18 @@ int sdei_dispatch_event(int ev_num)
 	sdei_dispatch_context_t *disp_ctx;
 	sdei_cpu_state_t *state;
 	struct jmpbuf dispatch_jmp;
+#if SDEI_EVENT_STATS
+	const uint64_t start_ts = read_cntpct_el0();
+#endif
 
 	/* Can't dispatch if events are masked on this PE */
 	state = sdei_get_this_pe_state();
 	if (state->pe_masked)
 		return -1;
 
+	if (sdei_check_ready() != 0)
+		return -1;
+
 	/* Event 0 can't be dispatched */
 	if (ev_num == SDEI_EVENT_0)
 		return -1;
@@ -580,6 +732,9 @@ int sdei_dispatch_event(int ev_num)
 
 	/* Dispatch event synchronously */
 	setup_ns_dispatch(map, se, ns_ctx, &dispatch_jmp);
+#if SDEI_EVENT_STATS
+	record_dispatch_stats(map, se, start_ts);
+#endif
 	begin_sdei_synchronous_dispatch(&dispatch_jmp);
 
 	/*
@@ -630,6 +785,13 @@ int sdei_event_complete(bool resume, uint64_t pc)
 		return SDEI_EDENY;
 	}
 
+#if SDEI_EVENT_STATS
+	se->stats.completions++;
+	update_time_stats(&se->stats.handler_time,
+			read_cntpct_el0() - disp_ctx->dispatch_ts,
+			se->stats.completions);
+#endif
+
 	if (is_event_shared(map))
 		sdei_map_unlock(map);
 
@@ -703,3 +865,77 @@ int64_t sdei_event_context(void *handle, unsigned int param)
 
 	return (int64_t) disp_ctx->x[param];
 }
+
+#if SDEI_EVENT_STATS
+/*
+ * Return the delivery statistics 'sel' of an event, for the CPU 'mpidr' if the
+ * event is private, in 'values':
+ *
+ * - SDEI_STATS_COUNTS: the number of dispatches, of completions and of
+ *   triggers while the PE was masked.
+ * - SDEI_STATS_DISPATCH_LATENCY: the minimum, maximum and average time from
+ *   the handling of the interrupt, or the explicit dispatch request, to the
+ *   dispatch.
+ * - SDEI_STATS_HANDLER_TIME: the minimum, maximum and average time from the
+ *   dispatch to the completion by the client.
+ *
+ * The durations are in ticks of the system counter.
+ */
+int sdei_event_get_stats(int ev_num, uint64_t mpidr, unsigned int sel,
+		uint64_t *values)
+{
+	const sdei_time_stats_t *ts;
+	sdei_ev_stats_t stats;
+	sdei_ev_map_t *map;
+	sdei_entry_t *se;
+	uint32_t count;
+	int cpu = 0;
+
+	assert(values != NULL);
+
+	map = find_event_map(ev_num);
+	if (map == NULL)
+		return -EINVAL;
+
+	if (is_event_private(map)) {
+		cpu = plat_core_pos_by_mpidr(mpidr);
+		if (cpu < 0)
+			return -EINVAL;
+	}
+
+	se = get_cpu_event_entry(map, (unsigned int) cpu);
+
+	/* Take a consistent copy of the statistics of a shared event */
+	if (is_event_shared(map))
+		sdei_map_lock(map);
+
+	stats = se->stats;
+
+	if (is_event_shared(map))
+		sdei_map_unlock(map);
+
+	switch (sel) {
+	case SDEI_STATS_COUNTS:
+		values[0] = stats.dispatches;
+		values[1] = stats.completions;
+		values[2] = stats.masked_triggers;
+		return 0;
+	case SDEI_STATS_DISPATCH_LATENCY:
+		ts = &stats.dispatch_lat;
+		count = stats.dispatches;
+		break;
+	case SDEI_STATS_HANDLER_TIME:
+		ts = &stats.handler_time;
+		count = stats.completions;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	values[0] = ts->min;
+	values[1] = ts->max;
+	values[2] = (count != 0U) ? (ts->total / count) : 0U;
+
+	return 0;
+}
+#endif
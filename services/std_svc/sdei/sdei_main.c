@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SDEI
+
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl31.h>
@@ -97,18 +99,22 @@ static void sdei_class_init(sdei_class_t class)
 {
 	unsigned int i;
 	bool zero_found __unused = false;
-	int ev_num_so_far __unused;
+	int ev_num_so_far;
 	sdei_ev_map_t *map;
 
 	/* Sanity check and configuration of shared events */
 	ev_num_so_far = -1;
 	for_each_shared_map(i, map) {
-#if ENABLE_ASSERTIONS
-		/* Ensure mappings are sorted */
-		assert((ev_num_so_far < 0) || (map->ev_num > ev_num_so_far));
+		/* Event lookups rely on the mappings being sorted */
+		if ((ev_num_so_far >= 0) && (map->ev_num <= ev_num_so_far)) {
+			ERROR("SDEI shared event %d is out of order\n",
+					map->ev_num);
+			panic();
+		}
 
 		ev_num_so_far = map->ev_num;
 
+#if ENABLE_ASSERTIONS
 		/* Event 0 must not be shared */
 		assert(map->ev_num != SDEI_EVENT_0);
 
@@ -146,12 +152,16 @@ static void sdei_class_init(sdei_class_t class)
 	/* Sanity check and configuration of private events for this CPU */
 	ev_num_so_far = -1;
 	for_each_private_map(i, map) {
-#if ENABLE_ASSERTIONS
-		/* Ensure mappings are sorted */
-		assert((ev_num_so_far < 0) || (map->ev_num > ev_num_so_far));
+		/* Event lookups rely on the mappings being sorted */
+		if ((ev_num_so_far >= 0) && (map->ev_num <= ev_num_so_far)) {
+			ERROR("SDEI private event %d is out of order\n",
+					map->ev_num);
+			panic();
+		}
 
 		ev_num_so_far = map->ev_num;
 
+#if ENABLE_ASSERTIONS
 		if (map->ev_num == SDEI_EVENT_0) {
 			zero_found = true;
 
@@ -217,21 +227,87 @@ static void sdei_class_init(sdei_class_t class)
 
 	/* Ensure event 0 is in the mapping */
 	assert(zero_found);
+}
 
-	(void) sdei_cpu_on_init(NULL);
+/* Set up the event mappings, which can be deferred */
+static int32_t sdei_setup_mappings(void)
+{
+	sdei_class_init(SDEI_CRITICAL);
+	sdei_class_init(SDEI_NORMAL);
+
+	return 0;
+}
+
+static DEFINE_RT_SVC_DEFERRED(sdei_mappings, sdei_setup_mappings);
+
+/*
+ * Make sure the event mappings are set up before using them. Returns 0 on
+ * success, -1 otherwise.
+ */
+int sdei_check_ready(void)
+{
+	return runtime_svc_deferred_ready(&sdei_mappings);
+}
+
+#if RT_SVC_FID_HANDLERS
+/*
+ * Handler bound directly to the completion calls, which the client makes once
+ * per dispatched event, so that they skip the Standard Service and SDEI
+ * dispatch. It performs the same checks as sdei_smc_handler(), except that the
+ * event mappings are known to be ready while an event is dispatched.
+ */
+static uintptr_t sdei_complete_smc_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	cpu_context_t *ctx = handle;
+	bool resume = (smc_fid == SDEI_EVENT_COMPLETE_AND_RESUME);
+	int ret;
+
+	if (is_caller_secure(flags))
+		SMC_RET1(ctx, SMC_UNK);
+
+	if (GET_EL(read_ctx_reg(get_el3state_ctx(ctx), CTX_SPSR_EL3)) !=
+	    sdei_client_el())
+		SMC_RET1(ctx, SMC_UNK);
+
+	SDEI_LOG("> COMPLETE(r:%u sta/ep:%lx):%lx\n",
+			(unsigned int) resume, x1, read_mpidr_el1());
+
+	/* On success, the call doesn't return */
+	ret = sdei_event_complete(resume, x1);
+	SDEI_LOG("< COMPLETE:%x\n", ret);
+
+	SMC_RET1(ctx, (u_register_t) (register_t) ret);
 }
+#endif /* RT_SVC_FID_HANDLERS */
 
 /* SDEI dispatcher initialisation */
 void sdei_init(void)
 {
-	sdei_class_init(SDEI_CRITICAL);
-	sdei_class_init(SDEI_NORMAL);
+	/* Initialise the private events of this CPU, and mask it */
+	(void) sdei_cpu_on_init(NULL);
 
 	/* Register priority level handlers */
 	ehf_register_priority_handler(PLAT_SDEI_CRITICAL_PRI,
 			sdei_intr_handler);
 	ehf_register_priority_handler(PLAT_SDEI_NORMAL_PRI,
 			sdei_intr_handler);
+
+	runtime_svc_defer_init(&sdei_mappings);
+
+#if RT_SVC_FID_HANDLERS
+	if ((runtime_svc_register_fid(SDEI_EVENT_COMPLETE,
+				sdei_complete_smc_handler) != 0) ||
+	    (runtime_svc_register_fid(SDEI_EVENT_COMPLETE_AND_RESUME,
+				sdei_complete_smc_handler) != 0))
+		WARN("Failed to bind the SDEI completion SMCs to their handler\n");
+#endif
 }
 
 /* Populate SDEI event entry */
@@ -944,8 +1020,15 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 	if (ss != NON_SECURE)
 		SMC_RET1(ctx, SMC_UNK);
 
-	/* Verify the caller EL */
-	if (GET_EL(read_spsr_el3()) != sdei_client_el())
+	/*
+	 * Verify the caller EL. SPSR_EL3 is read from the context, as the
+	 * profiler may have overwritten the register.
+	 */
+	if (GET_EL(read_ctx_reg(get_el3state_ctx(ctx), CTX_SPSR_EL3)) !=
+	    sdei_client_el())
+		SMC_RET1(ctx, SMC_UNK);
+
+	if (sdei_check_ready() != 0)
 		SMC_RET1(ctx, SMC_UNK);
 
 	switch (smc_fid) {
@@ -215,12 +215,20 @@ typedef enum {
 
 static inline void sdei_map_lock(sdei_ev_map_t *map)
 {
+#if USE_TICKET_LOCKS
+	ticket_lock(&map->lock);
+#else
 	spin_lock(&map->lock);
+#endif
 }
 
 static inline void sdei_map_unlock(sdei_ev_map_t *map)
 {
+#if USE_TICKET_LOCKS
+	ticket_unlock(&map->lock);
+#else
 	spin_unlock(&map->lock);
+#endif
 }
 
 extern const sdei_mapping_t sdei_global_mappings[];
@@ -232,6 +240,7 @@ void init_sdei_state(void);
 sdei_ev_map_t *find_event_map_by_intr(unsigned int intr_num, bool shared);
 sdei_ev_map_t *find_event_map(int ev_num);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
+sdei_entry_t *get_cpu_event_entry(sdei_ev_map_t *map, unsigned int cpu);
 
 int64_t sdei_event_context(void *handle, unsigned int param);
 int sdei_event_complete(bool resume, uint64_t pc);
@@ -239,6 +248,7 @@ int sdei_event_complete(bool resume, uint64_t pc);
 void sdei_pe_unmask(void);
 int64_t sdei_pe_mask(void);
 
+int sdei_check_ready(void);
 int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 		void *cookie);
 bool can_sdei_state_trans(sdei_entry_t *se, sdei_action_t act);
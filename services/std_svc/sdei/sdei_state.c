@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SDEI
+
 #include <assert.h>
 #include <cassert.h>
 #include <stdbool.h>
@@ -4,10 +4,19 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SPM
+
 #include <assert.h>
+#include <cassert.h>
 #include <context_mgmt.h>
 #include <debug.h>
 #include <errno.h>
+#include <lock_stats.h>
+#include <platform_def.h>
+#if SDEI_SUPPORT
+#include <sdei.h>
+#endif
+#include <slab.h>
 #include <smccc.h>
 #include <smccc_helpers.h>
 #include <spci_svc.h>
@@ -28,6 +37,12 @@
 /*******************************************************************************
  * Array of structs that contains information about all handles of Secure
  * Services that are currently open.
+ *
+ * The value of a handle is built from the index of its element in the array,
+ * so the element of a handle is found without searching the array. Each
+ * element has its own lock, so requests made with different handles don't
+ * contend. The free elements are kept in a slab cache, so handles are usually
+ * opened and closed without taking a lock shared with other CPUs.
  ******************************************************************************/
 typedef enum spci_handle_status {
 	HANDLE_STATUS_CLOSED = 0,
@@ -35,6 +50,9 @@ typedef enum spci_handle_status {
 } spci_handle_status_t;
 
 typedef struct spci_handle {
+	/* Lock of all the other fields */
+	spinlock_t lock;
+
 	/* 16-bit value used as reference in all SPCI calls */
 	uint16_t handle;
 
@@ -55,82 +73,216 @@ typedef struct spci_handle {
 	 * counter of them.
 	 */
 	unsigned int num_active_requests;
-} spci_handle_t;
+
+	/* Number of times this element has been used for a handle */
+	unsigned int handle_count;
+
+	/* Number of requests made with this handle */
+	uint32_t token_count;
+
+	/*
+	 * SDEI event dispatched to the client when a response to one of its
+	 * requests is stored, 0 if the client polls for responses.
+	 */
+	int notify_event;
+
+	/*
+	 * Buffers of the client mapped in the Secure Partition. An entry with a
+	 * size of 0 is free.
+	 */
+	struct {
+		uintptr_t base;
+		size_t size;
+	} mem_regions[PLAT_SPCI_HANDLE_MEM_REGIONS_MAX];
+	unsigned int num_mem_regions;
+} __aligned(CACHE_WRITEBACK_GRANULE) spci_handle_t;
+
+/* Number of different handle values that each element can be used for */
+#define SPCI_HANDLE_VALUES_PER_ELEM	\
+	((UINT16_MAX + 1U) / PLAT_SPCI_HANDLES_MAX_NUM)
+
+CASSERT(SPCI_HANDLE_VALUES_PER_ELEM > 0U, assert_spci_handles_max_num);
 
 static spci_handle_t spci_handles[PLAT_SPCI_HANDLES_MAX_NUM];
-static spinlock_t spci_handles_lock;
+
+/* Cache of the elements of spci_handles that don't hold an open handle */
+SLAB_CACHE_ARRAY(spci_handles_cache, spci_handles);
+REGISTER_LOCK_STATS(spci, spci_handles_cache.lock);
 
 /*
  * Given a handle and a client ID, return the element of the spci_handles
- * array that contains the information of the handle. It can only return open
- * handles. It returns NULL if it couldn't find the element in the array.
+ * array that contains the information of the handle, with its lock held. It
+ * can only return open handles. It returns NULL if the handle isn't open.
  */
-static spci_handle_t *spci_handle_info_get(uint16_t handle, uint16_t client_id)
+static spci_handle_t *spci_handle_info_lock(uint16_t handle, uint16_t client_id)
 {
-	size_t i;
-
-	for (i = 0; i < ARRAY_SIZE(spci_handles); i++) {
-		spci_handle_t *h = &(spci_handles[i]);
+	spci_handle_t *h = &(spci_handles[handle % PLAT_SPCI_HANDLES_MAX_NUM]);
 
-		/* Only check for open handles */
-		if (h->status == HANDLE_STATUS_CLOSED) {
-			continue;
-		}
-
-		/* Check if either the handle or the client ID are different */
-		if ((h->handle != handle) || (h->client_id != client_id)) {
-			continue;
-		}
+	spin_lock(&(h->lock));
 
+	/* Check that the element still holds this handle of this client */
+	if ((h->status == HANDLE_STATUS_OPEN) && (h->handle == handle) &&
+	    (h->client_id == client_id)) {
 		return h;
 	}
 
+	spin_unlock(&(h->lock));
+
 	return NULL;
 }
 
 /*
- * Returns a unique value for a handle. This function must be called while
- * spci_handles_lock is locked. It returns 0 on success, -1 on error.
+ * Take a free element of the spci_handles array. It returns NULL if all the
+ * elements are in use.
+ */
+static spci_handle_t *spci_handle_info_alloc(void)
+{
+	return slab_alloc(&spci_handles_cache);
+}
+
+/*
+ * Give back an element of the spci_handles array once its handle has been
+ * closed.
  */
-static int spci_create_handle_value(uint16_t *handle)
+static void spci_handle_info_free(spci_handle_t *h)
+{
+	slab_free(&spci_handles_cache, h);
+}
+
+/*
+ * Returns a unique value for a handle that uses the given element of the
+ * spci_handles array. This function must be called while the lock of the
+ * element is locked. It returns 0 on success, -1 on error.
+ */
+static int spci_create_handle_value(spci_handle_t *h, uint16_t *handle)
 {
 	/*
-	 * Trivial implementation that relies on the fact that any handle will
-	 * be closed before 2^16 more handles have been opened.
+	 * The value is the index of the element plus a multiple of the size
+	 * of the array, so that spci_handle_info_lock() can find the element
+	 * from the value. This relies on the fact that any handle will be
+	 * closed before SPCI_HANDLE_VALUES_PER_ELEM more handles have been
+	 * opened with the same element.
 	 */
-	static uint16_t handle_count;
+	unsigned int i = (unsigned int)(h - spci_handles);
 
-	*handle = handle_count;
+	*handle = (uint16_t)(((h->handle_count % SPCI_HANDLE_VALUES_PER_ELEM) *
+			       PLAT_SPCI_HANDLES_MAX_NUM) + i);
 
-	handle_count++;
+	h->handle_count++;
 
 	return 0;
 }
 
 /*******************************************************************************
- * Returns a unique token for a Secure Service request.
+ * Returns a unique token for a Secure Service request made with the given
+ * handle. This function must be called while the lock of the handle is locked.
  ******************************************************************************/
-static uint32_t spci_create_token_value(void)
+static uint32_t spci_create_token_value(spci_handle_t *h)
 {
 	/*
 	 * Trivial implementation that relies on the fact that any response will
-	 * be read before 2^32 more service requests have been done.
+	 * be read before 2^32 more service requests have been done with this
+	 * handle. Responses are looked up by handle and token, so the tokens
+	 * of different handles don't need to be different.
 	 */
-	static uint32_t token_count;
+	return h->token_count++;
+}
+
+/*******************************************************************************
+ * Returns the SDEI event to dispatch to notify the client of a handle that a
+ * response to one of its requests has been stored, 0 if there isn't any.
+ ******************************************************************************/
+static int spci_handle_notify_event(uint16_t handle, uint16_t client_id)
+{
+	spci_handle_t *handle_info;
+	int notify_event;
+
+	handle_info = spci_handle_info_lock(handle, client_id);
+	if (handle_info == NULL) {
+		return 0;
+	}
+
+	notify_event = handle_info->notify_event;
+
+	spin_unlock(&(handle_info->lock));
+
+	return notify_event;
+}
+
+/*******************************************************************************
+ * Dispatch the SDEI event returned by spci_handle_notify_event(), if any. This
+ * must be called once the Non-secure context has been restored. The response
+ * can still be read with SPCI_SERVICE_GET_RESPONSE if the event can't be
+ * dispatched.
+ ******************************************************************************/
+static void spci_notify_response(int notify_event)
+{
+#if SDEI_SUPPORT
+	if (notify_event == 0) {
+		return;
+	}
 
-	return token_count++;
+	if (sdei_dispatch_event(notify_event) != 0) {
+		VERBOSE("SPCI: Can't dispatch SDEI event %d\n", notify_event);
+	}
+#else
+	assert(notify_event == 0);
+#endif
+}
+
+/*******************************************************************************
+ * This function adds the response that a Secure Partition has returned with
+ * SPRT_PUT_RESPONSE_AARCH64 to the global response buffer. The current SMC
+ * was made by `caller_id` with `caller_handle`, for the request `caller_token`
+ * if it resumes one. It returns the SDEI event to dispatch to notify the client
+ * of the response, 0 if there isn't any.
+ ******************************************************************************/
+static int spci_sp_response_add(cpu_context_t *cpu_ctx, uint16_t caller_id,
+				uint16_t caller_handle, uint32_t caller_token)
+{
+	uint32_t token;
+	uint64_t rx1, rx2, rx3, x6;
+
+	token = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X1);
+	rx1 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X3);
+	rx2 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X4);
+	rx3 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X5);
+	x6 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X6);
+
+	uint16_t client_id = x6 & 0xFFFFU;
+	uint16_t service_handle = x6 >> 16;
+
+	int rc = spm_response_add(client_id, service_handle, token,
+				  rx1, rx2, rx3);
+	if (rc != 0) {
+		/*
+		 * This is error fatal because we can't return to the SP
+		 * from this SMC. The SP has crashed.
+		 */
+		panic();
+	}
+
+	/* The caller reads the response of its own request without a notice */
+	if ((client_id == caller_id) && (service_handle == caller_handle) &&
+	    (token == caller_token)) {
+		return 0;
+	}
+
+	return spci_handle_notify_event(service_handle, client_id);
 }
 
 /*******************************************************************************
  * This function looks for a Secure Partition that has a Secure Service
  * identified by the given UUID. It returns a handle that the client can use to
- * access the service, and an SPCI_*** error code.
+ * access the service, and an SPCI_*** error code. If `notify_event` isn't 0,
+ * it is the SDEI event used to notify the client of its responses.
  ******************************************************************************/
 static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 			u_register_t x2, u_register_t x3, u_register_t x4,
-			u_register_t x5, u_register_t x6, u_register_t x7)
+			u_register_t x5, u_register_t x6, u_register_t x7,
+			int notify_event)
 {
-	unsigned int i;
+	spci_handle_t *handle_info;
 	sp_context_t *sp_ptr;
 	uint16_t service_handle;
 
@@ -151,22 +303,12 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 		SMC_RET2(handle, SPCI_NOT_PRESENT, 0);
 	}
 
-	/* Get lock of the array of handles */
-	spin_lock(&spci_handles_lock);
-
 	/*
 	 * We need to record the client ID and Secure Partition that correspond
-	 * to this handle. Look for the first free entry in the array.
+	 * to this handle. Take a free entry of the array.
 	 */
-	for (i = 0; i < PLAT_SPCI_HANDLES_MAX_NUM; i++) {
-		if (spci_handles[i].status == HANDLE_STATUS_CLOSED) {
-			break;
-		}
-	}
-
-	if (i == PLAT_SPCI_HANDLES_MAX_NUM) {
-		spin_unlock(&spci_handles_lock);
-
+	handle_info = spci_handle_info_alloc();
+	if (handle_info == NULL) {
 		WARN("SPCI: Can't open more handles. Client 0x%04x\n",
 		     client_id);
 		WARN("SPCI:   UUID: " PRINT_UUID_FORMAT "\n",
@@ -175,9 +317,13 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 		SMC_RET2(handle, SPCI_NO_MEMORY, 0);
 	}
 
+	/* Get lock of the entry */
+	spin_lock(&(handle_info->lock));
+
 	/* Create new handle value */
-	if (spci_create_handle_value(&service_handle) != 0) {
-		spin_unlock(&spci_handles_lock);
+	if (spci_create_handle_value(handle_info, &service_handle) != 0) {
+		spin_unlock(&(handle_info->lock));
+		spci_handle_info_free(handle_info);
 
 		WARN("SPCI: Can't create a new handle value. Client 0x%04x\n",
 		     client_id);
@@ -188,14 +334,18 @@ static uint64_t spci_service_handle_open_poll(void *handle, u_register_t x1,
 	}
 
 	/* Save all information about this handle */
-	spci_handles[i].status = HANDLE_STATUS_OPEN;
-	spci_handles[i].client_id = client_id;
-	spci_handles[i].handle = service_handle;
-	spci_handles[i].num_active_requests = 0U;
-	spci_handles[i].sp_ctx = sp_ptr;
-
-	/* Release lock of the array of handles */
-	spin_unlock(&spci_handles_lock);
+	handle_info->status = HANDLE_STATUS_OPEN;
+	handle_info->client_id = client_id;
+	handle_info->handle = service_handle;
+	handle_info->num_active_requests = 0U;
+	handle_info->sp_ctx = sp_ptr;
+	handle_info->token_count = 0U;
+	handle_info->notify_event = notify_event;
+	handle_info->num_mem_regions = 0U;
+	memset(handle_info->mem_regions, 0, sizeof(handle_info->mem_regions));
+
+	/* Release lock of the entry */
+	spin_unlock(&(handle_info->lock));
 
 	VERBOSE("SPCI: Service handle request by client 0x%04x: 0x%04x\n",
 		client_id, service_handle);
@@ -215,13 +365,9 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 	uint16_t client_id = x1 & 0x0000FFFFU;
 	uint16_t service_handle = (x1 >> 16) & 0x0000FFFFU;
 
-	spin_lock(&spci_handles_lock);
-
-	handle_info = spci_handle_info_get(service_handle, client_id);
+	handle_info = spci_handle_info_lock(service_handle, client_id);
 
 	if (handle_info == NULL) {
-		spin_unlock(&spci_handles_lock);
-
 		WARN("SPCI: Tried to close invalid handle 0x%04x by client 0x%04x\n",
 		     service_handle, client_id);
 
@@ -229,7 +375,7 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 	}
 
 	if (handle_info->status != HANDLE_STATUS_OPEN) {
-		spin_unlock(&spci_handles_lock);
+		spin_unlock(&(handle_info->lock));
 
 		WARN("SPCI: Tried to close handle 0x%04x by client 0x%04x in status %d\n",
 			service_handle, client_id, handle_info->status);
@@ -238,7 +384,7 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 	}
 
 	if (handle_info->num_active_requests != 0U) {
-		spin_unlock(&spci_handles_lock);
+		spin_unlock(&(handle_info->lock));
 
 		/* A handle can't be closed if there are requests left */
 		WARN("SPCI: Tried to close handle 0x%04x by client 0x%04x with %d requests left\n",
@@ -248,11 +394,25 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 		SMC_RET1(handle, SPCI_BUSY);
 	}
 
-	memset(handle_info, 0, sizeof(spci_handle_t));
+	if (handle_info->num_mem_regions != 0U) {
+		spin_unlock(&(handle_info->lock));
+
+		/* The buffers of the client must be unregistered first */
+		WARN("SPCI: Tried to close handle 0x%04x by client 0x%04x with %u buffers registered\n",
+			service_handle, client_id,
+			handle_info->num_mem_regions);
 
+		SMC_RET1(handle, SPCI_BUSY);
+	}
+
+	/* The lock and the count of handles of the entry are kept */
 	handle_info->status = HANDLE_STATUS_CLOSED;
+	handle_info->client_id = 0U;
+	handle_info->sp_ctx = NULL;
 
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
+
+	spci_handle_info_free(handle_info);
 
 	VERBOSE("SPCI: Closed handle 0x%04x by client 0x%04x.\n",
 		service_handle, client_id);
@@ -260,6 +420,130 @@ static uint64_t spci_service_handle_close(void *handle, u_register_t x1)
 	SMC_RET1(handle, SPCI_SUCCESS);
 }
 
+/*******************************************************************************
+ * This function maps a buffer of a client in the Secure Partition that provides
+ * the Secure Service of a handle, so that requests made with the handle can
+ * refer to the buffer instead of copying its contents. The buffer is mapped
+ * with the same VA as its PA, which is returned in x1, until it is
+ * unregistered. It returns a SPCI_*** error code.
+ ******************************************************************************/
+static uint64_t spci_service_mem_register(void *handle, u_register_t x1,
+			u_register_t x2, u_register_t x3, u_register_t x7)
+{
+	spci_handle_t *handle_info;
+	uintptr_t base = x1;
+	size_t size = x2;
+	int rw = ((x3 & SPCI_SERVICE_MEM_REGISTER_RW_BIT) != 0U) ? 1 : 0;
+	uint16_t client_id = x7 & 0x0000FFFFU;
+	uint16_t service_handle = (x7 >> 16) & 0x0000FFFFU;
+	unsigned int i;
+	int rc;
+
+	if ((size == 0U) || !IS_PAGE_ALIGNED(base) || !IS_PAGE_ALIGNED(size) ||
+	    ((base + size) < base)) {
+		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+	}
+
+	handle_info = spci_handle_info_lock(service_handle, client_id);
+	if (handle_info == NULL) {
+		WARN("SPCI_SERVICE_MEM_REGISTER: Not found.\n"
+		     "  Handle 0x%04x. Client ID 0x%04x\n", service_handle,
+		     client_id);
+
+		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+	}
+
+	for (i = 0U; i < PLAT_SPCI_HANDLE_MEM_REGIONS_MAX; i++) {
+		if (handle_info->mem_regions[i].size == 0U) {
+			break;
+		}
+	}
+
+	if (i == PLAT_SPCI_HANDLE_MEM_REGIONS_MAX) {
+		spin_unlock(&(handle_info->lock));
+
+		SMC_RET1(handle, SPCI_NO_MEMORY);
+	}
+
+	rc = spm_sp_map_ns_memory(handle_info->sp_ctx, base, size, rw);
+	if (rc != 0) {
+		spin_unlock(&(handle_info->lock));
+
+		VERBOSE("SPCI: Can't map buffer 0x%lx (0x%zx) by client 0x%04x: %d\n",
+			base, size, client_id, rc);
+
+		SMC_RET1(handle, (rc == -ENOMEM) ? SPCI_NO_MEMORY :
+						   SPCI_INVALID_PARAMETER);
+	}
+
+	handle_info->mem_regions[i].base = base;
+	handle_info->mem_regions[i].size = size;
+	handle_info->num_mem_regions++;
+
+	spin_unlock(&(handle_info->lock));
+
+	SMC_RET2(handle, SPCI_SUCCESS, base);
+}
+
+/*******************************************************************************
+ * This function unmaps a buffer registered by spci_service_mem_register() from
+ * the Secure Partition. It can't be done while there are requests in progress
+ * with the handle, as they may be using the buffer. It returns a SPCI_***
+ * error code.
+ ******************************************************************************/
+static uint64_t spci_service_mem_unregister(void *handle, u_register_t x1,
+					    u_register_t x7)
+{
+	spci_handle_t *handle_info;
+	uintptr_t base = x1;
+	uint16_t client_id = x7 & 0x0000FFFFU;
+	uint16_t service_handle = (x7 >> 16) & 0x0000FFFFU;
+	unsigned int i;
+	int rc;
+
+	handle_info = spci_handle_info_lock(service_handle, client_id);
+	if (handle_info == NULL) {
+		WARN("SPCI_SERVICE_MEM_UNREGISTER: Not found.\n"
+		     "  Handle 0x%04x. Client ID 0x%04x\n", service_handle,
+		     client_id);
+
+		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+	}
+
+	for (i = 0U; i < PLAT_SPCI_HANDLE_MEM_REGIONS_MAX; i++) {
+		if ((handle_info->mem_regions[i].size != 0U) &&
+		    (handle_info->mem_regions[i].base == base)) {
+			break;
+		}
+	}
+
+	if (i == PLAT_SPCI_HANDLE_MEM_REGIONS_MAX) {
+		spin_unlock(&(handle_info->lock));
+
+		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+	}
+
+	if (handle_info->num_active_requests != 0U) {
+		spin_unlock(&(handle_info->lock));
+
+		SMC_RET1(handle, SPCI_BUSY);
+	}
+
+	rc = spm_sp_unmap_ns_memory(handle_info->sp_ctx, base,
+				    handle_info->mem_regions[i].size);
+	if (rc != 0) {
+		ERROR("SPCI: Unable to unmap buffer 0x%lx: %d\n", base, rc);
+		panic();
+	}
+
+	handle_info->mem_regions[i].size = 0U;
+	handle_info->num_mem_regions--;
+
+	spin_unlock(&(handle_info->lock));
+
+	SMC_RET1(handle, SPCI_SUCCESS);
+}
+
 /*******************************************************************************
  * This function requests a Secure Service from a given handle and client ID.
  ******************************************************************************/
@@ -275,16 +559,13 @@ static uint64_t spci_service_request_blocking(void *handle,
 	u_register_t rx1, rx2, rx3;
 	uint16_t request_handle, client_id;
 
-	/* Get handle array lock */
-	spin_lock(&spci_handles_lock);
-
 	/* Get pointer to struct of this open handle and client ID. */
 	request_handle = (x7 >> 16U) & 0x0000FFFFU;
 	client_id = x7 & 0x0000FFFFU;
 
-	handle_info = spci_handle_info_get(request_handle, client_id);
+	/* This also gets the handle lock */
+	handle_info = spci_handle_info_lock(request_handle, client_id);
 	if (handle_info == NULL) {
-		spin_unlock(&spci_handles_lock);
 
 		WARN("SPCI_SERVICE_TUN_REQUEST_BLOCKING: Not found.\n");
 		WARN("  Handle 0x%04x. Client ID 0x%04x\n", request_handle,
@@ -296,17 +577,17 @@ static uint64_t spci_service_request_blocking(void *handle,
 	/* Get pointer to the Secure Partition that handles the service */
 	sp_ctx = handle_info->sp_ctx;
 	assert(sp_ctx != NULL);
-	cpu_ctx = &(sp_ctx->cpu_ctx);
+	cpu_ctx = &(spm_sp_get_exec_ctx(sp_ctx)->cpu_ctx);
 
 	/* Blocking requests are only allowed if the queue is empty */
 	if (handle_info->num_active_requests > 0) {
-		spin_unlock(&spci_handles_lock);
+		spin_unlock(&(handle_info->lock));
 
 		SMC_RET1(handle, SPCI_BUSY);
 	}
 
 	if (spm_sp_request_increase_if_zero(sp_ctx) == -1) {
-		spin_unlock(&spci_handles_lock);
+		spin_unlock(&(handle_info->lock));
 
 		SMC_RET1(handle, SPCI_BUSY);
 	}
@@ -315,7 +596,7 @@ static uint64_t spci_service_request_blocking(void *handle,
 	handle_info->num_active_requests += 1;
 
 	/* Release handle lock */
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 
 	/* Save the Normal world context */
 	cm_el1_sysregs_context_save(NON_SECURE);
@@ -333,10 +614,13 @@ static uint64_t spci_service_request_blocking(void *handle,
 		.args = {smc_fid, x1, x2, x3, x4, x5}
 	};
 
-	spin_lock(&(sp_ctx->spm_sp_buffer_lock));
+	/*
+	 * There can only be one blocking request in progress for a Secure
+	 * Partition, as they are only made when it has no other request, so
+	 * the blocking queue has a single producer and needs no lock.
+	 */
 	int rc = sprt_push_message((void *)sp_ctx->spm_sp_buffer_base, &message,
 				   SPRT_QUEUE_NUM_BLOCKING);
-	spin_unlock(&(sp_ctx->spm_sp_buffer_lock));
 	if (rc != 0) {
 		/*
 		 * This shouldn't happen, blocking requests can only be made if
@@ -361,13 +645,13 @@ static uint64_t spci_service_request_blocking(void *handle,
 	rx3 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X5);
 
 	/* Flag Secure Partition as idle. */
-	assert(sp_ctx->state == SP_STATE_BUSY);
+	assert(spm_sp_get_exec_ctx(sp_ctx)->state == SP_STATE_BUSY);
 	sp_state_set(sp_ctx, SP_STATE_IDLE);
 
 	/* Decrease count of requests. */
-	spin_lock(&spci_handles_lock);
+	spin_lock(&(handle_info->lock));
 	handle_info->num_active_requests -= 1;
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 	spm_sp_request_decrease(sp_ctx);
 
 	/* Restore non-secure state */
@@ -391,16 +675,13 @@ static uint64_t spci_service_request_start(void *handle,
 	uint16_t request_handle, client_id;
 	uint32_t token;
 
-	/* Get handle array lock */
-	spin_lock(&spci_handles_lock);
-
 	/* Get pointer to struct of this open handle and client ID. */
 	request_handle = (x7 >> 16U) & 0x0000FFFFU;
 	client_id = x7 & 0x0000FFFFU;
 
-	handle_info = spci_handle_info_get(request_handle, client_id);
+	/* This also gets the handle lock */
+	handle_info = spci_handle_info_lock(request_handle, client_id);
 	if (handle_info == NULL) {
-		spin_unlock(&spci_handles_lock);
 
 		WARN("SPCI_SERVICE_TUN_REQUEST_START: Not found.\n"
 		     "  Handle 0x%04x. Client ID 0x%04x\n", request_handle,
@@ -412,7 +693,7 @@ static uint64_t spci_service_request_start(void *handle,
 	/* Get pointer to the Secure Partition that handles the service */
 	sp_ctx = handle_info->sp_ctx;
 	assert(sp_ctx != NULL);
-	cpu_ctx = &(sp_ctx->cpu_ctx);
+	cpu_ctx = &(spm_sp_get_exec_ctx(sp_ctx)->cpu_ctx);
 
 	/* Prevent this handle from being closed */
 	handle_info->num_active_requests += 1;
@@ -420,10 +701,10 @@ static uint64_t spci_service_request_start(void *handle,
 	spm_sp_request_increase(sp_ctx);
 
 	/* Create new token for this request */
-	token = spci_create_token_value();
+	token = spci_create_token_value(handle_info);
 
 	/* Release handle lock */
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 
 	/* Pass arguments to the Secure Partition */
 	struct sprt_queue_entry_message message = {
@@ -462,30 +743,12 @@ static uint64_t spci_service_request_start(void *handle,
 
 	/* Jump to the Secure Partition. */
 	uint64_t ret = spm_sp_synchronous_entry(sp_ctx, 1);
+	int notify_event = 0;
 
 	/* Verify returned values */
 	if (ret == SPRT_PUT_RESPONSE_AARCH64) {
-		uint32_t token;
-		uint64_t rx1, rx2, rx3, x6;
-
-		token = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X1);
-		rx1 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X3);
-		rx2 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X4);
-		rx3 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X5);
-		x6 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X6);
-
-		uint16_t client_id = x6 & 0xFFFFU;
-		uint16_t service_handle = x6 >> 16;
-
-		int rc = spm_response_add(client_id, service_handle, token,
-					  rx1, rx2, rx3);
-		if (rc != 0) {
-			/*
-			 * This is error fatal because we can't return to the SP
-			 * from this SMC. The SP has crashed.
-			 */
-			panic();
-		}
+		notify_event = spci_sp_response_add(cpu_ctx, client_id,
+						    request_handle, token);
 	} else if ((ret != SPRT_YIELD_AARCH64) &&
 		   (ret != SPM_SECURE_PARTITION_PREEMPTED)) {
 		ERROR("SPM: %s: Unexpected x0 value 0x%llx\n", __func__, ret);
@@ -493,13 +756,15 @@ static uint64_t spci_service_request_start(void *handle,
 	}
 
 	/* Flag Secure Partition as idle. */
-	assert(sp_ctx->state == SP_STATE_BUSY);
+	assert(spm_sp_get_exec_ctx(sp_ctx)->state == SP_STATE_BUSY);
 	sp_state_set(sp_ctx, SP_STATE_IDLE);
 
 	/* Restore non-secure state */
 	cm_el1_sysregs_context_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
+	spci_notify_response(notify_event);
+
 	SMC_RET2(handle, SPCI_SUCCESS, token);
 }
 
@@ -521,11 +786,8 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 	uint16_t service_handle = (x7 >> 16) & 0x0000FFFF;
 
 	/* Get pointer to struct of this open handle and client ID. */
-	spin_lock(&spci_handles_lock);
-
-	handle_info = spci_handle_info_get(service_handle, client_id);
+	handle_info = spci_handle_info_lock(service_handle, client_id);
 	if (handle_info == NULL) {
-		spin_unlock(&spci_handles_lock);
 		WARN("SPCI_SERVICE_REQUEST_RESUME: Not found.\n"
 		     "Handle 0x%04x. Client ID 0x%04x, Token 0x%08x.\n",
 		     client_id, service_handle, token);
@@ -536,18 +798,18 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 	/* Get pointer to the Secure Partition that handles the service */
 	sp_ctx = handle_info->sp_ctx;
 	assert(sp_ctx != NULL);
-	cpu_ctx = &(sp_ctx->cpu_ctx);
+	cpu_ctx = &(spm_sp_get_exec_ctx(sp_ctx)->cpu_ctx);
 
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 
 	/* Look for a valid response in the global queue */
 	rc = spm_response_get(client_id, service_handle, token,
 			      &rx1, &rx2, &rx3);
 	if (rc == 0) {
 		/* Decrease request count */
-		spin_lock(&spci_handles_lock);
+		spin_lock(&(handle_info->lock));
 		handle_info->num_active_requests -= 1;
-		spin_unlock(&spci_handles_lock);
+		spin_unlock(&(handle_info->lock));
 		spm_sp_request_decrease(sp_ctx);
 
 		SMC_RET4(handle, SPCI_SUCCESS, rx1, rx2, rx3);
@@ -569,30 +831,12 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 
 	/* Jump to the Secure Partition. */
 	uint64_t ret = spm_sp_synchronous_entry(sp_ctx, 1);
+	int notify_event = 0;
 
 	/* Verify returned values */
 	if (ret == SPRT_PUT_RESPONSE_AARCH64) {
-		uint32_t token;
-		uint64_t rx1, rx2, rx3, x6;
-
-		token = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X1);
-		rx1 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X3);
-		rx2 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X4);
-		rx3 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X5);
-		x6 = read_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X6);
-
-		uint16_t client_id = x6 & 0xFFFFU;
-		uint16_t service_handle = x6 >> 16;
-
-		int rc = spm_response_add(client_id, service_handle, token,
-					  rx1, rx2, rx3);
-		if (rc != 0) {
-			/*
-			 * This is error fatal because we can't return to the SP
-			 * from this SMC. The SP has crashed.
-			 */
-			panic();
-		}
+		notify_event = spci_sp_response_add(cpu_ctx, client_id,
+						    service_handle, token);
 	} else if ((ret != SPRT_YIELD_AARCH64) &&
 		   (ret != SPM_SECURE_PARTITION_PREEMPTED)) {
 		ERROR("SPM: %s: Unexpected x0 value 0x%llx\n", __func__, ret);
@@ -600,13 +844,15 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 	}
 
 	/* Flag Secure Partition as idle. */
-	assert(sp_ctx->state == SP_STATE_BUSY);
+	assert(spm_sp_get_exec_ctx(sp_ctx)->state == SP_STATE_BUSY);
 	sp_state_set(sp_ctx, SP_STATE_IDLE);
 
 	/* Restore non-secure state */
 	cm_el1_sysregs_context_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
+	spci_notify_response(notify_event);
+
 	/* Look for a valid response in the global queue */
 	rc = spm_response_get(client_id, service_handle, token,
 			      &rx1, &rx2, &rx3);
@@ -615,9 +861,9 @@ static uint64_t spci_service_request_resume(void *handle, u_register_t x1,
 	}
 
 	/* Decrease request count */
-	spin_lock(&spci_handles_lock);
+	spin_lock(&(handle_info->lock));
 	handle_info->num_active_requests -= 1;
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 	spm_sp_request_decrease(sp_ctx);
 
 	/* Return response */
@@ -641,11 +887,8 @@ static uint64_t spci_service_get_response(void *handle, u_register_t x1,
 
 	/* Get pointer to struct of this open handle and client ID. */
 
-	spin_lock(&spci_handles_lock);
-
-	handle_info = spci_handle_info_get(service_handle, client_id);
+	handle_info = spci_handle_info_lock(service_handle, client_id);
 	if (handle_info == NULL) {
-		spin_unlock(&spci_handles_lock);
 		WARN("SPCI_SERVICE_GET_RESPONSE: Not found.\n"
 		     "Handle 0x%04x. Client ID 0x%04x, Token 0x%08x.\n",
 		     client_id, service_handle, token);
@@ -653,7 +896,7 @@ static uint64_t spci_service_get_response(void *handle, u_register_t x1,
 		SMC_RET1(handle, SPCI_INVALID_PARAMETER);
 	}
 
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 
 	/* Look for a valid response in the global queue */
 	rc = spm_response_get(client_id, service_handle, token,
@@ -664,11 +907,11 @@ static uint64_t spci_service_get_response(void *handle, u_register_t x1,
 	}
 
 	/* Decrease request count */
-	spin_lock(&spci_handles_lock);
+	spin_lock(&(handle_info->lock));
 	handle_info->num_active_requests -= 1;
 	sp_context_t *sp_ctx;
 	sp_ctx = handle_info->sp_ctx;
-	spin_unlock(&spci_handles_lock);
+	spin_unlock(&(handle_info->lock));
 	spm_sp_request_decrease(sp_ctx);
 
 	/* Return response */
@@ -702,22 +945,49 @@ uint64_t spci_smc_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 
 		case SPCI_FID_SERVICE_HANDLE_OPEN:
 		{
+			uint64_t x5 = SMC_GET_GP(handle, CTX_GPREG_X5);
+			uint64_t x6 = SMC_GET_GP(handle, CTX_GPREG_X6);
+			uint64_t x7 = SMC_GET_GP(handle, CTX_GPREG_X7);
+			int notify_event = 0;
+
 			if ((smc_fid & SPCI_SERVICE_HANDLE_OPEN_NOTIFY_BIT) != 0) {
-				/* Not supported for now */
+#if SDEI_SUPPORT
+				/*
+				 * The client is notified of its responses with
+				 * the SDEI event in w5.
+				 */
+				notify_event = (int)(x5 & 0xFFFFFFFFU);
+				if (notify_event == 0) {
+					SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+				}
+#else
 				WARN("SPCI_SERVICE_HANDLE_OPEN_NOTIFY not supported.\n");
 				SMC_RET1(handle, SPCI_INVALID_PARAMETER);
+#endif
 			}
 
-			uint64_t x5 = SMC_GET_GP(handle, CTX_GPREG_X5);
-			uint64_t x6 = SMC_GET_GP(handle, CTX_GPREG_X6);
-			uint64_t x7 = SMC_GET_GP(handle, CTX_GPREG_X7);
-
 			return spci_service_handle_open_poll(handle, x1, x2, x3,
-							     x4, x5, x6, x7);
+							     x4, x5, x6, x7,
+							     notify_event);
 		}
 		case SPCI_FID_SERVICE_HANDLE_CLOSE:
 			return spci_service_handle_close(handle, x1);
 
+		case SPCI_FID_SERVICE_MEM_REGISTER:
+		{
+			uint64_t x7 = SMC_GET_GP(handle, CTX_GPREG_X7);
+
+			return spci_service_mem_register(handle, x1, x2, x3,
+							 x7);
+		}
+
+		case SPCI_FID_SERVICE_MEM_UNREGISTER:
+		{
+			uint64_t x7 = SMC_GET_GP(handle, CTX_GPREG_X7);
+
+			return spci_service_mem_unregister(handle, x1, x7);
+		}
+
 		case SPCI_FID_SERVICE_REQUEST_BLOCKING:
 		{
 			uint64_t x5 = SMC_GET_GP(handle, CTX_GPREG_X5);
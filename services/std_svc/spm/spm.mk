@@ -22,6 +22,7 @@ SPM_SOURCES	:=	$(addprefix services/std_svc/spm/,	\
 			spm_setup.c				\
 			spm_xlat.c				\
 			sprt.c)					\
+			lib/slab/slab.c				\
 			${SPRT_LIB_SOURCES}
 
 INCLUDES	+=	${SPRT_LIB_INCLUDES}
@@ -4,66 +4,103 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
-#include <arch_helpers.h>
 #include <platform_def.h>
+#include <slab.h>
 #include <spinlock.h>
+#include <stddef.h>
 #include <utils_def.h>
 
 /*******************************************************************************
  * Secure Service response global array. All the responses to the requests done
  * to the Secure Partition are stored here. They are removed from the array as
  * soon as their value is read.
+ *
+ * The stored responses are kept in lists, in a hash table indexed by handle and
+ * token. Each list has its own lock, so responses to requests made with
+ * different handles or tokens are usually added and read without contention.
+ * The unused responses are kept in a slab cache.
  ******************************************************************************/
+#define SPM_RESPONSES_BUCKETS	U(16)
+
 struct sprt_response {
-	int is_valid;
+	struct sprt_response *next;
 	uint32_t token;
 	uint16_t client_id, handle;
 	u_register_t x1, x2, x3;
 };
 
+struct sprt_response_bucket {
+	spinlock_t lock;
+	struct sprt_response *head;
+} __aligned(CACHE_WRITEBACK_GRANULE);
+
 static struct sprt_response responses[PLAT_SPM_RESPONSES_MAX];
+static struct sprt_response_bucket responses_buckets[SPM_RESPONSES_BUCKETS];
 
-static spinlock_t responses_lock;
+SLAB_CACHE_ARRAY(responses_cache, responses);
+
+static struct sprt_response_bucket *spm_response_bucket(uint16_t handle,
+							uint32_t token)
+{
+	/*
+	 * Tokens are counted per handle, so consecutive requests made with the
+	 * same handle go to consecutive buckets.
+	 */
+	unsigned int i = (token + ((uint32_t)handle * 7U)) %
+			 SPM_RESPONSES_BUCKETS;
+
+	return &(responses_buckets[i]);
+}
+
+static struct sprt_response *spm_response_alloc(void)
+{
+	return slab_alloc(&responses_cache);
+}
+
+static void spm_response_free(struct sprt_response *resp)
+{
+	slab_free(&responses_cache, resp);
+}
 
 /* Add response to the global response buffer. Returns 0 on success else -1. */
 int spm_response_add(uint16_t client_id, uint16_t handle, uint32_t token,
 		     u_register_t x1, u_register_t x2, u_register_t x3)
 {
-	spin_lock(&responses_lock);
-
-	/* Make sure that there isn't any other response with the same token. */
-	for (unsigned int i = 0U; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
+	struct sprt_response_bucket *bucket = spm_response_bucket(handle, token);
+	struct sprt_response *resp, *new_resp;
 
-		if ((resp->is_valid == 1) && (resp->token == token)) {
-			return -1;
-		}
+	new_resp = spm_response_alloc();
+	if (new_resp == NULL) {
+		return -1;
 	}
 
-	for (int i = 0; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
-
-		if (resp->is_valid == 0) {
-			resp->token = token;
-			resp->client_id = client_id;
-			resp->handle = handle;
-			resp->x1 = x1;
-			resp->x2 = x2;
-			resp->x3 = x3;
+	new_resp->token = token;
+	new_resp->client_id = client_id;
+	new_resp->handle = handle;
+	new_resp->x1 = x1;
+	new_resp->x2 = x2;
+	new_resp->x3 = x3;
 
-			dmbish();
+	spin_lock(&(bucket->lock));
 
-			resp->is_valid = 1;
+	/* Make sure that there isn't any other response to the same request. */
+	for (resp = bucket->head; resp != NULL; resp = resp->next) {
+		if ((resp->token == token) && (resp->client_id == client_id) &&
+		    (resp->handle == handle)) {
+			spin_unlock(&(bucket->lock));
 
-			spin_unlock(&responses_lock);
+			spm_response_free(new_resp);
 
-			return 0;
+			return -1;
 		}
 	}
 
-	spin_unlock(&responses_lock);
+	new_resp->next = bucket->head;
+	bucket->head = new_resp;
 
-	return -1;
+	spin_unlock(&(bucket->lock));
+
+	return 0;
 }
 
 /*
@@ -73,15 +110,13 @@ int spm_response_add(uint16_t client_id, uint16_t handle, uint32_t token,
 int spm_response_get(uint16_t client_id, uint16_t handle, uint32_t token,
 		     u_register_t *x1, u_register_t *x2, u_register_t *x3)
 {
-	spin_lock(&responses_lock);
+	struct sprt_response_bucket *bucket = spm_response_bucket(handle, token);
+	struct sprt_response **prev, *resp;
 
-	for (unsigned int i = 0U; i < ARRAY_SIZE(responses); i++) {
-		struct sprt_response *resp = &(responses[i]);
+	spin_lock(&(bucket->lock));
 
-		/* Ignore invalid entries */
-		if (resp->is_valid == 0) {
-			continue;
-		}
+	for (prev = &(bucket->head); *prev != NULL; prev = &((*prev)->next)) {
+		resp = *prev;
 
 		/* Make sure that all the information matches the stored one */
 		if ((resp->token != token) || (resp->client_id != client_id) ||
@@ -89,20 +124,20 @@ int spm_response_get(uint16_t client_id, uint16_t handle, uint32_t token,
 			continue;
 		}
 
+		*prev = resp->next;
+
+		spin_unlock(&(bucket->lock));
+
 		*x1 = resp->x1;
 		*x2 = resp->x2;
 		*x3 = resp->x3;
 
-		dmbish();
-
-		resp->is_valid = 0;
-
-		spin_unlock(&responses_lock);
+		spm_response_free(resp);
 
 		return 0;
 	}
 
-	spin_unlock(&responses_lock);
+	spin_unlock(&(bucket->lock));
 
 	return -1;
 }
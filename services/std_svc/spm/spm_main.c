@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SPM
+
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl31.h>
@@ -12,6 +14,7 @@
 #include <ehf.h>
 #include <errno.h>
 #include <interrupt_mgmt.h>
+#include <mpam.h>
 #include <platform.h>
 #include <runtime_svc.h>
 #include <smccc.h>
@@ -29,8 +32,9 @@
  ******************************************************************************/
 sp_context_t sp_ctx_array[PLAT_SPM_MAX_PARTITIONS];
 
-/* Last Secure Partition last used by the CPU */
+/* Last Secure Partition last used by the CPU, and its execution context */
 sp_context_t *cpu_sp_ctx[PLATFORM_CORE_COUNT];
+static sp_exec_ctx_t *cpu_sp_exec_ctx[PLATFORM_CORE_COUNT];
 
 void spm_cpu_set_sp_ctx(unsigned int linear_id, sp_context_t *sp_ctx)
 {
@@ -112,79 +116,110 @@ sp_context_t *spm_sp_get_by_uuid(const uint32_t (*svc_uuid)[4])
 }
 
 /*******************************************************************************
- * Set state of a Secure Partition context.
+ * This function returns the execution context of a Secure Partition that this
+ * CPU has to use. MP partitions have one execution context per CPU.
+ ******************************************************************************/
+sp_exec_ctx_t *spm_sp_get_exec_ctx(sp_context_t *sp_ctx)
+{
+	unsigned int i = 0U;
+
+	if (sp_ctx->exec_ctx_num > 1U) {
+		i = plat_my_core_pos();
+		assert(i < sp_ctx->exec_ctx_num);
+	}
+
+	return &(sp_ctx->exec_ctx[i]);
+}
+
+/*******************************************************************************
+ * Set state of the execution context of a Secure Partition used by this CPU.
  ******************************************************************************/
 void sp_state_set(sp_context_t *sp_ptr, sp_state_t state)
 {
-	spin_lock(&(sp_ptr->state_lock));
-	sp_ptr->state = state;
-	spin_unlock(&(sp_ptr->state_lock));
+	sp_exec_ctx_t *exec_ctx = spm_sp_get_exec_ctx(sp_ptr);
+
+	spin_lock(&(exec_ctx->state_lock));
+	exec_ctx->state = state;
+	spin_unlock(&(exec_ctx->state_lock));
 }
 
 /*******************************************************************************
- * Wait until the state of a Secure Partition is the specified one and change it
- * to the desired state.
+ * Wait until the state of the execution context of a Secure Partition used by
+ * this CPU is the specified one and change it to the desired state.
  ******************************************************************************/
 void sp_state_wait_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 {
+	sp_exec_ctx_t *exec_ctx = spm_sp_get_exec_ctx(sp_ptr);
 	int success = 0;
 
 	while (success == 0) {
-		spin_lock(&(sp_ptr->state_lock));
+		spin_lock(&(exec_ctx->state_lock));
 
-		if (sp_ptr->state == from) {
-			sp_ptr->state = to;
+		if (exec_ctx->state == from) {
+			exec_ctx->state = to;
 
 			success = 1;
 		}
 
-		spin_unlock(&(sp_ptr->state_lock));
+		spin_unlock(&(exec_ctx->state_lock));
 	}
 }
 
 /*******************************************************************************
- * Check if the state of a Secure Partition is the specified one and, if so,
- * change it to the desired state. Returns 0 on success, -1 on error.
+ * Check if the state of the execution context of a Secure Partition used by
+ * this CPU is the specified one and, if so, change it to the desired state.
+ * Returns 0 on success, -1 on error.
  ******************************************************************************/
 int sp_state_try_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
 {
+	sp_exec_ctx_t *exec_ctx = spm_sp_get_exec_ctx(sp_ptr);
 	int ret = -1;
 
-	spin_lock(&(sp_ptr->state_lock));
+	spin_lock(&(exec_ctx->state_lock));
 
-	if (sp_ptr->state == from) {
-		sp_ptr->state = to;
+	if (exec_ctx->state == from) {
+		exec_ctx->state = to;
 
 		ret = 0;
 	}
 
-	spin_unlock(&(sp_ptr->state_lock));
+	spin_unlock(&(exec_ctx->state_lock));
 
 	return ret;
 }
 
 /*******************************************************************************
- * This function takes an SP context pointer and performs a synchronous entry
- * into it.
+ * This function takes an SP context pointer and one of its execution contexts
+ * and performs a synchronous entry into it.
  ******************************************************************************/
-uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx, int can_preempt)
+static uint64_t spm_sp_exec_ctx_entry(sp_context_t *sp_ctx,
+				      sp_exec_ctx_t *exec_ctx, int can_preempt)
 {
 	uint64_t rc;
 	unsigned int linear_id = plat_my_core_pos();
 
 	assert(sp_ctx != NULL);
+	assert(exec_ctx != NULL);
 
 	/* Assign the context of the SP to this CPU */
 	spm_cpu_set_sp_ctx(linear_id, sp_ctx);
-	cm_set_context(&(sp_ctx->cpu_ctx), SECURE);
+	cpu_sp_exec_ctx[linear_id] = exec_ctx;
+	cm_set_context(&(exec_ctx->cpu_ctx), SECURE);
+
+#if MPAM_WORLD_PARTID
+	/* Run the secure partition in its MPAM partition */
+	mpam_set_secure_partid(plat_mpam_get_sp_partid_pmg(
+				(unsigned int)(sp_ctx - sp_ctx_array)));
+#endif
 
 	/* Restore the context assigned above */
 	cm_el1_sysregs_context_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
-	/* Invalidate TLBs at EL1. */
-	tlbivmalle1();
-	dsbish();
+	/*
+	 * The TLBs aren't invalidated: the mappings of the partitions are tagged
+	 * with their ASID, see spm_sp_setup().
+	 */
 
 	if (can_preempt == 1) {
 		enable_intr_rm_local(INTR_TYPE_NS, SECURE);
@@ -193,7 +228,7 @@ uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx, int can_preempt)
 	}
 
 	/* Enter Secure Partition */
-	rc = spm_secure_partition_enter(&sp_ctx->c_rt_ctx);
+	rc = spm_secure_partition_enter(&exec_ctx->c_rt_ctx);
 
 	/* Save secure state */
 	cm_el1_sysregs_context_save(SECURE);
@@ -201,15 +236,27 @@ uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx, int can_preempt)
 	return rc;
 }
 
+/*******************************************************************************
+ * This function takes an SP context pointer and performs a synchronous entry
+ * into the execution context that this CPU has to use.
+ ******************************************************************************/
+uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx, int can_preempt)
+{
+	assert(sp_ctx != NULL);
+
+	return spm_sp_exec_ctx_entry(sp_ctx, spm_sp_get_exec_ctx(sp_ctx),
+				     can_preempt);
+}
+
 /*******************************************************************************
  * This function returns to the place where spm_sp_synchronous_entry() was
  * called originally.
  ******************************************************************************/
 __dead2 void spm_sp_synchronous_exit(uint64_t rc)
 {
-	/* Get context of the SP in use by this CPU. */
+	/* Get execution context of the SP in use by this CPU. */
 	unsigned int linear_id = plat_my_core_pos();
-	sp_context_t *ctx = spm_cpu_get_sp_ctx(linear_id);
+	sp_exec_ctx_t *ctx = cpu_sp_exec_ctx[linear_id];
 
 	/*
 	 * The SPM must have initiated the original request through a
@@ -253,15 +300,23 @@ static int32_t spm_init(void)
 
 		INFO("Secure Partition %u init...\n", i);
 
-		ctx->state = SP_STATE_RESET;
+		/*
+		 * All the execution contexts of MP partitions are initialised
+		 * from this CPU. The index of the context is in X1.
+		 */
+		for (unsigned int j = 0U; j < ctx->exec_ctx_num; j++) {
+			sp_exec_ctx_t *exec_ctx = &(ctx->exec_ctx[j]);
 
-		rc = spm_sp_synchronous_entry(ctx, 0);
-		if (rc != SPRT_YIELD_AARCH64) {
-			ERROR("Unexpected return value 0x%llx\n", rc);
-			panic();
-		}
+			exec_ctx->state = SP_STATE_RESET;
 
-		ctx->state = SP_STATE_IDLE;
+			rc = spm_sp_exec_ctx_entry(ctx, exec_ctx, 0);
+			if (rc != SPRT_YIELD_AARCH64) {
+				ERROR("Unexpected return value 0x%llx\n", rc);
+				panic();
+			}
+
+			exec_ctx->state = SP_STATE_IDLE;
+		}
 
 		INFO("Secure Partition %u initialized.\n", i);
 	}
@@ -283,6 +338,21 @@ int32_t spm_setup(void)
 	/* Disable MMU at EL1 (initialized by BL2) */
 	disable_mmu_icache_el1();
 
+	/*
+	 * Remove the mappings of BL2 from the TLBs. They are global, so they
+	 * would be used by the partitions too, which don't invalidate the TLBs
+	 * when they are entered.
+	 */
+	tlbivmalle1is();
+	dsbish();
+
+	/*
+	 * The partitions run at S-EL0 behind the SPM shim, which doesn't use
+	 * the kernel or AArch32 EL1 registers, so they keep the Non-secure
+	 * values while a partition runs.
+	 */
+	cm_set_el1_sysregs_groups(0U);
+
 	/*
 	 * Non-blocking services can be interrupted by Non-secure interrupts.
 	 * Register an interrupt handler for NS interrupts when generated while
@@ -34,6 +34,7 @@
 
 #ifndef __ASSEMBLY__
 
+#include <platform_def.h>
 #include <spinlock.h>
 #include <sp_res_desc.h>
 #include <stdint.h>
@@ -45,6 +46,20 @@ typedef enum sp_state {
 	SP_STATE_BUSY
 } sp_state_t;
 
+/*
+ * Execution context of a Secure Partition. UP partitions only have one, which
+ * is used by all CPUs in turn. MP partitions have one per CPU, so that they can
+ * handle requests on several CPUs at the same time. All the execution contexts
+ * of a partition share its translation tables.
+ */
+typedef struct sp_exec_ctx {
+	uint64_t c_rt_ctx;
+	cpu_context_t cpu_ctx;
+
+	sp_state_t state;
+	spinlock_t state_lock;
+} sp_exec_ctx_t;
+
 typedef struct sp_context {
 	/* 1 if the partition is present, 0 otherwise */
 	int is_present;
@@ -53,21 +68,23 @@ typedef struct sp_context {
 	unsigned long long image_base;
 	size_t image_size;
 
-	uint64_t c_rt_ctx;
-	cpu_context_t cpu_ctx;
+	/* Execution contexts, one per CPU if this is an MP partition */
+	sp_exec_ctx_t exec_ctx[PLATFORM_CORE_COUNT];
+	unsigned int exec_ctx_num;
+
 	struct sp_res_desc rd;
 
 	/* Translation tables context */
 	xlat_ctx_t *xlat_ctx_handle;
 	spinlock_t xlat_ctx_lock;
 
-	sp_state_t state;
-	spinlock_t state_lock;
-
 	unsigned int request_count;
 	spinlock_t request_count_lock;
 
-	/* Base and size of the shared SPM<->SP buffer */
+	/*
+	 * Base and size of the shared SPM<->SP buffer, and lock of the queue of
+	 * non-blocking requests in it.
+	 */
 	uintptr_t spm_sp_buffer_base;
 	size_t spm_sp_buffer_size;
 	spinlock_t spm_sp_buffer_lock;
@@ -84,6 +101,9 @@ void __dead2 spm_secure_partition_exit(uint64_t c_rt_ctx, uint64_t ret);
 /* Secure Partition setup */
 void spm_sp_setup(sp_context_t *sp_ctx);
 
+/* Returns the execution context of a Secure Partition used by this CPU */
+sp_exec_ctx_t *spm_sp_get_exec_ctx(sp_context_t *sp_ctx);
+
 /* Secure Partition state management helpers */
 void sp_state_set(sp_context_t *sp_ptr, sp_state_t state);
 void sp_state_wait_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to);
@@ -97,6 +117,9 @@ int spm_sp_request_increase_if_zero(sp_context_t *sp_ctx);
 /* Functions related to the translation tables management */
 xlat_ctx_t *spm_sp_xlat_context_alloc(void);
 void sp_map_memory_regions(sp_context_t *sp_ctx);
+int spm_sp_map_ns_memory(sp_context_t *sp_ctx, uintptr_t base, size_t size,
+			 int rw);
+int spm_sp_unmap_ns_memory(sp_context_t *sp_ctx, uintptr_t base, size_t size);
 
 /* Functions to handle Secure Partition contexts */
 void spm_cpu_set_sp_ctx(unsigned int linear_id, sp_context_t *sp_ctx);
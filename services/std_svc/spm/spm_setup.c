@@ -7,6 +7,7 @@
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
+#include <cassert.h>
 #include <common_def.h>
 #include <context.h>
 #include <context_mgmt.h>
@@ -21,10 +22,18 @@
 #include "spm_private.h"
 #include "spm_shim_private.h"
 
-/* Setup context of the Secure Partition */
-void spm_sp_setup(sp_context_t *sp_ctx)
+/*
+ * Each Secure Partition has its own ASID, so that the TLB entries of a
+ * partition are kept when switching to another one.
+ */
+CASSERT(PLAT_SPM_MAX_PARTITIONS <= XLAT_ASID_MAX, assert_spm_enough_asids);
+
+static unsigned int spm_next_asid = 1U;
+
+/* Setup an execution context of the Secure Partition */
+static void spm_sp_exec_ctx_setup(sp_context_t *sp_ctx, unsigned int idx)
 {
-	cpu_context_t *ctx = &(sp_ctx->cpu_ctx);
+	cpu_context_t *ctx = &(sp_ctx->exec_ctx[idx].cpu_ctx);
 
 	/*
 	 * Initialize CPU context
@@ -41,25 +50,18 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 
 	/*
 	 * X0: Unused (MBZ).
-	 * X1: Unused (MBZ).
+	 * X1: Index of the execution context (0 if the partition is UP).
 	 * X2: cookie value (Implementation Defined)
 	 * X3: cookie value (Implementation Defined)
 	 * X4 to X7 = 0
 	 */
 	ep_info.args.arg0 = 0;
-	ep_info.args.arg1 = 0;
+	ep_info.args.arg1 = idx;
 	ep_info.args.arg2 = PLAT_SPM_COOKIE_0;
 	ep_info.args.arg3 = PLAT_SPM_COOKIE_1;
 
 	cm_setup_context(ctx, &ep_info);
 
-	/*
-	 * Setup translation tables
-	 * ------------------------
-	 */
-
-	sp_map_memory_regions(sp_ctx);
-
 	/*
 	 * MMU-related registers
 	 * ---------------------
@@ -79,7 +81,8 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 		      mmu_cfg_params[MMU_CFG_TCR]);
 
 	write_ctx_reg(get_sysregs_ctx(ctx), CTX_TTBR0_EL1,
-		      mmu_cfg_params[MMU_CFG_TTBR0]);
+		      mmu_cfg_params[MMU_CFG_TTBR0] |
+		      ((uint64_t)xlat_ctx->asid << TTBR_ASID_SHIFT));
 
 	/* Setup SCTLR_EL1 */
 	u_register_t sctlr_el1 = read_ctx_reg(get_sysregs_ctx(ctx), CTX_SCTLR_EL1);
@@ -134,6 +137,38 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 	write_ctx_reg(get_sysregs_ctx(ctx), CTX_CPACR_EL1,
 			CPACR_EL1_FPEN(CPACR_EL1_FP_TRAP_NONE));
 
+}
+
+/* Setup context of the Secure Partition */
+void spm_sp_setup(sp_context_t *sp_ctx)
+{
+	/*
+	 * Setup translation tables
+	 * ------------------------
+	 */
+
+	xlat_set_asid_ctx(sp_ctx->xlat_ctx_handle, spm_next_asid);
+	spm_next_asid++;
+
+	sp_map_memory_regions(sp_ctx);
+
+	/*
+	 * Setup execution contexts
+	 * ------------------------
+	 *
+	 * MP partitions have one execution context per CPU, UP partitions only
+	 * have one.
+	 */
+	if ((sp_ctx->rd.attribute.sp_type & RD_ATTR_TYPE_MP) != 0U) {
+		sp_ctx->exec_ctx_num = PLATFORM_CORE_COUNT;
+	} else {
+		sp_ctx->exec_ctx_num = 1U;
+	}
+
+	for (unsigned int i = 0U; i < sp_ctx->exec_ctx_num; i++) {
+		spm_sp_exec_ctx_setup(sp_ctx, i);
+	}
+
 	/*
 	 * Prepare shared buffers
 	 * ----------------------
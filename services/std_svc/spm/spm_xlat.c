@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SPM
+
 #include <arch.h>
 #include <arch_helpers.h>
 #include <assert.h>
@@ -65,6 +67,11 @@ static int sp_xlat_mapped_regions[PLAT_SP_IMAGE_MAX_XLAT_TABLES]
 static OBJECT_POOL(sp_xlat_mapped_regions_pool, sp_xlat_mapped_regions,
 	sizeof(int) * PLAT_SP_IMAGE_MAX_XLAT_TABLES, PLAT_SPM_MAX_PARTITIONS);
 
+static int sp_xlat_next_free[PLAT_SP_IMAGE_MAX_XLAT_TABLES]
+	[PLAT_SPM_MAX_PARTITIONS];
+static OBJECT_POOL(sp_xlat_next_free_pool, sp_xlat_next_free,
+	sizeof(int) * PLAT_SP_IMAGE_MAX_XLAT_TABLES, PLAT_SPM_MAX_PARTITIONS);
+
 /* Allocate individual contexts. */
 static xlat_ctx_t sp_xlat_ctx[PLAT_SPM_MAX_PARTITIONS];
 static OBJECT_POOL(sp_xlat_ctx_pool, sp_xlat_ctx, sizeof(xlat_ctx_t),
@@ -82,12 +89,13 @@ xlat_ctx_t *spm_sp_xlat_context_alloc(void)
 					PLAT_SP_IMAGE_MAX_XLAT_TABLES);
 
 	int *mapped_regions = pool_alloc(&sp_xlat_mapped_regions_pool);
+	int *next_free = pool_alloc(&sp_xlat_next_free_pool);
 
 	xlat_setup_dynamic_ctx(ctx, PLAT_PHY_ADDR_SPACE_SIZE - 1,
 			       PLAT_VIRT_ADDR_SPACE_SIZE - 1, mmap,
 			       PLAT_SP_IMAGE_MMAP_REGIONS, tables,
 			       PLAT_SP_IMAGE_MAX_XLAT_TABLES, base_table,
-			       EL1_EL0_REGIME, mapped_regions);
+			       EL1_EL0_REGIME, mapped_regions, next_free);
 
 	return ctx;
 };
@@ -104,8 +112,36 @@ xlat_ctx_t *spm_sp_xlat_context_alloc(void)
 static OBJECT_POOL(spm_heap_mem, (void *)PLAT_SPM_HEAP_BASE, 1U,
 		   PLAT_SPM_HEAP_SIZE);
 
-static uintptr_t spm_alloc_heap(size_t size)
+/*
+ * Allocate the memory of a region mapped at `va` in a Secure Partition. A
+ * block descriptor can only map a part of the region if its VA and PA have the
+ * same offset in the block. The allocation is padded to give the PA the same
+ * offset as the VA in the biggest block, no bigger than the mapping
+ * `granularity`, that the region can contain, as long as the padding fits in
+ * the heap. This keeps the tables of the partition and its TLB footprint small.
+ */
+static uintptr_t spm_alloc_heap(uintptr_t va, size_t size, size_t granularity)
 {
+	uintptr_t base = PLAT_SPM_HEAP_BASE + spm_heap_mem.used;
+	size_t left = spm_heap_mem.capacity - spm_heap_mem.used;
+	unsigned int level;
+
+	for (level = MIN_LVL_BLOCK_DESC; level < XLAT_TABLE_LEVEL_MAX; level++) {
+		size_t block = XLAT_BLOCK_SIZE(level);
+		size_t pad = (va - base) & (block - 1U);
+
+		if ((block > granularity) ||
+		    ((round_up(va, block) + block) > (va + size)))
+			continue;
+
+		if ((pad != 0U) && ((pad + size) <= left)) {
+			VERBOSE("  Aligning region to 0x%zx blocks\n", block);
+			(void)pool_alloc_n(&spm_heap_mem, pad);
+		}
+
+		break;
+	}
+
 	return (uintptr_t)pool_alloc_n(&spm_heap_mem, size);
 }
 
@@ -193,11 +229,24 @@ static void map_rdmem(sp_context_t *sp_ctx, struct sp_rd_sect_mem_region *rdmem)
 			panic();
 		}
 
-		rd_base_pa = spm_alloc_heap(rd_size);
-
 		/* Get offset into the image */
 		void *img_pa = (void *)(sp_base_pa + rd_base_va - sp_base_va);
 
+		/*
+		 * The package is only used to hold the images of the
+		 * partitions, so a section that covers whole pages of the
+		 * image is used where it was loaded instead of being copied.
+		 */
+		if ((((uintptr_t)img_pa | rd_base_va | rd_size) &
+		     PAGE_SIZE_MASK) == 0U) {
+			VERBOSE("  Using data in place at %p\n", img_pa);
+			rd_base_pa = (uintptr_t)img_pa;
+			break;
+		}
+
+		rd_base_pa = spm_alloc_heap(rd_base_va, rd_size,
+					    mmap.granularity);
+
 		VERBOSE("  Copying data from %p to 0x%llx\n", img_pa, rd_base_pa);
 
 		/* Map destination */
@@ -223,7 +272,8 @@ static void map_rdmem(sp_context_t *sp_ctx, struct sp_rd_sect_mem_region *rdmem)
 	case RD_MEM_NORMAL_MISCELLANEOUS:
 		/* Allow SPM to change the attributes of the region. */
 		mmap.granularity = PAGE_SIZE;
-		rd_base_pa = spm_alloc_heap(rd_size);
+		rd_base_pa = spm_alloc_heap(rd_base_va, rd_size,
+					    mmap.granularity);
 		zero_region = 1;
 		break;
 
@@ -233,7 +283,8 @@ static void map_rdmem(sp_context_t *sp_ctx, struct sp_rd_sect_mem_region *rdmem)
 			ERROR("A partition must have only one SPM<->SP buffer.\n");
 			panic();
 		}
-		rd_base_pa = spm_alloc_heap(rd_size);
+		rd_base_pa = spm_alloc_heap(rd_base_va, rd_size,
+					    mmap.granularity);
 		zero_region = 1;
 		/* Save location of this buffer, it is needed by SPM */
 		sp_ctx->spm_sp_buffer_base = rd_base_pa;
@@ -243,7 +294,8 @@ static void map_rdmem(sp_context_t *sp_ctx, struct sp_rd_sect_mem_region *rdmem)
 	case RD_MEM_NORMAL_CLIENT_SHARED_MEM:
 		/* Fallthrough */
 	case RD_MEM_NORMAL_BSS:
-		rd_base_pa = spm_alloc_heap(rd_size);
+		rd_base_pa = spm_alloc_heap(rd_base_va, rd_size,
+					    mmap.granularity);
 		zero_region = 1;
 		break;
 
@@ -310,3 +362,37 @@ void sp_map_memory_regions(sp_context_t *sp_ctx)
 
 	init_xlat_tables_ctx(sp_ctx->xlat_ctx_handle);
 }
+
+/*
+ * Map a buffer of the Normal world in a Secure Partition at run time, with the
+ * same VA as its PA. The buffer is mapped as Non-secure memory, so it can't be
+ * used to access Secure memory. Returns 0 on success, a negative error code
+ * from the translation tables library otherwise.
+ */
+int spm_sp_map_ns_memory(sp_context_t *sp_ctx, uintptr_t base, size_t size,
+			 int rw)
+{
+	int rc;
+	mmap_region_t mmap = MAP_REGION_FLAT(base, size,
+		MT_MEMORY | MT_NS | MT_USER | MT_EXECUTE_NEVER |
+		((rw != 0) ? MT_RW : MT_RO));
+
+	spin_lock(&(sp_ctx->xlat_ctx_lock));
+	rc = mmap_add_dynamic_region_ctx(sp_ctx->xlat_ctx_handle, &mmap);
+	spin_unlock(&(sp_ctx->xlat_ctx_lock));
+
+	return rc;
+}
+
+/* Unmap a buffer mapped by spm_sp_map_ns_memory(). */
+int spm_sp_unmap_ns_memory(sp_context_t *sp_ctx, uintptr_t base, size_t size)
+{
+	int rc;
+
+	spin_lock(&(sp_ctx->xlat_ctx_lock));
+	rc = mmap_remove_dynamic_region_ctx(sp_ctx->xlat_ctx_handle, base,
+					    size);
+	spin_unlock(&(sp_ctx->xlat_ctx_lock));
+
+	return rc;
+}
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#define LOG_MODULE LOG_MODULE_SPM
+
 #include <arch_helpers.h>
 #include <assert.h>
 #include <context_mgmt.h>
@@ -7,6 +7,7 @@
 #include <arch_helpers.h>
 #include <assert.h>
 #include <bl31.h>
+#include <cassert.h>
 #include <context_mgmt.h>
 #include <debug.h>
 #include <ehf.h>
@@ -25,9 +26,24 @@
 #include "spm_private.h"
 
 /*******************************************************************************
- * Secure Partition context information.
+ * Secure Partition context information. There is one context for each MM
+ * request that the partition can handle at the same time.
  ******************************************************************************/
-static sp_context_t sp_ctx;
+static sp_context_t sp_ctx[PLAT_SPM_MM_CONTEXTS];
+
+CASSERT(PLAT_SPM_MM_CONTEXTS <= PLATFORM_CORE_COUNT,
+	assert_spm_mm_contexts_fit_stacks);
+
+/* Context that each CPU is running, if any */
+static sp_context_t *cpu_sp_ctx[PLATFORM_CORE_COUNT];
+
+/*
+ * Non-secure buffer of the partition, through which the MM requests are passed.
+ * It is looked up once in the memory map of the partition at setup, so that the
+ * buffer of a request can then be validated with a range check.
+ */
+static uintptr_t ns_buf_base;
+static size_t ns_buf_size;
 
 /*******************************************************************************
  * Set state of a Secure Partition context.
@@ -92,6 +108,7 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx)
 	assert(sp_ctx != NULL);
 
 	/* Assign the context of the SP to this CPU */
+	cpu_sp_ctx[plat_my_core_pos()] = sp_ctx;
 	cm_set_context(&(sp_ctx->cpu_ctx), SECURE);
 
 	/* Restore the context assigned above */
@@ -117,7 +134,9 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *sp_ctx)
  ******************************************************************************/
 __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
 {
-	sp_context_t *ctx = &sp_ctx;
+	sp_context_t *ctx = cpu_sp_ctx[plat_my_core_pos()];
+
+	assert(ctx != NULL);
 
 	/*
 	 * The SPM must have initiated the original request through a
@@ -134,25 +153,45 @@ __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
  ******************************************************************************/
 static int32_t spm_init(void)
 {
-	uint64_t rc;
+	uint64_t rc = 0U;
 	sp_context_t *ctx;
+	unsigned int i;
 
 	INFO("Secure Partition init...\n");
 
-	ctx = &sp_ctx;
+	/* Each execution context goes through the initialization */
+	for (i = 0U; i < PLAT_SPM_MM_CONTEXTS; i++) {
+		ctx = &sp_ctx[i];
 
-	ctx->state = SP_STATE_RESET;
+		ctx->state = SP_STATE_RESET;
 
-	rc = spm_sp_synchronous_entry(ctx);
-	assert(rc == 0);
+		rc = spm_sp_synchronous_entry(ctx);
+		assert(rc == 0);
 
-	ctx->state = SP_STATE_IDLE;
+		ctx->state = SP_STATE_IDLE;
+	}
 
 	INFO("Secure Partition initialized.\n");
 
 	return rc;
 }
 
+/*******************************************************************************
+ * Find the Non-secure buffer in the memory map of the Secure Partition.
+ ******************************************************************************/
+static void spm_find_ns_buf(void)
+{
+	const mmap_region_t *mm = plat_get_secure_partition_mmap(NULL);
+
+	for (; mm->size != 0U; mm++) {
+		if ((mm->attr & MT_NS) != 0U) {
+			ns_buf_base = (uintptr_t)mm->base_pa;
+			ns_buf_size = mm->size;
+			return;
+		}
+	}
+}
+
 /*******************************************************************************
  * Initialize contexts of all Secure Partitions.
  ******************************************************************************/
@@ -166,13 +205,18 @@ int32_t spm_setup(void)
 	/* Initialize context of the SP */
 	INFO("Secure Partition context setup start...\n");
 
-	ctx = &sp_ctx;
+	ctx = &sp_ctx[0];
 
 	/* Assign translation tables context. */
 	ctx->xlat_ctx_handle = spm_get_sp_xlat_context();
 
 	spm_sp_setup(ctx);
 
+	for (unsigned int i = 1U; i < PLAT_SPM_MM_CONTEXTS; i++)
+		spm_sp_setup_secondary(&sp_ctx[i], ctx, i);
+
+	spm_find_ns_buf();
+
 	/* Register init function for deferred init.  */
 	bl31_register_bl32_init(&spm_init);
 
@@ -181,16 +225,38 @@ int32_t spm_setup(void)
 	return 0;
 }
 
+/*******************************************************************************
+ * Wait until an execution context of the Secure Partition is idle, set it to
+ * busy and return it. Each CPU starts looking from a different context, so that
+ * CPUs making requests at the same time don't contend for the same one.
+ ******************************************************************************/
+static sp_context_t *spm_sp_ctx_acquire(void)
+{
+	unsigned int first = plat_my_core_pos() % PLAT_SPM_MM_CONTEXTS;
+	sp_context_t *sp_ptr;
+	unsigned int i;
+
+	for (;;) {
+		for (i = 0U; i < PLAT_SPM_MM_CONTEXTS; i++) {
+			sp_ptr = &sp_ctx[(first + i) % PLAT_SPM_MM_CONTEXTS];
+
+			if (sp_state_try_switch(sp_ptr, SP_STATE_IDLE,
+						SP_STATE_BUSY) == 0)
+				return sp_ptr;
+		}
+	}
+}
+
 /*******************************************************************************
  * Function to perform a call to a Secure Partition.
  ******************************************************************************/
 uint64_t spm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 {
 	uint64_t rc;
-	sp_context_t *sp_ptr = &sp_ctx;
+	sp_context_t *sp_ptr;
 
 	/* Wait until the Secure Partition is idle and set it to busy. */
-	sp_state_wait_switch(sp_ptr, SP_STATE_IDLE, SP_STATE_BUSY);
+	sp_ptr = spm_sp_ctx_acquire();
 
 	/* Set values for registers on SP entry */
 	cpu_context_t *cpu_ctx = &(sp_ptr->cpu_ctx);
@@ -234,10 +300,21 @@ static uint64_t mm_communicate(uint32_t smc_fid, uint64_t mm_cookie,
 		VERBOSE("MM_COMMUNICATE: comm_size_address is not 0 as recommended.\n");
 	}
 
+	/*
+	 * The buffer must be in the Non-secure buffer of the partition. Callers
+	 * that make requests at the same time must use different parts of it.
+	 */
+	if ((ns_buf_size != 0U) &&
+	    ((comm_buffer_address < ns_buf_base) ||
+	     ((comm_buffer_address - ns_buf_base) >= ns_buf_size))) {
+		ERROR("MM_COMMUNICATE: comm_buffer_address is out of the buffer\n");
+		SMC_RET1(handle, SPM_INVALID_PARAMETER);
+	}
+
 	/*
 	 * The current secure partition design mandates
-	 * - at any point, only a single core can be
-	 *   executing in the secure partiton.
+	 * - at any point, only PLAT_SPM_MM_CONTEXTS cores can
+	 *   be executing in the secure partiton.
 	 * - a core cannot be preempted by an interrupt
 	 *   while executing in secure partition.
 	 * Raise the running priority of the core to the
@@ -287,7 +364,10 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 
 		/* Handle SMCs from Secure world. */
 
+		sp_context_t *sp_ptr = cpu_sp_ctx[plat_my_core_pos()];
+
 		assert(handle == cm_get_context(SECURE));
+		assert((sp_ptr != NULL) && (handle == &sp_ptr->cpu_ctx));
 
 		/* Make next ERET jump to S-EL0 instead of S-EL1. */
 		cm_set_elr_spsr_el3(SECURE, read_elr_el1(), read_spsr_el1());
@@ -303,24 +383,24 @@ uint64_t spm_smc_handler(uint32_t smc_fid,
 		case SP_MEMORY_ATTRIBUTES_GET_AARCH64:
 			INFO("Received SP_MEMORY_ATTRIBUTES_GET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if (sp_ptr->state != SP_STATE_RESET) {
 				WARN("SP_MEMORY_ATTRIBUTES_GET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_get_smc_handler(
-					 &sp_ctx, x1));
+					 sp_ptr, x1));
 
 		case SP_MEMORY_ATTRIBUTES_SET_AARCH64:
 			INFO("Received SP_MEMORY_ATTRIBUTES_SET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if (sp_ptr->state != SP_STATE_RESET) {
 				WARN("SP_MEMORY_ATTRIBUTES_SET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_set_smc_handler(
-					&sp_ctx, x1, x2, x3));
+					sp_ptr, x1, x2, x3));
 		default:
 			break;
 		}
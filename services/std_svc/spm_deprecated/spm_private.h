@@ -31,10 +31,20 @@
 
 #ifndef __ASSEMBLY__
 
+#include <platform_def.h>
 #include <spinlock.h>
 #include <stdint.h>
 #include <xlat_tables_v2.h>
 
+/*
+ * Number of execution contexts of the Secure Partition, i.e. of MM requests
+ * that it can handle at the same time. Each context has its own stack in the
+ * per-CPU stack area of the partition.
+ */
+#ifndef PLAT_SPM_MM_CONTEXTS
+#define PLAT_SPM_MM_CONTEXTS	1
+#endif
+
 typedef enum sp_state {
 	SP_STATE_RESET = 0,
 	SP_STATE_IDLE,
@@ -55,6 +65,8 @@ uint64_t spm_secure_partition_enter(uint64_t *c_rt_ctx);
 void __dead2 spm_secure_partition_exit(uint64_t c_rt_ctx, uint64_t ret);
 
 void spm_sp_setup(sp_context_t *sp_ctx);
+void spm_sp_setup_secondary(sp_context_t *sp_ctx, const sp_context_t *primary,
+			    unsigned int index);
 
 xlat_ctx_t *spm_get_sp_xlat_context(void);
 
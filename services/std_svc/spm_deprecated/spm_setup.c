@@ -245,3 +245,21 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 			sp_mp_info[index].flags |= MP_INFO_FLAG_PRIMARY_CPU;
 	}
 }
+
+/*
+ * Setup an additional execution context of the Secure Partition. It starts like
+ * the first one, set up by spm_sp_setup(), and shares its translation tables,
+ * but runs on the stack that follows the ones of the previous contexts.
+ */
+void spm_sp_setup_secondary(sp_context_t *sp_ctx, const sp_context_t *primary,
+			    unsigned int index)
+{
+	assert(index < PLATFORM_CORE_COUNT);
+
+	sp_ctx->xlat_ctx_handle = primary->xlat_ctx_handle;
+	sp_ctx->cpu_ctx = primary->cpu_ctx;
+
+	write_ctx_reg(get_gpregs_ctx(&sp_ctx->cpu_ctx), CTX_GPREG_SP_EL0,
+		      PLAT_SP_IMAGE_STACK_BASE +
+		      ((index + 1U) * PLAT_SP_IMAGE_STACK_PCPU_SIZE));
+}
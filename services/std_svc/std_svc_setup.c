@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <cpu_data.h>
 #include <debug.h>
+#include <platform.h>
 #include <pmf.h>
 #include <psci.h>
 #include <runtime_instr.h>
@@ -16,6 +17,7 @@
 #include <spm_svc.h>
 #include <std_svc.h>
 #include <stdint.h>
+#include <utils_def.h>
 #include <uuid.h>
 
 /* Standard Service UUID */
@@ -27,6 +29,84 @@ static uuid_t arm_svc_uid = {
 	{0xc0, 0xfb, 0x56, 0x41, 0xf6, 0xe2}
 };
 
+#if RT_SVC_FID_HANDLERS && !ENABLE_RUNTIME_INSTRUMENTATION
+/*
+ * Handler bound directly to the PSCI CPU_SUSPEND function ids, so that these
+ * frequent calls skip the Standard Service and PSCI dispatch. It performs the
+ * same checks as psci_smc_handler().
+ */
+static uintptr_t psci_cpu_suspend_smc_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	if (is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	if (((smc_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_32) {
+		/* 32-bit PSCI function, clear top parameter bits */
+		x2 = (uint32_t)x2;
+		x3 = (uint32_t)x3;
+	}
+
+	SMC_RET1(handle, (u_register_t)psci_cpu_suspend((unsigned int)x1,
+							x2, x3));
+}
+
+/*
+ * Leaf handler bound to the PSCI calls that only return information. It
+ * performs the same checks as psci_smc_handler().
+ */
+static uintptr_t psci_query_smc_handler(uint32_t smc_fid,
+			     u_register_t x1,
+			     u_register_t x2,
+			     u_register_t x3,
+			     u_register_t x4,
+			     void *cookie,
+			     void *handle,
+			     u_register_t flags)
+{
+	if (is_caller_secure(flags))
+		SMC_RET1(handle, SMC_UNK);
+
+	if (smc_fid == PSCI_VERSION)
+		SMC_RET1(handle, (u_register_t)psci_version());
+
+	SMC_RET1(handle, (u_register_t)psci_features((uint32_t)x1));
+}
+
+static void std_svc_register_fids(void)
+{
+	static const uint32_t suspend_fids[] = {
+		PSCI_CPU_SUSPEND_AARCH32,
+#ifndef AARCH32
+		PSCI_CPU_SUSPEND_AARCH64,
+#endif
+	};
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(suspend_fids); i++) {
+		if (psci_features(suspend_fids[i]) == PSCI_E_NOT_SUPPORTED)
+			continue;
+
+		if (runtime_svc_register_fid(suspend_fids[i],
+				psci_cpu_suspend_smc_handler) != 0)
+			WARN("Failed to bind SMC 0x%x to its handler\n",
+			     suspend_fids[i]);
+	}
+
+	if ((runtime_svc_register_leaf_fid(PSCI_VERSION,
+				psci_query_smc_handler) != 0) ||
+	    (runtime_svc_register_leaf_fid(PSCI_FEATURES,
+				psci_query_smc_handler) != 0))
+		WARN("Failed to bind the PSCI query SMCs to their handler\n");
+}
+#endif /* RT_SVC_FID_HANDLERS && !ENABLE_RUNTIME_INSTRUMENTATION */
+
 /* Setup Standard Services */
 static int32_t std_svc_setup(void)
 {
@@ -44,6 +124,15 @@ static int32_t std_svc_setup(void)
 		ret = 1;
 	}
 
+#if PSCI_PRESET_CPU_ON_CONTEXT
+	/* Prepare the Non-secure context of the secondary CPUs */
+	psci_preset_cpu_on_context(bl31_plat_get_next_image_ep_info(NON_SECURE));
+#endif
+
+#if RT_SVC_FID_HANDLERS && !ENABLE_RUNTIME_INSTRUMENTATION
+	std_svc_register_fids();
+#endif
+
 #if ENABLE_SPM
 	if (spm_setup() != 0) {
 		ret = 1;
@@ -99,6 +188,10 @@ static uintptr_t std_svc_smc_handler(uint32_t smc_fid,
 		    PMF_NO_CACHE_MAINT);
 #endif
 
+#if ENABLE_PSCI_SUSPEND_TRACE
+		rt_instr_suspend_trace_record();
+#endif
+
 		SMC_RET1(handle, ret);
 	}
 
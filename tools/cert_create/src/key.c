@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -81,11 +81,11 @@ err:
 }
 
 #ifndef OPENSSL_NO_EC
-static int key_create_ecdsa(key_t *key)
+static int key_create_ecdsa_curve(key_t *key, int curve_nid)
 {
 	EC_KEY *ec;
 
-	ec = EC_KEY_new_by_curve_name(NID_X9_62_prime256v1);
+	ec = EC_KEY_new_by_curve_name(curve_nid);
 	if (ec == NULL) {
 		printf("Cannot create EC key\n");
 		goto err;
@@ -106,6 +106,16 @@ err:
 	EC_KEY_free(ec);
 	return 0;
 }
+
+static int key_create_ecdsa(key_t *key)
+{
+	return key_create_ecdsa_curve(key, NID_X9_62_prime256v1);
+}
+
+static int key_create_ecdsa_p384(key_t *key)
+{
+	return key_create_ecdsa_curve(key, NID_secp384r1);
+}
 #endif /* OPENSSL_NO_EC */
 
 typedef int (*key_create_fn_t)(key_t *key);
@@ -114,6 +124,7 @@ static const key_create_fn_t key_create_fn[KEY_ALG_MAX_NUM] = {
 	key_create_rsa, 	/* KEY_ALG_RSA_1_5 */
 #ifndef OPENSSL_NO_EC
 	key_create_ecdsa, 	/* KEY_ALG_ECDSA */
+	key_create_ecdsa_p384,	/* KEY_ALG_ECDSA_P384 */
 #endif /* OPENSSL_NO_EC */
 };
 
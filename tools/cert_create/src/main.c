@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,9 +7,11 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -65,6 +67,7 @@
 #define ID_TO_BIT_MASK(id)		(1 << id)
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define MAX_THREADS			16
 
 /* Global options */
 static int key_alg;
@@ -72,6 +75,20 @@ static int hash_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static char *hash_cache;
+
+/* Hash of the images, indexed by extension */
+static const EVP_MD *md_info;
+static unsigned int md_len;
+static unsigned char (*ext_md)[SHA512_DIGEST_LENGTH];
+
+/* Jobs run in parallel by run_jobs() */
+static struct {
+	void (*fn)(unsigned int idx);
+	unsigned int num;
+	unsigned int next;
+	pthread_mutex_t lock;
+} jobs;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -92,7 +109,8 @@ static const char *key_algs_str[] = {
 	[KEY_ALG_RSA] = "rsa",
 	[KEY_ALG_RSA_1_5] = "rsa_1_5",
 #ifndef OPENSSL_NO_EC
-	[KEY_ALG_ECDSA] = "ecdsa"
+	[KEY_ALG_ECDSA] = "ecdsa",
+	[KEY_ALG_ECDSA_P384] = "ecdsa_p384"
 #endif /* OPENSSL_NO_EC */
 };
 
@@ -243,7 +261,8 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "key-alg", required_argument, NULL, 'a' },
 		"Key algorithm: 'rsa' (default) - RSAPSS scheme as per \
-PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa'"
+PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa' - ECDSA P-256, \
+'ecdsa_p384' - ECDSA P-384"
 	},
 	{
 		{ "hash-alg", required_argument, NULL, 's' },
@@ -260,25 +279,215 @@ PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa'"
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "hash-cache", required_argument, NULL, 'H' },
+		"Cache the hashes of the images in the given file, so that \
+unchanged images are not hashed again"
 	}
 };
 
-int main(int argc, char *argv[])
+static void *job_worker(void *arg)
+{
+	unsigned int idx;
+
+	while (1) {
+		pthread_mutex_lock(&jobs.lock);
+		idx = jobs.next++;
+		pthread_mutex_unlock(&jobs.lock);
+
+		if (idx >= jobs.num) {
+			break;
+		}
+		jobs.fn(idx);
+	}
+
+	return NULL;
+}
+
+/*
+ * Call fn() for each index from 0 to num - 1, in parallel on up to one thread
+ * per online CPU. The jobs must be independent from each other.
+ */
+static void run_jobs(void (*fn)(unsigned int idx), unsigned int num)
+{
+	pthread_t threads[MAX_THREADS];
+	long nr_cpus;
+	unsigned int i, nr_threads;
+
+	nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nr_threads = (nr_cpus > 0) ? (unsigned int)nr_cpus : 1;
+	if (nr_threads > MAX_THREADS) {
+		nr_threads = MAX_THREADS;
+	}
+	if (nr_threads > num) {
+		nr_threads = num;
+	}
+
+	jobs.fn = fn;
+	jobs.num = num;
+	jobs.next = 0;
+	if (pthread_mutex_init(&jobs.lock, NULL) != 0) {
+		ERROR("Cannot initialize mutex\n");
+		exit(1);
+	}
+
+	/* The calling thread is one of the workers */
+	for (i = 1; i < nr_threads; i++) {
+		if (pthread_create(&threads[i], NULL, job_worker, NULL) != 0) {
+			ERROR("Cannot create thread\n");
+			exit(1);
+		}
+	}
+	job_worker(NULL);
+	for (i = 1; i < nr_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	pthread_mutex_destroy(&jobs.lock);
+}
+
+/* Load a private key from its file (or generate a new one) */
+static void load_key(unsigned int i)
+{
+	unsigned int err_code;
+
+	if (!key_new(&keys[i])) {
+		ERROR("Failed to allocate key container\n");
+		exit(1);
+	}
+
+	/* First try to load the key from disk */
+	if (key_load(&keys[i], &err_code)) {
+		/* Key loaded successfully */
+		return;
+	}
+
+	/* Key not loaded. Check the error code */
+	if (err_code == KEY_ERR_LOAD) {
+		/* File exists, but it does not contain a valid private
+		 * key. Abort. */
+		ERROR("Error loading '%s'\n", keys[i].fn);
+		exit(1);
+	}
+
+	/* File does not exist, could not be opened or no filename was
+	 * given */
+	if (new_keys) {
+		/* Try to create a new key */
+		NOTICE("Creating new key for '%s'\n", keys[i].desc);
+		if (!key_create(&keys[i], key_alg)) {
+			ERROR("Error creating key '%s'\n", keys[i].desc);
+			exit(1);
+		}
+	} else {
+		if (err_code == KEY_ERR_OPEN) {
+			ERROR("Error opening '%s'\n", keys[i].fn);
+		} else {
+			ERROR("Key '%s' not specified\n", keys[i].desc);
+		}
+		exit(1);
+	}
+}
+
+/* Calculate the hash of the image of a hash extension */
+static void hash_image(unsigned int i)
+{
+	ext_t *ext = &extensions[i];
+
+	if ((ext->type != EXT_TYPE_HASH) || (ext->arg == NULL)) {
+		/* An optional hash missing is filled with zeros */
+		memset(ext_md[i], 0x0, SHA512_DIGEST_LENGTH);
+		return;
+	}
+
+	if (!sha_file(hash_alg, ext->arg, ext_md[i])) {
+		ERROR("Cannot calculate hash of %s\n", ext->arg);
+		exit(1);
+	}
+}
+
+/* Create a certificate, signed with the corresponding key */
+static void create_cert(unsigned int i)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
+	cert_t *cert = &certs[i];
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+
+	if (cert->fn == NULL) {
+		/* Certificate not requested */
+		return;
+	}
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg) {
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if ((ext->arg == NULL) && !ext->optional) {
+				/* Do not include this hash in the certificate */
+				break;
+			}
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, ext_md[cert->ext[j]],
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -315,7 +524,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:hknps:H:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -333,6 +542,9 @@ int main(int argc, char *argv[])
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'H':
+			hash_cache = strdup(optarg);
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -388,119 +600,24 @@ int main(int argc, char *argv[])
 	}
 
 	/* Load private keys from files (or generate new ones) */
-	for (i = 0 ; i < num_keys ; i++) {
-		if (!key_new(&keys[i])) {
-			ERROR("Failed to allocate key container\n");
-			exit(1);
-		}
-
-		/* First try to load the key from disk */
-		if (key_load(&keys[i], &err_code)) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
-			exit(1);
-		}
+	run_jobs(load_key, num_keys);
 
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
-			exit(1);
-		}
+	/* Calculate the hashes of the images */
+	if (hash_cache != NULL) {
+		sha_cache_load(hash_cache);
 	}
-
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->arg) {
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with corresponding key */
-		if (cert->fn && !cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		sk_X509_EXTENSION_free(sk);
+	ext_md = calloc(num_extensions, sizeof(*ext_md));
+	if (ext_md == NULL) {
+		ERROR("Cannot allocate memory for the hashes\n");
+		exit(1);
+	}
+	run_jobs(hash_image, num_extensions);
+	if (hash_cache != NULL) {
+		sha_cache_store(hash_cache);
 	}
 
+	/* Create the certificates */
+	run_jobs(create_cert, num_certs);
 
 	/* Print the certificates */
 	if (print_cert) {
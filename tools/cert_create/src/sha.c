@@ -1,23 +1,222 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* Needed for the nanosecond timestamps of struct stat */
+#define _POSIX_C_SOURCE 200809L
+
 #include <openssl/sha.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
+
+#define BUFFER_SIZE	(64 * 1024)
+
+/*
+ * Cache of the hashes of the images, kept in a file between runs. An image
+ * is only hashed again if it's a different file, or if its size or its
+ * modification or status change times changed since it was hashed.
+ */
+typedef struct sha_cache_entry_s {
+	int md_alg;
+	unsigned long long size;
+	unsigned long long ino;
+	long long mtime_sec, mtime_nsec;
+	long long ctime_sec, ctime_nsec;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	char *filename;
+	struct sha_cache_entry_s *next;
+} sha_cache_entry_t;
+
+static sha_cache_entry_t *sha_cache;
+static int sha_cache_enabled;
+static pthread_mutex_t sha_cache_lock = PTHREAD_MUTEX_INITIALIZER;
 
-#define BUFFER_SIZE	256
+static unsigned int sha_len(int md_alg)
+{
+	if (md_alg == HASH_ALG_SHA384) {
+		return SHA384_DIGEST_LENGTH;
+	} else if (md_alg == HASH_ALG_SHA512) {
+		return SHA512_DIGEST_LENGTH;
+	}
+	return SHA256_DIGEST_LENGTH;
+}
 
+static void sha_cache_fill(sha_cache_entry_t *e, int md_alg,
+			   const struct stat *st)
+{
+	e->md_alg = md_alg;
+	e->size = st->st_size;
+	e->ino = st->st_ino;
+	e->mtime_sec = st->st_mtim.tv_sec;
+	e->mtime_nsec = st->st_mtim.tv_nsec;
+	e->ctime_sec = st->st_ctim.tv_sec;
+	e->ctime_nsec = st->st_ctim.tv_nsec;
+}
+
+/* Return the entry matching the image, or NULL. Called with the lock held. */
+static sha_cache_entry_t *sha_cache_find(int md_alg, const char *filename,
+					 const struct stat *st)
+{
+	sha_cache_entry_t *e, f;
+
+	sha_cache_fill(&f, md_alg, st);
+
+	for (e = sha_cache; e != NULL; e = e->next) {
+		if ((strcmp(e->filename, filename) == 0) &&
+		    (e->md_alg == f.md_alg) && (e->size == f.size) &&
+		    (e->ino == f.ino) && (e->mtime_sec == f.mtime_sec) &&
+		    (e->mtime_nsec == f.mtime_nsec) &&
+		    (e->ctime_sec == f.ctime_sec) &&
+		    (e->ctime_nsec == f.ctime_nsec)) {
+			return e;
+		}
+	}
+
+	return NULL;
+}
+
+static int sha_cache_add(int md_alg, const char *filename,
+			 const struct stat *st, const unsigned char *md)
+{
+	sha_cache_entry_t *e, **p;
+
+	e = malloc(sizeof(*e));
+	if (e == NULL) {
+		return 0;
+	}
+	e->filename = malloc(strlen(filename) + 1);
+	if (e->filename == NULL) {
+		free(e);
+		return 0;
+	}
+	strcpy(e->filename, filename);
+	sha_cache_fill(e, md_alg, st);
+	memcpy(e->md, md, sha_len(md_alg));
+
+	/* Replace the previous entry of the image, if any */
+	for (p = &sha_cache; *p != NULL; p = &(*p)->next) {
+		if ((strcmp((*p)->filename, filename) == 0) &&
+		    ((*p)->md_alg == md_alg)) {
+			e->next = (*p)->next;
+			free((*p)->filename);
+			free(*p);
+			*p = e;
+			return 1;
+		}
+	}
+	e->next = sha_cache;
+	sha_cache = e;
+
+	return 1;
+}
+
+/*
+ * Load the hash cache from `filename`. A missing or corrupted cache file is
+ * not an error, the images are then all hashed.
+ */
+int sha_cache_load(const char *filename)
+{
+	FILE *fp;
+	char line[4096], hex[2 * SHA512_DIGEST_LENGTH + 1], *name;
+	sha_cache_entry_t e;
+	struct stat st;
+	unsigned int i, len;
+	int n, md_alg;
+
+	sha_cache_enabled = 1;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL) {
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		if (sscanf(line, "%d %llu %llu %lld %lld %lld %lld %128s %n",
+			   &md_alg, &e.size, &e.ino, &e.mtime_sec,
+			   &e.mtime_nsec, &e.ctime_sec, &e.ctime_nsec, hex,
+			   &n) != 8) {
+			continue;
+		}
+		name = &line[n];
+		name[strcspn(name, "\n")] = '\0';
+
+		len = sha_len(md_alg);
+		if ((name[0] == '\0') || (strlen(hex) != 2 * len)) {
+			continue;
+		}
+		for (i = 0; i < len; i++) {
+			if (sscanf(&hex[2 * i], "%2hhx", &e.md[i]) != 1) {
+				break;
+			}
+		}
+		if (i != len) {
+			continue;
+		}
+
+		memset(&st, 0, sizeof(st));
+		st.st_size = e.size;
+		st.st_ino = e.ino;
+		st.st_mtim.tv_sec = e.mtime_sec;
+		st.st_mtim.tv_nsec = e.mtime_nsec;
+		st.st_ctim.tv_sec = e.ctime_sec;
+		st.st_ctim.tv_nsec = e.ctime_nsec;
+		if (!sha_cache_add(md_alg, name, &st, e.md)) {
+			break;
+		}
+	}
+
+	fclose(fp);
+	return 1;
+}
+
+/* Write the hash cache to `filename` */
+int sha_cache_store(const char *filename)
+{
+	FILE *fp;
+	sha_cache_entry_t *e;
+	unsigned int i;
+
+	fp = fopen(filename, "w");
+	if (fp == NULL) {
+		ERROR("Cannot create hash cache %s\n", filename);
+		return 0;
+	}
+
+	for (e = sha_cache; e != NULL; e = e->next) {
+		fprintf(fp, "%d %llu %llu %lld %lld %lld %lld ", e->md_alg,
+			e->size, e->ino, e->mtime_sec, e->mtime_nsec,
+			e->ctime_sec, e->ctime_nsec);
+		for (i = 0; i < sha_len(e->md_alg); i++) {
+			fprintf(fp, "%02x", e->md[i]);
+		}
+		fprintf(fp, " %s\n", e->filename);
+	}
+
+	fclose(fp);
+	return 1;
+}
+
+/*
+ * Calculate the hash of a file. Once the hash cache is loaded, the hash of an
+ * unchanged file is taken from the cache. Can be called from several threads.
+ */
 int sha_file(int md_alg, const char *filename, unsigned char *md)
 {
 	FILE *inFile;
 	SHA256_CTX shaContext;
 	SHA512_CTX sha512Context;
+	struct stat st;
+	sha_cache_entry_t *e;
 	int bytes;
-	unsigned char data[BUFFER_SIZE];
+	unsigned char *data;
 
 	if ((filename == NULL) || (md == NULL)) {
 		ERROR("%s(): NULL argument\n", __FUNCTION__);
@@ -30,6 +229,33 @@ int sha_file(int md_alg, const char *filename, unsigned char *md)
 		return 0;
 	}
 
+	if (sha_cache_enabled) {
+		if (fstat(fileno(inFile), &st) != 0) {
+			ERROR("Cannot stat %s\n", filename);
+			fclose(inFile);
+			return 0;
+		}
+
+		pthread_mutex_lock(&sha_cache_lock);
+		e = sha_cache_find(md_alg, filename, &st);
+		if (e != NULL) {
+			memcpy(md, e->md, sha_len(md_alg));
+		}
+		pthread_mutex_unlock(&sha_cache_lock);
+
+		if (e != NULL) {
+			fclose(inFile);
+			return 1;
+		}
+	}
+
+	data = malloc(BUFFER_SIZE);
+	if (data == NULL) {
+		ERROR("%s(): malloc failed\n", __FUNCTION__);
+		fclose(inFile);
+		return 0;
+	}
+
 	if (md_alg == HASH_ALG_SHA384) {
 		SHA384_Init(&sha512Context);
 		while ((bytes = fread(data, 1, BUFFER_SIZE, inFile)) != 0) {
@@ -50,6 +276,16 @@ int sha_file(int md_alg, const char *filename, unsigned char *md)
 		SHA256_Final(md, &shaContext);
 	}
 
+	free(data);
 	fclose(inFile);
+
+	if (sha_cache_enabled) {
+		pthread_mutex_lock(&sha_cache_lock);
+		if (!sha_cache_add(md_alg, filename, &st, md)) {
+			WARN("Cannot add %s to the hash cache\n", filename);
+		}
+		pthread_mutex_unlock(&sha_cache_lock);
+	}
+
 	return 1;
 }
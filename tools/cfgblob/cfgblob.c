@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool compiling the TB_FW_CONFIG DTB of an Arm platform into the blob
+ * read by the images built with ARM_TB_FW_CONFIG_BLOB=1. The properties of the
+ * "arm,tb_fw" node are looked up once here, so that the boot stages read them
+ * at fixed offsets instead of parsing the DTB.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#include "tb_fw_cfg_blob.h"
+
+static const struct {
+	unsigned int index;
+	const char *addr;
+	const char *max_size;
+} config_props[] = {
+	{TB_FW_CFG_BLOB_HW_CONFIG, "hw_config_addr", "hw_config_max_size"},
+	{TB_FW_CFG_BLOB_SOC_FW_CONFIG, "soc_fw_config_addr",
+	 "soc_fw_config_max_size"},
+	{TB_FW_CFG_BLOB_TOS_FW_CONFIG, "tos_fw_config_addr",
+	 "tos_fw_config_max_size"},
+	{TB_FW_CFG_BLOB_NT_FW_CONFIG, "nt_fw_config_addr",
+	 "nt_fw_config_max_size"},
+};
+
+static const void *dtb;
+static int tb_fw_node;
+
+static void usage(void)
+{
+	printf("usage: cfgblob <tb_fw_config.dtb> <tb_fw_config.bin>\n");
+	exit(1);
+}
+
+/* Read a whole file in memory. Exit the program on error. */
+static void *load_file(const char *path)
+{
+	FILE *fp;
+	void *buf;
+	long len;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "error: Failed to open %s\n", path);
+		exit(1);
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "error: Failed to get the size of %s\n", path);
+		exit(1);
+	}
+
+	buf = malloc((size_t)len);
+	if (buf == NULL) {
+		fprintf(stderr, "error: malloc: %s\n", path);
+		exit(1);
+	}
+
+	if (fread(buf, 1U, (size_t)len, fp) != (size_t)len) {
+		fprintf(stderr, "error: Failed to read %s\n", path);
+		exit(1);
+	}
+
+	fclose(fp);
+
+	return buf;
+}
+
+/*
+ * Read a property of `ncells` cells (1 or 2) of the "arm,tb_fw" node. Return 0
+ * if it's found, 1 if it's missing. Exit the program if its size is invalid.
+ */
+static int read_cells(const char *name, int ncells, uint64_t *value)
+{
+	const fdt32_t *prop;
+	int len;
+
+	prop = fdt_getprop(dtb, tb_fw_node, name, &len);
+	if (prop == NULL)
+		return 1;
+
+	if (len != (ncells * (int)sizeof(fdt32_t))) {
+		fprintf(stderr, "error: %s must have %d cell(s)\n", name, ncells);
+		exit(1);
+	}
+
+	*value = fdt32_to_cpu(prop[0]);
+	if (ncells == 2)
+		*value = (*value << 32) | fdt32_to_cpu(prop[1]);
+
+	return 0;
+}
+
+/* Write the blob fields in little-endian, whatever the host endianness */
+static void put32(uint8_t *blob, size_t offset, uint32_t value)
+{
+	unsigned int i;
+
+	for (i = 0U; i < 4U; i++)
+		blob[offset + i] = (uint8_t)(value >> (8U * i));
+}
+
+static void put64(uint8_t *blob, size_t offset, uint64_t value)
+{
+	put32(blob, offset, (uint32_t)value);
+	put32(blob, offset + 4U, (uint32_t)(value >> 32));
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t blob[sizeof(tb_fw_cfg_blob_t)];
+	uint32_t flags = 0U;
+	uint64_t addr, size, value;
+	size_t off;
+	unsigned int i;
+	FILE *fp;
+
+	if (argc != 3)
+		usage();
+
+	dtb = load_file(argv[1]);
+	if (fdt_check_header(dtb) != 0) {
+		fprintf(stderr, "error: %s is not a DTB\n", argv[1]);
+		return 1;
+	}
+
+	tb_fw_node = fdt_node_offset_by_compatible(dtb, -1, "arm,tb_fw");
+	if (tb_fw_node < 0) {
+		fprintf(stderr, "error: No \"arm,tb_fw\" node in %s\n", argv[1]);
+		return 1;
+	}
+
+	memset(blob, 0, sizeof(blob));
+
+	for (i = 0U; i < (sizeof(config_props) / sizeof(config_props[0]));
+	     i++) {
+		/* A configuration is only valid if both properties are set */
+		if ((read_cells(config_props[i].addr, 2, &addr) != 0) ||
+		    (read_cells(config_props[i].max_size, 1, &size) != 0))
+			continue;
+
+		off = offsetof(tb_fw_cfg_blob_t, config) +
+		      (config_props[i].index *
+		       sizeof(tb_fw_cfg_blob_load_info_t));
+		put64(blob, off + offsetof(tb_fw_cfg_blob_load_info_t, addr),
+		      addr);
+		put32(blob, off +
+		      offsetof(tb_fw_cfg_blob_load_info_t, max_size),
+		      (uint32_t)size);
+		put32(blob, off + offsetof(tb_fw_cfg_blob_load_info_t, valid),
+		      1U);
+	}
+
+	if (read_cells("disable_auth", 1, &value) == 0) {
+		flags |= TB_FW_CFG_BLOB_DISABLE_AUTH;
+		put32(blob, offsetof(tb_fw_cfg_blob_t, disable_auth),
+		      (uint32_t)value);
+	}
+
+	/* The heap information is written by BL1 at boot for BL2 */
+	if ((read_cells("mbedtls_heap_addr", 2, &addr) == 0) &&
+	    (read_cells("mbedtls_heap_size", 1, &size) == 0)) {
+		flags |= TB_FW_CFG_BLOB_MBEDTLS_HEAP;
+		put64(blob, offsetof(tb_fw_cfg_blob_t, mbedtls_heap_addr),
+		      addr);
+		put64(blob, offsetof(tb_fw_cfg_blob_t, mbedtls_heap_size),
+		      size);
+	}
+
+	put32(blob, offsetof(tb_fw_cfg_blob_t, magic), TB_FW_CFG_BLOB_MAGIC);
+	put32(blob, offsetof(tb_fw_cfg_blob_t, version),
+	      TB_FW_CFG_BLOB_VERSION);
+	put32(blob, offsetof(tb_fw_cfg_blob_t, size), sizeof(blob));
+	put32(blob, offsetof(tb_fw_cfg_blob_t, flags), flags);
+
+	fp = fopen(argv[2], "wb");
+	if ((fp == NULL) || (fwrite(blob, 1U, sizeof(blob), fp) !=
+			     sizeof(blob)) || (fclose(fp) != 0)) {
+		fprintf(stderr, "error: Failed to write %s\n", argv[2]);
+		return 1;
+	}
+
+	return 0;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -23,6 +23,12 @@
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
 
+/* Size of the chunks in which the images are copied and hashed */
+#define COPY_CHUNK_SIZE (1024 * 1024)
+
+/* Maximum number of threads hashing the images */
+#define MAX_HASH_THREADS 16
+
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(void);
 static int create_cmd(int argc, char *argv[]);
@@ -54,6 +60,10 @@ static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
 
+/* Files the images are read from, closed on exit */
+static FILE **src_files;
+static size_t nr_src_files;
+
 static void vlog(int prio, const char *msg, va_list ap)
 {
 	char *prefix[] = { "DEBUG", "WARN", "ERROR" };
@@ -134,6 +144,80 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 		log_errx("Failed to write %s", filename);
 }
 
+static FILE *open_src_file(const char *filename)
+{
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	src_files = realloc(src_files, (nr_src_files + 1) * sizeof(*src_files));
+	if (src_files == NULL)
+		log_err("realloc");
+	src_files[nr_src_files++] = fp;
+
+	return fp;
+}
+
+static void close_src_files(void)
+{
+	size_t i;
+
+	for (i = 0; i < nr_src_files; i++)
+		fclose(src_files[i]);
+	free(src_files);
+	src_files = NULL;
+	nr_src_files = 0;
+}
+
+static void free_image(image_t *image)
+{
+	free(image->buffer);
+	free(image);
+}
+
+/* Read the content of an image in memory, if it isn't already. */
+static void load_image(image_t *image)
+{
+	if (image->buffer != NULL || image->toc_e.size == 0)
+		return;
+
+	image->buffer = xmalloc(image->toc_e.size,
+	    "failed to allocate image buffer");
+	if (fseek(image->src_fp, image->src_offset, SEEK_SET))
+		log_errx("Failed to set file position");
+	if (fread(image->buffer, 1, image->toc_e.size, image->src_fp) !=
+	    image->toc_e.size)
+		log_errx("Failed to read image");
+}
+
+/* Write the content of an image to fp, by chunks if it isn't loaded. */
+static void write_image(const image_t *image, FILE *fp, const char *filename)
+{
+	uint64_t left;
+	size_t n;
+	char *chunk;
+
+	if (image->buffer != NULL || image->toc_e.size == 0) {
+		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		return;
+	}
+
+	chunk = xmalloc(COPY_CHUNK_SIZE, "failed to allocate copy buffer");
+	if (fseek(image->src_fp, image->src_offset, SEEK_SET))
+		log_errx("Failed to set file position");
+
+	for (left = image->toc_e.size; left > 0; left -= n) {
+		n = left < COPY_CHUNK_SIZE ? left : COPY_CHUNK_SIZE;
+		if (fread(chunk, 1, n, image->src_fp) != n)
+			log_errx("Failed to read image");
+		xfwrite(chunk, n, fp, filename);
+	}
+
+	free(chunk);
+}
+
 static image_desc_t *new_image_desc(const uuid_t *uuid,
     const char *name, const char *cmdline_name)
 {
@@ -169,10 +253,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -278,79 +360,74 @@ static void uuid_from_str(uuid_t *u, const char *s)
 		log_errx("Invalid UUID: %s", s);
 }
 
+/*
+ * Parse the ToC of a FIP. The images are not loaded in memory, they are read
+ * from the FIP when they are written or hashed.
+ */
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
 	struct BLD_PLAT_STAT st;
 	FILE *fp;
-	char *buf, *bufend;
-	fip_toc_header_t *toc_header;
-	fip_toc_entry_t *toc_entry;
+	fip_toc_header_t toc_header;
+	fip_toc_entry_t toc_entry;
 	int terminated = 0;
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	fp = open_src_file(filename);
 
 	if (fstat(fileno(fp), &st) == -1)
 		log_err("fstat %s", filename);
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
 	if (st.st_size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
-	toc_header = (fip_toc_header_t *)buf;
-	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+	if (fread(&toc_header, 1, sizeof(toc_header), fp) !=
+	    sizeof(toc_header))
+		log_errx("Failed to read %s", filename);
 
-	if (toc_header->name != TOC_HEADER_NAME)
+	if (toc_header.name != TOC_HEADER_NAME)
 		log_errx("%s is not a FIP file", filename);
 
 	/* Return the ToC header if the caller wants it. */
 	if (toc_header_out != NULL)
-		*toc_header_out = *toc_header;
+		*toc_header_out = toc_header;
 
 	/* Walk through each ToC entry in the file. */
-	while ((char *)toc_entry + sizeof(*toc_entry) - 1 < bufend) {
+	while (fread(&toc_entry, 1, sizeof(toc_entry), fp) ==
+	    sizeof(toc_entry)) {
 		image_t *image;
 		image_desc_t *desc;
 
 		/* Found the ToC terminator, we are done. */
-		if (memcmp(&toc_entry->uuid, &uuid_null, sizeof(uuid_t)) == 0) {
+		if (memcmp(&toc_entry.uuid, &uuid_null, sizeof(uuid_t)) == 0) {
 			terminated = 1;
 			break;
 		}
 
+		/* Overflow checks before the image is read. */
+		if (toc_entry.size > (uint64_t)-1 - toc_entry.offset_address)
+			log_errx("FIP %s is corrupted", filename);
+		if (toc_entry.size + toc_entry.offset_address > st.st_size)
+			log_errx("FIP %s is corrupted", filename);
+
 		/*
 		 * Build a new image out of the ToC entry and add it to the
 		 * table of images.
 		 */
 		image = xzalloc(sizeof(*image),
 		    "failed to allocate memory for image");
-		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
-		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
-			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
-			log_errx("FIP %s is corrupted", filename);
-
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		image->toc_e = toc_entry;
+		image->src_fp = fp;
+		image->src_offset = toc_entry.offset_address;
 
 		/* If this is an unknown image, create a descriptor for it. */
-		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
+		desc = lookup_image_desc_from_uuid(&toc_entry.uuid);
 		if (desc == NULL) {
 			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
 
-			uuid_to_str(name, sizeof(name), &toc_entry->uuid);
+			uuid_to_str(name, sizeof(name), &toc_entry.uuid);
 			snprintf(filename, sizeof(filename), "%s%s",
 			    name, ".bin");
-			desc = new_image_desc(&toc_entry->uuid, name, "blob");
+			desc = new_image_desc(&toc_entry.uuid, name, "blob");
 			desc->action = DO_UNPACK;
 			desc->action_arg = xstrdup(filename,
 			    "failed to allocate memory for blob filename");
@@ -359,14 +436,11 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 
 		assert(desc->image == NULL);
 		desc->image = image;
-
-		toc_entry++;
 	}
 
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
 	return 0;
 }
 
@@ -379,32 +453,62 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
+	fp = open_src_file(filename);
 
 	if (fstat(fileno(fp), &st) == -1)
 		log_errx("fstat %s", filename);
 
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
 	image->toc_e.size = st.st_size;
+	image->src_fp = fp;
+	image->src_offset = 0;
 
-	fclose(fp);
 	return image;
 }
 
+/*
+ * The images are read from their source file while their destination is
+ * written, so load the images that are read from `filename` in memory before
+ * it is overwritten.
+ */
+static void load_images_from(const char *filename)
+{
+	image_desc_t *desc;
+#ifndef _MSC_VER
+	struct stat st, src_st;
+
+	if (stat(filename, &st) == -1)
+		return;
+#endif
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL || image->buffer != NULL)
+			continue;
+#ifndef _MSC_VER
+		if (fstat(fileno(image->src_fp), &src_st) == -1)
+			log_err("fstat");
+		if (src_st.st_dev != st.st_dev || src_st.st_ino != st.st_ino)
+			continue;
+#else
+		/* There is no file identity to compare, load all the images */
+#endif
+		load_image(image);
+	}
+}
+
 static int write_image_to_file(const image_t *image, const char *filename)
 {
 	FILE *fp;
 
+	load_images_from(filename);
+
 	fp = fopen(filename, "wb");
 	if (fp == NULL)
 		log_err("fopen");
-	xfwrite(image->buffer, image->toc_e.size, fp, filename);
+	write_image(image, fp, filename);
 	fclose(fp);
 	return 0;
 }
@@ -442,10 +546,116 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+/* Images hashed by the threads of hash_images(), in the order of the list */
+static struct {
+	image_t **images;
+	unsigned char (*md)[SHA256_DIGEST_LENGTH];
+	size_t nr_images;
+	size_t next;
+	pthread_mutex_t lock;
+} hash_jobs;
+
+/* Hash an image, reading it by chunks if it isn't loaded. */
+static void hash_image(const image_t *image, unsigned char *md)
+{
+	EVP_MD_CTX *ctx;
+	uint64_t off, end;
+	ssize_t n;
+	char *chunk;
+
+	if (image->buffer != NULL || image->toc_e.size == 0) {
+		SHA256(image->buffer, image->toc_e.size, md);
+		return;
+	}
+
+	ctx = EVP_MD_CTX_new();
+	if (ctx == NULL || !EVP_DigestInit_ex(ctx, EVP_sha256(), NULL))
+		log_errx("Failed to initialize SHA256");
+	chunk = xmalloc(COPY_CHUNK_SIZE, "failed to allocate hash buffer");
+
+	/* pread() keeps the file position shared by the threads unchanged. */
+	end = image->src_offset + image->toc_e.size;
+	for (off = image->src_offset; off < end; off += n) {
+		n = pread(fileno(image->src_fp), chunk,
+		    end - off < COPY_CHUNK_SIZE ? end - off : COPY_CHUNK_SIZE,
+		    off);
+		if (n <= 0)
+			log_errx("Failed to read image");
+		if (!EVP_DigestUpdate(ctx, chunk, n))
+			log_errx("Failed to hash image");
+	}
+
+	if (!EVP_DigestFinal_ex(ctx, md, NULL))
+		log_errx("Failed to hash image");
+
+	free(chunk);
+	EVP_MD_CTX_free(ctx);
+}
+
+static void *hash_worker(void *arg)
+{
+	size_t i;
+
+	while (1) {
+		pthread_mutex_lock(&hash_jobs.lock);
+		i = hash_jobs.next++;
+		pthread_mutex_unlock(&hash_jobs.lock);
+
+		if (i >= hash_jobs.nr_images)
+			break;
+		hash_image(hash_jobs.images[i], hash_jobs.md[i]);
+	}
+
+	return NULL;
+}
+
+/*
+ * Hash all the images in parallel, one image at a time per online CPU.
+ * md[i] is set to the SHA256 of images[i].
+ */
+static void hash_images(image_t **images,
+    unsigned char (*md)[SHA256_DIGEST_LENGTH], size_t nr_images)
+{
+	pthread_t threads[MAX_HASH_THREADS];
+	long nr_cpus;
+	size_t i, nr_threads;
+
+	nr_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	nr_threads = nr_cpus > 0 ? (size_t)nr_cpus : 1;
+	if (nr_threads > MAX_HASH_THREADS)
+		nr_threads = MAX_HASH_THREADS;
+	if (nr_threads > nr_images)
+		nr_threads = nr_images;
+
+	hash_jobs.images = images;
+	hash_jobs.md = md;
+	hash_jobs.nr_images = nr_images;
+	hash_jobs.next = 0;
+	if (pthread_mutex_init(&hash_jobs.lock, NULL) != 0)
+		log_errx("Failed to initialize mutex");
+
+	/* The calling thread is one of the workers. */
+	for (i = 1; i < nr_threads; i++)
+		if (pthread_create(&threads[i], NULL, hash_worker, NULL) != 0)
+			log_errx("Failed to create thread");
+	hash_worker(NULL);
+	for (i = 1; i < nr_threads; i++)
+		pthread_join(threads[i], NULL);
+
+	pthread_mutex_destroy(&hash_jobs.lock);
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	image_t **images = NULL;
+	unsigned char (*md)[SHA256_DIGEST_LENGTH] = NULL;
+	size_t i, nr_images = 0;
+#endif
 
 	if (argc != 2)
 		info_usage();
@@ -462,6 +672,26 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	if (verbose) {
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				nr_images++;
+
+		images = xmalloc(nr_images * sizeof(*images) + 1,
+		    "failed to allocate memory for images");
+		md = xmalloc(nr_images * sizeof(*md) + 1,
+		    "failed to allocate memory for hashes");
+		for (desc = image_desc_head, i = 0; desc != NULL;
+		     desc = desc->next)
+			if (desc->image != NULL)
+				images[i++] = desc->image;
+
+		hash_images(images, md, nr_images);
+	}
+	i = 0;
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -474,16 +704,17 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(md[i++], sizeof(*md));
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(images);
+	free(md);
+#endif
 	return 0;
 }
 
@@ -524,11 +755,13 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	entry_offset = buf_size;
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
+		unsigned long image_align = desc->align ? desc->align : align;
 
 		if (image == NULL)
 			continue;
 		payload_size += image->toc_e.size;
-		entry_offset = (entry_offset + align - 1) & ~(align - 1);
+		entry_offset = (entry_offset + image_align - 1) &
+		    ~(image_align - 1);
 		image->toc_e.offset_address = entry_offset;
 		*toc_entry++ = image->toc_e;
 		entry_offset += image->toc_e.size;
@@ -543,6 +776,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
 	/* Generate the FIP file. */
+	load_images_from(filename);
 	fp = fopen(filename, "wb");
 	if (fp == NULL)
 		log_err("fopen %s", filename);
@@ -563,7 +797,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
 			log_errx("Failed to set file position");
 
-		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		write_image(image, fp, filename);
 	}
 
 	if (fseek(fp, entry_offset, SEEK_SET))
@@ -604,7 +838,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -646,7 +880,31 @@ static unsigned long get_image_align(char *arg)
 	return align;
 }
 
-static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len)
+/*
+ * Parse an --align option: either <value>, the alignment of all the images,
+ * or <image>=<value>, the alignment of the image with the given command line
+ * name, which overrides the former.
+ */
+static void parse_align_opt(char *arg, unsigned long *align)
+{
+	image_desc_t *desc;
+	char *value;
+
+	value = strchr(arg, '=');
+	if (value == NULL) {
+		*align = get_image_align(arg);
+		return;
+	}
+
+	*value++ = '\0';
+	desc = lookup_image_desc_from_opt(arg);
+	if (desc == NULL || strcmp(arg, "blob") == 0)
+		log_errx("Invalid image for alignment: %s", arg);
+	desc->align = get_image_align(value);
+}
+
+static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len,
+    unsigned long *align)
 {
 	char *p;
 
@@ -657,6 +915,10 @@ static void parse_blob_opt(char *arg, uuid_t *uuid, char *filename, size_t len)
 		} else if (strncmp(p, "file=", strlen("file=")) == 0) {
 			p += strlen("file=");
 			snprintf(filename, len, "%s", p);
+		} else if (align != NULL &&
+		    strncmp(p, "align=", strlen("align=")) == 0) {
+			p += strlen("align=");
+			*align = get_image_align(p);
 		}
 	}
 }
@@ -697,16 +959,17 @@ static int create_cmd(int argc, char *argv[])
 			parse_plat_toc_flags(optarg, &toc_flags);
 			break;
 		case OPT_ALIGN:
-			align = get_image_align(optarg);
+			parse_align_opt(optarg, &align);
 			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1];
 			char filename[PATH_MAX] = { 0 };
 			uuid_t uuid = uuid_null;
+			unsigned long blob_align = 0;
 			image_desc_t *desc;
 
 			parse_blob_opt(optarg, &uuid,
-			    filename, sizeof(filename));
+			    filename, sizeof(filename), &blob_align);
 
 			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0 ||
 			    filename[0] == '\0')
@@ -719,6 +982,8 @@ static int create_cmd(int argc, char *argv[])
 				add_image_desc(desc);
 			}
 			set_image_desc_action(desc, DO_PACK, filename);
+			if (blob_align != 0)
+				desc->align = blob_align;
 			break;
 		}
 		default:
@@ -746,7 +1011,8 @@ static void create_usage(void)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
-	printf("  --blob uuid=...,file=...\tAdd an image with the given UUID pointed to by file.\n");
+	printf("  --align <image>=<value>\tThe image with the given option name (e.g. tb-fw) is aligned to <value>.\n");
+	printf("  --blob uuid=...,file=...[,align=...]\tAdd an image with the given UUID pointed to by file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
 	printf("Specific images are packed with the following options:\n");
@@ -800,10 +1066,11 @@ static int update_cmd(int argc, char *argv[])
 			char name[_UUID_STR_LEN + 1];
 			char filename[PATH_MAX] = { 0 };
 			uuid_t uuid = uuid_null;
+			unsigned long blob_align = 0;
 			image_desc_t *desc;
 
 			parse_blob_opt(optarg, &uuid,
-			    filename, sizeof(filename));
+			    filename, sizeof(filename), &blob_align);
 
 			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0 ||
 			    filename[0] == '\0')
@@ -816,10 +1083,12 @@ static int update_cmd(int argc, char *argv[])
 				add_image_desc(desc);
 			}
 			set_image_desc_action(desc, DO_PACK, filename);
+			if (blob_align != 0)
+				desc->align = blob_align;
 			break;
 		}
 		case OPT_ALIGN:
-			align = get_image_align(optarg);
+			parse_align_opt(optarg, &align);
 			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
@@ -859,7 +1128,8 @@ static void update_usage(void)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
-	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --align <image>=<value>\tThe image with the given option name (e.g. tb-fw) is aligned to <value>.\n");
+	printf("  --blob uuid=...,file=...[,align=...]\tAdd or update an image with the given UUID pointed to by file.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -911,7 +1181,7 @@ static int unpack_cmd(int argc, char *argv[])
 			image_desc_t *desc;
 
 			parse_blob_opt(optarg, &uuid,
-			    filename, sizeof(filename));
+			    filename, sizeof(filename), NULL);
 
 			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0 ||
 			    filename[0] == '\0')
@@ -1042,7 +1312,7 @@ static int remove_cmd(int argc, char *argv[])
 			break;
 		}
 		case OPT_ALIGN:
-			align = get_image_align(optarg);
+			parse_align_opt(optarg, &align);
 			break;
 		case 'b': {
 			char name[_UUID_STR_LEN + 1], filename[PATH_MAX];
@@ -1050,7 +1320,7 @@ static int remove_cmd(int argc, char *argv[])
 			image_desc_t *desc;
 
 			parse_blob_opt(optarg, &uuid,
-			    filename, sizeof(filename));
+			    filename, sizeof(filename), NULL);
 
 			if (memcmp(&uuid, &uuid_null, sizeof(uuid_t)) == 0)
 				remove_usage();
@@ -1098,7 +1368,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1118,6 +1388,7 @@ static void remove_usage(void)
 	printf("\n");
 	printf("Options:\n");
 	printf("  --align <value>\tEach image is aligned to <value> (default: 1).\n");
+	printf("  --align <image>=<value>\tThe image with the given option name (e.g. tb-fw) is aligned to <value>.\n");
 	printf("  --blob uuid=...\tRemove an image with the given UUID.\n");
 	printf("  --force\t\tIf the output FIP file already exists, use --force to overwrite it.\n");
 	printf("  --out FIP_FILENAME\tSet an alternative output FIP file.\n");
@@ -1226,5 +1497,6 @@ int main(int argc, char *argv[])
 	if (i == NELEM(cmds))
 		usage();
 	free_image_descs();
+	close_src_files();
 	return ret;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include <firmware_image_package.h>
 #include <uuid.h>
@@ -36,13 +37,21 @@ typedef struct image_desc {
 	char              *cmdline_name;
 	int                action;
 	char              *action_arg;
+	/* Alignment of the image, 0 to use the alignment of the FIP */
+	unsigned long      align;
 	struct image      *image;
 	struct image_desc *next;
 } image_desc_t;
 
+/*
+ * The content of an image is only loaded in memory when it has to be, it is
+ * otherwise read from `src_fp` at `src_offset` when it is written or hashed.
+ */
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	FILE                *src_fp;
+	uint64_t             src_offset;
 } image_t;
 
 typedef struct cmd {
@@ -16,7 +16,9 @@
 
 /* Not Visual Studio, so include Posix Headers. */
 # include <getopt.h>
+# include <openssl/evp.h>
 # include <openssl/sha.h>
+# include <pthread.h>
 # include <unistd.h>
 
 # define  BLD_PLAT_STAT stat
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool decoding the binary log of an image built with LOG_BINARY=1. The
+ * log is a memory dump of the `tf_log_bin` symbol of the image. The format
+ * strings are read from the binary of the image, at their address less the
+ * address the image is loaded at.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "tf_log_bin.h"
+
+/* Same values as the LOG_LEVEL_* macros of debug.h */
+#define LOG_LEVEL_INFO		40U
+#define LOG_LEVEL_VERBOSE	50U
+
+static uint8_t *image;
+static size_t image_size;
+static uint64_t image_base;
+
+static void usage(void)
+{
+	printf("usage: logdecode -i <image.bin> -a <load address> <log dump>\n\n");
+	printf("\t-i: Binary of the image (e.g. bl31.bin)\n");
+	printf("\t-a: Address the image is loaded at (e.g. BL31_BASE)\n");
+	printf("\tlog dump: Memory dump of the tf_log_bin symbol\n");
+
+	exit(1);
+}
+
+/* Read a whole file in memory. Exit the program on error. */
+static uint8_t *load_file(const char *path, size_t *size)
+{
+	FILE *fp;
+	uint8_t *buf;
+	long len;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "error: Failed to open %s\n", path);
+		exit(1);
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "error: Failed to get the size of %s\n", path);
+		exit(1);
+	}
+
+	/* Keep a NUL character after the data to terminate any string */
+	buf = calloc((size_t)len + 1U, 1U);
+	if (buf == NULL) {
+		fprintf(stderr, "error: malloc: %s\n", path);
+		exit(1);
+	}
+
+	if (fread(buf, 1U, (size_t)len, fp) != (size_t)len) {
+		fprintf(stderr, "error: Failed to read %s\n", path);
+		exit(1);
+	}
+
+	fclose(fp);
+
+	*size = (size_t)len;
+
+	return buf;
+}
+
+/* Return the string of the image at `addr`, or NULL if it's not in it */
+static const char *image_string(uint64_t addr)
+{
+	if ((addr < image_base) || ((addr - image_base) >= image_size))
+		return NULL;
+
+	return (const char *)&image[addr - image_base];
+}
+
+/*
+ * Return the number of arguments of a format string, with the same parsing as
+ * log_bin_get_args() in tf_log.c.
+ */
+static unsigned int fmt_nargs(const char *fmt)
+{
+	unsigned int n = 0U;
+
+	while ((*fmt != '\0') && (n < TF_LOG_BIN_MAX_ARGS)) {
+		if (*fmt++ != '%')
+			continue;
+
+		if (*fmt == '0') {
+			while ((*fmt >= '0') && (*fmt <= '9'))
+				fmt++;
+		}
+		while ((*fmt == 'l') || (*fmt == 'z'))
+			fmt++;
+
+		if ((*fmt == '\0') || (strchr("iduxsp", *fmt) == NULL))
+			return n;
+
+		n++;
+		fmt++;
+	}
+
+	return n;
+}
+
+/* Print a message like the printf() of TF-A would */
+static void print_msg(const char *fmt, const uint64_t *argv,
+		      unsigned int nargs)
+{
+	unsigned int n = 0U;
+	const char *str;
+	int padn;
+	uint64_t v;
+
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			putchar(*fmt++);
+			continue;
+		}
+
+		fmt++;
+		padn = 0;
+
+		if (*fmt == '0') {
+			while ((*fmt >= '0') && (*fmt <= '9'))
+				padn = (padn * 10) + (*fmt++ - '0');
+		}
+		while ((*fmt == 'l') || (*fmt == 'z'))
+			fmt++;
+
+		if ((*fmt == '\0') || (strchr("iduxsp", *fmt) == NULL))
+			return;
+
+		if (n == nargs) {
+			printf("<missing>");
+			fmt++;
+			continue;
+		}
+
+		v = argv[n++];
+
+		switch (*fmt) {
+		case 'i':
+		case 'd':
+			printf("%0*lld", padn, (long long)v);
+			break;
+		case 'u':
+			printf("%0*llu", padn, (unsigned long long)v);
+			break;
+		case 'x':
+			printf("%0*llx", padn, (unsigned long long)v);
+			break;
+		case 'p':
+			if (v != 0U)
+				printf("0x%0*llx", (padn > 2) ? padn - 2 : 0,
+				       (unsigned long long)v);
+			else
+				printf("%0*d", padn, 0);
+			break;
+		case 's':
+			str = image_string(v);
+			if (str != NULL)
+				printf("%s", str);
+			else
+				printf("<string at 0x%llx>",
+				       (unsigned long long)v);
+			break;
+		default:
+			break;
+		}
+
+		fmt++;
+	}
+}
+
+/*
+ * Decode the record at `words[i]` of a ring. Return the number of words of
+ * the record, or 0 if there is no valid record there.
+ */
+static unsigned int decode_rec(const uint64_t *words, uint64_t i,
+			       uint64_t end)
+{
+	unsigned int level, nargs;
+	const char *fmt;
+
+	if (!TF_LOG_BIN_IS_REC(words[i]) || ((i + 2U) > end))
+		return 0U;
+
+	level = (unsigned int)(words[i] >> TF_LOG_BIN_REC_LEVEL_SHIFT) &
+		TF_LOG_BIN_REC_LEVEL_MASK;
+	nargs = (unsigned int)words[i] & TF_LOG_BIN_REC_NARGS_MASK;
+	fmt = image_string(words[i + 1U]);
+
+	if ((fmt == NULL) || (nargs > TF_LOG_BIN_MAX_ARGS) ||
+	    ((i + 2U + nargs) > end) || (fmt_nargs(fmt) != nargs))
+		return 0U;
+
+	printf((level == LOG_LEVEL_VERBOSE) ? "VERBOSE: " : "INFO:    ");
+	print_msg(fmt, &words[i + 2U], nargs);
+
+	return nargs + 2U;
+}
+
+/* Decode the records of a ring from `words[start]` to `words[end - 1]` */
+static void decode_range(const uint64_t *words, uint64_t start, uint64_t end,
+			 int resync)
+{
+	uint64_t i = start;
+	unsigned int len;
+
+	while (i < end) {
+		len = decode_rec(words, i, end);
+		if (len != 0U) {
+			i += len;
+			resync = 0;
+		} else if (resync != 0) {
+			/* Look for the first whole record after the head */
+			i++;
+		} else {
+			/* End of the records, the rest of the ring is unused */
+			break;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const tf_log_bin_hdr_t *hdr;
+	const tf_log_bin_ring_hdr_t *ring;
+	const uint64_t *words;
+	const char *image_name = NULL;
+	uint8_t *log;
+	size_t log_size, ring_size;
+	unsigned int cpu;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "hi:a:")) != -1) {
+		switch (ch) {
+		case 'i':
+			image_name = optarg;
+			break;
+		case 'a':
+			image_base = strtoull(optarg, NULL, 0);
+			break;
+		case 'h':
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if ((image_name == NULL) || (argc != 1))
+		usage();
+
+	image = load_file(image_name, &image_size);
+	log = load_file(argv[0], &log_size);
+
+	hdr = (const tf_log_bin_hdr_t *)log;
+	if ((log_size < sizeof(*hdr)) || (hdr->magic != TF_LOG_BIN_MAGIC)) {
+		fprintf(stderr, "error: %s is not a binary log\n", argv[0]);
+		return 1;
+	}
+
+	ring_size = sizeof(*ring) + (hdr->ring_words * sizeof(uint64_t));
+	if ((log_size - sizeof(*hdr)) < (hdr->cpus * ring_size)) {
+		fprintf(stderr, "error: %s is truncated\n", argv[0]);
+		return 1;
+	}
+
+	for (cpu = 0U; cpu < hdr->cpus; cpu++) {
+		ring = (const tf_log_bin_ring_hdr_t *)
+			(log + sizeof(*hdr) + (cpu * ring_size));
+		words = (const uint64_t *)(ring + 1);
+
+		if ((ring->head == 0U) && (ring->wrapped == 0U))
+			continue;
+
+		if (ring->head > hdr->ring_words) {
+			fprintf(stderr, "error: Invalid ring of CPU %u\n", cpu);
+			return 1;
+		}
+
+		printf("CPU %u:\n", cpu);
+
+		/* The oldest records follow the head once the ring wrapped */
+		if (ring->wrapped != 0U)
+			decode_range(words, ring->head, hdr->ring_words, 1);
+		decode_range(words, 0U, ring->head, 0);
+	}
+
+	free(log);
+	free(image);
+
+	return 0;
+}
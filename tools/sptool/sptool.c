@@ -15,6 +15,15 @@
 
 #define PAGE_SIZE		4096
 
+/*
+ * Default alignments of the images and resource description blobs in the
+ * package. The images can be aligned to bigger boundaries, e.g. 2 MB, so that
+ * SPM can map them with block descriptors when the package is loaded at an
+ * address aligned to the same boundary.
+ */
+#define DEFAULT_SP_ALIGN	PAGE_SIZE
+#define DEFAULT_RD_ALIGN	8
+
 /*
  * Linked list of entries describing entries in the secure
  * partition package.
@@ -36,10 +45,13 @@ static struct sp_entry_info *sp_info_head;
 
 static uint64_t sp_count;
 
+static uint64_t sp_align = DEFAULT_SP_ALIGN;
+static uint64_t rd_align = DEFAULT_RD_ALIGN;
+
 /* Align an address to a power-of-two boundary. */
-static unsigned int align_to(unsigned int address, unsigned int boundary)
+static uint64_t align_to(uint64_t address, uint64_t boundary)
 {
-	unsigned int mask = boundary - 1U;
+	uint64_t mask = boundary - 1U;
 
 	if ((address & mask) != 0U)
 		return (address + boundary) & ~mask;
@@ -89,6 +101,25 @@ static void xfseek(FILE *fp, long offset, int whence)
 	}
 }
 
+/*
+ * Parse an alignment given on the command line. It must be a power of two no
+ * smaller than 'min'. Exit the program on error.
+ */
+static uint64_t parse_align(const char *arg, uint64_t min)
+{
+	char *end;
+	uint64_t align = strtoull(arg, &end, 0);
+
+	if ((*arg == '\0') || (*end != '\0') || (align < min) ||
+	    ((align & (align - 1U)) != 0U)) {
+		fprintf(stderr, "error: Invalid alignment %s (power of two, at least 0x%lx).\n",
+			arg, min);
+		exit(1);
+	}
+
+	return align;
+}
+
 static void cleanup(void)
 {
 	struct sp_entry_info *sp = sp_info_head;
@@ -185,6 +216,36 @@ static void load_sp_rd(char *path)
 	sp_count++;
 }
 
+/*
+ * Print the layout of the package, with the biggest power-of-two boundary that
+ * the offset of each image is aligned to.
+ */
+static void print_layout(uint64_t padding)
+{
+	struct sp_entry_info *sp = sp_info_head;
+	uint64_t end = 0;
+
+	printf("\nPackage layout (image alignment 0x%lx, RD alignment 0x%lx):\n",
+	       sp_align, rd_align);
+
+	for (uint64_t i = 0; i < sp_count; i++) {
+		uint64_t offset_align = sp->sp_offset & -sp->sp_offset;
+
+		printf("  SP %lu: image 0x%08lx-0x%08lx (aligned to 0x%lx), RD 0x%08lx-0x%08lx\n",
+		       i, sp->sp_offset, sp->sp_offset + sp->sp_size,
+		       offset_align, sp->rd_offset,
+		       sp->rd_offset + sp->rd_size);
+
+		if ((sp->rd_offset + sp->rd_size) > end)
+			end = sp->rd_offset + sp->rd_size;
+
+		sp = sp->next;
+	}
+
+	printf("  Total size 0x%lx bytes, of which 0x%lx bytes of padding.\n",
+	       end, padding);
+}
+
 static void output_write(const char *path)
 {
 	struct sp_entry_info *sp;
@@ -198,8 +259,8 @@ static void output_write(const char *path)
 
 	printf("Writing %lu partitions to output file.\n", sp_count);
 
-	unsigned int header_size = (sizeof(struct sp_pkg_header) * 8)
-				 + (sizeof(struct sp_pkg_entry) * 8 * sp_count);
+	uint64_t header_size = sizeof(struct sp_pkg_header)
+			     + (sizeof(struct sp_pkg_entry) * sp_count);
 
 	FILE *f = fopen(path, "wb");
 	if (f == NULL) {
@@ -207,37 +268,44 @@ static void output_write(const char *path)
 		exit(1);
 	}
 
-	unsigned int file_ptr = align_to(header_size, PAGE_SIZE);
+	uint64_t file_ptr = align_to(header_size, sp_align);
+	uint64_t padding = file_ptr - header_size;
 
-	/* First, save all partition images aligned to page boundaries */
+	/* First, save all partition images aligned to 'sp_align' boundaries */
 
 	sp = sp_info_head;
 
 	for (uint64_t i = 0; i < sp_count; i++) {
 		xfseek(f, file_ptr, SEEK_SET);
 
-		printf("Writing image %lu to offset 0x%x (0x%lx bytes)\n",
+		printf("Writing image %lu to offset 0x%lx (0x%lx bytes)\n",
 		       i, file_ptr, sp->sp_size);
 
 		sp->sp_offset = file_ptr;
 		xfwrite(sp->sp_data, sp->sp_size, f);
-		file_ptr = align_to(file_ptr + sp->sp_size, PAGE_SIZE);
+		file_ptr = align_to(file_ptr + sp->sp_size, sp_align);
+		padding += file_ptr - (sp->sp_offset + sp->sp_size);
 		sp = sp->next;
 	}
 
-	/* Now, save resource description blobs aligned to 8 bytes */
+	/*
+	 * Now, save resource description blobs aligned to 'rd_align' bytes.
+	 * The images are followed by enough padding for the first one.
+	 */
 
 	sp = sp_info_head;
 
 	for (uint64_t i = 0; i < sp_count; i++) {
 		xfseek(f, file_ptr, SEEK_SET);
 
-		printf("Writing RD blob %lu to offset 0x%x (0x%lx bytes)\n",
+		printf("Writing RD blob %lu to offset 0x%lx (0x%lx bytes)\n",
 		       i, file_ptr, sp->rd_size);
 
 		sp->rd_offset = file_ptr;
 		xfwrite(sp->rd_data, sp->rd_size, f);
-		file_ptr = align_to(file_ptr + sp->rd_size, 8);
+		file_ptr = align_to(file_ptr + sp->rd_size, rd_align);
+		if (i + 1U < sp_count)
+			padding += file_ptr - (sp->rd_offset + sp->rd_size);
 		sp = sp->next;
 	}
 
@@ -273,6 +341,8 @@ static void output_write(const char *path)
 	/* All information has been written now */
 
 	fclose(f);
+
+	print_layout(padding);
 }
 
 static void usage(void)
@@ -294,6 +364,16 @@ static void usage(void)
 	printf("  -i <sp_path:rd_path> Add Secure Partition image and Resource\n"
 	       "                       Description blob (specified in two paths\n"
 	       "                       separated by a colon).\n");
+	printf("  -a <align>           Align the images to <align> bytes in the\n"
+	       "                       package. It must be a power of two, at\n"
+	       "                       least 0x%x (default). Use the block size\n"
+	       "                       of the translation tables, e.g. 0x200000,\n"
+	       "                       to let SPM map the images with blocks.\n",
+	       PAGE_SIZE);
+	printf("  -r <align>           Align the Resource Description blobs to\n"
+	       "                       <align> bytes in the package. It must be a\n"
+	       "                       power of two, at least 0x%x (default).\n",
+	       DEFAULT_RD_ALIGN);
 	printf("  -h                   Show this message.\n");
 	exit(1);
 }
@@ -303,14 +383,20 @@ int main(int argc, char *argv[])
 	int ch;
 	const char *outname = NULL;
 
-	while ((ch = getopt(argc, argv, "hi:o:")) != -1) {
+	while ((ch = getopt(argc, argv, "a:hi:o:r:")) != -1) {
 		switch (ch) {
+		case 'a':
+			sp_align = parse_align(optarg, PAGE_SIZE);
+			break;
 		case 'i':
 			load_sp_rd(optarg);
 			break;
 		case 'o':
 			outname = optarg;
 			break;
+		case 'r':
+			rd_align = parse_align(optarg, DEFAULT_RD_ALIGN);
+			break;
 		case 'h':
 		default:
 			usage();
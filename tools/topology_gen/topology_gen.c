@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool generating the power domain topology of the PSCI library at build
+ * time.
+ *
+ * It is built for each BL image with the headers of the platform and with the
+ * source file given in the BLx_PSCI_TOPOLOGY platform makefile variable, which
+ * defines plat_get_power_domain_tree_desc() and plat_core_pos_by_mpidr() for a
+ * fixed topology. The tool populates the power domain tree as psci_setup() does
+ * and looks up the core index of every MPIDR whose affinity fields Aff0 to Aff2
+ * are in [0, 255]. The results are printed as a C source file that is linked
+ * into the image. See PREBUILT_PSCI_TOPOLOGY.
+ *
+ * The functions of the platform can only depend on constants: they can't read
+ * registers or the configuration of the platform, which are not known when the
+ * topology is generated.
+ */
+
+#include <arch.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <psci.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define AFF_VALUES		256U
+
+/* Power domain tree, as populated by psci_setup() */
+static unsigned int non_cpu_parent[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+static unsigned char non_cpu_level[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+static int non_cpu_start_idx[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+static unsigned int non_cpu_ncpus[PSCI_NUM_NON_CPU_PWR_DOMAINS];
+static unsigned int non_cpu_count;
+static unsigned int cpu_parent[PLATFORM_CORE_COUNT];
+
+/* MPIDR of each core index, and number of values of each affinity field */
+static u_register_t cpu_mpidr[PLATFORM_CORE_COUNT];
+static int cpu_found[PLATFORM_CORE_COUNT];
+static unsigned int aff_count[3];
+
+/* Same as psci_init_pwr_domain_node(), for the fields of the tables */
+static void init_node(unsigned int node_idx, int parent_idx, int level)
+{
+	if (level > (int)PSCI_CPU_PWR_LVL) {
+		if (node_idx >= PSCI_NUM_NON_CPU_PWR_DOMAINS) {
+			fprintf(stderr, "error: More than %d non CPU power "
+				"domains\n", PSCI_NUM_NON_CPU_PWR_DOMAINS);
+			exit(1);
+		}
+		non_cpu_parent[node_idx] = (unsigned int)parent_idx;
+		non_cpu_level[node_idx] = (unsigned char)level;
+		non_cpu_count = node_idx + 1U;
+	} else {
+		if (node_idx >= PLATFORM_CORE_COUNT) {
+			fprintf(stderr, "error: More than %d CPU power "
+				"domains\n", PLATFORM_CORE_COUNT);
+			exit(1);
+		}
+		cpu_parent[node_idx] = (unsigned int)parent_idx;
+	}
+}
+
+/* Same algorithm as populate_power_domain_tree() */
+static void populate_tree(const unsigned char *topology)
+{
+	unsigned int i, j = 0U, num_nodes_at_lvl = 1U, num_nodes_at_next_lvl;
+	unsigned int node_index = 0U, num_children;
+	int parent_node_index = 0;
+	int level = (int)PLAT_MAX_PWR_LVL;
+
+	while (level >= (int)PSCI_CPU_PWR_LVL) {
+		num_nodes_at_next_lvl = 0U;
+
+		for (i = 0U; i < num_nodes_at_lvl; i++) {
+			if (parent_node_index > PSCI_NUM_NON_CPU_PWR_DOMAINS) {
+				fprintf(stderr, "error: Too many power domains "
+					"in the tree descriptor\n");
+				exit(1);
+			}
+			num_children = topology[parent_node_index];
+
+			for (j = node_index; j < (node_index + num_children);
+			     j++)
+				init_node(j, parent_node_index - 1, level);
+
+			node_index = j;
+			num_nodes_at_next_lvl += num_children;
+			parent_node_index++;
+		}
+
+		num_nodes_at_lvl = num_nodes_at_next_lvl;
+		level--;
+
+		if (level == (int)PSCI_CPU_PWR_LVL)
+			node_index = 0U;
+	}
+
+	if (j != PLATFORM_CORE_COUNT) {
+		fprintf(stderr, "error: %u CPU power domains in the tree "
+			"descriptor, %d expected\n", j, PLATFORM_CORE_COUNT);
+		exit(1);
+	}
+}
+
+/* Same algorithm as psci_update_pwrlvl_limits() */
+static void update_pwrlvl_limits(void)
+{
+	unsigned int nodes_idx[PLAT_MAX_PWR_LVL] = {0};
+	unsigned int temp_index[PLAT_MAX_PWR_LVL];
+	unsigned int parent;
+	int cpu_idx, j;
+
+	for (cpu_idx = 0; cpu_idx < PLATFORM_CORE_COUNT; cpu_idx++) {
+		parent = cpu_parent[cpu_idx];
+		for (j = 0; j < (int)PLAT_MAX_PWR_LVL; j++) {
+			temp_index[j] = parent;
+			parent = non_cpu_parent[parent];
+		}
+
+		for (j = (int)PLAT_MAX_PWR_LVL - 1; j >= 0; j--) {
+			if (temp_index[j] != nodes_idx[j]) {
+				nodes_idx[j] = temp_index[j];
+				non_cpu_start_idx[nodes_idx[j]] = cpu_idx;
+			}
+			non_cpu_ncpus[nodes_idx[j]]++;
+		}
+	}
+}
+
+static u_register_t make_mpidr(unsigned int aff2, unsigned int aff1,
+			       unsigned int aff0)
+{
+	return ((u_register_t)aff2 << MPIDR_AFF2_SHIFT) |
+	       ((u_register_t)aff1 << MPIDR_AFF1_SHIFT) |
+	       ((u_register_t)aff0 << MPIDR_AFF0_SHIFT);
+}
+
+/* Look the core index of all the MPIDRs up, with Aff3 set to 0 */
+static void scan_mpidrs(void)
+{
+	unsigned int aff0, aff1, aff2, found = 0U;
+	u_register_t mpidr;
+	int pos;
+
+	for (aff2 = 0U; aff2 < AFF_VALUES; aff2++) {
+		for (aff1 = 0U; aff1 < AFF_VALUES; aff1++) {
+			for (aff0 = 0U; aff0 < AFF_VALUES; aff0++) {
+				mpidr = make_mpidr(aff2, aff1, aff0);
+				pos = plat_core_pos_by_mpidr(mpidr);
+				if (pos < 0)
+					continue;
+
+				if ((pos >= PLATFORM_CORE_COUNT) ||
+				    (cpu_found[pos] != 0)) {
+					fprintf(stderr, "error: Invalid core "
+						"index %d for MPIDR 0x%llx\n",
+						pos, (unsigned long long)mpidr);
+					exit(1);
+				}
+				cpu_found[pos] = 1;
+				cpu_mpidr[pos] = mpidr;
+				found++;
+
+				if (aff0 >= aff_count[0])
+					aff_count[0] = aff0 + 1U;
+				if (aff1 >= aff_count[1])
+					aff_count[1] = aff1 + 1U;
+				if (aff2 >= aff_count[2])
+					aff_count[2] = aff2 + 1U;
+#ifdef AARCH64
+				/* The lookup only supports a zero Aff3 */
+				if (plat_core_pos_by_mpidr(mpidr |
+					((u_register_t)1U << MPIDR_AFF3_SHIFT))
+				    >= 0) {
+					fprintf(stderr, "error: MPIDRs with a "
+						"non-zero Aff3 are not "
+						"supported\n");
+					exit(1);
+				}
+#endif
+			}
+		}
+	}
+
+	if (found != PLATFORM_CORE_COUNT) {
+		fprintf(stderr, "error: %u valid MPIDRs, %d expected\n",
+			found, PLATFORM_CORE_COUNT);
+		exit(1);
+	}
+}
+
+static int core_pos(unsigned int aff2, unsigned int aff1, unsigned int aff0)
+{
+	u_register_t mpidr = make_mpidr(aff2, aff1, aff0);
+	int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		if (cpu_mpidr[i] == mpidr)
+			return i;
+	}
+
+	return -1;
+}
+
+static void print_topology(void)
+{
+	unsigned int aff0, aff1, aff2, i;
+
+	printf("/*\n"
+	       " * Power domain topology generated by topology_gen. "
+	       "Do not edit.\n"
+	       " * %u non CPU power domains used out of %d "
+	       "(PSCI_NUM_NON_CPU_PWR_DOMAINS).\n"
+	       " */\n\n", non_cpu_count, PSCI_NUM_NON_CPU_PWR_DOMAINS);
+	printf("#include <arch.h>\n"
+	       "#include <psci_prebuilt_topology.h>\n\n");
+
+	printf("const unsigned int psci_prebuilt_non_cpu_node_count = %uU;\n\n",
+	       non_cpu_count);
+
+	printf("const psci_prebuilt_pd_node_t\n"
+	       "\tpsci_prebuilt_non_cpu_nodes[PSCI_NUM_NON_CPU_PWR_DOMAINS]"
+	       " = {\n");
+	for (i = 0U; i < non_cpu_count; i++) {
+		printf("\t[%u] = { .parent_node = 0x%xU, "
+		       ".cpu_start_idx = %d,\n"
+		       "\t\t.ncpus = %uU, .level = %uU },\n", i,
+		       non_cpu_parent[i], non_cpu_start_idx[i],
+		       non_cpu_ncpus[i], non_cpu_level[i]);
+	}
+	printf("};\n\n");
+
+	printf("const unsigned int\n"
+	       "\tpsci_prebuilt_cpu_parent[PLATFORM_CORE_COUNT] = {\n");
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++)
+		printf("\t[%u] = %uU,\n", i, cpu_parent[i]);
+	printf("};\n\n");
+
+	printf("const u_register_t\n"
+	       "\tpsci_prebuilt_cpu_mpidr[PLATFORM_CORE_COUNT] = {\n");
+	for (i = 0U; i < PLATFORM_CORE_COUNT; i++)
+		printf("\t[%u] = 0x%llxU,\n", i,
+		       (unsigned long long)cpu_mpidr[i]);
+	printf("};\n\n");
+
+	printf("/* Core index of each MPIDR, indexed by Aff2, Aff1 and Aff0 "
+	       "*/\n"
+	       "static const int16_t core_pos_table[%u][%u][%u] = {\n",
+	       aff_count[2], aff_count[1], aff_count[0]);
+	for (aff2 = 0U; aff2 < aff_count[2]; aff2++) {
+		printf("\t{\n");
+		for (aff1 = 0U; aff1 < aff_count[1]; aff1++) {
+			printf("\t\t{");
+			for (aff0 = 0U; aff0 < aff_count[0]; aff0++) {
+				printf("%s%d", (aff0 == 0U) ? " " : ", ",
+				       core_pos(aff2, aff1, aff0));
+			}
+			printf(" },\n");
+		}
+		printf("\t},\n");
+	}
+	printf("};\n\n");
+
+	printf("int psci_prebuilt_core_pos_by_mpidr(u_register_t mpidr)\n"
+	       "{\n"
+	       "\tunsigned int aff0 = MPIDR_AFFLVL0_VAL(mpidr);\n"
+	       "\tunsigned int aff1 = MPIDR_AFFLVL1_VAL(mpidr);\n"
+	       "\tunsigned int aff2 = MPIDR_AFFLVL2_VAL(mpidr);\n\n"
+	       "\tif ((mpidr & MPIDR_AFFINITY_MASK & ~(u_register_t)\n"
+	       "\t     ((MPIDR_AFFLVL_MASK << MPIDR_AFF2_SHIFT) |\n"
+	       "\t      (MPIDR_AFFLVL_MASK << MPIDR_AFF1_SHIFT) |\n"
+	       "\t      (MPIDR_AFFLVL_MASK << MPIDR_AFF0_SHIFT))) != 0U)\n"
+	       "\t\treturn -1;\n\n"
+	       "\tif ((aff0 >= %uU) || (aff1 >= %uU) || (aff2 >= %uU))\n"
+	       "\t\treturn -1;\n\n"
+	       "\treturn core_pos_table[aff2][aff1][aff0];\n"
+	       "}\n", aff_count[0], aff_count[1], aff_count[2]);
+}
+
+int main(void)
+{
+	populate_tree(plat_get_power_domain_tree_desc());
+	update_pwrlvl_limits();
+	scan_mpidrs();
+	print_topology();
+
+	return 0;
+}
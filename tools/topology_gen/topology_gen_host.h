@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TOPOLOGY_GEN_HOST_H
+#define TOPOLOGY_GEN_HOST_H
+
+/*
+ * topology_gen is built with the C library of the host, which doesn't define
+ * the register types of the firmware. They are used by the prototypes of the
+ * platform functions that the tool calls.
+ */
+#include <stdint.h>
+
+typedef uint64_t u_register_t;
+typedef int64_t register_t;
+
+#endif /* TOPOLOGY_GEN_HOST_H */
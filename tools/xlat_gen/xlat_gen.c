@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host tool generating the translation tables of a BL image at build time.
+ *
+ * It is built for each BL image with the headers of the platform and with the
+ * source file given in the BLx_XLAT_MMAP platform makefile variable, which
+ * defines plat_xlat_prebuilt_mmap[], the static memory map of the image. The
+ * tables are built on the host by the translation tables library itself, with
+ * the same context parameters as the image, and printed as a C source file
+ * that is linked into the image. See PREBUILT_XLAT_TABLES.
+ *
+ * The memory map can only use constant addresses: the symbols of the linker
+ * script of the image are not known when the tables are generated.
+ */
+
+#include <debug.h>
+#include <platform_def.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <xlat_tables_defs.h>
+#include <xlat_tables_v2.h>
+
+#include "xlat_tables_private.h"
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+#error "Prebuilt translation tables can't be used with dynamic regions"
+#endif
+
+/* Translation regime of the BL image, unless given by the build system. */
+#ifndef XLAT_GEN_REGIME
+#if defined(IMAGE_BL1) || defined(IMAGE_BL31) || \
+	(defined(IMAGE_BL2) && BL2_AT_EL3)
+#define XLAT_GEN_REGIME		EL3_REGIME
+#else
+#define XLAT_GEN_REGIME		EL1_EL0_REGIME
+#endif
+#endif
+
+/* Static memory map of the BL image, terminated by a zero-sized region */
+extern const mmap_region_t plat_xlat_prebuilt_mmap[];
+
+/* Same parameters as the default context of the BL image */
+REGISTER_XLAT_CONTEXT(gen, MAX_MMAP_REGIONS, MAX_XLAT_TABLES,
+		PLAT_VIRT_ADDR_SPACE_SIZE, PLAT_PHY_ADDR_SPACE_SIZE);
+
+/*******************************************************************************
+ * Host implementation of the functions used by the library. The tables are
+ * built in host memory, so there is no MMU or cache to deal with.
+ ******************************************************************************/
+bool is_mmu_enabled_ctx(const xlat_ctx_t *ctx)
+{
+	return false;
+}
+
+bool is_dcache_enabled(void)
+{
+	return false;
+}
+
+void clean_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+/*
+ * The physical address range of the CPU is unknown here. It is checked by the
+ * BL image when it installs the tables.
+ */
+unsigned long long xlat_arch_get_max_supported_pa(void)
+{
+	return PLAT_PHY_ADDR_SPACE_SIZE - 1ULL;
+}
+
+uint64_t xlat_arch_regime_get_xn_desc(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		return UPPER_ATTRS(UXN) | UPPER_ATTRS(PXN);
+	} else {
+		return UPPER_ATTRS(XN);
+	}
+}
+
+void xlat_mmap_print(const mmap_region_t *mmap)
+{
+}
+
+void xlat_tables_print(xlat_ctx_t *ctx)
+{
+}
+
+void tf_log(const char *fmt, ...)
+{
+	va_list args;
+
+	/* Skip the log level marker */
+	fmt++;
+
+	va_start(args, fmt);
+	(void)vfprintf(stderr, fmt, args);
+	va_end(args);
+}
+
+int console_flush(void)
+{
+	return 0;
+}
+
+#if ENABLE_BACKTRACE
+void backtrace(const char *cookie)
+{
+}
+#endif
+
+void do_panic(void)
+{
+	exit(1);
+}
+
+/*******************************************************************************
+ * Output of the tables
+ ******************************************************************************/
+static const char *regime_name(int xlat_regime)
+{
+	if (xlat_regime == EL1_EL0_REGIME) {
+		return "EL1_EL0_REGIME";
+	} else if (xlat_regime == EL2_REGIME) {
+		return "EL2_REGIME";
+	} else {
+		return "EL3_REGIME";
+	}
+}
+
+/*
+ * Print the non-zero entries of a table. Table descriptors point to tables of
+ * the host, they are printed as references to the generated tables.
+ */
+static void print_table(const uint64_t *table, unsigned int entries,
+			unsigned int level, const char *indent)
+{
+	for (unsigned int i = 0U; i < entries; i++) {
+		uint64_t desc = table[i];
+
+		if (desc == INVALID_DESC)
+			continue;
+
+		if ((level < XLAT_TABLE_LEVEL_MAX) &&
+		    ((desc & DESC_MASK) == TABLE_DESC)) {
+			uintptr_t subtable =
+				(uintptr_t)(desc & TABLE_ADDR_MASK);
+			uintptr_t idx = (subtable - (uintptr_t)gen_xlat_ctx.tables)
+				/ XLAT_TABLE_SIZE;
+
+			printf("%s[%u] = ULL(0x%llx) + "
+			       "(uintptr_t)xlat_prebuilt_sub_tables[%lu],\n",
+			       indent, i,
+			       (unsigned long long)(desc & ~TABLE_ADDR_MASK),
+			       (unsigned long)idx);
+		} else {
+			printf("%s[%u] = ULL(0x%016llx),\n", indent, i,
+			       (unsigned long long)desc);
+		}
+	}
+}
+
+/* Level of the tables that a table descriptor of the given table points to */
+static void find_sub_table_levels(const uint64_t *table, unsigned int entries,
+				  unsigned int level, unsigned int *levels)
+{
+	for (unsigned int i = 0U; i < entries; i++) {
+		uint64_t desc = table[i];
+		uintptr_t idx;
+
+		if ((level == XLAT_TABLE_LEVEL_MAX) ||
+		    ((desc & DESC_MASK) != TABLE_DESC))
+			continue;
+
+		idx = ((uintptr_t)(desc & TABLE_ADDR_MASK) -
+		       (uintptr_t)gen_xlat_ctx.tables) / XLAT_TABLE_SIZE;
+		levels[idx] = level + 1U;
+
+		find_sub_table_levels(gen_xlat_ctx.tables[idx],
+				      XLAT_TABLE_ENTRIES, level + 1U, levels);
+	}
+}
+
+static void print_tables(const xlat_ctx_t *ctx)
+{
+	unsigned int levels[MAX_XLAT_TABLES] = { 0U };
+	int i;
+
+	printf("/*\n"
+	       " * Translation tables generated by xlat_gen. Do not edit.\n"
+	       " * %d sub-tables used out of %d (MAX_XLAT_TABLES).\n"
+	       " */\n\n"
+	       "#include <platform_def.h>\n"
+	       "#include <stdint.h>\n"
+	       "#include <utils_def.h>\n"
+	       "#include <xlat_tables_defs.h>\n"
+	       "#include <xlat_tables_v2.h>\n\n"
+	       "#if PLAT_XLAT_TABLES_DYNAMIC\n"
+	       "#error \"Prebuilt translation tables can't be used with dynamic regions\"\n"
+	       "#endif\n\n", ctx->next_table, ctx->tables_num);
+
+	find_sub_table_levels(ctx->base_table, ctx->base_table_entries,
+			      ctx->base_level, levels);
+
+	if (ctx->next_table > 0) {
+		printf("static const uint64_t xlat_prebuilt_sub_tables[%d]"
+		       "[XLAT_TABLE_ENTRIES]\n"
+		       "\t__aligned(XLAT_TABLE_SIZE) = {\n", ctx->next_table);
+
+		for (i = 0; i < ctx->next_table; i++) {
+			printf("\t[%d] = {\n", i);
+			print_table(ctx->tables[i], XLAT_TABLE_ENTRIES,
+				    levels[i], "\t\t");
+			printf("\t},\n");
+		}
+
+		printf("};\n\n");
+	}
+
+	printf("static const uint64_t xlat_prebuilt_base_table[%u]\n"
+	       "\t__aligned(%u * sizeof(uint64_t)) = {\n",
+	       ctx->base_table_entries, ctx->base_table_entries);
+	print_table(ctx->base_table, ctx->base_table_entries, ctx->base_level,
+		    "\t");
+	printf("};\n\n");
+
+	printf("const xlat_prebuilt_tables_t xlat_prebuilt_tables = {\n"
+	       "\t.base_table = xlat_prebuilt_base_table,\n"
+	       "\t.base_table_entries = U(%u),\n"
+	       "\t.xlat_regime = %s,\n"
+	       "\t.pa_max_address = ULL(0x%llx),\n"
+	       "\t.va_max_address = ULL(0x%llx),\n"
+	       "\t.max_pa = ULL(0x%llx),\n"
+	       "\t.max_va = ULL(0x%llx),\n"
+	       "};\n",
+	       ctx->base_table_entries, regime_name(ctx->xlat_regime),
+	       ctx->pa_max_address,
+	       (unsigned long long)ctx->va_max_address,
+	       ctx->max_pa, (unsigned long long)ctx->max_va);
+}
+
+int main(void)
+{
+	gen_xlat_ctx.xlat_regime = XLAT_GEN_REGIME;
+
+	mmap_add_ctx(&gen_xlat_ctx, plat_xlat_prebuilt_mmap);
+	init_xlat_tables_ctx(&gen_xlat_ctx);
+
+	print_tables(&gen_xlat_ctx);
+
+	return 0;
+}